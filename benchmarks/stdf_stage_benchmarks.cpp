@@ -0,0 +1,277 @@
+// Per-stage benchmarks over the STDF_Files corpus (Google Benchmark)
+//
+//   ./stdf_benchmarks [--benchmark_filter=...] [file_or_directory ...]
+//
+// Without paths, every *.stdf file in STDF_Files/ is benchmarked. Each
+// stage reports, per file:
+//   bytes_per_second  file bytes through the stage (MB/s, comparable across stages)
+//   records/s         STDF records (rows for the measurement stages)
+//   allocs/record     C++ heap allocations (operator new) per record or row;
+//                     Python object allocations are not counted
+
+#include "../cpp/include/python_measurements.h"
+#include "../cpp/include/ultra_fast_processor.h"
+#include "../cpp/include/dynamic_field_extractor.h"
+#include <benchmark/benchmark.h>
+#include <libstdf.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+struct CorpusFile {
+    std::string path;
+    std::string name;
+    size_t bytes = 0;
+    size_t records = 0;  // Every record libstdf reads
+};
+
+// The processor logs per file; keep the benchmark table readable
+class ScopedQuietStdout {
+public:
+    ScopedQuietStdout() : saved_(std::cout.rdbuf(sink_.rdbuf())) {}
+    ~ScopedQuietStdout() { std::cout.rdbuf(saved_); }
+
+private:
+    std::ostringstream sink_;
+    std::streambuf* saved_;
+};
+
+static void report(benchmark::State& state, const CorpusFile& file, size_t records, size_t allocations) {
+    const double iterations = static_cast<double>(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(file.bytes));
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(records) * iterations,
+                                                     benchmark::Counter::kIsRate);
+    state.counters["allocs/record"] = records ? static_cast<double>(allocations) / (records * iterations) : 0.0;
+}
+
+static size_t count_records(const std::string& path) {
+    stdf_file* file = stdf_open(const_cast<char*>(path.c_str()));
+    if (!file) {
+        return 0;
+    }
+    size_t records = 0;
+    while (rec_unknown* record = stdf_read_record(file)) {
+        records++;
+        stdf_free_record(record);
+    }
+    stdf_close(file);
+    return records;
+}
+
+// Stage 1: bytes off the disk (page cache after the first pass)
+static void BM_RawRead(benchmark::State& state, const CorpusFile& file) {
+    std::vector<char> buffer(file.bytes);
+    size_t allocations = 0;
+    for (auto _ : state) {
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        std::ifstream in(file.path, std::ios::binary);
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        benchmark::DoNotOptimize(buffer.data());
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    report(state, file, file.records, allocations);
+}
+
+// Stage 2: libstdf record decoding, nothing extracted
+static void BM_LibstdfDecode(benchmark::State& state, const CorpusFile& file) {
+    size_t allocations = 0;
+    for (auto _ : state) {
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        stdf_file* handle = stdf_open(const_cast<char*>(file.path.c_str()));
+        if (!handle) {
+            state.SkipWithError("stdf_open failed");
+            return;
+        }
+        size_t records = 0;
+        while (rec_unknown* record = stdf_read_record(handle)) {
+            records++;
+            stdf_free_record(record);
+        }
+        stdf_close(handle);
+        benchmark::DoNotOptimize(records);
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    report(state, file, file.records, allocations);
+}
+
+// Stage 3: DynamicFieldExtractor over records decoded up front
+static void BM_FieldExtraction(benchmark::State& state, const CorpusFile& file) {
+    std::vector<rec_unknown*> records;
+    stdf_file* handle = stdf_open(const_cast<char*>(file.path.c_str()));
+    if (!handle) {
+        state.SkipWithError("stdf_open failed");
+        return;
+    }
+    while (rec_unknown* record = stdf_read_record(handle)) {
+        switch (HEAD_TO_REC(record->header)) {
+            case REC_PTR: case REC_MPR: case REC_FTR: case REC_HBR: case REC_SBR: case REC_PRR:
+                records.push_back(record);
+                break;
+            default:
+                stdf_free_record(record);
+        }
+    }
+    stdf_close(handle);
+
+    DynamicFieldExtractor& extractor = get_shared_field_extractor();
+    size_t allocations = 0;
+    for (auto _ : state) {
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        for (rec_unknown* record : records) {
+            DynamicSTDFRecord extracted;
+            switch (HEAD_TO_REC(record->header)) {
+                case REC_PTR: extractor.extract_fields(reinterpret_cast<rec_ptr*>(record), extracted); break;
+                case REC_MPR: extractor.extract_fields(reinterpret_cast<rec_mpr*>(record), extracted); break;
+                case REC_FTR: extractor.extract_fields(reinterpret_cast<rec_ftr*>(record), extracted); break;
+                case REC_HBR: extractor.extract_fields(reinterpret_cast<rec_hbr*>(record), extracted); break;
+                case REC_SBR: extractor.extract_fields(reinterpret_cast<rec_sbr*>(record), extracted); break;
+                case REC_PRR: extractor.extract_fields(reinterpret_cast<rec_prr*>(record), extracted); break;
+            }
+            benchmark::DoNotOptimize(extracted.fields.size());
+        }
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    report(state, file, records.size(), allocations);
+
+    for (rec_unknown* record : records) {
+        stdf_free_record(record);
+    }
+}
+
+// Stage 4: measurement rows from the parsed columns (UltraFastProcessor's
+// part brackets; its processing_time, parsing excluded). Allocations cover
+// the whole file, parse included.
+static void BM_MeasurementGeneration(benchmark::State& state, const CorpusFile& file) {
+    ScopedQuietStdout quiet;
+    size_t rows = 0;
+    size_t allocations = 0;
+    for (auto _ : state) {
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        UltraFastProcessor processor;
+        MeasurementBatch batch = processor.process_stdf_file_to_batch(file.path);
+        rows = batch.size();
+        state.SetIterationTime(processor.get_processing_time());
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    report(state, file, rows, allocations);
+}
+
+// Stage 5: batch -> list of Python tuples, as the module returns it
+static void BM_PythonTuples(benchmark::State& state, const CorpusFile& file) {
+    UltraFastProcessor processor;
+    MeasurementBatch batch;
+    {
+        ScopedQuietStdout quiet;
+        batch = processor.process_stdf_file_to_batch(file.path);
+    }
+    size_t allocations = 0;
+    for (auto _ : state) {
+        size_t before = g_allocations.load(std::memory_order_relaxed);
+        PyObject* tuples = measurement_batch_to_tuple_list(batch);
+        if (!tuples) {
+            PyErr_Clear();
+            state.SkipWithError("tuple conversion failed");
+            return;
+        }
+        Py_DECREF(tuples);
+        allocations += g_allocations.load(std::memory_order_relaxed) - before;
+    }
+    report(state, file, batch.size(), allocations);
+}
+
+static std::vector<CorpusFile> find_corpus(int argc, char** argv) {
+    std::vector<std::string> roots;
+    for (int i = 1; i < argc; ++i) {
+        roots.push_back(argv[i]);
+    }
+    if (roots.empty()) {
+        roots.push_back("STDF_Files");
+    }
+
+    std::vector<std::string> paths;
+    for (const auto& root : roots) {
+        std::error_code ec;
+        if (fs::is_directory(root, ec)) {
+            for (const auto& entry : fs::directory_iterator(root, ec)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".stdf") {
+                    paths.push_back(entry.path().string());
+                }
+            }
+        } else {
+            paths.push_back(root);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<CorpusFile> corpus;
+    for (const auto& path : paths) {
+        CorpusFile file;
+        file.path = path;
+        file.name = fs::path(path).filename().string();
+        std::error_code ec;
+        file.bytes = fs::file_size(path, ec);
+        file.records = ec ? 0 : count_records(path);
+        if (file.records == 0) {
+            std::cerr << "⚠️ Skipping " << path << " (not readable by libstdf)" << std::endl;
+            continue;
+        }
+        corpus.push_back(file);
+    }
+    return corpus;
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    std::vector<CorpusFile> corpus = find_corpus(argc, argv);
+    if (corpus.empty()) {
+        std::cerr << "❌ No STDF files to benchmark (pass files or directories, default STDF_Files/)" << std::endl;
+        return 1;
+    }
+
+    Py_Initialize();
+    for (const auto& file : corpus) {
+        benchmark::RegisterBenchmark(("RawRead/" + file.name).c_str(), BM_RawRead, file)
+            ->Unit(benchmark::kMillisecond)->UseRealTime();
+        benchmark::RegisterBenchmark(("LibstdfDecode/" + file.name).c_str(), BM_LibstdfDecode, file)
+            ->Unit(benchmark::kMillisecond)->UseRealTime();
+        benchmark::RegisterBenchmark(("FieldExtraction/" + file.name).c_str(), BM_FieldExtraction, file)
+            ->Unit(benchmark::kMillisecond)->UseRealTime();
+        benchmark::RegisterBenchmark(("MeasurementGeneration/" + file.name).c_str(), BM_MeasurementGeneration, file)
+            ->Unit(benchmark::kMillisecond)->UseManualTime();
+        benchmark::RegisterBenchmark(("PythonTuples/" + file.name).c_str(), BM_PythonTuples, file)
+            ->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    Py_FinalizeEx();
+    return 0;
+}
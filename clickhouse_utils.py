@@ -114,7 +114,7 @@ def setup_clickhouse_schema(client):
                 wp_pos_x Int32,
                 wp_pos_y Int32,
                 wptm_value Float64,
-                wptm_created_date DateTime,
+                wptm_created_date DateTime DEFAULT now(),  -- Filled in for native inserts that omit it
                 test_flag UInt8,
                 segment UInt8,
                 file_hash String  -- Added for file-level deduplication
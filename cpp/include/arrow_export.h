@@ -0,0 +1,73 @@
+#ifndef ARROW_EXPORT_H
+#define ARROW_EXPORT_H
+
+#include <memory>
+#include <string>
+#include <cstdint>
+#include "measurement_batch.h"
+
+// Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html),
+// verbatim so no Arrow headers or libraries are needed to produce it
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    // Array type description
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowSchema*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+struct ArrowArray {
+    // Array data description
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+
+    // Release callback
+    void (*release)(struct ArrowArray*);
+    // Opaque producer-specific data
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+/**
+ * MeasurementBatch as an Arrow record batch
+ *
+ * The schema is a struct ("+s") with one non-nullable child per
+ * MEASUREMENT_FIELD, in field order. Numeric columns are exported in place;
+ * string columns become dictionary arrays whose int32 indices are the
+ * batch's codes (also in place) over a utf8 dictionary, the only part that
+ * is copied. Every exported structure holds a reference to owner, which
+ * must keep the batch and the text behind its string views alive, so the
+ * consumer (pyarrow, Polars, DuckDB, ...) can outlive the caller's handle.
+ * Children may be moved out and released on their own, per the spec.
+ */
+class ArrowBatchExporter {
+public:
+    static bool export_schema(ArrowSchema* schema);
+    // False (nothing exported) if a dictionary exceeds 32-bit offsets
+    static bool export_array(const std::shared_ptr<const void>& owner, const MeasurementBatch& batch,
+                             ArrowArray* array, std::string* error = nullptr);
+};
+
+#endif // ARROW_EXPORT_H
@@ -0,0 +1,95 @@
+#ifndef BATCH_INGEST_ENGINE_H
+#define BATCH_INGEST_ENGINE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include "ultra_fast_processor.h"
+#include "measurement_batch.h"
+#include "ingest_manifest.h"
+#include "measurement_spool.h"
+
+// Outcome of one file of a batch
+struct FileIngestStats {
+    std::string path;
+    bool success = false;
+    std::string error;
+    size_t row_offset = 0;     // First row of this file in the merged batch
+    size_t measurements = 0;
+    size_t total_records = 0;
+    double parsing_time = 0.0;
+    double processing_time = 0.0;
+    std::string file_hash;  // Given in set_file_hashes, else the content hash
+    bool skipped = false;   // Already ingested per the manifest; not opened
+};
+
+/**
+ * Multi-file ingest with no Python in the loop
+ *
+ * Every file gets its own UltraFastProcessor; files are spread over a
+ * WorkStealingPool, largest first (file_schedule.h), and all processors
+ * assign IDs from one shared FastIDManager. Each file's chunked decode and
+ * tuple generation get its share of the threads by size, so a large file
+ * among small ones is split over the workers the small ones leave idle.
+ * A FilePrefetcher reads the files not started yet into the page cache.
+ *
+ * Per-file batches are merged in input order once all files are done, so
+ * a file's rows are contiguous (see FileIngestStats::row_offset). The
+ * merged batch's dictionaries view the processors' string tables: they
+ * stay valid until the next process_files() call or destruction.
+ *
+ * With a memory budget, files are staged block by block in a
+ * MeasurementSpool instead and nothing is merged: blocks past the budget
+ * are spilled to compressed files and drain_measurements() streams them
+ * back in file order, so staged rows hold about the budget in memory
+ * whatever the number and size of the files.
+ */
+class BatchIngestEngine {
+public:
+    BatchIngestEngine();
+
+    void set_num_threads(size_t threads);  // 0 = one per core
+    void set_parser_backend(STDFParserBackend backend) { parser_backend_ = backend; }
+    void set_test_filter_patterns(const std::vector<std::string>& patterns);
+    // Per-file hashes in input order; files without one hash their content
+    void set_file_hashes(const std::vector<std::string>& hashes) { file_hashes_ = hashes; }
+    // Files the manifest lists as ingested (and unchanged) are skipped
+    // without being opened; nullptr processes everything. Recording a
+    // file as ingested is up to the caller, once its rows are stored.
+    void set_manifest(const IngestManifest* manifest) { manifest_ = manifest; }
+    // Bytes of staged rows kept in memory (0 = merge everything in memory,
+    // the default); spill files go to spill_dir, by default the system
+    // temporary directory
+    void set_memory_budget(size_t bytes, const std::string& spill_dir = "");
+
+    FastIDManager& id_manager() { return id_manager_; }
+
+    // False when any file failed; the others are still merged
+    bool process_files(const std::vector<std::string>& paths);
+
+    const MeasurementBatch& measurements() const { return measurements_; }  // Empty with a memory budget
+    // With a memory budget: the staged blocks in file order, then the spool
+    // is empty. False when a block could not be read back or the sink stopped.
+    bool drain_measurements(const std::function<bool(size_t file, MeasurementBatch& batch)>& sink);
+    const MeasurementSpool* spool() const { return spool_.get(); }  // nullptr without a budget
+    const std::vector<FileIngestStats>& file_stats() const { return file_stats_; }
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    size_t num_threads_;
+    STDFParserBackend parser_backend_;
+    bool has_patterns_;
+    std::vector<std::string> test_patterns_;
+    std::vector<std::string> file_hashes_;
+    const IngestManifest* manifest_;
+    std::unique_ptr<MeasurementSpool> spool_;
+
+    FastIDManager id_manager_;
+    std::vector<std::unique_ptr<UltraFastProcessor>> processors_;
+    MeasurementBatch measurements_;
+    std::vector<FileIngestStats> file_stats_;
+    std::string last_error_;
+};
+
+#endif // BATCH_INGEST_ENGINE_H
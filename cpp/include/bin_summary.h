@@ -0,0 +1,64 @@
+#ifndef BIN_SUMMARY_H
+#define BIN_SUMMARY_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "columnar_store.h"
+
+// HEAD_NUM of the whole-file rows, as in STDF's summary HBR/SBR
+constexpr uint8_t ALL_SITES_HEAD = 255;
+
+// Parts counted in one hard or soft bin, per head/site or for the whole
+// file (head ALL_SITES_HEAD, site 0)
+struct BinCount {
+    bool soft;               // SOFT_BIN/SBR, else HARD_BIN/HBR
+    uint8_t head_num;
+    uint8_t site_num;
+    uint16_t bin_num;
+    uint32_t part_count;     // PRRs in the bin
+    uint32_t reported_count; // HBIN_CNT/SBIN_CNT of the matching HBR/SBR
+    bool reported;           // The file has a matching HBR/SBR
+    char pass_fail;          // HBIN_PF/SBIN_PF ('P', 'F' or ' ' when unknown)
+
+    bool matches() const { return reported && reported_count == part_count; }
+};
+
+// Parts and good parts (SOFT_BIN 1, as in the test_flag column) per
+// head/site or, in the first row, for the whole file
+struct SiteYield {
+    uint8_t head_num;
+    uint8_t site_num;
+    uint32_t part_count;
+    uint32_t good_count;
+
+    double yield() const { return part_count > 0 ? static_cast<double>(good_count) / part_count : 0.0; }
+};
+
+/**
+ * Per-file and per-site bin counts derived from PRRs, reconciled with HBR/SBR
+ *
+ * One pass over the PRR columns (a few thousand rows against millions of
+ * measurements) counts parts per (head, site, bin) for both bin kinds;
+ * HBR/SBR rows are then matched by key. Bins a summary record lists but no
+ * PRR reached show up with part_count 0, so testers that report counts the
+ * PRRs disagree with are visible as rows whose matches() is false.
+ *
+ * Rows are sorted hard before soft, whole-file before per-site, then by
+ * head, site and bin.
+ */
+class BinSummary {
+public:
+    void build(const STDFColumnarStore& store);
+    void clear();
+
+    const std::vector<BinCount>& bins() const { return bins_; }
+    const std::vector<SiteYield>& yields() const { return yields_; }
+    size_t mismatched_bins() const;  // Reported bins whose count differs
+
+private:
+    std::vector<BinCount> bins_;
+    std::vector<SiteYield> yields_;
+};
+
+#endif // BIN_SUMMARY_H
@@ -0,0 +1,77 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+/**
+ * Multi-producer, multi-consumer queue of at most `capacity` items
+ *
+ * push() blocks while the queue is full, so producers slow down to the
+ * pace of the consumers instead of piling up items. close() wakes every
+ * waiter: later pushes fail, and pops drain what is left, then fail.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1), closed_(false), peak_(0) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // False (item untouched) once the queue is closed
+    bool push(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        if (items_.size() > peak_) {
+            peak_ = items_.size();
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // False once the queue is closed and empty
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    // Most items ever queued at once
+    size_t peak() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_;
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool closed_;
+    size_t peak_;
+};
+
+#endif // BOUNDED_QUEUE_H
@@ -0,0 +1,101 @@
+#ifndef BYTE_ORDER_H
+#define BYTE_ORDER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+inline uint16_t byte_swap16(uint16_t v) {
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+}
+
+inline uint32_t byte_swap32(uint32_t v) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(v);
+#else
+    return ((v & 0x000000FFu) << 24) | ((v & 0x0000FF00u) << 8) |
+           ((v & 0x00FF0000u) >> 8)  | ((v & 0xFF000000u) >> 24);
+#endif
+}
+
+inline uint64_t byte_swap64(uint64_t v) {
+    return (static_cast<uint64_t>(byte_swap32(static_cast<uint32_t>(v))) << 32) |
+           byte_swap32(static_cast<uint32_t>(v >> 32));
+}
+
+/**
+ * Unaligned host-order loads from STDF bytes, with the file's byte order
+ * fixed at compile time
+ *
+ * FileByteOrder<false> reads files written in host order (plain memcpy),
+ * FileByteOrder<true> the opposite order (e.g. CPU_TYP 1, Sun-era
+ * big-endian files, on x86). Decoders are instantiated for both and the
+ * instance is picked once per file from the FAR, so no per-field branch
+ * on byte order is left in the inner loops.
+ */
+template<bool Swap>
+struct FileByteOrder {
+    static uint16_t u2(const uint8_t* p) {
+        uint16_t v;
+        std::memcpy(&v, p, 2);
+        return Swap ? byte_swap16(v) : v;
+    }
+    static uint32_t u4(const uint8_t* p) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return Swap ? byte_swap32(v) : v;
+    }
+    static uint64_t u8(const uint8_t* p) {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return Swap ? byte_swap64(v) : v;
+    }
+    static float r4(const uint8_t* p) {
+        uint32_t bits = u4(p);
+        float v;
+        std::memcpy(&v, &bits, 4);
+        return v;
+    }
+    static double r8(const uint8_t* p) {
+        uint64_t bits = u8(p);
+        double v;
+        std::memcpy(&v, &bits, 8);
+        return v;
+    }
+
+    // count unaligned elements at src into dst (arrays such as MPR RTN_RSLT)
+    static void copy_u2(uint16_t* dst, const uint8_t* src, size_t count);
+    static void copy_u4(void* dst, const uint8_t* src, size_t count);  // U4 or R4
+};
+
+// Bulk byte swap of unaligned input into dst (no overlap): dst[i] =
+// swapped src[i]; 32-bit elements may be U4/I4 or R4. SSE2 or AVX2 on
+// x86-64 and NEON on AArch64, picked once at runtime like
+// numeric_convert.h's kernels.
+void byte_swap_copy16(uint16_t* dst, const uint8_t* src, size_t count);
+void byte_swap_copy32(void* dst, const uint8_t* src, size_t count);
+
+// Kernel in use: "avx2", "sse2", "neon" or "scalar"
+const char* byte_swap_implementation();
+
+template<>
+inline void FileByteOrder<false>::copy_u2(uint16_t* dst, const uint8_t* src, size_t count) {
+    std::memcpy(dst, src, 2 * count);
+}
+
+template<>
+inline void FileByteOrder<false>::copy_u4(void* dst, const uint8_t* src, size_t count) {
+    std::memcpy(dst, src, 4 * count);
+}
+
+template<>
+inline void FileByteOrder<true>::copy_u2(uint16_t* dst, const uint8_t* src, size_t count) {
+    byte_swap_copy16(dst, src, count);
+}
+
+template<>
+inline void FileByteOrder<true>::copy_u4(void* dst, const uint8_t* src, size_t count) {
+    byte_swap_copy32(dst, src, count);
+}
+
+#endif // BYTE_ORDER_H
@@ -0,0 +1,114 @@
+#ifndef CLICKHOUSE_ENCODER_H
+#define CLICKHOUSE_ENCODER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "measurement_batch.h"
+
+enum class ClickHouseFormat {
+    NATIVE,      // Column-oriented blocks: numeric columns are copied as-is
+    ROW_BINARY   // Row-oriented, no header
+};
+
+/**
+ * Serializes MeasurementBatch rows for a ClickHouse INSERT
+ *
+ * Columns, their ClickHouse names and types all come from
+ * measurement_fields.def. Any subset can be sent, always in field order,
+ * for tables that carry only some of the fields (the others take their
+ * column defaults). Values are little-endian; strings are LEB128 length
+ * + bytes, each dictionary entry encoded once per block.
+ */
+class ClickHouseBlockEncoder {
+public:
+    ClickHouseBlockEncoder();
+
+    // Send only these fields; empty selects all. False on an unknown name.
+    bool set_columns(const std::vector<std::string>& columns);
+
+    // "wld_id, wtp_id, ..." for the selected fields
+    std::string column_list() const;
+    std::string insert_query(const std::string& table, ClickHouseFormat format) const;
+
+    // Append rows [first, first + count) of batch to out
+    void encode(const MeasurementBatch& batch, size_t first, size_t count,
+                ClickHouseFormat format, std::string& out) const;
+    // Bytes encode() appends for all of batch: exact for RowBinary, Native adds its headers
+    size_t encoded_size(const MeasurementBatch& batch) const;
+
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    void encode_native(const MeasurementBatch& batch, size_t first, size_t count, std::string& out) const;
+    void encode_row_binary(const MeasurementBatch& batch, size_t first, size_t count, std::string& out) const;
+
+    std::vector<bool> selected_;  // One flag per MEASUREMENT_FIELD
+    std::string last_error_;
+};
+
+// Where and as whom to insert (ClickHouse HTTP interface)
+struct ClickHouseConnection {
+    std::string host = "localhost";
+    uint16_t port = 8123;
+    std::string database = "default";
+    std::string user = "default";
+    std::string password;
+};
+
+/**
+ * Streams one INSERT over the ClickHouse HTTP interface
+ *
+ * Rows are encoded block by block and sent as HTTP chunks, so only one
+ * block is ever held in memory. The server answers once the whole body
+ * has arrived; anything but 200 fails the insert with the server's
+ * message in get_last_error().
+ */
+class ClickHouseHttpInserter {
+public:
+    explicit ClickHouseHttpInserter(const ClickHouseConnection& connection);
+    ~ClickHouseHttpInserter();
+
+    ClickHouseHttpInserter(const ClickHouseHttpInserter&) = delete;
+    ClickHouseHttpInserter& operator=(const ClickHouseHttpInserter&) = delete;
+
+    // Keep the connection open between inserts (HTTP keep-alive). A kept
+    // connection the server dropped while idle is reopened once, as long
+    // as no response had started.
+    void set_keep_alive(bool keep_alive);
+
+    bool insert(const std::string& table, const MeasurementBatch& batch, const ClickHouseBlockEncoder& encoder,
+                ClickHouseFormat format = ClickHouseFormat::NATIVE, size_t block_rows = 1 << 20);
+    // An INSERT whose body is already encoded (e.g. replayed from an
+    // InsertSpool); query is the whole "INSERT INTO ... FORMAT ..." statement
+    bool insert_encoded(const std::string& query, const std::string& body);
+
+    size_t get_bytes_sent() const { return bytes_sent_; }
+    size_t get_connections_opened() const { return connections_opened_; }
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    // Sends one HTTP chunk of the body; false once the connection failed
+    using ChunkSender = std::function<bool(const char* data, size_t size)>;
+    // Sends the whole body through send_chunk, again on a retry
+    using BodyWriter = std::function<bool(const ChunkSender& send_chunk)>;
+
+    // POSTs query with the body write_body produces, on the kept
+    // connection or a new one
+    bool post(const std::string& query, const BodyWriter& write_body);
+    // One request on the open connection: status, or 0 with response
+    // empty when nothing came back
+    int send_request(const std::string& head, const BodyWriter& write_body, bool& sent, std::string& response);
+    void disconnect();
+
+    ClickHouseConnection connection_;
+    bool keep_alive_;
+    intptr_t socket_;   // Platform socket handle, -1 when closed
+    size_t bytes_sent_;
+    size_t connections_opened_;
+    std::string last_error_;
+};
+
+#endif // CLICKHOUSE_ENCODER_H
@@ -0,0 +1,51 @@
+#ifndef COLUMNAR_CACHE_H
+#define COLUMNAR_CACHE_H
+
+#include <string>
+#include <cstdint>
+#include "columnar_store.h"
+
+// Decode statistics kept with a cached store
+struct ColumnarCacheInfo {
+    uint64_t total_records = 0;
+    uint64_t parsed_records = 0;
+};
+
+/**
+ * On-disk cache of decoded STDF as typed, compressed columns
+ *
+ * One file per STDF content hash (STDFParser::get_content_hash), named
+ * "<hash>.stdfcol" under the cache directory, so renamed or gzip-copied
+ * files share an entry. It holds every column of an STDFColumnarStore in
+ * the order of the field_defs X-macros, each deflated on its own, plus the
+ * string table (in id order, so string ids survive the round trip) and the
+ * MIR records. Loading inflates straight into the column vectors, which
+ * lets UltraFastProcessor rebuild measurements without touching the STDF.
+ *
+ * The layout is tied to the field_defs: a column count or element size
+ * that does not match this build rejects the entry, and the caller decodes
+ * the file again. Entries are written to a temporary name and renamed.
+ */
+class ColumnarCache {
+public:
+    explicit ColumnarCache(const std::string& directory = "");
+
+    void set_directory(const std::string& directory) { directory_ = directory; }
+    const std::string& directory() const { return directory_; }
+    bool enabled() const { return !directory_.empty(); }
+
+    std::string entry_path(const std::string& content_hash) const;
+    bool contains(const std::string& content_hash) const;
+
+    bool save(const std::string& content_hash, const STDFColumnarStore& store, const ColumnarCacheInfo& info) const;
+    // Replaces store; false (store cleared) when there is no usable entry
+    bool load(const std::string& content_hash, STDFColumnarStore& store, ColumnarCacheInfo& info) const;
+
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    std::string directory_;
+    mutable std::string last_error_;
+};
+
+#endif // COLUMNAR_CACHE_H
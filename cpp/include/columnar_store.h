@@ -0,0 +1,197 @@
+#ifndef COLUMNAR_STORE_H
+#define COLUMNAR_STORE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <libstdf.h>
+#include "stdf_parser.h"
+
+/**
+ * Typed structure-of-arrays record store
+ *
+ * One column per FIELD() in cpp/field_defs/<record>_fields.def, typed after
+ * the libstdf struct member it names, so numeric fields stay native instead
+ * of going through std::to_string/std::stod. Variable-length members are
+ * mapped to fixed-width columns:
+ *   - Cn (char*)            -> uint32_t id into the shared StringTable
+ *   - xR4 (float*)          -> uint32_t offset into STDFColumnarStore::float_pool
+ *   - Bn/Dn/xN1 (uchar*)    -> uint8_t presence flag
+ *
+ * Every table also carries record_index (1-based ordinal in the file, same
+ * as STDFRecord::record_index) so rows of different types can be merged
+ * back into file order. PTR/MPR keep REC_LEN as well, which tells fields
+ * left out of a truncated record apart from real zeros (see
+ * TestDefinitionCache). MPR RTN_STAT/RTN_INDX are kept typed as well: one
+ * state nibble per byte in state_pool and the U2 pin indices in pin_pool,
+ * RTN_ICNT entries each (zeros when the record is too short to carry
+ * them). PIR rows are kept whenever PRR is enabled so
+ * tests can be attached to the part bracket they were measured in.
+ */
+
+// Bump allocator for string bytes. Blocks never move, so views into the
+// arena stay valid until clear(), which releases everything at once.
+class StringArena {
+public:
+    explicit StringArena(size_t block_size = 64 * 1024);
+
+    std::string_view store(std::string_view value);
+    void clear();
+    size_t bytes_used() const { return bytes_used_; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_;
+    size_t block_used_;   // Bytes taken in blocks_.back()
+    size_t bytes_used_;
+};
+
+// Deduplicated string storage on a StringArena; id 0 is always the empty
+// string. Views returned by get() live as long as the table (moves keep
+// them valid, copies are not allowed).
+class StringTable {
+public:
+    StringTable();
+
+    StringTable(StringTable&&) = default;
+    StringTable& operator=(StringTable&&) = default;
+
+    uint32_t intern(std::string_view value);
+    uint32_t intern_cn(const char* cn);  // libstdf length-prefixed Cn
+
+    std::string_view get(uint32_t id) const { return strings_[id]; }
+    size_t size() const { return strings_.size(); }
+    size_t bytes_used() const { return arena_.bytes_used(); }
+    void clear();
+
+private:
+    StringArena arena_;
+    std::vector<std::string_view> strings_;
+    std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+// Column element type for a libstdf member type
+template<typename T> struct ColumnStorage { using type = T; };
+template<> struct ColumnStorage<char*> { using type = uint32_t; };
+template<> struct ColumnStorage<float*> { using type = uint32_t; };
+template<> struct ColumnStorage<unsigned char*> { using type = uint8_t; };
+
+template<typename T>
+using column_t = std::vector<typename ColumnStorage<T>::type>;
+
+struct PTRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_ptr::member)> member;
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    std::vector<uint16_t> rec_len;
+    size_t size() const { return record_index.size(); }
+};
+
+struct MPRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_mpr::member)> member;
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    std::vector<uint16_t> rec_len;
+    std::vector<uint32_t> state_offset;  // Into STDFColumnarStore::state_pool
+    std::vector<uint32_t> pin_offset;    // Into STDFColumnarStore::pin_pool
+    size_t size() const { return record_index.size(); }
+};
+
+struct FTRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_ftr::member)> member;
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    size_t size() const { return record_index.size(); }
+};
+
+struct PIRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_pir::member)> member;
+    #include "../field_defs/pir_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    size_t size() const { return record_index.size(); }
+};
+
+struct PRRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_prr::member)> member;
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    size_t size() const { return record_index.size(); }
+};
+
+struct HBRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_hbr::member)> member;
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    size_t size() const { return record_index.size(); }
+};
+
+struct SBRColumns {
+    #define FIELD(name, member) column_t<decltype(rec_sbr::member)> member;
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+    std::vector<uint32_t> record_index;
+    size_t size() const { return record_index.size(); }
+};
+
+// Rows to keep in STDFColumnarStore::retain, one flag per row of each table
+struct STDFRowSelection {
+    std::vector<uint8_t> ptr, mpr, ftr, pir, prr, hbr, sbr;
+};
+
+class STDFColumnarStore {
+public:
+    void append(const rec_ptr& rec, uint32_t record_index);
+    void append(const rec_mpr& rec, uint32_t record_index);
+    void append(const rec_ftr& rec, uint32_t record_index);
+    void append(const rec_pir& rec, uint32_t record_index);
+    void append(const rec_prr& rec, uint32_t record_index);
+    void append(const rec_hbr& rec, uint32_t record_index);
+    void append(const rec_sbr& rec, uint32_t record_index);
+
+    // Append every row of another store (e.g. one decoded chunk), remapping
+    // its string ids and float_pool offsets into this store
+    void append_store(const STDFColumnarStore& other);
+
+    // Drop the rows not selected, keeping the rest in order. String ids
+    // stay valid (the table is not pruned); the MPR pools are compacted to
+    // the kept rows' results, states and pins. MIR records are kept.
+    void retain(const STDFRowSelection& keep);
+
+    // Convenience accessors
+    std::string_view str(uint32_t id) const { return strings.get(id); }
+    const float* mpr_results(size_t row) const { return float_pool.data() + mpr.RTN_RSLT[row]; }
+    size_t mpr_result_count(size_t row) const { return mpr.RSLT_CNT[row]; }
+    const uint8_t* mpr_states(size_t row) const { return state_pool.data() + mpr.state_offset[row]; }
+    const uint16_t* mpr_pins(size_t row) const { return pin_pool.data() + mpr.pin_offset[row]; }
+    size_t mpr_pin_count(size_t row) const { return mpr.RTN_ICNT[row]; }
+
+    size_t size() const;  // Decoded records; PIR bracket markers are not counted
+    void clear();
+
+    PTRColumns ptr;
+    MPRColumns mpr;
+    FTRColumns ftr;
+    PIRColumns pir;
+    PRRColumns prr;
+    HBRColumns hbr;
+    SBRColumns sbr;
+
+    // MIR stays a regular record (one per file)
+    std::vector<STDFRecord> mir_records;
+
+    StringTable strings;
+    std::vector<float> float_pool;
+    std::vector<uint8_t> state_pool;   // RTN_STAT nibbles, unpacked
+    std::vector<uint16_t> pin_pool;    // RTN_INDX
+};
+
+#endif // COLUMNAR_STORE_H
@@ -0,0 +1,24 @@
+#ifndef CONSOLE_LOG_H
+#define CONSOLE_LOG_H
+
+#include <ostream>
+
+/**
+ * Console output of the native code, with a process-wide quiet switch
+ *
+ * The library writes progress and warnings to ConsoleLog::out() / err()
+ * instead of std::cout / std::cerr. In quiet mode both return a stream
+ * that discards everything, so embedding services (the Python module,
+ * daemons) get no console output; errors still reach callers through
+ * get_last_error() and return values.
+ */
+class ConsoleLog {
+public:
+    static void set_quiet(bool quiet);
+    static bool is_quiet();
+
+    static std::ostream& out();
+    static std::ostream& err();
+};
+
+#endif // CONSOLE_LOG_H
@@ -0,0 +1,48 @@
+#ifndef CPU_TOPOLOGY_H
+#define CPU_TOPOLOGY_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+/**
+ * NUMA nodes of the machine and the CPUs on each
+ *
+ * system() reads the topology once. On Linux it comes from
+ * /sys/devices/system/node, with only the CPUs the process may run on
+ * (Cpus_allowed_list in /proc/self/status). On Windows it comes from
+ * GetNumaNodeProcessorMaskEx. Elsewhere, or when neither is readable, the
+ * machine is one node.
+ *
+ * bind_current_thread() confines the calling thread to one node's CPUs
+ * rather than to one CPU, so pools that run nested inside each other never
+ * pile onto the same core. Linux places a page on the node of the thread
+ * that first writes it, and threads started later inherit the binding.
+ * So the buffers a bound worker allocates and fills stay on its node.
+ */
+class CPUTopology {
+public:
+    // nodes[n] = CPU numbers of node n (on Windows group * 64 + bit)
+    explicit CPUTopology(std::vector<std::vector<unsigned>> nodes);
+
+    static const CPUTopology& system();
+
+    size_t node_count() const { return nodes_.size(); }
+    const std::vector<unsigned>& node_cpus(size_t node) const { return nodes_[node]; }
+    size_t cpu_count() const;
+
+    // False (and the thread unchanged) when the OS refuses the binding
+    bool bind_current_thread(size_t node) const;
+
+    // Node the calling thread was bound to, or whose CPUs alone it may run
+    // on; -1 when it can run on several nodes
+    int current_thread_node() const;
+
+    // Linux cpulist syntax, e.g. "0-3,8-11"
+    static std::vector<unsigned> parse_cpu_list(const std::string& list);
+
+private:
+    std::vector<std::vector<unsigned>> nodes_;
+};
+
+#endif // CPU_TOPOLOGY_H
@@ -0,0 +1,91 @@
+#ifndef DECOMPRESSING_READER_H
+#define DECOMPRESSING_READER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include "mapped_file.h"
+
+enum class STDFCompression {
+    NONE,
+    GZIP,
+    BZIP2,
+    LZW
+};
+
+// Compression format from the leading magic bytes
+STDFCompression detect_compression(const std::string& filepath);
+
+/**
+ * Pipelined decompressor for compressed STDF files
+ *
+ * Decompression runs on a producer thread that fills a bounded ring of
+ * blocks; the caller drains them with next_block() while the next blocks
+ * are being inflated. Files made of independent members (BGZF gzip blocks,
+ * concatenated bzip2 streams as written by pbzip2) have their members
+ * decompressed on several threads and are still delivered in file order.
+ * Plain single-member files are inflated on the one producer thread.
+ *
+ * Supports gzip (zlib) and, when built with HAVE_BZLIB, bzip2. LZW (.Z)
+ * is left to libstdf.
+ */
+class DecompressingReader {
+public:
+    DecompressingReader();
+    ~DecompressingReader();
+
+    DecompressingReader(const DecompressingReader&) = delete;
+    DecompressingReader& operator=(const DecompressingReader&) = delete;
+
+    // threads: decompression threads for member-parallel files (0 = one per core)
+    bool open(const std::string& filepath, size_t threads = 1);
+    void close();
+
+    // Swaps the next decompressed block into `block` (its previous buffer is
+    // recycled). Blocks until data is ready; false at end of stream or error.
+    bool next_block(std::vector<uint8_t>& block);
+
+    STDFCompression compression() const { return compression_; }
+    size_t member_count() const { return members_.size(); }
+    bool is_parallel() const { return members_.size() > 1 && threads_ > 1; }
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    // Byte range of one independently decompressible member
+    struct Member {
+        size_t offset;
+        size_t length;
+    };
+
+    void find_members();
+    void produce_sequential();
+    void produce_parallel();
+    bool inflate_range(size_t offset, size_t length, std::vector<uint8_t>& out, bool emit_blocks);
+    bool push_block(std::vector<uint8_t>& block);
+    void take_free_block(std::vector<uint8_t>& block);
+    void fail(const std::string& error);
+
+    MappedFile file_;
+    STDFCompression compression_;
+    std::vector<Member> members_;
+    size_t threads_;
+
+    // Ring of decompressed blocks
+    std::deque<std::vector<uint8_t>> ready_;
+    std::vector<std::vector<uint8_t>> free_;
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool finished_;
+    std::atomic<bool> cancelled_;
+    std::thread producer_;
+
+    std::string last_error_;
+};
+
+#endif // DECOMPRESSING_READER_H
@@ -0,0 +1,65 @@
+#ifndef DEVICE_DISCOVERY_H
+#define DEVICE_DISCOVERY_H
+
+#include <vector>
+#include <string>
+#include <cstddef>
+#include "stdf_parser.h"
+#include "test_selection_filter.h"
+
+// Distinct names found in one file of a discovery pass
+struct FileDiscovery {
+    std::string path;
+    bool success = false;
+    std::string error;
+    size_t total_records = 0;
+    double discovery_time = 0.0;
+    std::vector<std::string> devices;     // PRR PART_IDs, sorted
+    std::vector<std::string> parameters;  // Cleaned parameter names, sorted
+};
+
+/**
+ * Device and parameter discovery without generating measurements
+ *
+ * Reads PRR, PTR and MPR records as lazy views (see stdf_record_view.h)
+ * and decodes only PRR PART_ID and the TEST_TXT / ALARM_ID pair of each
+ * test row; each distinct pair is filtered and cleaned once, exactly as
+ * UltraFastProcessor names its parameters. The sets therefore match the
+ * devices and parameters processing the same files would assign IDs to
+ * (tests outside any PIR..PRR bracket, which processing drops, aside).
+ * Empty PART_IDs and names are left out.
+ *
+ * Files are spread over a WorkStealingPool; the merged sets are sorted.
+ */
+class DeviceDiscovery {
+public:
+    DeviceDiscovery();
+
+    void set_num_threads(size_t threads);  // 0 = one per core
+    void set_parser_backend(STDFParserBackend backend) { parser_backend_ = backend; }  // Default MMAP
+    void set_enable_pixel_filtering(bool enable) { enable_pixel_filtering_ = enable; }
+    void set_test_filter_patterns(const std::vector<std::string>& patterns) { test_filter_.set_patterns(patterns); }
+
+    // False when any file failed; the others are still merged
+    bool discover_files(const std::vector<std::string>& paths);
+
+    const std::vector<std::string>& devices() const { return devices_; }
+    const std::vector<std::string>& parameters() const { return parameters_; }
+    const std::vector<FileDiscovery>& file_stats() const { return file_stats_; }
+    double get_discovery_time() const { return discovery_time_; }
+
+private:
+    void discover_file(FileDiscovery& file) const;
+
+    size_t num_threads_;
+    STDFParserBackend parser_backend_;
+    bool enable_pixel_filtering_;
+    TestSelectionFilter test_filter_;
+
+    std::vector<std::string> devices_;
+    std::vector<std::string> parameters_;
+    std::vector<FileDiscovery> file_stats_;
+    double discovery_time_;
+};
+
+#endif // DEVICE_DISCOVERY_H
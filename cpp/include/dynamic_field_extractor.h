@@ -9,10 +9,13 @@
 #include <sstream>
 #include <iostream>
 #include <memory>
+#include <cstdint>
 #include <libstdf.h>
 
 // Use STDFRecord from stdf_parser.h - avoid redefinition
 struct STDFRecord;
+class STDFRecordView;
+enum class STDFRecordType;
 
 // STDF Dynamic Record structure (different from parser's STDFRecord)
 struct DynamicSTDFRecord {
@@ -22,6 +25,51 @@ struct DynamicSTDFRecord {
     std::string filename;
 };
 
+// Field positions in each .def file, used as projection bit indices
+namespace stdf_fields {
+    enum PTRField : unsigned {
+        #define FIELD(name, member) PTR_##member,
+        #include "../field_defs/ptr_fields.def"
+        #undef FIELD
+        PTR_FIELD_COUNT
+    };
+    enum MPRField : unsigned {
+        #define FIELD(name, member) MPR_##member,
+        #include "../field_defs/mpr_fields.def"
+        #undef FIELD
+        MPR_FIELD_COUNT
+    };
+    enum FTRField : unsigned {
+        #define FIELD(name, member) FTR_##member,
+        #include "../field_defs/ftr_fields.def"
+        #undef FIELD
+        FTR_FIELD_COUNT
+    };
+    enum HBRField : unsigned {
+        #define FIELD(name, member) HBR_##member,
+        #include "../field_defs/hbr_fields.def"
+        #undef FIELD
+        HBR_FIELD_COUNT
+    };
+    enum SBRField : unsigned {
+        #define FIELD(name, member) SBR_##member,
+        #include "../field_defs/sbr_fields.def"
+        #undef FIELD
+        SBR_FIELD_COUNT
+    };
+    enum PRRField : unsigned {
+        #define FIELD(name, member) PRR_##member,
+        #include "../field_defs/prr_fields.def"
+        #undef FIELD
+        PRR_FIELD_COUNT
+    };
+}
+
+// One bit per FIELD line, in .def order
+using FieldMask = uint64_t;
+
+constexpr FieldMask field_bit(unsigned index) { return FieldMask(1) << index; }
+
 /**
  * Dynamic Field Extractor using X-Macros approach
  * 
@@ -30,24 +78,48 @@ struct DynamicSTDFRecord {
  * - Compile-time safety with X-Macros
  * - Zero runtime overhead when fields disabled
  * - Automatic field validation
+ *
+ * The enabled field sets are compiled into one FieldMask per record type
+ * whenever the configuration changes, so extraction tests a bit per FIELD
+ * line instead of looking names up in a std::set.
+ *
+ * Configuration (JSON file, JSON text or set_enabled_fields) lists the
+ * record types to extract and their fields; types left out or disabled
+ * extract none, and an empty field list means all of the type's fields:
+ *   {"PTR": {"fields": ["TEST_NUM", "RESULT"]}, "PRR": ["PART_ID"]}
+ * The record types may also sit under "field_extraction_rules", the layout
+ * of python/stdf_field_config.json. A configuration that cannot be parsed
+ * or selects no known field is rejected. Without a configuration file
+ * every .def field is extracted. When a type selects fewer than all of its
+ * fields (is_projected), the decoders push the selection down: they read
+ * the selected fields straight from the record bytes through an
+ * STDFRecordView and skip the rest of the record.
  */
 class DynamicFieldExtractor {
 public:
-    DynamicFieldExtractor(const std::string& config_file = "stdf_field_config.json");
+    // Empty = every field; a file that cannot be used is reported and ignored
+    explicit DynamicFieldExtractor(const std::string& config_file = "");
     
-    // Configuration management
+    // Configuration management (false leaves the selection unchanged)
     bool load_configuration(const std::string& config_file);
     bool reload_configuration();
-    void set_config_from_json(const std::string& json_content);
+    bool set_config_from_json(const std::string& json_content);
+    bool set_enabled_fields(const std::map<std::string, std::set<std::string>>& fields);
+    void enable_all_fields();
     
     // Field extraction interface
     template<typename RecordType>
-    void extract_fields(RecordType* record, DynamicSTDFRecord& out_record);
+    void extract_fields(RecordType* record, DynamicSTDFRecord& out_record) const;
+    
+    // Projected extraction: only the selected fields are decoded from the view
+    void extract_fields(STDFRecordView& view, DynamicSTDFRecord& out_record) const;
+    bool is_projected(STDFRecordType type) const;
     
     // Utility functions
     std::set<std::string> get_enabled_record_types() const;
     std::set<std::string> get_enabled_fields(const std::string& record_type) const;
     std::set<std::string> get_all_available_fields(const std::string& record_type) const;
+    FieldMask get_projection_mask(const std::string& record_type) const;
     
     // Validation
     bool validate_configuration() const;
@@ -57,17 +129,32 @@ private:
     std::string config_file_path_;
     std::map<std::string, std::set<std::string>> enabled_fields_;
     
+    // Compiled projection of enabled_fields_
+    FieldMask ptr_mask_;
+    FieldMask mpr_mask_;
+    FieldMask ftr_mask_;
+    FieldMask hbr_mask_;
+    FieldMask sbr_mask_;
+    FieldMask prr_mask_;
+    
     // Helper functions
-    std::string trim(const std::string& str) const;
+    void rebuild_projection();
     bool parse_json_config(const std::string& json_content);
 };
 
+// Text form of an R4 array field (MPR RTN_RSLT): comma-joined, shortest
+// round-trip digits
+std::string join_r4_array(const float* values, uint16_t count);
+
+// Process-wide extractor shared by every parser backend (created on first use)
+DynamicFieldExtractor& get_shared_field_extractor();
+
 // Template specializations for each record type (implemented in .cpp file)
-template<> void DynamicFieldExtractor::extract_fields<rec_ptr>(rec_ptr* record, DynamicSTDFRecord& out_record);
-template<> void DynamicFieldExtractor::extract_fields<rec_mpr>(rec_mpr* record, DynamicSTDFRecord& out_record);
-template<> void DynamicFieldExtractor::extract_fields<rec_ftr>(rec_ftr* record, DynamicSTDFRecord& out_record);
-template<> void DynamicFieldExtractor::extract_fields<rec_hbr>(rec_hbr* record, DynamicSTDFRecord& out_record);
-template<> void DynamicFieldExtractor::extract_fields<rec_sbr>(rec_sbr* record, DynamicSTDFRecord& out_record);
-template<> void DynamicFieldExtractor::extract_fields<rec_prr>(rec_prr* record, DynamicSTDFRecord& out_record);
+template<> void DynamicFieldExtractor::extract_fields<rec_ptr>(rec_ptr* record, DynamicSTDFRecord& out_record) const;
+template<> void DynamicFieldExtractor::extract_fields<rec_mpr>(rec_mpr* record, DynamicSTDFRecord& out_record) const;
+template<> void DynamicFieldExtractor::extract_fields<rec_ftr>(rec_ftr* record, DynamicSTDFRecord& out_record) const;
+template<> void DynamicFieldExtractor::extract_fields<rec_hbr>(rec_hbr* record, DynamicSTDFRecord& out_record) const;
+template<> void DynamicFieldExtractor::extract_fields<rec_sbr>(rec_sbr* record, DynamicSTDFRecord& out_record) const;
+template<> void DynamicFieldExtractor::extract_fields<rec_prr>(rec_prr* record, DynamicSTDFRecord& out_record) const;
 
 #endif // DYNAMIC_FIELD_EXTRACTOR_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#ifndef FILE_PREFETCHER_H
+#define FILE_PREFETCHER_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+// Totals of a FilePrefetcher run
+struct FilePrefetchStats {
+    size_t files = 0;        // Read ahead, in full or up to the window
+    uint64_t bytes = 0;
+    size_t late = 0;         // Claimed by a decoder before their read ahead finished
+    size_t errors = 0;       // Could not be opened or read (the decoder reports why)
+    double read_time = 0.0;  // Summed over the reader threads
+};
+
+/**
+ * Reads the next files of a multi-file run while the current ones decode
+ *
+ * The schedulers hand it the files in the order their decoders will take
+ * them (largest first, see file_schedule.h). Background threads read the
+ * files nobody has claimed yet, front to back in READ_CHUNK pieces, with
+ * pread() on POSIX and sequential-scan ReadFile on Windows. The data is
+ * discarded. The point is that the bytes are in the page cache when a
+ * decoder opens the file, whether through libstdf's small reads, a
+ * mapping or MappedFile's network read. A file on a NAS then costs its
+ * decoder memory bandwidth instead of round trips.
+ *
+ * At most files_ahead files are read ahead of the decoders, and at most
+ * window_bytes of them are waiting in the cache. A file is read only up
+ * to the window, so one huge file does not evict the others. claimed()
+ * takes a file out of the window as its decoder starts. A file claimed
+ * while it is still being read is read to the end all the same; the
+ * decoder then follows the reader through the cache.
+ */
+class FilePrefetcher {
+public:
+    static constexpr size_t READ_CHUNK = 8 << 20;
+
+    FilePrefetcher();
+    ~FilePrefetcher();  // stop()
+
+    FilePrefetcher(const FilePrefetcher&) = delete;
+    FilePrefetcher& operator=(const FilePrefetcher&) = delete;
+
+    // Applies to the next start(); files_ahead 0 = no read-ahead
+    void set_files_ahead(size_t files) { files_ahead_ = files; }
+    void set_window_bytes(uint64_t bytes) { window_bytes_ = bytes; }
+    void set_threads(size_t threads) { threads_ = threads > 0 ? threads : 1; }
+    size_t files_ahead() const { return files_ahead_; }
+
+    // Starts reading ahead through paths, in the order they will be
+    // claimed; the first `opened` are being decoded already
+    void start(const std::vector<std::string>& paths, size_t opened = 0);
+    // A decoder took paths[index]; it is not read ahead any more
+    void claimed(size_t index);
+    // Stops the readers (between chunks) and waits for them
+    void stop();
+
+    FilePrefetchStats stats() const;
+
+    // Process-wide defaults for prefetchers created afterwards (2 files
+    // ahead, 1 GiB window, 2 reader threads)
+    static void set_default_files_ahead(size_t files);
+    static size_t get_default_files_ahead();
+    static void set_default_window_bytes(uint64_t bytes);
+    static uint64_t get_default_window_bytes();
+
+private:
+    enum class FileState : uint8_t { WAITING, READING, READ, CLAIMED };
+
+    void read_ahead();
+    // Reads up to max_bytes of path into buffer, chunk by chunk; false when it cannot be read
+    bool read_file(const std::string& path, uint64_t max_bytes, std::vector<char>& buffer, uint64_t& bytes);
+
+    size_t files_ahead_;
+    uint64_t window_bytes_;
+    size_t threads_;
+
+    std::vector<std::string> paths_;
+    std::vector<uint64_t> sizes_;
+    std::vector<FileState> states_;
+    size_t next_;                // First file that may still be WAITING
+    size_t ahead_;               // Files READING or READ, not claimed
+    uint64_t window_used_;       // Their bytes
+    bool stopping_;
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<std::thread> readers_;
+    FilePrefetchStats stats_;
+};
+
+#endif // FILE_PREFETCHER_H
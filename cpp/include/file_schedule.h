@@ -0,0 +1,34 @@
+#ifndef FILE_SCHEDULE_H
+#define FILE_SCHEDULE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Largest-first planning for multi-file runs
+ *
+ * Decode time grows with the bytes to decode, so the schedulers stat the
+ * files up front, start the largest first (LPT, longest processing time)
+ * and give a file decode threads in proportion to its share of the bytes.
+ * A large file among many small ones then starts at once with most of the
+ * threads instead of turning up last and running alone on one.
+ */
+
+// gzip/bzip2 STDF typically inflates about this much
+constexpr uint64_t COMPRESSED_COST_FACTOR = 6;
+
+// Estimated decode cost per file: its size, times COMPRESSED_COST_FACTOR
+// when compressed; 0 when it cannot be stat'ed
+std::vector<uint64_t> estimate_file_costs(const std::vector<std::string>& paths);
+
+// Indices of costs, largest first; ties keep input order
+std::vector<size_t> largest_first(const std::vector<uint64_t>& costs);
+
+// Threads for intra-file decoding of a file costing `cost` out of `total`
+// over `files` files on `threads` threads: its share, at least 1. Equal
+// costs give threads / files; without costs every file gets that.
+size_t decode_threads_for(uint64_t cost, uint64_t total, size_t files, size_t threads);
+
+#endif // FILE_SCHEDULE_H
@@ -0,0 +1,127 @@
+#ifndef FLAT_STRING_MAP_H
+#define FLAT_STRING_MAP_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Open-addressing string -> uint32_t table
+ *
+ * Entries live in one vector in insertion order; the slot array holds
+ * only each key's hash and entry index. Probing is linear and the table
+ * grows at half full, so a lookup is usually one or two slot reads and one
+ * key compare. Keys are looked up by string_view with a hash the caller
+ * computed once (hash()), so neither step allocates; a std::string is
+ * only built when a key is inserted.
+ */
+class FlatStringMap {
+public:
+    using Entry = std::pair<std::string, uint32_t>;
+
+    static size_t hash(std::string_view key) { return std::hash<std::string_view>()(key); }
+
+    void reserve(size_t count) {
+        entries_.reserve(count);
+        size_t capacity = slots_.empty() ? 16 : slots_.size();
+        while (capacity < 2 * count) {
+            capacity *= 2;
+        }
+        if (capacity > slots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    // Value stored for key, or nullptr
+    const uint32_t* find(std::string_view key, size_t key_hash) const {
+        if (slots_.empty()) {
+            return nullptr;
+        }
+        const Slot& slot = slots_[probe(key, key_hash)];
+        return slot.entry != EMPTY ? &entries_[slot.entry].second : nullptr;
+    }
+
+    // Adds key -> value unless key is present; the stored value and
+    // whether it was added
+    std::pair<uint32_t, bool> insert(std::string_view key, size_t key_hash, uint32_t value) {
+        grow_for_one();
+        Slot& slot = slots_[probe(key, key_hash)];
+        if (slot.entry != EMPTY) {
+            return {entries_[slot.entry].second, false};
+        }
+        slot = Slot{key_hash, static_cast<uint32_t>(entries_.size())};
+        entries_.emplace_back(std::string(key), value);
+        return {value, true};
+    }
+
+    // Adds or overwrites
+    void assign(std::string_view key, size_t key_hash, uint32_t value) {
+        grow_for_one();
+        Slot& slot = slots_[probe(key, key_hash)];
+        if (slot.entry != EMPTY) {
+            entries_[slot.entry].second = value;
+            return;
+        }
+        slot = Slot{key_hash, static_cast<uint32_t>(entries_.size())};
+        entries_.emplace_back(std::string(key), value);
+    }
+
+    size_t size() const { return entries_.size(); }
+    const std::vector<Entry>& entries() const { return entries_; }  // Insertion order
+
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    struct Slot {
+        size_t hash;
+        uint32_t entry;  // Index into entries_, EMPTY when unused
+    };
+
+    // Slot holding key, or the empty slot where it would go
+    size_t probe(std::string_view key, size_t key_hash) const {
+        const size_t mask = slots_.size() - 1;
+        for (size_t i = key_hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots_[i];
+            if (slot.entry == EMPTY) {
+                return i;
+            }
+            if (slot.hash == key_hash) {
+                const std::string& stored = entries_[slot.entry].first;
+                if (stored.size() == key.size() && std::memcmp(stored.data(), key.data(), key.size()) == 0) {
+                    return i;
+                }
+            }
+        }
+    }
+
+    void grow_for_one() {
+        if (2 * (entries_.size() + 1) > slots_.size()) {
+            rehash(slots_.empty() ? 16 : 2 * slots_.size());
+        }
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> slots(capacity, Slot{0, EMPTY});
+        const size_t mask = capacity - 1;
+        for (const Slot& slot : slots_) {
+            if (slot.entry != EMPTY) {
+                size_t i = slot.hash & mask;
+                while (slots[i].entry != EMPTY) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+        slots_.swap(slots);
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<Entry> entries_;
+};
+
+#endif // FLAT_STRING_MAP_H
@@ -0,0 +1,73 @@
+#ifndef ID_MAP_SNAPSHOT_H
+#define ID_MAP_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+
+/**
+ * Read-only name -> ID table stored as a memory-mapped file
+ *
+ * The file is a header, an open-addressing table (linear probing, a
+ * power-of-two number of slots at most half full) and the names' bytes.
+ * Each slot holds the name's XXH64, its place in the name bytes and its
+ * ID, so open() only maps the file and checks the header and sizes:
+ * loading millions of mappings costs no parsing and no allocation, and
+ * pages are read as lookups touch them.
+ *
+ * write() replaces a snapshot atomically (temporary file + rename);
+ * processes that still map the old file keep reading it. Values are in
+ * host byte order, which the header records.
+ */
+class IDMapSnapshot {
+public:
+    using Mapping = std::pair<std::string, uint32_t>;
+
+    IDMapSnapshot();
+
+    IDMapSnapshot(const IDMapSnapshot&) = delete;
+    IDMapSnapshot& operator=(const IDMapSnapshot&) = delete;
+
+    bool open(const std::string& path);
+
+    bool find(std::string_view name, uint32_t& id) const;
+
+    size_t size() const { return count_; }
+    uint32_t max_id() const { return max_id_; }   // 0 when empty
+    std::vector<Mapping> mappings() const;        // Sorted by ID
+    const std::string& get_last_error() const { return last_error_; }
+
+    // Later duplicates of a name win
+    static bool write(const std::string& path, const std::vector<Mapping>& mappings, std::string& error);
+
+    // One shared mapping per path, reopened once the file was replaced;
+    // nullptr (error set) when it cannot be opened
+    static std::shared_ptr<const IDMapSnapshot> open_shared(const std::string& path, std::string& error);
+
+private:
+    struct Slot {
+        uint64_t hash;         // 0 = empty
+        uint32_t offset;       // Into the name bytes
+        uint32_t length;
+        uint32_t id;
+        uint32_t reserved;
+    };
+
+    static uint64_t hash_name(std::string_view name);
+
+    MappedFile file_;
+    const Slot* slots_;
+    const char* names_;
+    uint64_t names_size_;
+    uint64_t capacity_;
+    size_t count_;
+    uint32_t max_id_;
+    std::string last_error_;
+};
+
+#endif // ID_MAP_SNAPSHOT_H
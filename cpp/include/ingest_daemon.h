@@ -0,0 +1,196 @@
+#ifndef INGEST_DAEMON_H
+#define INGEST_DAEMON_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include "insert_pipeline.h"
+#include "ingest_manifest.h"
+
+/**
+ * Files in a set of directories that are ready to ingest
+ *
+ * Uses inotify on Linux, where a file is ready once it is closed after
+ * writing (IN_CLOSE_WRITE) or moved in (IN_MOVED_TO), and
+ * ReadDirectoryChangesW on Windows. Windows reports changes while the
+ * writer still holds the file open, and the polling fallback (other
+ * systems, or when inotify is unavailable) only lists the directories, so
+ * there a file is ready once its size and modification time have not
+ * changed for the settle time. Subdirectories are not watched.
+ */
+class DirectoryWatcher {
+public:
+    DirectoryWatcher();
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // Only names ending in one of these (case-insensitive); empty = all files
+    void set_extensions(const std::vector<std::string>& extensions) { extensions_ = extensions; }
+    void set_settle_time(std::chrono::milliseconds settle_time) { settle_time_ = settle_time; }
+    void set_poll_interval(std::chrono::milliseconds interval) { poll_interval_ = interval; }
+
+    bool add_directory(const std::string& directory);
+
+    // Matching files in the watched directories, sorted. Files present when
+    // their directory was added are only reported by wait() once they change.
+    std::vector<std::string> scan() const;
+
+    // Appends files that became ready, waiting up to timeout for the first
+    // one; returns early after wake(). False when watching failed.
+    bool wait(std::vector<std::string>& ready, std::chrono::milliseconds timeout);
+    void wake();  // From any thread
+
+    const char* backend() const;  // "inotify", "ReadDirectoryChangesW" or "polling"
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    struct Stamp {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        bool operator==(const Stamp& other) const { return size == other.size && mtime == other.mtime; }
+    };
+    struct Pending {
+        Stamp stamp;
+        std::chrono::steady_clock::time_point stable_since;
+    };
+
+    bool matches(const std::string& name) const;
+    static bool stamp_of(const std::string& path, Stamp& stamp);
+    bool is_polling() const;
+    std::vector<std::string> list_directory(const std::string& directory) const;
+    void set_baseline(const std::string& directory);  // Present files count as reported
+    void add_candidate(const std::string& path);         // Ready once settled
+    void add_ready(const std::string& path, std::vector<std::string>& ready);
+    void check_pending(std::vector<std::string>& ready);
+    void poll_directories();
+    // Blocks for events up to timeout; false on a watch error
+    bool wait_events(std::chrono::milliseconds timeout, std::vector<std::string>& ready);
+
+    std::vector<std::string> directories_;
+    std::vector<std::string> extensions_;
+    std::chrono::milliseconds settle_time_;
+    std::chrono::milliseconds poll_interval_;
+    std::map<std::string, Pending> pending_;   // Changed, not yet settled
+    std::map<std::string, Stamp> reported_;    // As last reported (polling baseline)
+    std::atomic<bool> woken_;
+    std::string last_error_;
+
+#ifdef _WIN32
+    struct WatchedDirectory;
+    std::vector<WatchedDirectory*> watched_;
+    void* wake_event_;
+#else
+    int inotify_fd_;                           // -1 when polling
+    int wake_pipe_[2];
+    std::map<int, std::string> watch_paths_;   // Watch descriptor -> directory
+#endif
+};
+
+// How an IngestDaemon watches and inserts
+struct IngestDaemonConfig {
+    std::vector<std::string> directories;
+    std::vector<std::string> extensions = {".stdf", ".std", ".stdf.gz", ".std.gz", ".stdf.bz2", ".std.bz2"};
+    std::string table = "measurements";
+    ClickHouseConnection connection;
+    std::string manifest_path;                     // Empty: no manifest, every arrival is ingested
+    size_t decode_threads = 0;                     // 0 = one per core
+    size_t insert_threads = 2;
+    size_t queue_depth = 4;
+    size_t block_rows = 1 << 20;
+    size_t coalesce_rows = 0;                      // See InsertPipeline::set_coalesce_rows
+    std::chrono::milliseconds batch_window{500};   // Files ready within it go in one pipeline run
+    std::chrono::milliseconds settle_time{2000};   // See DirectoryWatcher
+    bool ingest_existing = true;                   // Ingest matching files present at start()
+};
+
+// Totals since start()
+struct IngestDaemonStats {
+    size_t batches = 0;
+    size_t files_ingested = 0;
+    size_t files_skipped = 0;       // Already in the manifest
+    size_t files_failed = 0;
+    size_t rows_inserted = 0;
+    size_t connections_opened = 0;
+    double last_latency = 0.0;      // Seconds from a file being ready to its rows landing
+    double max_latency = 0.0;
+};
+
+/**
+ * Watches drop folders and inserts new STDF files as they arrive
+ *
+ * One InsertPipeline serves every batch, with keep-alive connections, so
+ * the device/parameter ID maps loaded once before start() keep growing in
+ * memory and the ClickHouse connections stay open between files. The
+ * manifest stays open too: files already ingested are skipped, and each
+ * file is recorded once all of its rows are in the table, or as failed.
+ *
+ * A background thread collects ready files for batch_window after the
+ * first one arrives, then runs the pipeline over them. Results and the
+ * ID mappings assigned since the last call are picked up with
+ * take_results() and take_new_mappings() (for the dimension tables).
+ * stop() waits for the batch being inserted; files still waiting are left
+ * for the next start() to find.
+ */
+class IngestDaemon {
+public:
+    explicit IngestDaemon(const IngestDaemonConfig& config);
+    ~IngestDaemon();
+
+    IngestDaemon(const IngestDaemon&) = delete;
+    IngestDaemon& operator=(const IngestDaemon&) = delete;
+
+    // Column selection, format, test filter and ID maps; before start()
+    InsertPipeline& pipeline() { return pipeline_; }
+
+    bool start();
+    void stop();
+    bool is_running() const { return running_; }
+
+    // Files finished since the last call, oldest first (measurements = rows inserted)
+    std::vector<FileIngestStats> take_results();
+    // Mappings assigned since the last call, sorted by ID
+    void take_new_mappings(std::vector<std::pair<std::string, uint32_t>>& devices,
+                           std::vector<std::pair<std::string, uint32_t>>& params);
+
+    IngestDaemonStats stats() const;
+    const char* watch_backend() const { return watcher_ ? watcher_->backend() : "none"; }
+    std::string get_last_error() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void run();
+    void ingest(const std::vector<std::string>& paths, const std::vector<Clock::time_point>& ready_at);
+
+    IngestDaemonConfig config_;
+    InsertPipeline pipeline_;
+    std::unique_ptr<DirectoryWatcher> watcher_;  // Created by start()
+    IngestManifest manifest_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<bool> stopping_;
+    std::vector<std::string> initial_files_;
+    size_t published_devices_;   // New mappings already handed out
+    size_t published_params_;
+
+    mutable std::mutex mutex_;   // Guards the members below
+    std::deque<FileIngestStats> results_;
+    std::vector<std::pair<std::string, uint32_t>> new_devices_;
+    std::vector<std::pair<std::string, uint32_t>> new_params_;
+    IngestDaemonStats stats_;
+    std::string last_error_;
+};
+
+#endif // INGEST_DAEMON_H
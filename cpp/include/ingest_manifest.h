@@ -0,0 +1,78 @@
+#ifndef INGEST_MANIFEST_H
+#define INGEST_MANIFEST_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+enum class ManifestStatus {
+    INGESTED,
+    FAILED
+};
+
+// Last known state of one file
+struct ManifestEntry {
+    std::string path;           // Absolute, normalized
+    uint64_t size = 0;
+    int64_t mtime = 0;          // filesystem clock ticks, as in STDFRecordIndex
+    std::string content_hash;   // STDFParser::get_content_hash, may be empty
+    ManifestStatus status = ManifestStatus::INGESTED;
+};
+
+/**
+ * Local record of processed files, so re-scans skip what is already in
+ * the database without asking it or reading the files again
+ *
+ * The manifest is an append-only text file, one tab-separated line per
+ * record() (status, size, mtime, hash, path); on open the last line per
+ * path wins. A file counts as ingested only while its size and mtime
+ * still match the entry, so a rewritten file is picked up again. Lookups
+ * only stat the file. compact() rewrites the file with one line per path.
+ *
+ * Thread-safe; one process should write a given manifest at a time.
+ */
+class IngestManifest {
+public:
+    IngestManifest();
+
+    // Loads an existing manifest; a missing file is an empty manifest,
+    // created on the first record()
+    bool open(const std::string& manifest_path);
+    void close();
+    bool is_open() const { return !manifest_path_.empty(); }
+
+    // True when path was ingested and is unchanged since; content_hash
+    // (optional) receives the hash recorded for it
+    bool is_ingested(const std::string& path, std::string* content_hash = nullptr) const;
+    // True when a file with this content was ingested under any path
+    bool contains_hash(const std::string& content_hash) const;
+    bool lookup(const std::string& path, ManifestEntry& entry) const;
+
+    // Stats path now and appends its state (flushed before returning)
+    bool record(const std::string& path, const std::string& content_hash, ManifestStatus status);
+    bool compact();
+
+    size_t size() const;
+    std::vector<ManifestEntry> entries() const;  // Sorted by path
+    const std::string& get_last_error() const { return last_error_; }
+
+    static std::string normalize_path(const std::string& path);
+    static bool file_stamp(const std::string& path, uint64_t& size, int64_t& mtime);
+
+private:
+    void apply(const ManifestEntry& entry);
+    static std::string format_line(const ManifestEntry& entry);
+
+    mutable std::mutex mutex_;
+    std::string manifest_path_;
+    std::ofstream out_;
+    std::map<std::string, ManifestEntry> entries_;
+    std::unordered_map<std::string, size_t> ingested_hashes_;  // Hash -> ingested paths carrying it
+    mutable std::string last_error_;
+};
+
+#endif // INGEST_MANIFEST_H
@@ -0,0 +1,173 @@
+#ifndef INSERT_PIPELINE_H
+#define INSERT_PIPELINE_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <cstddef>
+#include "ultra_fast_processor.h"
+#include "clickhouse_encoder.h"
+#include "batch_ingest_engine.h"
+#include "ingest_manifest.h"
+#include "insert_spool.h"
+
+// Totals of one InsertPipeline::run()
+struct InsertPipelineStats {
+    size_t blocks_inserted = 0;
+    size_t rows_inserted = 0;
+    size_t connections_opened = 0;
+    size_t bytes_sent = 0;
+    size_t blocks_spooled = 0;     // Written to the insert spool
+    size_t blocks_replayed = 0;    // Left by earlier runs, sent first
+    size_t blocks_pending = 0;     // Still in the spool afterwards
+    size_t files_coalesced = 0;    // Last rows shared a block with other files
+    size_t files_prefetched = 0;   // Read ahead of their decoder (file_prefetcher.h)
+    uint64_t bytes_prefetched = 0;
+    size_t peak_queue_depth = 0;   // Most blocks waiting at once
+    double backpressure_time = 0.0; // Decode-worker seconds spent waiting for a free slot
+    double total_time = 0.0;
+};
+
+/**
+ * Decode workers feeding insert workers through a bounded queue
+ *
+ * Decode workers take files largest first (file_schedule.h), decode each
+ * on its share of the decode threads and cut its rows into blocks of
+ * block_rows (UltraFastProcessor::process_stdf_file_in_batches).
+ * Meanwhile a FilePrefetcher reads the next files in that order into the
+ * page cache, so a decoder moving on does not wait for the disk or NAS.
+ * Blocks go onto a queue of at most queue_depth blocks; insert workers
+ * take them off and send each one as its own INSERT. When ClickHouse
+ * falls behind, the queue fills and decoding waits, so memory stays
+ * around (queue_depth + workers) blocks plus the files being decoded,
+ * whatever the number or size of the files.
+ *
+ * A block shares ownership of the processor whose string table its
+ * dictionaries view; the processor is freed after the file's last block
+ * is sent. All processors assign IDs from one shared FastIDManager.
+ *
+ * Small files would each make an INSERT, and so a MergeTree part, of
+ * their own. With set_coalesce_rows, the last block of each file is held
+ * back until the file is decoded and, when smaller than that, appended to
+ * a block shared with the next files. That block is sent once it reaches
+ * coalesce_rows (or coalesce_bytes). Every row keeps its file_hash, and a
+ * file counts as done only once its part of the shared block is in.
+ *
+ * The first failed INSERT stops the pipeline: decoding stops, queued
+ * blocks are dropped and unfinished files are reported as failed. A
+ * file succeeds only if it parsed and every one of its blocks landed.
+ *
+ * With an insert spool (insert_spool.h), each block is encoded and
+ * written to the spool before its INSERT, and deleted once the INSERT
+ * succeeds. Blocks left in the spool by an earlier run are sent before
+ * anything is decoded. A failed INSERT then no longer stops the decoding.
+ * The remaining blocks go to the spool only, and a file succeeds once all
+ * its blocks are either inserted or in the spool. It is not decoded
+ * again; the next run, or InsertSpool::replay(), sends the rest. The
+ * spooled blocks of a file that did not finish are dropped. A file given
+ * to run() whose blocks are still in the spool is not decoded, under any
+ * spelling of its path: it succeeds once they are replayed (or stay
+ * spooled). One rewritten since (other size or mtime) is decoded again.
+ */
+class InsertPipeline {
+public:
+    explicit InsertPipeline(const ClickHouseConnection& connection);
+
+    void set_decode_threads(size_t threads);  // 0 = one per core
+    void set_insert_threads(size_t threads) { insert_threads_ = threads > 0 ? threads : 1; }
+    void set_queue_depth(size_t blocks) { queue_depth_ = blocks > 0 ? blocks : 1; }
+    void set_block_rows(size_t rows) { block_rows_ = rows > 0 ? rows : 1; }
+    // Merge the last blocks of files shorter than this into shared blocks
+    // of at least this many rows; 0 = one INSERT per file at least (default)
+    void set_coalesce_rows(size_t rows) { coalesce_rows_ = rows; }
+    // Also send a merged block once it reaches about this many body bytes; 0 = no limit
+    void set_coalesce_bytes(size_t bytes) { coalesce_bytes_ = bytes; }
+    void set_format(ClickHouseFormat format) { format_ = format; }
+    void set_parser_backend(STDFParserBackend backend) { parser_backend_ = backend; }
+    void set_test_filter_patterns(const std::vector<std::string>& patterns);
+    void set_file_hashes(const std::vector<std::string>& hashes) { file_hashes_ = hashes; }
+    // Same contract as BatchIngestEngine::set_manifest
+    void set_manifest(const IngestManifest* manifest) { manifest_ = manifest; }
+    // Spool opened by the caller, outliving the runs; nullptr = none
+    void set_insert_spool(InsertSpool* spool) { spool_ = spool; }
+    // Insert workers keep their ClickHouse connections open between
+    // inserts and across runs (see ClickHouseHttpInserter::set_keep_alive)
+    void set_keep_alive(bool keep_alive);
+
+    ClickHouseBlockEncoder& encoder() { return encoder_; }  // Column selection
+    FastIDManager& id_manager() { return id_manager_; }
+
+    // False when any file failed
+    bool run(const std::string& table, const std::vector<std::string>& paths);
+
+    const std::vector<FileIngestStats>& file_stats() const { return file_stats_; }  // measurements = rows inserted
+    const InsertPipelineStats& stats() const { return stats_; }
+    size_t connections_opened() const;  // Over all runs
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    // Rows of one file in a block
+    struct BlockPart {
+        size_t file = 0;
+        size_t rows = 0;
+        std::shared_ptr<UltraFastProcessor> owner;  // Keeps the dictionaries' text alive
+    };
+    // One INSERT: rows of one file, or the last rows of several when coalesced
+    struct Block {
+        std::vector<BlockPart> parts;
+        MeasurementBatch rows;
+        size_t body_bytes = 0;  // Estimated, while coalescing
+    };
+
+    void fail(const std::string& error);
+    // Inserts one block, through the spool when there is one; false when
+    // the block is lost (the pipeline stops)
+    bool deliver(ClickHouseHttpInserter& inserter, const std::string& table, Block& block);
+    // Every block of the file delivered, and it is decoded
+    bool file_complete(size_t file) const;
+    // Complete, and so is every file sharing its coalesced block
+    bool file_settled(size_t file) const;
+    // Commits the spool groups of the file (and of the files sharing its
+    // coalesced block) once it is settled. Caller holds mutex_.
+    void settle_file(size_t file);
+
+    ClickHouseConnection connection_;
+    size_t decode_threads_;
+    size_t insert_threads_;
+    size_t queue_depth_;
+    size_t block_rows_;
+    size_t coalesce_rows_;
+    size_t coalesce_bytes_;
+    ClickHouseFormat format_;
+    STDFParserBackend parser_backend_;
+    bool has_patterns_;
+    std::vector<std::string> test_patterns_;
+    std::vector<std::string> file_hashes_;
+    const IngestManifest* manifest_;
+    InsertSpool* spool_;
+    ClickHouseBlockEncoder encoder_;
+    bool keep_alive_;
+    std::vector<std::unique_ptr<ClickHouseHttpInserter>> inserters_;  // One per insert worker
+    size_t connections_closed_;   // Opened by inserters since dropped
+
+    FastIDManager id_manager_;
+    std::vector<FileIngestStats> file_stats_;
+    std::vector<size_t> blocks_queued_;    // Per file
+    std::vector<size_t> blocks_inserted_;
+    std::vector<size_t> blocks_spooled_;   // Per file: left in the spool
+    std::vector<uint64_t> spool_groups_;
+    std::vector<std::string> spool_sources_;  // spool_source() of each file, taken before it is decoded
+    std::vector<uint64_t> tail_groups_;    // Spool group of the file's coalesced block, 0 = none
+    std::map<uint64_t, std::vector<size_t>> coalesced_files_;  // By spool group
+    std::vector<char> decoded_;
+    std::atomic<bool> inserts_failing_;    // With a spool: blocks only go to the spool
+    InsertPipelineStats stats_;
+    std::mutex mutex_;                     // Guards the above during run()
+    std::atomic<bool> stopped_;
+    std::string last_error_;
+};
+
+#endif // INSERT_PIPELINE_H
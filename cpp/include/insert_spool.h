@@ -0,0 +1,117 @@
+#ifndef INSERT_SPOOL_H
+#define INSERT_SPOOL_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include "clickhouse_encoder.h"
+
+// One encoded INSERT waiting in an InsertSpool
+struct InsertSpoolEntry {
+    uint64_t group = 0;
+    uint64_t sequence = 0;      // Order written, over all groups
+    std::string path;
+    std::string query;          // INSERT INTO ... FORMAT ...
+    std::string file_hash;      // Of the STDF file the rows came from
+    std::string source;         // Its name (InsertPipeline: size, mtime and path; see spool_source)
+    uint64_t rows = 0;
+    uint64_t body_bytes = 0;    // Encoded
+    uint64_t stored_bytes = 0;  // On disk
+};
+
+// Totals of an InsertSpool since open()
+struct InsertSpoolStats {
+    size_t written = 0;
+    size_t written_bytes = 0;   // On disk
+    size_t acknowledged = 0;    // Deleted after ClickHouse took them
+    size_t replayed = 0;        // Of those, sent by replay()
+    size_t discarded = 0;       // Of groups never committed or abandoned
+    size_t corrupt = 0;         // Failed their checksum; renamed to .corrupt
+};
+
+/**
+ * Encoded measurement blocks kept on local disk until ClickHouse has them
+ *
+ * Each block is written before its INSERT is sent and deleted once the
+ * server answered 200, so a failed insert or a dead process leaves the
+ * block on disk instead of only in memory. An entry holds the INSERT
+ * query, the STDF file's hash and path, and the encoded body
+ * zlib-compressed at the fastest level. A CRC-32 covers all of it. Entries
+ * are written to a temporary name and renamed, so a crash mid-write
+ * leaves no half entry behind.
+ *
+ * Entries belong to a group, one per STDF file, or one per block that
+ * coalesces the last rows of several files (file_hash and source then
+ * list them one per line). A group becomes
+ * replayable only once commit() says all its blocks are in, which means
+ * the file never needs decoding again. open() deletes the entries of
+ * groups that were not committed. Those files are decoded again (they
+ * were not recorded as ingested), so replaying their blocks as well would
+ * insert those rows twice.
+ *
+ * replay() sends the committed entries, oldest first, with plain
+ * ClickHouseHttpInserter::insert_encoded calls; no STDF is re-read. One
+ * process uses a spool directory at a time; all methods are thread-safe.
+ */
+class InsertSpool {
+public:
+    InsertSpool();
+
+    // Creates dir if needed and takes over what an earlier process left
+    // there (see above). False when dir cannot be created or listed.
+    bool open(const std::string& dir);
+    bool is_open() const { return !dir_.empty(); }
+    const std::string& dir() const { return dir_; }
+
+    uint64_t begin_group();
+
+    // Writes one block (before its INSERT); entry describes it for acknowledge()
+    bool write(uint64_t group, const std::string& query, const std::string& body, uint64_t rows,
+               const std::string& file_hash, const std::string& source, InsertSpoolEntry& entry);
+
+    // Every block of group has been written (or acknowledged already)
+    bool commit(uint64_t group);
+    // Drops group's remaining blocks (its file is going to be decoded again)
+    void abandon(uint64_t group);
+    // ClickHouse took the entry: deletes it
+    void acknowledge(const InsertSpoolEntry& entry);
+
+    // Committed entries not yet acknowledged, oldest first
+    std::vector<InsertSpoolEntry> pending() const;
+    size_t pending_count() const;
+
+    // Body of an entry; false when it cannot be read or fails its checksum
+    bool read(const InsertSpoolEntry& entry, std::string& body) const;
+
+    // Inserts the pending entries, oldest first, acknowledging each one
+    // the server took. Corrupt entries are set aside and skipped. Stops at
+    // the first failed INSERT (false, error in get_last_error()).
+    bool replay(ClickHouseHttpInserter& inserter);
+
+    InsertSpoolStats stats() const;
+    std::string get_last_error() const;
+
+private:
+    struct Group {
+        bool committed = false;
+        std::map<uint64_t, InsertSpoolEntry> entries;  // By sequence
+    };
+
+    std::string entry_path(uint64_t group, uint64_t sequence) const;
+    std::string commit_path(uint64_t group) const;
+    bool read_entry(const std::string& path, InsertSpoolEntry& entry, std::string* body) const;
+    void set_aside(const InsertSpoolEntry& entry);
+
+    std::string dir_;
+    mutable std::mutex mutex_;
+    std::map<uint64_t, Group> groups_;
+    uint64_t next_group_;
+    uint64_t next_sequence_;
+    InsertSpoolStats stats_;
+    std::string last_error_;
+};
+
+#endif // INSERT_SPOOL_H
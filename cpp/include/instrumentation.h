@@ -0,0 +1,181 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Process-wide counters for the hot paths
+ *
+ *   - per-stage timers: calls, total and max time, and a latency histogram
+ *     with power-of-two microsecond buckets
+ *   - bytes and records per STDF record type
+ *   - heap allocations per stage (operator new), only with
+ *     STDF_COUNT_ALLOCATIONS=1, since that replaces the global operator new
+ *
+ * Build with STDF_INSTRUMENTATION=0 and StageTimer / RecordCounters
+ * compile to nothing. When compiled in, a stage costs two clock reads and
+ * a few relaxed atomic adds per call; stages are per file, chunk or batch,
+ * never per record. Records are counted into a local RecordCounters by
+ * each decode loop and added to the totals once, when the loop is done.
+ * set_enabled(false) turns the timers off at run time.
+ */
+
+#ifndef STDF_INSTRUMENTATION
+#define STDF_INSTRUMENTATION 1
+#endif
+
+#ifndef STDF_COUNT_ALLOCATIONS
+#define STDF_COUNT_ALLOCATIONS 0
+#endif
+
+enum class InstrumentedStage : uint8_t {
+    PARSE,                   // One file into records or columns (STDFParser)
+    CHUNK_DECODE,            // One chunk of a parallel decode
+    CONTENT_HASH,            // Separate hashing pass (libstdf and mmap paths)
+    FILE_PROCESSING,         // One file through UltraFastProcessor
+    MEASUREMENT_GENERATION,  // One batch of measurement rows
+    PYTHON_CONVERSION,       // Rows into Python tuples or columns
+    CLICKHOUSE_INSERT,       // One INSERT over HTTP
+    SCAN,                    // One header-only file scan
+    COLUMNAR_CACHE,          // One columnar cache entry read or written
+    MEASUREMENT_SORT,        // One batch put in ORDER BY key order
+    COUNT
+};
+
+// STDF V4 record types counted separately; everything else is OTHER
+// (FAR_: libstdf defines FAR as a macro)
+enum class CountedRecordType : uint8_t {
+    FAR_, ATR, MIR, MRR, PCR, HBR, SBR, PMR, PGR, PLR, RDR, SDR,
+    WIR, WRR, WCR, PIR, PRR, TSR, PTR, MPR, FTR, BPS, EPS, GDR, DTR,
+    OTHER,
+    COUNT
+};
+
+const char* stage_name(InstrumentedStage stage);
+const char* counted_record_type_name(CountedRecordType type);
+
+// Inline: decode loops call it once per record
+inline CountedRecordType counted_record_type(uint8_t rec_typ, uint8_t rec_sub) {
+    switch ((rec_typ << 8) | rec_sub) {
+        case (0 << 8) | 10: return CountedRecordType::FAR_;
+        case (0 << 8) | 20: return CountedRecordType::ATR;
+        case (1 << 8) | 10: return CountedRecordType::MIR;
+        case (1 << 8) | 20: return CountedRecordType::MRR;
+        case (1 << 8) | 30: return CountedRecordType::PCR;
+        case (1 << 8) | 40: return CountedRecordType::HBR;
+        case (1 << 8) | 50: return CountedRecordType::SBR;
+        case (1 << 8) | 60: return CountedRecordType::PMR;
+        case (1 << 8) | 62: return CountedRecordType::PGR;
+        case (1 << 8) | 63: return CountedRecordType::PLR;
+        case (1 << 8) | 70: return CountedRecordType::RDR;
+        case (1 << 8) | 80: return CountedRecordType::SDR;
+        case (2 << 8) | 10: return CountedRecordType::WIR;
+        case (2 << 8) | 20: return CountedRecordType::WRR;
+        case (2 << 8) | 30: return CountedRecordType::WCR;
+        case (5 << 8) | 10: return CountedRecordType::PIR;
+        case (5 << 8) | 20: return CountedRecordType::PRR;
+        case (10 << 8) | 30: return CountedRecordType::TSR;
+        case (15 << 8) | 10: return CountedRecordType::PTR;
+        case (15 << 8) | 15: return CountedRecordType::MPR;
+        case (15 << 8) | 20: return CountedRecordType::FTR;
+        case (20 << 8) | 10: return CountedRecordType::BPS;
+        case (20 << 8) | 20: return CountedRecordType::EPS;
+        case (50 << 8) | 10: return CountedRecordType::GDR;
+        case (50 << 8) | 30: return CountedRecordType::DTR;
+        default: return CountedRecordType::OTHER;
+    }
+}
+
+// Records seen by one decode loop; add_records() folds them into the totals
+class RecordCounters {
+public:
+    RecordCounters() : counts_(), bytes_() {}
+
+    void add(uint8_t rec_typ, uint8_t rec_sub, size_t length) {
+#if STDF_INSTRUMENTATION
+        size_t type = static_cast<size_t>(counted_record_type(rec_typ, rec_sub));
+        counts_[type]++;
+        bytes_[type] += length + 4;  // Header included
+#else
+        (void)rec_typ; (void)rec_sub; (void)length;
+#endif
+    }
+
+    void clear() { *this = RecordCounters(); }
+
+    uint64_t count(CountedRecordType type) const { return counts_[static_cast<size_t>(type)]; }
+    uint64_t bytes(CountedRecordType type) const { return bytes_[static_cast<size_t>(type)]; }
+
+private:
+    uint64_t counts_[static_cast<size_t>(CountedRecordType::COUNT)];
+    uint64_t bytes_[static_cast<size_t>(CountedRecordType::COUNT)];
+};
+
+struct StageStats {
+    const char* name = "";
+    uint64_t calls = 0;
+    double total_seconds = 0.0;
+    double max_seconds = 0.0;
+    std::vector<uint64_t> histogram;  // [i]: calls that took < 2^i microseconds (and no less than 2^(i-1))
+    uint64_t allocations = 0;         // Only with STDF_COUNT_ALLOCATIONS
+    uint64_t allocated_bytes = 0;
+};
+
+struct RecordTypeStats {
+    const char* name = "";
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+struct InstrumentationSnapshot {
+    bool compiled = false;
+    bool enabled = false;
+    bool counts_allocations = false;
+    std::vector<StageStats> stages;         // Every stage, in enum order
+    std::vector<RecordTypeStats> records;   // Types seen at least once
+    uint64_t untracked_allocations = 0;     // Outside any stage
+    uint64_t untracked_allocated_bytes = 0;
+};
+
+class Instrumentation {
+public:
+    static constexpr size_t HISTOGRAM_BUCKETS = 32;  // Last bucket: >= 2^30 us (~18 min)
+
+    static void set_enabled(bool enabled);
+    static bool is_enabled();
+
+    static void record_stage(InstrumentedStage stage, uint64_t nanoseconds);
+    static void add_records(const RecordCounters& counters);
+
+    static InstrumentationSnapshot snapshot();
+    static void reset();
+};
+
+// Times the enclosing scope as one call of a stage. Heap allocations made on
+// this thread meanwhile are charged to the stage (innermost timer wins).
+class StageTimer {
+public:
+#if STDF_INSTRUMENTATION
+    explicit StageTimer(InstrumentedStage stage);
+    ~StageTimer();
+#else
+    explicit StageTimer(InstrumentedStage) {}
+#endif
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+#if STDF_INSTRUMENTATION
+private:
+    InstrumentedStage stage_;
+    bool active_;
+    uint8_t previous_stage_;
+    std::chrono::steady_clock::time_point start_;
+#endif
+};
+
+#endif // INSTRUMENTATION_H
@@ -0,0 +1,69 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+// How MappedFile brings a file into memory
+enum class FileReadMode {
+    AUTO,  // Map local files, read network shares (see below)
+    MAP,   // Always map
+    READ   // Always read into an owned buffer
+};
+
+/**
+ * Read-only memory-mapped view of a whole file
+ *
+ * Uses mmap() on POSIX and CreateFileMapping/MapViewOfFile on Windows.
+ * The mapping lives until close() or destruction; pointers returned by
+ * data() must not outlive it.
+ *
+ * Files on network shares (UNC paths and remote drives on Windows, NFS and
+ * SMB mounts on Linux) page in slowly through a mapping, one small fault at
+ * a time. In AUTO mode those are read instead, into a page-aligned buffer
+ * in READ_CHUNK pieces: overlapped ReadFile with READS_IN_FLIGHT requests
+ * outstanding on Windows, pread() on POSIX. Callers see the same data().
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filepath);
+    void close();
+
+    bool is_open() const { return open_; }
+    bool is_mapped() const { return open_ && !buffer_; }  // False once read into memory
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& get_last_error() const { return last_error_; }
+
+    static constexpr size_t READ_CHUNK = 4 << 20;
+    static constexpr size_t READS_IN_FLIGHT = 4;
+
+    // Process-wide, for files opened afterwards (AUTO by default)
+    static void set_default_read_mode(FileReadMode mode);
+    static FileReadMode get_default_read_mode();
+
+private:
+    bool read_into_memory(const std::string& filepath);
+
+    const uint8_t* data_;
+    void* buffer_;  // Owned copy when read rather than mapped
+    size_t size_;
+    bool open_;
+    std::string last_error_;
+
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#else
+    int fd_;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,126 @@
+#ifndef MEASUREMENT_BATCH_H
+#define MEASUREMENT_BATCH_H
+
+#include <vector>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Measurement rows, one struct per row or one column per field
+ *
+ * Both layouts are generated from measurement_fields.def. In the batch,
+ * a numeric field is a plain vector of values and a string field is a
+ * vector of 32-bit codes into the column's own dictionary. The handful of
+ * distinct file hashes, devices, parameter names and units are stored
+ * once per batch, however many rows repeat them; consumers expand a code
+ * only when they need the text.
+ *
+ * Dictionary entries are views, with the same lifetime as the views in
+ * MeasurementTuple (see measurement_fields.def).
+ */
+
+// 🚀 MACRO-DRIVEN: Measurement structure auto-generated from measurement_fields.def
+struct MeasurementTuple {
+    // Define MEASUREMENT_FIELD macro to generate struct members
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        cpp_type name;
+
+    // Include all fields from measurement_fields.def
+    #include "measurement_fields.def"
+
+    // Undefine the macro
+    #undef MEASUREMENT_FIELD
+
+    // Constructor for easy initialization
+    MeasurementTuple() = default;
+};
+
+// rows[i] = old rows[order[i]]
+template<typename T>
+void permute_rows(std::vector<T>& rows, const std::vector<uint32_t>& order) {
+    std::vector<T> permuted(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        permuted[i] = rows[order[i]];
+    }
+    rows.swap(permuted);
+}
+
+// Column of a numeric field
+template<typename T>
+struct MeasurementColumn {
+    std::vector<T> values;
+
+    T operator[](size_t row) const { return values[row]; }
+    void resize(size_t rows) { values.resize(rows); }
+    void clear() { values.clear(); }
+    void append(const MeasurementColumn& other) { values.insert(values.end(), other.values.begin(), other.values.end()); }
+    void permute(const std::vector<uint32_t>& order) { permute_rows(values, order); }
+};
+
+// Column of a string field: per-row codes into a dictionary of distinct values
+template<>
+struct MeasurementColumn<std::string_view> {
+    std::vector<uint32_t> codes;
+    std::vector<std::string_view> dictionary;
+
+    std::string_view operator[](size_t row) const { return dictionary[codes[row]]; }
+    void resize(size_t rows) { codes.resize(rows); }
+    void permute(const std::vector<uint32_t>& order) { permute_rows(codes, order); }
+    void clear() {
+        codes.clear();
+        dictionary.clear();
+        index_.clear();
+    }
+
+    // Codes of the other column are re-encoded into this column's dictionary
+    void append(const MeasurementColumn& other) {
+        std::vector<uint32_t> remap(other.dictionary.size());
+        for (size_t code = 0; code < remap.size(); ++code) {
+            remap[code] = encode(other.dictionary[code]);
+        }
+        codes.reserve(codes.size() + other.codes.size());
+        for (uint32_t code : other.codes) {
+            codes.push_back(remap[code]);
+        }
+    }
+
+    // Code for a value, adding it to the dictionary on first use. Not thread-safe:
+    // encode up front, then fill codes in parallel.
+    uint32_t encode(std::string_view value) {
+        auto it = index_.find(value);
+        if (it != index_.end()) {
+            return it->second;
+        }
+        uint32_t code = static_cast<uint32_t>(dictionary.size());
+        dictionary.push_back(value);
+        index_.emplace(value, code);
+        return code;
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+struct MeasurementBatch {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        MeasurementColumn<cpp_type> name;
+    #include "measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    size_t size() const { return rows_; }
+    void resize(size_t rows);
+    void clear();
+    void append(const MeasurementBatch& other);  // Rows of other after this batch's rows
+    void permute(const std::vector<uint32_t>& order);  // Row i becomes old row order[i]
+
+    // Expand one row / the whole batch into tuples
+    MeasurementTuple row(size_t index) const;
+    std::vector<MeasurementTuple> to_tuples() const;
+
+private:
+    size_t rows_ = 0;
+};
+
+#endif // MEASUREMENT_BATCH_H
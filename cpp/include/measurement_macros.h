@@ -3,24 +3,36 @@
 
 // 🚀 MACRO-DRIVEN: Helper macros for measurement field assignment
 
-// Macro to create a measurement initializer function
-#define INIT_MEASUREMENT(measurement, device_dmc, device_id, test_cache, value, test_flag, file_hash_param) \
+// Macro to fill one row of a MeasurementBatch; string fields take dictionary codes
+#define INIT_MEASUREMENT_ROW(batch, row, device_code, device_id, test_cache, value, test_flag, file_hash_code) \
     do { \
-        measurement.wld_id = device_id; \
-        measurement.wtp_id = test_cache.param_id; \
-        measurement.wp_pos_x = (test_cache.pixel_x != 0) ? test_cache.pixel_x : default_x; \
-        measurement.wp_pos_y = (test_cache.pixel_y != 0) ? test_cache.pixel_y : default_y; \
-        measurement.wptm_value = value; \
-        measurement.test_flag = test_flag; \
-        measurement.segment = 0; \
-        measurement.file_hash = file_hash_param; \
-        measurement.wld_device_dmc = device_dmc; \
-        measurement.wtp_param_name = test_cache.cleaned_param_name; \
-        measurement.units = test_cache.units; \
-        measurement.test_num = test_cache.test_num; \
-        measurement.test_flg = test_cache.test_flg; \
+        batch.wld_id.values[row] = device_id; \
+        batch.wtp_id.values[row] = test_cache.param_id; \
+        batch.wp_pos_x.values[row] = (test_cache.pixel_x != 0) ? test_cache.pixel_x : default_x; \
+        batch.wp_pos_y.values[row] = (test_cache.pixel_y != 0) ? test_cache.pixel_y : default_y; \
+        batch.wptm_value.values[row] = value; \
+        batch.test_flag.values[row] = test_flag; \
+        batch.segment.values[row] = 0; \
+        batch.file_hash.codes[row] = file_hash_code; \
+        batch.wld_device_dmc.codes[row] = device_code; \
+        batch.wtp_param_name.codes[row] = test_cache.name_code; \
+        batch.units.codes[row] = test_cache.units_code; \
+        batch.test_num.values[row] = test_cache.test_num; \
+        batch.test_flg.values[row] = test_cache.test_flg; \
     } while(0)
 
+// ClickHouse ORDER BY key of the measurements table, most significant column
+// first: KEY(name) per numeric field of measurement_fields.def. The schema
+// below and the output presort (measurement_sort.h) both expand it.
+#define MEASUREMENT_SORT_KEY_FIELDS(KEY) \
+    KEY(wld_id) \
+    KEY(wtp_id) \
+    KEY(wp_pos_x) \
+    KEY(wp_pos_y) \
+    KEY(segment)
+
+#define APPEND_SORT_KEY_NAME(name) order_by += order_by.empty() ? #name : ", " #name;
+
 // Macro to generate ClickHouse table schema from field definitions  
 #define GENERATE_CLICKHOUSE_SCHEMA() \
     std::string schema = "CREATE TABLE IF NOT EXISTS measurements (\n"; \
@@ -37,13 +49,16 @@
     /* Add fields using macro expansion */ \
     _Pragma("GCC diagnostic push") \
     _Pragma("GCC diagnostic ignored \"-Wunused-variable\"") \
+    _Pragma("GCC diagnostic ignored \"-Wunused-but-set-variable\"") \
     { \
         auto add_measurement_field = [&](const std::string& n, const std::string& t) { add_field(n, t); }; \
         std::string name, type; /* Dummy variables */ \
         \
         schema += "\n) ENGINE = MergeTree()\n"; \
         schema += "PARTITION BY toYYYYMM(wptm_created_date)\n"; \
-        schema += "ORDER BY (wld_id, wtp_id, wp_pos_x, wp_pos_y, segment)"; \
+        std::string order_by; \
+        MEASUREMENT_SORT_KEY_FIELDS(APPEND_SORT_KEY_NAME) \
+        schema += "ORDER BY (" + order_by + ")"; \
     } \
     _Pragma("GCC diagnostic pop")
 
@@ -0,0 +1,32 @@
+#ifndef MEASUREMENT_SORT_H
+#define MEASUREMENT_SORT_H
+
+#include <vector>
+#include <cstdint>
+#include "measurement_batch.h"
+
+/**
+ * Measurement rows in the measurements table's ORDER BY order
+ *
+ * The key is MEASUREMENT_SORT_KEY_FIELDS (measurement_macros.h), the list
+ * the CREATE TABLE statement's ORDER BY is generated from. A block that
+ * arrives sorted saves ClickHouse the sort of every insert, and parts
+ * written from sorted blocks merge with less work later.
+ *
+ * The rows are ordered by an LSD radix sort, least significant key column
+ * first. Each column is gathered once in the current order and rebased to
+ * its minimum, and only the bytes its range needs get a counting pass. So
+ * a constant segment costs nothing, and IDs below 65536 cost two passes.
+ * The sort is stable: rows with equal keys keep their file order.
+ */
+
+// Order that sorts batch: row i of the sorted batch is row order[i]
+std::vector<uint32_t> measurement_key_order(const MeasurementBatch& batch);
+
+// Sorts batch in place; returns false when it was already sorted (then
+// nothing is moved)
+bool sort_measurements_by_key(MeasurementBatch& batch);
+
+bool measurements_sorted_by_key(const MeasurementBatch& batch);
+
+#endif // MEASUREMENT_SORT_H
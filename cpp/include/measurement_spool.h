@@ -0,0 +1,97 @@
+#ifndef MEASUREMENT_SPOOL_H
+#define MEASUREMENT_SPOOL_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "columnar_store.h"
+#include "measurement_batch.h"
+
+// Totals of a MeasurementSpool since construction or the last clear()
+struct MeasurementSpoolStats {
+    size_t blocks = 0;
+    size_t spilled_blocks = 0;
+    size_t rows = 0;
+    size_t peak_memory_bytes = 0;   // Most bytes held in memory at once
+    size_t spilled_bytes = 0;       // Compressed bytes written to disk
+};
+
+/**
+ * Measurement blocks staged under a memory budget, spilled to disk past it
+ *
+ * Blocks are added from any number of threads, tagged with the index of
+ * the file they came from. Each block keeps its own copy of its
+ * dictionaries' text (a few hundred names against up to millions of rows),
+ * so it does not hold onto the processor that produced it. While the
+ * blocks in memory fit the budget a new block stays in memory; otherwise
+ * it is written zlib-compressed (fastest level) to its own file in the
+ * spill directory and dropped from memory.
+ *
+ * drain() hands the blocks back in file order, blocks of one file in the
+ * order they were added, reading spilled ones back one at a time, and
+ * empties the spool. Peak memory is then the budget plus about one block
+ * per producer and one being read back, whatever the number and size of
+ * the files.
+ */
+class MeasurementSpool {
+public:
+    // memory_budget 0 keeps everything in memory; an empty spill_dir uses
+    // the system temporary directory
+    explicit MeasurementSpool(size_t memory_budget = 0, const std::string& spill_dir = "");
+    ~MeasurementSpool();
+
+    MeasurementSpool(const MeasurementSpool&) = delete;
+    MeasurementSpool& operator=(const MeasurementSpool&) = delete;
+
+    // Rows per block for producers (UltraFastProcessor::process_stdf_file_to_spool);
+    // by default sized so that about eight blocks fit the budget
+    size_t block_rows() const { return block_rows_; }
+    void set_block_rows(size_t rows) { block_rows_ = rows > 0 ? rows : 1; }
+
+    // Takes the block's rows (batch may be moved from). False when spilling failed.
+    bool add(size_t file, MeasurementBatch& batch);
+
+    // Blocks in file order; the batch may be moved from. Stops at the first
+    // sink returning false or block failing to read back (false then).
+    bool drain(const std::function<bool(size_t file, MeasurementBatch& batch)>& sink);
+
+    void clear();  // Drops every block and spill file
+
+    size_t memory_bytes() const;  // Held in memory now
+    MeasurementSpoolStats stats() const;
+    size_t memory_budget() const { return memory_budget_; }
+    const std::string& get_last_error() const { return last_error_; }
+
+    // In-memory size of a batch's columns (dictionary text included)
+    static size_t batch_bytes(const MeasurementBatch& batch);
+
+private:
+    struct Block {
+        size_t file = 0;
+        size_t sequence = 0;          // Order of arrival
+        size_t bytes = 0;             // In memory, or as written
+        std::string spill_path;       // Empty while in memory
+        std::unique_ptr<StringTable> text;
+        MeasurementBatch rows;
+    };
+
+    static void own_dictionaries(MeasurementBatch& rows, StringTable& text);
+    bool spill(Block& block);
+    bool load(Block& block);
+
+    size_t memory_budget_;
+    size_t block_rows_;
+    std::string spill_dir_;
+    mutable std::mutex mutex_;
+    std::vector<Block> blocks_;
+    size_t memory_bytes_;
+    size_t next_sequence_;
+    MeasurementSpoolStats stats_;
+    std::string last_error_;
+};
+
+#endif // MEASUREMENT_SPOOL_H
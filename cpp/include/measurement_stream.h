@@ -0,0 +1,66 @@
+#ifndef MEASUREMENT_STREAM_H
+#define MEASUREMENT_STREAM_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <string>
+#include "ultra_fast_processor.h"
+#include "measurement_batch.h"
+
+/**
+ * Measurement batches from a background producer thread
+ *
+ * start() runs UltraFastProcessor::process_stdf_file_in_batches on its own
+ * thread and hands the batches over through a queue of at most `depth`
+ * batches. The producer runs ahead of the consumer by at most that much,
+ * then waits, so memory stays bounded by the batch size while parsing,
+ * conversion and insertion overlap. cancel() (or destruction) stops the
+ * producer before its next batch.
+ *
+ * Batches view the processor's string table; use them while the stream
+ * lives. Processor statistics are only stable once finished().
+ */
+class MeasurementStream {
+public:
+    explicit MeasurementStream(size_t depth = 2);
+    ~MeasurementStream();
+
+    MeasurementStream(const MeasurementStream&) = delete;
+    MeasurementStream& operator=(const MeasurementStream&) = delete;
+
+    // Configure (filters, hash, IDs) before start()
+    UltraFastProcessor& processor() { return processor_; }
+
+    bool start(const std::string& filepath, size_t batch_rows);
+
+    // Next batch in file order; blocks until one is ready. False at the end
+    // of the file, on error or after cancel().
+    bool next(MeasurementBatch& batch);
+    void cancel();
+
+    bool finished() const;
+    bool succeeded() const;  // Whole file produced; valid once finished()
+    std::string get_last_error() const;
+
+private:
+    void produce(const std::string& filepath, size_t batch_rows);
+    void join();
+
+    UltraFastProcessor processor_;
+    size_t depth_;
+
+    std::deque<MeasurementBatch> ready_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    bool started_;
+    bool done_;
+    bool cancelled_;
+    bool succeeded_;
+    std::thread producer_;
+    std::string last_error_;
+};
+
+#endif // MEASUREMENT_STREAM_H
@@ -0,0 +1,14 @@
+#ifndef NUMERIC_CONVERT_H
+#define NUMERIC_CONVERT_H
+
+#include <cstddef>
+
+// Widens STDF R4 values to double, out[i] = in[i] (exact). Uses AVX or
+// SSE2 on x86-64 and NEON on AArch64, picked once at runtime like
+// TestSelectionFilter's kernels.
+void convert_r4_to_double(const float* in, size_t count, double* out);
+
+// Kernel in use: "avx", "sse2", "neon" or "scalar"
+const char* convert_r4_implementation();
+
+#endif // NUMERIC_CONVERT_H
@@ -0,0 +1,66 @@
+#ifndef ORDERED_CHUNKS_H
+#define ORDERED_CHUNKS_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+
+// Runs decode(i) for every chunk on worker threads and consume(i) on the
+// calling thread in chunk order. At most `window` chunks are decoded ahead
+// of the consumer, so memory stays bounded for large files.
+template<typename Decode, typename Consume>
+inline void run_chunks_in_order(size_t chunk_count, size_t thread_count, Decode decode, Consume consume) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<char> ready(chunk_count, 0);
+    std::atomic<size_t> next_chunk(0);
+    size_t consumed = 0;
+    const size_t window = thread_count * 2;
+    
+    auto worker = [&]() {
+        for (;;) {
+            size_t id = next_chunk.fetch_add(1);
+            if (id >= chunk_count) return;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return id < consumed + window; });
+            }
+            decode(id);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ready[id] = 1;
+            }
+            cv.notify_all();
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    thread_count = std::min(thread_count, chunk_count);
+    workers.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back(worker);
+    }
+    
+    for (size_t id = 0; id < chunk_count; ++id) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]() { return ready[id] != 0; });
+        }
+        consume(id);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            consumed = id + 1;
+        }
+        cv.notify_all();
+    }
+    
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+#endif // ORDERED_CHUNKS_H
@@ -0,0 +1,76 @@
+#ifndef PART_ASSOCIATION_H
+#define PART_ASSOCIATION_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "columnar_store.h"
+
+// Where a test row sits in the file
+struct TestSite {
+    uint32_t record_index;
+    uint8_t head_num;
+    uint8_t site_num;
+};
+
+/**
+ * Test rows grouped by the part they were measured on
+ *
+ * Follows PIR..PRR brackets per (HEAD_NUM, SITE_NUM): a test belongs to
+ * the next PRR of its own head/site. A PIR discards tests still pending on
+ * its site (they sit outside any bracket), and so does the end of the
+ * file. Files without PIR records fall back to "everything since the
+ * previous PRR of the site", like STDFRecordIndex::parts().
+ *
+ * Multi-site testers interleave their sites in the record stream, so
+ * build() first routes tests, PIRs and PRRs into one lane per head/site.
+ * Lanes then walk their own brackets independently (on a WorkStealingPool
+ * when threads > 1) and are merged into the PRR-ordered layout; the result
+ * does not depend on the thread count.
+ *
+ * The result is laid out per PRR row, tests in file order, so output size
+ * is linear in the number of results actually recorded.
+ */
+class PartAssociation {
+public:
+    PartAssociation();
+
+    // tests must be in file order (record_index ascending); stored entries
+    // are indices into that vector
+    void build(const STDFColumnarStore& store, const std::vector<TestSite>& tests, size_t threads = 1);
+    void clear();
+
+    size_t part_count() const { return part_begin_.empty() ? 0 : part_begin_.size() - 1; }
+    const uint32_t* begin(size_t part) const { return tests_.data() + part_begin_[part]; }
+    const uint32_t* end(size_t part) const { return tests_.data() + part_begin_[part + 1]; }
+
+    size_t associated_tests() const { return tests_.size(); }
+    size_t orphaned_tests() const { return orphaned_; }
+
+    // One lane per (HEAD_NUM, SITE_NUM) seen, in order of first appearance;
+    // lane_parts() lists its PRR rows (= parts) in file order
+    size_t lane_count() const { return lanes_.size(); }
+    const std::vector<uint32_t>& lane_parts(size_t lane) const { return lanes_[lane].prr_rows; }
+
+private:
+    struct Lane {
+        uint32_t key;
+        std::vector<uint32_t> tests;  // Indices into the tests vector, file order
+        std::vector<uint32_t> pir_rows;
+        std::vector<uint32_t> prr_rows;
+        std::vector<uint32_t> part_first;  // Per entry of prr_rows: its tests are
+        std::vector<uint32_t> part_size;   // tests[part_first, part_first + part_size)
+        size_t orphaned;
+    };
+
+    static void walk_lane(const STDFColumnarStore& store, const std::vector<TestSite>& tests, Lane& lane);
+    Lane& lane_for(uint8_t head, uint8_t site);
+
+    std::vector<Lane> lanes_;
+    std::vector<uint32_t> lane_of_;     // (HEAD_NUM << 8 | SITE_NUM) -> lane + 1, 0 = none
+    std::vector<uint32_t> part_begin_;  // PRR row -> first entry in tests_, plus end sentinel
+    std::vector<uint32_t> tests_;
+    size_t orphaned_;
+};
+
+#endif // PART_ASSOCIATION_H
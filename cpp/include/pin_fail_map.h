@@ -0,0 +1,86 @@
+#ifndef PIN_FAIL_MAP_H
+#define PIN_FAIL_MAP_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+#include "stdf_parser.h"
+#include "stdf_record_view.h"
+
+// Bitset kernels over STDF bit fields (bit i = bit i % 8 of byte i / 8).
+// AVX2 or SSE2 on x86-64 and NEON on AArch64, picked once at runtime like
+// byte_order.h's kernels.
+size_t bitset_count(const uint8_t* bits, size_t bytes);              // Set bits
+void bitset_or(uint8_t* dst, const uint8_t* src, size_t bytes);       // dst |= src
+void bitset_and(uint8_t* dst, const uint8_t* src, size_t bytes);      // dst &= src
+void bitset_accumulate(uint32_t* counts, const uint8_t* bits, size_t bit_count);  // counts[i] += bit i
+
+// Kernel in use: "avx2", "sse2", "neon" or "scalar"
+const char* bitset_implementation();
+
+// One part's functional failures: the union of FAIL_PIN over its FTRs
+struct PartPinFails {
+    uint8_t head_num = 0;
+    uint8_t site_num = 0;
+    uint16_t hard_bin = 0;
+    uint16_t soft_bin = 0;
+    std::string part_id;
+    uint32_t ftr_count = 0;            // FTRs tested on the part
+    uint32_t failed_ftrs = 0;          // FTRs with a failing pin
+    std::vector<uint8_t> fail_pins;    // Bit per PMR index, tail bits clear
+
+    size_t failing_pins() const { return bitset_count(fail_pins.data(), fail_pins.size()); }
+};
+
+/**
+ * Pin-level functional failure analysis over FTR FAIL_PIN maps
+ *
+ * FTRs are read through STDFRecordView, so FAIL_PIN is never copied out of
+ * the record: each map is ORed into its part's map and added into the
+ * per-pin FTR fail counts with the bitset kernels. A PRR closes the part
+ * open on its head/site (multi-site testers interleave parts), after which
+ * the part's map is counted into the per-pin part fail counts. Pin i is
+ * the FAIL_PIN bit i, i.e. the PMR index the tester assigned.
+ */
+class PinFailMap {
+public:
+    // FTR or PRR; other record types are ignored
+    void add(STDFRecordView& view);
+    void add_ftr(uint8_t head_num, uint8_t site_num, const STDFBitsView& fail_pins);
+    void end_part(uint8_t head_num, uint8_t site_num, uint16_t hard_bin, uint16_t soft_bin,
+                  std::string_view part_id);
+
+    // Streams FTR and PRR views of a file into the map
+    bool add_file(const std::string& filepath, STDFParserBackend backend = STDFParserBackend::MMAP);
+
+    size_t pin_count() const { return ftr_fail_counts_.size(); }   // Widest failing FAIL_PIN map, in bits
+    size_t ftr_count() const { return ftr_count_; }
+    const std::vector<uint32_t>& ftr_fail_counts() const { return ftr_fail_counts_; }    // Per pin
+    const std::vector<uint32_t>& part_fail_counts() const { return part_fail_counts_; }  // Per pin
+    const std::vector<PartPinFails>& parts() const { return parts_; }   // In PRR order
+
+    // Pins failing in every part that has a failing pin (AND of their maps)
+    std::vector<uint8_t> common_fail_pins() const;
+
+    // Parts whose FTRs no PRR closed (FTRs after the last PRR of their
+    // head/site); add_file() drops them at the end of each file
+    size_t unfinished_parts() const { return unfinished_parts_ + open_parts_.size(); }
+    const std::string& get_last_error() const { return last_error_; }
+    void clear();
+
+private:
+    PartPinFails& open_part(uint8_t head_num, uint8_t site_num);
+
+    std::map<uint16_t, PartPinFails> open_parts_;  // By head << 8 | site
+    std::vector<PartPinFails> parts_;
+    std::vector<uint32_t> ftr_fail_counts_;
+    std::vector<uint32_t> part_fail_counts_;
+    size_t ftr_count_ = 0;
+    size_t unfinished_parts_ = 0;
+    std::string last_error_;
+};
+
+#endif // PIN_FAIL_MAP_H
@@ -0,0 +1,37 @@
+#ifndef PIXEL_NAME_H
+#define PIXEL_NAME_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+/**
+ * Pixel test names
+ *
+ * Pixel tests carry a "Pixel=R<row>C<col>" tag in ALARM_ID or TEST_TXT.
+ * These helpers replace the std::regex versions with a single forward
+ * scan and keep their exact results:
+ *   - coordinates come from the leftmost complete tag, as (X = col, Y = row);
+ *     a tag whose numbers overflow int32 yields (0, 0)
+ *   - the cleaned name drops every ";Pixel=R<d>C<d>", then a leading
+ *     "Pixel=R<d>C<d>;"
+ * Shared by UltraFastProcessor and the Python bridge.
+ */
+
+struct PixelName {
+    std::string cleaned;
+    int32_t x = 0;
+    int32_t y = 0;
+    bool has_tag = false;  // A complete tag was found
+};
+
+// "Pixel=" in either text (the filter the pipeline has always applied)
+bool is_pixel_name(std::string_view alarm_id, std::string_view test_txt);
+
+// Cleaned name and coordinates in one pass over the name
+void parse_pixel_name(std::string_view name, PixelName& result);
+
+// Coordinates only; returns false (and leaves x/y at 0) without a tag
+bool extract_pixel_coordinates(std::string_view text, int32_t& x, int32_t& y);
+
+#endif // PIXEL_NAME_H
@@ -0,0 +1,156 @@
+#ifndef PYTHON_MEASUREMENTS_H
+#define PYTHON_MEASUREMENTS_H
+
+#ifndef PY_SSIZE_T_CLEAN
+#define PY_SSIZE_T_CLEAN
+#endif
+#include <Python.h>
+#include <vector>
+#include <string_view>
+#include <type_traits>
+#include "measurement_batch.h"
+#include "instrumentation.h"
+
+/**
+ * MeasurementBatch -> Python tuples
+ *
+ * Shared by the extension module and the benchmarks, which time the same
+ * conversion the module returns. The caller holds the GIL.
+ */
+
+// Conversion named by the string fields of measurement_fields.def
+inline PyObject* PyUnicode_FromString_Safe(std::string_view str) {
+    return PyUnicode_FromStringAndSize(str.data(), static_cast<Py_ssize_t>(str.size()));
+}
+
+// Numeric columns convert per row; string columns convert each dictionary
+// entry once and every row shares the entry's object
+template<typename T, typename Convert>
+bool prepare_column(const MeasurementColumn<T>&, Convert, std::vector<PyObject*>&) {
+    return true;
+}
+
+template<typename Convert>
+bool prepare_column(const MeasurementColumn<std::string_view>& column, Convert convert,
+                           std::vector<PyObject*>& entries) {
+    entries.reserve(column.dictionary.size());
+    for (std::string_view value : column.dictionary) {
+        PyObject* entry = convert(value);
+        if (!entry) return false;
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+// Last object an integer column produced, handed out again while the
+// value repeats (rows of one part share wld_id, rows of one test its
+// number): runs cost an incref instead of an allocation
+template<typename T>
+struct RepeatedItem {
+    PyObject* object = nullptr;
+    T value{};
+    
+    ~RepeatedItem() { Py_XDECREF(object); }
+};
+
+// New reference, or nullptr (Python error set) when conversion fails
+template<typename T, typename Convert>
+PyObject* column_item(const MeasurementColumn<T>& column, const std::vector<PyObject*>&,
+                             RepeatedItem<T>& repeated, size_t row, Convert convert) {
+    const T value = column.values[row];
+    if constexpr (std::is_integral<T>::value) {
+        if (repeated.object && value == repeated.value) {
+            Py_INCREF(repeated.object);
+            return repeated.object;
+        }
+        PyObject* item = convert(value);
+        if (item) {
+            Py_XDECREF(repeated.object);
+            Py_INCREF(item);
+            repeated.object = item;
+            repeated.value = value;
+        }
+        return item;
+    } else {
+        return convert(value);  // Floats: -0.0 == 0.0, so equal is not identical
+    }
+}
+
+template<typename Convert>
+PyObject* column_item(const MeasurementColumn<std::string_view>& column, const std::vector<PyObject*>& entries,
+                             RepeatedItem<std::string_view>&, size_t row, Convert) {
+    PyObject* entry = entries[column.codes[row]];
+    Py_INCREF(entry);
+    return entry;
+}
+
+// 🚀 MACRO-DRIVEN: measurement batch -> list of ClickHouse-compatible tuples
+inline PyObject* measurement_batch_to_tuple_list(const MeasurementBatch& batch) {
+    StageTimer timer(InstrumentedStage::PYTHON_CONVERSION);
+    constexpr size_t TUPLE_SIZE = 0
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) + 1
+    #include "measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    ;
+    
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        std::vector<PyObject*> name##_entries; \
+        RepeatedItem<cpp_type> name##_repeated;
+    #include "measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    
+    auto release_entries = [&]() {
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            for (PyObject* entry : name##_entries) Py_DECREF(entry);
+        #include "measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+    };
+    
+    bool prepared = true;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        prepared = prepared && prepare_column(batch.name, python_conversion, name##_entries);
+    #include "measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    
+    PyObject* tuple_list = prepared ? PyList_New(batch.size()) : nullptr;
+    if (!tuple_list) {
+        release_entries();
+        return nullptr;
+    }
+    
+    // Tuples are new, so items go in with the unchecked macros. The first
+    // failed conversion sets a Python error, so the rest of the row is not
+    // converted; its items stay NULL (tuples release those safely) and the
+    // row is checked once
+    for (size_t i = 0; i < batch.size(); ++i) {
+        PyObject* tuple = PyTuple_New(TUPLE_SIZE);
+        if (!tuple) {
+            Py_DECREF(tuple_list);
+            release_entries();
+            return nullptr;
+        }
+        PyList_SET_ITEM(tuple_list, i, tuple);
+        
+        bool converted = true;
+        Py_ssize_t field_index = 0;
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            if (converted) { \
+                PyObject* item = column_item(batch.name, name##_entries, name##_repeated, i, python_conversion); \
+                converted = item != nullptr; \
+                PyTuple_SET_ITEM(tuple, field_index++, item); \
+            }
+        #include "measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+        
+        if (!converted) {
+            Py_DECREF(tuple_list);
+            release_entries();
+            return nullptr;
+        }
+    }
+    
+    release_entries();
+    return tuple_list;
+}
+
+#endif // PYTHON_MEASUREMENTS_H
@@ -0,0 +1,40 @@
+#ifndef RECORD_TYPE_FILTER_H
+#define RECORD_TYPE_FILTER_H
+
+#include <bitset>
+#include <vector>
+#include <cstdint>
+
+enum class STDFRecordType;  // stdf_parser.h
+
+/**
+ * Pre-decode record selection: one bit per (REC_TYP, REC_SUB) pair
+ *
+ * The decode loops test the header bytes against this 256x256 table and
+ * step over disabled records by REC_LEN without decoding them, instead of
+ * classifying every record and searching the enabled-type list. 8 KB,
+ * held by value in each parser.
+ */
+class RecordTypeFilter {
+public:
+    RecordTypeFilter() = default;
+
+    // The (REC_TYP, REC_SUB) pairs of the given types; with part_brackets,
+    // PRR also enables the PIR that opens each part
+    void set_enabled_types(const std::vector<STDFRecordType>& types, bool part_brackets);
+
+    void enable(uint8_t rec_type, uint8_t rec_subtype) { bits_.set(key(rec_type, rec_subtype)); }
+    void disable(uint8_t rec_type, uint8_t rec_subtype) { bits_.reset(key(rec_type, rec_subtype)); }
+    void clear() { bits_.reset(); }
+
+    bool enabled(uint8_t rec_type, uint8_t rec_subtype) const { return bits_[key(rec_type, rec_subtype)]; }
+
+private:
+    static size_t key(uint8_t rec_type, uint8_t rec_subtype) {
+        return (static_cast<size_t>(rec_type) << 8) | rec_subtype;
+    }
+
+    std::bitset<256 * 256> bits_;
+};
+
+#endif // RECORD_TYPE_FILTER_H
@@ -0,0 +1,82 @@
+#ifndef SHARDED_ID_MAP_H
+#define SHARDED_ID_MAP_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "id_map_snapshot.h"
+#include "flat_string_map.h"
+
+/**
+ * Thread-safe name -> ID table
+ *
+ * A name is hashed once; the top bits pick one of SHARD_COUNT shards,
+ * each a flat table (flat_string_map.h) behind its own reader/writer lock, so workers looking up different names rarely meet
+ * and repeated lookups of a known name only take a shared lock. New IDs
+ * come from one atomic counter; each shard also records the names it
+ * assigned, which is the "new mappings" delta to write back.
+ *
+ * A snapshot (id_map_snapshot.h) can stand in for most of the
+ * pre-existing mappings. The shards then only hold the delta loaded on
+ * top of it and the new names; a name they lack is looked up in the
+ * snapshot without taking any lock.
+ *
+ * An ID, once returned for a name, never changes. Which new name gets
+ * which ID depends on the order workers first reach it.
+ */
+class ShardedIDMap {
+public:
+    using Mapping = std::pair<std::string, uint32_t>;
+
+    static constexpr size_t SHARD_COUNT = 64;
+
+    ShardedIDMap();
+
+    // Adds pre-existing mappings (not part of the delta); new IDs start
+    // after the largest one loaded
+    void load(const std::vector<Mapping>& mappings);
+
+    // Pre-existing mappings from a snapshot, before any lookup; loaded
+    // mappings of the same names take precedence
+    void attach(std::shared_ptr<const IDMapSnapshot> snapshot);
+    const IDMapSnapshot* snapshot() const { return snapshot_.get(); }
+
+    uint32_t get_or_assign(std::string_view name);
+
+    size_t size() const;
+    uint32_t next_id() const { return counter_.load(std::memory_order_relaxed); }
+
+    // Copies, sorted by ID (all_mappings includes the snapshot's)
+    std::vector<Mapping> all_mappings() const;
+    std::vector<Mapping> new_mappings() const;
+
+private:
+    // Own cache lines, so workers on other cores (or sockets) locking
+    // neighbouring shards do not bounce one line between them
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        FlatStringMap ids;
+        std::vector<Mapping> added;
+    };
+
+    // Top bits, so shard and slot (low bits) do not use the same ones
+    static constexpr unsigned SHARD_SHIFT = sizeof(size_t) * 8 - 6;
+    static_assert(SHARD_COUNT == size_t(1) << 6, "SHARD_SHIFT assumes 64 shards");
+
+    Shard& shard_for(size_t hash) { return shards_[hash >> SHARD_SHIFT]; }
+
+    void advance_counter(uint32_t next);
+
+    std::array<Shard, SHARD_COUNT> shards_;
+    std::shared_ptr<const IDMapSnapshot> snapshot_;
+    alignas(64) std::atomic<uint32_t> counter_;
+};
+
+#endif // SHARDED_ID_MAP_H
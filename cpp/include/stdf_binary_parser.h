@@ -5,30 +5,24 @@
 #include <string>
 #include <map>
 #include <memory>
-#include <fstream>
 #include <cstdint>
+#include <libstdf.h>
+#include "stdf_parser.h"
+#include "mapped_file.h"
+#include "columnar_store.h"
+#include "instrumentation.h"
+#include "record_type_filter.h"
 
 #ifdef _WIN32
-    #include <windows.h>
     #define STDF_EXPORT __declspec(dllexport)
 #else
     #define STDF_EXPORT
 #endif
 
-// STDF V4 Record Types and Subtypes
-enum class STDFRecordType : uint8_t {
-    MIR = 0x01,  // Master Information Record (1,10)
-    SDR = 0x02,  // Site Description Record (1,80) 
-    PRR = 0x05,  // Part Result Record (5,20)
-    PTR = 0x0F,  // Parametric Test Record (15,20)
-    MPR = 0x0F,  // Multiple-Result Parametric Record (15,15)
-    FTR = 0x0F,  // Functional Test Record (15,25)
-    HBR = 0x01,  // Hardware Bin Record (1,40)
-    SBR = 0x01,  // Software Bin Record (1,50)
-    UNKNOWN = 0xFF
-};
+class STDFRecordView;
+class DynamicFieldExtractor;
 
-// STDF Record Header
+// STDF Record Header (as laid out on disk)
 #pragma pack(push, 1)
 struct STDFHeader {
     uint16_t length;     // Record length (excluding header)
@@ -37,108 +31,213 @@ struct STDFHeader {
 };
 #pragma pack(pop)
 
-// Parsed STDF record structure
-struct STDFRecord {
-    STDFRecordType type;
-    uint8_t rec_type;
-    uint8_t rec_subtype;
-    std::map<std::string, std::string> fields;
-    
-    // Common fields
-    uint32_t test_num = 0;
-    uint32_t head_num = 0;
-    uint32_t site_num = 0;
-    
-    // PTR/MPR specific
-    double result = 0.0;
-    std::string alarm_id;
-    std::string test_txt;
-    std::string units;
-    double lo_limit = 0.0;
-    double hi_limit = 0.0;
-    
-    // Context
-    std::string filename;
-    uint32_t record_index = 0;
-    size_t file_position = 0;
+// Result of a header-only scan (STDFParser::scan_file): record counts and
+// bytes per type, MIR/MRR fields and structural checks, no other decoding
+struct STDFScanSummary {
+    uint64_t stdf_bytes = 0;      // Bytes walked (decompressed size for gzip/bzip2)
+    uint64_t complete_bytes = 0;  // Bytes in whole records
+    uint64_t total_records = 0;
+    uint64_t record_counts[static_cast<size_t>(CountedRecordType::COUNT)] = {};
+    uint64_t record_bytes[static_cast<size_t>(CountedRecordType::COUNT)] = {};  // Header included
+
+    uint8_t cpu_type = 0;  // From the FAR (1 = big-endian, 2 = little-endian)
+    uint8_t stdf_version = 0;
+    bool starts_with_far = false;
+    bool has_mir = false;
+    bool has_mrr = false;
+    bool ends_with_mrr = false;
+    bool truncated = false;  // Last record cut short
+    std::map<std::string, std::string> mir_fields;
+    std::map<std::string, std::string> mrr_fields;
+
+    uint64_t count(CountedRecordType type) const { return record_counts[static_cast<size_t>(type)]; }
+    // Whole file written: no truncation and closed by an MRR
+    bool complete() const { return starts_with_far && !truncated && ends_with_mrr; }
 };
 
-// Native Windows STDF Binary Parser
+/**
+ * Memory-mapped zero-copy STDF V4 parser
+ *
+ * Maps the whole file and walks STDFHeaders in place. Fields are decoded
+ * straight from the mapped bytes into stack-resident libstdf record structs
+ * (Cn/N1 pointers aim into the mapping, only byte-swapped arrays go through
+ * reusable scratch buffers), so there is no per-record heap allocation on
+ * the decode side. The structs are handed to the shared DynamicFieldExtractor,
+ * which keeps the produced STDFRecord fields identical to the libstdf path.
+ *
+ * Byte order is taken from the FAR CPU_TYPE and selects the decoder
+ * instance once per file, so non-native (e.g. big-endian) files decode
+ * through the same straight-line code, with arrays swapped in bulk.
+ * Compressed files are not mapped directly; STDFParser feeds them through
+ * DecompressingReader and attach_buffer().
+ */
 class STDF_EXPORT STDFBinaryParser {
 public:
     STDFBinaryParser();
     ~STDFBinaryParser();
-    
+
     // Main parsing functions
     bool open_file(const std::string& filepath);
     void close_file();
     std::vector<STDFRecord> parse_all_records();
     STDFRecord parse_next_record();
     bool has_more_records();
-    
+
+    // Restrict the walk to [begin_offset, end_offset); first_record_index
+    // is the 1-based ordinal of the record at begin_offset. Used to decode
+    // one chunk of a file on a worker thread.
+    bool set_range(size_t begin_offset, size_t end_offset, uint32_t first_record_index);
+
+    // Decode from a caller-owned buffer of whole records instead of a mapped
+    // file (e.g. decompressed blocks). first_record_index continues the
+    // ordinals across consecutive buffers; byte order is detected from the
+    // FAR when first_record_index is 1 and kept for later buffers.
+    bool attach_buffer(const uint8_t* data, size_t size, const std::string& filename,
+                       uint32_t first_record_index);
+
+    // Next enabled record as a lazy view over the mapped bytes (no fields
+    // decoded yet); false at the end. The view is valid while the mapping is.
+    bool next_view(STDFRecordView& view);
+
+    // Random access: decode the record whose header starts at offset
+    // (record_index is its 1-based ordinal, e.g. from STDFRecordIndex).
+    // Ignores the enabled-type filter; returns UNKNOWN for other types.
+    STDFRecord parse_record_at(size_t offset, uint32_t record_index);
+
+    // Decode every enabled record straight into typed columns (no field maps)
+    size_t parse_all_to_columns(STDFColumnarStore& store);
+
+    // Header-only walk over the remaining records into summary (only FAR,
+    // MIR and MRR bodies are read); ignores the enabled-type filter.
+    // Consecutive buffers accumulate into the same summary.
+    size_t scan_records(STDFScanSummary& summary);
+
     // Configuration
     void set_enabled_record_types(const std::vector<STDFRecordType>& types);
     void enable_record_type(uint8_t rec_type, uint8_t rec_subtype);
     void disable_record_type(uint8_t rec_type, uint8_t rec_subtype);
-    
+
+    // Field selection for the STDFRecord paths (not owned; nullptr = the
+    // process-wide extractor). Projected types decode only their fields.
+    void set_field_extractor(const DynamicFieldExtractor* extractor);
+
     // Statistics
     size_t get_total_records() const { return total_records_; }
     size_t get_parsed_records() const { return parsed_records_; }
     size_t get_file_size() const { return file_size_; }
-    
+    const uint8_t* get_data() const { return data_; }  // Mapped or attached bytes
+
     // Error handling
     std::string get_last_error() const { return last_error_; }
-    
+
 private:
     // File operations
     bool read_header(STDFHeader& header);
-    std::vector<uint8_t> read_record_data(uint16_t length);
     bool skip_record(uint16_t length);
-    
-    // STDF data type parsers
+    bool next_raw_record(STDFHeader& header, const uint8_t*& data, size_t& record_start);
+
+    // STDF data type parsers (bounded by record_length_, missing
+    // trailing fields decode to the same defaults libstdf uses). Multi-byte
+    // readers and everything built on them are instantiated per byte order
+    // (Swap = file order differs from host order, see byte_order.h); the
+    // public entry points pick the instance from swap_bytes_.
     uint8_t read_u1(const uint8_t* data, size_t& offset);
-    uint16_t read_u2(const uint8_t* data, size_t& offset);
-    uint32_t read_u4(const uint8_t* data, size_t& offset);
+    template<bool Swap> uint16_t read_u2(const uint8_t* data, size_t& offset);
+    template<bool Swap> uint32_t read_u4(const uint8_t* data, size_t& offset);
     int8_t read_i1(const uint8_t* data, size_t& offset);
-    int16_t read_i2(const uint8_t* data, size_t& offset);
-    int32_t read_i4(const uint8_t* data, size_t& offset);
-    float read_r4(const uint8_t* data, size_t& offset);
-    double read_r8(const uint8_t* data, size_t& offset);
+    template<bool Swap> int16_t read_i2(const uint8_t* data, size_t& offset);
+    template<bool Swap> int32_t read_i4(const uint8_t* data, size_t& offset);
+    template<bool Swap> float read_r4(const uint8_t* data, size_t& offset);
+    template<bool Swap> double read_r8(const uint8_t* data, size_t& offset);
+    char read_c1(const uint8_t* data, size_t& offset);
     std::string read_cn(const uint8_t* data, size_t& offset);
     std::string read_cf(const uint8_t* data, size_t& offset, uint8_t length);
-    
+
+    // Zero-copy variants returning libstdf-style pointers into the mapping;
+    // arrays are copied to host order in bulk (byte_swap_copy16/32)
+    char* read_cn_ptr(const uint8_t* data, size_t& offset);
+    uint8_t* read_xn1_ptr(const uint8_t* data, size_t& offset, uint16_t count);
+    template<bool Swap> uint8_t* read_dn_ptr(const uint8_t* data, size_t& offset, std::vector<uint8_t>& scratch);
+    template<bool Swap>
+    float* read_xr4(const uint8_t* data, size_t& offset, uint16_t count, std::vector<float>& scratch);
+    template<bool Swap>
+    uint16_t* read_xu2(const uint8_t* data, size_t& offset, uint16_t count, std::vector<uint16_t>& scratch);
+
+    // One field of a record layout (stdf_layout.h): fixed-width fields are
+    // loaded at their constexpr offset once REC_LEN is known to cover their
+    // whole run, and read field by field otherwise
+    struct LayoutRun {
+        size_t start = 0;
+        bool whole = false;
+    };
+    template<bool Swap, typename Layout, size_t Index, typename T>
+    void decode_layout_field(const uint8_t* data, size_t& offset, LayoutRun& run, T& value);
+
+    // Record decoders (mapped bytes -> libstdf struct); PTR and PRR are
+    // generated from cpp/field_defs/ptr_layout.def and prr_layout.def
+    template<bool Swap> void decode_ptr(const uint8_t* data, uint16_t length, rec_ptr& ptr);
+    template<bool Swap> void decode_mpr(const uint8_t* data, uint16_t length, rec_mpr& mpr);
+    template<bool Swap> void decode_ftr(const uint8_t* data, uint16_t length, rec_ftr& ftr);
+    void decode_pir(const uint8_t* data, uint16_t length, rec_pir& pir);
+    template<bool Swap> void decode_prr(const uint8_t* data, uint16_t length, rec_prr& prr);
+    template<bool Swap> void decode_hbr(const uint8_t* data, uint16_t length, rec_hbr& hbr);
+    template<bool Swap> void decode_sbr(const uint8_t* data, uint16_t length, rec_sbr& sbr);
+
     // Record-specific parsers
-    STDFRecord parse_mir_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_ptr_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_mpr_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_ftr_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_prr_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_hbr_record(const uint8_t* data, uint16_t length);
-    STDFRecord parse_sbr_record(const uint8_t* data, uint16_t length);
-    
+    template<bool Swap> STDFRecord parse_mir_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_ptr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_mpr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_ftr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_prr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_hbr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_sbr_record(const uint8_t* data, uint16_t length);
+    template<bool Swap> STDFRecord parse_mrr_record(const uint8_t* data, uint16_t length);
+    STDFRecord parse_projected_record(const STDFHeader& header, const uint8_t* data);
+
+    template<bool Swap>
+    STDFRecord decode_record(const STDFHeader& header, const uint8_t* data, size_t record_start);
+    template<bool Swap> size_t parse_columns(STDFColumnarStore& store);
+
     // Utility functions
     STDFRecordType classify_record(uint8_t rec_type, uint8_t rec_subtype);
-    bool is_record_enabled(uint8_t rec_type, uint8_t rec_subtype);
+    bool is_record_enabled(uint8_t rec_type, uint8_t rec_subtype) const {
+        return record_filter_.enabled(rec_type, rec_subtype);
+    }
     std::string record_type_to_string(STDFRecordType type);
     void set_error(const std::string& error);
-    
+    void detect_byte_order();
+    STDFRecord make_record(STDFRecordType type, uint8_t rec_type, uint8_t rec_subtype);
+
     // File handling
-    std::ifstream file_;
+    MappedFile file_;
+    const uint8_t* data_;  // Mapping or attached buffer
     std::string current_filename_;
     size_t file_size_;
+    size_t end_offset_;
     size_t current_position_;
-    
+    bool swap_bytes_;
+    uint16_t record_length_;
+
+    // Scratch buffers for arrays that must be aligned / host order
+    std::vector<float> rslt_scratch_;
+    std::vector<uint16_t> indx_scratch_;
+    std::vector<uint16_t> pgm_indx_scratch_;
+    std::vector<uint8_t> fail_pin_scratch_;
+    std::vector<uint8_t> spin_map_scratch_;
+
     // Configuration
-    std::map<std::pair<uint8_t, uint8_t>, bool> enabled_records_;
-    
+    RecordTypeFilter record_filter_;
+    const DynamicFieldExtractor* field_extractor_;
+
     // Statistics
     size_t total_records_;
     size_t parsed_records_;
     uint32_t current_record_index_;
-    
+    RecordCounters record_counters_;  // Every record walked; added to the totals on destruction
+
     // Error handling
     std::string last_error_;
-    
+
     // Context from MIR record
     std::string mir_lot_id_;
     std::string mir_part_typ_;
@@ -146,4 +245,4 @@ private:
     std::string mir_setup_id_;
 };
 
-#endif // STDF_BINARY_PARSER_H
\ No newline at end of file
+#endif // STDF_BINARY_PARSER_H
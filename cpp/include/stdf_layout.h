@@ -0,0 +1,126 @@
+#ifndef STDF_LAYOUT_H
+#define STDF_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <libstdf.h>
+#include "byte_order.h"
+
+/**
+ * Compile-time record layouts generated from cpp/field_defs/<record>_layout.def
+ *
+ * A layout lists a record's fields in on-disk order with their STDF types.
+ * Consecutive fixed-width fields form a run, and each field of a run sits
+ * at a constexpr offset from the run's start. A decoder checks once that a
+ * whole run lies inside REC_LEN and then loads every field of it at its
+ * offset. Only a run that a short record cuts falls back to the checked
+ * field-by-field reads, so trailing fields still decode to libstdf's
+ * defaults. PTR's runs are TEST_NUM..RESULT (12 bytes), OPT_FLAG..HI_LIMIT
+ * (12) and LO_SPEC..HI_SPEC (8); PRR's is HEAD_NUM..TEST_T (17).
+ */
+namespace stdf_layout {
+
+enum class Type : uint8_t { U1, U2, U4, I1, I2, I4, R4, B1, C1, CN, BN };
+
+// Bytes on disk; 0 for the length-prefixed types
+constexpr size_t fixed_size(Type type) {
+    switch (type) {
+        case Type::U1: case Type::I1: case Type::B1: case Type::C1: return 1;
+        case Type::U2: case Type::I2: return 2;
+        case Type::U4: case Type::I4: case Type::R4: return 4;
+        default: return 0;
+    }
+}
+
+// libstdf struct member type for each STDF type
+template<Type T> struct Member;
+template<> struct Member<Type::U1> { using type = dtc_U1; };
+template<> struct Member<Type::U2> { using type = dtc_U2; };
+template<> struct Member<Type::U4> { using type = dtc_U4; };
+template<> struct Member<Type::I1> { using type = dtc_I1; };
+template<> struct Member<Type::I2> { using type = dtc_I2; };
+template<> struct Member<Type::I4> { using type = dtc_I4; };
+template<> struct Member<Type::R4> { using type = dtc_R4; };
+template<> struct Member<Type::B1> { using type = dtc_B1; };
+template<> struct Member<Type::C1> { using type = dtc_C1; };
+template<> struct Member<Type::CN> { using type = dtc_Cn; };
+template<> struct Member<Type::BN> { using type = dtc_Bn; };
+
+template<Type T>
+using member_t = typename Member<T>::type;
+
+// Unchecked load of a fixed-width field
+template<bool Swap, Type T>
+inline member_t<T> load(const uint8_t* p) {
+    if constexpr (T == Type::U2 || T == Type::I2) {
+        return static_cast<member_t<T>>(FileByteOrder<Swap>::u2(p));
+    } else if constexpr (T == Type::U4 || T == Type::I4) {
+        return static_cast<member_t<T>>(FileByteOrder<Swap>::u4(p));
+    } else if constexpr (T == Type::R4) {
+        return FileByteOrder<Swap>::r4(p);
+    } else {
+        static_assert(fixed_size(T) == 1, "no fixed-width load for this type");
+        return static_cast<member_t<T>>(p[0]);
+    }
+}
+
+// Bytes from field index to the end of its fixed run (0 if variable-length)
+template<typename Layout>
+constexpr size_t run_bytes(size_t index) {
+    size_t bytes = 0;
+    for (size_t i = index; i < Layout::COUNT && fixed_size(Layout::types[i]) != 0; ++i) {
+        bytes += fixed_size(Layout::types[i]);
+    }
+    return bytes;
+}
+
+// Offset of field index from the start of its fixed run
+template<typename Layout>
+constexpr size_t run_offset(size_t index) {
+    size_t offset = 0;
+    for (size_t i = index; i > 0 && fixed_size(Layout::types[i - 1]) != 0; --i) {
+        offset += fixed_size(Layout::types[i - 1]);
+    }
+    return offset;
+}
+
+template<typename Layout>
+constexpr bool starts_run(size_t index) {
+    return fixed_size(Layout::types[index]) != 0 && run_offset<Layout>(index) == 0;
+}
+
+struct PTRLayout {
+    static constexpr Type types[] = {
+        #define LAYOUT(name, member, type) Type::type,
+        #include "../field_defs/ptr_layout.def"
+        #undef LAYOUT
+    };
+    enum Field : size_t {
+        #define LAYOUT(name, member, type) member,
+        #include "../field_defs/ptr_layout.def"
+        #undef LAYOUT
+        COUNT
+    };
+};
+
+struct PRRLayout {
+    static constexpr Type types[] = {
+        #define LAYOUT(name, member, type) Type::type,
+        #include "../field_defs/prr_layout.def"
+        #undef LAYOUT
+    };
+    enum Field : size_t {
+        #define LAYOUT(name, member, type) member,
+        #include "../field_defs/prr_layout.def"
+        #undef LAYOUT
+        COUNT
+    };
+};
+
+static_assert(run_bytes<PTRLayout>(PTRLayout::TEST_NUM) == 12 && run_bytes<PTRLayout>(PTRLayout::OPT_FLAG) == 12,
+              "ptr_layout.def: unexpected fixed runs");
+static_assert(run_bytes<PRRLayout>(PRRLayout::HEAD_NUM) == 17, "prr_layout.def: unexpected fixed prefix");
+
+}  // namespace stdf_layout
+
+#endif // STDF_LAYOUT_H
@@ -6,6 +6,8 @@
 #include <map>
 #include <memory>
 #include <cstdint>
+#include <functional>
+#include "record_type_filter.h"
 
 // STDF Record Types we care about
 enum class STDFRecordType {
@@ -19,6 +21,12 @@ enum class STDFRecordType {
     UNKNOWN
 };
 
+// Record decoding backends selectable on STDFParser
+enum class STDFParserBackend {
+    LIBSTDF,  // libstdf stdf_read_record (supports compressed files)
+    MMAP      // Memory-mapped zero-copy STDFBinaryParser
+};
+
 // Parsed STDF record structure
 struct STDFRecord {
     STDFRecordType type;
@@ -36,11 +44,47 @@ struct STDFRecord {
     std::string alarm_id;
     std::string test_txt;
     std::string units;
+    double lo_limit = 0.0;
+    double hi_limit = 0.0;
     
     // Timestamps and context
     std::string wld_id;
     std::string filename;
     uint32_t record_index = 0;
+    size_t file_position = 0;
+};
+
+class STDFColumnarStore;
+class STDFRecordIndex;
+class STDFBinaryParser;
+struct STDFScanSummary;
+class STDFRecordView;
+class DynamicFieldExtractor;
+
+// Per-record callback for streaming parses. The record is owned by the
+// parser and may be moved from; it is not retained after the call returns.
+using STDFRecordCallback = std::function<void(STDFRecord&)>;
+
+// Per-record callback for lazy parses; the view (and the bytes behind it)
+// is only valid for the duration of the call
+using STDFRecordViewCallback = std::function<void(STDFRecordView&)>;
+
+// Push-style visitor, one hook per record type. Default hooks ignore the
+// record so implementations only override what they consume.
+class STDFRecordVisitor {
+public:
+    virtual ~STDFRecordVisitor() = default;
+    
+    virtual void on_mir(STDFRecord&) {}
+    virtual void on_ptr(STDFRecord&) {}
+    virtual void on_mpr(STDFRecord&) {}
+    virtual void on_ftr(STDFRecord&) {}
+    virtual void on_hbr(STDFRecord&) {}
+    virtual void on_sbr(STDFRecord&) {}
+    virtual void on_prr(STDFRecord&) {}
+    
+    // Called once after the last record has been delivered
+    virtual void on_end() {}
 };
 
 // Main STDF Parser class
@@ -49,21 +93,120 @@ public:
     STDFParser();
     ~STDFParser();
     
-    // Main parsing function
+    // Main parsing function (materializes every record; wraps stream_file)
     std::vector<STDFRecord> parse_file(const std::string& filepath);
     
+    // Streaming parse: records are handed over as they are decoded and
+    // never accumulated. Returns false if the file could not be opened.
+    bool stream_file(const std::string& filepath, const STDFRecordCallback& callback);
+    bool stream_file(const std::string& filepath, STDFRecordVisitor& visitor);
+    
+    // Lazy streaming parse: each enabled record is handed over as an
+    // STDFRecordView over its raw bytes, and only the fields the callback
+    // reads get decoded. Sequential on both backends (gzip/bzip2 like
+    // stream_file); ignores the field configuration.
+    bool stream_views(const std::string& filepath, const STDFRecordViewCallback& callback);
+    
+    // Typed columnar parse: fills one structure-of-arrays table per record
+    // type (see columnar_store.h) without building per-field string maps
+    bool parse_to_columns(const std::string& filepath, STDFColumnarStore& store);
+    
+    // Header-only scan for triage: record counts and bytes per type, MIR and
+    // MRR fields, truncation. Record bodies are skipped, so it runs at
+    // roughly read bandwidth (gzip/bzip2 files are inflated on the way and
+    // also get a content hash). Any backend; ignores the enabled types.
+    bool scan_file(const std::string& filepath, STDFScanSummary& summary);
+    
+    // Random access through a persistent offset index (uncompressed files
+    // only). open_indexed loads the sidecar or builds and writes it; reads
+    // then seek straight to the requested records.
+    bool open_indexed(const std::string& filepath, const std::string& cache_dir = "");
+    void close_indexed();
+    bool read_record(uint32_t record_index, STDFRecord& record);  // 1-based ordinal
+    std::vector<STDFRecord> read_records_of_type(STDFRecordType type);
+    std::vector<STDFRecord> read_part(size_t part_number);        // 0-based, PIR..PRR of one site
+    size_t get_part_count() const;
+    const STDFRecordIndex* get_index() const { return index_.get(); }
+    
     // Configuration
     void set_enabled_record_types(const std::vector<STDFRecordType>& types);
-    void set_field_config(const std::string& config_json);
+    
+    // Per-parser field selection for the STDFRecord paths (parse_file,
+    // stream_file, read_record): JSON as in DynamicFieldExtractor, e.g.
+    // {"PTR": {"fields": ["TEST_NUM", "TEST_FLG", "RESULT", "TEST_TXT"]}}.
+    // Selected fields are read straight from the record bytes and the rest
+    // is skipped. Empty string: back to the process-wide configuration.
+    // Returns false (keeping the old selection) on malformed JSON or one
+    // that selects no known field.
+    bool set_field_config(const std::string& config_json);
+    void set_backend(STDFParserBackend backend) { backend_ = backend; }
+    STDFParserBackend get_backend() const { return backend_; }
+    
+    // Native I/O for the LIBSTDF backend: uncompressed, gzip and bzip2
+    // files are read through MappedFile (mapped, or in large reads on
+    // network shares; see mapped_file.h) and decoded by the MMAP reader,
+    // which yields the same records. LZW (.Z) files still go to libstdf.
+    // On by default on Windows, where libstdf reads through the C
+    // runtime's read() in small pieces.
+    void set_native_io(bool enabled) { native_io_ = enabled; }
+    bool get_native_io() const { return native_io_; }
+    
+    // Intra-file parallel decoding: with more than one thread, a header-only
+    // pre-scan (STDFRecordIndex) cuts the file into chunks ending on PRR
+    // boundaries, chunks are decoded on worker threads with the memory-mapped
+    // reader and results are delivered in file order. 0 = one per core.
+    // Falls back to sequential decoding when the file cannot be mapped.
+    // gzip/bzip2 input on the MMAP backend, or with more than one thread,
+    // is inflated on background threads (DecompressingReader) while the
+    // records are decoded.
+    void set_num_threads(size_t threads);
+    size_t get_num_threads() const { return num_threads_; }
     
     // Statistics
     size_t get_total_records() const { return total_records_; }
     size_t get_parsed_records() const { return parsed_records_; }
     
+    // XXH64 (hex) of the decoded STDF byte stream, taken from the buffers the
+    // last parse_to_columns() read; gzip/bzip2 files hash their decompressed
+    // content, so a file and its compressed copy share one key. Empty on failure.
+    const std::string& get_content_hash() const { return content_hash_; }
+    // The key of the next parse_to_columns() file when the caller has it
+    // already (a cache lookup hashed it): that parse reports it instead of
+    // hashing the bytes again
+    void set_content_hash(const std::string& hash) { known_content_hash_ = hash; }
+    
+    // The same key computed without decoding: one read over the file
+    // (inflating gzip/bzip2). Empty if it cannot be read.
+    static std::string hash_file_content(const std::string& filepath);
+    
 private:
     // libstdf integration
     bool open_stdf_file(const std::string& filepath);
     void close_stdf_file();
+    bool stream_file_mmap(const std::string& filepath, const STDFRecordCallback& callback);
+    bool decode_to_columns(const std::string& filepath, STDFColumnarStore& store);
+    bool parse_to_columns_mmap(const std::string& filepath, STDFColumnarStore& store);
+    
+    // Parallel decoding (records [first_record, first_record + record_count)
+    // occupying bytes [begin_offset, end_offset))
+    struct DecodeChunk {
+        size_t begin_offset;
+        size_t end_offset;
+        uint32_t first_record;
+        uint32_t record_count;
+    };
+    bool plan_chunks(const std::string& filepath, std::vector<DecodeChunk>& chunks);
+    bool stream_file_parallel(const std::string& filepath, const std::vector<DecodeChunk>& chunks,
+                              const STDFRecordCallback& callback);
+    bool parse_to_columns_parallel(const std::string& filepath, const std::vector<DecodeChunk>& chunks,
+                                   STDFColumnarStore& store);
+    
+    // Pipelined decompression (gzip/bzip2)
+    bool use_pipelined_decompression(const std::string& filepath) const;
+    bool decode_compressed(const std::string& filepath, const std::function<void(STDFBinaryParser&)>& decode);
+    
+    // Uncompressed input decoded by the MMAP reader (MMAP, or native I/O)
+    bool use_mapped_reader(const std::string& filepath) const;
     STDFRecord parse_record(void* stdf_record, STDFRecordType type);
     STDFRecord parse_record_safe(void* stdf_record, STDFRecordType type);
     
@@ -81,19 +224,31 @@ private:
     
     // Utility functions
     STDFRecordType get_record_type(uint8_t rec_typ, uint8_t rec_sub);
+    const DynamicFieldExtractor& field_extractor() const;
+    STDFRecord parse_projected_record(STDFRecordView& view);
     std::string extract_string_field(const char* field, size_t max_len = 255);
     
     // Configuration and state
     std::vector<STDFRecordType> enabled_types_;
-    std::map<std::string, std::vector<std::string>> field_config_;
+    RecordTypeFilter record_filter_;  // enabled_types_ by (REC_TYP, REC_SUB), tested before decode
+    std::shared_ptr<DynamicFieldExtractor> field_extractor_;  // set_field_config; null = shared
+    STDFParserBackend backend_;
+    bool native_io_;
+    size_t num_threads_;
     
     // File handling
     void* stdf_file_handle_;
+    std::unique_ptr<STDFRecordIndex> index_;
+    std::unique_ptr<STDFBinaryParser> indexed_reader_;
     std::string current_filename_;
     
     // Statistics
     size_t total_records_;
     size_t parsed_records_;
+    size_t trailing_bytes_;  // Bytes after the last whole record (decode_compressed)
+    std::string content_hash_;
+    std::string known_content_hash_;  // set_content_hash, for the next parse_to_columns
+    bool hash_content_;               // False while decoding a file whose hash is known
     
     // Context from MIR record
     std::string mir_lot_id_;
@@ -0,0 +1,69 @@
+#ifndef STDF_RECORD_INDEX_H
+#define STDF_RECORD_INDEX_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// One record header as located in the file
+struct STDFIndexEntry {
+    uint64_t offset;       // Byte offset of the record header
+    uint16_t length;       // REC_LEN (payload bytes after the header)
+    uint8_t rec_type;
+    uint8_t rec_subtype;
+    uint8_t head_num;      // PIR/PRR/PTR/MPR/FTR only, 0 otherwise
+    uint8_t site_num;
+    uint16_t reserved;
+};
+
+// PIR..PRR bracket of one part (record ordinals are 1-based, inclusive)
+struct STDFPartSpan {
+    uint32_t first_record;
+    uint32_t prr_record;
+    uint8_t head_num;
+    uint8_t site_num;
+};
+
+/**
+ * Byte-offset index over every record of an uncompressed STDF V4 file
+ *
+ * Built with a header-only walk over a memory mapping (no field decoding)
+ * and persisted as a sidecar "<file>.idx" next to the STDF, or under a
+ * cache directory. The sidecar records the source size and mtime and is
+ * rebuilt when either changes. Record ordinals match
+ * STDFRecord::record_index.
+ */
+class STDFRecordIndex {
+public:
+    STDFRecordIndex();
+
+    bool build(const std::string& filepath);
+    bool load(const std::string& index_path, const std::string& filepath);
+    bool save(const std::string& index_path) const;
+
+    // Load a valid sidecar, otherwise build and write it
+    bool load_or_build(const std::string& filepath, const std::string& cache_dir = "");
+    static std::string sidecar_path(const std::string& filepath, const std::string& cache_dir = "");
+
+    // Lookup
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+    const STDFIndexEntry& entry(uint32_t record_index) const { return entries_[record_index - 1]; }
+    const std::vector<STDFIndexEntry>& entries() const { return entries_; }
+    const std::vector<STDFPartSpan>& parts() const { return parts_; }
+    std::vector<uint32_t> find_records(uint8_t rec_type, uint8_t rec_subtype) const;
+
+    const std::string& get_last_error() const { return last_error_; }
+
+private:
+    void build_parts();
+    static bool source_stamp(const std::string& filepath, uint64_t& size, int64_t& mtime);
+
+    std::vector<STDFIndexEntry> entries_;
+    std::vector<STDFPartSpan> parts_;
+    uint64_t source_size_;
+    int64_t source_mtime_;
+    mutable std::string last_error_;
+};
+
+#endif // STDF_RECORD_INDEX_H
@@ -0,0 +1,132 @@
+#ifndef STDF_RECORD_VIEW_H
+#define STDF_RECORD_VIEW_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "stdf_parser.h"
+
+// STDF V4 on-disk field encodings
+enum class STDFFieldKind : uint8_t {
+    U1, U2, U4, I1, I2, I4, R4, B1, C1,
+    CN,   // Length-prefixed string
+    BN,   // Length-prefixed bytes
+    DN,   // U2 bit count, then the bits
+    XN1,  // Nibble array, count held by an earlier field
+    XU2,  // U2 array, count held by an earlier field
+    XR4   // R4 array, count held by an earlier field
+};
+
+struct STDFFieldSpec {
+    const char* name;
+    STDFFieldKind kind;
+    int8_t count_field;  // Index of the field holding the array length, -1 otherwise
+};
+
+// Dn/Bn bit field over the record's bytes: bit i is bit i % 8 of byte
+// i / 8, as STDF stores it. Clipped to the bytes the record has; bits past
+// bit_count in the last byte are not part of the field.
+struct STDFBitsView {
+    const uint8_t* bytes = nullptr;
+    size_t bit_count = 0;
+
+    size_t byte_count() const { return (bit_count + 7) / 8; }
+    bool empty() const { return bit_count == 0; }
+    bool test(size_t bit) const { return bit < bit_count && ((bytes[bit / 8] >> (bit % 8)) & 1); }
+};
+
+// xN1 nibble array over the record's bytes: element i is the low (even i)
+// or high (odd i) nibble of byte i / 2
+struct STDFNibblesView {
+    const uint8_t* bytes = nullptr;
+    size_t count = 0;
+
+    size_t size() const { return count; }
+    uint8_t operator[](size_t i) const { return (bytes[i / 2] >> (4 * (i % 2))) & 0x0F; }
+};
+
+/**
+ * Lazily decoded view over one record's raw bytes
+ *
+ * Keeps a span over the record body and an offset table that is filled on
+ * demand: an access walks the on-disk layout only as far as the requested
+ * field (Cn strings and arrays make every later offset depend on the bytes
+ * before it), so asking for TEST_NUM and RESULT never touches the strings
+ * behind them. Typed accessors decode straight from the span (bit and
+ * nibble fields as views into it); get_field()
+ * gives the same text STDFRecord::fields holds for the record and caches it.
+ *
+ * Covers MIR, PIR, PRR, PTR, MPR, FTR, HBR and SBR. The view does not own
+ * the bytes; it is valid only while the mapping or libstdf buffer it was
+ * made from is (STDFParser::stream_views hands it out per callback).
+ */
+class STDFRecordView {
+public:
+    static constexpr size_t MAX_FIELDS = 40;
+
+    STDFRecordView() = default;
+
+    // Point the view at a record body (header excluded) and forget all
+    // resolved offsets and cached text
+    void reset(uint8_t rec_type, uint8_t rec_subtype, const uint8_t* body, uint16_t length,
+               bool swap_bytes, uint32_t record_index);
+
+    STDFRecordType type() const { return type_; }
+    uint8_t rec_type() const { return rec_type_; }
+    uint8_t rec_subtype() const { return rec_subtype_; }
+    uint32_t record_index() const { return record_index_; }
+    const uint8_t* data() const { return data_; }
+    uint16_t length() const { return length_; }
+
+    // Field names in on-disk order
+    size_t field_count() const { return schema_size_; }
+    const STDFFieldSpec& field_spec(size_t index) const { return schema_[index]; }
+    int field_index(std::string_view name) const;  // -1 if the record type has no such field
+    bool has_field(std::string_view name) const { return field_index(name) >= 0; }
+
+    // Typed accessors. Fields past the end of the record (or of another
+    // kind) read as the defaults the decoders use: 0, ' ' for C1, "".
+    uint32_t get_unsigned(std::string_view name);  // U1, U2, U4, B1
+    int32_t get_signed(std::string_view name);     // I1, I2, I4
+    float get_float(std::string_view name);        // R4
+    char get_char(std::string_view name);          // C1
+    std::string_view get_string(std::string_view name);   // Cn, length byte stripped
+    size_t get_floats(std::string_view name, std::vector<float>& values);  // xR4
+    size_t get_u2s(std::string_view name, std::vector<uint16_t>& values);  // xU2
+
+    // Zero-copy views of FTR FAIL_PIN/SPIN_MAP (Dn), PRR PART_FIX (Bn) and
+    // RTN_STAT/PGM_STAT (xN1); empty for other kinds
+    STDFBitsView get_bits(std::string_view name);
+    STDFNibblesView get_nibbles(std::string_view name);
+
+    // Text form as in STDFRecord::fields; "" for an unknown name
+    const std::string& get_field(std::string_view name);
+
+private:
+    size_t field_offset(size_t index);  // Resolves offsets_ up to index
+    size_t field_size(size_t index, size_t offset);
+    uint16_t load_u2(size_t offset) const;
+    uint32_t load_u4(size_t offset) const;
+    uint32_t unsigned_at(size_t index);
+    int32_t signed_at(size_t index);
+    float float_at(size_t index);
+    std::string field_text(size_t index);
+
+    const STDFFieldSpec* schema_ = nullptr;
+    size_t schema_size_ = 0;
+    STDFRecordType type_ = STDFRecordType::UNKNOWN;
+    uint8_t rec_type_ = 0;
+    uint8_t rec_subtype_ = 0;
+    const uint8_t* data_ = nullptr;
+    uint16_t length_ = 0;
+    bool swap_bytes_ = false;
+    uint32_t record_index_ = 0;
+
+    uint16_t offsets_[MAX_FIELDS + 1] = {};
+    size_t resolved_ = 0;  // offsets_[0..resolved_] are known
+    std::vector<std::pair<size_t, std::string>> text_cache_;
+};
+
+#endif // STDF_RECORD_VIEW_H
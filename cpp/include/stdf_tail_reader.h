@@ -0,0 +1,62 @@
+#ifndef STDF_TAIL_READER_H
+#define STDF_TAIL_READER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "stdf_binary_parser.h"
+#include "columnar_store.h"
+
+/**
+ * Incremental reader for an STDF file that is still being written
+ *
+ * Remembers the offset just past the last whole record and that record's
+ * ordinal. Each poll() reads only the bytes appended since then (plain
+ * reads, so local disks and network shares behave the same), walks their
+ * headers up to the last whole record and decodes those records into the
+ * caller's store with the memory-mapped reader's decoders. A record the
+ * tester has not finished writing is left for the next poll. Byte order
+ * comes from the FAR on the first poll and is kept. Uncompressed files
+ * only: a gzip/bzip2 stream cannot be resumed mid-member.
+ */
+class STDFTailReader {
+public:
+    STDFTailReader();
+
+    // Starts over at the beginning of filepath
+    bool open(const std::string& filepath);
+
+    // Appends the whole records written since the last poll to store (with
+    // ordinals continuing the file's). False on a read error, a file that
+    // shrank or was replaced, or a first record that is not a FAR.
+    bool poll(STDFColumnarStore& store);
+
+    const std::string& path() const { return filepath_; }
+    uint64_t offset() const { return offset_; }               // End of the last whole record read
+    uint32_t record_count() const { return record_count_; }   // Whole records read so far
+    size_t last_poll_records() const { return last_poll_records_; }
+    uint64_t pending_bytes() const { return pending_bytes_; } // Unfinished record at the last poll
+    bool complete() const { return complete_; }               // MRR read: the tester closed the lot
+    const std::string& get_last_error() const { return last_error_; }
+
+    static constexpr size_t READ_CHUNK = 16 << 20;  // Larger than any record (64 KiB + header)
+
+private:
+    // Whole records at the start of buffer_[0, size): their bytes and how
+    // many there are; takes the byte order from the FAR and notes the MRR
+    bool whole_records(size_t size, size_t& bytes, uint32_t& count);
+
+    std::string filepath_;
+    STDFBinaryParser parser_;
+    std::vector<uint8_t> buffer_;
+    uint64_t offset_;
+    uint32_t record_count_;
+    size_t last_poll_records_;
+    uint64_t pending_bytes_;
+    bool big_endian_;
+    bool complete_;
+    std::string last_error_;
+};
+
+#endif // STDF_TAIL_READER_H
@@ -0,0 +1,35 @@
+#ifndef STREAM_HASH_H
+#define STREAM_HASH_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Incremental XXH64 (xxHash, 64-bit)
+ *
+ * Bytes can be fed in any number of update() calls; the digest only
+ * depends on the concatenated input and the seed, never on the host's
+ * byte order, compiler or chunking. Used as the stable file dedupe key.
+ */
+class StreamHash {
+public:
+    explicit StreamHash(uint64_t seed = 0);
+
+    void reset(uint64_t seed = 0);
+    void update(const void* data, size_t size);
+
+    uint64_t digest() const;
+    std::string hex_digest() const;  // 16 lowercase hex digits
+
+    uint64_t total_bytes() const { return total_; }
+
+private:
+    uint64_t seed_;
+    uint64_t lanes_[4];
+    uint8_t buffer_[32];  // Input not yet consumed as a whole 32-byte stripe
+    size_t buffered_;
+    uint64_t total_;
+};
+
+#endif // STREAM_HASH_H
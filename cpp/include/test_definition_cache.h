@@ -0,0 +1,62 @@
+#ifndef TEST_DEFINITION_CACHE_H
+#define TEST_DEFINITION_CACHE_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "columnar_store.h"
+
+// Effective test metadata of one PTR/MPR row (string ids index the
+// STDFColumnarStore string table the rows came from)
+struct TestDefinition {
+    uint32_t alarm_id;
+    uint32_t test_txt;
+    uint32_t units;
+    float lo_limit;
+    float hi_limit;
+    bool has_lo_limit;
+    bool has_hi_limit;
+};
+
+/**
+ * Per-file STDF default-data inheritance for PTR/MPR
+ *
+ * The first PTR/MPR of a (TEST_NUM, HEAD_NUM, SITE_NUM) defines the test:
+ * its TEST_TXT/ALARM_ID, UNITS and limits become the defaults. Later rows
+ * typically leave those fields out (truncated record, empty Cn, or
+ * OPT_FLAG bits 4/5 "limit invalid") and inherit them; whatever a row does
+ * carry overrides the default for that row only. OPT_FLAG bits 6/7 mean
+ * the row has no low/high limit.
+ */
+class TestDefinitionCache {
+public:
+    // The returned reference is valid until the next resolve call
+    const TestDefinition& resolve_ptr(const STDFColumnarStore& store, size_t row);
+    const TestDefinition& resolve_mpr(const STDFColumnarStore& store, size_t row);
+
+    size_t size() const { return definitions_.size(); }
+    void clear();
+
+private:
+    // What a row actually carries
+    struct RowFields {
+        TestDefinition values;
+        bool has_name;
+        bool has_units;
+        bool lo_present;  // LO_LIMIT valid in this row
+        bool hi_present;
+        bool lo_none;     // OPT_FLAG says there is no low limit
+        bool hi_none;
+    };
+
+    static void limits_from_flags(RowFields& fields, bool has_opt_flag, uint8_t opt_flag,
+                                  bool has_lo, bool has_hi);
+    const TestDefinition& resolve(uint32_t test_num, uint8_t head_num, uint8_t site_num,
+                                  const RowFields& fields);
+
+    std::unordered_map<uint64_t, uint32_t> index_;  // (TEST_NUM, HEAD_NUM, SITE_NUM) -> definition
+    std::vector<TestDefinition> definitions_;
+    TestDefinition effective_;
+};
+
+#endif // TEST_DEFINITION_CACHE_H
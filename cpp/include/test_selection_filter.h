@@ -0,0 +1,43 @@
+#ifndef TEST_SELECTION_FILTER_H
+#define TEST_SELECTION_FILTER_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Substring filter that selects tests by name
+ *
+ * A text is selected when it contains any of the configured patterns
+ * (case-sensitive; an empty pattern selects everything, an empty list
+ * nothing). The default is the pipeline's pixel-test rule, {"Pixel="}.
+ *
+ * Matching compares the first and last byte of each pattern against 16/32
+ * text positions per step and only runs memcmp on the candidates. The
+ * widest kernel the CPU supports is picked once at startup: AVX2 or SSE2
+ * on x86-64, NEON on AArch64, a scalar loop elsewhere.
+ */
+class TestSelectionFilter {
+public:
+    TestSelectionFilter();
+    explicit TestSelectionFilter(const std::vector<std::string>& patterns);
+
+    void set_patterns(const std::vector<std::string>& patterns);
+    const std::vector<std::string>& patterns() const { return patterns_; }
+
+    bool matches(std::string_view text) const;
+
+    // selected[i] = 1 when texts[i] contains any pattern, 0 otherwise
+    void match_batch(const std::string_view* texts, size_t count, uint8_t* selected) const;
+
+    // Kernel in use: "avx2", "sse2", "neon" or "scalar"
+    static const char* implementation();
+
+private:
+    std::vector<std::string> patterns_;
+    bool match_all_;  // An empty pattern is configured
+};
+
+#endif // TEST_SELECTION_FILTER_H
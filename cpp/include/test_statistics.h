@@ -0,0 +1,57 @@
+#ifndef TEST_STATISTICS_H
+#define TEST_STATISTICS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+
+/**
+ * Mergeable running statistics of one test's measurements
+ *
+ * count/mean/m2 follow Welford; two accumulators combine with Chan et
+ * al.'s parallel update, so workers can each summarize a share of the
+ * rows and merge afterwards. Values arrive a block at a time (a PTR
+ * result or an MPR's results): a block is reduced in simple loops the
+ * compiler vectorizes and then merged, instead of one dependent update
+ * per value.
+ */
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;   // Sum of squared deviations from the mean
+    double min = 0.0;
+    double max = 0.0;
+    uint64_t passed = 0;
+
+    // Adds values[0..count); a value passes when it lies within the limits
+    // that are present. Without limits passed_without_limits decides
+    // (the test's TEST_FLG pass/fail for all its values).
+    void add(const double* values, size_t value_count, double lo_limit, double hi_limit,
+             bool has_lo_limit, bool has_hi_limit, bool passed_without_limits);
+    void merge(const RunningStats& other);
+
+    double variance() const { return count > 1 ? m2 / static_cast<double>(count - 1) : 0.0; }  // Sample
+    double stddev() const;
+};
+
+// Per-file summary of one parameter (wtp_id). Limits are those of the
+// first test row seen; names are views like the batch dictionaries'.
+struct TestSummary {
+    uint32_t wtp_id = 0;
+    std::string_view wtp_param_name;
+    std::string_view units;
+    uint32_t test_num = 0;
+    double lo_limit = 0.0;
+    double hi_limit = 0.0;
+    bool has_lo_limit = false;
+    bool has_hi_limit = false;
+    RunningStats stats;
+
+    // min((hi - mean) / 3s, (mean - lo) / 3s) over the limits present;
+    // NaN without limits or with fewer than two distinct values
+    double cpk() const;
+    // Fraction of values that passed (0 when there are none)
+    double yield() const;
+};
+
+#endif // TEST_STATISTICS_H
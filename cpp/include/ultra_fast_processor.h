@@ -4,12 +4,23 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
 #include <cstdint>
-#include <regex>
+#include <string_view>
 #include "stdf_parser.h"
+#include "columnar_store.h"
+#include "test_definition_cache.h"
+#include "part_association.h"
+#include "pixel_name.h"
+#include "test_selection_filter.h"
+#include "sharded_id_map.h"
+#include "measurement_batch.h"
+#include "test_statistics.h"
+#include "bin_summary.h"
+#include "measurement_spool.h"
 
 /**
  * Ultra-Fast STDF to ClickHouse Processor
@@ -18,22 +29,6 @@
  * and only returning final measurement tuples for ClickHouse insertion.
  */
 
-// 🚀 MACRO-DRIVEN: Measurement structure auto-generated from measurement_fields.def
-struct MeasurementTuple {
-    // Define MEASUREMENT_FIELD macro to generate struct members
-    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
-        cpp_type name;
-    
-    // Include all fields from measurement_fields.def
-    #include "measurement_fields.def"
-    
-    // Undefine the macro
-    #undef MEASUREMENT_FIELD
-    
-    // Constructor for easy initialization
-    MeasurementTuple() = default;
-};
-
 // MIR information extracted from STDF
 struct MIRInfo {
     std::string facility;
@@ -45,10 +40,13 @@ struct MIRInfo {
     std::string start_time;
 };
 
-// Device and parameter ID management with database integration
+// Device and parameter ID management with database integration. Both tables
+// are sharded (see sharded_id_map.h), so processors on different threads can
+// share one manager and assign IDs in the same pass.
 class FastIDManager {
 public:
-    FastIDManager();
+    // Attaches the default snapshots (set_default_snapshot_dir) unless told not to
+    explicit FastIDManager(bool attach_default_snapshots = true);
     
     // Database integration methods
     void load_existing_mappings_from_python(
@@ -56,90 +54,244 @@ public:
         const std::vector<std::pair<std::string, uint32_t>>& param_mappings
     );
     
-    uint32_t get_device_id(const std::string& device_dmc);
-    uint32_t get_param_id(const std::string& param_name);
+    uint32_t get_device_id(std::string_view device_dmc) { return devices_.get_or_assign(device_dmc); }
+    uint32_t get_param_id(std::string_view param_name) { return params_.get_or_assign(param_name); }
     
-    const std::unordered_map<std::string, uint32_t>& get_device_map() const { return device_id_map_; }
-    const std::unordered_map<std::string, uint32_t>& get_param_map() const { return param_id_map_; }
+    // Every mapping, pre-existing and new, sorted by ID
+    std::vector<std::pair<std::string, uint32_t>> get_device_mappings() const { return devices_.all_mappings(); }
+    std::vector<std::pair<std::string, uint32_t>> get_param_mappings() const { return params_.all_mappings(); }
     
     // Get only new mappings (for database insertion)
-    std::vector<std::pair<std::string, uint32_t>> get_new_device_mappings() const;
-    std::vector<std::pair<std::string, uint32_t>> get_new_param_mappings() const;
+    std::vector<std::pair<std::string, uint32_t>> get_new_device_mappings() const { return devices_.new_mappings(); }
+    std::vector<std::pair<std::string, uint32_t>> get_new_param_mappings() const { return params_.new_mappings(); }
+    
+    // Memory-mapped snapshots (devices.idmap, params.idmap in snapshot_dir)
+    // as the pre-existing mappings; load_existing_mappings_from_python then
+    // only needs the IDs above snapshot_max_device_id()/_param_id(). False,
+    // with nothing attached, when either file is missing or unreadable.
+    bool attach_snapshots(const std::string& snapshot_dir);
+    uint32_t snapshot_max_device_id() const { return devices_.snapshot() ? devices_.snapshot()->max_id() : 0; }
+    uint32_t snapshot_max_param_id() const { return params_.snapshot() ? params_.snapshot()->max_id() : 0; }
+    // Every mapping, snapshot included, as the snapshots in snapshot_dir
+    bool save_snapshots(const std::string& snapshot_dir) const;
+    const std::string& get_last_error() const { return last_error_; }
+    
+    // Managers constructed afterwards attach the snapshots in this
+    // directory, when there are any ("" = none)
+    static void set_default_snapshot_dir(const std::string& snapshot_dir);
+    static std::string get_default_snapshot_dir();
+    static std::string snapshot_path(const std::string& snapshot_dir, bool devices);
     
 private:
-    std::unordered_map<std::string, uint32_t> device_id_map_;
-    std::unordered_map<std::string, uint32_t> param_id_map_;
-    std::unordered_set<std::string> existing_devices_;  // Track pre-existing entries
-    std::unordered_set<std::string> existing_params_;   // Track pre-existing entries
-    uint32_t device_counter_;
-    uint32_t param_counter_;
+    ShardedIDMap devices_;
+    ShardedIDMap params_;
+    mutable std::string last_error_;
 };
 
+class STDFTailReader;
+
+// Receives consecutive slices of a file's rows; return false to stop early.
+// The batch may be moved from.
+using MeasurementSink = std::function<bool(MeasurementBatch&)>;
+
 // Ultra-fast STDF processor
 class UltraFastProcessor {
 public:
     UltraFastProcessor();
     ~UltraFastProcessor();
     
-    // Main processing function
+    // Main processing function. String fields of the returned tuples point
+    // into this processor's per-file string table: they stay valid until the
+    // next call (or destruction), which frees the whole table at once.
     std::vector<MeasurementTuple> process_stdf_file(const std::string& filepath);
     
+    // Same rows, dictionary-encoded (see measurement_batch.h); the
+    // dictionaries' views follow the same lifetime rule
+    MeasurementBatch process_stdf_file_to_batch(const std::string& filepath);
+    
+    // Same rows in file order, batch_rows at a time (the last batch may be
+    // shorter; 0 = one batch). Each batch carries the file's full
+    // dictionaries. Only the parsed columns and one batch are held at once.
+    // False on a parse error or when the sink stopped.
+    bool process_stdf_file_in_batches(const std::string& filepath, size_t batch_rows, const MeasurementSink& sink);
+    
+    // Same rows, staged in spool as blocks of spool.block_rows() tagged with
+    // file; past the spool's memory budget they go to disk. The blocks own
+    // their text, so they outlive this processor's next call.
+    bool process_stdf_file_to_spool(const std::string& filepath, MeasurementSpool& spool, size_t file = 0);
+    
+    // Tail-follow mode for a file the tester is still writing. After
+    // start_following(), each poll_followed_file() decodes only the whole
+    // records appended since the previous poll (see stdf_tail_reader.h) and
+    // emits the measurements of the parts they close, batch_rows at a time.
+    // Tests of parts still open (after the last PRR of their head/site), the
+    // MIR, test definitions and resolved names carry over between polls, so
+    // a poll costs time in proportion to the new records, not the file.
+    // Test summaries and bin counts cover the parts the last poll closed;
+    // the file_hash column is set_file_hash()'s value, or the file path
+    // since the content is not final yet. False on a read error or when
+    // the sink stopped. Uncompressed files only.
+    bool start_following(const std::string& filepath);
+    bool poll_followed_file(size_t batch_rows, const MeasurementSink& sink);
+    const STDFTailReader* followed_file() const { return tail_.get(); }  // Offset, records, complete()
+    size_t open_part_tests() const;  // Test rows carried into the next poll
+    
     // Configuration
     void set_enable_pixel_filtering(bool enable) { enable_pixel_filtering_ = enable; }
+    // Tests whose ALARM_ID or TEST_TXT contains any pattern are kept while
+    // filtering is enabled (default {"Pixel="})
+    void set_test_filter_patterns(const std::vector<std::string>& patterns) { test_filter_.set_patterns(patterns); }
+    // Fixed file_hash column value; by default each file gets its content
+    // hash (STDFParser::get_content_hash), computed while it is parsed
     void set_file_hash(const std::string& hash) { file_hash_ = hash; }
+    void set_parser_backend(STDFParserBackend backend) { parser_backend_ = backend; }
+    void set_num_threads(size_t threads);  // Decode + tuple generation threads, 0 = one per core
+    // Assign IDs from a manager shared with other processors instead of this
+    // processor's own; nullptr switches back. The manager must outlive the calls.
+    void set_shared_id_manager(FastIDManager* manager) { shared_id_manager_ = manager; }
+    // Decoded columns are looked up in (and, after a decode, written to) a
+    // ColumnarCache under this directory, keyed by content hash; a hit
+    // rebuilds the measurements without decoding the STDF. Empty = off.
+    // New processors start from the process-wide default.
+    void set_cache_dir(const std::string& cache_dir) { cache_dir_ = cache_dir; }
+    const std::string& get_cache_dir() const { return cache_dir_; }
+    static void set_default_cache_dir(const std::string& cache_dir);
+    static std::string get_default_cache_dir();
+    // Each emitted batch is sorted by the measurements table's ORDER BY key
+    // (measurement_sort.h) before it reaches the sink, instead of coming in
+    // file order. Off by default; new processors start from the
+    // process-wide default.
+    void set_sort_output(bool sort) { sort_output_ = sort; }
+    bool get_sort_output() const { return sort_output_; }
+    static void set_default_sort_output(bool sort);
+    static bool get_default_sort_output();
     
     // Statistics
     size_t get_total_records() const { return total_records_; }
     size_t get_processed_measurements() const { return processed_measurements_; }
     double get_parsing_time() const { return parsing_time_; }
     double get_processing_time() const { return processing_time_; }
+    bool loaded_from_cache() const { return loaded_from_cache_; }  // Last file came from the cache
+    const std::string& get_file_hash() const { return current_file_hash_; }  // Of the last file
+    // Per-parameter count/mean/stddev/min/max, Cpk and yield of the last
+    // file's rows, in wtp_id order; accumulated while the rows are built.
+    // Names follow the tuples' lifetime rule.
+    const std::vector<TestSummary>& get_test_summaries() const { return test_summaries_; }
+    // Hard/soft bin counts and yield of the last file, per site and overall
+    const BinSummary& get_bin_summary() const { return bin_summary_; }
+    
+    // Why the last file produced no measurements (empty when it parsed)
+    const std::string& get_last_error() const { return last_error_; }
     
     // Get ID mappings for Python bridge
-    const FastIDManager& get_id_manager() const { return id_manager_; }
+    const FastIDManager& get_id_manager() const { return shared_id_manager_ ? *shared_id_manager_ : id_manager_; }
     
 private:
+    // Test row reduced to what tuple generation needs. Names are views into
+    // text_, values a slice of test_values_.
+    struct ProcessedTest {
+        uint32_t value_offset;
+        uint32_t value_count;
+        uint32_t name_slot;  // Index into resolved_names_
+        std::string_view cleaned_param_name;
+        std::string_view units;
+        uint32_t name_code;   // Codes into the batch's wtp_param_name / units dictionaries
+        uint32_t units_code;
+        uint32_t test_num;
+        uint8_t test_flg;
+        int32_t pixel_x;
+        int32_t pixel_y;
+        uint32_t param_id;
+        float lo_limit;       // Effective limits (see TestDefinitionCache)
+        float hi_limit;
+        bool has_lo_limit;
+        bool has_hi_limit;
+        uint32_t summary_slot;  // Index into test_summaries_
+    };
+    
+    // Everything derived from one distinct (ALARM_ID, TEST_TXT) pair,
+    // computed once per file however many sites and parts repeat it
+    struct ResolvedName {
+        bool keep;                            // Passes the test selection filter
+        std::string_view cleaned_param_name;  // View into text_
+        int32_t pixel_x;
+        int32_t pixel_y;
+        uint32_t param_id;                    // UINT32_MAX until tuple generation
+        uint32_t name_code;                   // UINT32_MAX until tuple generation
+        uint32_t summary_slot;                // UINT32_MAX until tuple generation
+    };
+    
+    // Accumulates the associated tests' values into test_summaries_, split
+    // over the threads by output row (part_offsets as in process_part_brackets)
+    void summarize_tests(const std::vector<ProcessedTest>& processed_tests, const std::vector<size_t>& part_offsets);
+    
     // Core processing functions
+    void reset_file_state();
+    void carry_open_parts(STDFColumnarStore& store);
+    bool decode_columns(const std::string& filepath, STDFColumnarStore& store, std::string& content_hash);
     MIRInfo extract_mir_info(const std::vector<STDFRecord>& mir_records);
-    std::vector<MeasurementTuple> process_cross_product(
-        const std::vector<STDFRecord>& prr_records,
-        const std::vector<STDFRecord>& test_records,
-        const MIRInfo& mir_info
+    uint32_t resolve_name(const STDFColumnarStore& store, uint32_t alarm_id, uint32_t test_txt);
+    std::string_view resolve_units(const STDFColumnarStore& store, uint32_t units);
+    void build_processed_tests(const STDFColumnarStore& store, std::vector<ProcessedTest>& processed_tests,
+                               std::vector<TestSite>& test_sites);
+    bool process_part_brackets(
+        const STDFColumnarStore& store,
+        std::vector<ProcessedTest>& processed_tests,
+        const std::vector<TestSite>& test_sites,
+        const MIRInfo& mir_info,
+        size_t batch_rows,
+        const MeasurementSink& sink
     );
     
-    // Record filtering and processing
-    std::vector<STDFRecord> filter_records_by_type(
-        const std::vector<STDFRecord>& records, 
-        STDFRecordType type
-    );
-    std::vector<STDFRecord> filter_test_records(const std::vector<STDFRecord>& records);
-    
-    // Test processing utilities
-    bool is_pixel_test(const STDFRecord& test_record);
-    std::vector<double> parse_test_values(const STDFRecord& test_record);
-    std::pair<int32_t, int32_t> extract_pixel_coordinates(const std::string& text);
-    std::string clean_param_name(const std::string& param_name);
-    
     // Utility functions
-    std::string calculate_file_hash(const std::string& filepath);
-    uint8_t calculate_test_flag(const STDFRecord& prr_record);
+    FastIDManager& ids() { return shared_id_manager_ ? *shared_id_manager_ : id_manager_; }
+    uint8_t calculate_test_flag(uint16_t soft_bin);
     
     // Configuration
     bool enable_pixel_filtering_;
+    TestSelectionFilter test_filter_;
     std::string file_hash_;
+    std::string current_file_hash_;
+    STDFParserBackend parser_backend_;
+    size_t num_threads_;
+    std::string cache_dir_;
+    bool sort_output_;
     
     // ID management
     FastIDManager id_manager_;
+    FastIDManager* shared_id_manager_;
+    
+    // Per-file storage behind the tuples' string views and the test values
+    StringTable text_;
+    std::vector<double> test_values_;
+    
+    // Per-file test-definition caches
+    TestDefinitionCache test_definitions_;
+    std::vector<ResolvedName> resolved_names_;
+    std::unordered_map<uint64_t, uint32_t> name_slots_;  // (ALARM_ID, TEST_TXT) store ids -> slot
+    std::vector<uint32_t> units_text_ids_;               // store string id -> text_ id
+    std::vector<uint8_t> selected_strings_;              // store string id -> matches test_filter_
+    PartAssociation parts_;
+    std::vector<TestSummary> test_summaries_;
+    BinSummary bin_summary_;
     
     // Statistics
     size_t total_records_;
     size_t processed_measurements_;
     double parsing_time_;
     double processing_time_;
+    bool loaded_from_cache_;
+    std::string last_error_;
+    
+    // Scratch for name cleaning (see pixel_name.h)
+    PixelName pixel_name_;
     
-    // Regex patterns (compiled once)
-    std::regex pixel_pattern_;
-    std::regex pixel_clean_pattern1_;
-    std::regex pixel_clean_pattern2_;
+    // Tail-follow state: the reader, the open parts' rows (whose string
+    // table the definition caches index) and the MIR once it has been read
+    std::unique_ptr<STDFTailReader> tail_;
+    STDFColumnarStore follow_store_;
+    MIRInfo follow_mir_;
+    bool follow_mir_read_;
 };
 
 #endif // ULTRA_FAST_PROCESSOR_H
\ No newline at end of file
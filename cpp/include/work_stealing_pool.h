@@ -0,0 +1,77 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+#include <exception>
+#include <cstddef>
+#include <cstdint>
+#include "cpu_topology.h"
+
+/**
+ * Runs a fixed set of tasks on N threads with work stealing
+ *
+ * Tasks are dealt round-robin onto one deque per worker. A worker takes
+ * from the front of its own deque and, once that is empty, steals from
+ * the back of the others, so a worker stuck on one large file does not
+ * hold up the small files queued behind it.
+ *
+ * With costs, tasks are dealt largest first, each onto the worker with
+ * the least work so far (LPT). Every deque then runs from its largest task
+ * down, and thieves take the smallest, so the big tasks start at once and
+ * the small ones fill in around them.
+ *
+ * On a machine with several NUMA nodes (cpu_topology.h) the workers are
+ * spread over the nodes, worker w on node w % N, and a thief tries the
+ * workers of its own node before crossing to another. A pool created by
+ * a worker of another pool keeps all its workers on that worker's node,
+ * so a file's decode threads share the node its buffers were filled on.
+ * Worker 0 is the calling thread and keeps its affinity.
+ *
+ * run() returns once every task has finished. The first exception thrown
+ * by a task is rethrown there, after the other workers have drained.
+ */
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t threads);
+    WorkStealingPool(size_t threads, const CPUTopology& topology);
+
+    size_t thread_count() const { return threads_; }
+
+    void run(const std::vector<std::function<void()>>& tasks);
+    // costs[i]: relative cost of tasks[i] (e.g. bytes to decode)
+    void run(const std::vector<std::function<void()>>& tasks, const std::vector<uint64_t>& costs);
+
+    // Node worker runs on, -1 when not placed
+    int worker_node(size_t worker) const { return nodes_[worker]; }
+
+    // Process-wide, for pools created afterwards (on by default; only has
+    // an effect with more than one node)
+    static void set_numa_placement(bool enabled);
+    static bool get_numa_placement();
+
+private:
+    // Own cache line each, so workers popping their own deques do not
+    // invalidate each other's locks
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    void execute(const std::vector<std::function<void()>>& tasks);
+    bool pop_own(size_t worker, size_t& task);
+    bool steal(size_t thief, size_t& task);
+    void work(size_t worker, const std::vector<std::function<void()>>& tasks);
+
+    size_t threads_;
+    const CPUTopology& topology_;
+    std::vector<int> nodes_;
+    std::vector<std::vector<size_t>> victims_;  // Steal order per worker: own node first
+    std::vector<WorkerQueue> queues_;
+    std::mutex error_mutex_;
+    std::exception_ptr first_error_;
+};
+
+#endif // WORK_STEALING_POOL_H
@@ -0,0 +1,210 @@
+#include "../include/arrow_export.h"
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <cstring>
+
+namespace {
+
+// Arrow format string of a primitive column
+template<typename T> struct ArrowFormat;
+template<> struct ArrowFormat<uint8_t> { static constexpr const char* value = "C"; };
+template<> struct ArrowFormat<int8_t> { static constexpr const char* value = "c"; };
+template<> struct ArrowFormat<uint16_t> { static constexpr const char* value = "S"; };
+template<> struct ArrowFormat<int16_t> { static constexpr const char* value = "s"; };
+template<> struct ArrowFormat<uint32_t> { static constexpr const char* value = "I"; };
+template<> struct ArrowFormat<int32_t> { static constexpr const char* value = "i"; };
+template<> struct ArrowFormat<uint64_t> { static constexpr const char* value = "L"; };
+template<> struct ArrowFormat<int64_t> { static constexpr const char* value = "l"; };
+template<> struct ArrowFormat<float> { static constexpr const char* value = "f"; };
+template<> struct ArrowFormat<double> { static constexpr const char* value = "g"; };
+// String columns: int32 indices (the uint32 codes, which never reach 2^31)
+template<> struct ArrowFormat<std::string_view> { static constexpr const char* value = "i"; };
+
+constexpr int64_t FIELD_COUNT = 0
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) + 1
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    ;
+
+// Each schema node owns its strings and children; released bottom-up
+struct SchemaPrivate {
+    std::string format;
+    std::string name;
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> child_pointers;
+    std::unique_ptr<ArrowSchema> dictionary;
+};
+
+void release_schema(ArrowSchema* schema) {
+    auto* node = static_cast<SchemaPrivate*>(schema->private_data);
+    for (ArrowSchema& child : node->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+    if (node->dictionary && node->dictionary->release) {
+        node->dictionary->release(node->dictionary.get());
+    }
+    delete node;
+    schema->release = nullptr;
+}
+
+SchemaPrivate* init_schema(ArrowSchema* schema, const char* format, const char* name, size_t children) {
+    auto* node = new SchemaPrivate;
+    node->format = format;
+    node->name = name;
+    node->children.resize(children);
+    for (ArrowSchema& child : node->children) {
+        node->child_pointers.push_back(&child);
+    }
+
+    schema->format = node->format.c_str();
+    schema->name = node->name.c_str();
+    schema->metadata = nullptr;
+    schema->flags = 0;
+    schema->n_children = static_cast<int64_t>(children);
+    schema->children = children ? node->child_pointers.data() : nullptr;
+    schema->dictionary = nullptr;
+    schema->release = release_schema;
+    schema->private_data = node;
+    return node;
+}
+
+template<typename T>
+void init_field_schema(ArrowSchema* schema, const char* name) {
+    SchemaPrivate* node = init_schema(schema, ArrowFormat<T>::value, name, 0);
+    if constexpr (std::is_same<T, std::string_view>::value) {
+        node->dictionary.reset(new ArrowSchema);
+        init_schema(node->dictionary.get(), "u", "", 0);
+        schema->dictionary = node->dictionary.get();
+    }
+}
+
+// Each array node keeps the batch's owner alive, plus whatever it copied
+struct ArrayPrivate {
+    std::shared_ptr<const void> owner;
+    std::vector<const void*> buffers;
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> child_pointers;
+    std::unique_ptr<ArrowArray> dictionary;
+    std::vector<int32_t> offsets;  // utf8 dictionary values
+    std::string text;
+};
+
+void release_array(ArrowArray* array) {
+    auto* node = static_cast<ArrayPrivate*>(array->private_data);
+    for (ArrowArray& child : node->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+    if (node->dictionary && node->dictionary->release) {
+        node->dictionary->release(node->dictionary.get());
+    }
+    delete node;
+    array->release = nullptr;
+}
+
+ArrayPrivate* init_array(ArrowArray* array, const std::shared_ptr<const void>& owner, int64_t length,
+                         std::vector<const void*> buffers, size_t children) {
+    auto* node = new ArrayPrivate;
+    node->owner = owner;
+    node->buffers = std::move(buffers);
+    node->children.resize(children);
+    for (ArrowArray& child : node->children) {
+        node->child_pointers.push_back(&child);
+    }
+
+    array->length = length;
+    array->null_count = 0;
+    array->offset = 0;
+    array->n_buffers = static_cast<int64_t>(node->buffers.size());
+    array->n_children = static_cast<int64_t>(children);
+    array->buffers = node->buffers.data();
+    array->children = children ? node->child_pointers.data() : nullptr;
+    array->dictionary = nullptr;
+    array->release = release_array;
+    array->private_data = node;
+    return node;
+}
+
+// Zero-length columns still get a non-null data buffer
+const void* column_data(const void* data) {
+    static const uint64_t empty = 0;
+    return data ? data : &empty;
+}
+
+template<typename T>
+bool init_field_array(ArrowArray* array, const std::shared_ptr<const void>& owner,
+                      const MeasurementColumn<T>& column, std::string&) {
+    init_array(array, owner, static_cast<int64_t>(column.values.size()),
+               {nullptr, column_data(column.values.data())}, 0);
+    return true;
+}
+
+bool init_field_array(ArrowArray* array, const std::shared_ptr<const void>& owner,
+                      const MeasurementColumn<std::string_view>& column, std::string& error) {
+    size_t text_size = 0;
+    for (std::string_view value : column.dictionary) {
+        text_size += value.size();
+    }
+    if (text_size > static_cast<size_t>(std::numeric_limits<int32_t>::max()) ||
+        column.dictionary.size() > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        error = "dictionary too large for 32-bit Arrow offsets";
+        return false;
+    }
+
+    ArrayPrivate* node = init_array(array, owner, static_cast<int64_t>(column.codes.size()),
+                                    {nullptr, column_data(column.codes.data())}, 0);
+
+    node->dictionary.reset(new ArrowArray);
+    ArrayPrivate* values = init_array(node->dictionary.get(), owner, static_cast<int64_t>(column.dictionary.size()),
+                                      {nullptr, nullptr, nullptr}, 0);
+    values->offsets.reserve(column.dictionary.size() + 1);
+    values->text.reserve(text_size);
+    values->offsets.push_back(0);
+    for (std::string_view value : column.dictionary) {
+        values->text.append(value.data(), value.size());
+        values->offsets.push_back(static_cast<int32_t>(values->text.size()));
+    }
+    values->buffers[1] = values->offsets.data();
+    values->buffers[2] = column_data(values->text.data());
+    array->dictionary = node->dictionary.get();
+    return true;
+}
+
+}  // namespace
+
+bool ArrowBatchExporter::export_schema(ArrowSchema* schema) {
+    SchemaPrivate* node = init_schema(schema, "+s", "", static_cast<size_t>(FIELD_COUNT));
+    size_t index = 0;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        init_field_schema<cpp_type>(&node->children[index++], #name);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return true;
+}
+
+bool ArrowBatchExporter::export_array(const std::shared_ptr<const void>& owner, const MeasurementBatch& batch,
+                                      ArrowArray* array, std::string* error) {
+    std::string message;
+    ArrayPrivate* node = init_array(array, owner, static_cast<int64_t>(batch.size()), {nullptr},
+                                    static_cast<size_t>(FIELD_COUNT));
+    size_t index = 0;
+    bool exported = true;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        exported = exported && init_field_array(&node->children[index++], owner, batch.name, message);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    if (!exported) {
+        // Children not reached are still zeroed, without a release callback
+        array->release(array);
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,168 @@
+#include "../include/batch_ingest_engine.h"
+#include "../include/work_stealing_pool.h"
+#include "../include/file_schedule.h"
+#include "../include/file_prefetcher.h"
+#include "../include/console_log.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+BatchIngestEngine::BatchIngestEngine()
+    : num_threads_(1)
+    , parser_backend_(STDFParserBackend::LIBSTDF)
+    , has_patterns_(false)
+    , manifest_(nullptr) {
+}
+
+void BatchIngestEngine::set_num_threads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads_ = threads;
+}
+
+void BatchIngestEngine::set_test_filter_patterns(const std::vector<std::string>& patterns) {
+    test_patterns_ = patterns;
+    has_patterns_ = true;
+}
+
+void BatchIngestEngine::set_memory_budget(size_t bytes, const std::string& spill_dir) {
+    spool_ = bytes > 0 ? std::make_unique<MeasurementSpool>(bytes, spill_dir) : nullptr;
+}
+
+bool BatchIngestEngine::drain_measurements(const std::function<bool(size_t file, MeasurementBatch& batch)>& sink) {
+    return spool_ && spool_->drain(sink);
+}
+
+bool BatchIngestEngine::process_files(const std::vector<std::string>& paths) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    measurements_.clear();
+    processors_.clear();
+    if (spool_) {
+        spool_->clear();
+    }
+    file_stats_.assign(paths.size(), FileIngestStats());
+    last_error_.clear();
+
+    // Manifest hits are settled before any file is opened
+    size_t skipped = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        FileIngestStats& stats = file_stats_[i];
+        stats.path = paths[i];
+        if (manifest_ && manifest_->is_ingested(paths[i], &stats.file_hash)) {
+            stats.success = true;
+            stats.skipped = true;
+            skipped++;
+        }
+    }
+
+    // Largest files first; spare threads go to intra-file decoding, in
+    // proportion to each file's share of the bytes
+    const size_t pending = paths.size() - skipped;
+    const std::vector<uint64_t> costs = estimate_file_costs(paths);
+    uint64_t total_cost = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        total_cost += file_stats_[i].skipped ? 0 : costs[i];
+    }
+
+    std::vector<MeasurementBatch> batches(paths.size());
+    std::vector<std::function<void()>> tasks;
+    std::vector<uint64_t> task_costs;
+    std::vector<std::string> task_paths;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (file_stats_[i].skipped) {
+            processors_.push_back(nullptr);
+            continue;
+        }
+
+        processors_.push_back(std::make_unique<UltraFastProcessor>());
+        UltraFastProcessor& processor = *processors_.back();
+        processor.set_parser_backend(parser_backend_);
+        processor.set_num_threads(decode_threads_for(costs[i], total_cost, pending, num_threads_));
+        processor.set_shared_id_manager(&id_manager_);
+        if (has_patterns_) {
+            processor.set_test_filter_patterns(test_patterns_);
+        }
+        if (i < file_hashes_.size() && !file_hashes_[i].empty()) {
+            processor.set_file_hash(file_hashes_[i]);
+        }
+
+        task_costs.push_back(costs[i]);
+        task_paths.push_back(paths[i]);
+        tasks.emplace_back([this, i, &paths, &batches]() {
+            UltraFastProcessor& processor = *processors_[i];
+            FileIngestStats& stats = file_stats_[i];
+            if (spool_) {
+                processor.process_stdf_file_to_spool(paths[i], *spool_, i);
+            } else {
+                batches[i] = processor.process_stdf_file_to_batch(paths[i]);
+            }
+
+            stats.error = processor.get_last_error();
+            stats.success = stats.error.empty();
+            stats.measurements = processor.get_processed_measurements();
+            stats.total_records = processor.get_total_records();
+            stats.parsing_time = processor.get_parsing_time();
+            stats.processing_time = processor.get_processing_time();
+            stats.file_hash = processor.get_file_hash();
+            if (spool_) {
+                processors_[i].reset();  // Spooled blocks own their text
+            }
+        });
+    }
+
+    WorkStealingPool pool(std::min(num_threads_, std::max<size_t>(1, tasks.size())));
+
+    // The pool starts tasks about largest first too; the files after the
+    // first of each worker are read into the page cache meanwhile
+    const std::vector<size_t> claim_order = largest_first(task_costs);
+    std::vector<std::string> claim_paths;
+    std::vector<size_t> claim_position(tasks.size());
+    for (size_t position = 0; position < claim_order.size(); ++position) {
+        claim_paths.push_back(task_paths[claim_order[position]]);
+        claim_position[claim_order[position]] = position;
+    }
+    FilePrefetcher prefetcher;
+    std::vector<std::function<void()>> claiming_tasks;
+    for (size_t task = 0; task < tasks.size(); ++task) {
+        claiming_tasks.emplace_back([&, task]() {
+            prefetcher.claimed(claim_position[task]);
+            tasks[task]();
+        });
+    }
+    prefetcher.start(claim_paths, pool.thread_count());
+    pool.run(claiming_tasks, task_costs);
+    prefetcher.stop();
+
+    // Merge in input order; rows of one file stay contiguous
+    size_t total_rows = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        file_stats_[i].row_offset = total_rows;
+        total_rows += file_stats_[i].measurements;
+        if (!file_stats_[i].success) {
+            failed++;
+            if (last_error_.empty()) last_error_ = file_stats_[i].error;
+        }
+    }
+    for (auto& batch : batches) {
+        measurements_.append(batch);
+        batch.clear();
+    }
+
+    auto total_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+    if (spool_) {
+        MeasurementSpoolStats spooled = spool_->stats();
+        ConsoleLog::out() << "💾 Staged " << spooled.rows << " measurements in " << spooled.blocks << " blocks, "
+                  << spooled.spilled_blocks << " spilled (" << spooled.spilled_bytes << " bytes), peak "
+                  << spooled.peak_memory_bytes << " of " << spool_->memory_budget() << " bytes in memory" << std::endl;
+    }
+    ConsoleLog::out() << "✅ Batch ingest completed: " << paths.size() << " files (" << skipped << " already ingested, "
+              << failed << " failed), "
+              << total_rows << " measurements on " << pool.thread_count() << " workers in "
+              << total_time << "s" << std::endl;
+
+    return failed == 0;
+}
@@ -0,0 +1,109 @@
+#include "../include/bin_summary.h"
+#include <algorithm>
+#include <unordered_map>
+#include <tuple>
+
+namespace {
+
+uint64_t bin_key(bool soft, uint8_t head_num, uint8_t site_num, uint16_t bin_num) {
+    // Site is ignored for whole-file rows, as STDF does for HEAD_NUM 255
+    if (head_num == ALL_SITES_HEAD) {
+        site_num = 0;
+    }
+    return static_cast<uint64_t>(soft) << 32 | static_cast<uint64_t>(head_num) << 24 |
+           static_cast<uint64_t>(site_num) << 16 | bin_num;
+}
+
+// Hard before soft, whole-file before per-site, then head, site, bin
+bool bin_order(const BinCount& a, const BinCount& b) {
+    auto rank = [](const BinCount& bin) {
+        return std::make_tuple(bin.soft, bin.head_num != ALL_SITES_HEAD, bin.head_num, bin.site_num, bin.bin_num);
+    };
+    return rank(a) < rank(b);
+}
+
+}  // namespace
+
+void BinSummary::clear() {
+    bins_.clear();
+    yields_.clear();
+}
+
+void BinSummary::build(const STDFColumnarStore& store) {
+    clear();
+    const PRRColumns& prr = store.prr;
+
+    std::unordered_map<uint64_t, size_t> index;  // bin_key -> bins_ row
+    auto count = [&](bool soft, uint8_t head_num, uint8_t site_num, uint16_t bin_num) -> BinCount& {
+        auto inserted = index.emplace(bin_key(soft, head_num, site_num, bin_num), bins_.size());
+        if (inserted.second) {
+            BinCount bin;
+            bin.soft = soft;
+            bin.head_num = head_num;
+            bin.site_num = head_num == ALL_SITES_HEAD ? 0 : site_num;
+            bin.bin_num = bin_num;
+            bin.part_count = 0;
+            bin.reported_count = 0;
+            bin.reported = false;
+            bin.pass_fail = ' ';
+            bins_.push_back(bin);
+        }
+        return bins_[inserted.first->second];
+    };
+
+    std::unordered_map<uint32_t, size_t> site_rows;  // head << 8 | site -> yields_ row
+    SiteYield file_yield = {ALL_SITES_HEAD, 0, 0, 0};
+    for (size_t row = 0; row < prr.size(); ++row) {
+        const uint8_t head_num = prr.HEAD_NUM[row];
+        const uint8_t site_num = prr.SITE_NUM[row];
+        const bool good = prr.SOFT_BIN[row] == 1;
+
+        ++count(false, head_num, site_num, prr.HARD_BIN[row]).part_count;
+        ++count(true, head_num, site_num, prr.SOFT_BIN[row]).part_count;
+        ++count(false, ALL_SITES_HEAD, 0, prr.HARD_BIN[row]).part_count;
+        ++count(true, ALL_SITES_HEAD, 0, prr.SOFT_BIN[row]).part_count;
+
+        auto inserted = site_rows.emplace(static_cast<uint32_t>(head_num) << 8 | site_num, yields_.size());
+        if (inserted.second) {
+            yields_.push_back({head_num, site_num, 0, 0});
+        }
+        SiteYield& site = yields_[inserted.first->second];
+        ++site.part_count;
+        site.good_count += good;
+        ++file_yield.part_count;
+        file_yield.good_count += good;
+    }
+
+    // Summary records, matched by key; repeats of a key add up
+    auto reconcile = [&](bool soft, uint8_t head_num, uint8_t site_num, uint16_t bin_num, uint32_t reported_count,
+                         char pass_fail) {
+        BinCount& bin = count(soft, head_num, site_num, bin_num);
+        bin.reported_count += reported_count;
+        bin.reported = true;
+        if (pass_fail == 'P' || pass_fail == 'F') {
+            bin.pass_fail = pass_fail;
+        }
+    };
+    for (size_t row = 0; row < store.hbr.size(); ++row) {
+        reconcile(false, store.hbr.HEAD_NUM[row], store.hbr.SITE_NUM[row], store.hbr.HBIN_NUM[row],
+                  store.hbr.HBIN_CNT[row], store.hbr.HBIN_PF[row]);
+    }
+    for (size_t row = 0; row < store.sbr.size(); ++row) {
+        reconcile(true, store.sbr.HEAD_NUM[row], store.sbr.SITE_NUM[row], store.sbr.SBIN_NUM[row],
+                  store.sbr.SBIN_CNT[row], store.sbr.SBIN_PF[row]);
+    }
+
+    std::sort(bins_.begin(), bins_.end(), bin_order);
+    std::sort(yields_.begin(), yields_.end(), [](const SiteYield& a, const SiteYield& b) {
+        return std::make_pair(a.head_num, a.site_num) < std::make_pair(b.head_num, b.site_num);
+    });
+    if (prr.size() > 0) {
+        yields_.insert(yields_.begin(), file_yield);
+    }
+}
+
+size_t BinSummary::mismatched_bins() const {
+    return static_cast<size_t>(std::count_if(bins_.begin(), bins_.end(), [](const BinCount& bin) {
+        return bin.reported && !bin.matches();
+    }));
+}
@@ -0,0 +1,126 @@
+#include "../include/byte_order.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STDF_SWAP_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define STDF_SWAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+static void swap16_scalar(uint16_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = FileByteOrder<true>::u2(src + 2 * i);
+    }
+}
+
+static void swap32_scalar(uint8_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t value = FileByteOrder<true>::u4(src + 4 * i);
+        std::memcpy(dst + 4 * i, &value, 4);
+    }
+}
+
+#ifdef STDF_SWAP_X86
+static void swap16_sse2(uint16_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), values);
+    }
+    swap16_scalar(dst + i, src + 2 * i, count - i);
+}
+
+static void swap32_sse2(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        // Swap the 16-bit halves, then the bytes within each half
+        values = _mm_shufflehi_epi16(_mm_shufflelo_epi16(values, 0xB1), 0xB1);
+        values = _mm_or_si128(_mm_slli_epi16(values, 8), _mm_srli_epi16(values, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), values);
+    }
+    swap32_scalar(dst + 4 * i, src + 4 * i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void swap16_avx2(uint16_t* dst, const uint8_t* src, size_t count) {
+    const __m256i order = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                           1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 2 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_shuffle_epi8(values, order));
+    }
+    swap16_sse2(dst + i, src + 2 * i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void swap32_avx2(uint8_t* dst, const uint8_t* src, size_t count) {
+    const __m256i order = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                           3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i), _mm256_shuffle_epi8(values, order));
+    }
+    swap32_sse2(dst + 4 * i, src + 4 * i, count - i);
+}
+#endif
+
+#ifdef STDF_SWAP_NEON
+static void swap16_neon(uint16_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        vst1q_u8(reinterpret_cast<uint8_t*>(dst + i), vrev16q_u8(vld1q_u8(src + 2 * i)));
+    }
+    swap16_scalar(dst + i, src + 2 * i, count - i);
+}
+
+static void swap32_neon(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u8(dst + 4 * i, vrev32q_u8(vld1q_u8(src + 4 * i)));
+    }
+    swap32_scalar(dst + 4 * i, src + 4 * i, count - i);
+}
+#endif
+
+using Swap16Kernel = void (*)(uint16_t*, const uint8_t*, size_t);
+using Swap32Kernel = void (*)(uint8_t*, const uint8_t*, size_t);
+
+struct SwapChoice {
+    Swap16Kernel swap16;
+    Swap32Kernel swap32;
+    const char* name;
+};
+
+static SwapChoice choose_kernel() {
+#if defined(STDF_SWAP_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {swap16_avx2, swap32_avx2, "avx2"};
+    return {swap16_sse2, swap32_sse2, "sse2"};
+#elif defined(STDF_SWAP_NEON)
+    return {swap16_neon, swap32_neon, "neon"};
+#else
+    return {swap16_scalar, swap32_scalar, "scalar"};
+#endif
+}
+
+static const SwapChoice& kernel() {
+    static const SwapChoice choice = choose_kernel();
+    return choice;
+}
+
+void byte_swap_copy16(uint16_t* dst, const uint8_t* src, size_t count) {
+    kernel().swap16(dst, src, count);
+}
+
+void byte_swap_copy32(void* dst, const uint8_t* src, size_t count) {
+    kernel().swap32(static_cast<uint8_t*>(dst), src, count);
+}
+
+const char* byte_swap_implementation() {
+    return kernel().name;
+}
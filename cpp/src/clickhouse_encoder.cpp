@@ -0,0 +1,474 @@
+#include "../include/clickhouse_encoder.h"
+#include "../include/console_log.h"
+#include "../include/instrumentation.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socket_t = SOCKET;
+static const socket_t INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+static void close_socket(socket_t socket) { closesocket(socket); }
+#else
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <netdb.h>
+#include <unistd.h>
+using socket_t = int;
+static const socket_t INVALID_SOCKET_HANDLE = -1;
+static void close_socket(socket_t socket) { close(socket); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;  // A server hang-up is an error, not SIGPIPE
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+// Field order of measurement_fields.def
+enum MeasurementFieldIndex {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) FIELD_##name,
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    FIELD_COUNT
+};
+
+static const char* const FIELD_NAMES[FIELD_COUNT] = {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) #name,
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+};
+
+static void append_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+static void append_string(std::string& out, std::string_view value) {
+    append_varint(out, value.size());
+    out.append(value.data(), value.size());
+}
+
+template<typename T>
+static void append_values(std::string& out, const T* values, size_t count) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < count; ++i) {
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, values + i, sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        out.append(bytes, sizeof(T));
+    }
+#else
+    out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+#endif
+}
+
+// Writes rows of one column; string columns encode each dictionary entry once
+template<typename T>
+class ColumnWriter {
+public:
+    explicit ColumnWriter(const MeasurementColumn<T>& column) : column_(column) {}
+    void write(size_t row, std::string& out) const { append_values(out, column_.values.data() + row, 1); }
+    void write_range(size_t first, size_t count, std::string& out) const {
+        append_values(out, column_.values.data() + first, count);
+    }
+    size_t encoded_size() const { return column_.values.size() * sizeof(T); }
+
+private:
+    const MeasurementColumn<T>& column_;
+};
+
+template<>
+class ColumnWriter<std::string_view> {
+public:
+    explicit ColumnWriter(const MeasurementColumn<std::string_view>& column) : column_(column) {
+        entries_.reserve(column.dictionary.size());
+        for (std::string_view value : column.dictionary) {
+            entries_.emplace_back();
+            append_string(entries_.back(), value);
+        }
+    }
+    void write(size_t row, std::string& out) const { out += entries_[column_.codes[row]]; }
+    void write_range(size_t first, size_t count, std::string& out) const {
+        for (size_t row = first; row < first + count; ++row) {
+            write(row, out);
+        }
+    }
+    size_t encoded_size() const {
+        size_t size = 0;
+        for (uint32_t code : column_.codes) {
+            size += entries_[code].size();
+        }
+        return size;
+    }
+
+private:
+    const MeasurementColumn<std::string_view>& column_;
+    std::vector<std::string> entries_;
+};
+
+ClickHouseBlockEncoder::ClickHouseBlockEncoder()
+    : selected_(FIELD_COUNT, true) {
+}
+
+bool ClickHouseBlockEncoder::set_columns(const std::vector<std::string>& columns) {
+    std::vector<bool> selected(FIELD_COUNT, columns.empty());
+    for (const auto& column : columns) {
+        const char* const* found = std::find(FIELD_NAMES, FIELD_NAMES + FIELD_COUNT, column);
+        if (found == FIELD_NAMES + FIELD_COUNT) {
+            last_error_ = "Unknown measurement field '" + column + "'";
+            return false;
+        }
+        selected[found - FIELD_NAMES] = true;
+    }
+    selected_ = selected;
+    last_error_.clear();
+    return true;
+}
+
+std::string ClickHouseBlockEncoder::column_list() const {
+    std::string list;
+    for (size_t field = 0; field < FIELD_COUNT; ++field) {
+        if (!selected_[field]) continue;
+        if (!list.empty()) list += ", ";
+        list += FIELD_NAMES[field];
+    }
+    return list;
+}
+
+std::string ClickHouseBlockEncoder::insert_query(const std::string& table, ClickHouseFormat format) const {
+    return "INSERT INTO " + table + " (" + column_list() + ") FORMAT " +
+           (format == ClickHouseFormat::NATIVE ? "Native" : "RowBinary");
+}
+
+void ClickHouseBlockEncoder::encode(const MeasurementBatch& batch, size_t first, size_t count,
+                                    ClickHouseFormat format, std::string& out) const {
+    count = std::min(count, batch.size() - std::min(first, batch.size()));
+    if (format == ClickHouseFormat::NATIVE) {
+        encode_native(batch, first, count, out);
+    } else {
+        encode_row_binary(batch, first, count, out);
+    }
+}
+
+void ClickHouseBlockEncoder::encode_native(const MeasurementBatch& batch, size_t first, size_t count,
+                                           std::string& out) const {
+    // Block: column count, row count, then name, type and data per column
+    append_varint(out, std::count(selected_.begin(), selected_.end(), true));
+    append_varint(out, count);
+
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        if (selected_[FIELD_##name]) { \
+            append_string(out, #name); \
+            append_string(out, clickhouse_type); \
+            ColumnWriter<cpp_type>(batch.name).write_range(first, count, out); \
+        }
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+}
+
+size_t ClickHouseBlockEncoder::encoded_size(const MeasurementBatch& batch) const {
+    size_t size = 0;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        if (selected_[FIELD_##name]) size += ColumnWriter<cpp_type>(batch.name).encoded_size();
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return size;
+}
+
+void ClickHouseBlockEncoder::encode_row_binary(const MeasurementBatch& batch, size_t first, size_t count,
+                                               std::string& out) const {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        ColumnWriter<cpp_type> name##_writer(batch.name);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    for (size_t row = first; row < first + count; ++row) {
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            if (selected_[FIELD_##name]) name##_writer.write(row, out);
+        #include "../include/measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+    }
+}
+
+// ClickHouseHttpInserter
+
+static std::string url_encode(const std::string& text) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string encoded;
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            encoded.push_back(static_cast<char>(c));
+        } else {
+            encoded.push_back('%');
+            encoded.push_back(hex[c >> 4]);
+            encoded.push_back(hex[c & 0x0F]);
+        }
+    }
+    return encoded;
+}
+
+static bool send_all(socket_t socket, const char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(std::min<size_t>(size, 1 << 30));
+        auto sent = send(socket, data, chunk, SEND_FLAGS);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static socket_t connect_to(const std::string& host, uint16_t port) {
+#ifdef _WIN32
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!started) return INVALID_SOCKET_HANDLE;
+#endif
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return INVALID_SOCKET_HANDLE;
+    }
+
+    socket_t connected = INVALID_SOCKET_HANDLE;
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        socket_t candidate = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (candidate == INVALID_SOCKET_HANDLE) continue;
+        if (connect(candidate, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            connected = candidate;
+            break;
+        }
+        close_socket(candidate);
+    }
+    freeaddrinfo(addresses);
+    return connected;
+}
+
+// Case-insensitive value of an HTTP header in head, or empty
+static std::string header_value(const std::string& head, const char* name) {
+    const size_t name_size = std::strlen(name);
+    for (size_t line = head.find("\r\n"); line != std::string::npos && line + 2 < head.size();
+         line = head.find("\r\n", line + 2)) {
+        size_t start = line + 2;
+        if (head.size() - start > name_size && head[start + name_size] == ':') {
+            bool same = true;
+            for (size_t i = 0; same && i < name_size; ++i) {
+                same = std::tolower(static_cast<unsigned char>(head[start + i])) == name[i];
+            }
+            if (same) {
+                size_t value = head.find_first_not_of(' ', start + name_size + 1);
+                size_t end = head.find("\r\n", start);
+                return value < end ? head.substr(value, end - value) : std::string();
+            }
+        }
+    }
+    return std::string();
+}
+
+// Reads one response: its head and decoded body. False when the
+// connection cannot carry another request (closed, or the length unknown).
+static bool read_response(socket_t socket, std::string& response) {
+    response.clear();
+    char buffer[4096];
+    auto receive = [&]() {
+        auto received = recv(socket, buffer, sizeof(buffer), 0);
+        if (received <= 0) return false;
+        response.append(buffer, static_cast<size_t>(received));
+        return true;
+    };
+    size_t head_end;
+    while ((head_end = response.find("\r\n\r\n")) == std::string::npos) {
+        if (!receive()) return false;
+    }
+    head_end += 4;
+    std::string head = response.substr(0, head_end);
+    for (char& c : head) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    const std::string length = header_value(head, "content-length");
+    const bool chunked = header_value(head, "transfer-encoding").find("chunked") != std::string::npos;
+    bool reusable = header_value(head, "connection").find("close") == std::string::npos;
+
+    if (!length.empty()) {
+        const size_t body_size = std::strtoull(length.c_str(), nullptr, 10);
+        while (response.size() < head_end + body_size) {
+            if (!receive()) return false;
+        }
+        response.resize(head_end + body_size);
+    } else if (chunked) {
+        std::string body;
+        size_t pos = head_end;
+        while (true) {
+            size_t line_end;
+            while ((line_end = response.find("\r\n", pos)) == std::string::npos) {
+                if (!receive()) return false;
+            }
+            const size_t chunk_size = std::strtoull(response.c_str() + pos, nullptr, 16);
+            pos = line_end + 2;
+            if (chunk_size == 0) {
+                // Trailers (normally none) end with an empty line
+                while (response.find("\r\n", pos) == std::string::npos) {
+                    if (!receive()) return false;
+                }
+                break;
+            }
+            while (response.size() < pos + chunk_size + 2) {
+                if (!receive()) return false;
+            }
+            body.append(response, pos, chunk_size);
+            pos += chunk_size + 2;
+        }
+        response.resize(head_end);
+        response += body;
+    } else {
+        while (receive()) {
+        }
+        reusable = false;
+    }
+    return reusable;
+}
+
+ClickHouseHttpInserter::ClickHouseHttpInserter(const ClickHouseConnection& connection)
+    : connection_(connection), keep_alive_(false), socket_(-1), bytes_sent_(0), connections_opened_(0) {
+}
+
+ClickHouseHttpInserter::~ClickHouseHttpInserter() {
+    disconnect();
+}
+
+void ClickHouseHttpInserter::set_keep_alive(bool keep_alive) {
+    keep_alive_ = keep_alive;
+    if (!keep_alive_) {
+        disconnect();
+    }
+}
+
+void ClickHouseHttpInserter::disconnect() {
+    if (socket_ != -1) {
+        close_socket(static_cast<socket_t>(socket_));
+        socket_ = -1;
+    }
+}
+
+int ClickHouseHttpInserter::send_request(const std::string& head, const BodyWriter& write_body, bool& sent,
+                                         std::string& response) {
+    const socket_t socket = static_cast<socket_t>(socket_);
+    sent = send_all(socket, head.data(), head.size());
+    bytes_sent_ = 0;
+
+    auto send_chunk = [&](const char* data, size_t size) {
+        char header[32];
+        int header_size = std::snprintf(header, sizeof(header), "%zx\r\n", size);
+        bytes_sent_ += size;
+        return send_all(socket, header, static_cast<size_t>(header_size)) && send_all(socket, data, size) &&
+               send_all(socket, "\r\n", 2);
+    };
+    sent = sent && write_body(send_chunk);
+    sent = sent && send_all(socket, "0\r\n\r\n", 5);
+
+    // The server replies once the body is complete or on error
+    const bool reusable = read_response(socket, response);
+    if (!keep_alive_ || !reusable) {
+        disconnect();
+    }
+    size_t status_start = response.find(' ');
+    return (status_start != std::string::npos) ? std::atoi(response.c_str() + status_start + 1) : 0;
+}
+
+bool ClickHouseHttpInserter::insert(const std::string& table, const MeasurementBatch& batch,
+                                    const ClickHouseBlockEncoder& encoder, ClickHouseFormat format,
+                                    size_t block_rows) {
+    StageTimer timer(InstrumentedStage::CLICKHOUSE_INSERT);
+    bytes_sent_ = 0;
+    last_error_.clear();
+    if (batch.size() == 0) {
+        return true;
+    }
+
+    block_rows = std::max<size_t>(1, block_rows);
+    return post(encoder.insert_query(table, format), [&](const ChunkSender& send_chunk) {
+        std::string block;
+        for (size_t first = 0; first < batch.size(); first += block_rows) {
+            block.clear();
+            encoder.encode(batch, first, block_rows, format, block);
+            if (!send_chunk(block.data(), block.size())) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+bool ClickHouseHttpInserter::insert_encoded(const std::string& query, const std::string& body) {
+    StageTimer timer(InstrumentedStage::CLICKHOUSE_INSERT);
+    bytes_sent_ = 0;
+    last_error_.clear();
+    if (body.empty()) {
+        return true;
+    }
+
+    return post(query, [&body](const ChunkSender& send_chunk) { return send_chunk(body.data(), body.size()); });
+}
+
+bool ClickHouseHttpInserter::post(const std::string& query, const BodyWriter& write_body) {
+    const std::string endpoint = connection_.host + ":" + std::to_string(connection_.port);
+    std::string request = "POST /?query=" + url_encode(query) + " HTTP/1.1\r\n";
+    request += "Host: " + endpoint + "\r\n";
+    request += "X-ClickHouse-User: " + connection_.user + "\r\n";
+    if (!connection_.password.empty()) {
+        request += "X-ClickHouse-Key: " + connection_.password + "\r\n";
+    }
+    request += "X-ClickHouse-Database: " + connection_.database + "\r\n";
+    request += "Content-Type: application/octet-stream\r\n";
+    request += "Transfer-Encoding: chunked\r\n";
+    request += keep_alive_ ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+
+    // A kept connection may have been closed by the server while idle;
+    // with no response at all the rows were not taken, so send them again
+    // on a new one
+    bool sent = false;
+    int status = 0;
+    std::string response;
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const bool reused = socket_ != -1;
+        if (!reused) {
+            socket_t socket = connect_to(connection_.host, connection_.port);
+            if (socket == INVALID_SOCKET_HANDLE) {
+                last_error_ = "Cannot connect to ClickHouse at " + endpoint;
+                return false;
+            }
+            socket_ = static_cast<intptr_t>(socket);
+            connections_opened_++;
+        }
+        status = send_request(request, write_body, sent, response);
+        if (!reused || !response.empty()) {
+            break;
+        }
+    }
+    if (status == 200) {
+        return true;
+    }
+
+    size_t body = response.find("\r\n\r\n");
+    std::string message = (body != std::string::npos) ? response.substr(body + 4) : response;
+    if (status == 0) {
+        last_error_ = (sent ? "No HTTP response from " : "Connection lost while sending to ") + endpoint;
+    } else {
+        last_error_ = "ClickHouse insert failed (HTTP " + std::to_string(status) + "): " + message;
+    }
+    ConsoleLog::err() << "❌ " << last_error_ << std::endl;
+    return false;
+}
@@ -0,0 +1,382 @@
+#include "../include/columnar_cache.h"
+#include "../include/instrumentation.h"
+#include <zlib.h>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+// Cache layout: header, then one section per column (for_each_column
+// order), then the string table and the MIR records as byte sections.
+// Every section is a CacheSectionHeader followed by its deflated bytes.
+static const char CACHE_MAGIC[8] = {'S', 'T', 'D', 'F', 'C', 'O', 'L', '1'};
+static const uint32_t CACHE_VERSION = 1;
+static const uint32_t CACHE_BYTE_ORDER = 0x01020304;  // Columns are stored in host order
+
+#pragma pack(push, 1)
+struct CacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t section_count;
+    uint32_t reserved;
+    uint64_t total_records;
+    uint64_t parsed_records;
+};
+
+struct CacheSectionHeader {
+    uint32_t element_size;
+    uint32_t reserved;
+    uint64_t element_count;
+    uint64_t compressed_size;  // 0 for an empty column
+};
+#pragma pack(pop)
+
+namespace {
+
+// Every typed column of a store, in a fixed order
+template<typename Store, typename Visit>
+void for_each_column(Store& store, Visit&& visit) {
+    #define FIELD(name, member) visit(store.ptr.member);
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    visit(store.ptr.record_index);
+    visit(store.ptr.rec_len);
+
+    #define FIELD(name, member) visit(store.mpr.member);
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    visit(store.mpr.record_index);
+    visit(store.mpr.rec_len);
+    visit(store.mpr.state_offset);
+    visit(store.mpr.pin_offset);
+
+    #define FIELD(name, member) visit(store.ftr.member);
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    visit(store.ftr.record_index);
+
+    #define FIELD(name, member) visit(store.pir.member);
+    #include "../field_defs/pir_fields.def"
+    #undef FIELD
+    visit(store.pir.record_index);
+
+    #define FIELD(name, member) visit(store.prr.member);
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+    visit(store.prr.record_index);
+
+    #define FIELD(name, member) visit(store.hbr.member);
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
+    visit(store.hbr.record_index);
+
+    #define FIELD(name, member) visit(store.sbr.member);
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+    visit(store.sbr.record_index);
+
+    visit(store.float_pool);
+    visit(store.state_pool);
+    visit(store.pin_pool);
+}
+
+class SectionWriter {
+public:
+    explicit SectionWriter(std::ofstream& out) : out_(out) {}
+
+    template<typename T>
+    void operator()(const std::vector<T>& column) {
+        write(column.data(), sizeof(T), column.size());
+    }
+
+    void write(const void* data, size_t element_size, size_t count) {
+        CacheSectionHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.element_size = static_cast<uint32_t>(element_size);
+        header.element_count = count;
+
+        uLongf compressed_size = 0;
+        if (count > 0) {
+            uLong raw_size = static_cast<uLong>(element_size * count);
+            compressed_size = compressBound(raw_size);
+            buffer_.resize(compressed_size);
+            if (compress2(buffer_.data(), &compressed_size, static_cast<const Bytef*>(data), raw_size,
+                          Z_BEST_SPEED) != Z_OK) {
+                ok_ = false;
+                return;
+            }
+        }
+        header.compressed_size = compressed_size;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.write(reinterpret_cast<const char*>(buffer_.data()), static_cast<std::streamsize>(compressed_size));
+    }
+
+    bool ok() const { return ok_ && static_cast<bool>(out_); }
+
+private:
+    std::ofstream& out_;
+    std::vector<Bytef> buffer_;
+    bool ok_ = true;
+};
+
+class SectionReader {
+public:
+    explicit SectionReader(std::ifstream& in) : in_(in) {}
+
+    template<typename T>
+    void operator()(std::vector<T>& column) {
+        CacheSectionHeader header;
+        if (!ok_ || !in_.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+            header.element_size != sizeof(T)) {
+            ok_ = false;
+            return;
+        }
+        column.resize(header.element_count);
+        if (header.element_count == 0) {
+            return;
+        }
+        buffer_.resize(header.compressed_size);
+        uLongf raw_size = static_cast<uLongf>(header.element_count * sizeof(T));
+        if (!in_.read(reinterpret_cast<char*>(buffer_.data()), static_cast<std::streamsize>(buffer_.size())) ||
+            uncompress(reinterpret_cast<Bytef*>(column.data()), &raw_size, buffer_.data(), buffer_.size()) != Z_OK ||
+            raw_size != header.element_count * sizeof(T)) {
+            ok_ = false;
+        }
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    std::ifstream& in_;
+    std::vector<Bytef> buffer_;
+    bool ok_ = true;
+};
+
+void put_u32(std::vector<uint8_t>& bytes, uint32_t value) {
+    const uint8_t* raw = reinterpret_cast<const uint8_t*>(&value);
+    bytes.insert(bytes.end(), raw, raw + sizeof(value));
+}
+
+void put_text(std::vector<uint8_t>& bytes, std::string_view text) {
+    put_u32(bytes, static_cast<uint32_t>(text.size()));
+    bytes.insert(bytes.end(), text.begin(), text.end());
+}
+
+// Bounds-checked walk over a byte section
+class ByteCursor {
+public:
+    explicit ByteCursor(const std::vector<uint8_t>& bytes) : bytes_(bytes), position_(0) {}
+
+    bool at_end() const { return position_ == bytes_.size(); }
+
+    bool get_u8(uint8_t& value) {
+        if (position_ + 1 > bytes_.size()) return false;
+        value = bytes_[position_++];
+        return true;
+    }
+
+    bool get_u32(uint32_t& value) {
+        if (position_ + sizeof(value) > bytes_.size()) return false;
+        std::memcpy(&value, bytes_.data() + position_, sizeof(value));
+        position_ += sizeof(value);
+        return true;
+    }
+
+    bool get_text(std::string_view& text) {
+        uint32_t size = 0;
+        if (!get_u32(size) || position_ + size > bytes_.size()) return false;
+        text = std::string_view(reinterpret_cast<const char*>(bytes_.data()) + position_, size);
+        position_ += size;
+        return true;
+    }
+
+private:
+    const std::vector<uint8_t>& bytes_;
+    size_t position_;
+};
+
+void encode_strings(const StringTable& strings, std::vector<uint8_t>& bytes) {
+    for (uint32_t id = 1; id < strings.size(); ++id) {  // id 0 is always ""
+        put_text(bytes, strings.get(id));
+    }
+}
+
+bool decode_strings(const std::vector<uint8_t>& bytes, StringTable& strings) {
+    ByteCursor cursor(bytes);
+    std::string_view text;
+    while (!cursor.at_end()) {
+        // Strings were unique when written, so each one gets the next id
+        uint32_t expected = static_cast<uint32_t>(strings.size());
+        if (!cursor.get_text(text) || strings.intern(text) != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void encode_mir_records(const std::vector<STDFRecord>& records, std::vector<uint8_t>& bytes) {
+    put_u32(bytes, static_cast<uint32_t>(records.size()));
+    for (const STDFRecord& record : records) {
+        bytes.push_back(static_cast<uint8_t>(record.type));
+        bytes.push_back(record.rec_type);
+        bytes.push_back(record.rec_subtype);
+        put_u32(bytes, record.record_index);
+        put_u32(bytes, static_cast<uint32_t>(record.fields.size()));
+        for (const auto& field : record.fields) {
+            put_text(bytes, field.first);
+            put_text(bytes, field.second);
+        }
+    }
+}
+
+bool decode_mir_records(const std::vector<uint8_t>& bytes, std::vector<STDFRecord>& records) {
+    ByteCursor cursor(bytes);
+    uint32_t count = 0;
+    if (!cursor.get_u32(count)) {
+        return false;
+    }
+    records.resize(count);
+    for (STDFRecord& record : records) {
+        uint8_t type = 0;
+        uint32_t field_count = 0;
+        if (!cursor.get_u8(type) || !cursor.get_u8(record.rec_type) || !cursor.get_u8(record.rec_subtype) ||
+            !cursor.get_u32(record.record_index) || !cursor.get_u32(field_count)) {
+            return false;
+        }
+        record.type = static_cast<STDFRecordType>(type);
+        for (uint32_t i = 0; i < field_count; ++i) {
+            std::string_view name;
+            std::string_view value;
+            if (!cursor.get_text(name) || !cursor.get_text(value)) {
+                return false;
+            }
+            record.fields.emplace(std::string(name), std::string(value));
+        }
+    }
+    return cursor.at_end();
+}
+
+}  // namespace
+
+ColumnarCache::ColumnarCache(const std::string& directory)
+    : directory_(directory) {
+}
+
+std::string ColumnarCache::entry_path(const std::string& content_hash) const {
+    return (fs::path(directory_) / (content_hash + ".stdfcol")).string();
+}
+
+bool ColumnarCache::contains(const std::string& content_hash) const {
+    std::error_code ec;
+    return enabled() && !content_hash.empty() && fs::is_regular_file(entry_path(content_hash), ec);
+}
+
+bool ColumnarCache::save(const std::string& content_hash, const STDFColumnarStore& store,
+                         const ColumnarCacheInfo& info) const {
+    StageTimer timer(InstrumentedStage::COLUMNAR_CACHE);
+    last_error_.clear();
+    if (!enabled() || content_hash.empty()) {
+        last_error_ = "Columnar cache needs a directory and a content hash";
+        return false;
+    }
+
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+
+    std::string path = entry_path(content_hash);
+    std::string tmp_path = path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        last_error_ = "Cannot write columnar cache " + tmp_path;
+        return false;
+    }
+
+    size_t column_count = 0;
+    for_each_column(store, [&column_count](const auto&) { ++column_count; });
+
+    CacheFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    header.section_count = static_cast<uint32_t>(column_count + 2);
+    header.total_records = info.total_records;
+    header.parsed_records = info.parsed_records;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    SectionWriter writer(out);
+    for_each_column(store, writer);
+
+    std::vector<uint8_t> bytes;
+    encode_strings(store.strings, bytes);
+    writer.write(bytes.data(), 1, bytes.size());
+    bytes.clear();
+    encode_mir_records(store.mir_records, bytes);
+    writer.write(bytes.data(), 1, bytes.size());
+
+    bool written = writer.ok();
+    out.close();
+    if (!written || !out) {
+        last_error_ = "Failed writing columnar cache " + tmp_path;
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+        last_error_ = "Cannot rename columnar cache into place: " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool ColumnarCache::load(const std::string& content_hash, STDFColumnarStore& store, ColumnarCacheInfo& info) const {
+    StageTimer timer(InstrumentedStage::COLUMNAR_CACHE);
+    last_error_.clear();
+    store.clear();
+    if (!enabled() || content_hash.empty()) {
+        last_error_ = "Columnar cache needs a directory and a content hash";
+        return false;
+    }
+
+    std::string path = entry_path(content_hash);
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        last_error_ = "No columnar cache at " + path;
+        return false;
+    }
+
+    size_t column_count = 0;
+    for_each_column(store, [&column_count](const auto&) { ++column_count; });
+
+    CacheFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+        header.version != CACHE_VERSION ||
+        header.byte_order != CACHE_BYTE_ORDER ||
+        header.section_count != column_count + 2) {
+        last_error_ = "Unrecognized columnar cache format: " + path;
+        return false;
+    }
+
+    SectionReader reader(in);
+    for_each_column(store, reader);
+    std::vector<uint8_t> strings;
+    std::vector<uint8_t> mir_records;
+    reader(strings);
+    reader(mir_records);
+
+    if (!reader.ok() || !decode_strings(strings, store.strings) ||
+        !decode_mir_records(mir_records, store.mir_records)) {
+        store.clear();
+        last_error_ = "Corrupt columnar cache: " + path;
+        return false;
+    }
+
+    info.total_records = header.total_records;
+    info.parsed_records = header.parsed_records;
+    return true;
+}
@@ -0,0 +1,374 @@
+#include "../include/columnar_store.h"
+
+#include <cstring>
+
+// ============================================================================
+// StringArena
+// ============================================================================
+
+StringArena::StringArena(size_t block_size)
+    : block_size_(block_size)
+    , block_used_(0)
+    , bytes_used_(0) {
+}
+
+std::string_view StringArena::store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+
+    // Oversized strings get a block of their own, filed behind the open block
+    if (value.size() > block_size_ / 4) {
+        std::unique_ptr<char[]> block(new char[value.size()]);
+        std::memcpy(block.get(), value.data(), value.size());
+        std::string_view stored(block.get(), value.size());
+        blocks_.insert(blocks_.empty() ? blocks_.end() : blocks_.end() - 1, std::move(block));
+        if (blocks_.size() == 1) {
+            block_used_ = block_size_;  // Not an open block
+        }
+        bytes_used_ += value.size();
+        return stored;
+    }
+
+    if (blocks_.empty() || block_used_ + value.size() > block_size_) {
+        blocks_.emplace_back(new char[block_size_]);
+        block_used_ = 0;
+    }
+
+    char* target = blocks_.back().get() + block_used_;
+    std::memcpy(target, value.data(), value.size());
+    block_used_ += value.size();
+    bytes_used_ += value.size();
+    return std::string_view(target, value.size());
+}
+
+void StringArena::clear() {
+    blocks_.clear();
+    block_used_ = 0;
+    bytes_used_ = 0;
+}
+
+// ============================================================================
+// StringTable
+// ============================================================================
+
+StringTable::StringTable() {
+    clear();
+}
+
+uint32_t StringTable::intern(std::string_view value) {
+    auto it = index_.find(value);
+    if (it != index_.end()) {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(strings_.size());
+    std::string_view stored = arena_.store(value);
+    strings_.push_back(stored);
+    index_.emplace(stored, id);
+    return id;
+}
+
+uint32_t StringTable::intern_cn(const char* cn) {
+    if (!cn || cn[0] == 0) return 0;
+    return intern(std::string_view(cn + 1, static_cast<uint8_t>(cn[0])));
+}
+
+void StringTable::clear() {
+    index_.clear();
+    strings_.clear();
+    arena_.clear();
+    strings_.emplace_back();
+    index_.emplace(std::string_view(), 0);
+}
+
+// ============================================================================
+// Column appenders (one overload per ColumnStorage mapping)
+// ============================================================================
+
+template<typename T>
+static void append_value(std::vector<T>& column, const T& value, STDFColumnarStore&) {
+    column.push_back(value);
+}
+
+static void append_value(std::vector<uint32_t>& column, char* const& value, STDFColumnarStore& store) {
+    column.push_back(store.strings.intern_cn(value));
+}
+
+// Offset only; the values are copied by the record-specific append because
+// the element count lives in a sibling field (e.g. MPR RSLT_CNT)
+static void append_value(std::vector<uint32_t>& column, float* const&, STDFColumnarStore& store) {
+    column.push_back(static_cast<uint32_t>(store.float_pool.size()));
+}
+
+static void append_value(std::vector<uint8_t>& column, unsigned char* const& value, STDFColumnarStore&) {
+    column.push_back(value != nullptr ? 1 : 0);
+}
+
+// ============================================================================
+// Record appenders
+// ============================================================================
+
+// Serialized size of a Cn field (length byte + text)
+static size_t cn_size(const char* cn) {
+    return cn ? 1 + static_cast<uint8_t>(cn[0]) : 1;
+}
+
+void STDFColumnarStore::append(const rec_ptr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(ptr.member, rec.member, *this);
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    ptr.record_index.push_back(record_index);
+    ptr.rec_len.push_back(rec.header.REC_LEN);
+}
+
+void STDFColumnarStore::append(const rec_mpr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(mpr.member, rec.member, *this);
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    mpr.record_index.push_back(record_index);
+    mpr.rec_len.push_back(rec.header.REC_LEN);
+
+    // Keep float_pool in step with RSLT_CNT even if the array is absent
+    if (rec.RTN_RSLT) {
+        float_pool.insert(float_pool.end(), rec.RTN_RSLT, rec.RTN_RSLT + rec.RSLT_CNT);
+    } else {
+        float_pool.resize(float_pool.size() + rec.RSLT_CNT, 0.0f);
+    }
+
+    // RTN_STAT/RTN_INDX; REC_LEN says whether the record reaches them
+    const size_t icnt = rec.RTN_ICNT;
+    const size_t state_bytes = (icnt + 1) / 2;
+    const size_t state_end = 12 + state_bytes;
+    const size_t pin_end = state_end + 4 * static_cast<size_t>(rec.RSLT_CNT) + cn_size(rec.TEST_TXT) +
+                           cn_size(rec.ALARM_ID) + 20 + 2 * icnt;
+
+    mpr.state_offset.push_back(static_cast<uint32_t>(state_pool.size()));
+    if (rec.RTN_STAT && rec.header.REC_LEN >= state_end) {
+        for (size_t i = 0; i < icnt; ++i) {
+            uint8_t packed = rec.RTN_STAT[i / 2];
+            state_pool.push_back((i % 2 == 0) ? (packed & 0x0F) : (packed >> 4));
+        }
+    } else {
+        state_pool.resize(state_pool.size() + icnt, 0);
+    }
+
+    mpr.pin_offset.push_back(static_cast<uint32_t>(pin_pool.size()));
+    if (rec.RTN_INDX && rec.header.REC_LEN >= pin_end) {
+        pin_pool.insert(pin_pool.end(), rec.RTN_INDX, rec.RTN_INDX + icnt);
+    } else {
+        pin_pool.resize(pin_pool.size() + icnt, 0);
+    }
+}
+
+void STDFColumnarStore::append(const rec_ftr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(ftr.member, rec.member, *this);
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    ftr.record_index.push_back(record_index);
+}
+
+void STDFColumnarStore::append(const rec_pir& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(pir.member, rec.member, *this);
+    #include "../field_defs/pir_fields.def"
+    #undef FIELD
+    pir.record_index.push_back(record_index);
+}
+
+void STDFColumnarStore::append(const rec_prr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(prr.member, rec.member, *this);
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+    prr.record_index.push_back(record_index);
+}
+
+void STDFColumnarStore::append(const rec_hbr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(hbr.member, rec.member, *this);
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
+    hbr.record_index.push_back(record_index);
+}
+
+void STDFColumnarStore::append(const rec_sbr& rec, uint32_t record_index) {
+    #define FIELD(name, member) append_value(sbr.member, rec.member, *this);
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+    sbr.record_index.push_back(record_index);
+}
+
+// ============================================================================
+// Store merge (one overload per ColumnStorage mapping, selected by the libstdf
+// member type since Cn and xR4 columns share the uint32_t element type)
+// ============================================================================
+
+struct ColumnRemap {
+    std::vector<uint32_t> string_ids;  // other.strings id -> this.strings id
+    uint32_t float_base;               // this.float_pool size before the merge
+};
+
+template<typename T>
+static void merge_column(column_t<T>& column, const column_t<T>& other, const ColumnRemap&) {
+    column.insert(column.end(), other.begin(), other.end());
+}
+
+template<>
+void merge_column<char*>(column_t<char*>& column, const column_t<char*>& other, const ColumnRemap& remap) {
+    column.reserve(column.size() + other.size());
+    for (uint32_t id : other) {
+        column.push_back(remap.string_ids[id]);
+    }
+}
+
+template<>
+void merge_column<float*>(column_t<float*>& column, const column_t<float*>& other, const ColumnRemap& remap) {
+    column.reserve(column.size() + other.size());
+    for (uint32_t offset : other) {
+        column.push_back(offset + remap.float_base);
+    }
+}
+
+void STDFColumnarStore::append_store(const STDFColumnarStore& other) {
+    ColumnRemap remap;
+    remap.string_ids.resize(other.strings.size());
+    for (uint32_t id = 0; id < other.strings.size(); ++id) {
+        remap.string_ids[id] = strings.intern(other.strings.get(id));
+    }
+    remap.float_base = static_cast<uint32_t>(float_pool.size());
+
+    #define FIELD(name, member) merge_column<decltype(rec_ptr::member)>(ptr.member, other.ptr.member, remap);
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_mpr::member)>(mpr.member, other.mpr.member, remap);
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_ftr::member)>(ftr.member, other.ftr.member, remap);
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_pir::member)>(pir.member, other.pir.member, remap);
+    #include "../field_defs/pir_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_prr::member)>(prr.member, other.prr.member, remap);
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_hbr::member)>(hbr.member, other.hbr.member, remap);
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
+    #define FIELD(name, member) merge_column<decltype(rec_sbr::member)>(sbr.member, other.sbr.member, remap);
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+
+    ptr.record_index.insert(ptr.record_index.end(), other.ptr.record_index.begin(), other.ptr.record_index.end());
+    mpr.record_index.insert(mpr.record_index.end(), other.mpr.record_index.begin(), other.mpr.record_index.end());
+    ftr.record_index.insert(ftr.record_index.end(), other.ftr.record_index.begin(), other.ftr.record_index.end());
+    pir.record_index.insert(pir.record_index.end(), other.pir.record_index.begin(), other.pir.record_index.end());
+    prr.record_index.insert(prr.record_index.end(), other.prr.record_index.begin(), other.prr.record_index.end());
+    hbr.record_index.insert(hbr.record_index.end(), other.hbr.record_index.begin(), other.hbr.record_index.end());
+    sbr.record_index.insert(sbr.record_index.end(), other.sbr.record_index.begin(), other.sbr.record_index.end());
+    ptr.rec_len.insert(ptr.rec_len.end(), other.ptr.rec_len.begin(), other.ptr.rec_len.end());
+    mpr.rec_len.insert(mpr.rec_len.end(), other.mpr.rec_len.begin(), other.mpr.rec_len.end());
+    for (uint32_t offset : other.mpr.state_offset) {
+        mpr.state_offset.push_back(offset + static_cast<uint32_t>(state_pool.size()));
+    }
+    for (uint32_t offset : other.mpr.pin_offset) {
+        mpr.pin_offset.push_back(offset + static_cast<uint32_t>(pin_pool.size()));
+    }
+
+    mir_records.insert(mir_records.end(), other.mir_records.begin(), other.mir_records.end());
+    float_pool.insert(float_pool.end(), other.float_pool.begin(), other.float_pool.end());
+    state_pool.insert(state_pool.end(), other.state_pool.begin(), other.state_pool.end());
+    pin_pool.insert(pin_pool.end(), other.pin_pool.begin(), other.pin_pool.end());
+}
+
+// ============================================================================
+// Row retention
+// ============================================================================
+
+template<typename T>
+static void retain_column(std::vector<T>& column, const std::vector<uint8_t>& keep) {
+    size_t kept = 0;
+    for (size_t row = 0; row < column.size(); ++row) {
+        if (keep[row]) {
+            column[kept++] = column[row];
+        }
+    }
+    column.resize(kept);
+}
+
+void STDFColumnarStore::retain(const STDFRowSelection& keep) {
+    // Pool entries first, while the MPR offsets still point at them
+    std::vector<float> floats;
+    std::vector<uint8_t> states;
+    std::vector<uint16_t> pins;
+    for (size_t row = 0; row < mpr.size(); ++row) {
+        if (!keep.mpr[row]) {
+            continue;
+        }
+        const size_t results = mpr.RSLT_CNT[row];
+        const size_t icnt = mpr.RTN_ICNT[row];
+        const uint32_t result_offset = static_cast<uint32_t>(floats.size());
+        const uint32_t state_offset = static_cast<uint32_t>(states.size());
+        const uint32_t pin_offset = static_cast<uint32_t>(pins.size());
+        floats.insert(floats.end(), mpr_results(row), mpr_results(row) + results);
+        states.insert(states.end(), mpr_states(row), mpr_states(row) + icnt);
+        pins.insert(pins.end(), mpr_pins(row), mpr_pins(row) + icnt);
+        mpr.RTN_RSLT[row] = result_offset;
+        mpr.state_offset[row] = state_offset;
+        mpr.pin_offset[row] = pin_offset;
+    }
+    float_pool.swap(floats);
+    state_pool.swap(states);
+    pin_pool.swap(pins);
+
+    #define FIELD(name, member) retain_column(ptr.member, keep.ptr);
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    retain_column(ptr.rec_len, keep.ptr);
+    retain_column(ptr.record_index, keep.ptr);
+    #define FIELD(name, member) retain_column(mpr.member, keep.mpr);
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    retain_column(mpr.rec_len, keep.mpr);
+    retain_column(mpr.state_offset, keep.mpr);
+    retain_column(mpr.pin_offset, keep.mpr);
+    retain_column(mpr.record_index, keep.mpr);
+    #define FIELD(name, member) retain_column(ftr.member, keep.ftr);
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    retain_column(ftr.record_index, keep.ftr);
+    #define FIELD(name, member) retain_column(pir.member, keep.pir);
+    #include "../field_defs/pir_fields.def"
+    #undef FIELD
+    retain_column(pir.record_index, keep.pir);
+    #define FIELD(name, member) retain_column(prr.member, keep.prr);
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+    retain_column(prr.record_index, keep.prr);
+    #define FIELD(name, member) retain_column(hbr.member, keep.hbr);
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
+    retain_column(hbr.record_index, keep.hbr);
+    #define FIELD(name, member) retain_column(sbr.member, keep.sbr);
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+    retain_column(sbr.record_index, keep.sbr);
+}
+
+size_t STDFColumnarStore::size() const {
+    return ptr.size() + mpr.size() + ftr.size() + prr.size() + hbr.size() + sbr.size() +
+           mir_records.size();
+}
+
+void STDFColumnarStore::clear() {
+    ptr = PTRColumns();
+    mpr = MPRColumns();
+    ftr = FTRColumns();
+    pir = PIRColumns();
+    prr = PRRColumns();
+    hbr = HBRColumns();
+    sbr = SBRColumns();
+    mir_records.clear();
+    strings.clear();
+    float_pool.clear();
+    state_pool.clear();
+    pin_pool.clear();
+}
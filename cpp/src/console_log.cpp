@@ -0,0 +1,28 @@
+#include "../include/console_log.h"
+#include <atomic>
+#include <iostream>
+
+static std::atomic<bool> g_quiet{false};
+
+// No buffer: every write fails silently. One per thread, so the stream
+// state it flips on each write is never shared.
+static std::ostream& null_stream() {
+    thread_local std::ostream discard(nullptr);
+    return discard;
+}
+
+void ConsoleLog::set_quiet(bool quiet) {
+    g_quiet.store(quiet, std::memory_order_relaxed);
+}
+
+bool ConsoleLog::is_quiet() {
+    return g_quiet.load(std::memory_order_relaxed);
+}
+
+std::ostream& ConsoleLog::out() {
+    return is_quiet() ? null_stream() : std::cout;
+}
+
+std::ostream& ConsoleLog::err() {
+    return is_quiet() ? null_stream() : std::cerr;
+}
@@ -0,0 +1,213 @@
+#include "../include/cpu_topology.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef _WIN32_WINNT
+        #define _WIN32_WINNT 0x0601
+    #endif
+    #include <windows.h>
+#elif defined(__linux__)
+    #include <sched.h>
+#endif
+
+// What bind_current_thread() last bound this thread to
+static thread_local const CPUTopology* g_bound_topology = nullptr;
+static thread_local int g_bound_node = -1;
+
+CPUTopology::CPUTopology(std::vector<std::vector<unsigned>> nodes)
+    : nodes_(std::move(nodes)) {
+    if (nodes_.empty()) {
+        nodes_.emplace_back(1, 0);
+    }
+}
+
+std::vector<unsigned> CPUTopology::parse_cpu_list(const std::string& list) {
+    std::vector<unsigned> cpus;
+    size_t at = 0;
+    while (at < list.size()) {
+        size_t end = list.find(',', at);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        const std::string range = list.substr(at, end - at);
+        const size_t dash = range.find('-');
+        char* stop = nullptr;
+        const unsigned long first = std::strtoul(range.c_str(), &stop, 10);
+        if (stop != range.c_str()) {
+            const unsigned long last = dash == std::string::npos ? first : std::strtoul(range.c_str() + dash + 1, nullptr, 10);
+            for (unsigned long cpu = first; cpu <= last && cpu - first < 65536; ++cpu) {
+                cpus.push_back(static_cast<unsigned>(cpu));
+            }
+        }
+        at = end + 1;
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+#if defined(__linux__)
+static std::vector<std::vector<unsigned>> discover_nodes() {
+    namespace fs = std::filesystem;
+
+    std::vector<unsigned> allowed;
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+        if (line.compare(0, 18, "Cpus_allowed_list:") == 0) {
+            allowed = CPUTopology::parse_cpu_list(line.substr(line.find_first_not_of(" \t", 18)));
+        }
+    }
+
+    // node<N> directories, in node order; nodes without usable CPUs are left out
+    std::vector<std::pair<unsigned long, std::vector<unsigned>>> found;
+    std::error_code error;
+    for (const fs::directory_entry& entry : fs::directory_iterator("/sys/devices/system/node", error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() < 5 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) {
+            continue;
+        }
+        std::ifstream cpulist(entry.path() / "cpulist");
+        std::string list;
+        std::getline(cpulist, list);
+        std::vector<unsigned> cpus = CPUTopology::parse_cpu_list(list);
+        if (!allowed.empty()) {
+            std::vector<unsigned> usable;
+            std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(), std::back_inserter(usable));
+            cpus.swap(usable);
+        }
+        if (!cpus.empty()) {
+            found.emplace_back(std::strtoul(name.c_str() + 4, nullptr, 10), std::move(cpus));
+        }
+    }
+    std::sort(found.begin(), found.end());
+
+    std::vector<std::vector<unsigned>> nodes;
+    for (auto& node : found) {
+        nodes.push_back(std::move(node.second));
+    }
+    return nodes;
+}
+#elif defined(_WIN32)
+static std::vector<std::vector<unsigned>> discover_nodes() {
+    std::vector<std::vector<unsigned>> nodes;
+    ULONG highest = 0;
+    if (!GetNumaHighestNodeNumber(&highest)) {
+        return nodes;
+    }
+    for (ULONG node = 0; node <= highest; ++node) {
+        GROUP_AFFINITY affinity = {};
+        if (!GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)) {
+            continue;
+        }
+        std::vector<unsigned> cpus;
+        for (unsigned bit = 0; bit < 64; ++bit) {
+            if (affinity.Mask & (KAFFINITY(1) << bit)) {
+                cpus.push_back(affinity.Group * 64u + bit);
+            }
+        }
+        if (!cpus.empty()) {
+            nodes.push_back(std::move(cpus));
+        }
+    }
+    return nodes;
+}
+#else
+static std::vector<std::vector<unsigned>> discover_nodes() {
+    return {};
+}
+#endif
+
+const CPUTopology& CPUTopology::system() {
+    static const CPUTopology topology = []() {
+        std::vector<std::vector<unsigned>> nodes = discover_nodes();
+        if (nodes.empty()) {
+            nodes.emplace_back();
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                nodes.back().push_back(cpu);
+            }
+        }
+        return CPUTopology(std::move(nodes));
+    }();
+    return topology;
+}
+
+size_t CPUTopology::cpu_count() const {
+    size_t count = 0;
+    for (const std::vector<unsigned>& cpus : nodes_) {
+        count += cpus.size();
+    }
+    return count;
+}
+
+bool CPUTopology::bind_current_thread(size_t node) const {
+    if (node >= nodes_.size()) {
+        return false;
+    }
+    const std::vector<unsigned>& cpus = nodes_[node];
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0 || sched_setaffinity(0, sizeof(set), &set) != 0) {
+        return false;
+    }
+#elif defined(_WIN32)
+    // A node lies within one processor group
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(cpus.front() / 64);
+    for (unsigned cpu : cpus) {
+        if (cpu / 64 == affinity.Group) {
+            affinity.Mask |= KAFFINITY(1) << (cpu % 64);
+        }
+    }
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr)) {
+        return false;
+    }
+#else
+    (void)cpus;
+#endif
+    g_bound_topology = this;
+    g_bound_node = static_cast<int>(node);
+    return true;
+}
+
+int CPUTopology::current_thread_node() const {
+    if (g_bound_topology == this) {
+        return g_bound_node;
+    }
+    if (nodes_.size() == 1) {
+        return 0;
+    }
+#if defined(__linux__)
+    // Threads started by a bound thread inherit its CPU set
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return -1;
+    }
+    int found = -1;
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        size_t inside = 0;
+        for (unsigned cpu : nodes_[node]) {
+            inside += cpu < CPU_SETSIZE && CPU_ISSET(cpu, &set);
+        }
+        if (inside == static_cast<size_t>(CPU_COUNT(&set))) {
+            if (found >= 0) {
+                return -1;  // Nodes sharing CPUs: not telling them apart
+            }
+            found = static_cast<int>(node);
+        }
+    }
+    return found;
+#endif
+    return -1;
+}
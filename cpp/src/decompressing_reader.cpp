@@ -0,0 +1,370 @@
+#include "../include/decompressing_reader.h"
+#include "../include/ordered_chunks.h"
+#include <zlib.h>
+#ifdef HAVE_BZLIB
+#include <bzlib.h>
+#endif
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+// Decompressed block size and number of blocks buffered ahead of the decoder
+static const size_t BLOCK_SIZE = 1 << 20;
+static const size_t RING_BLOCKS = 8;
+
+// Compressed bytes per parallel task (BGZF members are only ~64 KB each)
+static const size_t TASK_BYTES = 1 << 20;
+
+// zlib/bzip2 take 32-bit input lengths
+static const size_t MAX_INPUT_STEP = 1u << 30;
+
+STDFCompression detect_compression(const std::string& filepath) {
+    std::ifstream in(filepath, std::ios::binary);
+    unsigned char magic[3] = {0, 0, 0};
+    if (!in.read(reinterpret_cast<char*>(magic), sizeof(magic))) {
+        return STDFCompression::NONE;
+    }
+
+    if (magic[0] == 0x1f && magic[1] == 0x8b) return STDFCompression::GZIP;
+    if (magic[0] == 0x1f && magic[1] == 0x9d) return STDFCompression::LZW;
+    if (magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h') return STDFCompression::BZIP2;
+    return STDFCompression::NONE;
+}
+
+DecompressingReader::DecompressingReader()
+    : compression_(STDFCompression::NONE)
+    , threads_(1)
+    , finished_(false)
+    , cancelled_(false) {
+}
+
+DecompressingReader::~DecompressingReader() {
+    close();
+}
+
+bool DecompressingReader::open(const std::string& filepath, size_t threads) {
+    close();
+    last_error_.clear();
+
+    compression_ = detect_compression(filepath);
+    if (compression_ == STDFCompression::NONE || compression_ == STDFCompression::LZW) {
+        last_error_ = "Not a gzip/bzip2 file: " + filepath;
+        return false;
+    }
+#ifndef HAVE_BZLIB
+    if (compression_ == STDFCompression::BZIP2) {
+        last_error_ = "Built without bzip2 support: " + filepath;
+        return false;
+    }
+#endif
+
+    if (!file_.open(filepath)) {
+        last_error_ = file_.get_last_error();
+        return false;
+    }
+
+    threads_ = threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+    find_members();
+
+    finished_ = false;
+    cancelled_ = false;
+    if (is_parallel()) {
+        producer_ = std::thread(&DecompressingReader::produce_parallel, this);
+    } else {
+        producer_ = std::thread(&DecompressingReader::produce_sequential, this);
+    }
+    return true;
+}
+
+void DecompressingReader::close() {
+    cancelled_ = true;
+    not_full_.notify_all();
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+
+    ready_.clear();
+    free_.clear();
+    members_.clear();
+    file_.close();
+}
+
+void DecompressingReader::find_members() {
+    members_.clear();
+    const uint8_t* data = file_.data();
+    const size_t size = file_.size();
+
+    if (compression_ == STDFCompression::GZIP) {
+        // BGZF: every member carries its own size in a "BC" extra subfield
+        size_t position = 0;
+        while (position + 18 <= size) {
+            const uint8_t* h = data + position;
+            bool bgzf = h[0] == 0x1f && h[1] == 0x8b && h[2] == 8 && (h[3] & 4) &&
+                        h[12] == 'B' && h[13] == 'C' && h[14] == 2 && h[15] == 0;
+            if (!bgzf) break;
+
+            size_t length = static_cast<size_t>(h[16] | (h[17] << 8)) + 1;
+            if (position + length > size) break;
+            members_.push_back({position, length});
+            position += length;
+        }
+        if (position != size) {
+            members_.clear();
+        }
+    }
+#ifdef HAVE_BZLIB
+    else if (compression_ == STDFCompression::BZIP2) {
+        // Concatenated streams: "BZh[1-9]" followed by a block or end-of-stream
+        // magic. Blocks inside one stream are bit-aligned, so byte-aligned
+        // matches only occur at stream starts.
+        static const uint8_t block_magic[6] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+        static const uint8_t eos_magic[6] = {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+        size_t start = 0;
+        for (size_t i = 1; i + 10 <= size; ++i) {
+            const uint8_t* p = data + i;
+            if (p[0] != 'B' || p[1] != 'Z' || p[2] != 'h' || p[3] < '1' || p[3] > '9') continue;
+            if (std::memcmp(p + 4, block_magic, 6) != 0 && std::memcmp(p + 4, eos_magic, 6) != 0) continue;
+            members_.push_back({start, i - start});
+            start = i;
+        }
+        if (!members_.empty()) {
+            members_.push_back({start, size - start});
+        }
+    }
+#endif
+
+    if (members_.empty()) {
+        members_.push_back({0, size});
+    }
+}
+
+void DecompressingReader::fail(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (last_error_.empty()) last_error_ = error;
+        finished_ = true;
+    }
+    not_empty_.notify_all();
+}
+
+void DecompressingReader::take_free_block(std::vector<uint8_t>& block) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+            block.swap(free_.back());
+            free_.pop_back();
+        }
+    }
+    block.clear();
+}
+
+bool DecompressingReader::push_block(std::vector<uint8_t>& block) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return ready_.size() < RING_BLOCKS || cancelled_; });
+        if (cancelled_) return false;
+        ready_.push_back(std::move(block));
+    }
+    not_empty_.notify_one();
+    block = std::vector<uint8_t>();
+    return true;
+}
+
+bool DecompressingReader::next_block(std::vector<uint8_t>& block) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !ready_.empty() || finished_; });
+        if (ready_.empty()) {
+            return false;
+        }
+
+        if (block.capacity() > 0 && free_.size() < RING_BLOCKS) {
+            free_.push_back(std::move(block));
+        }
+        block = std::move(ready_.front());
+        ready_.pop_front();
+    }
+    not_full_.notify_one();
+    return true;
+}
+
+bool DecompressingReader::inflate_range(size_t offset, size_t length, std::vector<uint8_t>& out,
+                                        bool emit_blocks) {
+    const uint8_t* input = file_.data() + offset;
+    size_t remaining = length;
+
+    // Grow `out` for the next write; in streaming mode full blocks go to the ring
+    auto reserve_output = [&]() -> bool {
+        if (emit_blocks && out.size() >= BLOCK_SIZE) {
+            if (!push_block(out)) return false;
+            take_free_block(out);
+        }
+        if (out.capacity() - out.size() < 64 * 1024) {
+            out.reserve(std::max(out.capacity() * 2, BLOCK_SIZE + 64 * 1024));
+        }
+        return true;
+    };
+
+    if (compression_ == STDFCompression::GZIP) {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+            fail("inflateInit2 failed");
+            return false;
+        }
+
+        int status = Z_OK;
+        while (!cancelled_) {
+            if (zs.avail_in == 0 && remaining > 0) {
+                size_t step = std::min(remaining, MAX_INPUT_STEP);
+                zs.next_in = const_cast<Bytef*>(input);
+                zs.avail_in = static_cast<uInt>(step);
+                input += step;
+                remaining -= step;
+            }
+            if (!reserve_output()) break;
+
+            size_t used = out.size();
+            size_t capacity = out.capacity() - used;
+            out.resize(out.capacity());
+            zs.next_out = out.data() + used;
+            zs.avail_out = static_cast<uInt>(capacity);
+            status = inflate(&zs, Z_NO_FLUSH);
+            out.resize(used + (capacity - zs.avail_out));
+
+            if (status == Z_STREAM_END) {
+                // Concatenated members: continue if another gzip header follows
+                if (zs.avail_in == 0 && remaining == 0) break;
+                if (zs.avail_in >= 2 && zs.next_in[0] == 0x1f && zs.next_in[1] == 0x8b) {
+                    inflateReset(&zs);
+                    continue;
+                }
+                break;  // Trailing padding
+            }
+            if (status != Z_OK && status != Z_BUF_ERROR) {
+                inflateEnd(&zs);
+                fail(std::string("gzip data error: ") + (zs.msg ? zs.msg : "inflate failed"));
+                return false;
+            }
+            if (status == Z_BUF_ERROR && zs.avail_in == 0 && remaining == 0) {
+                inflateEnd(&zs);
+                fail("Truncated gzip stream");
+                return false;
+            }
+        }
+        inflateEnd(&zs);
+    }
+#ifdef HAVE_BZLIB
+    else if (compression_ == STDFCompression::BZIP2) {
+        bz_stream bs;
+        std::memset(&bs, 0, sizeof(bs));
+        if (BZ2_bzDecompressInit(&bs, 0, 0) != BZ_OK) {
+            fail("BZ2_bzDecompressInit failed");
+            return false;
+        }
+
+        while (!cancelled_) {
+            if (bs.avail_in == 0 && remaining > 0) {
+                size_t step = std::min(remaining, MAX_INPUT_STEP);
+                bs.next_in = reinterpret_cast<char*>(const_cast<uint8_t*>(input));
+                bs.avail_in = static_cast<unsigned int>(step);
+                input += step;
+                remaining -= step;
+            }
+            if (!reserve_output()) break;
+
+            size_t used = out.size();
+            size_t capacity = out.capacity() - used;
+            out.resize(out.capacity());
+            bs.next_out = reinterpret_cast<char*>(out.data() + used);
+            bs.avail_out = static_cast<unsigned int>(capacity);
+            int status = BZ2_bzDecompress(&bs);
+            out.resize(used + (capacity - bs.avail_out));
+
+            if (status == BZ_STREAM_END) {
+                if (bs.avail_in == 0 && remaining == 0) break;
+                if (bs.avail_in >= 3 && std::memcmp(bs.next_in, "BZh", 3) == 0) {
+                    BZ2_bzDecompressEnd(&bs);
+                    char* next_in = bs.next_in;
+                    unsigned int avail_in = bs.avail_in;
+                    std::memset(&bs, 0, sizeof(bs));
+                    BZ2_bzDecompressInit(&bs, 0, 0);
+                    bs.next_in = next_in;
+                    bs.avail_in = avail_in;
+                    continue;
+                }
+                break;
+            }
+            if (status != BZ_OK) {
+                BZ2_bzDecompressEnd(&bs);
+                fail("bzip2 data error (" + std::to_string(status) + ")");
+                return false;
+            }
+            if (bs.avail_in == 0 && remaining == 0 && bs.avail_out != 0) {
+                BZ2_bzDecompressEnd(&bs);
+                fail("Truncated bzip2 stream");
+                return false;
+            }
+        }
+        BZ2_bzDecompressEnd(&bs);
+    }
+#endif
+
+    return !cancelled_;
+}
+
+void DecompressingReader::produce_sequential() {
+    std::vector<uint8_t> block;
+    take_free_block(block);
+
+    if (inflate_range(0, file_.size(), block, true) && !block.empty()) {
+        push_block(block);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    not_empty_.notify_all();
+}
+
+void DecompressingReader::produce_parallel() {
+    // Group small members so each task amortizes the hand-off
+    std::vector<std::pair<size_t, size_t>> tasks;  // [first member, last member)
+    size_t first = 0;
+    size_t task_bytes = 0;
+    for (size_t i = 0; i < members_.size(); ++i) {
+        task_bytes += members_[i].length;
+        if (task_bytes >= TASK_BYTES || i + 1 == members_.size()) {
+            tasks.emplace_back(first, i + 1);
+            first = i + 1;
+            task_bytes = 0;
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> outputs(tasks.size());
+    std::atomic<bool> ok(true);
+
+    run_chunks_in_order(tasks.size(), threads_,
+        [&](size_t id) {
+            if (!ok || cancelled_) return;
+            for (size_t m = tasks[id].first; m < tasks[id].second; ++m) {
+                if (!inflate_range(members_[m].offset, members_[m].length, outputs[id], false)) {
+                    ok = false;
+                    return;
+                }
+            }
+        },
+        [&](size_t id) {
+            if (ok && !cancelled_ && !outputs[id].empty() && !push_block(outputs[id])) {
+                ok = false;
+            }
+            std::vector<uint8_t>().swap(outputs[id]);
+        });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+    }
+    not_empty_.notify_all();
+}
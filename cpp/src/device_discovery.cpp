@@ -0,0 +1,133 @@
+#include "../include/device_discovery.h"
+#include "../include/stdf_record_view.h"
+#include "../include/pixel_name.h"
+#include "../include/work_stealing_pool.h"
+#include "../include/file_schedule.h"
+#include <unordered_set>
+#include <functional>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+std::vector<std::string> sorted(std::unordered_set<std::string>& names) {
+    std::vector<std::string> result;
+    result.reserve(names.size());
+    for (auto it = names.begin(); it != names.end();) {
+        auto node = names.extract(it++);
+        result.push_back(std::move(node.value()));
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace
+
+DeviceDiscovery::DeviceDiscovery()
+    : num_threads_(1)
+    , parser_backend_(STDFParserBackend::MMAP)
+    , enable_pixel_filtering_(true)
+    , discovery_time_(0.0) {
+}
+
+void DeviceDiscovery::set_num_threads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads_ = threads;
+}
+
+bool DeviceDiscovery::discover_files(const std::vector<std::string>& paths) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    file_stats_.assign(paths.size(), FileDiscovery());
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        file_stats_[i].path = paths[i];
+        tasks.emplace_back([this, i]() { discover_file(file_stats_[i]); });
+    }
+    WorkStealingPool pool(std::min(num_threads_, std::max<size_t>(1, tasks.size())));
+    pool.run(tasks, estimate_file_costs(paths));
+
+    bool all_succeeded = true;
+    std::unordered_set<std::string> devices;
+    std::unordered_set<std::string> parameters;
+    for (const FileDiscovery& file : file_stats_) {
+        all_succeeded = all_succeeded && file.success;
+        devices.insert(file.devices.begin(), file.devices.end());
+        parameters.insert(file.parameters.begin(), file.parameters.end());
+    }
+    devices_ = sorted(devices);
+    parameters_ = sorted(parameters);
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    discovery_time_ = std::chrono::duration<double>(end_time - start_time).count();
+    return all_succeeded;
+}
+
+void DeviceDiscovery::discover_file(FileDiscovery& file) const {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    STDFParser parser;
+    parser.set_backend(parser_backend_);
+    parser.set_enabled_record_types({STDFRecordType::PTR, STDFRecordType::MPR, STDFRecordType::PRR});
+
+    std::unordered_set<std::string> devices;
+    std::unordered_set<std::string> parameters;
+    std::unordered_set<std::string> seen_names;  // ALARM_ID '\0' TEST_TXT
+    std::string key;
+    PixelName pixel_name;
+    bool has_kept_tests = false;
+
+    // Every row's name is read, not only the first per test: a later row can
+    // rename its test (see TestDefinitionCache) and reading the two strings
+    // costs no more than looking the test up. Rows without a name inherit
+    // one already seen.
+    file.success = parser.stream_views(file.path, [&](STDFRecordView& view) {
+        if (view.type() == STDFRecordType::PRR) {
+            std::string_view part_id = view.get_string("PART_ID");
+            if (!part_id.empty()) {
+                devices.emplace(part_id);
+            }
+            return;
+        }
+
+        std::string_view text = view.get_string("TEST_TXT");
+        std::string_view alarm = view.get_string("ALARM_ID");
+        if (text.empty() && alarm.empty()) {
+            has_kept_tests = has_kept_tests || !enable_pixel_filtering_;
+            return;
+        }
+
+        key.assign(alarm.data(), alarm.size());
+        key.push_back('\0');
+        key.append(text.data(), text.size());
+        if (seen_names.find(key) != seen_names.end()) {
+            return;
+        }
+        seen_names.insert(key);
+
+        if (enable_pixel_filtering_ && !test_filter_.matches(alarm) && !test_filter_.matches(text)) {
+            return;
+        }
+        has_kept_tests = true;
+        parse_pixel_name(alarm.empty() ? text : alarm, pixel_name);
+        if (!pixel_name.cleaned.empty()) {
+            parameters.insert(pixel_name.cleaned);
+        }
+    });
+
+    if (!file.success) {
+        file.error = "Failed to read STDF file";
+    }
+    // Processing assigns no device IDs in a file without kept tests
+    if (has_kept_tests) {
+        file.devices = sorted(devices);
+    }
+    file.parameters = sorted(parameters);
+    file.total_records = parser.get_total_records();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    file.discovery_time = std::chrono::duration<double>(end_time - start_time).count();
+}
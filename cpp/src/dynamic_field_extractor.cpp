@@ -1,30 +1,63 @@
 #include "../include/dynamic_field_extractor.h"
+#include "../include/console_log.h"
+#include "../include/stdf_record_view.h"
 #include <libstdf.h>
 #include <iostream>
+#include <atomic>
 #include <sstream>
+#include <charconv>
+#include <cctype>
+
+static_assert(stdf_fields::PTR_FIELD_COUNT <= 64, "ptr_fields.def exceeds FieldMask width");
+static_assert(stdf_fields::MPR_FIELD_COUNT <= 64, "mpr_fields.def exceeds FieldMask width");
+static_assert(stdf_fields::FTR_FIELD_COUNT <= 64, "ftr_fields.def exceeds FieldMask width");
+static_assert(stdf_fields::HBR_FIELD_COUNT <= 64, "hbr_fields.def exceeds FieldMask width");
+static_assert(stdf_fields::SBR_FIELD_COUNT <= 64, "sbr_fields.def exceeds FieldMask width");
+static_assert(stdf_fields::PRR_FIELD_COUNT <= 64, "prr_fields.def exceeds FieldMask width");
 
 DynamicFieldExtractor::DynamicFieldExtractor(const std::string& config_file) 
-    : config_file_path_(config_file) {
-    
-    // NO CONFIG FILES - Extract ALL fields from .def files automatically
-    std::cout << "🚀 DynamicFieldExtractor: Extracting ALL fields from .def files (no config filtering)" << std::endl;
+    : config_file_path_(config_file)
+    , ptr_mask_(0)
+    , mpr_mask_(0)
+    , ftr_mask_(0)
+    , hbr_mask_(0)
+    , sbr_mask_(0)
+    , prr_mask_(0) {
+    
+    enable_all_fields();
+    if (config_file.empty()) {
+        return;  // Every field; callers narrow it (set_field_config)
+    }
     
-    // Enable ALL fields from each .def file
-    enabled_fields_["PTR"] = get_all_available_fields("PTR");
-    enabled_fields_["MPR"] = get_all_available_fields("MPR");
-    enabled_fields_["FTR"] = get_all_available_fields("FTR");
-    enabled_fields_["HBR"] = get_all_available_fields("HBR");
-    enabled_fields_["SBR"] = get_all_available_fields("SBR");
-    enabled_fields_["PRR"] = get_all_available_fields("PRR");
+    // An explicit configuration file narrows the selection. One that cannot
+    // be used is an error, and every .def field stays extracted.
+    if (load_configuration(config_file)) {
+        ConsoleLog::out() << "🚀 DynamicFieldExtractor: Extracting configured fields from " << config_file << std::endl;
+    } else {
+        ConsoleLog::err() << "❌ DynamicFieldExtractor: Ignoring " << config_file << ", extracting ALL fields" << std::endl;
+    }
     
     print_configuration_summary();
 }
 
+DynamicFieldExtractor& get_shared_field_extractor() {
+    static DynamicFieldExtractor extractor("");
+    return extractor;
+}
+
+bool DynamicFieldExtractor::reload_configuration() {
+    return load_configuration(config_file_path_);
+}
+
+bool DynamicFieldExtractor::set_config_from_json(const std::string& json_content) {
+    return parse_json_config(json_content);
+}
+
 bool DynamicFieldExtractor::load_configuration(const std::string& config_file) {
     try {
         std::ifstream file(config_file);
         if (!file.is_open()) {
-            std::cout << "Config file not found: " << config_file << std::endl;
+            ConsoleLog::err() << "ERROR: config file not found: " << config_file << std::endl;
             return false;
         }
         
@@ -36,74 +69,262 @@ bool DynamicFieldExtractor::load_configuration(const std::string& config_file) {
         return parse_json_config(json_content);
         
     } catch (const std::exception& e) {
-        std::cout << "ERROR loading config: " << e.what() << std::endl;
+        ConsoleLog::err() << "ERROR loading config: " << e.what() << std::endl;
         return false;
     }
 }
 
-bool DynamicFieldExtractor::parse_json_config(const std::string& json_content) {
-    // Simplified JSON parsing - in production use a proper JSON library
-    // For now, parse basic patterns manually
+namespace {
+
+// Just enough JSON for the field configuration: an object of record types,
+// each a list of field names or an object with a "fields" list and an
+// optional "enabled" flag. The record types may be nested in a
+// "field_extraction_rules" member, as in python/stdf_field_config.json.
+// Disabled types are left out; other members and values are skipped.
+class ConfigJsonReader {
+public:
+    explicit ConfigJsonReader(const std::string& text) : text_(text), pos_(0) {}
+    
+    bool read(std::map<std::string, std::set<std::string>>& fields) {
+        return read_record_types(fields) && at_end();
+    }
     
-    std::istringstream iss(json_content);
-    std::string line;
-    std::string current_record_type;
+private:
+    bool read_record_types(std::map<std::string, std::set<std::string>>& fields) {
+        if (!consume('{')) return false;
+        if (consume('}')) return true;
+        do {
+            std::string record_type;
+            if (!read_string(record_type) || !consume(':')) return false;
+            skip_space();
+            if (record_type == "field_extraction_rules" && peek() == '{') {
+                if (!read_record_types(fields)) return false;
+            } else if (peek() == '[') {
+                if (!read_string_list(fields[record_type])) return false;
+            } else if (consume('{')) {
+                if (!read_record_object(fields, record_type)) return false;
+            } else if (!skip_value()) {
+                return false;
+            }
+        } while (consume(','));
+        return consume('}');
+    }
     
-    enabled_fields_.clear();
+    char peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
     
-    while (std::getline(iss, line)) {
-        line = trim(line);
-        
-        // Look for record type definitions like "PTR": {
-        if (line.find("\":") != std::string::npos && line.find("{") != std::string::npos) {
-            size_t quote_start = line.find('"');
-            size_t quote_end = line.find('"', quote_start + 1);
-            if (quote_start != std::string::npos && quote_end != std::string::npos) {
-                current_record_type = line.substr(quote_start + 1, quote_end - quote_start - 1);
-            }
+    void skip_space() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) pos_++;
+    }
+    
+    bool consume(char c) {
+        skip_space();
+        if (peek() != c) return false;
+        pos_++;
+        return true;
+    }
+    
+    bool at_end() {
+        skip_space();
+        return pos_ == text_.size();
+    }
+    
+    bool read_string(std::string& out) {
+        if (!consume('"')) return false;
+        out.clear();
+        while (pos_ < text_.size() && text_[pos_] != '"') {
+            if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) pos_++;
+            out.push_back(text_[pos_++]);
         }
-        
-        // Look for fields arrays like "fields": ["TEST_NUM", "TEST_FLG"]
-        if (line.find("\"fields\":") != std::string::npos && !current_record_type.empty()) {
-            size_t bracket_start = line.find('[');
-            size_t bracket_end = line.rfind(']');
-            
-            if (bracket_start != std::string::npos && bracket_end != std::string::npos) {
-                std::string fields_str = line.substr(bracket_start + 1, bracket_end - bracket_start - 1);
-                
-                // Parse individual field names
-                std::set<std::string> fields;
-                std::istringstream field_stream(fields_str);
-                std::string field;
-                
-                while (std::getline(field_stream, field, ',')) {
-                    field = trim(field);
-                    if (field.front() == '"') field = field.substr(1);
-                    if (field.back() == '"') field = field.substr(0, field.length() - 1);
-                    field = trim(field);
-                    
-                    if (!field.empty()) {
-                        fields.insert(field);
-                    }
-                }
-                
-                if (!fields.empty()) {
-                    enabled_fields_[current_record_type] = fields;
-                    std::cout << "Loaded " << fields.size() << " fields for " << current_record_type << std::endl;
+        return consume('"');
+    }
+    
+    bool read_string_list(std::set<std::string>& out) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            std::string field;
+            if (!read_string(field)) return false;
+            out.insert(field);
+        } while (consume(','));
+        return consume(']');
+    }
+    
+    bool read_record_object(std::map<std::string, std::set<std::string>>& fields, const std::string& record_type) {
+        // Objects without a "fields" list (global_settings, ...) select nothing
+        std::set<std::string> names;
+        bool listed = false;
+        bool enabled = true;
+        if (!consume('}')) {
+            do {
+                std::string key;
+                if (!read_string(key) || !consume(':')) return false;
+                if (key == "fields") {
+                    if (!read_string_list(names)) return false;
+                    listed = true;
+                } else if (key == "enabled") {
+                    if (!read_bool(enabled)) return false;
+                } else if (!skip_value()) {
+                    return false;
                 }
+            } while (consume(','));
+            if (!consume('}')) return false;
+        }
+        if (listed && enabled) {
+            fields[record_type] = std::move(names);
+        }
+        return true;
+    }
+    
+    bool read_bool(bool& out) {
+        skip_space();
+        for (const char* literal : {"true", "false"}) {
+            const size_t length = std::char_traits<char>::length(literal);
+            if (text_.compare(pos_, length, literal) == 0) {
+                out = literal[0] == 't';
+                pos_ += length;
+                return true;
             }
         }
+        return false;
+    }
+    
+    bool skip_value() {
+        skip_space();
+        char c = peek();
+        if (c == '"') {
+            std::string ignored;
+            return read_string(ignored);
+        }
+        if (c == '[' || c == '{') {
+            char close = (c == '[') ? ']' : '}';
+            pos_++;
+            if (consume(close)) return true;
+            do {
+                if (c == '{') {
+                    std::string key;
+                    if (!read_string(key) || !consume(':')) return false;
+                }
+                if (!skip_value()) return false;
+            } while (consume(','));
+            return consume(close);
+        }
+        size_t start = pos_;
+        while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) ||
+                                       text_[pos_] == '-' || text_[pos_] == '+' || text_[pos_] == '.')) {
+            pos_++;
+        }
+        return pos_ > start;  // Number, true, false, null
+    }
+    
+    const std::string& text_;
+    size_t pos_;
+};
+
+}  // namespace
+
+bool DynamicFieldExtractor::parse_json_config(const std::string& json_content) {
+    std::map<std::string, std::set<std::string>> fields;
+    if (!ConfigJsonReader(json_content).read(fields)) {
+        ConsoleLog::err() << "ERROR: malformed field configuration JSON" << std::endl;
+        return false;
+    }
+    
+    for (const auto& record_config : fields) {
+        ConsoleLog::out() << "Loaded " << record_config.second.size() << " fields for " << record_config.first << std::endl;
+    }
+    return set_enabled_fields(fields);
+}
+
+bool DynamicFieldExtractor::set_enabled_fields(const std::map<std::string, std::set<std::string>>& fields) {
+    // An empty field list stands for all of the type's fields
+    std::map<std::string, std::set<std::string>> selection;
+    bool selects_any = false;
+    for (const auto& record_config : fields) {
+        const std::set<std::string> available = get_all_available_fields(record_config.first);
+        std::set<std::string>& names = selection[record_config.first];
+        names = record_config.second.empty() ? available : record_config.second;
+        for (const std::string& name : names) {
+            selects_any = selects_any || available.count(name);
+        }
+    }
+    if (!selects_any) {
+        ConsoleLog::err() << "ERROR: field configuration selects no known fields" << std::endl;
+        return false;
     }
     
-    return !enabled_fields_.empty();
+    enabled_fields_ = std::move(selection);
+    rebuild_projection();
+    validate_configuration();
+    return true;
+}
+
+void DynamicFieldExtractor::enable_all_fields() {
+    enabled_fields_.clear();
+    for (const char* record_type : {"PTR", "MPR", "FTR", "HBR", "SBR", "PRR"}) {
+        enabled_fields_[record_type] = get_all_available_fields(record_type);
+    }
+    rebuild_projection();
 }
 
-std::string DynamicFieldExtractor::trim(const std::string& str) const {
-    size_t start = str.find_first_not_of(" \\t\\n\\r");
-    if (start == std::string::npos) return "";
+void DynamicFieldExtractor::rebuild_projection() {
+    // X-Macros: set the bit of every enabled FIELD line
+    const std::set<std::string> ptr_enabled = get_enabled_fields("PTR");
+    ptr_mask_ = 0;
+    #define FIELD(name, member) if (ptr_enabled.count(name)) ptr_mask_ |= field_bit(stdf_fields::PTR_##member);
+    #include "../field_defs/ptr_fields.def"
+    #undef FIELD
+    
+    const std::set<std::string> mpr_enabled = get_enabled_fields("MPR");
+    mpr_mask_ = 0;
+    #define FIELD(name, member) if (mpr_enabled.count(name)) mpr_mask_ |= field_bit(stdf_fields::MPR_##member);
+    #include "../field_defs/mpr_fields.def"
+    #undef FIELD
+    
+    const std::set<std::string> ftr_enabled = get_enabled_fields("FTR");
+    ftr_mask_ = 0;
+    #define FIELD(name, member) if (ftr_enabled.count(name)) ftr_mask_ |= field_bit(stdf_fields::FTR_##member);
+    #include "../field_defs/ftr_fields.def"
+    #undef FIELD
+    
+    const std::set<std::string> hbr_enabled = get_enabled_fields("HBR");
+    hbr_mask_ = 0;
+    #define FIELD(name, member) if (hbr_enabled.count(name)) hbr_mask_ |= field_bit(stdf_fields::HBR_##member);
+    #include "../field_defs/hbr_fields.def"
+    #undef FIELD
     
-    size_t end = str.find_last_not_of(" \\t\\n\\r");
-    return str.substr(start, end - start + 1);
+    const std::set<std::string> sbr_enabled = get_enabled_fields("SBR");
+    sbr_mask_ = 0;
+    #define FIELD(name, member) if (sbr_enabled.count(name)) sbr_mask_ |= field_bit(stdf_fields::SBR_##member);
+    #include "../field_defs/sbr_fields.def"
+    #undef FIELD
+    
+    const std::set<std::string> prr_enabled = get_enabled_fields("PRR");
+    prr_mask_ = 0;
+    #define FIELD(name, member) if (prr_enabled.count(name)) prr_mask_ |= field_bit(stdf_fields::PRR_##member);
+    #include "../field_defs/prr_fields.def"
+    #undef FIELD
+}
+
+bool DynamicFieldExtractor::is_projected(STDFRecordType type) const {
+    switch (type) {
+        case STDFRecordType::PTR: return ptr_mask_ != field_bit(stdf_fields::PTR_FIELD_COUNT) - 1;
+        case STDFRecordType::MPR: return mpr_mask_ != field_bit(stdf_fields::MPR_FIELD_COUNT) - 1;
+        case STDFRecordType::FTR: return ftr_mask_ != field_bit(stdf_fields::FTR_FIELD_COUNT) - 1;
+        case STDFRecordType::HBR: return hbr_mask_ != field_bit(stdf_fields::HBR_FIELD_COUNT) - 1;
+        case STDFRecordType::SBR: return sbr_mask_ != field_bit(stdf_fields::SBR_FIELD_COUNT) - 1;
+        case STDFRecordType::PRR: return prr_mask_ != field_bit(stdf_fields::PRR_FIELD_COUNT) - 1;
+        default: return false;  // MIR keeps its own fixed selection
+    }
+}
+
+FieldMask DynamicFieldExtractor::get_projection_mask(const std::string& record_type) const {
+    if (record_type == "PTR") return ptr_mask_;
+    if (record_type == "MPR") return mpr_mask_;
+    if (record_type == "FTR") return ftr_mask_;
+    if (record_type == "HBR") return hbr_mask_;
+    if (record_type == "SBR") return sbr_mask_;
+    if (record_type == "PRR") return prr_mask_;
+    return 0;
 }
 
 std::set<std::string> DynamicFieldExtractor::get_enabled_record_types() const {
@@ -171,7 +392,7 @@ bool DynamicFieldExtractor::validate_configuration() const {
         std::set<std::string> available_fields = get_all_available_fields(record_type);
         
         if (available_fields.empty()) {
-            std::cout << "WARNING: Unknown record type: " << record_type << std::endl;
+            ConsoleLog::out() << "WARNING: Unknown record type: " << record_type << std::endl;
             valid = false;
             continue;
         }
@@ -179,7 +400,7 @@ bool DynamicFieldExtractor::validate_configuration() const {
         // Check if all enabled fields are valid
         for (const std::string& field : enabled_fields) {
             if (available_fields.find(field) == available_fields.end()) {
-                std::cout << "WARNING: Invalid field '" << field << "' for record type " << record_type << std::endl;
+                ConsoleLog::out() << "WARNING: Invalid field '" << field << "' for record type " << record_type << std::endl;
                 valid = false;
             }
         }
@@ -189,16 +410,16 @@ bool DynamicFieldExtractor::validate_configuration() const {
 }
 
 void DynamicFieldExtractor::print_configuration_summary() const {
-    std::cout << "\nDynamic Field Extractor Configuration:" << std::endl;
-    std::cout << "  Config file: " << config_file_path_ << std::endl;
-    std::cout << "  Enabled record types: " << enabled_fields_.size() << std::endl;
+    ConsoleLog::out() << "\nDynamic Field Extractor Configuration:" << std::endl;
+    ConsoleLog::out() << "  Config file: " << config_file_path_ << std::endl;
+    ConsoleLog::out() << "  Enabled record types: " << enabled_fields_.size() << std::endl;
     
     for (const auto& record_config : enabled_fields_) {
         const std::string& record_type = record_config.first;
         const std::set<std::string>& fields = record_config.second;
         std::set<std::string> available = get_all_available_fields(record_type);
         
-        std::cout << "    " << record_type << ": " << fields.size() << "/" << available.size() << " fields enabled" << std::endl;
+        ConsoleLog::out() << "    " << record_type << ": " << fields.size() << "/" << available.size() << " fields enabled" << std::endl;
     }
 }
 
@@ -245,6 +466,20 @@ std::string field_to_string<float*>(float* const& value) {
     return "[float_array]";
 }
 
+// Comma-joined R4 array. Shortest round-trip form (std::to_chars), so the
+// text parses back to the exact float, unlike ostream's 6 digits.
+std::string join_r4_array(const float* values, uint16_t count) {
+    std::string joined;
+    joined.reserve(static_cast<size_t>(count) * 12);
+    char buffer[32];
+    for (uint16_t i = 0; i < count; ++i) {
+        if (i > 0) joined.push_back(',');
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), values[i]);
+        joined.append(buffer, result.ptr);
+    }
+    return joined;
+}
+
 // Specialization for unsigned char* (dtc_Bn - binary data)
 template<>
 std::string field_to_string<unsigned char*>(unsigned char* const& value) {
@@ -262,54 +497,43 @@ std::string field_to_string<const char*>(const char* const& value) {
 
 // PTR Record Extraction
 template<>
-void DynamicFieldExtractor::extract_fields<rec_ptr>(rec_ptr* ptr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_ptr>(rec_ptr* ptr, DynamicSTDFRecord& out_record) const {
     if (!ptr) return;
     
     out_record.type_name = "PTR";
-    const std::set<std::string>& enabled = get_enabled_fields("PTR");
+    const FieldMask mask = ptr_mask_;
     
-    if (enabled.empty()) {
+    if (!mask) {
         return;  // No fields enabled for PTR
     }
     
     // X-Macros magic: Generate field extraction code with unified type handling
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
+        if (mask & field_bit(stdf_fields::PTR_##member)) { \
             out_record.fields[name] = field_to_string(ptr->member); \
         }
     
     #include "../field_defs/ptr_fields.def"
     #undef FIELD
-    
-    static int debug_count = 0;
-    if (debug_count < 2) {
-        std::cout << "PTR X-Macros extraction completed - " << out_record.fields.size() << " fields extracted" << std::endl;
-        debug_count++;
-    }
 }
 
 // MPR Record Extraction
 template<>
-void DynamicFieldExtractor::extract_fields<rec_mpr>(rec_mpr* mpr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_mpr>(rec_mpr* mpr, DynamicSTDFRecord& out_record) const {
     if (!mpr) return;
     
     out_record.type_name = "MPR";
-    const std::set<std::string>& enabled = get_enabled_fields("MPR");
+    const FieldMask mask = mpr_mask_;
     
-    if (enabled.empty()) return;
+    if (!mask) return;
     
-    // X-Macros: Unified field extraction (but handle RTN_RSLT specially)
+    // X-Macros: Unified field extraction (RTN_RSLT resolved at compile time)
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
-            if (std::string(name) == "RTN_RSLT") { \
+        if (mask & field_bit(stdf_fields::MPR_##member)) { \
+            if constexpr (stdf_fields::MPR_##member == stdf_fields::MPR_RTN_RSLT) { \
                 /* Special handling for RTN_RSLT array with RSLT_CNT */ \
                 if (mpr->RTN_RSLT != nullptr && mpr->RSLT_CNT > 0) { \
-                    std::ostringstream oss; \
-                    for (int i = 0; i < mpr->RSLT_CNT; i++) { \
-                        if (i > 0) oss << ","; \
-                        oss << mpr->RTN_RSLT[i]; \
-                    } \
-                    out_record.fields[name] = oss.str(); \
+                    out_record.fields[name] = join_r4_array(mpr->RTN_RSLT, mpr->RSLT_CNT); \
                 } else { \
                     out_record.fields[name] = ""; \
                 } \
@@ -324,17 +548,17 @@ void DynamicFieldExtractor::extract_fields<rec_mpr>(rec_mpr* mpr, DynamicSTDFRec
 
 // FTR Record Extraction
 template<>
-void DynamicFieldExtractor::extract_fields<rec_ftr>(rec_ftr* ftr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_ftr>(rec_ftr* ftr, DynamicSTDFRecord& out_record) const {
     if (!ftr) return;
     
     out_record.type_name = "FTR";
-    const std::set<std::string>& enabled = get_enabled_fields("FTR");
+    const FieldMask mask = ftr_mask_;
     
-    if (enabled.empty()) return;
+    if (!mask) return;
     
     // X-Macros: Unified field extraction
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
+        if (mask & field_bit(stdf_fields::FTR_##member)) { \
             out_record.fields[name] = field_to_string(ftr->member); \
         }
     
@@ -344,17 +568,17 @@ void DynamicFieldExtractor::extract_fields<rec_ftr>(rec_ftr* ftr, DynamicSTDFRec
 
 // HBR Record Extraction
 template<>
-void DynamicFieldExtractor::extract_fields<rec_hbr>(rec_hbr* hbr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_hbr>(rec_hbr* hbr, DynamicSTDFRecord& out_record) const {
     if (!hbr) return;
     
     out_record.type_name = "HBR";
-    const std::set<std::string>& enabled = get_enabled_fields("HBR");
+    const FieldMask mask = hbr_mask_;
     
-    if (enabled.empty()) return;
+    if (!mask) return;
     
     // X-Macros: Unified field extraction
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
+        if (mask & field_bit(stdf_fields::HBR_##member)) { \
             out_record.fields[name] = field_to_string(hbr->member); \
         }
     
@@ -364,17 +588,17 @@ void DynamicFieldExtractor::extract_fields<rec_hbr>(rec_hbr* hbr, DynamicSTDFRec
 
 // SBR Record Extraction  
 template<>
-void DynamicFieldExtractor::extract_fields<rec_sbr>(rec_sbr* sbr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_sbr>(rec_sbr* sbr, DynamicSTDFRecord& out_record) const {
     if (!sbr) return;
     
     out_record.type_name = "SBR";
-    const std::set<std::string>& enabled = get_enabled_fields("SBR");
+    const FieldMask mask = sbr_mask_;
     
-    if (enabled.empty()) return;
+    if (!mask) return;
     
     // X-Macros: Unified field extraction
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
+        if (mask & field_bit(stdf_fields::SBR_##member)) { \
             out_record.fields[name] = field_to_string(sbr->member); \
         }
     
@@ -384,20 +608,79 @@ void DynamicFieldExtractor::extract_fields<rec_sbr>(rec_sbr* sbr, DynamicSTDFRec
 
 // PRR Record Extraction
 template<>
-void DynamicFieldExtractor::extract_fields<rec_prr>(rec_prr* prr, DynamicSTDFRecord& out_record) {
+void DynamicFieldExtractor::extract_fields<rec_prr>(rec_prr* prr, DynamicSTDFRecord& out_record) const {
     if (!prr) return;
     
     out_record.type_name = "PRR";
-    const std::set<std::string>& enabled = get_enabled_fields("PRR");
+    const FieldMask mask = prr_mask_;
     
-    if (enabled.empty()) return;
+    if (!mask) return;
     
     // X-Macros: Unified field extraction
     #define FIELD(name, member) \
-        if (enabled.count(name)) { \
+        if (mask & field_bit(stdf_fields::PRR_##member)) { \
             out_record.fields[name] = field_to_string(prr->member); \
         }
     
     #include "../field_defs/prr_fields.def"
     #undef FIELD
-}
\ No newline at end of file
+}
+
+// Projected extraction: the view decodes each selected field on access and
+// never touches the bytes past the last one
+void DynamicFieldExtractor::extract_fields(STDFRecordView& view, DynamicSTDFRecord& out_record) const {
+    #define FIELD(name, member) \
+        if (mask & field_bit(FIELD_PREFIX(member))) { \
+            out_record.fields[name] = view.get_field(name); \
+        }
+    
+    FieldMask mask = 0;
+    switch (view.type()) {
+        case STDFRecordType::PTR:
+            out_record.type_name = "PTR";
+            mask = ptr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::PTR_##member
+            #include "../field_defs/ptr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        case STDFRecordType::MPR:
+            out_record.type_name = "MPR";
+            mask = mpr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::MPR_##member
+            #include "../field_defs/mpr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        case STDFRecordType::FTR:
+            out_record.type_name = "FTR";
+            mask = ftr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::FTR_##member
+            #include "../field_defs/ftr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        case STDFRecordType::HBR:
+            out_record.type_name = "HBR";
+            mask = hbr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::HBR_##member
+            #include "../field_defs/hbr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        case STDFRecordType::SBR:
+            out_record.type_name = "SBR";
+            mask = sbr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::SBR_##member
+            #include "../field_defs/sbr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        case STDFRecordType::PRR:
+            out_record.type_name = "PRR";
+            mask = prr_mask_;
+            #define FIELD_PREFIX(member) stdf_fields::PRR_##member
+            #include "../field_defs/prr_fields.def"
+            #undef FIELD_PREFIX
+            break;
+        default:
+            break;
+    }
+    
+    #undef FIELD
+}
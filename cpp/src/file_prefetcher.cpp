@@ -0,0 +1,199 @@
+#include "../include/file_prefetcher.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+static std::atomic<size_t> g_default_files_ahead(2);
+static std::atomic<uint64_t> g_default_window_bytes(uint64_t(1) << 30);
+
+void FilePrefetcher::set_default_files_ahead(size_t files) {
+    g_default_files_ahead = files;
+}
+
+size_t FilePrefetcher::get_default_files_ahead() {
+    return g_default_files_ahead;
+}
+
+void FilePrefetcher::set_default_window_bytes(uint64_t bytes) {
+    g_default_window_bytes = bytes;
+}
+
+uint64_t FilePrefetcher::get_default_window_bytes() {
+    return g_default_window_bytes;
+}
+
+FilePrefetcher::FilePrefetcher()
+    : files_ahead_(g_default_files_ahead)
+    , window_bytes_(g_default_window_bytes)
+    , threads_(2)
+    , next_(0)
+    , ahead_(0)
+    , window_used_(0)
+    , stopping_(false) {
+}
+
+FilePrefetcher::~FilePrefetcher() {
+    stop();
+}
+
+void FilePrefetcher::start(const std::vector<std::string>& paths, size_t opened) {
+    stop();
+    paths_ = paths;
+    sizes_.assign(paths.size(), 0);
+    states_.assign(paths.size(), FileState::WAITING);
+    std::fill(states_.begin(), states_.begin() + std::min(opened, paths.size()), FileState::CLAIMED);
+    next_ = 0;
+    ahead_ = 0;
+    window_used_ = 0;
+    stopping_ = false;
+    stats_ = FilePrefetchStats();
+    if (files_ahead_ == 0 || window_bytes_ == 0 || opened >= paths.size()) {
+        return;
+    }
+
+    // Each file takes its size, up to the whole window, out of the window
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(paths[i], ec);
+        sizes_[i] = ec ? 0 : std::min(size, window_bytes_);
+    }
+    const size_t readers = std::min(threads_, std::min(files_ahead_, paths.size() - opened));
+    for (size_t t = 0; t < readers; ++t) {
+        readers_.emplace_back(&FilePrefetcher::read_ahead, this);
+    }
+}
+
+void FilePrefetcher::claimed(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index >= states_.size() || states_[index] == FileState::CLAIMED) {
+        return;
+    }
+    if (states_[index] != FileState::WAITING) {
+        ahead_--;
+        window_used_ -= sizes_[index];
+    }
+    states_[index] = FileState::CLAIMED;
+    changed_.notify_all();
+}
+
+void FilePrefetcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        changed_.notify_all();
+    }
+    for (auto& reader : readers_) {
+        reader.join();
+    }
+    readers_.clear();
+}
+
+FilePrefetchStats FilePrefetcher::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void FilePrefetcher::read_ahead() {
+    std::vector<char> buffer(READ_CHUNK);
+    while (true) {
+        size_t file = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // Files are read in claim order; the next one waits for room
+            bool found = false;
+            changed_.wait(lock, [&]() {
+                while (next_ < states_.size() && states_[next_] != FileState::WAITING) {
+                    next_++;
+                }
+                found = next_ < states_.size();
+                return stopping_ || !found || (ahead_ < files_ahead_ && window_used_ + sizes_[next_] <= window_bytes_);
+            });
+            if (stopping_ || !found) {
+                return;
+            }
+            file = next_++;
+            states_[file] = FileState::READING;
+            ahead_++;
+            window_used_ += sizes_[file];
+        }
+
+        auto read_start = std::chrono::high_resolution_clock::now();
+        uint64_t bytes = 0;
+        const bool read = read_file(paths_[file], sizes_[file], buffer, bytes);
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - read_start).count();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.files += read;
+        stats_.errors += !read;
+        stats_.bytes += bytes;
+        stats_.read_time += seconds;
+        if (states_[file] == FileState::CLAIMED) {
+            stats_.late++;
+        } else {
+            states_[file] = FileState::READ;
+        }
+    }
+}
+
+bool FilePrefetcher::read_file(const std::string& path, uint64_t max_bytes, std::vector<char>& buffer, uint64_t& bytes) {
+    auto stopped = [this]() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stopping_;
+    };
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    bool ok = true;
+    while (bytes < max_bytes && !stopped()) {
+        DWORD got = 0;
+        const DWORD want = static_cast<DWORD>(std::min<uint64_t>(buffer.size(), max_bytes - bytes));
+        if (!ReadFile(file, buffer.data(), want, &got, nullptr)) {
+            ok = false;
+            break;
+        }
+        if (got == 0) {
+            break;
+        }
+        bytes += got;
+    }
+    CloseHandle(file);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    posix_fadvise(fd, 0, static_cast<off_t>(max_bytes), POSIX_FADV_SEQUENTIAL);
+    bool ok = true;
+    while (bytes < max_bytes && !stopped()) {
+        const size_t want = static_cast<size_t>(std::min<uint64_t>(buffer.size(), max_bytes - bytes));
+        ssize_t got = pread(fd, buffer.data(), want, static_cast<off_t>(bytes));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            ok = false;
+            break;
+        }
+        if (got == 0) {
+            break;  // Shrank since start(); the decoder will see it
+        }
+        bytes += static_cast<uint64_t>(got);
+    }
+    ::close(fd);
+    return ok;
+#endif
+}
@@ -0,0 +1,33 @@
+#include "../include/file_schedule.h"
+#include "../include/decompressing_reader.h"
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+
+std::vector<uint64_t> estimate_file_costs(const std::vector<std::string>& paths) {
+    std::vector<uint64_t> costs(paths.size(), 0);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::error_code ec;
+        const uint64_t size = std::filesystem::file_size(paths[i], ec);
+        if (ec) {
+            continue;
+        }
+        costs[i] = detect_compression(paths[i]) == STDFCompression::NONE ? size : size * COMPRESSED_COST_FACTOR;
+    }
+    return costs;
+}
+
+std::vector<size_t> largest_first(const std::vector<uint64_t>& costs) {
+    std::vector<size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+    return order;
+}
+
+size_t decode_threads_for(uint64_t cost, uint64_t total, size_t files, size_t threads) {
+    if (total == 0) {
+        return std::max<size_t>(1, threads / std::max<size_t>(1, files));
+    }
+    const double share = static_cast<double>(cost) / static_cast<double>(total);
+    return std::min(threads, std::max<size_t>(1, static_cast<size_t>(share * static_cast<double>(threads))));
+}
@@ -0,0 +1,206 @@
+#include "../include/id_map_snapshot.h"
+#include "../include/ingest_manifest.h"
+#include "../include/stream_hash.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint64_t SNAPSHOT_MAGIC = 0x314E5350414D4449ULL;  // "IDMAPSN1" on little-endian hosts
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct SnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t count;
+    uint64_t capacity;       // Slots, a power of two
+    uint64_t names_size;
+    uint32_t max_id;
+    uint32_t reserved;
+};
+
+// Shared snapshots by path, with the file stamp they were opened at
+struct SharedSnapshot {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    std::shared_ptr<const IDMapSnapshot> snapshot;
+};
+
+std::mutex shared_mutex;
+std::map<std::string, SharedSnapshot> shared_snapshots;
+
+}  // namespace
+
+IDMapSnapshot::IDMapSnapshot()
+    : slots_(nullptr), names_(nullptr), names_size_(0), capacity_(0), count_(0), max_id_(0) {
+}
+
+uint64_t IDMapSnapshot::hash_name(std::string_view name) {
+    StreamHash hash;
+    hash.update(name.data(), name.size());
+    uint64_t digest = hash.digest();
+    return digest != 0 ? digest : 1;  // 0 marks an empty slot
+}
+
+bool IDMapSnapshot::open(const std::string& path) {
+    if (!file_.open(path)) {
+        last_error_ = file_.get_last_error();
+        return false;
+    }
+    SnapshotHeader header;
+    if (file_.size() < sizeof(header)) {
+        last_error_ = "Truncated ID snapshot " + path;
+        return false;
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.byte_order != BYTE_ORDER_MARK) {
+        last_error_ = "Not an ID snapshot (or another version / byte order): " + path;
+        return false;
+    }
+    const uint64_t slots_bytes = header.capacity * sizeof(Slot);
+    if (header.capacity == 0 || (header.capacity & (header.capacity - 1)) != 0 || header.count > header.capacity ||
+        header.capacity > (file_.size() - sizeof(header)) / sizeof(Slot) ||
+        header.names_size != file_.size() - sizeof(header) - slots_bytes) {
+        last_error_ = "Corrupt ID snapshot " + path;
+        return false;
+    }
+    slots_ = reinterpret_cast<const Slot*>(file_.data() + sizeof(header));
+    names_ = reinterpret_cast<const char*>(file_.data() + sizeof(header) + slots_bytes);
+    names_size_ = header.names_size;
+    capacity_ = header.capacity;
+    count_ = static_cast<size_t>(header.count);
+    max_id_ = header.max_id;
+    return true;
+}
+
+bool IDMapSnapshot::find(std::string_view name, uint32_t& id) const {
+    if (capacity_ == 0) {
+        return false;
+    }
+    const uint64_t hash = hash_name(name);
+    const uint64_t mask = capacity_ - 1;
+    // A table written here always has an empty slot; a damaged one without
+    // any is not probed past its capacity
+    uint64_t i = hash & mask;
+    for (uint64_t probe = 0; probe < capacity_; ++probe, i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (slot.hash == 0) {
+            return false;
+        }
+        if (slot.hash == hash && slot.length == name.size() && uint64_t(slot.offset) + slot.length <= names_size_ &&
+            std::memcmp(names_ + slot.offset, name.data(), name.size()) == 0) {
+            id = slot.id;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<IDMapSnapshot::Mapping> IDMapSnapshot::mappings() const {
+    std::vector<Mapping> mappings;
+    mappings.reserve(count_);
+    for (uint64_t i = 0; i < capacity_; ++i) {
+        if (slots_[i].hash != 0 && uint64_t(slots_[i].offset) + slots_[i].length <= names_size_) {
+            mappings.emplace_back(std::string(names_ + slots_[i].offset, slots_[i].length), slots_[i].id);
+        }
+    }
+    std::sort(mappings.begin(), mappings.end(),
+              [](const Mapping& a, const Mapping& b) { return a.second < b.second; });
+    return mappings;
+}
+
+bool IDMapSnapshot::write(const std::string& path, const std::vector<Mapping>& mappings, std::string& error) {
+    // Last mapping of each name
+    std::unordered_map<std::string_view, uint32_t> unique;
+    unique.reserve(mappings.size());
+    for (const Mapping& mapping : mappings) {
+        unique[mapping.first] = mapping.second;
+    }
+
+    uint64_t capacity = 16;
+    while (capacity < 2 * unique.size()) {
+        capacity *= 2;
+    }
+    std::vector<Slot> slots(capacity, Slot{0, 0, 0, 0, 0});
+    std::string names;
+    uint32_t max_id = 0;
+    for (const auto& entry : unique) {
+        if (names.size() + entry.first.size() > UINT32_MAX) {
+            error = "ID snapshot names exceed 4 GiB";
+            return false;
+        }
+        const uint64_t hash = hash_name(entry.first);
+        uint64_t i = hash & (capacity - 1);
+        while (slots[i].hash != 0) {
+            i = (i + 1) & (capacity - 1);
+        }
+        slots[i] = Slot{hash, static_cast<uint32_t>(names.size()), static_cast<uint32_t>(entry.first.size()),
+                        entry.second, 0};
+        names.append(entry.first.data(), entry.first.size());
+        max_id = std::max(max_id, entry.second);
+    }
+
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, BYTE_ORDER_MARK, unique.size(), capacity,
+                             names.size(), max_id, 0};
+    std::error_code ec;
+    const fs::path target(path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+    }
+    std::ostringstream temporary_name;
+    temporary_name << path << ".tmp" << std::hex << std::random_device()();
+    const std::string temporary = temporary_name.str();
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Slot)));
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+        if (!out) {
+            out.close();
+            fs::remove(temporary, ec);
+            error = "Failed to write " + temporary;
+            return false;
+        }
+    }
+    fs::rename(temporary, target, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        error = "Failed to replace " + path;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<const IDMapSnapshot> IDMapSnapshot::open_shared(const std::string& path, std::string& error) {
+    SharedSnapshot current;
+    if (!IngestManifest::file_stamp(path, current.size, current.mtime)) {
+        error = "No ID snapshot at " + path;
+        return nullptr;
+    }
+    const std::string key = IngestManifest::normalize_path(path);
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    SharedSnapshot& shared = shared_snapshots[key];
+    if (shared.snapshot && shared.size == current.size && shared.mtime == current.mtime) {
+        return shared.snapshot;
+    }
+    auto snapshot = std::make_shared<IDMapSnapshot>();
+    if (!snapshot->open(path)) {
+        error = snapshot->get_last_error();
+        return nullptr;
+    }
+    current.snapshot = snapshot;
+    shared = current;
+    return shared.snapshot;
+}
@@ -0,0 +1,580 @@
+#include "../include/ingest_daemon.h"
+#include "../include/console_log.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t MAX_RESULTS = 4096;  // Unclaimed results kept by IngestDaemon
+
+}  // namespace
+
+#ifdef _WIN32
+// One directory handle with its pending overlapped ReadDirectoryChangesW
+struct DirectoryWatcher::WatchedDirectory {
+    std::string path;
+    HANDLE handle = INVALID_HANDLE_VALUE;
+    OVERLAPPED overlapped = {};
+    DWORD buffer[16384];  // FILE_NOTIFY_INFORMATION entries are DWORD-aligned
+
+    bool arm() {
+        ResetEvent(overlapped.hEvent);
+        return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), FALSE,
+                                     FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE |
+                                         FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                     nullptr, &overlapped, nullptr) != 0;
+    }
+
+    ~WatchedDirectory() {
+        if (handle != INVALID_HANDLE_VALUE) {
+            CancelIo(handle);
+            CloseHandle(handle);
+        }
+        if (overlapped.hEvent) {
+            CloseHandle(overlapped.hEvent);
+        }
+    }
+};
+#endif
+
+// DirectoryWatcher
+
+DirectoryWatcher::DirectoryWatcher()
+    : settle_time_(2000)
+    , poll_interval_(250)
+    , woken_(false)
+#ifdef _WIN32
+    , wake_event_(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+#else
+    , inotify_fd_(-1)
+#endif
+{
+#ifndef _WIN32
+    wake_pipe_[0] = wake_pipe_[1] = -1;
+    if (pipe(wake_pipe_) == 0) {
+        fcntl(wake_pipe_[0], F_SETFL, O_NONBLOCK);
+        fcntl(wake_pipe_[1], F_SETFL, O_NONBLOCK);
+    }
+#ifdef __linux__
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef _WIN32
+    for (WatchedDirectory* watched : watched_) {
+        delete watched;
+    }
+    if (wake_event_) {
+        CloseHandle(wake_event_);
+    }
+#else
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+    for (int fd : wake_pipe_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+const char* DirectoryWatcher::backend() const {
+#ifdef _WIN32
+    return "ReadDirectoryChangesW";
+#else
+    return inotify_fd_ >= 0 ? "inotify" : "polling";
+#endif
+}
+
+bool DirectoryWatcher::is_polling() const {
+#ifdef _WIN32
+    return false;
+#else
+    return inotify_fd_ < 0;
+#endif
+}
+
+bool DirectoryWatcher::matches(const std::string& name) const {
+    if (extensions_.empty()) {
+        return true;
+    }
+    for (const std::string& extension : extensions_) {
+        if (name.size() >= extension.size() &&
+            std::equal(extension.begin(), extension.end(), name.end() - extension.size(), [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool DirectoryWatcher::stamp_of(const std::string& path, Stamp& stamp) {
+    return IngestManifest::file_stamp(path, stamp.size, stamp.mtime);
+}
+
+std::vector<std::string> DirectoryWatcher::list_directory(const std::string& directory) const {
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (fs::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec) && matches(it->path().filename().string())) {
+            files.push_back(it->path().string());
+        }
+    }
+    return files;
+}
+
+void DirectoryWatcher::set_baseline(const std::string& directory) {
+    for (const std::string& path : list_directory(directory)) {
+        Stamp stamp;
+        if (stamp_of(path, stamp)) {
+            reported_[path] = stamp;
+        }
+    }
+}
+
+bool DirectoryWatcher::add_directory(const std::string& directory) {
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec)) {
+        last_error_ = "Not a directory: " + directory;
+        return false;
+    }
+    const std::string path = IngestManifest::normalize_path(directory);
+
+#ifdef _WIN32
+    auto* watched = new WatchedDirectory;
+    watched->path = path;
+    watched->handle = CreateFileW(fs::path(path).wstring().c_str(), FILE_LIST_DIRECTORY,
+                                  FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                  FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    watched->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (watched->handle == INVALID_HANDLE_VALUE || !watched->overlapped.hEvent || !watched->arm()) {
+        delete watched;
+        last_error_ = "Cannot watch " + path + " (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    watched_.push_back(watched);
+#else
+#ifdef __linux__
+    if (inotify_fd_ >= 0) {
+        int descriptor = inotify_add_watch(inotify_fd_, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (descriptor >= 0) {
+            watch_paths_[descriptor] = path;
+        } else {
+            // Out of watches (fs.inotify.max_user_watches) or unsupported here
+            ConsoleLog::err() << "⚠️ inotify cannot watch " << path << ", polling all directories instead"
+                              << std::endl;
+            close(inotify_fd_);
+            inotify_fd_ = -1;
+            watch_paths_.clear();
+        }
+    }
+#endif
+#endif
+    directories_.push_back(path);
+    set_baseline(path);
+    return true;
+}
+
+std::vector<std::string> DirectoryWatcher::scan() const {
+    std::vector<std::string> files;
+    for (const std::string& directory : directories_) {
+        std::vector<std::string> listed = list_directory(directory);
+        files.insert(files.end(), listed.begin(), listed.end());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void DirectoryWatcher::add_candidate(const std::string& path) {
+    Stamp stamp;
+    if (!stamp_of(path, stamp)) {
+        return;
+    }
+    auto reported = reported_.find(path);
+    if (reported != reported_.end() && reported->second == stamp) {
+        return;
+    }
+    auto pending = pending_.find(path);
+    if (pending == pending_.end() || !(pending->second.stamp == stamp)) {
+        pending_[path] = Pending{stamp, std::chrono::steady_clock::now()};
+    }
+}
+
+void DirectoryWatcher::add_ready(const std::string& path, std::vector<std::string>& ready) {
+    Stamp stamp;
+    if (stamp_of(path, stamp)) {
+        reported_[path] = stamp;
+        pending_.erase(path);
+        ready.push_back(path);
+    }
+}
+
+void DirectoryWatcher::check_pending(std::vector<std::string>& ready) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        Stamp stamp;
+        if (!stamp_of(it->first, stamp)) {
+            it = pending_.erase(it);  // Gone before it settled
+        } else if (!(stamp == it->second.stamp)) {
+            it->second = Pending{stamp, now};
+            ++it;
+        } else if (now - it->second.stable_since >= settle_time_) {
+            reported_[it->first] = stamp;
+            ready.push_back(it->first);
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DirectoryWatcher::poll_directories() {
+    for (const std::string& directory : directories_) {
+        for (const std::string& path : list_directory(directory)) {
+            add_candidate(path);
+        }
+    }
+}
+
+void DirectoryWatcher::wake() {
+    woken_ = true;
+#ifdef _WIN32
+    SetEvent(wake_event_);
+#else
+    if (wake_pipe_[1] >= 0) {
+        char byte = 1;
+        (void)!write(wake_pipe_[1], &byte, 1);
+    }
+#endif
+}
+
+bool DirectoryWatcher::wait_events(std::chrono::milliseconds timeout, std::vector<std::string>& ready) {
+#ifdef _WIN32
+    std::vector<HANDLE> handles;
+    for (WatchedDirectory* watched : watched_) {
+        handles.push_back(watched->overlapped.hEvent);
+    }
+    handles.push_back(wake_event_);
+    DWORD signalled = WaitForMultipleObjects(static_cast<DWORD>(handles.size()), handles.data(), FALSE,
+                                             static_cast<DWORD>(timeout.count()));
+    if (signalled == WAIT_FAILED) {
+        last_error_ = "Waiting for directory changes failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    if (signalled >= WAIT_OBJECT_0 && signalled < WAIT_OBJECT_0 + watched_.size()) {
+        WatchedDirectory* watched = watched_[signalled - WAIT_OBJECT_0];
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(watched->handle, &watched->overlapped, &bytes, FALSE)) {
+            last_error_ = "Lost the watch on " + watched->path;
+            return false;
+        }
+        if (bytes == 0) {
+            // The change buffer overflowed: list the directory instead
+            for (const std::string& path : list_directory(watched->path)) {
+                add_candidate(path);
+            }
+        }
+        for (size_t offset = 0; bytes > 0;) {
+            const auto* change = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(
+                reinterpret_cast<const char*>(watched->buffer) + offset);
+            if (change->Action == FILE_ACTION_ADDED || change->Action == FILE_ACTION_MODIFIED ||
+                change->Action == FILE_ACTION_RENAMED_NEW_NAME) {
+                fs::path path = fs::path(watched->path) /
+                                std::wstring(change->FileName, change->FileNameLength / sizeof(WCHAR));
+                if (matches(path.filename().string())) {
+                    add_candidate(path.string());
+                }
+            }
+            if (change->NextEntryOffset == 0) break;
+            offset += change->NextEntryOffset;
+        }
+        if (!watched->arm()) {
+            last_error_ = "Lost the watch on " + watched->path;
+            return false;
+        }
+    }
+    return true;
+#else
+    pollfd descriptors[2];
+    nfds_t count = 0;
+    descriptors[count++] = pollfd{wake_pipe_[0], POLLIN, 0};
+    if (inotify_fd_ >= 0) {
+        descriptors[count++] = pollfd{inotify_fd_, POLLIN, 0};
+    }
+    if (poll(descriptors, count, static_cast<int>(timeout.count())) < 0) {
+        if (errno == EINTR) {
+            return true;
+        }
+        last_error_ = "Waiting for directory changes failed (errno " + std::to_string(errno) + ")";
+        return false;
+    }
+    if (descriptors[0].revents & POLLIN) {
+        char drained[64];
+        while (read(wake_pipe_[0], drained, sizeof(drained)) > 0) {
+        }
+    }
+#ifdef __linux__
+    if (count > 1 && (descriptors[1].revents & POLLIN)) {
+        alignas(inotify_event) char buffer[16384];
+        ssize_t length;
+        while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (char* entry = buffer; entry < buffer + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(entry);
+                entry += sizeof(inotify_event) + event->len;
+                if (event->mask & IN_Q_OVERFLOW) {
+                    poll_directories();  // Events were dropped: compare listings instead
+                    continue;
+                }
+                auto directory = watch_paths_.find(event->wd);
+                if (event->len == 0 || directory == watch_paths_.end() || !matches(event->name)) {
+                    continue;
+                }
+                add_ready((fs::path(directory->second) / event->name).string(), ready);
+            }
+        }
+    }
+#endif
+    return true;
+#endif
+}
+
+bool DirectoryWatcher::wait(std::vector<std::string>& ready, std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const size_t before = ready.size();
+    while (true) {
+        const auto now = std::chrono::steady_clock::now();
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        remaining = std::max(remaining, std::chrono::milliseconds(0));
+        // Unsettled files and listings need a look every poll interval
+        auto step = (is_polling() || !pending_.empty()) ? std::min(remaining, poll_interval_) : remaining;
+        if (!wait_events(step, ready)) {
+            return false;
+        }
+        if (is_polling()) {
+            poll_directories();
+        }
+        check_pending(ready);
+        if (ready.size() > before || woken_.exchange(false) || std::chrono::steady_clock::now() >= deadline) {
+            return true;
+        }
+    }
+}
+
+// IngestDaemon
+
+IngestDaemon::IngestDaemon(const IngestDaemonConfig& config)
+    : config_(config)
+    , pipeline_(config.connection)
+    , running_(false)
+    , stopping_(false)
+    , published_devices_(0)
+    , published_params_(0) {
+    pipeline_.set_decode_threads(config_.decode_threads);
+    pipeline_.set_insert_threads(config_.insert_threads);
+    pipeline_.set_queue_depth(config_.queue_depth);
+    pipeline_.set_block_rows(config_.block_rows);
+    pipeline_.set_coalesce_rows(config_.coalesce_rows);
+    pipeline_.set_keep_alive(true);
+}
+
+IngestDaemon::~IngestDaemon() {
+    stop();
+}
+
+bool IngestDaemon::start() {
+    if (thread_.joinable()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_error_.clear();
+    stats_ = IngestDaemonStats();
+
+    if (config_.directories.empty()) {
+        last_error_ = "No directories to watch";
+        return false;
+    }
+    watcher_ = std::make_unique<DirectoryWatcher>();
+    watcher_->set_extensions(config_.extensions);
+    watcher_->set_settle_time(config_.settle_time);
+    for (const std::string& directory : config_.directories) {
+        if (!watcher_->add_directory(directory)) {
+            last_error_ = watcher_->get_last_error();
+            watcher_.reset();
+            return false;
+        }
+    }
+    if (!config_.manifest_path.empty() && !manifest_.is_open()) {
+        if (!manifest_.open(config_.manifest_path)) {
+            last_error_ = manifest_.get_last_error();
+            watcher_.reset();
+            return false;
+        }
+        pipeline_.set_manifest(&manifest_);
+    }
+    initial_files_ = config_.ingest_existing ? watcher_->scan() : std::vector<std::string>();
+
+    ConsoleLog::out() << "👀 Watching " << config_.directories.size() << " directories (" << watcher_->backend()
+                      << ") for " << config_.table << "; " << initial_files_.size() << " files already there"
+                      << std::endl;
+    stopping_ = false;
+    running_ = true;
+    thread_ = std::thread(&IngestDaemon::run, this);
+    return true;
+}
+
+void IngestDaemon::stop() {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stopping_ = true;
+    watcher_->wake();
+    thread_.join();
+    watcher_.reset();
+    running_ = false;
+}
+
+void IngestDaemon::run() {
+    std::vector<std::string> batch;
+    std::vector<Clock::time_point> ready_at;
+    std::set<std::string> queued;
+    Clock::time_point first_ready;
+    auto enqueue = [&](const std::vector<std::string>& paths) {
+        const auto now = Clock::now();
+        for (const std::string& path : paths) {
+            if (queued.insert(path).second) {
+                if (batch.empty()) {
+                    first_ready = now;
+                }
+                batch.push_back(path);
+                ready_at.push_back(now);
+            }
+        }
+    };
+    enqueue(initial_files_);
+    initial_files_.clear();
+
+    while (!stopping_) {
+        const auto now = Clock::now();
+        if (!batch.empty() && now >= first_ready + config_.batch_window) {
+            ingest(batch, ready_at);
+            batch.clear();
+            ready_at.clear();
+            queued.clear();
+            continue;
+        }
+        auto timeout = batch.empty()
+            ? std::chrono::milliseconds(1000)
+            : std::chrono::duration_cast<std::chrono::milliseconds>(first_ready + config_.batch_window - now);
+        std::vector<std::string> ready;
+        if (!watcher_->wait(ready, timeout)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last_error_ = watcher_->get_last_error();
+            ConsoleLog::err() << "❌ Ingest daemon stopped: " << last_error_ << std::endl;
+            break;
+        }
+        enqueue(ready);
+    }
+    running_ = false;
+}
+
+void IngestDaemon::ingest(const std::vector<std::string>& paths, const std::vector<Clock::time_point>& ready_at) {
+    pipeline_.run(config_.table, paths);
+    const auto done = Clock::now();
+
+    // Every row of these files is in the table now
+    if (manifest_.is_open()) {
+        for (const FileIngestStats& file : pipeline_.file_stats()) {
+            if (!file.skipped) {
+                manifest_.record(file.path, file.file_hash,
+                                 file.success ? ManifestStatus::INGESTED : ManifestStatus::FAILED);
+            }
+        }
+    }
+    // IDs only grow, so the mappings past those handed out are this batch's
+    auto devices = pipeline_.id_manager().get_new_device_mappings();
+    auto params = pipeline_.id_manager().get_new_param_mappings();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.batches++;
+    stats_.rows_inserted += pipeline_.stats().rows_inserted;
+    stats_.connections_opened = pipeline_.connections_opened();
+    size_t ingested = 0;
+    double latency = 0.0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const FileIngestStats& file = pipeline_.file_stats()[i];
+        if (file.skipped) {
+            stats_.files_skipped++;
+            continue;
+        }
+        if (!file.success) {
+            stats_.files_failed++;
+        } else {
+            ingested++;
+            latency = std::max(latency, std::chrono::duration<double>(done - ready_at[i]).count());
+            stats_.last_latency = latency;
+            stats_.max_latency = std::max(stats_.max_latency, latency);
+        }
+        results_.push_back(file);
+        if (results_.size() > MAX_RESULTS) {
+            results_.pop_front();
+        }
+    }
+    stats_.files_ingested += ingested;
+    new_devices_.insert(new_devices_.end(), devices.begin() + std::min(published_devices_, devices.size()),
+                        devices.end());
+    new_params_.insert(new_params_.end(), params.begin() + std::min(published_params_, params.size()),
+                       params.end());
+    published_devices_ = devices.size();
+    published_params_ = params.size();
+    if (!pipeline_.get_last_error().empty()) {
+        last_error_ = pipeline_.get_last_error();
+    }
+    if (ingested > 0) {
+        ConsoleLog::out() << "📥 Ingested " << ingested << " new files within " << latency << "s of their arrival"
+                          << std::endl;
+    }
+}
+
+std::vector<FileIngestStats> IngestDaemon::take_results() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<FileIngestStats> results(results_.begin(), results_.end());
+    results_.clear();
+    return results;
+}
+
+void IngestDaemon::take_new_mappings(std::vector<std::pair<std::string, uint32_t>>& devices,
+                                     std::vector<std::pair<std::string, uint32_t>>& params) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    devices.swap(new_devices_);
+    params.swap(new_params_);
+    new_devices_.clear();
+    new_params_.clear();
+}
+
+IngestDaemonStats IngestDaemon::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string IngestDaemon::get_last_error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
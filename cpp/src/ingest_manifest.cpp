@@ -0,0 +1,243 @@
+#include "../include/ingest_manifest.h"
+#include "../include/console_log.h"
+#include <filesystem>
+#include <iostream>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+static const char MANIFEST_HEADER[] = "# stdf ingest manifest v1";
+
+static const char* status_name(ManifestStatus status) {
+    return status == ManifestStatus::INGESTED ? "ingested" : "failed";
+}
+
+// "status\tsize\tmtime\thash\tpath"; the path goes last so it may hold tabs
+static bool parse_line(const std::string& line, ManifestEntry& entry) {
+    size_t fields[4];
+    size_t position = 0;
+    for (size_t& field : fields) {
+        field = line.find('\t', position);
+        if (field == std::string::npos) return false;
+        position = field + 1;
+    }
+
+    std::string status = line.substr(0, fields[0]);
+    if (status == "ingested") {
+        entry.status = ManifestStatus::INGESTED;
+    } else if (status == "failed") {
+        entry.status = ManifestStatus::FAILED;
+    } else {
+        return false;
+    }
+    try {
+        entry.size = std::stoull(line.substr(fields[0] + 1, fields[1] - fields[0] - 1));
+        entry.mtime = std::stoll(line.substr(fields[1] + 1, fields[2] - fields[1] - 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    entry.content_hash = line.substr(fields[2] + 1, fields[3] - fields[2] - 1);
+    entry.path = line.substr(fields[3] + 1);
+    return !entry.path.empty();
+}
+
+IngestManifest::IngestManifest() {
+}
+
+std::string IngestManifest::normalize_path(const std::string& path) {
+    std::error_code ec;
+    fs::path absolute = fs::absolute(path, ec);
+    return ec ? path : absolute.lexically_normal().string();
+}
+
+bool IngestManifest::file_stamp(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = fs::file_size(path, ec);
+    if (ec) return false;
+    auto write_time = fs::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+bool IngestManifest::open(const std::string& manifest_path) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_error_.clear();
+
+    std::ifstream in(manifest_path);
+    size_t skipped = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        ManifestEntry entry;
+        if (parse_line(line, entry)) {
+            apply(entry);
+        } else {
+            skipped++;  // e.g. a line cut short by a crash mid-append
+        }
+    }
+    if (skipped > 0) {
+        ConsoleLog::err() << "⚠️ Ignored " << skipped << " malformed manifest line(s) in " << manifest_path << std::endl;
+    }
+
+    manifest_path_ = manifest_path;
+    return true;
+}
+
+void IngestManifest::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (out_.is_open()) {
+        out_.close();
+    }
+    manifest_path_.clear();
+    entries_.clear();
+    ingested_hashes_.clear();
+}
+
+void IngestManifest::apply(const ManifestEntry& entry) {
+    auto it = entries_.find(entry.path);
+    if (it != entries_.end() && it->second.status == ManifestStatus::INGESTED && !it->second.content_hash.empty()) {
+        auto hash = ingested_hashes_.find(it->second.content_hash);
+        if (hash != ingested_hashes_.end() && --hash->second == 0) {
+            ingested_hashes_.erase(hash);
+        }
+    }
+    if (entry.status == ManifestStatus::INGESTED && !entry.content_hash.empty()) {
+        ingested_hashes_[entry.content_hash]++;
+    }
+    entries_[entry.path] = entry;
+}
+
+bool IngestManifest::lookup(const std::string& path, ManifestEntry& entry) const {
+    std::string key = normalize_path(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        return false;
+    }
+    entry = it->second;
+    return true;
+}
+
+bool IngestManifest::is_ingested(const std::string& path, std::string* content_hash) const {
+    ManifestEntry entry;
+    if (!lookup(path, entry) || entry.status != ManifestStatus::INGESTED) {
+        return false;
+    }
+
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!file_stamp(path, size, mtime) || size != entry.size || mtime != entry.mtime) {
+        return false;  // Gone or rewritten since it was ingested
+    }
+    if (content_hash) {
+        *content_hash = entry.content_hash;
+    }
+    return true;
+}
+
+bool IngestManifest::contains_hash(const std::string& content_hash) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ingested_hashes_.count(content_hash) > 0;
+}
+
+std::string IngestManifest::format_line(const ManifestEntry& entry) {
+    return std::string(status_name(entry.status)) + "\t" + std::to_string(entry.size) + "\t" +
+           std::to_string(entry.mtime) + "\t" + entry.content_hash + "\t" + entry.path + "\n";
+}
+
+bool IngestManifest::record(const std::string& path, const std::string& content_hash, ManifestStatus status) {
+    ManifestEntry entry;
+    entry.path = normalize_path(path);
+    entry.content_hash = content_hash;
+    entry.status = status;
+    if (!file_stamp(path, entry.size, entry.mtime)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Cannot stat " + path;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (manifest_path_.empty()) {
+        last_error_ = "Manifest is not open";
+        return false;
+    }
+    if (!out_.is_open()) {
+        // Terminate a line torn by an earlier crash so it stays a single bad line
+        std::ifstream existing(manifest_path_, std::ios::binary | std::ios::ate);
+        bool fresh = !existing || existing.tellg() <= 0;
+        bool torn = false;
+        if (!fresh) {
+            existing.seekg(-1, std::ios::end);
+            torn = existing.get() != '\n';
+        }
+        existing.close();
+
+        out_.open(manifest_path_, std::ios::app);
+        if (out_ && fresh) {
+            out_ << MANIFEST_HEADER << "\n";
+        } else if (out_ && torn) {
+            out_ << "\n";
+        }
+    }
+
+    out_ << format_line(entry);
+    out_.flush();
+    if (!out_) {
+        last_error_ = "Cannot write manifest " + manifest_path_;
+        out_.close();
+        return false;
+    }
+    apply(entry);
+    return true;
+}
+
+bool IngestManifest::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (manifest_path_.empty()) {
+        last_error_ = "Manifest is not open";
+        return false;
+    }
+
+    // Write a sibling file and rename it over, so a crash leaves one intact copy
+    const std::string temp_path = manifest_path_ + ".tmp";
+    {
+        std::ofstream temp(temp_path, std::ios::trunc);
+        temp << MANIFEST_HEADER << "\n";
+        for (const auto& entry : entries_) {
+            temp << format_line(entry.second);
+        }
+        if (!temp) {
+            last_error_ = "Cannot write " + temp_path;
+            return false;
+        }
+    }
+
+    if (out_.is_open()) {
+        out_.close();
+    }
+    std::error_code ec;
+    fs::rename(temp_path, manifest_path_, ec);
+    if (ec) {
+        last_error_ = "Cannot replace " + manifest_path_ + ": " + ec.message();
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+size_t IngestManifest::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+std::vector<ManifestEntry> IngestManifest::entries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ManifestEntry> result;
+    result.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
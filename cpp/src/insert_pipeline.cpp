@@ -0,0 +1,476 @@
+#include "../include/insert_pipeline.h"
+#include "../include/bounded_queue.h"
+#include "../include/console_log.h"
+#include "../include/file_schedule.h"
+#include "../include/file_prefetcher.h"
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <sstream>
+
+InsertPipeline::InsertPipeline(const ClickHouseConnection& connection)
+    : connection_(connection)
+    , decode_threads_(1)
+    , insert_threads_(1)
+    , queue_depth_(4)
+    , block_rows_(1 << 20)
+    , coalesce_rows_(0)
+    , coalesce_bytes_(0)
+    , format_(ClickHouseFormat::NATIVE)
+    , parser_backend_(STDFParserBackend::LIBSTDF)
+    , has_patterns_(false)
+    , manifest_(nullptr)
+    , spool_(nullptr)
+    , keep_alive_(false)
+    , connections_closed_(0)
+    , inserts_failing_(false)
+    , stopped_(false) {
+}
+
+void InsertPipeline::set_keep_alive(bool keep_alive) {
+    keep_alive_ = keep_alive;
+    if (!keep_alive_) {
+        for (const auto& inserter : inserters_) {
+            connections_closed_ += inserter->get_connections_opened();
+        }
+        inserters_.clear();
+    }
+}
+
+size_t InsertPipeline::connections_opened() const {
+    size_t opened = connections_closed_;
+    for (const auto& inserter : inserters_) {
+        opened += inserter->get_connections_opened();
+    }
+    return opened;
+}
+
+void InsertPipeline::set_decode_threads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    decode_threads_ = threads;
+}
+
+void InsertPipeline::set_test_filter_patterns(const std::vector<std::string>& patterns) {
+    test_patterns_ = patterns;
+    has_patterns_ = true;
+}
+
+// How a spooled block names a source file: size, mtime and normalized
+// path, tab-separated, so a later run recognizes the file under any
+// spelling and not once it was rewritten; empty if it cannot be stat'ed
+static std::string spool_source(const std::string& path) {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!IngestManifest::file_stamp(path, size, mtime)) {
+        return "";
+    }
+    return std::to_string(size) + "\t" + std::to_string(mtime) + "\t" + IngestManifest::normalize_path(path);
+}
+
+void InsertPipeline::fail(const std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (last_error_.empty()) {
+        last_error_ = error;
+    }
+    stopped_ = true;
+}
+
+bool InsertPipeline::deliver(ClickHouseHttpInserter& inserter, const std::string& table, Block& block) {
+    const size_t rows = block.rows.size();
+    bool inserted = false;
+    if (!spool_) {
+        // Blocks are sized already; one INSERT each
+        inserted = inserter.insert(table, block.rows, encoder_, format_, rows);
+        if (!inserted) {
+            fail(inserter.get_last_error());
+            return false;
+        }
+    } else {
+        const std::string query = encoder_.insert_query(table, format_);
+        std::string body;
+        encoder_.encode(block.rows, 0, rows, format_, body);
+        // A coalesced block gets its own group, committed with its files
+        uint64_t group = spool_groups_[block.parts.front().file];
+        std::string file_hash = block.parts.front().owner->get_file_hash();
+        std::string source = spool_sources_[block.parts.front().file];
+        if (block.parts.size() > 1) {
+            group = spool_->begin_group();
+            for (size_t part = 1; part < block.parts.size(); ++part) {
+                file_hash += "\n" + block.parts[part].owner->get_file_hash();
+                source += "\n" + spool_sources_[block.parts[part].file];
+            }
+        }
+        InsertSpoolEntry entry;
+        if (!spool_->write(group, query, body, rows, file_hash, source, entry)) {
+            fail(spool_->get_last_error());
+            return false;
+        }
+        if (block.parts.size() > 1) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const BlockPart& part : block.parts) {
+                tail_groups_[part.file] = group;
+                coalesced_files_[group].push_back(part.file);
+            }
+        }
+        inserted = !inserts_failing_ && inserter.insert_encoded(query, body);
+        if (inserted) {
+            spool_->acknowledge(entry);
+        } else if (!inserts_failing_.exchange(true)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (last_error_.empty()) {
+                last_error_ = inserter.get_last_error();
+            }
+            ConsoleLog::err() << "⚠️ Inserts failing; spooling the remaining blocks to " << spool_->dir() << std::endl;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (spool_) {
+        stats_.blocks_spooled++;
+    }
+    if (inserted) {
+        stats_.blocks_inserted++;
+        stats_.rows_inserted += rows;
+        stats_.bytes_sent += inserter.get_bytes_sent();
+    }
+    for (const BlockPart& part : block.parts) {
+        if (inserted) {
+            blocks_inserted_[part.file]++;
+            file_stats_[part.file].measurements += part.rows;
+        } else {
+            blocks_spooled_[part.file]++;
+        }
+    }
+    return true;
+}
+
+bool InsertPipeline::file_complete(size_t file) const {
+    return decoded_[file] && blocks_inserted_[file] + blocks_spooled_[file] == blocks_queued_[file];
+}
+
+bool InsertPipeline::file_settled(size_t file) const {
+    if (!file_complete(file)) {
+        return false;
+    }
+    // Only a spooled block binds its files together: replaying it needs all of them done
+    auto shared = coalesced_files_.find(tail_groups_[file]);
+    if (shared == coalesced_files_.end()) {
+        return true;
+    }
+    for (size_t other : shared->second) {
+        if (!file_complete(other)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InsertPipeline::settle_file(size_t file) {
+    if (!spool_ || !file_settled(file)) {
+        return;
+    }
+    auto shared = coalesced_files_.find(tail_groups_[file]);
+    if (shared == coalesced_files_.end()) {
+        spool_->commit(spool_groups_[file]);
+        return;
+    }
+    for (size_t other : shared->second) {
+        spool_->commit(spool_groups_[other]);
+    }
+    spool_->commit(shared->first);
+}
+
+bool InsertPipeline::run(const std::string& table, const std::vector<std::string>& paths) {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    file_stats_.assign(paths.size(), FileIngestStats());
+    blocks_queued_.assign(paths.size(), 0);
+    blocks_inserted_.assign(paths.size(), 0);
+    blocks_spooled_.assign(paths.size(), 0);
+    spool_groups_.assign(paths.size(), 0);
+    spool_sources_.assign(paths.size(), std::string());
+    tail_groups_.assign(paths.size(), 0);
+    coalesced_files_.clear();
+    decoded_.assign(paths.size(), 0);
+    stats_ = InsertPipelineStats();
+    stopped_ = false;
+    inserts_failing_ = false;
+    last_error_.clear();
+
+    // A file with committed blocks in the spool was decoded in full by a
+    // run that stopped before it could be recorded; the replay below
+    // inserts it, so decoding it again would insert its rows twice. The
+    // blocks name it by stamp and normalized path (spool_source), so a
+    // rewritten file is decoded again.
+    std::map<std::string, FileIngestStats> spooled;
+    if (spool_) {
+        for (const InsertSpoolEntry& entry : spool_->pending()) {
+            // A coalesced block lists its files one per line
+            std::istringstream sources(entry.source);
+            std::istringstream hashes(entry.file_hash);
+            std::string source;
+            std::string file_hash;
+            while (std::getline(sources, source) && std::getline(hashes, file_hash)) {
+                FileIngestStats& stats = spooled[source];
+                stats.file_hash = file_hash;
+                if (entry.source.find('\n') == std::string::npos) {
+                    stats.measurements += entry.rows;
+                }
+            }
+        }
+    }
+
+    // Manifest hits are settled before any file is opened
+    std::vector<size_t> pending;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        FileIngestStats& stats = file_stats_[i];
+        stats.path = paths[i];
+        if (manifest_ && manifest_->is_ingested(paths[i], &stats.file_hash)) {
+            stats.success = true;
+            stats.skipped = true;
+            continue;
+        }
+        if (spool_) {
+            spool_sources_[i] = spool_source(paths[i]);
+        }
+        auto in_spool = spooled.find(spool_sources_[i]);
+        if (!spool_sources_[i].empty() && in_spool != spooled.end()) {
+            stats.file_hash = in_spool->second.file_hash;
+            stats.measurements = in_spool->second.measurements;
+            decoded_[i] = 1;  // Settled with no blocks of this run
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    // Largest files first, each with its share of the decode threads
+    const std::vector<uint64_t> costs = estimate_file_costs(paths);
+    uint64_t total_cost = 0;
+    for (size_t i : pending) {
+        total_cost += costs[i];
+    }
+    std::stable_sort(pending.begin(), pending.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+    const size_t decoders = std::min(decode_threads_, std::max<size_t>(1, pending.size()));
+    BoundedQueue<Block> queue(queue_depth_);
+    std::atomic<size_t> next_file(0);
+
+    // The files after the first `decoders` are read into the page cache
+    // while those decode
+    std::vector<std::string> claim_order;
+    for (size_t i : pending) {
+        claim_order.push_back(paths[i]);
+    }
+    FilePrefetcher prefetcher;
+    prefetcher.start(claim_order, decoders);
+
+    auto push = [&](Block& block, double& waited) {
+        auto wait_start = std::chrono::high_resolution_clock::now();
+        bool queued = queue.push(block);
+        waited += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - wait_start).count();
+        return queued;
+    };
+
+    // The last rows of decoded files pile up here until the block is big enough
+    std::mutex coalesce_mutex;
+    Block coalescing;
+    size_t coalesced = 0;
+    auto coalesce = [&](const BlockPart& part, MeasurementBatch& rows, double& waited) {
+        Block full;
+        {
+            std::lock_guard<std::mutex> lock(coalesce_mutex);
+            coalescing.body_bytes += encoder_.encoded_size(rows);
+            coalescing.rows.append(rows);
+            coalescing.parts.push_back(part);
+            coalesced++;
+            if (coalescing.rows.size() < coalesce_rows_ &&
+                (coalesce_bytes_ == 0 || coalescing.body_bytes < coalesce_bytes_)) {
+                return true;
+            }
+            full = std::move(coalescing);
+            coalescing = Block();
+        }
+        return push(full, waited);
+    };
+
+    auto decode = [&]() {
+        double waited = 0.0;
+        for (size_t next = next_file++; next < pending.size() && !stopped_; next = next_file++) {
+            const size_t i = pending[next];
+            prefetcher.claimed(next);
+            if (spool_) {
+                spool_groups_[i] = spool_->begin_group();
+            }
+            try {
+                auto processor = std::make_shared<UltraFastProcessor>();
+                processor->set_parser_backend(parser_backend_);
+                processor->set_num_threads(decode_threads_for(costs[i], total_cost, pending.size(), decode_threads_));
+                processor->set_shared_id_manager(&id_manager_);
+                if (has_patterns_) {
+                    processor->set_test_filter_patterns(test_patterns_);
+                }
+                if (i < file_hashes_.size() && !file_hashes_[i].empty()) {
+                    processor->set_file_hash(file_hashes_[i]);
+                }
+
+                // Counted before they are queued, so the file is not settled
+                // while its last rows wait to be coalesced
+                auto hand_off = [&, i]() {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    blocks_queued_[i]++;
+                };
+                auto push_rows = [&, i](MeasurementBatch& rows) {
+                    Block block;
+                    block.parts.push_back({i, rows.size(), processor});
+                    block.rows = std::move(rows);
+                    hand_off();
+                    return push(block, waited);
+                };
+
+                // Coalescing holds each batch back until the next one shows
+                // it was not the file's last
+                MeasurementBatch held;
+                bool holding = false;
+                bool done = processor->process_stdf_file_in_batches(paths[i], block_rows_,
+                    [&](MeasurementBatch& batch) {
+                        if (coalesce_rows_ == 0) {
+                            return push_rows(batch);
+                        }
+                        bool queued = !holding || push_rows(held);
+                        held = std::move(batch);
+                        holding = true;
+                        return queued;
+                    });
+                if (done && holding) {
+                    if (held.size() >= coalesce_rows_) {
+                        push_rows(held);
+                    } else {
+                        hand_off();
+                        coalesce({i, held.size(), processor}, held, waited);
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                FileIngestStats& stats = file_stats_[i];
+                decoded_[i] = done;
+                settle_file(i);
+                stats.error = processor->get_last_error();
+                stats.total_records = processor->get_total_records();
+                stats.parsing_time = processor->get_parsing_time();
+                stats.processing_time = processor->get_processing_time();
+                stats.file_hash = processor->get_file_hash();
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                file_stats_[i].error = e.what();
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.backpressure_time += waited;
+    };
+
+    // Workers own an inserter each; kept ones carry their connection into the next run
+    const size_t connections_before = connections_opened();
+    while (inserters_.size() < insert_threads_) {
+        inserters_.push_back(std::make_unique<ClickHouseHttpInserter>(connection_));
+        inserters_.back()->set_keep_alive(keep_alive_);
+    }
+    // Blocks an earlier run left in the spool go first
+    if (spool_) {
+        const InsertSpoolStats before = spool_->stats();
+        if (!spool_->replay(*inserters_.front())) {
+            inserts_failing_ = true;
+            last_error_ = spool_->get_last_error();
+            ConsoleLog::err() << "⚠️ Spool replay failed (" << last_error_ << "); spooling every block to "
+                              << spool_->dir() << std::endl;
+        }
+        stats_.blocks_replayed = spool_->stats().replayed - before.replayed;
+    }
+
+    auto insert = [&](ClickHouseHttpInserter& inserter) {
+        Block block;
+        while (queue.pop(block)) {
+            if (!stopped_) {
+                if (deliver(inserter, table, block)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (const BlockPart& part : block.parts) {
+                        settle_file(part.file);
+                    }
+                } else {
+                    queue.close();  // Unblocks the decoders; they stop at their next block
+                }
+            }
+            block = Block();  // Last block of a file frees its processor
+        }
+    };
+
+    std::vector<std::thread> inserters;
+    for (size_t t = 0; t < insert_threads_; ++t) {
+        inserters.emplace_back(insert, std::ref(*inserters_[t]));
+    }
+    std::vector<std::thread> decoders_running;
+    for (size_t t = 0; t < decoders; ++t) {
+        decoders_running.emplace_back(decode);
+    }
+    for (auto& thread : decoders_running) {
+        thread.join();
+    }
+    if (!coalescing.parts.empty()) {
+        double waited = 0.0;
+        push(coalescing, waited);
+    }
+    stats_.files_coalesced = coalesced;
+    queue.close();
+    for (auto& thread : inserters) {
+        thread.join();
+    }
+    prefetcher.stop();
+    const FilePrefetchStats prefetched = prefetcher.stats();
+    stats_.files_prefetched = prefetched.files;
+    stats_.bytes_prefetched = prefetched.bytes;
+
+    size_t skipped = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        FileIngestStats& stats = file_stats_[i];
+        if (stats.skipped) {
+            skipped++;
+            continue;
+        }
+        stats.success = stats.error.empty() && file_settled(i);
+        if (spool_ && !stats.success) {
+            spool_->abandon(spool_groups_[i]);  // Decoded again next time
+            spool_->abandon(tail_groups_[i]);
+        }
+        if (!stats.success) {
+            if (stats.error.empty()) {
+                stats.error = "Pipeline stopped: " + last_error_;
+            }
+            if (last_error_.empty()) {
+                last_error_ = stats.error;
+            }
+            failed++;
+        }
+    }
+    if (spool_) {
+        stats_.blocks_pending = spool_->pending_count();
+    }
+    stats_.peak_queue_depth = queue.peak();
+    stats_.connections_opened = connections_opened() - connections_before;
+    if (!keep_alive_) {
+        connections_closed_ += stats_.connections_opened;
+        inserters_.clear();
+    }
+    stats_.total_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+
+    ConsoleLog::out() << "✅ Insert pipeline completed: " << paths.size() << " files (" << skipped << " already ingested, "
+              << failed << " failed), " << stats_.rows_inserted << " rows in " << stats_.blocks_inserted
+              << " blocks on " << decoders << " decode / " << insert_threads_ << " insert workers in "
+              << stats_.total_time << "s (peak queue " << stats_.peak_queue_depth << "/" << queue.capacity()
+              << ", decode waited " << stats_.backpressure_time << "s)" << std::endl;
+
+    return failed == 0;
+}
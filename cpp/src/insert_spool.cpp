@@ -0,0 +1,388 @@
+#include "../include/insert_spool.h"
+#include "../include/console_log.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t INSERT_SPOOL_MAGIC = 0x50534843;  // "CHSP"
+
+struct InsertSpoolHeader {
+    uint32_t magic;
+    uint32_t checksum;          // CRC-32 of everything after the header
+    uint64_t group;
+    uint64_t sequence;
+    uint64_t rows;
+    uint64_t body_size;
+    uint64_t compressed_size;
+    uint32_t query_size;
+    uint32_t file_hash_size;
+    uint32_t source_size;
+    uint32_t reserved;
+};
+
+const char* const ENTRY_SUFFIX = ".chblock";
+const char* const COMMIT_SUFFIX = ".commit";
+
+bool has_suffix(const std::string& name, const std::string& suffix) {
+    return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+uint32_t crc_of(uint32_t crc, const std::string& data) {
+    return static_cast<uint32_t>(crc32(crc, reinterpret_cast<const Bytef*>(data.data()), static_cast<uInt>(data.size())));
+}
+
+}  // namespace
+
+InsertSpool::InsertSpool() : next_group_(1), next_sequence_(1) {
+}
+
+std::string InsertSpool::entry_path(uint64_t group, uint64_t sequence) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 "-%016" PRIx64 "%s", group, sequence, ENTRY_SUFFIX);
+    return (fs::path(dir_) / name).string();
+}
+
+std::string InsertSpool::commit_path(uint64_t group) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 "%s", group, COMMIT_SUFFIX);
+    return (fs::path(dir_) / name).string();
+}
+
+bool InsertSpool::open(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    groups_.clear();
+    stats_ = InsertSpoolStats();
+    last_error_.clear();
+    dir_ = dir;
+
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    std::set<uint64_t> committed;
+    std::vector<std::string> unreadable;
+    uint64_t last_group = 0;
+    uint64_t last_sequence = 0;
+    for (const fs::directory_entry& file : fs::directory_iterator(dir_, ec)) {
+        const std::string name = file.path().filename().string();
+        if (has_suffix(name, ".tmp")) {
+            fs::remove(file.path(), ec);  // Crashed mid-write: never renamed into place
+        } else if (has_suffix(name, COMMIT_SUFFIX)) {
+            const uint64_t group = std::strtoull(name.c_str(), nullptr, 16);
+            committed.insert(group);
+            last_group = std::max(last_group, group);
+        } else if (has_suffix(name, ENTRY_SUFFIX)) {
+            InsertSpoolEntry entry;
+            if (!read_entry(file.path().string(), entry, nullptr)) {
+                unreadable.push_back(file.path().string());
+                continue;
+            }
+            groups_[entry.group].entries[entry.sequence] = entry;
+            last_group = std::max(last_group, entry.group);
+            last_sequence = std::max(last_sequence, entry.sequence);
+        }
+    }
+    if (ec) {
+        last_error_ = "Cannot list spool directory " + dir_ + ": " + ec.message();
+        dir_.clear();
+        return false;
+    }
+    for (const std::string& path : unreadable) {
+        fs::rename(path, path + ".corrupt", ec);
+        stats_.corrupt++;
+    }
+
+    // Groups of files that never finished are decoded again, not replayed
+    for (auto group = groups_.begin(); group != groups_.end();) {
+        if (committed.count(group->first)) {
+            group->second.committed = true;
+            ++group;
+            continue;
+        }
+        for (const auto& entry : group->second.entries) {
+            fs::remove(entry.second.path, ec);
+            stats_.discarded++;
+        }
+        group = groups_.erase(group);
+    }
+    for (uint64_t group : committed) {
+        if (!groups_.count(group)) {
+            fs::remove(commit_path(group), ec);
+        }
+    }
+    next_group_ = last_group + 1;
+    next_sequence_ = last_sequence + 1;
+
+    size_t pending = 0;
+    for (const auto& group : groups_) {
+        pending += group.second.entries.size();
+    }
+    if (pending > 0 || stats_.discarded > 0) {
+        ConsoleLog::out() << "📦 Insert spool " << dir_ << ": " << pending << " blocks to replay, "
+                  << stats_.discarded << " of unfinished files dropped" << std::endl;
+    }
+    return true;
+}
+
+uint64_t InsertSpool::begin_group() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint64_t group = next_group_++;
+    groups_[group];
+    return group;
+}
+
+bool InsertSpool::write(uint64_t group, const std::string& query, const std::string& body, uint64_t rows,
+                        const std::string& file_hash, const std::string& source, InsertSpoolEntry& entry) {
+    uLongf compressed_size = compressBound(static_cast<uLong>(body.size()));
+    std::string compressed(compressed_size, '\0');
+    if (compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_size, reinterpret_cast<const Bytef*>(body.data()),
+                  static_cast<uLong>(body.size()), Z_BEST_SPEED) != Z_OK) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Failed to compress a spooled block";
+        return false;
+    }
+    compressed.resize(compressed_size);
+
+    InsertSpoolHeader header = {};
+    header.magic = INSERT_SPOOL_MAGIC;
+    header.group = group;
+    header.rows = rows;
+    header.body_size = body.size();
+    header.compressed_size = compressed.size();
+    header.query_size = static_cast<uint32_t>(query.size());
+    header.file_hash_size = static_cast<uint32_t>(file_hash.size());
+    header.source_size = static_cast<uint32_t>(source.size());
+    header.checksum = crc_of(crc_of(crc_of(crc_of(0, query), file_hash), source), compressed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        header.sequence = next_sequence_++;
+    }
+
+    entry = InsertSpoolEntry();
+    entry.group = group;
+    entry.sequence = header.sequence;
+    entry.path = entry_path(group, header.sequence);
+    entry.query = query;
+    entry.file_hash = file_hash;
+    entry.source = source;
+    entry.rows = rows;
+    entry.body_bytes = body.size();
+    entry.stored_bytes = sizeof(header) + query.size() + file_hash.size() + source.size() + compressed.size();
+
+    // Renamed into place only once complete
+    const std::string temporary = entry.path + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const std::string* part : {&query, &file_hash, &source, static_cast<const std::string*>(&compressed)}) {
+            out.write(part->data(), static_cast<std::streamsize>(part->size()));
+        }
+        out.close();
+        if (!out) {
+            fs::remove(temporary, ec);
+            std::lock_guard<std::mutex> lock(mutex_);
+            last_error_ = "Failed to write spool entry " + temporary;
+            return false;
+        }
+    }
+    fs::rename(temporary, entry.path, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Failed to write spool entry " + entry.path;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    groups_[group].entries[entry.sequence] = entry;
+    stats_.written++;
+    stats_.written_bytes += entry.stored_bytes;
+    return true;
+}
+
+bool InsertSpool::commit(uint64_t group) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(group);
+    if (it == groups_.end()) {
+        return true;
+    }
+    if (it->second.entries.empty()) {
+        groups_.erase(it);  // Everything acknowledged already
+        return true;
+    }
+    std::ofstream(commit_path(group), std::ios::trunc) << group << '\n';
+    std::error_code ec;
+    if (!fs::exists(commit_path(group), ec)) {
+        last_error_ = "Failed to write " + commit_path(group);
+        return false;
+    }
+    it->second.committed = true;
+    return true;
+}
+
+void InsertSpool::abandon(uint64_t group) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = groups_.find(group);
+    if (it == groups_.end()) {
+        return;
+    }
+    std::error_code ec;
+    for (const auto& entry : it->second.entries) {
+        fs::remove(entry.second.path, ec);
+        stats_.discarded++;
+    }
+    fs::remove(commit_path(group), ec);
+    groups_.erase(it);
+}
+
+void InsertSpool::acknowledge(const InsertSpoolEntry& entry) {
+    std::error_code ec;
+    fs::remove(entry.path, ec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.acknowledged++;
+    auto it = groups_.find(entry.group);
+    if (it == groups_.end()) {
+        return;
+    }
+    it->second.entries.erase(entry.sequence);
+    if (it->second.entries.empty() && it->second.committed) {
+        fs::remove(commit_path(entry.group), ec);
+        groups_.erase(it);
+    }
+}
+
+void InsertSpool::set_aside(const InsertSpoolEntry& entry) {
+    std::error_code ec;
+    fs::rename(entry.path, entry.path + ".corrupt", ec);
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.corrupt++;
+    auto it = groups_.find(entry.group);
+    if (it == groups_.end()) {
+        return;
+    }
+    it->second.entries.erase(entry.sequence);
+    if (it->second.entries.empty() && it->second.committed) {
+        fs::remove(commit_path(entry.group), ec);
+        groups_.erase(it);
+    }
+}
+
+std::vector<InsertSpoolEntry> InsertSpool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<InsertSpoolEntry> entries;
+    for (const auto& group : groups_) {
+        if (group.second.committed) {
+            for (const auto& entry : group.second.entries) {
+                entries.push_back(entry.second);
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const InsertSpoolEntry& a, const InsertSpoolEntry& b) { return a.sequence < b.sequence; });
+    return entries;
+}
+
+size_t InsertSpool::pending_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& group : groups_) {
+        count += group.second.committed ? group.second.entries.size() : 0;
+    }
+    return count;
+}
+
+bool InsertSpool::read_entry(const std::string& path, InsertSpoolEntry& entry, std::string* body) const {
+    std::ifstream in(path, std::ios::binary);
+    InsertSpoolHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != INSERT_SPOOL_MAGIC) {
+        return false;
+    }
+    // Sizes from a damaged header must not drive the allocations below
+    std::error_code ec;
+    const uint64_t file_size = fs::file_size(path, ec);
+    if (ec || file_size != sizeof(header) + uint64_t(header.query_size) + header.file_hash_size +
+                               header.source_size + header.compressed_size) {
+        return false;
+    }
+    std::string query(header.query_size, '\0');
+    std::string file_hash(header.file_hash_size, '\0');
+    std::string source(header.source_size, '\0');
+    for (std::string* part : {&query, &file_hash, &source}) {
+        in.read(&(*part)[0], static_cast<std::streamsize>(part->size()));
+    }
+    if (!in) {
+        return false;
+    }
+    entry.group = header.group;
+    entry.sequence = header.sequence;
+    entry.path = path;
+    entry.query = query;
+    entry.file_hash = file_hash;
+    entry.source = source;
+    entry.rows = header.rows;
+    entry.body_bytes = header.body_size;
+    entry.stored_bytes = sizeof(header) + query.size() + file_hash.size() + source.size() + header.compressed_size;
+    if (!body) {
+        return true;
+    }
+
+    std::string compressed(header.compressed_size, '\0');
+    if (!in.read(&compressed[0], static_cast<std::streamsize>(compressed.size())) ||
+        crc_of(crc_of(crc_of(crc_of(0, query), file_hash), source), compressed) != header.checksum) {
+        return false;
+    }
+    body->assign(header.body_size, '\0');
+    uLongf body_size = static_cast<uLongf>(header.body_size);
+    return uncompress(reinterpret_cast<Bytef*>(&(*body)[0]), &body_size, reinterpret_cast<const Bytef*>(compressed.data()),
+                      static_cast<uLong>(compressed.size())) == Z_OK && body_size == header.body_size;
+}
+
+bool InsertSpool::read(const InsertSpoolEntry& entry, std::string& body) const {
+    InsertSpoolEntry stored;
+    return read_entry(entry.path, stored, &body);
+}
+
+bool InsertSpool::replay(ClickHouseHttpInserter& inserter) {
+    size_t replayed = 0;
+    size_t rows = 0;
+    std::string body;
+    for (const InsertSpoolEntry& entry : pending()) {
+        if (!read(entry, body)) {
+            ConsoleLog::err() << "⚠️ Spool entry " << entry.path << " failed its checksum; set aside" << std::endl;
+            set_aside(entry);
+            continue;
+        }
+        if (!inserter.insert_encoded(entry.query, body)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            last_error_ = inserter.get_last_error();
+            return false;
+        }
+        acknowledge(entry);
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.replayed++;
+        replayed++;
+        rows += entry.rows;
+    }
+    if (replayed > 0) {
+        ConsoleLog::out() << "📦 Replayed " << replayed << " spooled blocks (" << rows << " rows) from " << dir_
+                  << std::endl;
+    }
+    return true;
+}
+
+InsertSpoolStats InsertSpool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string InsertSpool::get_last_error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
@@ -0,0 +1,202 @@
+#include "../include/instrumentation.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(InstrumentedStage::COUNT);
+constexpr size_t RECORD_TYPE_COUNT = static_cast<size_t>(CountedRecordType::COUNT);
+constexpr uint8_t NO_STAGE = static_cast<uint8_t>(InstrumentedStage::COUNT);
+
+struct StageTotals {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+    std::atomic<uint64_t> histogram[Instrumentation::HISTOGRAM_BUCKETS] = {};
+};
+
+struct AllocationTotals {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+// Plain aggregates with constant initialization, so they are usable from
+// operator new before any dynamic initializer runs
+StageTotals g_stages[STAGE_COUNT];
+std::atomic<uint64_t> g_record_counts[RECORD_TYPE_COUNT] = {};
+std::atomic<uint64_t> g_record_bytes[RECORD_TYPE_COUNT] = {};
+AllocationTotals g_allocations[STAGE_COUNT + 1];  // Last slot: outside any stage
+std::atomic<bool> g_enabled{true};
+
+#if STDF_INSTRUMENTATION
+thread_local uint8_t t_current_stage = NO_STAGE;
+#endif
+
+const char* const STAGE_NAMES[STAGE_COUNT] = {
+    "parse", "chunk_decode", "content_hash", "file_processing",
+    "measurement_generation", "python_conversion", "clickhouse_insert", "scan",
+    "columnar_cache", "measurement_sort"
+};
+
+const char* const RECORD_TYPE_NAMES[RECORD_TYPE_COUNT] = {
+    "FAR", "ATR", "MIR", "MRR", "PCR", "HBR", "SBR", "PMR", "PGR", "PLR", "RDR", "SDR",
+    "WIR", "WRR", "WCR", "PIR", "PRR", "TSR", "PTR", "MPR", "FTR", "BPS", "EPS", "GDR", "DTR",
+    "OTHER"
+};
+
+size_t histogram_bucket(uint64_t nanoseconds) {
+    uint64_t microseconds = nanoseconds / 1000;
+    size_t bucket = 0;
+    while (microseconds > 0 && bucket + 1 < Instrumentation::HISTOGRAM_BUCKETS) {
+        microseconds >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+}  // namespace
+
+const char* stage_name(InstrumentedStage stage) {
+    size_t index = static_cast<size_t>(stage);
+    return index < STAGE_COUNT ? STAGE_NAMES[index] : "unknown";
+}
+
+const char* counted_record_type_name(CountedRecordType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < RECORD_TYPE_COUNT ? RECORD_TYPE_NAMES[index] : "OTHER";
+}
+
+void Instrumentation::set_enabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Instrumentation::is_enabled() {
+    return STDF_INSTRUMENTATION && g_enabled.load(std::memory_order_relaxed);
+}
+
+void Instrumentation::record_stage(InstrumentedStage stage, uint64_t nanoseconds) {
+    StageTotals& totals = g_stages[static_cast<size_t>(stage)];
+    totals.calls.fetch_add(1, std::memory_order_relaxed);
+    totals.total_ns.fetch_add(nanoseconds, std::memory_order_relaxed);
+    totals.histogram[histogram_bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t max = totals.max_ns.load(std::memory_order_relaxed);
+    while (nanoseconds > max && !totals.max_ns.compare_exchange_weak(max, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void Instrumentation::add_records(const RecordCounters& counters) {
+    if (!is_enabled()) {
+        return;
+    }
+    for (size_t type = 0; type < RECORD_TYPE_COUNT; ++type) {
+        uint64_t count = counters.count(static_cast<CountedRecordType>(type));
+        if (count > 0) {
+            g_record_counts[type].fetch_add(count, std::memory_order_relaxed);
+            g_record_bytes[type].fetch_add(counters.bytes(static_cast<CountedRecordType>(type)),
+                                           std::memory_order_relaxed);
+        }
+    }
+}
+
+InstrumentationSnapshot Instrumentation::snapshot() {
+    InstrumentationSnapshot snapshot;
+    snapshot.compiled = STDF_INSTRUMENTATION;
+    snapshot.enabled = is_enabled();
+    snapshot.counts_allocations = STDF_INSTRUMENTATION && STDF_COUNT_ALLOCATIONS;
+
+    for (size_t index = 0; index < STAGE_COUNT; ++index) {
+        const StageTotals& totals = g_stages[index];
+        StageStats stage;
+        stage.name = STAGE_NAMES[index];
+        stage.calls = totals.calls.load(std::memory_order_relaxed);
+        stage.total_seconds = totals.total_ns.load(std::memory_order_relaxed) / 1e9;
+        stage.max_seconds = totals.max_ns.load(std::memory_order_relaxed) / 1e9;
+        for (const auto& bucket : totals.histogram) {
+            stage.histogram.push_back(bucket.load(std::memory_order_relaxed));
+        }
+        stage.allocations = g_allocations[index].count.load(std::memory_order_relaxed);
+        stage.allocated_bytes = g_allocations[index].bytes.load(std::memory_order_relaxed);
+        snapshot.stages.push_back(stage);
+    }
+
+    for (size_t type = 0; type < RECORD_TYPE_COUNT; ++type) {
+        uint64_t count = g_record_counts[type].load(std::memory_order_relaxed);
+        if (count > 0) {
+            RecordTypeStats record;
+            record.name = RECORD_TYPE_NAMES[type];
+            record.count = count;
+            record.bytes = g_record_bytes[type].load(std::memory_order_relaxed);
+            snapshot.records.push_back(record);
+        }
+    }
+
+    snapshot.untracked_allocations = g_allocations[STAGE_COUNT].count.load(std::memory_order_relaxed);
+    snapshot.untracked_allocated_bytes = g_allocations[STAGE_COUNT].bytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void Instrumentation::reset() {
+    for (StageTotals& totals : g_stages) {
+        totals.calls.store(0, std::memory_order_relaxed);
+        totals.total_ns.store(0, std::memory_order_relaxed);
+        totals.max_ns.store(0, std::memory_order_relaxed);
+        for (auto& bucket : totals.histogram) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    for (size_t type = 0; type < RECORD_TYPE_COUNT; ++type) {
+        g_record_counts[type].store(0, std::memory_order_relaxed);
+        g_record_bytes[type].store(0, std::memory_order_relaxed);
+    }
+    for (AllocationTotals& allocations : g_allocations) {
+        allocations.count.store(0, std::memory_order_relaxed);
+        allocations.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+#if STDF_INSTRUMENTATION
+
+StageTimer::StageTimer(InstrumentedStage stage)
+    : stage_(stage)
+    , active_(Instrumentation::is_enabled())
+    , previous_stage_(t_current_stage) {
+    if (active_) {
+        t_current_stage = static_cast<uint8_t>(stage);
+        start_ = std::chrono::steady_clock::now();
+    }
+}
+
+StageTimer::~StageTimer() {
+    if (active_) {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        Instrumentation::record_stage(stage_, static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        t_current_stage = previous_stage_;
+    }
+}
+
+#endif
+
+#if STDF_INSTRUMENTATION && STDF_COUNT_ALLOCATIONS
+
+void* operator new(size_t size) {
+    AllocationTotals& totals = g_allocations[t_current_stage];
+    totals.count.fetch_add(1, std::memory_order_relaxed);
+    totals.bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+#endif
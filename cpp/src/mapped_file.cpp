@@ -0,0 +1,352 @@
+#include "../include/mapped_file.h"
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <cstring>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+    #include <cstdlib>
+    #include <cstring>
+    #ifdef __linux__
+        #include <sys/vfs.h>
+    #endif
+#endif
+
+static std::atomic<FileReadMode> g_default_read_mode(FileReadMode::AUTO);
+
+void MappedFile::set_default_read_mode(FileReadMode mode) {
+    g_default_read_mode = mode;
+}
+
+FileReadMode MappedFile::get_default_read_mode() {
+    return g_default_read_mode;
+}
+
+MappedFile::MappedFile()
+    : data_(nullptr)
+    , buffer_(nullptr)
+    , size_(0)
+    , open_(false)
+#ifdef _WIN32
+    , file_handle_(INVALID_HANDLE_VALUE)
+    , mapping_handle_(nullptr)
+#else
+    , fd_(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+// UNC paths (\\server\share, \\?\UNC\...) and mapped network drives
+static bool is_remote_path(const std::string& filepath) {
+    const bool unc = filepath.size() > 2 && (filepath[0] == '\\' || filepath[0] == '/') &&
+                     (filepath[1] == '\\' || filepath[1] == '/');
+    if (unc) {
+        // \\?\C:\... and \\.\C:\... are local paths in device syntax
+        const bool device = filepath.size() > 3 && (filepath[2] == '?' || filepath[2] == '.');
+        return !device || filepath.compare(4, 4, "UNC\\") == 0;
+    }
+    char full_path[MAX_PATH];
+    DWORD length = GetFullPathNameA(filepath.c_str(), MAX_PATH, full_path, nullptr);
+    if (length < 3 || length >= MAX_PATH || full_path[1] != ':') {
+        return false;
+    }
+    const char root[4] = {full_path[0], ':', '\\', '\0'};
+    return GetDriveTypeA(root) == DRIVE_REMOTE;
+}
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+
+    const FileReadMode mode = get_default_read_mode();
+    if (mode == FileReadMode::READ || (mode == FileReadMode::AUTO && is_remote_path(filepath))) {
+        return read_into_memory(filepath);
+    }
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        last_error_ = "CreateFile failed for " + filepath;
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        last_error_ = "GetFileSizeEx failed for " + filepath;
+        return false;
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    open_ = true;
+
+    // Zero-length files cannot be mapped; treat them as an empty view
+    if (size_ == 0) {
+        return true;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        close();
+        last_error_ = "CreateFileMapping failed for " + filepath;
+        return false;
+    }
+    mapping_handle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        close();
+        last_error_ = "MapViewOfFile failed for " + filepath;
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(view);
+    return true;
+}
+
+bool MappedFile::read_into_memory(const std::string& filepath) {
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        last_error_ = "CreateFile failed for " + filepath;
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        CloseHandle(file);
+        last_error_ = "GetFileSizeEx failed for " + filepath;
+        return false;
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    open_ = true;
+    if (size_ == 0) {
+        return true;
+    }
+
+    // Page-aligned, and every request starts on a READ_CHUNK boundary
+    buffer_ = VirtualAlloc(nullptr, size_, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!buffer_) {
+        close();
+        last_error_ = "VirtualAlloc failed for " + filepath;
+        return false;
+    }
+    uint8_t* out = static_cast<uint8_t*>(buffer_);
+
+    // Ring of outstanding requests, completed oldest first
+    struct PendingRead {
+        OVERLAPPED overlapped;
+        HANDLE event;
+        size_t offset;
+        DWORD length;
+    };
+    PendingRead reads[READS_IN_FLIGHT];
+    bool ok = true;
+    for (PendingRead& read : reads) {
+        read.event = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        ok = ok && read.event;
+    }
+    auto issue = [&](PendingRead& read, size_t offset, size_t length) {
+        std::memset(&read.overlapped, 0, sizeof(read.overlapped));
+        read.overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFFu);
+        read.overlapped.OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+        read.overlapped.hEvent = read.event;
+        read.offset = offset;
+        read.length = static_cast<DWORD>(length);
+        return ReadFile(file, out + offset, read.length, nullptr, &read.overlapped) ||
+               GetLastError() == ERROR_IO_PENDING;
+    };
+
+    size_t issued = 0;
+    size_t oldest = 0;
+    size_t pending = 0;
+    while (ok && (issued < size_ || pending > 0)) {
+        while (ok && pending < READS_IN_FLIGHT && issued < size_) {
+            const size_t length = std::min(READ_CHUNK, size_ - issued);
+            ok = issue(reads[(oldest + pending) % READS_IN_FLIGHT], issued, length);
+            if (ok) {
+                issued += length;
+                pending++;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        PendingRead& read = reads[oldest];
+        DWORD transferred = 0;
+        ok = GetOverlappedResult(file, &read.overlapped, &transferred, TRUE) && transferred > 0;
+        if (ok && transferred < read.length) {
+            // Short read: the rest goes out again from the same slot
+            ok = issue(read, read.offset + transferred, read.length - transferred);
+            if (ok) {
+                continue;
+            }
+        }
+        oldest = (oldest + 1) % READS_IN_FLIGHT;
+        pending--;
+    }
+
+    // The buffer must outlive every request still in flight
+    if (!ok && pending > 0) {
+        CancelIo(file);
+        for (size_t i = 0; i < pending; ++i) {
+            DWORD transferred = 0;
+            GetOverlappedResult(file, &reads[(oldest + i) % READS_IN_FLIGHT].overlapped, &transferred, TRUE);
+        }
+    }
+    for (PendingRead& read : reads) {
+        if (read.event) {
+            CloseHandle(read.event);
+        }
+    }
+    if (!ok) {
+        close();
+        last_error_ = "ReadFile failed for " + filepath;
+        return false;
+    }
+
+    data_ = out;
+    return true;
+}
+
+void MappedFile::close() {
+    if (buffer_) {
+        VirtualFree(buffer_, 0, MEM_RELEASE);
+        buffer_ = nullptr;
+    } else if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    data_ = nullptr;
+    if (mapping_handle_) {
+        CloseHandle(static_cast<HANDLE>(mapping_handle_));
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(static_cast<HANDLE>(file_handle_));
+        file_handle_ = INVALID_HANDLE_VALUE;
+    }
+    size_ = 0;
+    open_ = false;
+}
+
+#else
+
+// NFS and SMB/CIFS mounts (Linux statfs magic numbers)
+static bool is_network_file(int fd) {
+#ifdef __linux__
+    struct statfs fs;
+    if (fstatfs(fd, &fs) != 0) {
+        return false;
+    }
+    const unsigned long type = static_cast<unsigned long>(fs.f_type);
+    return type == 0x6969 || type == 0x517B || type == 0xFF534D42 || type == 0xFE534D42;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+bool MappedFile::open(const std::string& filepath) {
+    close();
+
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        last_error_ = "open failed for " + filepath + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        last_error_ = "fstat failed for " + filepath + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    size_ = static_cast<size_t>(st.st_size);
+    open_ = true;
+
+    // mmap() rejects zero-length mappings; treat them as an empty view
+    if (size_ == 0) {
+        return true;
+    }
+
+    const FileReadMode mode = get_default_read_mode();
+    if (mode == FileReadMode::READ || (mode == FileReadMode::AUTO && is_network_file(fd_))) {
+        return read_into_memory(filepath);
+    }
+
+    void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        last_error_ = "mmap failed for " + filepath + ": " + std::strerror(errno);
+        close();
+        return false;
+    }
+
+    // Records are walked front to back exactly once
+    madvise(addr, size_, MADV_SEQUENTIAL);
+
+    data_ = static_cast<const uint8_t*>(addr);
+    return true;
+}
+
+bool MappedFile::read_into_memory(const std::string& filepath) {
+    if (posix_memalign(&buffer_, 4096, size_) != 0) {
+        buffer_ = nullptr;
+        last_error_ = "Out of memory reading " + filepath;
+        close();
+        return false;
+    }
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    uint8_t* out = static_cast<uint8_t*>(buffer_);
+    size_t done = 0;
+    while (done < size_) {
+        ssize_t got = pread(fd_, out + done, std::min(READ_CHUNK, size_ - done), static_cast<off_t>(done));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            last_error_ = "read failed for " + filepath + ": " +
+                          (got < 0 ? std::strerror(errno) : "file shrank while reading");
+            close();
+            return false;
+        }
+        done += static_cast<size_t>(got);
+    }
+
+    data_ = out;
+    return true;
+}
+
+void MappedFile::close() {
+    if (buffer_) {
+        std::free(buffer_);
+        buffer_ = nullptr;
+    } else if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    size_ = 0;
+    open_ = false;
+}
+
+#endif
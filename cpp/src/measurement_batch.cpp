@@ -0,0 +1,49 @@
+#include "../include/measurement_batch.h"
+
+void MeasurementBatch::resize(size_t rows) {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        name.resize(rows);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    rows_ = rows;
+}
+
+void MeasurementBatch::clear() {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        name.clear();
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    rows_ = 0;
+}
+
+void MeasurementBatch::append(const MeasurementBatch& other) {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        name.append(other.name);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    rows_ += other.rows_;
+}
+
+void MeasurementBatch::permute(const std::vector<uint32_t>& order) {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        name.permute(order);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+}
+
+MeasurementTuple MeasurementBatch::row(size_t index) const {
+    MeasurementTuple tuple;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        tuple.name = name[index];
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return tuple;
+}
+
+std::vector<MeasurementTuple> MeasurementBatch::to_tuples() const {
+    std::vector<MeasurementTuple> tuples(rows_);
+    for (size_t i = 0; i < rows_; ++i) {
+        tuples[i] = row(i);
+    }
+    return tuples;
+}
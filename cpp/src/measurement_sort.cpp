@@ -0,0 +1,121 @@
+#include "../include/measurement_sort.h"
+#include "../include/measurement_macros.h"
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <type_traits>
+
+namespace {
+
+// Order-preserving map onto uint32_t (signed values get their sign bit flipped)
+template<typename T>
+uint32_t unsigned_key(T value) {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= 4, "sort key fields must be integers of 32 bits or less");
+    using Unsigned = typename std::make_unsigned<T>::type;
+    const Unsigned sign = std::is_signed<T>::value ? Unsigned(Unsigned(1) << (sizeof(T) * 8 - 1)) : Unsigned(0);
+    return static_cast<uint32_t>(static_cast<Unsigned>(static_cast<Unsigned>(value) ^ sign));
+}
+
+class KeyRadixSort {
+public:
+    explicit KeyRadixSort(size_t rows) : order_(rows), next_order_(rows), keys_(rows), next_keys_(rows) {
+        std::iota(order_.begin(), order_.end(), 0u);
+    }
+
+    // Stable pass by one key column, on top of the less significant ones
+    template<typename T>
+    void sort_by(const std::vector<T>& values) {
+        const size_t rows = order_.size();
+        uint32_t lo = UINT32_MAX;
+        uint32_t hi = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            const uint32_t key = unsigned_key(values[order_[i]]);
+            keys_[i] = key;
+            lo = std::min(lo, key);
+            hi = std::max(hi, key);
+        }
+        if (rows == 0 || lo == hi) {
+            return;
+        }
+
+        const uint32_t range = hi - lo;
+        for (size_t i = 0; i < rows; ++i) {
+            keys_[i] -= lo;
+        }
+        for (unsigned shift = 0; shift < 32 && (range >> shift) != 0; shift += 8) {
+            size_t counts[256] = {};
+            for (size_t i = 0; i < rows; ++i) {
+                ++counts[(keys_[i] >> shift) & 0xFF];
+            }
+            if (*std::max_element(counts, counts + 256) == rows) {
+                continue;  // Same byte in every row
+            }
+            size_t position = 0;
+            for (size_t& count : counts) {
+                const size_t digit_rows = count;
+                count = position;
+                position += digit_rows;
+            }
+            for (size_t i = 0; i < rows; ++i) {
+                const size_t to = counts[(keys_[i] >> shift) & 0xFF]++;
+                next_keys_[to] = keys_[i];
+                next_order_[to] = order_[i];
+            }
+            keys_.swap(next_keys_);
+            order_.swap(next_order_);
+        }
+    }
+
+    std::vector<uint32_t>& order() { return order_; }
+
+private:
+    std::vector<uint32_t> order_;
+    std::vector<uint32_t> next_order_;
+    std::vector<uint32_t> keys_;
+    std::vector<uint32_t> next_keys_;
+};
+
+// Key columns least significant first
+template<typename Visit>
+void for_each_key_column_reversed(const MeasurementBatch& batch, Visit visit) {
+    std::vector<std::function<void()>> columns;
+    #define VISIT_SORT_KEY(name) columns.push_back([&]() { visit(batch.name.values); });
+    MEASUREMENT_SORT_KEY_FIELDS(VISIT_SORT_KEY)
+    #undef VISIT_SORT_KEY
+    for (auto column = columns.rbegin(); column != columns.rend(); ++column) {
+        (*column)();
+    }
+}
+
+}  // namespace
+
+std::vector<uint32_t> measurement_key_order(const MeasurementBatch& batch) {
+    KeyRadixSort sort(batch.size());
+    for_each_key_column_reversed(batch, [&sort](const auto& values) { sort.sort_by(values); });
+    return std::move(sort.order());
+}
+
+bool measurements_sorted_by_key(const MeasurementBatch& batch) {
+    for (size_t row = 1; row < batch.size(); ++row) {
+        // First key column that differs decides
+        int order = 0;
+        #define COMPARE_SORT_KEY(name) \
+            if (order == 0 && batch.name.values[row - 1] != batch.name.values[row]) { \
+                order = batch.name.values[row - 1] < batch.name.values[row] ? -1 : 1; \
+            }
+        MEASUREMENT_SORT_KEY_FIELDS(COMPARE_SORT_KEY)
+        #undef COMPARE_SORT_KEY
+        if (order > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool sort_measurements_by_key(MeasurementBatch& batch) {
+    if (measurements_sorted_by_key(batch)) {
+        return false;
+    }
+    batch.permute(measurement_key_order(batch));
+    return true;
+}
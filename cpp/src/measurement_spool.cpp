@@ -0,0 +1,341 @@
+#include "../include/measurement_spool.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const uint32_t SPOOL_MAGIC = 0x4C4F5053;  // "SPOL"
+
+struct SpoolFileHeader {
+    uint32_t magic;
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t raw_size;
+    uint64_t compressed_size;
+};
+
+// Bytes per row of the measurement columns (codes for string fields)
+size_t row_bytes() {
+    size_t bytes = 0;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        bytes += std::is_same<cpp_type, std::string_view>::value ? sizeof(uint32_t) : sizeof(cpp_type);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return bytes;
+}
+
+void put(std::string& out, const void* data, size_t size) {
+    out.append(static_cast<const char*>(data), size);
+}
+
+void put_count(std::string& out, uint64_t count) {
+    put(out, &count, sizeof(count));
+}
+
+template<typename T>
+void put_column(std::string& out, const MeasurementColumn<T>& column) {
+    put_count(out, column.values.size());
+    put(out, column.values.data(), column.values.size() * sizeof(T));
+}
+
+void put_column(std::string& out, const MeasurementColumn<std::string_view>& column) {
+    put_count(out, column.codes.size());
+    put(out, column.codes.data(), column.codes.size() * sizeof(uint32_t));
+    put_count(out, column.dictionary.size());
+    for (std::string_view value : column.dictionary) {
+        put_count(out, value.size());
+        put(out, value.data(), value.size());
+    }
+}
+
+// Dictionary text of a string column; nothing for numeric ones
+template<typename T>
+size_t dictionary_bytes(const MeasurementColumn<T>&) {
+    return 0;
+}
+
+size_t dictionary_bytes(const MeasurementColumn<std::string_view>& column) {
+    size_t bytes = 0;
+    for (std::string_view value : column.dictionary) {
+        bytes += value.size() + sizeof(std::string_view);
+    }
+    return bytes;
+}
+
+// Re-points a string column at copies in text (codes are unchanged)
+template<typename T>
+void own_column(MeasurementColumn<T>&, StringTable&) {
+}
+
+void own_column(MeasurementColumn<std::string_view>& column, StringTable& text) {
+    MeasurementColumn<std::string_view> owned;
+    for (std::string_view value : column.dictionary) {
+        owned.encode(text.get(text.intern(value)));
+    }
+    owned.codes = std::move(column.codes);
+    column = std::move(owned);
+}
+
+template<typename T>
+size_t column_rows(const MeasurementColumn<T>& column) {
+    return column.values.size();
+}
+
+size_t column_rows(const MeasurementColumn<std::string_view>& column) {
+    return column.codes.size();
+}
+
+// Reads back what put_column wrote; false on a short buffer
+class SpoolReader {
+public:
+    SpoolReader(const std::vector<char>& data, StringTable& text) : data_(data), text_(text) {}
+
+    template<typename T>
+    bool column(MeasurementColumn<T>& column) {
+        uint64_t count = 0;
+        if (!count_of(count, sizeof(T))) return false;
+        column.values.resize(count);
+        return take(column.values.data(), count * sizeof(T));
+    }
+
+    bool column(MeasurementColumn<std::string_view>& column) {
+        uint64_t count = 0;
+        if (!count_of(count, sizeof(uint32_t))) return false;
+        std::vector<uint32_t> codes(count);
+        uint64_t entries = 0;
+        if (!take(codes.data(), count * sizeof(uint32_t)) || !count_of(entries, sizeof(uint64_t))) return false;
+        column.clear();
+        for (uint64_t i = 0; i < entries; ++i) {
+            uint64_t size = 0;
+            if (!count_of(size, 1) || position_ + size > data_.size()) return false;
+            column.encode(text_.get(text_.intern(std::string_view(data_.data() + position_, size))));
+            position_ += size;
+        }
+        column.codes = std::move(codes);
+        return true;
+    }
+
+private:
+    bool take(void* out, size_t size) {
+        if (position_ + size > data_.size()) return false;
+        std::memcpy(out, data_.data() + position_, size);
+        position_ += size;
+        return true;
+    }
+    // A count of elements of element_size that must still fit the buffer
+    bool count_of(uint64_t& count, size_t element_size) {
+        return take(&count, sizeof(count)) && count <= (data_.size() - position_) / element_size;
+    }
+
+    const std::vector<char>& data_;
+    StringTable& text_;
+    size_t position_ = 0;
+};
+
+}  // namespace
+
+MeasurementSpool::MeasurementSpool(size_t memory_budget, const std::string& spill_dir)
+    : memory_budget_(memory_budget)
+    , block_rows_(memory_budget > 0 ? std::max<size_t>(4096, memory_budget / 8 / row_bytes()) : 1 << 20)
+    , spill_dir_(spill_dir)
+    , memory_bytes_(0)
+    , next_sequence_(0) {
+}
+
+MeasurementSpool::~MeasurementSpool() {
+    clear();
+}
+
+size_t MeasurementSpool::batch_bytes(const MeasurementBatch& batch) {
+    size_t bytes = batch.size() * row_bytes();
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        bytes += dictionary_bytes(batch.name);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return bytes;
+}
+
+void MeasurementSpool::own_dictionaries(MeasurementBatch& rows, StringTable& text) {
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        own_column(rows.name, text);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+}
+
+bool MeasurementSpool::add(size_t file, MeasurementBatch& batch) {
+    Block block;
+    block.file = file;
+    block.text = std::make_unique<StringTable>();
+    block.rows = std::move(batch);
+    own_dictionaries(block.rows, *block.text);
+    block.bytes = batch_bytes(block.rows);
+    const size_t rows = block.rows.size();
+
+    bool keep;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        block.sequence = next_sequence_++;
+        keep = memory_budget_ == 0 || memory_bytes_ + block.bytes <= memory_budget_;
+        if (keep) {
+            memory_bytes_ += block.bytes;
+            stats_.peak_memory_bytes = std::max(stats_.peak_memory_bytes, memory_bytes_);
+        }
+    }
+
+    // Compress outside the lock so producers spill in parallel
+    if (!keep && !spill(block)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.blocks++;
+    stats_.rows += rows;
+    if (!keep) {
+        stats_.spilled_blocks++;
+        stats_.spilled_bytes += block.bytes;
+    }
+    blocks_.push_back(std::move(block));
+    return true;
+}
+
+bool MeasurementSpool::spill(Block& block) {
+    std::string raw;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        put_column(raw, block.rows.name);
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    uLongf compressed_size = compressBound(static_cast<uLong>(raw.size()));
+    std::vector<Bytef> compressed(compressed_size);
+    if (compress2(compressed.data(), &compressed_size, reinterpret_cast<const Bytef*>(raw.data()),
+                  static_cast<uLong>(raw.size()), Z_BEST_SPEED) != Z_OK) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Failed to compress a spilled measurement block";
+        return false;
+    }
+
+    std::ostringstream name;
+    name << "stdf_spool_" << std::hex << std::random_device()() << '_' << this << '_' << std::dec << block.sequence
+         << ".bin";
+    fs::path dir = spill_dir_.empty() ? fs::temp_directory_path() : fs::path(spill_dir_);
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    block.spill_path = (dir / name.str()).string();
+
+    SpoolFileHeader header = {SPOOL_MAGIC, 0, block.rows.size(), raw.size(), compressed_size};
+    std::ofstream out(block.spill_path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(compressed.data()), static_cast<std::streamsize>(compressed_size));
+    if (!out) {
+        out.close();
+        fs::remove(block.spill_path, ec);
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_error_ = "Failed to write spill file " + block.spill_path;
+        return false;
+    }
+
+    block.bytes = sizeof(header) + compressed_size;
+    block.rows.clear();
+    block.rows = MeasurementBatch();
+    block.text.reset();
+    return true;
+}
+
+bool MeasurementSpool::load(Block& block) {
+    std::ifstream in(block.spill_path, std::ios::binary);
+    SpoolFileHeader header;
+    std::vector<Bytef> compressed;
+    if (in.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.magic == SPOOL_MAGIC) {
+        compressed.resize(header.compressed_size);
+        in.read(reinterpret_cast<char*>(compressed.data()), static_cast<std::streamsize>(compressed.size()));
+    }
+    std::vector<char> raw;
+    uLongf raw_size = 0;
+    bool ok = static_cast<bool>(in) && header.magic == SPOOL_MAGIC;
+    if (ok) {
+        raw.resize(header.raw_size);
+        raw_size = static_cast<uLongf>(header.raw_size);
+        ok = uncompress(reinterpret_cast<Bytef*>(raw.data()), &raw_size, compressed.data(),
+                        static_cast<uLong>(compressed.size())) == Z_OK && raw_size == header.raw_size;
+    }
+
+    block.text = std::make_unique<StringTable>();
+    MeasurementBatch rows;
+    rows.resize(ok ? header.rows : 0);
+    SpoolReader reader(raw, *block.text);
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        ok = ok && reader.column(rows.name) && column_rows(rows.name) == header.rows;
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    std::error_code ec;
+    fs::remove(block.spill_path, ec);
+    block.spill_path.clear();
+    if (!ok) {
+        last_error_ = "Failed to read back a spilled measurement block";
+        return false;
+    }
+    block.rows = std::move(rows);
+    return true;
+}
+
+bool MeasurementSpool::drain(const std::function<bool(size_t file, MeasurementBatch& batch)>& sink) {
+    std::vector<Block> blocks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        blocks.swap(blocks_);
+    }
+    std::sort(blocks.begin(), blocks.end(), [](const Block& a, const Block& b) {
+        return a.file != b.file ? a.file < b.file : a.sequence < b.sequence;
+    });
+
+    bool ok = true;
+    for (Block& block : blocks) {
+        const bool resident = block.spill_path.empty();
+        ok = ok && (resident || load(block)) && sink(block.file, block.rows);
+        if (!block.spill_path.empty()) {
+            std::error_code ec;
+            fs::remove(block.spill_path, ec);
+        }
+        if (resident) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            memory_bytes_ -= block.bytes;
+        }
+        block.rows = MeasurementBatch();
+        block.text.reset();
+    }
+    return ok;
+}
+
+void MeasurementSpool::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Block& block : blocks_) {
+        if (!block.spill_path.empty()) {
+            std::error_code ec;
+            fs::remove(block.spill_path, ec);
+        }
+    }
+    blocks_.clear();
+    memory_bytes_ = 0;
+    next_sequence_ = 0;
+    stats_ = MeasurementSpoolStats();
+    last_error_.clear();
+}
+
+size_t MeasurementSpool::memory_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memory_bytes_;
+}
+
+MeasurementSpoolStats MeasurementSpool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
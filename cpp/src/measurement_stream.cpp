@@ -0,0 +1,91 @@
+#include "../include/measurement_stream.h"
+#include <algorithm>
+
+MeasurementStream::MeasurementStream(size_t depth)
+    : depth_(std::max<size_t>(1, depth))
+    , started_(false)
+    , done_(false)
+    , cancelled_(false)
+    , succeeded_(false) {
+}
+
+MeasurementStream::~MeasurementStream() {
+    cancel();
+    join();
+}
+
+bool MeasurementStream::start(const std::string& filepath, size_t batch_rows) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (started_) {
+        last_error_ = "Stream already started";
+        return false;
+    }
+    started_ = true;
+    producer_ = std::thread(&MeasurementStream::produce, this, filepath, std::max<size_t>(1, batch_rows));
+    return true;
+}
+
+void MeasurementStream::produce(const std::string& filepath, size_t batch_rows) {
+    bool completed = processor_.process_stdf_file_in_batches(filepath, batch_rows, [this](MeasurementBatch& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return cancelled_ || ready_.size() < depth_; });
+        if (cancelled_) {
+            return false;
+        }
+        ready_.push_back(std::move(batch));
+        not_empty_.notify_one();
+        return true;
+    });
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    succeeded_ = completed && !cancelled_;
+    if (!completed && !cancelled_) {
+        last_error_ = processor_.get_last_error().empty() ? "Processing failed" : processor_.get_last_error();
+    }
+    done_ = true;
+    not_empty_.notify_all();
+}
+
+bool MeasurementStream::next(MeasurementBatch& batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!started_) {
+        return false;
+    }
+    not_empty_.wait(lock, [this] { return !ready_.empty() || done_ || cancelled_; });
+    if (ready_.empty() || cancelled_) {
+        return false;
+    }
+    batch = std::move(ready_.front());
+    ready_.pop_front();
+    not_full_.notify_one();
+    return true;
+}
+
+void MeasurementStream::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    ready_.clear();
+    not_full_.notify_all();
+    not_empty_.notify_all();
+}
+
+void MeasurementStream::join() {
+    if (producer_.joinable()) {
+        producer_.join();
+    }
+}
+
+bool MeasurementStream::finished() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+}
+
+bool MeasurementStream::succeeded() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_ && succeeded_;
+}
+
+std::string MeasurementStream::get_last_error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_error_;
+}
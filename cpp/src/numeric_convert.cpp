@@ -0,0 +1,81 @@
+#include "../include/numeric_convert.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STDF_CONVERT_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define STDF_CONVERT_NEON 1
+#include <arm_neon.h>
+#endif
+
+static void convert_scalar(const float* in, size_t count, double* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = in[i];
+    }
+}
+
+#ifdef STDF_CONVERT_X86
+static void convert_sse2(const float* in, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 values = _mm_loadu_ps(in + i);
+        _mm_storeu_pd(out + i, _mm_cvtps_pd(values));
+        _mm_storeu_pd(out + i + 2, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+    }
+    convert_scalar(in + i, count - i, out + i);
+}
+
+__attribute__((target("avx")))
+static void convert_avx(const float* in, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_pd(out + i, _mm256_cvtps_pd(_mm_loadu_ps(in + i)));
+        _mm256_storeu_pd(out + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(in + i + 4)));
+    }
+    convert_sse2(in + i, count - i, out + i);
+}
+#endif
+
+#ifdef STDF_CONVERT_NEON
+static void convert_neon(const float* in, size_t count, double* out) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t values = vld1q_f32(in + i);
+        vst1q_f64(out + i, vcvt_f64_f32(vget_low_f32(values)));
+        vst1q_f64(out + i + 2, vcvt_high_f64_f32(values));
+    }
+    convert_scalar(in + i, count - i, out + i);
+}
+#endif
+
+using ConvertKernel = void (*)(const float*, size_t, double*);
+
+struct ConvertChoice {
+    ConvertKernel convert;
+    const char* name;
+};
+
+static ConvertChoice choose_kernel() {
+#if defined(STDF_CONVERT_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) return {convert_avx, "avx"};
+    return {convert_sse2, "sse2"};
+#elif defined(STDF_CONVERT_NEON)
+    return {convert_neon, "neon"};
+#else
+    return {convert_scalar, "scalar"};
+#endif
+}
+
+static const ConvertChoice& kernel() {
+    static const ConvertChoice choice = choose_kernel();
+    return choice;
+}
+
+void convert_r4_to_double(const float* in, size_t count, double* out) {
+    kernel().convert(in, count, out);
+}
+
+const char* convert_r4_implementation() {
+    return kernel().name;
+}
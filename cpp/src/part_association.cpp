@@ -0,0 +1,123 @@
+#include "../include/part_association.h"
+#include "../include/work_stealing_pool.h"
+#include <functional>
+#include <algorithm>
+#include <cstring>
+
+PartAssociation::PartAssociation()
+    : orphaned_(0) {
+}
+
+PartAssociation::Lane& PartAssociation::lane_for(uint8_t head, uint8_t site) {
+    const uint32_t key = (static_cast<uint32_t>(head) << 8) | site;
+    uint32_t& slot = lane_of_[key];
+    if (slot == 0) {
+        lanes_.emplace_back();
+        lanes_.back().key = key;
+        lanes_.back().orphaned = 0;
+        slot = static_cast<uint32_t>(lanes_.size());
+    }
+    return lanes_[slot - 1];
+}
+
+// One site's PIR..PRR brackets; the tests pending on the site are always
+// the run of lane.tests since its last PIR or PRR
+void PartAssociation::walk_lane(const STDFColumnarStore& store, const std::vector<TestSite>& tests, Lane& lane) {
+    const std::vector<uint32_t>& pir_index = store.pir.record_index;
+    const std::vector<uint32_t>& prr_index = store.prr.record_index;
+
+    lane.part_first.reserve(lane.prr_rows.size());
+    lane.part_size.reserve(lane.prr_rows.size());
+
+    size_t i_test = 0, i_pir = 0, i_prr = 0;
+    size_t pending = 0;
+    const uint32_t done = UINT32_MAX;
+
+    while (i_test < lane.tests.size() || i_prr < lane.prr_rows.size()) {
+        uint32_t next_test = (i_test < lane.tests.size()) ? tests[lane.tests[i_test]].record_index : done;
+        uint32_t next_pir = (i_pir < lane.pir_rows.size()) ? pir_index[lane.pir_rows[i_pir]] : done;
+        uint32_t next_prr = (i_prr < lane.prr_rows.size()) ? prr_index[lane.prr_rows[i_prr]] : done;
+
+        if (next_pir <= next_test && next_pir <= next_prr) {
+            lane.orphaned += i_test - pending;
+            pending = i_test;
+            ++i_pir;
+        } else if (next_test <= next_prr) {
+            ++i_test;
+        } else {
+            lane.part_first.push_back(static_cast<uint32_t>(pending));
+            lane.part_size.push_back(static_cast<uint32_t>(i_test - pending));
+            pending = i_test;
+            ++i_prr;
+        }
+    }
+    lane.orphaned += i_test - pending;
+}
+
+void PartAssociation::build(const STDFColumnarStore& store, const std::vector<TestSite>& tests, size_t threads) {
+    clear();
+
+    const PIRColumns& pir = store.pir;
+    const PRRColumns& prr = store.prr;
+
+    // Route every row to its head/site lane, keeping file order per lane
+    if (lane_of_.empty()) {
+        lane_of_.assign(65536, 0);
+    }
+    for (uint32_t i = 0; i < tests.size(); ++i) {
+        lane_for(tests[i].head_num, tests[i].site_num).tests.push_back(i);
+    }
+    for (uint32_t row = 0; row < pir.size(); ++row) {
+        lane_for(pir.HEAD_NUM[row], pir.SITE_NUM[row]).pir_rows.push_back(row);
+    }
+    for (uint32_t row = 0; row < prr.size(); ++row) {
+        lane_for(prr.HEAD_NUM[row], prr.SITE_NUM[row]).prr_rows.push_back(row);
+    }
+
+    auto run = [&](const std::function<void(Lane&)>& work) {
+        if (threads <= 1 || lanes_.size() <= 1) {
+            for (Lane& lane : lanes_) {
+                work(lane);
+            }
+            return;
+        }
+        std::vector<std::function<void()>> tasks;
+        for (Lane& lane : lanes_) {
+            tasks.emplace_back([&work, &lane]() { work(lane); });
+        }
+        WorkStealingPool pool(std::min(threads, lanes_.size()));
+        pool.run(tasks);
+    };
+
+    run([&](Lane& lane) { walk_lane(store, tests, lane); });
+
+    // Parts keep PRR order; each lane then fills its own parts' slices
+    part_begin_.assign(prr.size() + 1, 0);
+    for (const Lane& lane : lanes_) {
+        orphaned_ += lane.orphaned;
+        for (size_t k = 0; k < lane.prr_rows.size(); ++k) {
+            part_begin_[lane.prr_rows[k] + 1] = lane.part_size[k];
+        }
+    }
+    for (size_t row = 0; row < prr.size(); ++row) {
+        part_begin_[row + 1] += part_begin_[row];
+    }
+    tests_.resize(part_begin_.back());
+
+    run([&](Lane& lane) {
+        for (size_t k = 0; k < lane.prr_rows.size(); ++k) {
+            std::copy_n(lane.tests.data() + lane.part_first[k], lane.part_size[k],
+                        tests_.data() + part_begin_[lane.prr_rows[k]]);
+        }
+    });
+}
+
+void PartAssociation::clear() {
+    for (const Lane& lane : lanes_) {
+        lane_of_[lane.key] = 0;
+    }
+    lanes_.clear();
+    part_begin_.clear();
+    tests_.clear();
+    orphaned_ = 0;
+}
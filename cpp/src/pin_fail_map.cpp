@@ -0,0 +1,358 @@
+#include "../include/pin_fail_map.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STDF_BITSET_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define STDF_BITSET_NEON 1
+#include <arm_neon.h>
+#endif
+
+static size_t popcount64(uint64_t value) {
+    return static_cast<size_t>(__builtin_popcountll(value));
+}
+
+static size_t count_scalar(const uint8_t* bits, size_t bytes) {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bits + i, 8);
+        count += popcount64(word);
+    }
+    for (; i < bytes; ++i) {
+        count += popcount64(bits[i]);
+    }
+    return count;
+}
+
+static void or_scalar(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[i] |= src[i];
+    }
+}
+
+static void and_scalar(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        dst[i] &= src[i];
+    }
+}
+
+// Fail maps are sparse: zero words are skipped and set bits visited one by one
+static void accumulate_bytes_scalar(uint32_t* counts, const uint8_t* bits, size_t bytes) {
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bits + i, 8);
+        for (; word != 0; word &= word - 1) {
+            // Bytes are little-endian bit order within the field, so byte k of
+            // the word is field byte i + k on either host order
+            size_t bit = static_cast<size_t>(__builtin_ctzll(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            bit = (7 - bit / 8) * 8 + bit % 8;
+#endif
+            counts[8 * i + bit]++;
+        }
+    }
+    for (; i < bytes; ++i) {
+        for (unsigned byte = bits[i]; byte != 0; byte &= byte - 1) {
+            counts[8 * i + static_cast<size_t>(__builtin_ctz(byte))]++;
+        }
+    }
+}
+
+#ifdef STDF_BITSET_X86
+static size_t count_bytes_sse2(const uint8_t* bits, size_t bytes, size_t& done) {
+    const __m128i m1 = _mm_set1_epi8(0x55);
+    const __m128i m2 = _mm_set1_epi8(0x33);
+    const __m128i m4 = _mm_set1_epi8(0x0F);
+    __m128i total = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i));
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m1));
+        v = _mm_add_epi8(_mm_and_si128(v, m2), _mm_and_si128(_mm_srli_epi16(v, 2), m2));
+        v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), m4);
+        total = _mm_add_epi64(total, _mm_sad_epu8(v, _mm_setzero_si128()));
+    }
+    done = i;
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), total);
+    return static_cast<size_t>(lanes[0] + lanes[1]);
+}
+
+static size_t count_sse2(const uint8_t* bits, size_t bytes) {
+    size_t done = 0;
+    size_t count = count_bytes_sse2(bits, bytes, done);
+    return count + count_scalar(bits + done, bytes - done);
+}
+
+static void or_sse2(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(a, b));
+    }
+    or_scalar(dst + i, src + i, bytes - i);
+}
+
+static void and_sse2(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+    }
+    and_scalar(dst + i, src + i, bytes - i);
+}
+
+// Nibble lookup popcount (pshufb), summed per 64-bit lane with psadbw
+__attribute__((target("avx2")))
+static size_t count_avx2(const uint8_t* bits, size_t bytes) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+        __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low_mask));
+        __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask));
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(low, high), _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + count_sse2(bits + i, bytes - i);
+}
+
+__attribute__((target("avx2")))
+static void or_avx2(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+    }
+    or_sse2(dst + i, src + i, bytes - i);
+}
+
+__attribute__((target("avx2")))
+static void and_avx2(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+    }
+    and_sse2(dst + i, src + i, bytes - i);
+}
+
+// Zero words are skipped; each non-zero byte adds its 8 bits to 8 counts
+// at once (variable shift, mask, add)
+__attribute__((target("avx2")))
+static void accumulate_bytes_avx2(uint32_t* counts, const uint8_t* bits, size_t bytes) {
+    const __m256i shifts = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i one = _mm256_set1_epi32(1);
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bits + i, 8);
+        if (word == 0) {
+            continue;
+        }
+        for (size_t k = 0; k < 8; ++k) {
+            if (bits[i + k] == 0) {
+                continue;
+            }
+            __m256i* target = reinterpret_cast<__m256i*>(counts + 8 * (i + k));
+            __m256i expanded = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(bits[i + k]), shifts), one);
+            _mm256_storeu_si256(target, _mm256_add_epi32(_mm256_loadu_si256(target), expanded));
+        }
+    }
+    accumulate_bytes_scalar(counts + 8 * i, bits + i, bytes - i);
+}
+#endif
+
+#ifdef STDF_BITSET_NEON
+static size_t count_neon(const uint8_t* bits, size_t bytes) {
+    uint64x2_t total = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        total = vaddq_u64(total, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(vld1q_u8(bits + i))))));
+    }
+    return static_cast<size_t>(vgetq_lane_u64(total, 0) + vgetq_lane_u64(total, 1)) +
+           count_scalar(bits + i, bytes - i);
+}
+
+static void or_neon(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, vorrq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    }
+    or_scalar(dst + i, src + i, bytes - i);
+}
+
+static void and_neon(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        vst1q_u8(dst + i, vandq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    }
+    and_scalar(dst + i, src + i, bytes - i);
+}
+#endif
+
+using CountKernel = size_t (*)(const uint8_t*, size_t);
+using CombineKernel = void (*)(uint8_t*, const uint8_t*, size_t);
+using AccumulateKernel = void (*)(uint32_t*, const uint8_t*, size_t);
+
+struct BitsetChoice {
+    CountKernel count;
+    CombineKernel bit_or;
+    CombineKernel bit_and;
+    AccumulateKernel accumulate;
+    const char* name;
+};
+
+static BitsetChoice choose_kernel() {
+#if defined(STDF_BITSET_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {count_avx2, or_avx2, and_avx2, accumulate_bytes_avx2, "avx2"};
+    return {count_sse2, or_sse2, and_sse2, accumulate_bytes_scalar, "sse2"};
+#elif defined(STDF_BITSET_NEON)
+    return {count_neon, or_neon, and_neon, accumulate_bytes_scalar, "neon"};
+#else
+    return {count_scalar, or_scalar, and_scalar, accumulate_bytes_scalar, "scalar"};
+#endif
+}
+
+static const BitsetChoice& kernel() {
+    static const BitsetChoice choice = choose_kernel();
+    return choice;
+}
+
+size_t bitset_count(const uint8_t* bits, size_t bytes) {
+    return kernel().count(bits, bytes);
+}
+
+void bitset_or(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    kernel().bit_or(dst, src, bytes);
+}
+
+void bitset_and(uint8_t* dst, const uint8_t* src, size_t bytes) {
+    kernel().bit_and(dst, src, bytes);
+}
+
+void bitset_accumulate(uint32_t* counts, const uint8_t* bits, size_t bit_count) {
+    const size_t full_bytes = bit_count / 8;
+    kernel().accumulate(counts, bits, full_bytes);
+    const uint8_t tail = bit_count % 8 ? bits[full_bytes] & ((1u << (bit_count % 8)) - 1) : 0;
+    accumulate_bytes_scalar(counts + 8 * full_bytes, &tail, tail ? 1 : 0);
+}
+
+const char* bitset_implementation() {
+    return kernel().name;
+}
+
+PartPinFails& PinFailMap::open_part(uint8_t head_num, uint8_t site_num) {
+    PartPinFails& part = open_parts_[static_cast<uint16_t>((head_num << 8) | site_num)];
+    part.head_num = head_num;
+    part.site_num = site_num;
+    return part;
+}
+
+void PinFailMap::add_ftr(uint8_t head_num, uint8_t site_num, const STDFBitsView& fail_pins) {
+    ftr_count_++;
+    PartPinFails& part = open_part(head_num, site_num);
+    part.ftr_count++;
+
+    const size_t full_bytes = fail_pins.bit_count / 8;
+    const uint8_t tail = fail_pins.bit_count % 8
+                             ? fail_pins.bytes[full_bytes] & ((1u << (fail_pins.bit_count % 8)) - 1) : 0;
+    if (fail_pins.empty() || (tail == 0 && bitset_count(fail_pins.bytes, full_bytes) == 0)) {
+        return;
+    }
+    part.failed_ftrs++;
+    if (part.fail_pins.size() < fail_pins.byte_count()) {
+        part.fail_pins.resize(fail_pins.byte_count(), 0);
+    }
+    bitset_or(part.fail_pins.data(), fail_pins.bytes, full_bytes);
+    if (tail) {
+        part.fail_pins[full_bytes] |= tail;
+    }
+
+    if (ftr_fail_counts_.size() < fail_pins.bit_count) {
+        ftr_fail_counts_.resize(fail_pins.bit_count, 0);
+        part_fail_counts_.resize(fail_pins.bit_count, 0);
+    }
+    bitset_accumulate(ftr_fail_counts_.data(), fail_pins.bytes, fail_pins.bit_count);
+}
+
+void PinFailMap::end_part(uint8_t head_num, uint8_t site_num, uint16_t hard_bin, uint16_t soft_bin,
+                          std::string_view part_id) {
+    PartPinFails part = std::move(open_part(head_num, site_num));
+    open_parts_.erase(static_cast<uint16_t>((head_num << 8) | site_num));
+    part.hard_bin = hard_bin;
+    part.soft_bin = soft_bin;
+    part.part_id.assign(part_id.data(), part_id.size());
+    // Tail bits are clear and no map is wider than pin_count() bits
+    bitset_accumulate(part_fail_counts_.data(), part.fail_pins.data(),
+                      std::min(8 * part.fail_pins.size(), part_fail_counts_.size()));
+    parts_.push_back(std::move(part));
+}
+
+void PinFailMap::add(STDFRecordView& view) {
+    if (view.type() == STDFRecordType::FTR) {
+        add_ftr(static_cast<uint8_t>(view.get_unsigned("HEAD_NUM")), static_cast<uint8_t>(view.get_unsigned("SITE_NUM")),
+                view.get_bits("FAIL_PIN"));
+    } else if (view.type() == STDFRecordType::PRR) {
+        end_part(static_cast<uint8_t>(view.get_unsigned("HEAD_NUM")), static_cast<uint8_t>(view.get_unsigned("SITE_NUM")),
+                 static_cast<uint16_t>(view.get_unsigned("HARD_BIN")), static_cast<uint16_t>(view.get_unsigned("SOFT_BIN")),
+                 view.get_string("PART_ID"));
+    }
+}
+
+bool PinFailMap::add_file(const std::string& filepath, STDFParserBackend backend) {
+    STDFParser parser;
+    parser.set_backend(backend);
+    parser.set_enabled_record_types({STDFRecordType::FTR, STDFRecordType::PRR});
+    if (!parser.stream_views(filepath, [this](STDFRecordView& view) { add(view); })) {
+        last_error_ = "Failed to read STDF file " + filepath;
+        return false;
+    }
+    // A part left open at the end of a file does not continue in the next one
+    unfinished_parts_ += open_parts_.size();
+    open_parts_.clear();
+    return true;
+}
+
+std::vector<uint8_t> PinFailMap::common_fail_pins() const {
+    std::vector<uint8_t> common;
+    bool first = true;
+    for (const PartPinFails& part : parts_) {
+        if (part.failed_ftrs == 0) {
+            continue;
+        }
+        if (first) {
+            common = part.fail_pins;
+            first = false;
+            continue;
+        }
+        // Pins past the end of a shorter map did not fail on that part
+        common.resize(std::min(common.size(), part.fail_pins.size()));
+        bitset_and(common.data(), part.fail_pins.data(), common.size());
+    }
+    return common;
+}
+
+void PinFailMap::clear() {
+    open_parts_.clear();
+    parts_.clear();
+    ftr_fail_counts_.clear();
+    part_fail_counts_.clear();
+    ftr_count_ = 0;
+    unfinished_parts_ = 0;
+    last_error_.clear();
+}
@@ -0,0 +1,107 @@
+#include "../include/pixel_name.h"
+#include <limits>
+
+static const std::string_view PIXEL_TAG = "Pixel=R";
+
+static bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Reads \d+ at pos; value saturates to -1 once it no longer fits int32
+static bool read_number(std::string_view text, size_t& pos, int64_t& value) {
+    const size_t start = pos;
+    value = 0;
+    while (pos < text.size() && is_digit(text[pos])) {
+        if (value >= 0) {
+            value = value * 10 + (text[pos] - '0');
+            if (value > std::numeric_limits<int32_t>::max()) value = -1;
+        }
+        ++pos;
+    }
+    return pos > start;
+}
+
+// Matches "Pixel=R<digits>C<digits>" at pos (greedy, like the old regex);
+// end is one past the last column digit
+static bool match_tag(std::string_view text, size_t pos, size_t& end, int64_t& row, int64_t& col) {
+    if (text.compare(pos, PIXEL_TAG.size(), PIXEL_TAG) != 0) return false;
+    pos += PIXEL_TAG.size();
+    if (!read_number(text, pos, row)) return false;
+    if (pos >= text.size() || text[pos] != 'C') return false;
+    ++pos;
+    if (!read_number(text, pos, col)) return false;
+    end = pos;
+    return true;
+}
+
+bool is_pixel_name(std::string_view alarm_id, std::string_view test_txt) {
+    return alarm_id.find("Pixel=") != std::string_view::npos ||
+           test_txt.find("Pixel=") != std::string_view::npos;
+}
+
+void parse_pixel_name(std::string_view name, PixelName& result) {
+    result.cleaned.clear();
+    result.x = 0;
+    result.y = 0;
+    result.has_tag = false;
+
+    // Copy everything except ";<tag>" runs; the first tag seen (with or
+    // without the ';') supplies the coordinates
+    size_t copied = 0;
+    size_t pos = 0;
+    size_t tag;
+    while ((tag = name.find(PIXEL_TAG, pos)) != std::string_view::npos) {
+        size_t end;
+        int64_t row, col;
+        if (!match_tag(name, tag, end, row, col)) {
+            pos = tag + 1;
+            continue;
+        }
+
+        if (!result.has_tag) {
+            result.has_tag = true;
+            if (row >= 0 && col >= 0) {
+                result.x = static_cast<int32_t>(col);
+                result.y = static_cast<int32_t>(row);
+            }
+        }
+
+        if (tag > copied && name[tag - 1] == ';') {
+            result.cleaned.append(name.data() + copied, tag - 1 - copied);
+            copied = end;
+        }
+        pos = end;
+    }
+    result.cleaned.append(name.data() + copied, name.size() - copied);
+
+    // Then drop a leading "<tag>;" from what is left
+    if (result.has_tag) {
+        size_t end;
+        int64_t row, col;
+        if (match_tag(result.cleaned, 0, end, row, col) && end < result.cleaned.size() &&
+            result.cleaned[end] == ';') {
+            result.cleaned.erase(0, end + 1);
+        }
+    }
+}
+
+bool extract_pixel_coordinates(std::string_view text, int32_t& x, int32_t& y) {
+    x = 0;
+    y = 0;
+
+    size_t pos = 0;
+    size_t tag;
+    while ((tag = text.find(PIXEL_TAG, pos)) != std::string_view::npos) {
+        size_t end;
+        int64_t row, col;
+        if (match_tag(text, tag, end, row, col)) {
+            if (row >= 0 && col >= 0) {
+                x = static_cast<int32_t>(col);
+                y = static_cast<int32_t>(row);
+            }
+            return true;
+        }
+        pos = tag + 1;
+    }
+    return false;
+}
@@ -1,9 +1,35 @@
+#define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include "../include/stdf_parser.h"
 #include "../include/dynamic_field_extractor.h"
 #include "../include/ultra_fast_processor.h"
+#include "../include/batch_ingest_engine.h"
+#include "../include/device_discovery.h"
+#include "../include/clickhouse_encoder.h"
+#include "../include/measurement_stream.h"
+#include "../include/insert_pipeline.h"
+#include "../include/ingest_daemon.h"
+#include "../include/stdf_record_index.h"
+#include "../include/columnar_cache.h"
+#include "../include/arrow_export.h"
+#include "../include/stdf_binary_parser.h"
+#include "../include/stdf_record_view.h"
+#include "../include/pin_fail_map.h"
+#include "../include/stdf_tail_reader.h"
+#include "../include/work_stealing_pool.h"
+#include "../include/file_schedule.h"
+#include "../include/file_prefetcher.h"
+#include "../include/pixel_name.h"
+#include "../include/python_measurements.h"
+#include "../include/console_log.h"
+#include "../include/instrumentation.h"
 #include <iostream>
 #include <vector>
+#include <memory>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <algorithm>
 
 // Python extension module for STDF parsing
 
@@ -12,6 +38,571 @@ static PyObject* safe_unicode_from_string(const std::string& str) {
     return PyUnicode_FromStringAndSize(str.c_str(), str.length());
 }
 
+// Stores value under key and drops our reference (PyDict_SetItemString does not steal)
+static void set_dict_item(PyObject* dict, const char* key, PyObject* value) {
+    if (value) {
+        PyDict_SetItemString(dict, key, value);
+        Py_DECREF(value);
+    }
+}
+
+// Py_BEGIN/END_ALLOW_THREADS as a scope: native parsing and processing run
+// without the GIL, and it is taken back before any Python object is touched,
+// including when an exception unwinds out of the scope
+class ScopedGILRelease {
+public:
+    ScopedGILRelease() : state_(PyEval_SaveThread()) {}
+    ~ScopedGILRelease() { PyEval_RestoreThread(state_); }
+    
+    ScopedGILRelease(const ScopedGILRelease&) = delete;
+    ScopedGILRelease& operator=(const ScopedGILRelease&) = delete;
+    
+private:
+    PyThreadState* state_;
+};
+
+// Map a Python-side backend name onto STDFParserBackend
+static bool parse_backend_name(const char* name, STDFParserBackend& backend) {
+    if (!name || std::strcmp(name, "libstdf") == 0) {
+        backend = STDFParserBackend::LIBSTDF;
+        return true;
+    }
+    if (std::strcmp(name, "mmap") == 0) {
+        backend = STDFParserBackend::MMAP;
+        return true;
+    }
+    PyErr_Format(PyExc_ValueError, "Unknown parser backend '%s' (expected 'libstdf' or 'mmap')", name);
+    return false;
+}
+
+// Optional list/tuple of str (test patterns, paths, hashes); None leaves given false
+static bool parse_string_list(PyObject* object, const char* what, std::vector<std::string>& strings, bool& given) {
+    given = false;
+    if (!object || object == Py_None) {
+        return true;
+    }
+    
+    PyObject* sequence = PyUnicode_Check(object) ? nullptr : PySequence_Fast(object, "expected a list of str");
+    if (!sequence) {
+        PyErr_Clear();
+        PyErr_Format(PyExc_TypeError, "%s must be a list of str", what);
+        return false;
+    }
+    
+    Py_ssize_t size = PySequence_Fast_GET_SIZE(sequence);
+    for (Py_ssize_t i = 0; i < size; ++i) {
+        PyObject* item = PySequence_Fast_GET_ITEM(sequence, i);
+        Py_ssize_t length = 0;
+        const char* text = PyUnicode_Check(item) ? PyUnicode_AsUTF8AndSize(item, &length) : nullptr;
+        if (!text) {
+            Py_DECREF(sequence);
+            if (!PyErr_Occurred()) {
+                PyErr_Format(PyExc_TypeError, "%s must be a list of str", what);
+            }
+            return false;
+        }
+        strings.emplace_back(text, static_cast<size_t>(length));
+    }
+    
+    Py_DECREF(sequence);
+    given = true;
+    return true;
+}
+
+// Optional test selection patterns; None keeps the default
+static bool parse_test_patterns(PyObject* object, std::vector<std::string>& patterns, bool& given) {
+    return parse_string_list(object, "test_patterns", patterns, given);
+}
+
+// List of (name, id) tuples -> ID mappings; malformed entries are skipped
+static void parse_id_mappings(PyObject* list, std::vector<std::pair<std::string, uint32_t>>& mappings) {
+    if (!list || !PyList_Check(list)) {
+        return;
+    }
+    
+    Py_ssize_t size = PyList_Size(list);
+    for (Py_ssize_t i = 0; i < size; ++i) {
+        PyObject* tuple = PyList_GetItem(list, i);
+        if (PyTuple_Check(tuple) && PyTuple_Size(tuple) == 2) {
+            PyObject* name_object = PyTuple_GetItem(tuple, 0);
+            PyObject* id_object = PyTuple_GetItem(tuple, 1);
+            
+            if (PyUnicode_Check(name_object) && PyLong_Check(id_object)) {
+                const char* name = PyUnicode_AsUTF8(name_object);
+                uint32_t id = static_cast<uint32_t>(PyLong_AsUnsignedLong(id_object));
+                mappings.emplace_back(name, id);
+            }
+        }
+    }
+}
+
+// ID mappings -> list of (name, id) tuples
+static PyObject* id_mappings_to_list(const std::vector<std::pair<std::string, uint32_t>>& mappings) {
+    PyObject* list = PyList_New(mappings.size());
+    for (size_t i = 0; i < mappings.size(); ++i) {
+        PyObject* mapping = PyTuple_New(2);
+        PyTuple_SetItem(mapping, 0, PyUnicode_FromString(mappings[i].first.c_str()));
+        PyTuple_SetItem(mapping, 1, PyLong_FromUnsignedLong(mappings[i].second));
+        PyList_SetItem(list, i, mapping);
+    }
+    return list;
+}
+
+static PyObject* string_list(const std::vector<std::string>& strings) {
+    PyObject* list = PyList_New(strings.size());
+    for (size_t i = 0; list && i < strings.size(); ++i) {
+        PyList_SetItem(list, i, safe_unicode_from_string(strings[i]));
+    }
+    return list;
+}
+
+// value, or None when absent
+static PyObject* optional_float(bool present, double value) {
+    if (present) {
+        return PyFloat_FromDouble(value);
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+// Per-parameter summaries -> list of dicts (cpk is NaN without limits)
+static PyObject* test_summaries_to_list(const std::vector<TestSummary>& summaries) {
+    PyObject* list = PyList_New(summaries.size());
+    for (size_t i = 0; list && i < summaries.size(); ++i) {
+        const TestSummary& summary = summaries[i];
+        PyObject* item = PyDict_New();
+        set_dict_item(item, "wtp_id", PyLong_FromUnsignedLong(summary.wtp_id));
+        set_dict_item(item, "wtp_param_name", PyUnicode_FromString_Safe(summary.wtp_param_name));
+        set_dict_item(item, "units", PyUnicode_FromString_Safe(summary.units));
+        set_dict_item(item, "test_num", PyLong_FromUnsignedLong(summary.test_num));
+        set_dict_item(item, "count", PyLong_FromUnsignedLongLong(summary.stats.count));
+        set_dict_item(item, "mean", PyFloat_FromDouble(summary.stats.mean));
+        set_dict_item(item, "stddev", PyFloat_FromDouble(summary.stats.stddev()));
+        set_dict_item(item, "min", PyFloat_FromDouble(summary.stats.min));
+        set_dict_item(item, "max", PyFloat_FromDouble(summary.stats.max));
+        set_dict_item(item, "lo_limit", optional_float(summary.has_lo_limit, summary.lo_limit));
+        set_dict_item(item, "hi_limit", optional_float(summary.has_hi_limit, summary.hi_limit));
+        set_dict_item(item, "passed", PyLong_FromUnsignedLongLong(summary.stats.passed));
+        set_dict_item(item, "yield", PyFloat_FromDouble(summary.yield()));
+        set_dict_item(item, "cpk", PyFloat_FromDouble(summary.cpk()));
+        PyList_SetItem(list, i, item);
+    }
+    return list;
+}
+
+// Bin counts -> list of dicts; reported_count is None without an HBR/SBR
+static PyObject* bin_counts_to_list(const std::vector<BinCount>& bins) {
+    PyObject* list = PyList_New(bins.size());
+    for (size_t i = 0; list && i < bins.size(); ++i) {
+        const BinCount& bin = bins[i];
+        PyObject* item = PyDict_New();
+        set_dict_item(item, "kind", PyUnicode_FromString(bin.soft ? "soft" : "hard"));
+        set_dict_item(item, "head_num", PyLong_FromUnsignedLong(bin.head_num));
+        set_dict_item(item, "site_num", PyLong_FromUnsignedLong(bin.site_num));
+        set_dict_item(item, "bin_num", PyLong_FromUnsignedLong(bin.bin_num));
+        set_dict_item(item, "part_count", PyLong_FromUnsignedLong(bin.part_count));
+        if (bin.reported) {
+            set_dict_item(item, "reported_count", PyLong_FromUnsignedLong(bin.reported_count));
+        } else {
+            Py_INCREF(Py_None);
+            set_dict_item(item, "reported_count", Py_None);
+        }
+        set_dict_item(item, "pass_fail", PyUnicode_FromStringAndSize(&bin.pass_fail, 1));
+        set_dict_item(item, "matches", PyBool_FromLong(bin.matches()));
+        PyList_SetItem(list, i, item);
+    }
+    return list;
+}
+
+static PyObject* site_yields_to_list(const std::vector<SiteYield>& yields) {
+    PyObject* list = PyList_New(yields.size());
+    for (size_t i = 0; list && i < yields.size(); ++i) {
+        PyObject* item = PyDict_New();
+        set_dict_item(item, "head_num", PyLong_FromUnsignedLong(yields[i].head_num));
+        set_dict_item(item, "site_num", PyLong_FromUnsignedLong(yields[i].site_num));
+        set_dict_item(item, "part_count", PyLong_FromUnsignedLong(yields[i].part_count));
+        set_dict_item(item, "good_count", PyLong_FromUnsignedLong(yields[i].good_count));
+        set_dict_item(item, "yield", PyFloat_FromDouble(yields[i].yield()));
+        PyList_SetItem(list, i, item);
+    }
+    return list;
+}
+
+// Per-file results of the insert pipeline (rows_inserted per file)
+static PyObject* file_ingest_stats_to_list(const std::vector<FileIngestStats>& files) {
+    PyObject* list = PyList_New(files.size());
+    for (size_t i = 0; list && i < files.size(); ++i) {
+        const FileIngestStats& stats = files[i];
+        PyObject* item = PyDict_New();
+        set_dict_item(item, "path", safe_unicode_from_string(stats.path));
+        set_dict_item(item, "success", PyBool_FromLong(stats.success));
+        set_dict_item(item, "skipped", PyBool_FromLong(stats.skipped));
+        set_dict_item(item, "error", safe_unicode_from_string(stats.error));
+        set_dict_item(item, "rows_inserted", PyLong_FromSize_t(stats.measurements));
+        set_dict_item(item, "total_records", PyLong_FromSize_t(stats.total_records));
+        set_dict_item(item, "parsing_time", PyFloat_FromDouble(stats.parsing_time));
+        set_dict_item(item, "processing_time", PyFloat_FromDouble(stats.processing_time));
+        set_dict_item(item, "file_hash", safe_unicode_from_string(stats.file_hash));
+        PyList_SetItem(list, i, item);
+    }
+    return list;
+}
+
+// Single-file columnar result; the processor owns the text behind the
+// batch's dictionaries
+struct ColumnarResult {
+    UltraFastProcessor processor;
+    MeasurementBatch batch;
+};
+
+// Read-only one-dimensional buffer over one column of a batch. The owner
+// (ColumnarResult or BatchIngestEngine) stays alive while any column is exported.
+struct ColumnBufferObject {
+    PyObject_HEAD
+    std::shared_ptr<const void>* owner;
+    void* data;
+    Py_ssize_t length;
+    Py_ssize_t itemsize;
+    const char* format;
+};
+
+static PyTypeObject* ColumnBufferType = nullptr;
+
+template<typename T> struct BufferFormat;
+template<> struct BufferFormat<uint8_t> { static constexpr const char* value = "B"; };
+template<> struct BufferFormat<int32_t> { static constexpr const char* value = "i"; };
+template<> struct BufferFormat<uint32_t> { static constexpr const char* value = "I"; };
+template<> struct BufferFormat<double> { static constexpr const char* value = "d"; };
+
+static void column_buffer_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    delete reinterpret_cast<ColumnBufferObject*>(self)->owner;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static int column_buffer_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    auto* column = reinterpret_cast<ColumnBufferObject*>(self);
+    if (flags & PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "measurement columns are read-only");
+        view->obj = nullptr;
+        return -1;
+    }
+    
+    view->buf = column->data;
+    view->obj = self;
+    Py_INCREF(self);
+    view->len = column->length * column->itemsize;
+    view->readonly = 1;
+    view->itemsize = column->itemsize;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(column->format) : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &column->length : nullptr;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &column->itemsize : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static Py_ssize_t column_buffer_length(PyObject* self) {
+    return reinterpret_cast<ColumnBufferObject*>(self)->length;
+}
+
+static PyType_Slot column_buffer_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Read-only measurement column (buffer protocol; wrap with numpy.asarray)")},
+    {Py_tp_dealloc, reinterpret_cast<void*>(column_buffer_dealloc)},
+    {Py_bf_getbuffer, reinterpret_cast<void*>(column_buffer_getbuffer)},
+    {Py_sq_length, reinterpret_cast<void*>(column_buffer_length)},
+    {0, nullptr}
+};
+
+static PyType_Spec column_buffer_spec = {
+    "stdf_parser_cpp.ColumnBuffer",
+    sizeof(ColumnBufferObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    column_buffer_slots
+};
+
+// Iterator over one file's measurements, batch by batch, from a native
+// producer thread (MeasurementStream)
+struct MeasurementIteratorObject {
+    PyObject_HEAD
+    MeasurementStream* stream;
+};
+
+static PyTypeObject* MeasurementIteratorType = nullptr;
+
+static void measurement_iterator_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    MeasurementStream* stream = reinterpret_cast<MeasurementIteratorObject*>(self)->stream;
+    if (stream) {
+        // Waits for the producer to notice the cancel
+        ScopedGILRelease released;
+        delete stream;
+    }
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyObject* measurement_iterator_next(PyObject* self) {
+    MeasurementStream* stream = reinterpret_cast<MeasurementIteratorObject*>(self)->stream;
+    MeasurementBatch batch;
+    bool has_batch;
+    {
+        ScopedGILRelease released;
+        has_batch = stream->next(batch);
+    }
+    if (has_batch) {
+        return measurement_batch_to_tuple_list(batch);
+    }
+    if (stream->finished() && !stream->succeeded() && !stream->get_last_error().empty()) {
+        PyErr_SetString(PyExc_RuntimeError, stream->get_last_error().c_str());
+    }
+    return nullptr;  // StopIteration
+}
+
+static PyObject* measurement_iterator_stats(PyObject* self, PyObject* /*args*/) {
+    MeasurementStream* stream = reinterpret_cast<MeasurementIteratorObject*>(self)->stream;
+    if (!stream->finished()) {
+        PyErr_SetString(PyExc_RuntimeError, "statistics are available once the iterator is exhausted");
+        return nullptr;
+    }
+    
+    const UltraFastProcessor& processor = stream->processor();
+    const FastIDManager& id_manager = processor.get_id_manager();
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    PyDict_SetItemString(result_dict, "success", PyBool_FromLong(stream->succeeded()));
+    PyDict_SetItemString(result_dict, "total_records", 
+                       PyLong_FromSize_t(processor.get_total_records()));
+    PyDict_SetItemString(result_dict, "total_measurements", 
+                       PyLong_FromSize_t(processor.get_processed_measurements()));
+    PyDict_SetItemString(result_dict, "parsing_time", 
+                       PyFloat_FromDouble(processor.get_parsing_time()));
+    PyDict_SetItemString(result_dict, "processing_time", 
+                       PyFloat_FromDouble(processor.get_processing_time()));
+    PyDict_SetItemString(result_dict, "file_hash", safe_unicode_from_string(processor.get_file_hash()));
+    PyDict_SetItemString(result_dict, "new_device_mappings", id_mappings_to_list(id_manager.get_new_device_mappings()));
+    PyDict_SetItemString(result_dict, "new_param_mappings", id_mappings_to_list(id_manager.get_new_param_mappings()));
+    return result_dict;
+}
+
+static PyMethodDef measurement_iterator_methods[] = {
+    {"stats", measurement_iterator_stats, METH_NOARGS,
+     "Totals, timings, file hash and new ID mappings (after exhaustion)"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot measurement_iterator_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Yields lists of measurement tuples while the file is still being parsed")},
+    {Py_tp_dealloc, reinterpret_cast<void*>(measurement_iterator_dealloc)},
+    {Py_tp_iter, reinterpret_cast<void*>(PyObject_SelfIter)},
+    {Py_tp_iternext, reinterpret_cast<void*>(measurement_iterator_next)},
+    {Py_tp_methods, measurement_iterator_methods},
+    {0, nullptr}
+};
+
+static PyType_Spec measurement_iterator_spec = {
+    "stdf_parser_cpp.MeasurementIterator",
+    sizeof(MeasurementIteratorObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    measurement_iterator_slots
+};
+
+template<typename T>
+static PyObject* new_column_buffer(const std::shared_ptr<const void>& owner, const std::vector<T>& values) {
+    static char empty = 0;  // Zero-length columns still need a non-null buffer
+    
+    auto* column = PyObject_New(ColumnBufferObject, ColumnBufferType);
+    if (!column) return nullptr;
+    column->owner = new std::shared_ptr<const void>(owner);
+    column->data = values.empty() ? static_cast<void*>(&empty) : const_cast<T*>(values.data());
+    column->length = static_cast<Py_ssize_t>(values.size());
+    column->itemsize = sizeof(T);
+    column->format = BufferFormat<T>::value;
+    return reinterpret_cast<PyObject*>(column);
+}
+
+// Numeric field -> ColumnBuffer of values
+template<typename T, typename Convert>
+static PyObject* export_column(const std::shared_ptr<const void>& owner, const MeasurementColumn<T>& column, Convert) {
+    return new_column_buffer(owner, column.values);
+}
+
+// String field -> (ColumnBuffer of uint32 codes, list of dictionary str)
+template<typename Convert>
+static PyObject* export_column(const std::shared_ptr<const void>& owner,
+                               const MeasurementColumn<std::string_view>& column, Convert convert) {
+    PyObject* dictionary = PyList_New(column.dictionary.size());
+    if (!dictionary) return nullptr;
+    for (size_t i = 0; i < column.dictionary.size(); ++i) {
+        PyObject* entry = convert(column.dictionary[i]);
+        if (!entry) {
+            Py_DECREF(dictionary);
+            return nullptr;
+        }
+        PyList_SetItem(dictionary, i, entry);
+    }
+    
+    PyObject* codes = new_column_buffer(owner, column.codes);
+    if (!codes) {
+        Py_DECREF(dictionary);
+        return nullptr;
+    }
+    
+    PyObject* pair = PyTuple_Pack(2, codes, dictionary);
+    Py_DECREF(codes);
+    Py_DECREF(dictionary);
+    return pair;
+}
+
+// 🚀 MACRO-DRIVEN: one entry per MEASUREMENT_FIELD, in field order
+static PyObject* measurement_batch_to_columns(const std::shared_ptr<const void>& owner, const MeasurementBatch& batch) {
+    StageTimer timer(InstrumentedStage::PYTHON_CONVERSION);
+    PyObject* columns = PyDict_New();
+    if (!columns) return nullptr;
+
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        { \
+            PyObject* column = export_column(owner, batch.name, python_conversion); \
+            if (!column || PyDict_SetItemString(columns, #name, column) < 0) { \
+                Py_XDECREF(column); \
+                Py_DECREF(columns); \
+                return nullptr; \
+            } \
+            Py_DECREF(column); \
+        }
+    #include "../include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    
+    return columns;
+}
+
+// Arrow record batch over a MeasurementBatch. Implements the Arrow PyCapsule
+// interface (__arrow_c_schema__ / __arrow_c_array__), so pyarrow, Polars and
+// DuckDB import it without copying numeric columns or string codes.
+struct ArrowBatchObject {
+    PyObject_HEAD
+    std::shared_ptr<const void>* owner;
+    const MeasurementBatch* batch;
+};
+
+static PyTypeObject* ArrowBatchType = nullptr;
+
+static void arrow_batch_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    delete reinterpret_cast<ArrowBatchObject*>(self)->owner;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static void arrow_schema_capsule_destructor(PyObject* capsule) {
+    auto* schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(capsule, "arrow_schema"));
+    if (schema->release) {
+        schema->release(schema);
+    }
+    delete schema;
+}
+
+static void arrow_array_capsule_destructor(PyObject* capsule) {
+    auto* array = static_cast<ArrowArray*>(PyCapsule_GetPointer(capsule, "arrow_array"));
+    if (array->release) {
+        array->release(array);
+    }
+    delete array;
+}
+
+static PyObject* arrow_schema_capsule() {
+    auto* schema = new ArrowSchema;
+    ArrowBatchExporter::export_schema(schema);
+    PyObject* capsule = PyCapsule_New(schema, "arrow_schema", arrow_schema_capsule_destructor);
+    if (!capsule) {
+        schema->release(schema);
+        delete schema;
+    }
+    return capsule;
+}
+
+static PyObject* arrow_batch_schema(PyObject* /*self*/, PyObject* /*args*/) {
+    return arrow_schema_capsule();
+}
+
+static PyObject* arrow_batch_array(PyObject* self, PyObject* args, PyObject* kwargs) {
+    static const char* keywords[] = {"requested_schema", nullptr};
+    PyObject* requested_schema = Py_None;
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", const_cast<char**>(keywords), &requested_schema)) {
+        return nullptr;
+    }
+    // The batch has one layout; a requested schema other than None is ignored
+    // (the consumer casts if it needs something else)
+    
+    auto* object = reinterpret_cast<ArrowBatchObject*>(self);
+    auto* array = new ArrowArray;
+    std::string error;
+    if (!ArrowBatchExporter::export_array(*object->owner, *object->batch, array, &error)) {
+        delete array;
+        PyErr_SetString(PyExc_OverflowError, error.c_str());
+        return nullptr;
+    }
+    PyObject* array_capsule = PyCapsule_New(array, "arrow_array", arrow_array_capsule_destructor);
+    if (!array_capsule) {
+        array->release(array);
+        delete array;
+        return nullptr;
+    }
+    PyObject* schema_capsule = arrow_schema_capsule();
+    if (!schema_capsule) {
+        Py_DECREF(array_capsule);
+        return nullptr;
+    }
+    
+    PyObject* pair = PyTuple_Pack(2, schema_capsule, array_capsule);
+    Py_DECREF(schema_capsule);
+    Py_DECREF(array_capsule);
+    return pair;
+}
+
+static Py_ssize_t arrow_batch_length(PyObject* self) {
+    return static_cast<Py_ssize_t>(reinterpret_cast<ArrowBatchObject*>(self)->batch->size());
+}
+
+static PyMethodDef arrow_batch_methods[] = {
+    {"__arrow_c_schema__", arrow_batch_schema, METH_NOARGS,
+     "Arrow C Data Interface schema as an 'arrow_schema' PyCapsule"},
+    {"__arrow_c_array__", reinterpret_cast<PyCFunction>(reinterpret_cast<void*>(arrow_batch_array)),
+     METH_VARARGS | METH_KEYWORDS,
+     "(schema, array) PyCapsules of the Arrow C Data Interface"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot arrow_batch_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Measurements as an Arrow record batch (pyarrow.record_batch(obj), polars.from_arrow(...))")},
+    {Py_tp_dealloc, reinterpret_cast<void*>(arrow_batch_dealloc)},
+    {Py_tp_methods, arrow_batch_methods},
+    {Py_sq_length, reinterpret_cast<void*>(arrow_batch_length)},
+    {0, nullptr}
+};
+
+static PyType_Spec arrow_batch_spec = {
+    "stdf_parser_cpp.ArrowBatch",
+    sizeof(ArrowBatchObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    arrow_batch_slots
+};
+
+static PyObject* new_arrow_batch(const std::shared_ptr<const void>& owner, const MeasurementBatch& batch) {
+    auto* object = PyObject_New(ArrowBatchObject, ArrowBatchType);
+    if (!object) return nullptr;
+    object->owner = new std::shared_ptr<const void>(owner);
+    object->batch = &batch;
+    return reinterpret_cast<PyObject*>(object);
+}
+
 // Convert C++ STDFRecord to Python dictionary
 static PyObject* stdf_record_to_dict(const STDFRecord& record) {
     PyObject* dict = PyDict_New();
@@ -64,44 +655,98 @@ static const char* record_type_to_string(STDFRecordType type) {
     }
 }
 
-// Python function: parse_stdf_file(filepath)
-static PyObject* parse_stdf_file(PyObject* self, PyObject* args) {
+// Map a Python-side record type name ("PTR", "MIR", ...) onto STDFRecordType
+static bool parse_record_type_name(const char* name, STDFRecordType& type) {
+    static const STDFRecordType known[] = {
+        STDFRecordType::PTR, STDFRecordType::MPR, STDFRecordType::FTR, STDFRecordType::HBR,
+        STDFRecordType::SBR, STDFRecordType::PRR, STDFRecordType::MIR
+    };
+    for (STDFRecordType candidate : known) {
+        if (std::strcmp(name, record_type_to_string(candidate)) == 0) {
+            type = candidate;
+            return true;
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "Unknown record type '%s'", name);
+    return false;
+}
+
+// Convert a record vector to a Python list of dicts (with "record_type")
+static PyObject* stdf_records_to_list(const std::vector<STDFRecord>& records) {
+    PyObject* results_list = PyList_New(records.size());
+    if (!results_list) {
+        return nullptr;
+    }
+    
+    for (size_t i = 0; i < records.size(); ++i) {
+        PyObject* record_dict = stdf_record_to_dict(records[i]);
+        if (!record_dict) {
+            Py_DECREF(results_list);
+            return nullptr;
+        }
+        
+        // Add record type string
+        PyDict_SetItemString(record_dict, "record_type", 
+                           PyUnicode_FromString(record_type_to_string(records[i].type)));
+        
+        PyList_SetItem(results_list, i, record_dict);
+    }
+    
+    return results_list;
+}
+
+// Python function: parse_stdf_file(filepath, backend="libstdf", fields=None)
+// With fields, records are decoded lazily and only those fields are
+// materialized (names from the STDF spec, e.g. ["TEST_NUM", "RESULT"])
+static PyObject* parse_stdf_file(PyObject* /*self*/, PyObject* args) {
     const char* filepath;
+    const char* backend_name = nullptr;
+    PyObject* fields_object = nullptr;
+    STDFParserBackend backend;
+    std::vector<std::string> field_names;
+    bool project = false;
     
     // Parse arguments
-    if (!PyArg_ParseTuple(args, "s", &filepath)) {
+    if (!PyArg_ParseTuple(args, "s|zO", &filepath, &backend_name, &fields_object)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend) ||
+        !parse_string_list(fields_object, "fields", field_names, project)) {
         return nullptr;
     }
     
     try {
         // Create parser and parse file
         STDFParser parser;
-        std::vector<STDFRecord> records = parser.parse_file(std::string(filepath));
-        
-        // TODO: Integrate X-Macros dynamic extraction
-        // For now, the existing parser includes the basic fields
-        // X-Macros integration will enhance field extraction
+        parser.set_backend(backend);
+        std::vector<STDFRecord> records;
+        {
+            ScopedGILRelease released;
+            if (project) {
+                parser.stream_views(std::string(filepath), [&records, &field_names](STDFRecordView& view) {
+                    STDFRecord record;
+                    record.type = view.type();
+                    record.rec_type = view.rec_type();
+                    record.rec_subtype = view.rec_subtype();
+                    record.record_index = view.record_index();
+                    for (const std::string& name : field_names) {
+                        if (view.has_field(name)) {
+                            record.fields[name] = view.get_field(name);
+                        }
+                    }
+                    records.push_back(std::move(record));
+                });
+            } else {
+                records = parser.parse_file(std::string(filepath));
+            }
+        }
         
         // Convert results to Python list
-        PyObject* results_list = PyList_New(records.size());
+        PyObject* results_list = stdf_records_to_list(records);
         if (!results_list) {
             return nullptr;
         }
         
-        for (size_t i = 0; i < records.size(); ++i) {
-            PyObject* record_dict = stdf_record_to_dict(records[i]);
-            if (!record_dict) {
-                Py_DECREF(results_list);
-                return nullptr;
-            }
-            
-            // Add record type string
-            PyDict_SetItemString(record_dict, "record_type", 
-                               PyUnicode_FromString(record_type_to_string(records[i].type)));
-            
-            PyList_SetItem(results_list, i, record_dict);
-        }
-        
         // Create return dictionary with results and statistics
         PyObject* result_dict = PyDict_New();
         PyDict_SetItemString(result_dict, "records", results_list);
@@ -118,130 +763,716 @@ static PyObject* parse_stdf_file(PyObject* self, PyObject* args) {
     }
 }
 
-// Python function: get_version()
-static PyObject* get_version(PyObject* self, PyObject* args) {
-    return PyUnicode_FromString("STDFParser C++ Extension v1.0.0");
+static PyObject* u32_list(const std::vector<uint32_t>& values) {
+    PyObject* list = PyList_New(values.size());
+    for (size_t i = 0; list && i < values.size(); ++i) {
+        PyList_SET_ITEM(list, i, PyLong_FromUnsignedLong(values[i]));
+    }
+    return list;
 }
 
-// Helper function to safely extract string from Python dict
-static std::string extract_dict_string(PyObject* dict, const char* key, const std::string& default_val = "") {
-    if (!dict || !PyDict_Check(dict)) return default_val;
-    
-    PyObject* item = PyDict_GetItemString(dict, key);
-    if (!item || !PyUnicode_Check(item)) return default_val;
-    
-    const char* str = PyUnicode_AsUTF8(item);
-    return str ? std::string(str) : default_val;
+// Set bit indices of a pin map
+static PyObject* pin_index_list(const std::vector<uint8_t>& bits) {
+    PyObject* list = PyList_New(0);
+    for (size_t pin = 0; list && pin < 8 * bits.size(); ++pin) {
+        if ((bits[pin / 8] >> (pin % 8)) & 1) {
+            PyObject* index = PyLong_FromSize_t(pin);
+            PyList_Append(list, index);
+            Py_DECREF(index);
+        }
+    }
+    return list;
 }
 
-// Option 1: Pre-compute expensive fields in C++, return to Python for object assembly
-static PyObject* precompute_measurement_fields(PyObject* self, PyObject* args) {
-    PyObject* mir_data_dict;
-    PyObject* prr_data_dict;
+// Python function: get_pin_fail_map(paths, backend=None) -> dict
+// FTR FAIL_PIN maps per pin and per part for one file or a list of files
+// (parts in file order); each part's 'fail_pins' is the raw bitmap (bytes,
+// bit i = pin i)
+static PyObject* get_pin_fail_map(PyObject* /*self*/, PyObject* args) {
+    PyObject* paths_object;
+    const char* backend_name = nullptr;
+    STDFParserBackend backend = STDFParserBackend::MMAP;
+    std::vector<std::string> paths;
+    bool has_paths = false;
     
-    // Parse Python arguments
-    if (!PyArg_ParseTuple(args, "OO", &mir_data_dict, &prr_data_dict)) {
+    if (!PyArg_ParseTuple(args, "O|z", &paths_object, &backend_name)) {
+        return nullptr;
+    }
+    if (PyUnicode_Check(paths_object)) {
+        const char* path = PyUnicode_AsUTF8(paths_object);
+        if (!path) {
+            return nullptr;
+        }
+        paths.emplace_back(path);
+    } else if (!parse_string_list(paths_object, "paths", paths, has_paths)) {
+        return nullptr;
+    }
+    if (backend_name && !parse_backend_name(backend_name, backend)) {
         return nullptr;
     }
     
-    // Pre-compute expensive operations in C++ (ONCE per test, not per measurement)
-    std::string facility = extract_dict_string(mir_data_dict, "facility");
-    std::string operation = extract_dict_string(mir_data_dict, "operation");
-    std::string lot_name = extract_dict_string(mir_data_dict, "lot_name");
-    std::string equipment = extract_dict_string(mir_data_dict, "equipment");
-    std::string prog_name = extract_dict_string(mir_data_dict, "prog_name");
-    std::string prog_version = extract_dict_string(mir_data_dict, "prog_version");
-    std::string start_time = extract_dict_string(mir_data_dict, "start_time");
-    
-    std::string device_dmc = extract_dict_string(prr_data_dict, "device_dmc");
-    std::string bin_code = extract_dict_string(prr_data_dict, "bin_code");
+    PinFailMap map;
+    bool success = true;
+    {
+        ScopedGILRelease released;
+        for (const std::string& path : paths) {
+            success = success && map.add_file(path, backend);
+        }
+    }
+    if (!success) {
+        PyErr_SetString(PyExc_RuntimeError, map.get_last_error().c_str());
+        return nullptr;
+    }
     
-    // C++ logic for expensive computations (computed once, reused many times)
-    bool is_pass = (bin_code == "1");
-    std::string bin_desc = is_pass ? "PASS" : "FAIL";
-    bool test_flag = is_pass;
+    PyObject* parts = PyList_New(map.parts().size());
+    for (size_t i = 0; parts && i < map.parts().size(); ++i) {
+        const PartPinFails& part = map.parts()[i];
+        PyObject* item = PyDict_New();
+        set_dict_item(item, "head_num", PyLong_FromUnsignedLong(part.head_num));
+        set_dict_item(item, "site_num", PyLong_FromUnsignedLong(part.site_num));
+        set_dict_item(item, "hard_bin", PyLong_FromUnsignedLong(part.hard_bin));
+        set_dict_item(item, "soft_bin", PyLong_FromUnsignedLong(part.soft_bin));
+        set_dict_item(item, "part_id", safe_unicode_from_string(part.part_id));
+        set_dict_item(item, "ftr_count", PyLong_FromUnsignedLong(part.ftr_count));
+        set_dict_item(item, "failed_ftrs", PyLong_FromUnsignedLong(part.failed_ftrs));
+        set_dict_item(item, "failing_pins", PyLong_FromSize_t(part.failing_pins()));
+        set_dict_item(item, "fail_pins", PyBytes_FromStringAndSize(reinterpret_cast<const char*>(part.fail_pins.data()),
+                                                                   static_cast<Py_ssize_t>(part.fail_pins.size())));
+        PyList_SET_ITEM(parts, i, item);
+    }
     
-    // Return pre-computed values as Python dict
-    PyObject* computed_fields = PyDict_New();
-    if (!computed_fields) return nullptr;
+    PyObject* result_dict = PyDict_New();
+    set_dict_item(result_dict, "pin_count", PyLong_FromSize_t(map.pin_count()));
+    set_dict_item(result_dict, "ftr_count", PyLong_FromSize_t(map.ftr_count()));
+    set_dict_item(result_dict, "ftr_fail_counts", u32_list(map.ftr_fail_counts()));
+    set_dict_item(result_dict, "part_fail_counts", u32_list(map.part_fail_counts()));
+    set_dict_item(result_dict, "common_fail_pins", pin_index_list(map.common_fail_pins()));
+    set_dict_item(result_dict, "parts", parts);
+    set_dict_item(result_dict, "unfinished_parts", PyLong_FromSize_t(map.unfinished_parts()));
+    return result_dict;
+}
+
+// Python function: build_stdf_index(filepath, cache_dir=None)
+static PyObject* build_stdf_index(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    const char* cache_dir = nullptr;
     
-    // Set all the expensive-to-compute fields:
-    PyDict_SetItemString(computed_fields, "WFI_FACILITY", PyUnicode_FromString(facility.c_str()));
-    PyDict_SetItemString(computed_fields, "WFI_OPERATION", PyUnicode_FromString(operation.c_str()));
-    PyDict_SetItemString(computed_fields, "WL_LOT_NAME", PyUnicode_FromString(lot_name.c_str()));
-    PyDict_SetItemString(computed_fields, "WFI_EQUIPMENT", PyUnicode_FromString(equipment.c_str()));
-    PyDict_SetItemString(computed_fields, "WMP_PROG_NAME", PyUnicode_FromString(prog_name.c_str()));
-    PyDict_SetItemString(computed_fields, "WMP_PROG_VERSION", PyUnicode_FromString(prog_version.c_str()));
-    PyDict_SetItemString(computed_fields, "WPTM_CREATED_DATE", PyUnicode_FromString(start_time.c_str()));
-    PyDict_SetItemString(computed_fields, "WLD_CREATED_DATE", PyUnicode_FromString(start_time.c_str()));
-    
-    PyDict_SetItemString(computed_fields, "WLD_DEVICE_DMC", PyUnicode_FromString(device_dmc.c_str()));
-    PyDict_SetItemString(computed_fields, "WLD_BIN_CODE", PyUnicode_FromString(bin_code.c_str()));
-    PyDict_SetItemString(computed_fields, "WLD_BIN_DESC", PyUnicode_FromString(bin_desc.c_str()));
-    PyDict_SetItemString(computed_fields, "TEST_FLAG", PyBool_FromLong(test_flag));
+    if (!PyArg_ParseTuple(args, "s|z", &filepath, &cache_dir)) {
+        return nullptr;
+    }
     
-    // Constant fields (computed once in C++)
-    PyDict_SetItemString(computed_fields, "WLD_PHOENIX_ID", PyUnicode_FromString(""));
-    PyDict_SetItemString(computed_fields, "WLD_LATEST", PyUnicode_FromString("Y"));
-    PyDict_SetItemString(computed_fields, "SFT_NAME", PyUnicode_FromString("STDF_CPP"));
-    PyDict_SetItemString(computed_fields, "SFT_GROUP", PyUnicode_FromString("STDF_CPP"));
+    std::string cache = cache_dir ? cache_dir : "";
+    STDFRecordIndex index;
+    bool loaded;
+    {
+        ScopedGILRelease released;
+        loaded = index.load_or_build(filepath, cache);
+    }
+    if (!loaded) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot index %s: %s", filepath, index.get_last_error().c_str());
+        return nullptr;
+    }
     
-    return computed_fields;
+    PyObject* result_dict = PyDict_New();
+    PyDict_SetItemString(result_dict, "index_path",
+                       safe_unicode_from_string(STDFRecordIndex::sidecar_path(filepath, cache)));
+    PyDict_SetItemString(result_dict, "total_records", PyLong_FromSize_t(index.size()));
+    PyDict_SetItemString(result_dict, "total_parts", PyLong_FromSize_t(index.parts().size()));
+    return result_dict;
 }
 
-// 🚀 ULTRA-FAST: Process STDF to ClickHouse tuples entirely in C++
-static PyObject* process_stdf_to_clickhouse_tuples(PyObject* self, PyObject* args) {
+// Python function: export_stdf_cache(filepath, cache_dir, backend=None, num_threads=1)
+// Decodes a file once into the columnar cache under cache_dir (see
+// set_decode_cache); returns the entry path, content hash and record counts
+static PyObject* export_stdf_cache(PyObject* /*self*/, PyObject* args) {
     const char* filepath;
+    const char* cache_dir;
+    const char* backend_name = nullptr;
+    Py_ssize_t num_threads = 1;
+    STDFParserBackend backend;
     
-    // Parse arguments
-    if (!PyArg_ParseTuple(args, "s", &filepath)) {
+    if (!PyArg_ParseTuple(args, "ss|zn", &filepath, &cache_dir, &backend_name, &num_threads)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
         return nullptr;
     }
     
-    try {
-        // Create ultra-fast processor
-        UltraFastProcessor processor;
-        
-        // Process STDF file entirely in C++
-        std::vector<MeasurementTuple> measurements = processor.process_stdf_file(std::string(filepath));
-        
-        // Convert ONLY final measurements to Python tuples (minimal bridge)
-        PyObject* tuple_list = PyList_New(measurements.size());
-        if (!tuple_list) {
-            return nullptr;
+    ColumnarCache cache(cache_dir);
+    STDFParser parser;
+    parser.set_backend(backend);
+    parser.set_num_threads(static_cast<size_t>(num_threads));
+    bool parsed;
+    bool saved = false;
+    {
+        ScopedGILRelease released;
+        STDFColumnarStore store;
+        parsed = parser.parse_to_columns(filepath, store);
+        if (parsed) {
+            ColumnarCacheInfo info;
+            info.total_records = parser.get_total_records();
+            info.parsed_records = parser.get_parsed_records();
+            saved = cache.save(parser.get_content_hash(), store, info);
         }
-        
-        // Helper function for safe string conversion
-        auto PyUnicode_FromString_Safe = [](const std::string& str) -> PyObject* {
-            return PyUnicode_FromString(str.c_str());
-        };
-        
-        // 🚀 MACRO-DRIVEN: Calculate tuple size automatically
-        constexpr size_t TUPLE_SIZE = 0
-        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) + 1
-        #include "../include/measurement_fields.def"
-        #undef MEASUREMENT_FIELD
-        ;
-        
-        for (size_t i = 0; i < measurements.size(); ++i) {
-            const auto& m = measurements[i];
-            
-            // Create ClickHouse-compatible tuple with auto-calculated size
-            PyObject* tuple = PyTuple_New(TUPLE_SIZE);
-            if (!tuple) {
-                Py_DECREF(tuple_list);
-                return nullptr;
-            }
-            
-            // 🚀 MACRO-DRIVEN: Pack measurement data using macro expansion
-            size_t field_index = 0;
-            #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
-                PyTuple_SetItem(tuple, field_index++, python_conversion(m.name));
-            
-            #include "../include/measurement_fields.def"
-            #undef MEASUREMENT_FIELD
-            
-            PyList_SetItem(tuple_list, i, tuple);
+    }
+    if (!parsed) {
+        PyErr_Format(PyExc_RuntimeError, "Failed to parse %s", filepath);
+        return nullptr;
+    }
+    if (!saved) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot cache %s: %s", filepath, cache.get_last_error().c_str());
+        return nullptr;
+    }
+    
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "cache_path", safe_unicode_from_string(cache.entry_path(parser.get_content_hash())));
+    set_dict_item(result_dict, "content_hash", safe_unicode_from_string(parser.get_content_hash()));
+    set_dict_item(result_dict, "total_records", PyLong_FromSize_t(parser.get_total_records()));
+    set_dict_item(result_dict, "parsed_records", PyLong_FromSize_t(parser.get_parsed_records()));
+    return result_dict;
+}
+
+// Python function: set_decode_cache(cache_dir)
+// Processing functions called afterwards (process_stdf_*, iter_measurements,
+// process_stdf_files, ...) rebuild measurements from the columnar cache when
+// it has the file's content hash and fill it when it does not. None = off.
+static PyObject* set_decode_cache(PyObject* /*self*/, PyObject* args) {
+    const char* cache_dir = nullptr;
+    if (!PyArg_ParseTuple(args, "z", &cache_dir)) {
+        return nullptr;
+    }
+    UltraFastProcessor::set_default_cache_dir(cache_dir ? cache_dir : "");
+    Py_RETURN_NONE;
+}
+
+// Python function: set_presort_output(enabled)
+// Processing functions called afterwards emit every batch sorted by the
+// measurements table's ORDER BY key instead of in file order (off by
+// default). Returns the previous setting.
+static PyObject* set_presort_output(PyObject* /*self*/, PyObject* args) {
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled)) {
+        return nullptr;
+    }
+    const bool previous = UltraFastProcessor::get_default_sort_output();
+    UltraFastProcessor::set_default_sort_output(enabled != 0);
+    return PyBool_FromLong(previous);
+}
+
+// Python function: set_file_read_mode(mode)
+// How files opened afterwards are brought into memory: "auto" (default:
+// mapped, except network shares, which are read in large chunks), "map" or
+// "read". Returns the previous mode.
+static PyObject* set_file_read_mode(PyObject* /*self*/, PyObject* args) {
+    const char* mode_name;
+    if (!PyArg_ParseTuple(args, "s", &mode_name)) {
+        return nullptr;
+    }
+    static const char* const names[] = {"auto", "map", "read"};
+    const FileReadMode modes[] = {FileReadMode::AUTO, FileReadMode::MAP, FileReadMode::READ};
+    const FileReadMode previous = MappedFile::get_default_read_mode();
+    for (size_t i = 0; i < 3; ++i) {
+        if (std::strcmp(mode_name, names[i]) == 0) {
+            MappedFile::set_default_read_mode(modes[i]);
+            return PyUnicode_FromString(names[static_cast<size_t>(previous)]);
+        }
+    }
+    PyErr_Format(PyExc_ValueError, "Unknown file read mode '%s' (expected 'auto', 'map' or 'read')", mode_name);
+    return nullptr;
+}
+
+// Python function: set_numa_placement(enabled)
+// Whether worker pools created afterwards spread their threads over the
+// NUMA nodes (on by default; no effect on a single-node machine). Returns
+// the previous setting.
+static PyObject* set_numa_placement(PyObject* /*self*/, PyObject* args) {
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled)) {
+        return nullptr;
+    }
+    const bool previous = WorkStealingPool::get_numa_placement();
+    WorkStealingPool::set_numa_placement(enabled != 0);
+    return PyBool_FromLong(previous);
+}
+
+// Python function: set_read_ahead(files, window_mb=None)
+// How many files multi-file runs read into the page cache ahead of their
+// decoders (0 = none, default 2), and at most how many MB of them wait
+// there (default 1024). Returns the previous (files, window_mb).
+static PyObject* set_read_ahead(PyObject* /*self*/, PyObject* args) {
+    Py_ssize_t files;
+    PyObject* window_object = Py_None;
+    if (!PyArg_ParseTuple(args, "n|O", &files, &window_object)) {
+        return nullptr;
+    }
+    unsigned long long window_mb = 0;
+    if (window_object != Py_None) {
+        window_mb = PyLong_AsUnsignedLongLong(window_object);
+        if (PyErr_Occurred()) {
+            return nullptr;
+        }
+    }
+    if (files < 0) {
+        PyErr_SetString(PyExc_ValueError, "files must be >= 0");
+        return nullptr;
+    }
+    const size_t previous_files = FilePrefetcher::get_default_files_ahead();
+    const uint64_t previous_window = FilePrefetcher::get_default_window_bytes() >> 20;
+    FilePrefetcher::set_default_files_ahead(static_cast<size_t>(files));
+    if (window_object != Py_None) {
+        FilePrefetcher::set_default_window_bytes(static_cast<uint64_t>(window_mb) << 20);
+    }
+    return Py_BuildValue("(nK)", static_cast<Py_ssize_t>(previous_files),
+                         static_cast<unsigned long long>(previous_window));
+}
+
+// Python function: get_cpu_topology()
+// {"nodes": [[cpu, ...], ...], "cpu_count": n, "numa_placement": bool}
+static PyObject* get_cpu_topology(PyObject* /*self*/, PyObject* /*args*/) {
+    const CPUTopology& topology = CPUTopology::system();
+    PyObject* nodes = PyList_New(static_cast<Py_ssize_t>(topology.node_count()));
+    if (!nodes) {
+        return nullptr;
+    }
+    for (size_t node = 0; node < topology.node_count(); ++node) {
+        const std::vector<unsigned>& cpus = topology.node_cpus(node);
+        PyObject* cpu_list = PyList_New(static_cast<Py_ssize_t>(cpus.size()));
+        if (!cpu_list) {
+            Py_DECREF(nodes);
+            return nullptr;
+        }
+        for (size_t i = 0; i < cpus.size(); ++i) {
+            PyList_SET_ITEM(cpu_list, static_cast<Py_ssize_t>(i), PyLong_FromUnsignedLong(cpus[i]));
+        }
+        PyList_SET_ITEM(nodes, static_cast<Py_ssize_t>(node), cpu_list);
+    }
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        Py_DECREF(nodes);
+        return nullptr;
+    }
+    set_dict_item(result_dict, "nodes", nodes);
+    set_dict_item(result_dict, "cpu_count", PyLong_FromSize_t(topology.cpu_count()));
+    set_dict_item(result_dict, "numa_placement", PyBool_FromLong(WorkStealingPool::get_numa_placement()));
+    return result_dict;
+}
+
+// Sizes and largest IDs of the ID snapshots in snapshot_dir (zeros without any)
+static PyObject* id_snapshot_info(const std::string& snapshot_dir) {
+    FastIDManager manager(false);
+    bool attached = manager.attach_snapshots(snapshot_dir);
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "snapshot_dir", safe_unicode_from_string(snapshot_dir));
+    set_dict_item(result_dict, "exists", PyBool_FromLong(attached));
+    set_dict_item(result_dict, "devices", PyLong_FromSize_t(attached ? manager.get_device_mappings().size() : 0));
+    set_dict_item(result_dict, "params", PyLong_FromSize_t(attached ? manager.get_param_mappings().size() : 0));
+    set_dict_item(result_dict, "max_device_id", PyLong_FromUnsignedLong(manager.snapshot_max_device_id()));
+    set_dict_item(result_dict, "max_param_id", PyLong_FromUnsignedLong(manager.snapshot_max_param_id()));
+    return result_dict;
+}
+
+// Python function: set_id_snapshot(snapshot_dir)
+// ID managers created afterwards (every processing and insert function)
+// start from the memory-mapped snapshots in snapshot_dir; the mappings
+// passed to them then only need the IDs above max_device_id / max_param_id
+// of the returned info. None = off.
+static PyObject* set_id_snapshot(PyObject* /*self*/, PyObject* args) {
+    const char* snapshot_dir = nullptr;
+    if (!PyArg_ParseTuple(args, "z", &snapshot_dir)) {
+        return nullptr;
+    }
+    FastIDManager::set_default_snapshot_dir(snapshot_dir ? snapshot_dir : "");
+    if (!snapshot_dir) {
+        Py_RETURN_NONE;
+    }
+    return id_snapshot_info(snapshot_dir);
+}
+
+// Python function: write_id_snapshot(snapshot_dir, device_mappings=None, param_mappings=None)
+// Folds the mappings (e.g. the delta synced from ClickHouse, or the new
+// mappings a run returned) into the snapshots in snapshot_dir, creating them
+// on first use; returns the new info
+static PyObject* write_id_snapshot(PyObject* /*self*/, PyObject* args) {
+    const char* snapshot_dir;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    if (!PyArg_ParseTuple(args, "s|OO", &snapshot_dir, &device_mappings_list, &param_mappings_list)) {
+        return nullptr;
+    }
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    bool saved;
+    std::string error;
+    {
+        ScopedGILRelease released;
+        FastIDManager manager(false);
+        manager.attach_snapshots(snapshot_dir);  // Absent the first time
+        manager.load_existing_mappings_from_python(device_mappings, param_mappings);
+        saved = manager.save_snapshots(snapshot_dir);
+        error = manager.get_last_error();
+    }
+    if (!saved) {
+        PyErr_SetString(PyExc_RuntimeError, error.c_str());
+        return nullptr;
+    }
+    return id_snapshot_info(snapshot_dir);
+}
+
+// Python function: read_stdf_records(filepath, record_type, cache_dir=None)
+static PyObject* read_stdf_records(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    const char* type_name;
+    const char* cache_dir = nullptr;
+    STDFRecordType type;
+    
+    if (!PyArg_ParseTuple(args, "ss|z", &filepath, &type_name, &cache_dir)) {
+        return nullptr;
+    }
+    if (!parse_record_type_name(type_name, type)) {
+        return nullptr;
+    }
+    
+    STDFParser parser;
+    std::vector<STDFRecord> records;
+    bool opened;
+    {
+        ScopedGILRelease released;
+        opened = parser.open_indexed(filepath, cache_dir ? cache_dir : "");
+        if (opened) {
+            records = parser.read_records_of_type(type);
+        }
+    }
+    if (!opened) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot open indexed STDF file %s", filepath);
+        return nullptr;
+    }
+    
+    return stdf_records_to_list(records);
+}
+
+// Python function: read_stdf_part(filepath, part_number, cache_dir=None)
+static PyObject* read_stdf_part(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    Py_ssize_t part_number;
+    const char* cache_dir = nullptr;
+    
+    if (!PyArg_ParseTuple(args, "sn|z", &filepath, &part_number, &cache_dir)) {
+        return nullptr;
+    }
+    
+    STDFParser parser;
+    bool opened;
+    {
+        ScopedGILRelease released;
+        opened = parser.open_indexed(filepath, cache_dir ? cache_dir : "");
+    }
+    if (!opened) {
+        PyErr_Format(PyExc_RuntimeError, "Cannot open indexed STDF file %s", filepath);
+        return nullptr;
+    }
+    
+    if (part_number < 0 || static_cast<size_t>(part_number) >= parser.get_part_count()) {
+        PyErr_Format(PyExc_IndexError, "Part %zd out of range (file has %zu parts)",
+                     part_number, parser.get_part_count());
+        return nullptr;
+    }
+    
+    std::vector<STDFRecord> records;
+    {
+        ScopedGILRelease released;
+        records = parser.read_part(static_cast<size_t>(part_number));
+    }
+    return stdf_records_to_list(records);
+}
+
+// Python function: is_pixel_test(alarm_id, test_txt)
+static PyObject* is_pixel_test(PyObject* /*self*/, PyObject* args) {
+    const char* alarm_id;
+    Py_ssize_t alarm_len;
+    const char* test_txt;
+    Py_ssize_t test_len;
+    
+    if (!PyArg_ParseTuple(args, "z#z#", &alarm_id, &alarm_len, &test_txt, &test_len)) {
+        return nullptr;
+    }
+    
+    bool pixel = is_pixel_name(alarm_id ? std::string_view(alarm_id, alarm_len) : std::string_view(),
+                               test_txt ? std::string_view(test_txt, test_len) : std::string_view());
+    return PyBool_FromLong(pixel);
+}
+
+// Python function: clean_param_name(name)
+static PyObject* clean_param_name(PyObject* /*self*/, PyObject* args) {
+    const char* name;
+    Py_ssize_t name_len;
+    
+    if (!PyArg_ParseTuple(args, "s#", &name, &name_len)) {
+        return nullptr;
+    }
+    
+    PixelName pixel_name;
+    parse_pixel_name(std::string_view(name, name_len), pixel_name);
+    return safe_unicode_from_string(pixel_name.cleaned);
+}
+
+// Python function: parse_pixel_name(name) -> (cleaned, x, y); x/y are None without a tag
+static PyObject* parse_pixel_name(PyObject* /*self*/, PyObject* args) {
+    const char* name;
+    Py_ssize_t name_len;
+    
+    if (!PyArg_ParseTuple(args, "s#", &name, &name_len)) {
+        return nullptr;
+    }
+    
+    PixelName pixel_name;
+    parse_pixel_name(std::string_view(name, name_len), pixel_name);
+    if (!pixel_name.has_tag) {
+        return Py_BuildValue("(s#OO)", pixel_name.cleaned.data(), static_cast<Py_ssize_t>(pixel_name.cleaned.size()),
+                             Py_None, Py_None);
+    }
+    return Py_BuildValue("(s#ii)", pixel_name.cleaned.data(), static_cast<Py_ssize_t>(pixel_name.cleaned.size()),
+                         pixel_name.x, pixel_name.y);
+}
+
+// Python function: get_version()
+static PyObject* get_version(PyObject* /*self*/, PyObject* /*args*/) {
+    return PyUnicode_FromString("STDFParser C++ Extension v1.0.0");
+}
+
+// Helper function to safely extract string from Python dict
+static std::string extract_dict_string(PyObject* dict, const char* key, const std::string& default_val = "") {
+    if (!dict || !PyDict_Check(dict)) return default_val;
+    
+    PyObject* item = PyDict_GetItemString(dict, key);
+    if (!item || !PyUnicode_Check(item)) return default_val;
+    
+    const char* str = PyUnicode_AsUTF8(item);
+    return str ? std::string(str) : default_val;
+}
+
+// The fields precompute_measurement_fields derives from the MIR alone,
+// plus the constant ones; the same for every part of a file
+static void set_mir_measurement_fields(PyObject* fields, PyObject* mir_data_dict) {
+    std::string start_time = extract_dict_string(mir_data_dict, "start_time");
+    set_dict_item(fields, "WFI_FACILITY", PyUnicode_FromString(extract_dict_string(mir_data_dict, "facility").c_str()));
+    set_dict_item(fields, "WFI_OPERATION", PyUnicode_FromString(extract_dict_string(mir_data_dict, "operation").c_str()));
+    set_dict_item(fields, "WL_LOT_NAME", PyUnicode_FromString(extract_dict_string(mir_data_dict, "lot_name").c_str()));
+    set_dict_item(fields, "WFI_EQUIPMENT", PyUnicode_FromString(extract_dict_string(mir_data_dict, "equipment").c_str()));
+    set_dict_item(fields, "WMP_PROG_NAME", PyUnicode_FromString(extract_dict_string(mir_data_dict, "prog_name").c_str()));
+    set_dict_item(fields, "WMP_PROG_VERSION", PyUnicode_FromString(extract_dict_string(mir_data_dict, "prog_version").c_str()));
+    set_dict_item(fields, "WPTM_CREATED_DATE", PyUnicode_FromString(start_time.c_str()));
+    set_dict_item(fields, "WLD_CREATED_DATE", PyUnicode_FromString(start_time.c_str()));
+
+    // Constant fields (computed once in C++)
+    set_dict_item(fields, "WLD_PHOENIX_ID", PyUnicode_FromString(""));
+    set_dict_item(fields, "WLD_LATEST", PyUnicode_FromString("Y"));
+    set_dict_item(fields, "SFT_NAME", PyUnicode_FromString("STDF_CPP"));
+    set_dict_item(fields, "SFT_GROUP", PyUnicode_FromString("STDF_CPP"));
+}
+
+// Option 1: Pre-compute expensive fields in C++, return to Python for object assembly
+static PyObject* precompute_measurement_fields(PyObject* /*self*/, PyObject* args) {
+    PyObject* mir_data_dict;
+    PyObject* prr_data_dict;
+    
+    // Parse Python arguments
+    if (!PyArg_ParseTuple(args, "OO", &mir_data_dict, &prr_data_dict)) {
+        return nullptr;
+    }
+    
+    std::string device_dmc = extract_dict_string(prr_data_dict, "device_dmc");
+    std::string bin_code = extract_dict_string(prr_data_dict, "bin_code");
+    
+    // C++ logic for expensive computations (computed once, reused many times)
+    bool is_pass = (bin_code == "1");
+    std::string bin_desc = is_pass ? "PASS" : "FAIL";
+    bool test_flag = is_pass;
+    
+    // Return pre-computed values as Python dict
+    PyObject* computed_fields = PyDict_New();
+    if (!computed_fields) return nullptr;
+    
+    set_mir_measurement_fields(computed_fields, mir_data_dict);
+    set_dict_item(computed_fields, "WLD_DEVICE_DMC", PyUnicode_FromString(device_dmc.c_str()));
+    set_dict_item(computed_fields, "WLD_BIN_CODE", PyUnicode_FromString(bin_code.c_str()));
+    set_dict_item(computed_fields, "WLD_BIN_DESC", PyUnicode_FromString(bin_desc.c_str()));
+    set_dict_item(computed_fields, "TEST_FLAG", PyBool_FromLong(test_flag));
+    
+    return computed_fields;
+}
+
+// Python function: precompute_measurement_fields_batch(mir_data_dict, prrs)
+// prrs: a list of PRR dicts, or columns {"device_dmc": [...], "bin_code": [...]}.
+// Returns {"count": n, "constants": {MIR-derived and constant fields, once},
+// "columns": {"WLD_DEVICE_DMC", "WLD_BIN_CODE", "WLD_BIN_DESC", "TEST_FLAG": n values each}}.
+// The per-part strings are the caller's own objects, and every part shares
+// one "PASS", one "FAIL" and one "" object.
+static PyObject* precompute_measurement_fields_batch(PyObject* /*self*/, PyObject* args) {
+    PyObject* mir_data_dict;
+    PyObject* prrs;
+    if (!PyArg_ParseTuple(args, "OO", &mir_data_dict, &prrs)) {
+        return nullptr;
+    }
+
+    // Either one sequence of dicts, or one sequence per key
+    const bool columnar = PyDict_Check(prrs);
+    PyObject* rows = nullptr;
+    PyObject* key_columns[2] = {nullptr, nullptr};
+    static const char* const keys[2] = {"device_dmc", "bin_code"};
+    Py_ssize_t count = -1;
+    auto release = [&]() {
+        Py_XDECREF(rows);
+        Py_XDECREF(key_columns[0]);
+        Py_XDECREF(key_columns[1]);
+    };
+    if (columnar) {
+        for (size_t key = 0; key < 2; ++key) {
+            PyObject* column = PyDict_GetItemString(prrs, keys[key]);
+            if (!column) {
+                continue;
+            }
+            key_columns[key] = PySequence_Fast(column, "PRR columns must be sequences");
+            if (!key_columns[key]) {
+                release();
+                return nullptr;
+            }
+            const Py_ssize_t length = PySequence_Fast_GET_SIZE(key_columns[key]);
+            if (count >= 0 && length != count) {
+                PyErr_Format(PyExc_ValueError, "PRR columns differ in length (%zd and %zd)", count, length);
+                release();
+                return nullptr;
+            }
+            count = length;
+        }
+        count = std::max<Py_ssize_t>(count, 0);
+    } else {
+        rows = PySequence_Fast(prrs, "prrs must be a list of PRR dicts or a dict of columns");
+        if (!rows) {
+            return nullptr;
+        }
+        count = PySequence_Fast_GET_SIZE(rows);
+    }
+
+    PyObject* result_dict = PyDict_New();
+    PyObject* constants = PyDict_New();
+    PyObject* columns = PyDict_New();
+    PyObject* dmc_column = PyList_New(count);
+    PyObject* bin_column = PyList_New(count);
+    PyObject* desc_column = PyList_New(count);
+    PyObject* flag_column = PyList_New(count);
+    PyObject* empty = PyUnicode_FromString("");
+    PyObject* pass = PyUnicode_FromString("PASS");
+    PyObject* fail = PyUnicode_FromString("FAIL");
+    if (!result_dict || !constants || !columns || !dmc_column || !bin_column || !desc_column || !flag_column ||
+        !empty || !pass || !fail) {
+        for (PyObject* object : {result_dict, constants, columns, dmc_column, bin_column, desc_column, flag_column,
+                                 empty, pass, fail}) {
+            Py_XDECREF(object);
+        }
+        release();
+        return nullptr;
+    }
+
+    // New reference to a str value, "" for anything else (as extract_dict_string)
+    auto text = [&](Py_ssize_t part, size_t key) {
+        PyObject* value = nullptr;
+        if (columnar) {
+            value = key_columns[key] ? PySequence_Fast_GET_ITEM(key_columns[key], part) : nullptr;
+        } else {
+            PyObject* row = PySequence_Fast_GET_ITEM(rows, part);
+            value = PyDict_Check(row) ? PyDict_GetItemString(row, keys[key]) : nullptr;
+        }
+        value = value && PyUnicode_Check(value) ? value : empty;
+        Py_INCREF(value);
+        return value;
+    };
+
+    for (Py_ssize_t part = 0; part < count; ++part) {
+        PyObject* bin_code = text(part, 1);
+        const bool is_pass = PyUnicode_CompareWithASCIIString(bin_code, "1") == 0;
+        PyObject* bin_desc = is_pass ? pass : fail;
+        Py_INCREF(bin_desc);
+        PyList_SET_ITEM(dmc_column, part, text(part, 0));
+        PyList_SET_ITEM(bin_column, part, bin_code);
+        PyList_SET_ITEM(desc_column, part, bin_desc);
+        PyList_SET_ITEM(flag_column, part, PyBool_FromLong(is_pass));
+    }
+    release();
+    Py_DECREF(empty);
+    Py_DECREF(pass);
+    Py_DECREF(fail);
+
+    set_mir_measurement_fields(constants, mir_data_dict);
+    set_dict_item(columns, "WLD_DEVICE_DMC", dmc_column);
+    set_dict_item(columns, "WLD_BIN_CODE", bin_column);
+    set_dict_item(columns, "WLD_BIN_DESC", desc_column);
+    set_dict_item(columns, "TEST_FLAG", flag_column);
+    set_dict_item(result_dict, "count", PyLong_FromSsize_t(count));
+    set_dict_item(result_dict, "constants", constants);
+    set_dict_item(result_dict, "columns", columns);
+    return result_dict;
+}
+
+// 🚀 ULTRA-FAST: Process STDF to ClickHouse tuples entirely in C++
+static PyObject* process_stdf_to_clickhouse_tuples(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    const char* backend_name = nullptr;
+    STDFParserBackend backend;
+    
+    Py_ssize_t num_threads = 1;
+    PyObject* patterns_object = nullptr;
+    std::vector<std::string> test_patterns;
+    bool has_patterns = false;
+    
+    // Parse arguments: filepath, backend (optional), num_threads (optional, 0 = one per core),
+    // test_patterns (optional list of substrings selecting tests, default ["Pixel="])
+    if (!PyArg_ParseTuple(args, "s|snO", &filepath, &backend_name, &num_threads, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    try {
+        // Create ultra-fast processor
+        UltraFastProcessor processor;
+        processor.set_parser_backend(backend);
+        processor.set_num_threads(static_cast<size_t>(num_threads));
+        if (has_patterns) {
+            processor.set_test_filter_patterns(test_patterns);
+        }
+        
+        // Process STDF file entirely in C++
+        MeasurementBatch measurements;
+        {
+            ScopedGILRelease released;
+            measurements = processor.process_stdf_file_to_batch(std::string(filepath));
+        }
+        
+        // Convert ONLY final measurements to Python tuples (minimal bridge)
+        PyObject* tuple_list = measurement_batch_to_tuple_list(measurements);
+        if (!tuple_list) {
+            return nullptr;
         }
         
         // Create result dictionary with tuples and statistics
@@ -260,11 +1491,12 @@ static PyObject* process_stdf_to_clickhouse_tuples(PyObject* self, PyObject* arg
                            PyFloat_FromDouble(processor.get_parsing_time()));
         PyDict_SetItemString(result_dict, "processing_time", 
                            PyFloat_FromDouble(processor.get_processing_time()));
+        PyDict_SetItemString(result_dict, "file_hash", safe_unicode_from_string(processor.get_file_hash()));
         
         // Add ID mappings for database insertion
         const auto& id_manager = processor.get_id_manager();
-        const auto& device_map = id_manager.get_device_map();
-        const auto& param_map = id_manager.get_param_map();
+        const auto device_map = id_manager.get_device_mappings();
+        const auto param_map = id_manager.get_param_mappings();
         
         PyObject* device_mappings = PyList_New(device_map.size());
         size_t idx = 0;
@@ -295,115 +1527,81 @@ static PyObject* process_stdf_to_clickhouse_tuples(PyObject* self, PyObject* arg
 }
 
 // 🔧 DATABASE-AWARE: Process STDF with existing database mappings
-static PyObject* process_stdf_with_database_mappings(PyObject* self, PyObject* args) {
+static PyObject* process_stdf_with_database_mappings(PyObject* /*self*/, PyObject* args) {
     const char* filepath;
     PyObject* device_mappings_list;
     PyObject* param_mappings_list;
     const char* file_hash = "";
+    const char* backend_name = nullptr;
+    STDFParserBackend backend;
     
-    // Parse arguments: filepath, device_mappings, param_mappings, file_hash (optional)
-    if (!PyArg_ParseTuple(args, "sOO|s", &filepath, &device_mappings_list, &param_mappings_list, &file_hash)) {
+    Py_ssize_t num_threads = 1;
+    PyObject* patterns_object = nullptr;
+    std::vector<std::string> test_patterns;
+    bool has_patterns = false;
+    
+    // Parse arguments: filepath, device_mappings, param_mappings, file_hash (optional), backend (optional),
+    // num_threads (optional, 0 = one per core), test_patterns (optional, default ["Pixel="])
+    if (!PyArg_ParseTuple(args, "sOO|ssnO", &filepath, &device_mappings_list, &param_mappings_list, &file_hash, 
+                          &backend_name, &num_threads, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
         return nullptr;
     }
     
     try {
         // Create ultra-fast processor
         UltraFastProcessor processor;
+        processor.set_parser_backend(backend);
+        processor.set_num_threads(static_cast<size_t>(num_threads));
+        if (has_patterns) {
+            processor.set_test_filter_patterns(test_patterns);
+        }
         
         // Set the file hash from Python (MD5) to ensure consistency
         if (file_hash && strlen(file_hash) > 0) {
             processor.set_file_hash(std::string(file_hash));
-            std::cout << "🔑 Using Python-generated MD5 hash: " << file_hash << std::endl;
+            ConsoleLog::out() << "🔑 Using Python-generated MD5 hash: " << file_hash << std::endl;
         }
         
         // Convert Python lists to C++ vectors
         std::vector<std::pair<std::string, uint32_t>> device_mappings;
         std::vector<std::pair<std::string, uint32_t>> param_mappings;
         
-        // Parse device mappings
-        if (PyList_Check(device_mappings_list)) {
-            Py_ssize_t size = PyList_Size(device_mappings_list);
-            for (Py_ssize_t i = 0; i < size; ++i) {
-                PyObject* tuple = PyList_GetItem(device_mappings_list, i);
-                if (PyTuple_Check(tuple) && PyTuple_Size(tuple) == 2) {
-                    PyObject* device_name = PyTuple_GetItem(tuple, 0);
-                    PyObject* device_id = PyTuple_GetItem(tuple, 1);
-                    
-                    if (PyUnicode_Check(device_name) && PyLong_Check(device_id)) {
-                        const char* name = PyUnicode_AsUTF8(device_name);
-                        uint32_t id = static_cast<uint32_t>(PyLong_AsUnsignedLong(device_id));
-                        device_mappings.emplace_back(name, id);
-                    }
-                }
-            }
-        }
-        
-        // Parse parameter mappings
-        if (PyList_Check(param_mappings_list)) {
-            Py_ssize_t size = PyList_Size(param_mappings_list);
-            for (Py_ssize_t i = 0; i < size; ++i) {
-                PyObject* tuple = PyList_GetItem(param_mappings_list, i);
-                if (PyTuple_Check(tuple) && PyTuple_Size(tuple) == 2) {
-                    PyObject* param_name = PyTuple_GetItem(tuple, 0);
-                    PyObject* param_id = PyTuple_GetItem(tuple, 1);
-                    
-                    if (PyUnicode_Check(param_name) && PyLong_Check(param_id)) {
-                        const char* name = PyUnicode_AsUTF8(param_name);
-                        uint32_t id = static_cast<uint32_t>(PyLong_AsUnsignedLong(param_id));
-                        param_mappings.emplace_back(name, id);
-                    }
-                }
-            }
-        }
+        parse_id_mappings(device_mappings_list, device_mappings);
+        parse_id_mappings(param_mappings_list, param_mappings);
         
-        std::cout << "🔧 Loading " << device_mappings.size() << " device mappings, " 
+        ConsoleLog::out() << "🔧 Loading " << device_mappings.size() << " device mappings, " 
                   << param_mappings.size() << " parameter mappings from database" << std::endl;
         
-        // Load existing mappings into processor
+        // Load existing mappings and process the file with database-aware IDs
         auto& id_manager = const_cast<FastIDManager&>(processor.get_id_manager());
-        id_manager.load_existing_mappings_from_python(device_mappings, param_mappings);
-        
-        // Process STDF file with database-aware IDs
-        std::vector<MeasurementTuple> measurements = processor.process_stdf_file(std::string(filepath));
-        
-        // Convert measurements to Python tuples (reuse existing code)
-        auto PyUnicode_FromString_Safe = [](const std::string& str) -> PyObject* {
-            return PyUnicode_FromString(str.c_str());
-        };
-        
-        constexpr size_t TUPLE_SIZE = 0
-        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) + 1
-        #include "../include/measurement_fields.def"
-        #undef MEASUREMENT_FIELD
-        ;
-        
-        PyObject* tuple_list = PyList_New(measurements.size());
-        if (!tuple_list) return nullptr;
-        
-        for (size_t i = 0; i < measurements.size(); ++i) {
-            const auto& m = measurements[i];
+        MeasurementBatch measurements;
+        std::vector<std::pair<std::string, uint32_t>> new_device_mappings;
+        std::vector<std::pair<std::string, uint32_t>> new_param_mappings;
+        {
+            ScopedGILRelease released;
+            id_manager.load_existing_mappings_from_python(device_mappings, param_mappings);
+            measurements = processor.process_stdf_file_to_batch(std::string(filepath));
             
-            PyObject* tuple = PyTuple_New(TUPLE_SIZE);
-            if (!tuple) {
-                Py_DECREF(tuple_list);
-                return nullptr;
-            }
-            
-            size_t field_index = 0;
-            #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
-                PyTuple_SetItem(tuple, field_index++, python_conversion(m.name));
-            
-            #include "../include/measurement_fields.def"
-            #undef MEASUREMENT_FIELD
-            
-            PyList_SetItem(tuple_list, i, tuple);
+            // Get only new mappings for database insertion
+            new_device_mappings = id_manager.get_new_device_mappings();
+            new_param_mappings = id_manager.get_new_param_mappings();
         }
         
-        // Get only new mappings for database insertion
-        auto new_device_mappings = id_manager.get_new_device_mappings();
-        auto new_param_mappings = id_manager.get_new_param_mappings();
+        // Convert measurements to Python tuples (reuse existing code)
+        PyObject* tuple_list = measurement_batch_to_tuple_list(measurements);
+        if (!tuple_list) return nullptr;
         
-        std::cout << "🆕 Found " << new_device_mappings.size() << " new devices, " 
+        ConsoleLog::out() << "🆕 Found " << new_device_mappings.size() << " new devices, " 
                   << new_param_mappings.size() << " new parameters to insert" << std::endl;
         
         // Create result dictionary
@@ -422,25 +1620,14 @@ static PyObject* process_stdf_with_database_mappings(PyObject* self, PyObject* a
                            PyFloat_FromDouble(processor.get_parsing_time()));
         PyDict_SetItemString(result_dict, "processing_time", 
                            PyFloat_FromDouble(processor.get_processing_time()));
+        PyDict_SetItemString(result_dict, "file_hash", safe_unicode_from_string(processor.get_file_hash()));
         
         // Add only NEW mappings for database insertion
-        PyObject* new_device_list = PyList_New(new_device_mappings.size());
-        for (size_t i = 0; i < new_device_mappings.size(); ++i) {
-            PyObject* mapping = PyTuple_New(2);
-            PyTuple_SetItem(mapping, 0, PyUnicode_FromString(new_device_mappings[i].first.c_str()));
-            PyTuple_SetItem(mapping, 1, PyLong_FromUnsignedLong(new_device_mappings[i].second));
-            PyList_SetItem(new_device_list, i, mapping);
-        }
-        PyDict_SetItemString(result_dict, "new_device_mappings", new_device_list);
-        
-        PyObject* new_param_list = PyList_New(new_param_mappings.size());
-        for (size_t i = 0; i < new_param_mappings.size(); ++i) {
-            PyObject* mapping = PyTuple_New(2);
-            PyTuple_SetItem(mapping, 0, PyUnicode_FromString(new_param_mappings[i].first.c_str()));
-            PyTuple_SetItem(mapping, 1, PyLong_FromUnsignedLong(new_param_mappings[i].second));
-            PyList_SetItem(new_param_list, i, mapping);
-        }
-        PyDict_SetItemString(result_dict, "new_param_mappings", new_param_list);
+        PyDict_SetItemString(result_dict, "new_device_mappings", id_mappings_to_list(new_device_mappings));
+        PyDict_SetItemString(result_dict, "new_param_mappings", id_mappings_to_list(new_param_mappings));
+        set_dict_item(result_dict, "test_summaries", test_summaries_to_list(processor.get_test_summaries()));
+        set_dict_item(result_dict, "bin_summaries", bin_counts_to_list(processor.get_bin_summary().bins()));
+        set_dict_item(result_dict, "site_yields", site_yields_to_list(processor.get_bin_summary().yields()));
         
         return result_dict;
         
@@ -450,19 +1637,1468 @@ static PyObject* process_stdf_with_database_mappings(PyObject* self, PyObject* a
     }
 }
 
-// Method definitions
-static PyMethodDef StdfParserMethods[] = {
-    {"parse_stdf_file", parse_stdf_file, METH_VARARGS,
-     "Parse STDF file and return list of records"},
-    {"precompute_measurement_fields", precompute_measurement_fields, METH_VARARGS,
-     "Pre-compute expensive measurement fields in C++"},
-    {"process_stdf_to_clickhouse_tuples", process_stdf_to_clickhouse_tuples, METH_VARARGS,
-     "🚀 ULTRA-FAST: Process STDF to ClickHouse tuples entirely in C++"},
-    {"process_stdf_with_database_mappings", process_stdf_with_database_mappings, METH_VARARGS,
-     "🔧 DATABASE-AWARE: Process STDF with existing database mappings and optional file hash"},
-    {"get_version", get_version, METH_NOARGS,
-     "Get version information"},
-    {nullptr, nullptr, 0, nullptr}
+// Shared by process_stdf_to_columns and process_stdf_to_arrow: parses their
+// arguments and processes the file into a ColumnarResult (nullptr with a
+// Python error set on failure)
+static std::shared_ptr<ColumnarResult> process_columnar(PyObject* args) {
+    const char* filepath;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* file_hash = "";
+    const char* backend_name = nullptr;
+    STDFParserBackend backend;
+    
+    Py_ssize_t num_threads = 1;
+    PyObject* patterns_object = nullptr;
+    std::vector<std::string> test_patterns;
+    bool has_patterns = false;
+    
+    // Parse arguments: filepath, then the optional arguments of process_stdf_with_database_mappings
+    if (!PyArg_ParseTuple(args, "s|OOssnO", &filepath, &device_mappings_list, &param_mappings_list, &file_hash,
+                          &backend_name, &num_threads, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    try {
+        auto owner = std::make_shared<ColumnarResult>();
+        UltraFastProcessor& processor = owner->processor;
+        processor.set_parser_backend(backend);
+        processor.set_num_threads(static_cast<size_t>(num_threads));
+        if (has_patterns) {
+            processor.set_test_filter_patterns(test_patterns);
+        }
+        if (file_hash && strlen(file_hash) > 0) {
+            processor.set_file_hash(std::string(file_hash));
+        }
+        
+        std::vector<std::pair<std::string, uint32_t>> device_mappings;
+        std::vector<std::pair<std::string, uint32_t>> param_mappings;
+        parse_id_mappings(device_mappings_list, device_mappings);
+        parse_id_mappings(param_mappings_list, param_mappings);
+        
+        auto& id_manager = const_cast<FastIDManager&>(processor.get_id_manager());
+        {
+            ScopedGILRelease released;
+            id_manager.load_existing_mappings_from_python(device_mappings, param_mappings);
+            owner->batch = processor.process_stdf_file_to_batch(std::string(filepath));
+        }
+        return owner;
+        
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return nullptr;
+    }
+}
+
+// Result dict of a columnar call; takes over the reference to data
+static PyObject* columnar_result_dict(const ColumnarResult& result, const char* data_key, PyObject* data) {
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        Py_DECREF(data);
+        return nullptr;
+    }
+    
+    const UltraFastProcessor& processor = result.processor;
+    const FastIDManager& id_manager = processor.get_id_manager();
+    set_dict_item(result_dict, data_key, data);
+    set_dict_item(result_dict, "row_count", PyLong_FromSize_t(result.batch.size()));
+    set_dict_item(result_dict, "total_records", PyLong_FromSize_t(processor.get_total_records()));
+    set_dict_item(result_dict, "total_measurements", PyLong_FromSize_t(processor.get_processed_measurements()));
+    set_dict_item(result_dict, "parsing_time", PyFloat_FromDouble(processor.get_parsing_time()));
+    set_dict_item(result_dict, "processing_time", PyFloat_FromDouble(processor.get_processing_time()));
+    set_dict_item(result_dict, "file_hash", safe_unicode_from_string(processor.get_file_hash()));
+    set_dict_item(result_dict, "new_device_mappings", id_mappings_to_list(id_manager.get_new_device_mappings()));
+    set_dict_item(result_dict, "new_param_mappings", id_mappings_to_list(id_manager.get_new_param_mappings()));
+    set_dict_item(result_dict, "test_summaries", test_summaries_to_list(processor.get_test_summaries()));
+    set_dict_item(result_dict, "bin_summaries", bin_counts_to_list(processor.get_bin_summary().bins()));
+    set_dict_item(result_dict, "site_yields", site_yields_to_list(processor.get_bin_summary().yields()));
+    return result_dict;
+}
+
+// 🚀 COLUMNAR: Process STDF into one zero-copy buffer per measurement field
+static PyObject* process_stdf_to_columns(PyObject* /*self*/, PyObject* args) {
+    std::shared_ptr<ColumnarResult> owner = process_columnar(args);
+    if (!owner) {
+        return nullptr;
+    }
+    PyObject* columns = measurement_batch_to_columns(owner, owner->batch);
+    if (!columns) {
+        return nullptr;
+    }
+    return columnar_result_dict(*owner, "columns", columns);
+}
+
+// 🚀 ARROW: Same rows as an Arrow record batch (C Data Interface); pass
+// result["batch"] to pyarrow.record_batch(), polars.from_arrow(), ...
+static PyObject* process_stdf_to_arrow(PyObject* /*self*/, PyObject* args) {
+    std::shared_ptr<ColumnarResult> owner = process_columnar(args);
+    if (!owner) {
+        return nullptr;
+    }
+    PyObject* batch = new_arrow_batch(owner, owner->batch);
+    if (!batch) {
+        return nullptr;
+    }
+    return columnar_result_dict(*owner, "batch", batch);
+}
+
+// 🚀 STREAMING: Iterate over measurement batches while the file is still being processed
+static PyObject* iter_measurements(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    Py_ssize_t batch_size = 100000;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* file_hash = "";
+    const char* backend_name = nullptr;
+    STDFParserBackend backend;
+    Py_ssize_t num_threads = 1;
+    PyObject* patterns_object = nullptr;
+    std::vector<std::string> test_patterns;
+    bool has_patterns = false;
+    
+    // Parse arguments: filepath, batch_size (optional), then the optional arguments of process_stdf_to_columns
+    if (!PyArg_ParseTuple(args, "s|nOOssnO", &filepath, &batch_size, &device_mappings_list, &param_mappings_list,
+                          &file_hash, &backend_name, &num_threads, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (batch_size <= 0) {
+        PyErr_SetString(PyExc_ValueError, "batch_size must be > 0");
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    auto* iterator = PyObject_New(MeasurementIteratorObject, MeasurementIteratorType);
+    if (!iterator) {
+        return nullptr;
+    }
+    iterator->stream = new MeasurementStream();
+    
+    UltraFastProcessor& processor = iterator->stream->processor();
+    processor.set_parser_backend(backend);
+    processor.set_num_threads(static_cast<size_t>(num_threads));
+    if (has_patterns) {
+        processor.set_test_filter_patterns(test_patterns);
+    }
+    if (file_hash && strlen(file_hash) > 0) {
+        processor.set_file_hash(std::string(file_hash));
+    }
+    const_cast<FastIDManager&>(processor.get_id_manager()).load_existing_mappings_from_python(device_mappings,
+                                                                                             param_mappings);
+    iterator->stream->start(filepath, static_cast<size_t>(batch_size));
+    return reinterpret_cast<PyObject*>(iterator);
+}
+
+// Processor following one STDF file while the tester writes it
+struct StdfFollowerObject {
+    PyObject_HEAD
+    UltraFastProcessor* processor;
+};
+
+static PyTypeObject* StdfFollowerType = nullptr;
+
+static void stdf_follower_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    delete reinterpret_cast<StdfFollowerObject*>(self)->processor;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyObject* stdf_follower_poll(PyObject* self, PyObject* /*args*/) {
+    UltraFastProcessor* processor = reinterpret_cast<StdfFollowerObject*>(self)->processor;
+    MeasurementBatch measurements;
+    bool polled;
+    {
+        ScopedGILRelease released;
+        polled = processor->poll_followed_file(0, [&measurements](MeasurementBatch& batch) {
+            measurements = std::move(batch);
+            return true;
+        });
+    }
+    if (!polled) {
+        PyErr_SetString(PyExc_RuntimeError, processor->get_last_error().c_str());
+        return nullptr;
+    }
+    return measurement_batch_to_tuple_list(measurements);
+}
+
+static PyObject* stdf_follower_stats(PyObject* self, PyObject* /*args*/) {
+    const UltraFastProcessor* processor = reinterpret_cast<StdfFollowerObject*>(self)->processor;
+    const STDFTailReader* tail = processor->followed_file();
+    const FastIDManager& id_manager = processor->get_id_manager();
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "complete", PyBool_FromLong(tail->complete()));
+    set_dict_item(result_dict, "offset", PyLong_FromUnsignedLongLong(tail->offset()));
+    set_dict_item(result_dict, "pending_bytes", PyLong_FromUnsignedLongLong(tail->pending_bytes()));
+    set_dict_item(result_dict, "total_records", PyLong_FromSize_t(tail->record_count()));
+    set_dict_item(result_dict, "new_records", PyLong_FromSize_t(tail->last_poll_records()));
+    set_dict_item(result_dict, "open_part_tests", PyLong_FromSize_t(processor->open_part_tests()));
+    set_dict_item(result_dict, "total_measurements", PyLong_FromSize_t(processor->get_processed_measurements()));
+    set_dict_item(result_dict, "parsing_time", PyFloat_FromDouble(processor->get_parsing_time()));
+    set_dict_item(result_dict, "processing_time", PyFloat_FromDouble(processor->get_processing_time()));
+    set_dict_item(result_dict, "new_device_mappings", id_mappings_to_list(id_manager.get_new_device_mappings()));
+    set_dict_item(result_dict, "new_param_mappings", id_mappings_to_list(id_manager.get_new_param_mappings()));
+    set_dict_item(result_dict, "test_summaries", test_summaries_to_list(processor->get_test_summaries()));
+    set_dict_item(result_dict, "bin_summaries", bin_counts_to_list(processor->get_bin_summary().bins()));
+    set_dict_item(result_dict, "site_yields", site_yields_to_list(processor->get_bin_summary().yields()));
+    return result_dict;
+}
+
+static PyMethodDef stdf_follower_methods[] = {
+    {"poll", stdf_follower_poll, METH_NOARGS,
+     "Measurement tuples of the parts closed by the records appended since the last poll"},
+    {"stats", stdf_follower_stats, METH_NOARGS,
+     "Read offset, records, open-part tests, whether the MRR was read, and the last poll's "
+     "measurements, timings, summaries and new ID mappings"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot stdf_follower_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Follows an STDF file while it is written, decoding only appended records")},
+    {Py_tp_dealloc, reinterpret_cast<void*>(stdf_follower_dealloc)},
+    {Py_tp_methods, stdf_follower_methods},
+    {0, nullptr}
+};
+
+static PyType_Spec stdf_follower_spec = {
+    "stdf_parser_cpp.StdfFollower",
+    sizeof(StdfFollowerObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    stdf_follower_slots
+};
+
+// 📡 FOLLOW: Measurements of a file still being written, one poll at a time
+static PyObject* follow_stdf_file(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* file_hash = "";
+    Py_ssize_t num_threads = 1;
+    PyObject* patterns_object = nullptr;
+    std::vector<std::string> test_patterns;
+    bool has_patterns = false;
+    
+    // Parse arguments: filepath, then device_mappings, param_mappings, file_hash, num_threads, test_patterns
+    if (!PyArg_ParseTuple(args, "s|OOsnO", &filepath, &device_mappings_list, &param_mappings_list, &file_hash,
+                          &num_threads, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    std::unique_ptr<UltraFastProcessor> processor(new UltraFastProcessor());
+    processor->set_num_threads(static_cast<size_t>(num_threads));
+    if (has_patterns) {
+        processor->set_test_filter_patterns(test_patterns);
+    }
+    if (file_hash && strlen(file_hash) > 0) {
+        processor->set_file_hash(std::string(file_hash));
+    }
+    bool started;
+    {
+        ScopedGILRelease released;
+        const_cast<FastIDManager&>(processor->get_id_manager()).load_existing_mappings_from_python(device_mappings,
+                                                                                                  param_mappings);
+        started = processor->start_following(filepath);
+    }
+    if (!started) {
+        PyErr_SetString(PyExc_RuntimeError, processor->get_last_error().c_str());
+        return nullptr;
+    }
+    
+    auto* object = PyObject_New(StdfFollowerObject, StdfFollowerType);
+    if (!object) {
+        return nullptr;
+    }
+    object->processor = processor.release();
+    return reinterpret_cast<PyObject*>(object);
+}
+
+// 🚀 BATCH: Process many STDF files natively on a work-stealing pool
+static PyObject* process_stdf_files(PyObject* /*self*/, PyObject* args) {
+    PyObject* paths_object;
+    Py_ssize_t num_threads = 0;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* backend_name = nullptr;
+    PyObject* patterns_object = nullptr;
+    PyObject* hashes_object = nullptr;
+    const char* manifest_path = nullptr;
+    STDFParserBackend backend;
+    std::vector<std::string> paths;
+    std::vector<std::string> test_patterns;
+    std::vector<std::string> file_hashes;
+    bool has_patterns = false;
+    bool has_hashes = false;
+    
+    // Parse arguments: paths, num_threads (optional, 0 = one per core), device_mappings, param_mappings,
+    // backend, test_patterns, file_hashes (optional, one per path) and manifest_path (optional,
+    // files it lists as ingested are skipped)
+    if (!PyArg_ParseTuple(args, "O|nOOzOOz", &paths_object, &num_threads, &device_mappings_list,
+                          &param_mappings_list, &backend_name, &patterns_object, &hashes_object, &manifest_path)) {
+        return nullptr;
+    }
+    bool has_paths = false;
+    if (!parse_string_list(paths_object, "paths", paths, has_paths) ||
+        !parse_test_patterns(patterns_object, test_patterns, has_patterns) ||
+        !parse_string_list(hashes_object, "file_hashes", file_hashes, has_hashes)) {
+        return nullptr;
+    }
+    if (!has_paths) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list of str");
+        return nullptr;
+    }
+    if (!parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    try {
+        auto engine = std::make_shared<BatchIngestEngine>();
+        engine->set_num_threads(static_cast<size_t>(num_threads));
+        engine->set_parser_backend(backend);
+        if (has_patterns) {
+            engine->set_test_filter_patterns(test_patterns);
+        }
+        engine->set_file_hashes(file_hashes);
+        
+        IngestManifest manifest;
+        if (manifest_path && strlen(manifest_path) > 0) {
+            manifest.open(manifest_path);
+            engine->set_manifest(&manifest);
+        }
+        
+        std::vector<std::pair<std::string, uint32_t>> new_device_mappings;
+        std::vector<std::pair<std::string, uint32_t>> new_param_mappings;
+        {
+            ScopedGILRelease released;
+            engine->id_manager().load_existing_mappings_from_python(device_mappings, param_mappings);
+            engine->process_files(paths);
+            new_device_mappings = engine->id_manager().get_new_device_mappings();
+            new_param_mappings = engine->id_manager().get_new_param_mappings();
+        }
+        
+        PyObject* columns = measurement_batch_to_columns(engine, engine->measurements());
+        if (!columns) {
+            return nullptr;
+        }
+        
+        PyObject* file_list = PyList_New(engine->file_stats().size());
+        if (!file_list) {
+            Py_DECREF(columns);
+            return nullptr;
+        }
+        for (size_t i = 0; i < engine->file_stats().size(); ++i) {
+            const FileIngestStats& stats = engine->file_stats()[i];
+            PyObject* file_dict = PyDict_New();
+            PyDict_SetItemString(file_dict, "path", safe_unicode_from_string(stats.path));
+            PyDict_SetItemString(file_dict, "success", PyBool_FromLong(stats.success));
+            PyDict_SetItemString(file_dict, "skipped", PyBool_FromLong(stats.skipped));
+            PyDict_SetItemString(file_dict, "error", safe_unicode_from_string(stats.error));
+            PyDict_SetItemString(file_dict, "row_offset", PyLong_FromSize_t(stats.row_offset));
+            PyDict_SetItemString(file_dict, "total_measurements", PyLong_FromSize_t(stats.measurements));
+            PyDict_SetItemString(file_dict, "total_records", PyLong_FromSize_t(stats.total_records));
+            PyDict_SetItemString(file_dict, "parsing_time", PyFloat_FromDouble(stats.parsing_time));
+            PyDict_SetItemString(file_dict, "processing_time", PyFloat_FromDouble(stats.processing_time));
+            PyDict_SetItemString(file_dict, "file_hash", safe_unicode_from_string(stats.file_hash));
+            PyList_SetItem(file_list, i, file_dict);
+        }
+        
+        PyObject* result_dict = PyDict_New();
+        if (!result_dict) {
+            Py_DECREF(columns);
+            Py_DECREF(file_list);
+            return nullptr;
+        }
+        
+        PyDict_SetItemString(result_dict, "columns", columns);
+        Py_DECREF(columns);
+        PyDict_SetItemString(result_dict, "files", file_list);
+        Py_DECREF(file_list);
+        PyDict_SetItemString(result_dict, "row_count", PyLong_FromSize_t(engine->measurements().size()));
+        PyDict_SetItemString(result_dict, "new_device_mappings", id_mappings_to_list(new_device_mappings));
+        PyDict_SetItemString(result_dict, "new_param_mappings", id_mappings_to_list(new_param_mappings));
+        
+        return result_dict;
+        
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return nullptr;
+    }
+}
+
+// Distinct devices and cleaned parameter names across many files, without
+// generating measurements (ID discovery ahead of a full ingest)
+static PyObject* discover_devices_and_parameters(PyObject* /*self*/, PyObject* args) {
+    PyObject* paths_object;
+    Py_ssize_t num_threads = 0;
+    const char* backend_name = nullptr;
+    PyObject* patterns_object = nullptr;
+    STDFParserBackend backend = STDFParserBackend::MMAP;
+    std::vector<std::string> paths;
+    std::vector<std::string> test_patterns;
+    bool has_paths = false;
+    bool has_patterns = false;
+    
+    // Parse arguments: paths, num_threads (optional, 0 = one per core), backend (optional,
+    // default 'mmap') and test_patterns (optional)
+    if (!PyArg_ParseTuple(args, "O|nzO", &paths_object, &num_threads, &backend_name, &patterns_object)) {
+        return nullptr;
+    }
+    if (!parse_string_list(paths_object, "paths", paths, has_paths) ||
+        !parse_test_patterns(patterns_object, test_patterns, has_patterns)) {
+        return nullptr;
+    }
+    if (!has_paths) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list of str");
+        return nullptr;
+    }
+    if (backend_name && !parse_backend_name(backend_name, backend)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    try {
+        DeviceDiscovery discovery;
+        discovery.set_num_threads(static_cast<size_t>(num_threads));
+        discovery.set_parser_backend(backend);
+        if (has_patterns) {
+            discovery.set_test_filter_patterns(test_patterns);
+        }
+        bool success;
+        {
+            ScopedGILRelease released;
+            success = discovery.discover_files(paths);
+        }
+        
+        PyObject* file_list = PyList_New(discovery.file_stats().size());
+        if (!file_list) {
+            return nullptr;
+        }
+        for (size_t i = 0; i < discovery.file_stats().size(); ++i) {
+            const FileDiscovery& file = discovery.file_stats()[i];
+            PyObject* file_dict = PyDict_New();
+            set_dict_item(file_dict, "path", safe_unicode_from_string(file.path));
+            set_dict_item(file_dict, "success", PyBool_FromLong(file.success));
+            set_dict_item(file_dict, "error", safe_unicode_from_string(file.error));
+            set_dict_item(file_dict, "total_records", PyLong_FromSize_t(file.total_records));
+            set_dict_item(file_dict, "discovery_time", PyFloat_FromDouble(file.discovery_time));
+            set_dict_item(file_dict, "devices", PyLong_FromSize_t(file.devices.size()));
+            set_dict_item(file_dict, "parameters", PyLong_FromSize_t(file.parameters.size()));
+            PyList_SetItem(file_list, i, file_dict);
+        }
+        
+        PyObject* result_dict = PyDict_New();
+        if (!result_dict) {
+            Py_DECREF(file_list);
+            return nullptr;
+        }
+        set_dict_item(result_dict, "success", PyBool_FromLong(success));
+        set_dict_item(result_dict, "devices", string_list(discovery.devices()));
+        set_dict_item(result_dict, "parameters", string_list(discovery.parameters()));
+        set_dict_item(result_dict, "files", file_list);
+        set_dict_item(result_dict, "discovery_time", PyFloat_FromDouble(discovery.get_discovery_time()));
+        return result_dict;
+        
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return nullptr;
+    }
+}
+
+// Connection dict {host, port, database, user, password}; missing keys keep the defaults
+static bool parse_clickhouse_connection(PyObject* object, ClickHouseConnection& connection) {
+    if (!object || object == Py_None) {
+        return true;
+    }
+    if (!PyDict_Check(object)) {
+        PyErr_SetString(PyExc_TypeError, "connection must be a dict");
+        return false;
+    }
+    
+    std::string* text_fields[] = {&connection.host, &connection.database, &connection.user, &connection.password};
+    const char* text_keys[] = {"host", "database", "user", "password"};
+    for (size_t i = 0; i < 4; ++i) {
+        PyObject* value = PyDict_GetItemString(object, text_keys[i]);
+        if (!value) continue;
+        const char* text = PyUnicode_Check(value) ? PyUnicode_AsUTF8(value) : nullptr;
+        if (!text) {
+            PyErr_Format(PyExc_TypeError, "connection['%s'] must be a str", text_keys[i]);
+            return false;
+        }
+        *text_fields[i] = text;
+    }
+    
+    PyObject* port = PyDict_GetItemString(object, "port");
+    if (port) {
+        long value = PyLong_Check(port) ? PyLong_AsLong(port) : -1;
+        if (value <= 0 || value > 65535) {
+            PyErr_Clear();
+            PyErr_SetString(PyExc_ValueError, "connection['port'] must be an int in 1..65535");
+            return false;
+        }
+        connection.port = static_cast<uint16_t>(value);
+    }
+    return true;
+}
+
+// 'native' (default) or 'rowbinary'
+static bool parse_clickhouse_format(const char* name, ClickHouseFormat& format) {
+    if (!name || strcmp(name, "native") == 0) {
+        format = ClickHouseFormat::NATIVE;
+    } else if (strcmp(name, "rowbinary") == 0) {
+        format = ClickHouseFormat::ROW_BINARY;
+    } else {
+        PyErr_Format(PyExc_ValueError, "Unknown ClickHouse format '%s' (expected 'native' or 'rowbinary')", name);
+        return false;
+    }
+    return true;
+}
+
+// 🚀 DIRECT INSERT: Process STDF and stream it to ClickHouse without building Python rows
+static PyObject* insert_stdf_to_clickhouse(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    const char* table;
+    PyObject* connection_object = nullptr;
+    PyObject* columns_object = nullptr;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* file_hash = "";
+    const char* format_name = "native";
+    ClickHouseConnection connection;
+    std::vector<std::string> columns;
+    bool has_columns = false;
+    
+    // Parse arguments: filepath, table, connection (optional dict), columns (optional, default all fields),
+    // device_mappings, param_mappings, file_hash and format ('native' or 'rowbinary')
+    if (!PyArg_ParseTuple(args, "ss|OOOOss", &filepath, &table, &connection_object, &columns_object,
+                          &device_mappings_list, &param_mappings_list, &file_hash, &format_name)) {
+        return nullptr;
+    }
+    if (!parse_clickhouse_connection(connection_object, connection) ||
+        !parse_string_list(columns_object, "columns", columns, has_columns)) {
+        return nullptr;
+    }
+    
+    ClickHouseFormat format;
+    if (!parse_clickhouse_format(format_name, format)) {
+        return nullptr;
+    }
+    
+    ClickHouseBlockEncoder encoder;
+    if (!encoder.set_columns(columns)) {
+        PyErr_SetString(PyExc_ValueError, encoder.get_last_error().c_str());
+        return nullptr;
+    }
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    try {
+        UltraFastProcessor processor;
+        if (file_hash && strlen(file_hash) > 0) {
+            processor.set_file_hash(std::string(file_hash));
+        }
+        
+        ClickHouseHttpInserter inserter(connection);
+        size_t row_count = 0;
+        bool inserted = false;
+        auto& id_manager = const_cast<FastIDManager&>(processor.get_id_manager());
+        {
+            ScopedGILRelease released;
+            id_manager.load_existing_mappings_from_python(device_mappings, param_mappings);
+            MeasurementBatch batch = processor.process_stdf_file_to_batch(std::string(filepath));
+            row_count = batch.size();
+            inserted = inserter.insert(table, batch, encoder, format);
+        }
+        if (!inserted) {
+            PyErr_SetString(PyExc_RuntimeError, inserter.get_last_error().c_str());
+            return nullptr;
+        }
+        
+        PyObject* result_dict = PyDict_New();
+        if (!result_dict) {
+            return nullptr;
+        }
+        
+        PyDict_SetItemString(result_dict, "rows_inserted", PyLong_FromSize_t(row_count));
+        PyDict_SetItemString(result_dict, "bytes_sent", PyLong_FromSize_t(inserter.get_bytes_sent()));
+        PyDict_SetItemString(result_dict, "total_records", 
+                           PyLong_FromSize_t(processor.get_total_records()));
+        PyDict_SetItemString(result_dict, "parsing_time", 
+                           PyFloat_FromDouble(processor.get_parsing_time()));
+        PyDict_SetItemString(result_dict, "processing_time", 
+                           PyFloat_FromDouble(processor.get_processing_time()));
+        PyDict_SetItemString(result_dict, "file_hash", safe_unicode_from_string(processor.get_file_hash()));
+        PyDict_SetItemString(result_dict, "new_device_mappings", id_mappings_to_list(id_manager.get_new_device_mappings()));
+        PyDict_SetItemString(result_dict, "new_param_mappings", id_mappings_to_list(id_manager.get_new_param_mappings()));
+        
+        return result_dict;
+        
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return nullptr;
+    }
+}
+
+// 🚀 PIPELINE: Decode many STDF files and insert them through a bounded block queue
+static PyObject* insert_stdf_files_to_clickhouse(PyObject* /*self*/, PyObject* args) {
+    PyObject* paths_object;
+    const char* table;
+    PyObject* connection_object = nullptr;
+    PyObject* columns_object = nullptr;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* format_name = nullptr;
+    Py_ssize_t decode_threads = 0;
+    Py_ssize_t insert_threads = 2;
+    Py_ssize_t queue_depth = 4;
+    Py_ssize_t block_rows = 1 << 20;
+    const char* manifest_path = nullptr;
+    const char* spool_dir = nullptr;
+    Py_ssize_t coalesce_rows = 0;
+    Py_ssize_t coalesce_bytes = 0;
+    ClickHouseConnection connection;
+    std::vector<std::string> paths;
+    std::vector<std::string> columns;
+    bool has_paths = false;
+    bool has_columns = false;
+    
+    // Parse arguments: paths, table, connection, columns, device_mappings, param_mappings, format,
+    // decode_threads (0 = one per core), insert_threads, queue_depth (blocks), block_rows,
+    // manifest_path (listed files are skipped, fully inserted ones are recorded), spool_dir
+    // (blocks are kept there until inserted, see InsertSpool), coalesce_rows and coalesce_bytes
+    // (the last rows of small files share INSERTs up to these, 0 = off); all but the first two optional
+    if (!PyArg_ParseTuple(args, "Os|OOOOznnnnzznn", &paths_object, &table, &connection_object, &columns_object,
+                          &device_mappings_list, &param_mappings_list, &format_name, &decode_threads,
+                          &insert_threads, &queue_depth, &block_rows, &manifest_path, &spool_dir,
+                          &coalesce_rows, &coalesce_bytes)) {
+        return nullptr;
+    }
+    if (!parse_string_list(paths_object, "paths", paths, has_paths) ||
+        !parse_clickhouse_connection(connection_object, connection) ||
+        !parse_string_list(columns_object, "columns", columns, has_columns)) {
+        return nullptr;
+    }
+    if (!has_paths) {
+        PyErr_SetString(PyExc_TypeError, "paths must be a list of str");
+        return nullptr;
+    }
+    ClickHouseFormat format;
+    if (!parse_clickhouse_format(format_name, format)) {
+        return nullptr;
+    }
+    if (decode_threads < 0 || insert_threads <= 0 || queue_depth <= 0 || block_rows <= 0 || coalesce_rows < 0 ||
+        coalesce_bytes < 0) {
+        PyErr_SetString(PyExc_ValueError, "decode_threads, coalesce_rows and coalesce_bytes must be >= 0; "
+                                          "insert_threads, queue_depth and block_rows > 0");
+        return nullptr;
+    }
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    try {
+        InsertPipeline pipeline(connection);
+        if (!pipeline.encoder().set_columns(columns)) {
+            PyErr_SetString(PyExc_ValueError, pipeline.encoder().get_last_error().c_str());
+            return nullptr;
+        }
+        pipeline.set_format(format);
+        pipeline.set_decode_threads(static_cast<size_t>(decode_threads));
+        pipeline.set_insert_threads(static_cast<size_t>(insert_threads));
+        pipeline.set_queue_depth(static_cast<size_t>(queue_depth));
+        pipeline.set_block_rows(static_cast<size_t>(block_rows));
+        pipeline.set_coalesce_rows(static_cast<size_t>(coalesce_rows));
+        pipeline.set_coalesce_bytes(static_cast<size_t>(coalesce_bytes));
+        
+        IngestManifest manifest;
+        bool use_manifest = manifest_path && strlen(manifest_path) > 0;
+        if (use_manifest) {
+            manifest.open(manifest_path);
+            pipeline.set_manifest(&manifest);
+        }
+        InsertSpool spool;
+        if (spool_dir && strlen(spool_dir) > 0) {
+            if (!spool.open(spool_dir)) {
+                PyErr_SetString(PyExc_OSError, spool.get_last_error().c_str());
+                return nullptr;
+            }
+            pipeline.set_insert_spool(&spool);
+        }
+        
+        std::vector<std::pair<std::string, uint32_t>> new_device_mappings;
+        std::vector<std::pair<std::string, uint32_t>> new_param_mappings;
+        {
+            ScopedGILRelease released;
+            pipeline.id_manager().load_existing_mappings_from_python(device_mappings, param_mappings);
+            pipeline.run(table, paths);
+            new_device_mappings = pipeline.id_manager().get_new_device_mappings();
+            new_param_mappings = pipeline.id_manager().get_new_param_mappings();
+            // Every row of these files is in the table now
+            for (const auto& stats : pipeline.file_stats()) {
+                if (use_manifest && !stats.skipped) {
+                    manifest.record(stats.path, stats.file_hash,
+                                    stats.success ? ManifestStatus::INGESTED : ManifestStatus::FAILED);
+                }
+            }
+        }
+        
+        PyObject* file_list = file_ingest_stats_to_list(pipeline.file_stats());
+        if (!file_list) {
+            return nullptr;
+        }
+        
+        PyObject* result_dict = PyDict_New();
+        if (!result_dict) {
+            Py_DECREF(file_list);
+            return nullptr;
+        }
+        
+        const InsertPipelineStats& totals = pipeline.stats();
+        PyDict_SetItemString(result_dict, "files", file_list);
+        Py_DECREF(file_list);
+        PyDict_SetItemString(result_dict, "success", PyBool_FromLong(pipeline.get_last_error().empty()));
+        PyDict_SetItemString(result_dict, "error", safe_unicode_from_string(pipeline.get_last_error()));
+        PyDict_SetItemString(result_dict, "rows_inserted", PyLong_FromSize_t(totals.rows_inserted));
+        PyDict_SetItemString(result_dict, "blocks_inserted", PyLong_FromSize_t(totals.blocks_inserted));
+        PyDict_SetItemString(result_dict, "bytes_sent", PyLong_FromSize_t(totals.bytes_sent));
+        set_dict_item(result_dict, "blocks_spooled", PyLong_FromSize_t(totals.blocks_spooled));
+        set_dict_item(result_dict, "blocks_replayed", PyLong_FromSize_t(totals.blocks_replayed));
+        set_dict_item(result_dict, "blocks_pending", PyLong_FromSize_t(totals.blocks_pending));
+        set_dict_item(result_dict, "files_coalesced", PyLong_FromSize_t(totals.files_coalesced));
+        set_dict_item(result_dict, "files_prefetched", PyLong_FromSize_t(totals.files_prefetched));
+        set_dict_item(result_dict, "bytes_prefetched", PyLong_FromUnsignedLongLong(totals.bytes_prefetched));
+        PyDict_SetItemString(result_dict, "peak_queue_depth", PyLong_FromSize_t(totals.peak_queue_depth));
+        PyDict_SetItemString(result_dict, "backpressure_time", PyFloat_FromDouble(totals.backpressure_time));
+        PyDict_SetItemString(result_dict, "total_time", PyFloat_FromDouble(totals.total_time));
+        PyDict_SetItemString(result_dict, "new_device_mappings", id_mappings_to_list(new_device_mappings));
+        PyDict_SetItemString(result_dict, "new_param_mappings", id_mappings_to_list(new_param_mappings));
+        
+        return result_dict;
+        
+    } catch (const std::exception& e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        return nullptr;
+    }
+}
+
+// 📦 SPOOL: Send the blocks an insert spool holds, without re-reading any STDF
+static PyObject* replay_insert_spool(PyObject* /*self*/, PyObject* args) {
+    const char* spool_dir;
+    PyObject* connection_object = nullptr;
+    ClickHouseConnection connection;
+    
+    // Parse arguments: spool_dir, connection (optional)
+    if (!PyArg_ParseTuple(args, "s|O", &spool_dir, &connection_object)) {
+        return nullptr;
+    }
+    if (!parse_clickhouse_connection(connection_object, connection)) {
+        return nullptr;
+    }
+    
+    InsertSpool spool;
+    bool replayed = false;
+    {
+        ScopedGILRelease released;
+        if (spool.open(spool_dir)) {
+            ClickHouseHttpInserter inserter(connection);
+            replayed = spool.replay(inserter);
+        }
+    }
+    if (!spool.is_open()) {
+        PyErr_SetString(PyExc_OSError, spool.get_last_error().c_str());
+        return nullptr;
+    }
+    
+    const InsertSpoolStats stats = spool.stats();
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "success", PyBool_FromLong(replayed));
+    set_dict_item(result_dict, "error", safe_unicode_from_string(spool.get_last_error()));
+    set_dict_item(result_dict, "blocks_replayed", PyLong_FromSize_t(stats.replayed));
+    set_dict_item(result_dict, "blocks_pending", PyLong_FromSize_t(spool.pending_count()));
+    set_dict_item(result_dict, "blocks_discarded", PyLong_FromSize_t(stats.discarded));
+    set_dict_item(result_dict, "blocks_corrupt", PyLong_FromSize_t(stats.corrupt));
+    return result_dict;
+}
+
+// Watch-folder ingest running on a native thread (IngestDaemon); the ID
+// maps, connections and manifest stay warm between files
+struct IngestDaemonObject {
+    PyObject_HEAD
+    IngestDaemon* daemon;
+};
+
+static PyTypeObject* IngestDaemonType = nullptr;
+
+static void ingest_daemon_dealloc(PyObject* self) {
+    PyTypeObject* type = Py_TYPE(self);
+    IngestDaemon* daemon = reinterpret_cast<IngestDaemonObject*>(self)->daemon;
+    if (daemon) {
+        // Waits for the batch being inserted
+        ScopedGILRelease released;
+        delete daemon;
+    }
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyObject* ingest_daemon_poll(PyObject* self, PyObject* /*args*/) {
+    IngestDaemon* daemon = reinterpret_cast<IngestDaemonObject*>(self)->daemon;
+    std::vector<FileIngestStats> files = daemon->take_results();
+    std::vector<std::pair<std::string, uint32_t>> new_device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> new_param_mappings;
+    daemon->take_new_mappings(new_device_mappings, new_param_mappings);
+    
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "files", file_ingest_stats_to_list(files));
+    set_dict_item(result_dict, "new_device_mappings", id_mappings_to_list(new_device_mappings));
+    set_dict_item(result_dict, "new_param_mappings", id_mappings_to_list(new_param_mappings));
+    return result_dict;
+}
+
+static PyObject* ingest_daemon_stats(PyObject* self, PyObject* /*args*/) {
+    IngestDaemon* daemon = reinterpret_cast<IngestDaemonObject*>(self)->daemon;
+    const IngestDaemonStats stats = daemon->stats();
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) {
+        return nullptr;
+    }
+    set_dict_item(result_dict, "running", PyBool_FromLong(daemon->is_running()));
+    set_dict_item(result_dict, "watch_backend", PyUnicode_FromString(daemon->watch_backend()));
+    set_dict_item(result_dict, "error", safe_unicode_from_string(daemon->get_last_error()));
+    set_dict_item(result_dict, "batches", PyLong_FromSize_t(stats.batches));
+    set_dict_item(result_dict, "files_ingested", PyLong_FromSize_t(stats.files_ingested));
+    set_dict_item(result_dict, "files_skipped", PyLong_FromSize_t(stats.files_skipped));
+    set_dict_item(result_dict, "files_failed", PyLong_FromSize_t(stats.files_failed));
+    set_dict_item(result_dict, "rows_inserted", PyLong_FromSize_t(stats.rows_inserted));
+    set_dict_item(result_dict, "connections_opened", PyLong_FromSize_t(stats.connections_opened));
+    set_dict_item(result_dict, "last_latency", PyFloat_FromDouble(stats.last_latency));
+    set_dict_item(result_dict, "max_latency", PyFloat_FromDouble(stats.max_latency));
+    return result_dict;
+}
+
+static PyObject* ingest_daemon_stop(PyObject* self, PyObject* /*args*/) {
+    IngestDaemon* daemon = reinterpret_cast<IngestDaemonObject*>(self)->daemon;
+    {
+        ScopedGILRelease released;
+        daemon->stop();
+    }
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef ingest_daemon_methods[] = {
+    {"poll", ingest_daemon_poll, METH_NOARGS,
+     "Files finished and ID mappings assigned since the last poll (write the mappings to the dimension tables)"},
+    {"stats", ingest_daemon_stats, METH_NOARGS,
+     "Totals since start: batches, files, rows, connections opened, arrival-to-insert latency"},
+    {"stop", ingest_daemon_stop, METH_NOARGS,
+     "Stop watching once the batch being inserted is done"},
+    {nullptr, nullptr, 0, nullptr}
+};
+
+static PyType_Slot ingest_daemon_slots[] = {
+    {Py_tp_doc, const_cast<char*>("Inserts STDF files dropped into watched directories as they arrive")},
+    {Py_tp_dealloc, reinterpret_cast<void*>(ingest_daemon_dealloc)},
+    {Py_tp_methods, ingest_daemon_methods},
+    {0, nullptr}
+};
+
+static PyType_Spec ingest_daemon_spec = {
+    "stdf_parser_cpp.IngestDaemon",
+    sizeof(IngestDaemonObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    ingest_daemon_slots
+};
+
+// 🚀 DAEMON: Watch drop folders and insert new files within seconds of arrival
+static PyObject* start_ingest_daemon(PyObject* /*self*/, PyObject* args) {
+    PyObject* directories_object;
+    const char* table;
+    PyObject* connection_object = nullptr;
+    PyObject* columns_object = nullptr;
+    PyObject* device_mappings_list = nullptr;
+    PyObject* param_mappings_list = nullptr;
+    const char* format_name = nullptr;
+    Py_ssize_t decode_threads = 0;
+    Py_ssize_t insert_threads = 2;
+    const char* manifest_path = nullptr;
+    double batch_window = 0.5;
+    double settle_time = 2.0;
+    int ingest_existing = 1;
+    Py_ssize_t coalesce_rows = 0;
+    IngestDaemonConfig config;
+    std::vector<std::string> columns;
+    bool has_directories = false;
+    bool has_columns = false;
+    
+    // Parse arguments: directories, table, then as insert_stdf_files_to_clickhouse: connection, columns,
+    // device_mappings, param_mappings, format, decode_threads, insert_threads, manifest_path; then
+    // batch_window and settle_time (seconds), ingest_existing and coalesce_rows (small files of a
+    // batch share INSERTs of at least this many rows); all but the first two optional
+    if (!PyArg_ParseTuple(args, "Os|OOOOznnzddpn", &directories_object, &table, &connection_object,
+                          &columns_object, &device_mappings_list, &param_mappings_list, &format_name,
+                          &decode_threads, &insert_threads, &manifest_path, &batch_window, &settle_time,
+                          &ingest_existing, &coalesce_rows)) {
+        return nullptr;
+    }
+    if (!parse_string_list(directories_object, "directories", config.directories, has_directories) ||
+        !parse_clickhouse_connection(connection_object, config.connection) ||
+        !parse_string_list(columns_object, "columns", columns, has_columns)) {
+        return nullptr;
+    }
+    if (!has_directories) {
+        PyErr_SetString(PyExc_TypeError, "directories must be a list of str");
+        return nullptr;
+    }
+    ClickHouseFormat format;
+    if (!parse_clickhouse_format(format_name, format)) {
+        return nullptr;
+    }
+    if (decode_threads < 0 || insert_threads <= 0 || batch_window < 0.0 || settle_time < 0.0 || coalesce_rows < 0) {
+        PyErr_SetString(PyExc_ValueError,
+                        "decode_threads, batch_window, settle_time and coalesce_rows must be >= 0; insert_threads > 0");
+        return nullptr;
+    }
+    config.table = table;
+    config.manifest_path = manifest_path ? manifest_path : "";
+    config.decode_threads = static_cast<size_t>(decode_threads);
+    config.insert_threads = static_cast<size_t>(insert_threads);
+    config.batch_window = std::chrono::milliseconds(static_cast<int64_t>(batch_window * 1000.0));
+    config.settle_time = std::chrono::milliseconds(static_cast<int64_t>(settle_time * 1000.0));
+    config.ingest_existing = ingest_existing != 0;
+    config.coalesce_rows = static_cast<size_t>(coalesce_rows);
+    
+    std::vector<std::pair<std::string, uint32_t>> device_mappings;
+    std::vector<std::pair<std::string, uint32_t>> param_mappings;
+    parse_id_mappings(device_mappings_list, device_mappings);
+    parse_id_mappings(param_mappings_list, param_mappings);
+    
+    std::unique_ptr<IngestDaemon> daemon(new IngestDaemon(config));
+    if (!daemon->pipeline().encoder().set_columns(columns)) {
+        PyErr_SetString(PyExc_ValueError, daemon->pipeline().encoder().get_last_error().c_str());
+        return nullptr;
+    }
+    daemon->pipeline().set_format(format);
+    bool started;
+    {
+        ScopedGILRelease released;
+        daemon->pipeline().id_manager().load_existing_mappings_from_python(device_mappings, param_mappings);
+        started = daemon->start();
+    }
+    if (!started) {
+        PyErr_SetString(PyExc_RuntimeError, daemon->get_last_error().c_str());
+        return nullptr;
+    }
+    
+    auto* object = PyObject_New(IngestDaemonObject, IngestDaemonType);
+    if (!object) {
+        ScopedGILRelease released;
+        daemon.reset();
+        return nullptr;
+    }
+    object->daemon = daemon.release();
+    return reinterpret_cast<PyObject*>(object);
+}
+
+// Paths of a list that the manifest does not list as ingested (or that changed since)
+static PyObject* filter_unprocessed_files(PyObject* /*self*/, PyObject* args) {
+    const char* manifest_path;
+    PyObject* paths_object;
+    std::vector<std::string> paths;
+    bool has_paths = false;
+    
+    if (!PyArg_ParseTuple(args, "sO", &manifest_path, &paths_object)) {
+        return nullptr;
+    }
+    if (!parse_string_list(paths_object, "paths", paths, has_paths)) {
+        return nullptr;
+    }
+    
+    std::vector<std::string> pending;
+    {
+        ScopedGILRelease released;
+        IngestManifest manifest;
+        manifest.open(manifest_path);
+        for (const auto& path : paths) {
+            if (!manifest.is_ingested(path)) {
+                pending.push_back(path);
+            }
+        }
+    }
+    
+    PyObject* list = PyList_New(pending.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+        PyList_SetItem(list, i, safe_unicode_from_string(pending[i]));
+    }
+    return list;
+}
+
+// Append files (with their content hashes) to the manifest once their rows are stored
+static PyObject* record_ingested_files(PyObject* /*self*/, PyObject* args) {
+    const char* manifest_path;
+    PyObject* paths_object;
+    PyObject* hashes_object = nullptr;
+    int failed = 0;
+    std::vector<std::string> paths;
+    std::vector<std::string> hashes;
+    bool has_paths = false;
+    bool has_hashes = false;
+    
+    // Parse arguments: manifest_path, paths, file_hashes (optional, one per path), failed (optional)
+    if (!PyArg_ParseTuple(args, "sO|Op", &manifest_path, &paths_object, &hashes_object, &failed)) {
+        return nullptr;
+    }
+    if (!parse_string_list(paths_object, "paths", paths, has_paths) ||
+        !parse_string_list(hashes_object, "file_hashes", hashes, has_hashes)) {
+        return nullptr;
+    }
+    if (has_hashes && hashes.size() != paths.size()) {
+        PyErr_SetString(PyExc_ValueError, "file_hashes must have one entry per path");
+        return nullptr;
+    }
+    
+    size_t recorded = 0;
+    std::string error;
+    {
+        ScopedGILRelease released;
+        IngestManifest manifest;
+        manifest.open(manifest_path);
+        ManifestStatus status = failed ? ManifestStatus::FAILED : ManifestStatus::INGESTED;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (manifest.record(paths[i], has_hashes ? hashes[i] : std::string(), status)) {
+                recorded++;
+            } else if (error.empty()) {
+                error = manifest.get_last_error();
+            }
+        }
+    }
+    
+    if (recorded < paths.size() && !error.empty()) {
+        ConsoleLog::err() << "⚠️ " << (paths.size() - recorded) << " file(s) not recorded: " << error << std::endl;
+    }
+    return PyLong_FromSize_t(recorded);
+}
+
+
+static PyObject* string_map_to_dict(const std::map<std::string, std::string>& fields) {
+    PyObject* dict = PyDict_New();
+    if (!dict) return nullptr;
+    for (const auto& field : fields) {
+        set_dict_item(dict, field.first.c_str(), safe_unicode_from_string(field.second));
+    }
+    return dict;
+}
+
+struct ScanResult {
+    std::string filepath;
+    bool success = false;
+    STDFScanSummary summary;
+    std::string content_hash;
+};
+
+static ScanResult scan_one_file(const std::string& filepath) {
+    ScanResult result;
+    result.filepath = filepath;
+    STDFParser parser;
+    result.success = parser.scan_file(filepath, result.summary);
+    result.content_hash = parser.get_content_hash();
+    return result;
+}
+
+static PyObject* scan_result_to_dict(const ScanResult& result) {
+    const STDFScanSummary& summary = result.summary;
+    PyObject* dict = PyDict_New();
+    if (!dict) return nullptr;
+    
+    set_dict_item(dict, "filepath", safe_unicode_from_string(result.filepath));
+    set_dict_item(dict, "success", PyBool_FromLong(result.success));
+    set_dict_item(dict, "complete", PyBool_FromLong(result.success && summary.complete()));
+    set_dict_item(dict, "truncated", PyBool_FromLong(summary.truncated));
+    set_dict_item(dict, "starts_with_far", PyBool_FromLong(summary.starts_with_far));
+    set_dict_item(dict, "has_mir", PyBool_FromLong(summary.has_mir));
+    set_dict_item(dict, "has_mrr", PyBool_FromLong(summary.has_mrr));
+    set_dict_item(dict, "ends_with_mrr", PyBool_FromLong(summary.ends_with_mrr));
+    set_dict_item(dict, "cpu_type", PyLong_FromLong(summary.cpu_type));
+    set_dict_item(dict, "stdf_version", PyLong_FromLong(summary.stdf_version));
+    set_dict_item(dict, "stdf_bytes", PyLong_FromUnsignedLongLong(summary.stdf_bytes));
+    set_dict_item(dict, "complete_bytes", PyLong_FromUnsignedLongLong(summary.complete_bytes));
+    set_dict_item(dict, "total_records", PyLong_FromUnsignedLongLong(summary.total_records));
+    set_dict_item(dict, "part_count", PyLong_FromUnsignedLongLong(summary.count(CountedRecordType::PRR)));
+    set_dict_item(dict, "wafer_count", PyLong_FromUnsignedLongLong(summary.count(CountedRecordType::WIR)));
+    set_dict_item(dict, "content_hash", safe_unicode_from_string(result.content_hash));
+    
+    PyObject* records = PyDict_New();
+    for (size_t type = 0; type < static_cast<size_t>(CountedRecordType::COUNT); ++type) {
+        if (summary.record_counts[type] == 0) continue;
+        PyObject* record_dict = PyDict_New();
+        set_dict_item(record_dict, "count", PyLong_FromUnsignedLongLong(summary.record_counts[type]));
+        set_dict_item(record_dict, "bytes", PyLong_FromUnsignedLongLong(summary.record_bytes[type]));
+        set_dict_item(records, counted_record_type_name(static_cast<CountedRecordType>(type)), record_dict);
+    }
+    set_dict_item(dict, "records", records);
+    set_dict_item(dict, "mir", string_map_to_dict(summary.mir_fields));
+    set_dict_item(dict, "mrr", string_map_to_dict(summary.mrr_fields));
+    return dict;
+}
+
+// Python function: scan_stdf_file(filepath) -> header-only summary dict
+static PyObject* scan_stdf_file(PyObject* /*self*/, PyObject* args) {
+    const char* filepath;
+    if (!PyArg_ParseTuple(args, "s", &filepath)) {
+        return nullptr;
+    }
+    
+    ScanResult result;
+    {
+        ScopedGILRelease released;
+        result = scan_one_file(filepath);
+    }
+    return scan_result_to_dict(result);
+}
+
+// Python function: scan_stdf_files(paths, num_threads=0) -> list of summary dicts, in path order
+static PyObject* scan_stdf_files(PyObject* /*self*/, PyObject* args) {
+    PyObject* paths_object;
+    Py_ssize_t num_threads = 0;
+    std::vector<std::string> paths;
+    bool has_paths = false;
+    
+    // Parse arguments: paths, num_threads (optional, 0 = one per core)
+    if (!PyArg_ParseTuple(args, "O|n", &paths_object, &num_threads)) {
+        return nullptr;
+    }
+    if (!parse_string_list(paths_object, "paths", paths, has_paths)) {
+        return nullptr;
+    }
+    if (num_threads < 0) {
+        PyErr_SetString(PyExc_ValueError, "num_threads must be >= 0");
+        return nullptr;
+    }
+    
+    std::vector<ScanResult> results(paths.size());
+    {
+        ScopedGILRelease released;
+        size_t threads = num_threads > 0 ? static_cast<size_t>(num_threads)
+                                         : std::max<size_t>(1, std::thread::hardware_concurrency());
+        std::vector<std::function<void()>> tasks;
+        for (size_t i = 0; i < paths.size(); ++i) {
+            tasks.push_back([&results, &paths, i]() { results[i] = scan_one_file(paths[i]); });
+        }
+        WorkStealingPool pool(std::min(threads, std::max<size_t>(1, tasks.size())));
+        pool.run(tasks, estimate_file_costs(paths));
+    }
+    
+    PyObject* list = PyList_New(results.size());
+    if (!list) return nullptr;
+    for (size_t i = 0; i < results.size(); ++i) {
+        PyObject* dict = scan_result_to_dict(results[i]);
+        if (!dict) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SetItem(list, i, dict);
+    }
+    return list;
+}
+
+// Per-stage timers, histograms, record counts and (opt-in) allocations
+static PyObject* get_stats(PyObject* /*self*/, PyObject* /*args*/) {
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    
+    PyObject* result_dict = PyDict_New();
+    if (!result_dict) return nullptr;
+    set_dict_item(result_dict, "compiled", PyBool_FromLong(snapshot.compiled));
+    set_dict_item(result_dict, "enabled", PyBool_FromLong(snapshot.enabled));
+    set_dict_item(result_dict, "allocation_counting", PyBool_FromLong(snapshot.counts_allocations));
+    
+    // Histogram as cumulative (le_seconds, count) pairs, Prometheus style
+    PyObject* stages = PyDict_New();
+    for (const StageStats& stage : snapshot.stages) {
+        PyObject* stage_dict = PyDict_New();
+        set_dict_item(stage_dict, "calls", PyLong_FromUnsignedLongLong(stage.calls));
+        set_dict_item(stage_dict, "sum_seconds", PyFloat_FromDouble(stage.total_seconds));
+        set_dict_item(stage_dict, "max_seconds", PyFloat_FromDouble(stage.max_seconds));
+        
+        PyObject* buckets = PyList_New(0);
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i + 1 < stage.histogram.size(); ++i) {
+            cumulative += stage.histogram[i];
+            PyObject* bucket = Py_BuildValue("(dK)", static_cast<double>(1ULL << i) * 1e-6,
+                                             static_cast<unsigned long long>(cumulative));
+            PyList_Append(buckets, bucket);
+            Py_DECREF(bucket);
+        }
+        PyObject* last = Py_BuildValue("(dK)", Py_HUGE_VAL, static_cast<unsigned long long>(stage.calls));
+        PyList_Append(buckets, last);
+        Py_DECREF(last);
+        set_dict_item(stage_dict, "buckets", buckets);
+        
+        if (snapshot.counts_allocations) {
+            set_dict_item(stage_dict, "allocations", PyLong_FromUnsignedLongLong(stage.allocations));
+            set_dict_item(stage_dict, "allocated_bytes", PyLong_FromUnsignedLongLong(stage.allocated_bytes));
+        }
+        set_dict_item(stages, stage.name, stage_dict);
+    }
+    set_dict_item(result_dict, "stages", stages);
+    
+    PyObject* records = PyDict_New();
+    for (const RecordTypeStats& record : snapshot.records) {
+        PyObject* record_dict = PyDict_New();
+        set_dict_item(record_dict, "count", PyLong_FromUnsignedLongLong(record.count));
+        set_dict_item(record_dict, "bytes", PyLong_FromUnsignedLongLong(record.bytes));
+        set_dict_item(records, record.name, record_dict);
+    }
+    set_dict_item(result_dict, "records", records);
+    
+    if (snapshot.counts_allocations) {
+        set_dict_item(result_dict, "untracked_allocations", PyLong_FromUnsignedLongLong(snapshot.untracked_allocations));
+        set_dict_item(result_dict, "untracked_allocated_bytes",
+                      PyLong_FromUnsignedLongLong(snapshot.untracked_allocated_bytes));
+    }
+    return result_dict;
+}
+
+static PyObject* reset_stats(PyObject* /*self*/, PyObject* /*args*/) {
+    Instrumentation::reset();
+    Py_RETURN_NONE;
+}
+
+static PyObject* set_instrumentation_enabled(PyObject* /*self*/, PyObject* args) {
+    int enabled;
+    if (!PyArg_ParseTuple(args, "p", &enabled)) {
+        return nullptr;
+    }
+    Instrumentation::set_enabled(enabled);
+    Py_RETURN_NONE;
+}
+
+// Silence the native progress output (errors are still raised or returned)
+static PyObject* set_quiet(PyObject* /*self*/, PyObject* args) {
+    int quiet;
+    if (!PyArg_ParseTuple(args, "p", &quiet)) {
+        return nullptr;
+    }
+    ConsoleLog::set_quiet(quiet);
+    Py_RETURN_NONE;
+}
+
+// Python function: set_field_config(config)
+// Process-wide field selection for the record dict paths (parse_stdf_file,
+// read_stdf_records, ...): a dict {"PTR": ["TEST_NUM", ...]} or
+// {"PTR": {"enabled": True, "fields": [...]}}, optionally nested under
+// "field_extraction_rules", the same as JSON text, or None for every field.
+// Set it before parsing; selected fields are decoded straight from the bytes.
+static PyObject* set_field_config(PyObject* /*self*/, PyObject* args) {
+    PyObject* config;
+    if (!PyArg_ParseTuple(args, "O", &config)) {
+        return nullptr;
+    }
+    
+    DynamicFieldExtractor& extractor = get_shared_field_extractor();
+    if (config == Py_None) {
+        extractor.enable_all_fields();
+        Py_RETURN_NONE;
+    }
+    if (PyUnicode_Check(config)) {
+        if (!extractor.set_config_from_json(PyUnicode_AsUTF8(config))) {
+            PyErr_SetString(PyExc_ValueError, "malformed field configuration JSON or no known fields selected");
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+    if (!PyDict_Check(config)) {
+        PyErr_SetString(PyExc_TypeError, "config must be a dict, a JSON str or None");
+        return nullptr;
+    }
+    
+    // The layout of python/stdf_field_config.json nests the record types
+    PyObject* rules = PyDict_GetItemString(config, "field_extraction_rules");
+    if (rules && PyDict_Check(rules)) {
+        config = rules;
+    }
+    
+    std::map<std::string, std::set<std::string>> selection;
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t position = 0;
+    while (PyDict_Next(config, &position, &key, &value)) {
+        const char* record_type = PyUnicode_Check(key) ? PyUnicode_AsUTF8(key) : nullptr;
+        if (!record_type) {
+            PyErr_SetString(PyExc_TypeError, "config keys must be record type names");
+            return nullptr;
+        }
+        PyObject* fields = value;
+        if (PyDict_Check(value)) {
+            // Disabled types and objects without "fields" select nothing
+            PyObject* enabled = PyDict_GetItemString(value, "enabled");
+            fields = PyDict_GetItemString(value, "fields");
+            if (!fields || (enabled && PyObject_IsTrue(enabled) != 1)) {
+                continue;
+            }
+        }
+        std::vector<std::string> names;
+        bool given = false;
+        if (!parse_string_list(fields, "fields", names, given)) {
+            return nullptr;
+        }
+        selection[record_type].insert(names.begin(), names.end());
+    }
+    if (!extractor.set_enabled_fields(selection)) {
+        PyErr_SetString(PyExc_ValueError, "field configuration selects no known fields");
+        return nullptr;
+    }
+    Py_RETURN_NONE;
+}
+
+// Method definitions
+static PyMethodDef StdfParserMethods[] = {
+    {"parse_stdf_file", parse_stdf_file, METH_VARARGS,
+     "Parse STDF file and return list of records (backend: 'libstdf' or 'mmap'; fields: decode only these)"},
+    {"precompute_measurement_fields", precompute_measurement_fields, METH_VARARGS,
+     "Pre-compute expensive measurement fields in C++"},
+    {"precompute_measurement_fields_batch", precompute_measurement_fields_batch, METH_VARARGS,
+     "Pre-compute the measurement fields of all parts at once: MIR constants once, per-part columns"},
+    {"process_stdf_to_clickhouse_tuples", process_stdf_to_clickhouse_tuples, METH_VARARGS,
+     "🚀 ULTRA-FAST: Process STDF to ClickHouse tuples entirely in C++"},
+    {"process_stdf_with_database_mappings", process_stdf_with_database_mappings, METH_VARARGS,
+     "🔧 DATABASE-AWARE: Process STDF with existing database mappings and optional file hash"},
+    {"process_stdf_to_columns", process_stdf_to_columns, METH_VARARGS,
+     "🚀 COLUMNAR: Process STDF to one buffer per measurement field (string fields: (codes, dictionary))"},
+    {"process_stdf_to_arrow", process_stdf_to_arrow, METH_VARARGS,
+     "🚀 ARROW: Process STDF to an Arrow record batch (C Data Interface; string fields as dictionaries)"},
+    {"iter_measurements", iter_measurements, METH_VARARGS,
+     "🚀 STREAMING: Iterate over lists of measurement tuples (batch_size each) while parsing continues"},
+    {"follow_stdf_file", follow_stdf_file, METH_VARARGS,
+     "📡 FOLLOW: Follow an STDF file the tester is still writing: returns an StdfFollower whose poll() decodes only "
+     "the whole records appended since the last poll and returns the measurement tuples of the parts "
+     "they close (open parts, the MIR and test definitions carry over). "
+     "Args: filepath, device_mappings=None, param_mappings=None, file_hash='' (default: the file path), "
+     "num_threads=1, test_patterns=None"},
+    {"process_stdf_files", process_stdf_files, METH_VARARGS,
+     "🚀 BATCH: Process many STDF files natively with a shared ID manager; merged columns plus per-file stats"},
+    {"discover_devices_and_parameters", discover_devices_and_parameters, METH_VARARGS,
+     "🔍 DISCOVERY: Distinct PART_IDs and cleaned parameter names across many files (no measurements)"},
+    {"filter_unprocessed_files", filter_unprocessed_files, METH_VARARGS,
+     "Paths not yet ingested according to a local manifest (stat only, no reads)"},
+    {"record_ingested_files", record_ingested_files, METH_VARARGS,
+     "Record files (and content hashes) as ingested, or failed, in a local manifest"},
+    {"insert_stdf_to_clickhouse", insert_stdf_to_clickhouse, METH_VARARGS,
+     "🚀 DIRECT INSERT: Process STDF and stream it to ClickHouse over HTTP (Native or RowBinary)"},
+    {"insert_stdf_files_to_clickhouse", insert_stdf_files_to_clickhouse, METH_VARARGS,
+     "🚀 PIPELINE: Decode many STDF files and insert them as blocks through a bounded queue (backpressure)"},
+    {"replay_insert_spool", replay_insert_spool, METH_VARARGS,
+     "📦 SPOOL: Insert the blocks an insert spool directory holds, oldest first, without re-reading STDF"},
+    {"start_ingest_daemon", start_ingest_daemon, METH_VARARGS,
+     "🚀 DAEMON: Watch drop folders (inotify / ReadDirectoryChangesW) and insert new files as they arrive"},
+    {"scan_stdf_file", scan_stdf_file, METH_VARARGS,
+     "Header-only scan: record counts/bytes per type, part count, MIR/MRR fields, truncation"},
+    {"scan_stdf_files", scan_stdf_files, METH_VARARGS,
+     "Header-only scan of many files on a thread pool (triage before ingest)"},
+    {"get_pin_fail_map", get_pin_fail_map, METH_VARARGS,
+     "FTR FAIL_PIN analysis: per-pin fail counts, per-part pin maps and pins failing in every failing part"},
+    {"build_stdf_index", build_stdf_index, METH_VARARGS,
+     "Build (or load) the record offset sidecar index for an STDF file"},
+    {"export_stdf_cache", export_stdf_cache, METH_VARARGS,
+     "Decode an STDF file into the compressed columnar cache, keyed by content hash"},
+    {"set_decode_cache", set_decode_cache, METH_VARARGS,
+     "Reprocess from (and fill) a columnar cache directory; None turns it off"},
+    {"set_presort_output", set_presort_output, METH_VARARGS,
+     "Sort each measurement batch by the ClickHouse ORDER BY key (wld_id, wtp_id, ...) before it is returned or inserted"},
+    {"set_file_read_mode", set_file_read_mode, METH_VARARGS,
+     "Map files ('map'), read them in large chunks ('read') or map all but network shares ('auto')"},
+    {"set_numa_placement", set_numa_placement, METH_VARARGS,
+     "Spread worker threads over the NUMA nodes (default on); returns the previous setting"},
+    {"set_read_ahead", set_read_ahead, METH_VARARGS,
+     "Files multi-file runs read into the page cache ahead of their decoders (default 2); returns the previous setting"},
+    {"get_cpu_topology", get_cpu_topology, METH_NOARGS,
+     "NUMA nodes and the CPUs of each that this process may run on"},
+    {"set_id_snapshot", set_id_snapshot, METH_VARARGS,
+     "Start every ID manager from the memory-mapped ID snapshots in a directory; None turns it off"},
+    {"write_id_snapshot", write_id_snapshot, METH_VARARGS,
+     "Fold device/param mappings into the ID snapshots in a directory (created on first use)"},
+    {"read_stdf_records", read_stdf_records, METH_VARARGS,
+     "Read all records of one type ('MIR', 'PRR', ...) via the offset index"},
+    {"read_stdf_part", read_stdf_part, METH_VARARGS,
+     "Read one part's PIR..PRR records via the offset index"},
+    {"is_pixel_test", is_pixel_test, METH_VARARGS,
+     "True if ALARM_ID or TEST_TXT carries a Pixel= tag"},
+    {"clean_param_name", clean_param_name, METH_VARARGS,
+     "Strip Pixel=R<row>C<col> tags from a parameter name"},
+    {"parse_pixel_name", parse_pixel_name, METH_VARARGS,
+     "Cleaned name and (x, y) pixel coordinates of a test name in one pass"},
+    {"get_version", get_version, METH_NOARGS,
+     "Get version information"},
+    {"get_stats", get_stats, METH_NOARGS,
+     "Per-stage timings (with latency histograms), per-record-type counts and bytes"},
+    {"reset_stats", reset_stats, METH_NOARGS,
+     "Zero all counters returned by get_stats()"},
+    {"set_instrumentation_enabled", set_instrumentation_enabled, METH_VARARGS,
+     "Turn the stage timers and record counters on or off at run time"},
+    {"set_quiet", set_quiet, METH_VARARGS,
+     "Suppress the native console output (progress and warnings)"},
+    {"set_field_config", set_field_config, METH_VARARGS,
+     "Select the fields decoded per record type (dict, JSON str or None for all)"},
+    {nullptr, nullptr, 0, nullptr}
 };
 
 // Module definition
@@ -471,16 +3107,72 @@ static struct PyModuleDef stdf_parser_module = {
     "stdf_parser_cpp",
     "High-performance STDF parser using C++",
     -1,
-    StdfParserMethods
+    StdfParserMethods,
+    nullptr,
+    nullptr,
+    nullptr,
+    nullptr
 };
 
 // Module initialization
 PyMODINIT_FUNC PyInit_stdf_parser_cpp(void) {
+    ColumnBufferType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&column_buffer_spec));
+    if (!ColumnBufferType) {
+        return nullptr;
+    }
+    MeasurementIteratorType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&measurement_iterator_spec));
+    if (!MeasurementIteratorType) {
+        return nullptr;
+    }
+    ArrowBatchType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&arrow_batch_spec));
+    if (!ArrowBatchType) {
+        return nullptr;
+    }
+    IngestDaemonType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&ingest_daemon_spec));
+    if (!IngestDaemonType) {
+        return nullptr;
+    }
+    StdfFollowerType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&stdf_follower_spec));
+    if (!StdfFollowerType) {
+        return nullptr;
+    }
+    
     PyObject* module = PyModule_Create(&stdf_parser_module);
     if (!module) {
         return nullptr;
     }
     
+    Py_INCREF(ColumnBufferType);
+    if (PyModule_AddObject(module, "ColumnBuffer", reinterpret_cast<PyObject*>(ColumnBufferType)) < 0) {
+        Py_DECREF(ColumnBufferType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    Py_INCREF(MeasurementIteratorType);
+    if (PyModule_AddObject(module, "MeasurementIterator", reinterpret_cast<PyObject*>(MeasurementIteratorType)) < 0) {
+        Py_DECREF(MeasurementIteratorType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    Py_INCREF(ArrowBatchType);
+    if (PyModule_AddObject(module, "ArrowBatch", reinterpret_cast<PyObject*>(ArrowBatchType)) < 0) {
+        Py_DECREF(ArrowBatchType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    Py_INCREF(IngestDaemonType);
+    if (PyModule_AddObject(module, "IngestDaemon", reinterpret_cast<PyObject*>(IngestDaemonType)) < 0) {
+        Py_DECREF(IngestDaemonType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    Py_INCREF(StdfFollowerType);
+    if (PyModule_AddObject(module, "StdfFollower", reinterpret_cast<PyObject*>(StdfFollowerType)) < 0) {
+        Py_DECREF(StdfFollowerType);
+        Py_DECREF(module);
+        return nullptr;
+    }
+    
     // Add constants for record types
     PyModule_AddIntConstant(module, "PTR", static_cast<int>(STDFRecordType::PTR));
     PyModule_AddIntConstant(module, "MPR", static_cast<int>(STDFRecordType::MPR));
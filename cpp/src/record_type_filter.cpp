@@ -0,0 +1,25 @@
+#include "../include/record_type_filter.h"
+#include "../include/stdf_parser.h"
+#include <libstdf.h>
+
+void RecordTypeFilter::set_enabled_types(const std::vector<STDFRecordType>& types, bool part_brackets) {
+    clear();
+
+    for (STDFRecordType type : types) {
+        switch (type) {
+            case STDFRecordType::PTR: enable(REC_TYP_PER_EXEC, REC_SUB_PTR); break;
+            case STDFRecordType::MPR: enable(REC_TYP_PER_EXEC, REC_SUB_MPR); break;
+            case STDFRecordType::FTR: enable(REC_TYP_PER_EXEC, REC_SUB_FTR); break;
+            case STDFRecordType::HBR: enable(REC_TYP_PER_LOT, REC_SUB_HBR); break;
+            case STDFRecordType::SBR: enable(REC_TYP_PER_LOT, REC_SUB_SBR); break;
+            case STDFRecordType::PRR:
+                if (part_brackets) {
+                    enable(REC_TYP_PER_PART, REC_SUB_PIR);
+                }
+                enable(REC_TYP_PER_PART, REC_SUB_PRR);
+                break;
+            case STDFRecordType::MIR: enable(REC_TYP_PER_LOT, REC_SUB_MIR); break;
+            default: break;  // UNKNOWN has no record pair
+        }
+    }
+}
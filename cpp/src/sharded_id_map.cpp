@@ -0,0 +1,109 @@
+#include "../include/sharded_id_map.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_set>
+
+ShardedIDMap::ShardedIDMap()
+    : counter_(0) {
+}
+
+void ShardedIDMap::load(const std::vector<Mapping>& mappings) {
+    uint32_t max_id = 0;
+    for (const auto& mapping : mappings) {
+        const size_t hash = FlatStringMap::hash(mapping.first);
+        Shard& shard = shard_for(hash);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.ids.assign(mapping.first, hash, mapping.second);
+        max_id = std::max(max_id, mapping.second);
+    }
+
+    // Same rule as before sharding: counting resumes at max + 1 (1 when empty)
+    advance_counter(max_id + 1);
+}
+
+void ShardedIDMap::advance_counter(uint32_t next) {
+    uint32_t current = counter_.load();
+    while (current < next && !counter_.compare_exchange_weak(current, next)) {
+    }
+}
+
+void ShardedIDMap::attach(std::shared_ptr<const IDMapSnapshot> snapshot) {
+    snapshot_ = std::move(snapshot);
+    if (snapshot_) {
+        advance_counter(snapshot_->max_id() + 1);
+    }
+}
+
+uint32_t ShardedIDMap::get_or_assign(std::string_view name) {
+    const size_t hash = FlatStringMap::hash(name);
+    Shard& shard = shard_for(hash);
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        if (const uint32_t* found = shard.ids.find(name, hash)) {
+            return *found;
+        }
+    }
+    uint32_t id;
+    if (snapshot_ && snapshot_->find(name, id)) {
+        return id;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    // Another worker may have added the name between the two locks
+    if (const uint32_t* found = shard.ids.find(name, hash)) {
+        return *found;
+    }
+    id = counter_.fetch_add(1, std::memory_order_relaxed);
+    shard.ids.insert(name, hash, id);
+    shard.added.emplace_back(std::string(name), id);
+    return id;
+}
+
+size_t ShardedIDMap::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.ids.size();
+        uint32_t id;
+        for (const auto& entry : shard.ids.entries()) {
+            total -= snapshot_ && snapshot_->find(entry.first, id) ? 1 : 0;  // Counted below
+        }
+    }
+    return total + (snapshot_ ? snapshot_->size() : 0);
+}
+
+static void sort_by_id(std::vector<ShardedIDMap::Mapping>& mappings) {
+    std::sort(mappings.begin(), mappings.end(),
+              [](const ShardedIDMap::Mapping& a, const ShardedIDMap::Mapping& b) { return a.second < b.second; });
+}
+
+std::vector<ShardedIDMap::Mapping> ShardedIDMap::all_mappings() const {
+    std::vector<Mapping> mappings;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        mappings.insert(mappings.end(), shard.ids.entries().begin(), shard.ids.entries().end());
+    }
+    if (snapshot_) {
+        std::unordered_set<std::string> loaded;
+        for (const Mapping& mapping : mappings) {
+            loaded.insert(mapping.first);
+        }
+        for (Mapping& mapping : snapshot_->mappings()) {
+            if (!loaded.count(mapping.first)) {
+                mappings.push_back(std::move(mapping));
+            }
+        }
+    }
+    sort_by_id(mappings);
+    return mappings;
+}
+
+std::vector<ShardedIDMap::Mapping> ShardedIDMap::new_mappings() const {
+    std::vector<Mapping> mappings;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        mappings.insert(mappings.end(), shard.added.begin(), shard.added.end());
+    }
+    sort_by_id(mappings);
+    return mappings;
+}
@@ -0,0 +1,1081 @@
+#include "../include/stdf_binary_parser.h"
+#include "../include/byte_order.h"
+#include "../include/stdf_layout.h"
+#include "../include/stdf_record_view.h"
+#include "../include/dynamic_field_extractor.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <deque>
+#include <type_traits>
+
+// Shared with the libstdf backend so both produce identical field maps
+// (unless set_field_extractor picks another configuration). Created on
+// first use, after main() had the chance to silence ConsoleLog.
+
+// libstdf hands out a 1-byte "\0" Cn for fields missing at the end of a record
+static char g_empty_cn[1] = {0};
+
+// Backing storage for Cn fields whose length byte runs past the record end
+static thread_local std::deque<std::string> g_truncated_cn;
+
+static bool host_is_big_endian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 0;
+}
+
+// Fill a libstdf header the way stdf_read_record leaves it
+static void init_header(rec_header& header, int rec, uint16_t length) {
+    header.stdf_file = nullptr;
+    header.state = REC_STATE_PARSED;
+    header.REC_LEN = length;
+    header.REC_TYP = static_cast<rec_typ>(rec >> 8);
+    header.REC_SUB = static_cast<rec_sub>(rec & 0xFF);
+}
+
+// Length-prefixed Cn pointer -> std::string
+static std::string cn_to_string(const char* cn) {
+    if (!cn) return "";
+    return std::string(cn + 1, static_cast<uint8_t>(cn[0]));
+}
+
+STDFBinaryParser::STDFBinaryParser()
+    : data_(nullptr)
+    , file_size_(0)
+    , end_offset_(0)
+    , current_position_(0)
+    , swap_bytes_(false)
+    , record_length_(0)
+    , field_extractor_(&get_shared_field_extractor())
+    , total_records_(0)
+    , parsed_records_(0)
+    , current_record_index_(0) {
+
+    // Same default selection as STDFParser
+    set_enabled_record_types({
+        STDFRecordType::PTR,
+        STDFRecordType::MPR,
+        STDFRecordType::FTR,
+        STDFRecordType::HBR,
+        STDFRecordType::SBR,
+        STDFRecordType::MIR,
+        STDFRecordType::PRR
+    });
+}
+
+STDFBinaryParser::~STDFBinaryParser() {
+    close_file();
+    Instrumentation::add_records(record_counters_);
+}
+
+bool STDFBinaryParser::open_file(const std::string& filepath) {
+    close_file();
+    last_error_.clear();
+
+    if (!file_.open(filepath)) {
+        set_error(file_.get_last_error());
+        return false;
+    }
+
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ?
+                       filepath.substr(last_slash + 1) : filepath;
+
+    data_ = file_.data();
+    file_size_ = file_.size();
+    end_offset_ = file_size_;
+    current_position_ = 0;
+    total_records_ = 0;
+    parsed_records_ = 0;
+    current_record_index_ = 0;
+
+    detect_byte_order();
+    return true;
+}
+
+void STDFBinaryParser::close_file() {
+    file_.close();
+    data_ = nullptr;
+    file_size_ = 0;
+    end_offset_ = 0;
+    current_position_ = 0;
+}
+
+void STDFBinaryParser::detect_byte_order() {
+    // FAR is always first: REC_LEN=2, REC_TYP=0, REC_SUB=10, CPU_TYPE, STDF_VER
+    bool file_big_endian = host_is_big_endian();
+    const uint8_t* data = data_;
+
+    if (file_size_ >= 6 && data[2] == 0 && data[3] == 10) {
+        uint8_t cpu_type = data[4];
+        if (cpu_type == 1) {
+            file_big_endian = true;   // Sun SPARC / 680x0
+        } else if (cpu_type == 2) {
+            file_big_endian = false;  // x86
+        }
+    } else {
+        set_error("File does not start with a FAR record, assuming host byte order");
+    }
+
+    swap_bytes_ = (file_big_endian != host_is_big_endian());
+}
+
+bool STDFBinaryParser::has_more_records() {
+    return data_ != nullptr && current_position_ + sizeof(STDFHeader) <= end_offset_;
+}
+
+bool STDFBinaryParser::attach_buffer(const uint8_t* data, size_t size, const std::string& filename,
+                                     uint32_t first_record_index) {
+    if (!data || first_record_index == 0) {
+        set_error("Invalid buffer");
+        return false;
+    }
+    if (file_.is_open()) {
+        close_file();
+    }
+
+    data_ = data;
+    file_size_ = size;
+    end_offset_ = size;
+    current_position_ = 0;
+    current_filename_ = filename;
+    total_records_ = first_record_index - 1;
+    current_record_index_ = total_records_;
+    parsed_records_ = 0;
+
+    // Byte order comes from the FAR, so only the first buffer carries it
+    if (first_record_index == 1) {
+        last_error_.clear();
+        detect_byte_order();
+    }
+    return true;
+}
+
+bool STDFBinaryParser::set_range(size_t begin_offset, size_t end_offset, uint32_t first_record_index) {
+    if (!data_ || begin_offset > end_offset || end_offset > file_size_ || first_record_index == 0) {
+        set_error("Invalid record range");
+        return false;
+    }
+
+    current_position_ = begin_offset;
+    end_offset_ = end_offset;
+    total_records_ = first_record_index - 1;
+    current_record_index_ = total_records_;
+    parsed_records_ = 0;
+    return true;
+}
+
+bool STDFBinaryParser::read_header(STDFHeader& header) {
+    if (current_position_ + sizeof(STDFHeader) > file_size_) {
+        return false;
+    }
+
+    std::memcpy(&header, data_ + current_position_, sizeof(STDFHeader));
+    if (swap_bytes_) {
+        header.length = byte_swap16(header.length);
+    }
+    current_position_ += sizeof(STDFHeader);
+    return true;
+}
+
+bool STDFBinaryParser::skip_record(uint16_t length) {
+    if (current_position_ + length > file_size_) {
+        current_position_ = file_size_;
+        return false;
+    }
+    current_position_ += length;
+    return true;
+}
+
+std::vector<STDFRecord> STDFBinaryParser::parse_all_records() {
+    std::vector<STDFRecord> results;
+
+    while (has_more_records()) {
+        STDFRecord record = parse_next_record();
+        if (record.type == STDFRecordType::UNKNOWN) {
+            break;
+        }
+        results.push_back(std::move(record));
+    }
+
+    return results;
+}
+
+bool STDFBinaryParser::next_raw_record(STDFHeader& header, const uint8_t*& data, size_t& record_start) {
+    while (has_more_records()) {
+        record_start = current_position_;
+
+        if (!read_header(header)) {
+            break;
+        }
+
+        data = data_ + current_position_;
+        if (!skip_record(header.length)) {
+            set_error("Truncated record at offset " + std::to_string(record_start));
+            break;
+        }
+
+        total_records_++;
+        current_record_index_ = static_cast<uint32_t>(total_records_);
+        record_counters_.add(header.rec_type, header.rec_subtype, header.length);
+
+        if (is_record_enabled(header.rec_type, header.rec_subtype)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::decode_record(const STDFHeader& header, const uint8_t* data, size_t record_start) {
+    STDFRecordType type = classify_record(header.rec_type, header.rec_subtype);
+    STDFRecord record;
+    g_truncated_cn.clear();
+
+    if (field_extractor_->is_projected(type)) {
+        record = parse_projected_record(header, data);
+    } else {
+        switch (type) {
+            case STDFRecordType::MIR: record = parse_mir_record<Swap>(data, header.length); break;
+            case STDFRecordType::PTR: record = parse_ptr_record<Swap>(data, header.length); break;
+            case STDFRecordType::MPR: record = parse_mpr_record<Swap>(data, header.length); break;
+            case STDFRecordType::FTR: record = parse_ftr_record<Swap>(data, header.length); break;
+            case STDFRecordType::HBR: record = parse_hbr_record<Swap>(data, header.length); break;
+            case STDFRecordType::SBR: record = parse_sbr_record<Swap>(data, header.length); break;
+            case STDFRecordType::PRR: record = parse_prr_record<Swap>(data, header.length); break;
+            default:
+                record.type = STDFRecordType::UNKNOWN;
+                return record;
+        }
+    }
+
+    if (record.fields.empty() && type != STDFRecordType::MIR) {
+        record.type = STDFRecordType::UNKNOWN;
+        return record;
+    }
+
+    record.filename = current_filename_;
+    record.record_index = current_record_index_;
+    record.file_position = record_start;
+    return record;
+}
+
+STDFRecord STDFBinaryParser::parse_next_record() {
+    STDFHeader header;
+    const uint8_t* data = nullptr;
+    size_t record_start = 0;
+
+    while (next_raw_record(header, data, record_start)) {
+        STDFRecord record = swap_bytes_ ? decode_record<true>(header, data, record_start)
+                                        : decode_record<false>(header, data, record_start);
+        if (record.type == STDFRecordType::UNKNOWN) {
+            continue;
+        }
+        parsed_records_++;
+        return record;
+    }
+
+    STDFRecord end_marker;
+    end_marker.type = STDFRecordType::UNKNOWN;
+    return end_marker;
+}
+
+bool STDFBinaryParser::next_view(STDFRecordView& view) {
+    STDFHeader header;
+    const uint8_t* data = nullptr;
+    size_t record_start = 0;
+
+    while (next_raw_record(header, data, record_start)) {
+        view.reset(header.rec_type, header.rec_subtype, data, header.length, swap_bytes_, current_record_index_);
+        if (view.type() == STDFRecordType::UNKNOWN) {
+            continue;  // PIR bracket markers, as in parse_next_record
+        }
+        parsed_records_++;
+        return true;
+    }
+    return false;
+}
+
+STDFRecord STDFBinaryParser::parse_record_at(size_t offset, uint32_t record_index) {
+    STDFRecord record;
+    record.type = STDFRecordType::UNKNOWN;
+
+    if (!data_ || offset + sizeof(STDFHeader) > file_size_) {
+        set_error("Record offset " + std::to_string(offset) + " is outside the file");
+        return record;
+    }
+
+    current_position_ = offset;
+    STDFHeader header;
+    read_header(header);
+
+    const uint8_t* data = data_ + current_position_;
+    if (!skip_record(header.length)) {
+        set_error("Truncated record at offset " + std::to_string(offset));
+        return record;
+    }
+
+    // Keep the walk counters consistent so parse_next_record can continue from here
+    total_records_ = record_index;
+    current_record_index_ = record_index;
+
+    record = swap_bytes_ ? decode_record<true>(header, data, offset) : decode_record<false>(header, data, offset);
+    if (record.type != STDFRecordType::UNKNOWN) {
+        parsed_records_++;
+    }
+    return record;
+}
+
+size_t STDFBinaryParser::parse_all_to_columns(STDFColumnarStore& store) {
+    // One decoder instance per byte order; the choice is made once per file
+    return swap_bytes_ ? parse_columns<true>(store) : parse_columns<false>(store);
+}
+
+template<bool Swap>
+size_t STDFBinaryParser::parse_columns(STDFColumnarStore& store) {
+    STDFHeader header;
+    const uint8_t* data = nullptr;
+    size_t record_start = 0;
+    size_t appended = 0;
+
+    while (next_raw_record(header, data, record_start)) {
+        if (header.rec_type == REC_TYP_PER_PART && header.rec_subtype == REC_SUB_PIR) {
+            // Bracket marker for part association, not counted as parsed
+            rec_pir pir;
+            decode_pir(data, header.length, pir);
+            store.append(pir, current_record_index_);
+            continue;
+        }
+
+        STDFRecordType type = classify_record(header.rec_type, header.rec_subtype);
+        g_truncated_cn.clear();
+
+        switch (type) {
+            case STDFRecordType::PTR: {
+                rec_ptr ptr;
+                decode_ptr<Swap>(data, header.length, ptr);
+                store.append(ptr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::MPR: {
+                rec_mpr mpr;
+                decode_mpr<Swap>(data, header.length, mpr);
+                store.append(mpr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::FTR: {
+                rec_ftr ftr;
+                decode_ftr<Swap>(data, header.length, ftr);
+                store.append(ftr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::HBR: {
+                rec_hbr hbr;
+                decode_hbr<Swap>(data, header.length, hbr);
+                store.append(hbr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::SBR: {
+                rec_sbr sbr;
+                decode_sbr<Swap>(data, header.length, sbr);
+                store.append(sbr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::PRR: {
+                rec_prr prr;
+                decode_prr<Swap>(data, header.length, prr);
+                store.append(prr, current_record_index_);
+                break;
+            }
+            case STDFRecordType::MIR: {
+                STDFRecord record = parse_mir_record<Swap>(data, header.length);
+                record.filename = current_filename_;
+                record.record_index = current_record_index_;
+                record.file_position = record_start;
+                store.mir_records.push_back(std::move(record));
+                break;
+            }
+            default:
+                continue;
+        }
+
+        parsed_records_++;
+        appended++;
+    }
+
+    return appended;
+}
+
+size_t STDFBinaryParser::scan_records(STDFScanSummary& summary) {
+    const size_t begin = data_ ? std::min(current_position_, end_offset_) : 0;
+    size_t scanned = 0;
+    STDFHeader header;
+
+    while (has_more_records()) {
+        size_t record_start = current_position_;
+        read_header(header);
+        const uint8_t* data = data_ + current_position_;
+        if (!skip_record(header.length)) {
+            summary.truncated = true;
+            set_error("Truncated record at offset " + std::to_string(record_start));
+            break;
+        }
+
+        const bool first = summary.total_records == 0;
+        total_records_++;
+        current_record_index_ = static_cast<uint32_t>(total_records_);
+        record_counters_.add(header.rec_type, header.rec_subtype, header.length);
+
+        CountedRecordType type = counted_record_type(header.rec_type, header.rec_subtype);
+        summary.record_counts[static_cast<size_t>(type)]++;
+        summary.record_bytes[static_cast<size_t>(type)] += sizeof(STDFHeader) + header.length;
+        summary.total_records++;
+        summary.complete_bytes += sizeof(STDFHeader) + header.length;
+        summary.ends_with_mrr = false;
+
+        switch (type) {
+            case CountedRecordType::FAR_:
+                if (first) {
+                    summary.starts_with_far = true;
+                    summary.cpu_type = header.length >= 1 ? data[0] : 0;
+                    summary.stdf_version = header.length >= 2 ? data[1] : 0;
+                }
+                break;
+            case CountedRecordType::MIR:
+                if (!summary.has_mir) {
+                    summary.mir_fields = (swap_bytes_ ? parse_mir_record<true>(data, header.length)
+                                                      : parse_mir_record<false>(data, header.length)).fields;
+                    summary.has_mir = true;
+                }
+                break;
+            case CountedRecordType::MRR:
+                summary.mrr_fields = (swap_bytes_ ? parse_mrr_record<true>(data, header.length)
+                                                  : parse_mrr_record<false>(data, header.length)).fields;
+                summary.has_mrr = true;
+                summary.ends_with_mrr = true;
+                break;
+            default:
+                break;
+        }
+        scanned++;
+    }
+
+    // A header cut short leaves 1..3 bytes that has_more_records() skips
+    if (data_ && current_position_ < end_offset_ && !summary.truncated) {
+        summary.truncated = true;
+        set_error("Truncated record header at offset " + std::to_string(current_position_));
+    }
+    summary.stdf_bytes += end_offset_ - begin;
+    return scanned;
+}
+
+// ============================================================================
+// STDF data type parsers
+// ============================================================================
+
+uint8_t STDFBinaryParser::read_u1(const uint8_t* data, size_t& offset) {
+    if (offset + 1 > record_length_) return 0;
+    return data[offset++];
+}
+
+template<bool Swap>
+uint16_t STDFBinaryParser::read_u2(const uint8_t* data, size_t& offset) {
+    if (offset + 2 > record_length_) {
+        offset = record_length_;
+        return 0;
+    }
+    uint16_t value = FileByteOrder<Swap>::u2(data + offset);
+    offset += 2;
+    return value;
+}
+
+template<bool Swap>
+uint32_t STDFBinaryParser::read_u4(const uint8_t* data, size_t& offset) {
+    if (offset + 4 > record_length_) {
+        offset = record_length_;
+        return 0;
+    }
+    uint32_t value = FileByteOrder<Swap>::u4(data + offset);
+    offset += 4;
+    return value;
+}
+
+int8_t STDFBinaryParser::read_i1(const uint8_t* data, size_t& offset) {
+    return static_cast<int8_t>(read_u1(data, offset));
+}
+
+template<bool Swap>
+int16_t STDFBinaryParser::read_i2(const uint8_t* data, size_t& offset) {
+    return static_cast<int16_t>(read_u2<Swap>(data, offset));
+}
+
+template<bool Swap>
+int32_t STDFBinaryParser::read_i4(const uint8_t* data, size_t& offset) {
+    return static_cast<int32_t>(read_u4<Swap>(data, offset));
+}
+
+template<bool Swap>
+float STDFBinaryParser::read_r4(const uint8_t* data, size_t& offset) {
+    if (offset + 4 > record_length_) {
+        offset = record_length_;
+        return 0.0f;
+    }
+    float value = FileByteOrder<Swap>::r4(data + offset);
+    offset += 4;
+    return value;
+}
+
+template<bool Swap>
+double STDFBinaryParser::read_r8(const uint8_t* data, size_t& offset) {
+    if (offset + 8 > record_length_) {
+        offset = record_length_;
+        return 0.0;
+    }
+    double value = FileByteOrder<Swap>::r8(data + offset);
+    offset += 8;
+    return value;
+}
+
+char STDFBinaryParser::read_c1(const uint8_t* data, size_t& offset) {
+    if (offset + 1 > record_length_) return ' ';  // libstdf default for C1
+    return static_cast<char>(data[offset++]);
+}
+
+std::string STDFBinaryParser::read_cn(const uint8_t* data, size_t& offset) {
+    return cn_to_string(read_cn_ptr(data, offset));
+}
+
+std::string STDFBinaryParser::read_cf(const uint8_t* data, size_t& offset, uint8_t length) {
+    size_t available = (offset < record_length_) ? record_length_ - offset : 0;
+    size_t take = std::min<size_t>(length, available);
+    std::string value(reinterpret_cast<const char*>(data + offset), take);
+    offset += take;
+    return value;
+}
+
+char* STDFBinaryParser::read_cn_ptr(const uint8_t* data, size_t& offset) {
+    if (offset >= record_length_) {
+        return g_empty_cn;
+    }
+
+    uint8_t length = data[offset];
+    if (offset + 1 + length <= record_length_) {
+        // Points at the length byte inside the mapping - no copy
+        char* cn = const_cast<char*>(reinterpret_cast<const char*>(data + offset));
+        offset += 1 + length;
+        return cn;
+    }
+
+    // Corrupt length byte: keep the pointer inside valid memory
+    size_t available = record_length_ - offset - 1;
+    g_truncated_cn.emplace_back(1, static_cast<char>(available));
+    g_truncated_cn.back().append(reinterpret_cast<const char*>(data + offset + 1), available);
+    offset = record_length_;
+    return &g_truncated_cn.back()[0];
+}
+
+uint8_t* STDFBinaryParser::read_xn1_ptr(const uint8_t* data, size_t& offset, uint16_t count) {
+    size_t length = count / 2 + count % 2;
+    if (offset + length > record_length_) {
+        offset = record_length_;
+        return reinterpret_cast<uint8_t*>(g_empty_cn);
+    }
+    uint8_t* nibbles = const_cast<uint8_t*>(data + offset);
+    offset += length;
+    return nibbles;
+}
+
+template<bool Swap>
+uint8_t* STDFBinaryParser::read_dn_ptr(const uint8_t* data, size_t& offset, std::vector<uint8_t>& scratch) {
+    // libstdf layout: [U2 bit count, host order][bytes...][0x00]
+    uint16_t bit_count = read_u2<Swap>(data, offset);
+    size_t length = bit_count / 8 + ((bit_count % 8) ? 1 : 0);
+
+    scratch.assign(2 + length + 1, 0);
+    std::memcpy(scratch.data(), &bit_count, 2);
+
+    size_t available = (offset < record_length_) ? record_length_ - offset : 0;
+    size_t take = std::min(length, available);
+    std::memcpy(scratch.data() + 2, data + offset, take);
+    offset += take;
+
+    return scratch.data();
+}
+
+template<bool Swap>
+float* STDFBinaryParser::read_xr4(const uint8_t* data, size_t& offset, uint16_t count, std::vector<float>& scratch) {
+    if (count == 0) return nullptr;
+
+    scratch.resize(count);
+    if (offset + 4u * count <= record_length_) {
+        FileByteOrder<Swap>::copy_u4(scratch.data(), data + offset, count);
+        offset += 4u * count;
+    } else {
+        for (uint16_t i = 0; i < count; ++i) {
+            scratch[i] = read_r4<Swap>(data, offset);
+        }
+    }
+    return scratch.data();
+}
+
+template<bool Swap>
+uint16_t* STDFBinaryParser::read_xu2(const uint8_t* data, size_t& offset, uint16_t count, std::vector<uint16_t>& scratch) {
+    if (count == 0) return nullptr;
+
+    scratch.resize(count);
+    if (offset + 2u * count <= record_length_) {
+        FileByteOrder<Swap>::copy_u2(scratch.data(), data + offset, count);
+        offset += 2u * count;
+    } else {
+        for (uint16_t i = 0; i < count; ++i) {
+            scratch[i] = read_u2<Swap>(data, offset);
+        }
+    }
+    return scratch.data();
+}
+
+// ============================================================================
+// Record-specific parsers
+// ============================================================================
+
+STDFRecord STDFBinaryParser::make_record(STDFRecordType type, uint8_t rec_type, uint8_t rec_subtype) {
+    STDFRecord record;
+    record.type = type;
+    record.rec_type = rec_type;
+    record.rec_subtype = rec_subtype;
+    record.fields["REC_TYPE"] = std::to_string(rec_type);
+    record.fields["REC_SUB"] = std::to_string(rec_subtype);
+    record.fields["RECORD_TYPE"] = record_type_to_string(type);
+    return record;
+}
+
+// Copy X-Macros extracted fields into the output record
+static void merge_dynamic_fields(const DynamicSTDFRecord& dynamic_record, STDFRecord& record) {
+    for (const auto& field : dynamic_record.fields) {
+        record.fields[field.first] = field.second;
+    }
+}
+
+// Selected fields only, read through a view; the rest of the record is
+// never decoded (no libstdf struct, no per-type extras)
+STDFRecord STDFBinaryParser::parse_projected_record(const STDFHeader& header, const uint8_t* data) {
+    STDFRecordView view;
+    view.reset(header.rec_type, header.rec_subtype, data, header.length, swap_bytes_, current_record_index_);
+
+    STDFRecord record = make_record(view.type(), header.rec_type, header.rec_subtype);
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(view, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+    return record;
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_mir_record(const uint8_t* data, uint16_t length) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    STDFRecord record;
+    record.type = STDFRecordType::MIR;
+    record.rec_type = REC_TYP_PER_LOT;
+    record.rec_subtype = REC_SUB_MIR;
+
+    uint32_t setup_t = read_u4<Swap>(data, offset);
+    uint32_t start_t = read_u4<Swap>(data, offset);
+    uint8_t stat_num = read_u1(data, offset);
+    char mode_cod = read_c1(data, offset);
+    char rtst_cod = read_c1(data, offset);
+    char prot_cod = read_c1(data, offset);
+    read_u2<Swap>(data, offset);  // BURN_TIM
+    read_c1(data, offset);  // CMOD_COD
+    mir_lot_id_ = read_cn(data, offset);
+    mir_part_typ_ = read_cn(data, offset);
+    std::string node_nam = read_cn(data, offset);
+    std::string tstr_typ = read_cn(data, offset);
+    mir_job_nam_ = read_cn(data, offset);
+    read_cn(data, offset);  // JOB_REV
+    read_cn(data, offset);  // SBLOT_ID
+    read_cn(data, offset);  // OPER_NAM
+    std::string exec_typ = read_cn(data, offset);
+    std::string exec_ver = read_cn(data, offset);
+
+    // Same field selection as STDFParser::parse_mir_record
+    record.fields["LOT_ID"] = mir_lot_id_;
+    record.fields["PART_TYP"] = mir_part_typ_;
+    record.fields["JOB_NAM"] = mir_job_nam_;
+    record.fields["SETUP_T"] = std::to_string(setup_t);
+    record.fields["START_T"] = std::to_string(start_t);
+    record.fields["STAT_NUM"] = std::to_string(stat_num);
+    if (mode_cod) record.fields["MODE_COD"] = std::string(1, mode_cod);
+    if (rtst_cod) record.fields["RTST_COD"] = std::string(1, rtst_cod);
+    if (prot_cod) record.fields["PROT_COD"] = std::string(1, prot_cod);
+    record.fields["NODE_NAM"] = node_nam;
+    record.fields["TSTR_TYP"] = tstr_typ;
+    record.fields["EXEC_TYP"] = exec_typ;
+    record.fields["EXEC_VER"] = exec_ver;
+
+    return record;
+}
+
+template<bool Swap, typename Layout, size_t Index, typename T>
+void STDFBinaryParser::decode_layout_field(const uint8_t* data, size_t& offset, LayoutRun& run, T& value) {
+    using stdf_layout::Type;
+    constexpr Type type = Layout::types[Index];
+    static_assert(std::is_same<T, stdf_layout::member_t<type>>::value, "layout type differs from the libstdf member");
+
+    if constexpr (type == Type::CN) {
+        value = read_cn_ptr(data, offset);
+    } else if constexpr (type == Type::BN) {
+        value = reinterpret_cast<dtc_Bn>(read_cn_ptr(data, offset));
+    } else {
+        if constexpr (stdf_layout::starts_run<Layout>(Index)) {
+            constexpr size_t bytes = stdf_layout::run_bytes<Layout>(Index);
+            run.start = offset;
+            run.whole = offset + bytes <= record_length_;
+            if (run.whole) {
+                offset += bytes;
+            }
+        }
+        if (run.whole) {
+            value = stdf_layout::load<Swap, type>(data + run.start + stdf_layout::run_offset<Layout>(Index));
+        } else if constexpr (type == Type::U1 || type == Type::B1) {
+            value = read_u1(data, offset);
+        } else if constexpr (type == Type::I1) {
+            value = read_i1(data, offset);
+        } else if constexpr (type == Type::C1) {
+            value = read_c1(data, offset);
+        } else if constexpr (type == Type::U2) {
+            value = read_u2<Swap>(data, offset);
+        } else if constexpr (type == Type::I2) {
+            value = read_i2<Swap>(data, offset);
+        } else if constexpr (type == Type::U4) {
+            value = read_u4<Swap>(data, offset);
+        } else if constexpr (type == Type::I4) {
+            value = read_i4<Swap>(data, offset);
+        } else {
+            value = read_r4<Swap>(data, offset);
+        }
+    }
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_ptr(const uint8_t* data, uint16_t length, rec_ptr& ptr) {
+    record_length_ = length;
+    size_t offset = 0;
+    LayoutRun run;
+
+    std::memset(&ptr, 0, sizeof(ptr));
+    init_header(ptr.header, REC_PTR, length);
+
+    #define LAYOUT(name, member, type) \
+        decode_layout_field<Swap, stdf_layout::PTRLayout, stdf_layout::PTRLayout::member>(data, offset, run, ptr.member);
+    #include "../field_defs/ptr_layout.def"
+    #undef LAYOUT
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_ptr_record(const uint8_t* data, uint16_t length) {
+    rec_ptr ptr;
+    decode_ptr<Swap>(data, length, ptr);
+
+    STDFRecord record = make_record(STDFRecordType::PTR, REC_TYP_PER_EXEC, REC_SUB_PTR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&ptr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    return record;
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_mpr(const uint8_t* data, uint16_t length, rec_mpr& mpr) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    std::memset(&mpr, 0, sizeof(mpr));
+    init_header(mpr.header, REC_MPR, length);
+
+    mpr.TEST_NUM = read_u4<Swap>(data, offset);
+    mpr.HEAD_NUM = read_u1(data, offset);
+    mpr.SITE_NUM = read_u1(data, offset);
+    mpr.TEST_FLG = read_u1(data, offset);
+    mpr.PARM_FLG = read_u1(data, offset);
+    mpr.RTN_ICNT = read_u2<Swap>(data, offset);
+    mpr.RSLT_CNT = read_u2<Swap>(data, offset);
+    mpr.RTN_STAT = read_xn1_ptr(data, offset, mpr.RTN_ICNT);
+    mpr.RTN_RSLT = read_xr4<Swap>(data, offset, mpr.RSLT_CNT, rslt_scratch_);
+    mpr.TEST_TXT = read_cn_ptr(data, offset);
+    mpr.ALARM_ID = read_cn_ptr(data, offset);
+    mpr.OPT_FLAG = read_u1(data, offset);
+    mpr.RES_SCAL = read_i1(data, offset);
+    mpr.LLM_SCAL = read_i1(data, offset);
+    mpr.HLM_SCAL = read_i1(data, offset);
+    mpr.LO_LIMIT = read_r4<Swap>(data, offset);
+    mpr.HI_LIMIT = read_r4<Swap>(data, offset);
+    mpr.START_IN = read_r4<Swap>(data, offset);
+    mpr.INCR_IN = read_r4<Swap>(data, offset);
+    mpr.RTN_INDX = read_xu2<Swap>(data, offset, mpr.RTN_ICNT, indx_scratch_);
+    mpr.UNITS = read_cn_ptr(data, offset);
+    mpr.UNITS_IN = read_cn_ptr(data, offset);
+    mpr.C_RESFMT = read_cn_ptr(data, offset);
+    mpr.C_LLMFMT = read_cn_ptr(data, offset);
+    mpr.C_HLMFMT = read_cn_ptr(data, offset);
+    mpr.LO_SPEC = read_r4<Swap>(data, offset);
+    mpr.HI_SPEC = read_r4<Swap>(data, offset);
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_mpr_record(const uint8_t* data, uint16_t length) {
+    rec_mpr mpr;
+    decode_mpr<Swap>(data, length, mpr);
+
+    STDFRecord record = make_record(STDFRecordType::MPR, REC_TYP_PER_EXEC, REC_SUB_MPR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&mpr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    record.fields["start_in"] = std::to_string(mpr.START_IN);
+    record.fields["incr_in"] = std::to_string(mpr.INCR_IN);
+    if (mpr.RTN_STAT && mpr.RSLT_CNT > 0) {
+        record.fields["rtn_stat_count"] = std::to_string(mpr.RSLT_CNT);
+    }
+
+    return record;
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_ftr(const uint8_t* data, uint16_t length, rec_ftr& ftr) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    std::memset(&ftr, 0, sizeof(ftr));
+    init_header(ftr.header, REC_FTR, length);
+
+    ftr.TEST_NUM = read_u4<Swap>(data, offset);
+    ftr.HEAD_NUM = read_u1(data, offset);
+    ftr.SITE_NUM = read_u1(data, offset);
+    ftr.TEST_FLG = read_u1(data, offset);
+    ftr.OPT_FLAG = read_u1(data, offset);
+    ftr.CYCL_CNT = read_u4<Swap>(data, offset);
+    ftr.REL_VADR = read_u4<Swap>(data, offset);
+    ftr.REPT_CNT = read_u4<Swap>(data, offset);
+    ftr.NUM_FAIL = read_u4<Swap>(data, offset);
+    ftr.XFAIL_AD = read_i4<Swap>(data, offset);
+    ftr.YFAIL_AD = read_i4<Swap>(data, offset);
+    ftr.VECT_OFF = read_i2<Swap>(data, offset);
+    ftr.RTN_ICNT = read_u2<Swap>(data, offset);
+    ftr.PGM_ICNT = read_u2<Swap>(data, offset);
+    ftr.RTN_INDX = read_xu2<Swap>(data, offset, ftr.RTN_ICNT, indx_scratch_);
+    ftr.RTN_STAT = read_xn1_ptr(data, offset, ftr.RTN_ICNT);
+    ftr.PGM_INDX = read_xu2<Swap>(data, offset, ftr.PGM_ICNT, pgm_indx_scratch_);
+    ftr.PGM_STAT = read_xn1_ptr(data, offset, ftr.PGM_ICNT);
+    ftr.FAIL_PIN = read_dn_ptr<Swap>(data, offset, fail_pin_scratch_);
+    ftr.VECT_NAM = read_cn_ptr(data, offset);
+    ftr.TIME_SET = read_cn_ptr(data, offset);
+    ftr.OP_CODE = read_cn_ptr(data, offset);
+    ftr.TEST_TXT = read_cn_ptr(data, offset);
+    ftr.ALARM_ID = read_cn_ptr(data, offset);
+    ftr.PROG_TXT = read_cn_ptr(data, offset);
+    ftr.RSLT_TXT = read_cn_ptr(data, offset);
+    ftr.PATG_NUM = read_u1(data, offset);
+    ftr.SPIN_MAP = read_dn_ptr<Swap>(data, offset, spin_map_scratch_);
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_ftr_record(const uint8_t* data, uint16_t length) {
+    rec_ftr ftr;
+    decode_ftr<Swap>(data, length, ftr);
+
+    STDFRecord record = make_record(STDFRecordType::FTR, REC_TYP_PER_EXEC, REC_SUB_FTR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&ftr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    record.fields["vect_nam"] = cn_to_string(ftr.VECT_NAM);
+    record.fields["time_set"] = cn_to_string(ftr.TIME_SET);
+    record.fields["op_code"] = cn_to_string(ftr.OP_CODE);
+    record.fields["prog_txt"] = cn_to_string(ftr.PROG_TXT);
+    record.fields["rslt_txt"] = cn_to_string(ftr.RSLT_TXT);
+    record.fields["patg_num"] = std::to_string(ftr.PATG_NUM);
+    record.fields["spin_map"] = "present";
+
+    return record;
+}
+
+void STDFBinaryParser::decode_pir(const uint8_t* data, uint16_t length, rec_pir& pir) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    std::memset(&pir, 0, sizeof(pir));
+    init_header(pir.header, REC_PIR, length);
+
+    pir.HEAD_NUM = read_u1(data, offset);
+    pir.SITE_NUM = read_u1(data, offset);
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_prr(const uint8_t* data, uint16_t length, rec_prr& prr) {
+    record_length_ = length;
+    size_t offset = 0;
+    LayoutRun run;
+
+    std::memset(&prr, 0, sizeof(prr));
+    init_header(prr.header, REC_PRR, length);
+
+    #define LAYOUT(name, member, type) \
+        decode_layout_field<Swap, stdf_layout::PRRLayout, stdf_layout::PRRLayout::member>(data, offset, run, prr.member);
+    #include "../field_defs/prr_layout.def"
+    #undef LAYOUT
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_prr_record(const uint8_t* data, uint16_t length) {
+    rec_prr prr;
+    decode_prr<Swap>(data, length, prr);
+
+    STDFRecord record = make_record(STDFRecordType::PRR, REC_TYP_PER_PART, REC_SUB_PRR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&prr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    record.fields["PART_ID"] = cn_to_string(prr.PART_ID);
+    record.fields["PART_TXT"] = cn_to_string(prr.PART_TXT);
+    record.fields["part_fix"] = "present";
+
+    return record;
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_hbr(const uint8_t* data, uint16_t length, rec_hbr& hbr) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    std::memset(&hbr, 0, sizeof(hbr));
+    init_header(hbr.header, REC_HBR, length);
+
+    hbr.HEAD_NUM = read_u1(data, offset);
+    hbr.SITE_NUM = read_u1(data, offset);
+    hbr.HBIN_NUM = read_u2<Swap>(data, offset);
+    hbr.HBIN_CNT = read_u4<Swap>(data, offset);
+    hbr.HBIN_PF = read_c1(data, offset);
+    hbr.HBIN_NAM = read_cn_ptr(data, offset);
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_hbr_record(const uint8_t* data, uint16_t length) {
+    rec_hbr hbr;
+    decode_hbr<Swap>(data, length, hbr);
+
+    STDFRecord record = make_record(STDFRecordType::HBR, REC_TYP_PER_LOT, REC_SUB_HBR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&hbr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    return record;
+}
+
+template<bool Swap>
+void STDFBinaryParser::decode_sbr(const uint8_t* data, uint16_t length, rec_sbr& sbr) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    std::memset(&sbr, 0, sizeof(sbr));
+    init_header(sbr.header, REC_SBR, length);
+
+    sbr.HEAD_NUM = read_u1(data, offset);
+    sbr.SITE_NUM = read_u1(data, offset);
+    sbr.SBIN_NUM = read_u2<Swap>(data, offset);
+    sbr.SBIN_CNT = read_u4<Swap>(data, offset);
+    sbr.SBIN_PF = read_c1(data, offset);
+    sbr.SBIN_NAM = read_cn_ptr(data, offset);
+}
+
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_sbr_record(const uint8_t* data, uint16_t length) {
+    rec_sbr sbr;
+    decode_sbr<Swap>(data, length, sbr);
+
+    STDFRecord record = make_record(STDFRecordType::SBR, REC_TYP_PER_LOT, REC_SUB_SBR);
+
+    DynamicSTDFRecord dynamic_record;
+    field_extractor_->extract_fields(&sbr, dynamic_record);
+    merge_dynamic_fields(dynamic_record, record);
+
+    return record;
+}
+
+// MRR is not in the field definitions; only scan_records() decodes it
+template<bool Swap>
+STDFRecord STDFBinaryParser::parse_mrr_record(const uint8_t* data, uint16_t length) {
+    record_length_ = length;
+    size_t offset = 0;
+
+    STDFRecord record = make_record(STDFRecordType::UNKNOWN, REC_TYP_PER_LOT, REC_SUB_MRR);
+    record.fields["RECORD_TYPE"] = "MRR";
+
+    uint32_t finish_t = read_u4<Swap>(data, offset);
+    char disp_cod = read_c1(data, offset);
+    std::string usr_desc = read_cn(data, offset);
+    std::string exc_desc = read_cn(data, offset);
+
+    record.fields["FINISH_T"] = std::to_string(finish_t);
+    if (disp_cod && disp_cod != ' ') record.fields["DISP_COD"] = std::string(1, disp_cod);
+    if (!usr_desc.empty()) record.fields["USR_DESC"] = usr_desc;
+    if (!exc_desc.empty()) record.fields["EXC_DESC"] = exc_desc;
+
+    return record;
+}
+
+// ============================================================================
+// Configuration and utilities
+// ============================================================================
+
+void STDFBinaryParser::set_field_extractor(const DynamicFieldExtractor* extractor) {
+    field_extractor_ = extractor ? extractor : &get_shared_field_extractor();
+}
+
+void STDFBinaryParser::set_enabled_record_types(const std::vector<STDFRecordType>& types) {
+    // PIR opens the part bracket; only parse_all_to_columns keeps it
+    record_filter_.set_enabled_types(types, true);
+}
+
+void STDFBinaryParser::enable_record_type(uint8_t rec_type, uint8_t rec_subtype) {
+    record_filter_.enable(rec_type, rec_subtype);
+}
+
+void STDFBinaryParser::disable_record_type(uint8_t rec_type, uint8_t rec_subtype) {
+    record_filter_.disable(rec_type, rec_subtype);
+}
+
+STDFRecordType STDFBinaryParser::classify_record(uint8_t rec_type, uint8_t rec_subtype) {
+    if (rec_type == 15 && rec_subtype == 10) return STDFRecordType::PTR;
+    if (rec_type == 15 && rec_subtype == 15) return STDFRecordType::MPR;
+    if (rec_type == 15 && rec_subtype == 20) return STDFRecordType::FTR;
+    if (rec_type == 1 && rec_subtype == 40)  return STDFRecordType::HBR;
+    if (rec_type == 1 && rec_subtype == 50)  return STDFRecordType::SBR;
+    if (rec_type == 5 && rec_subtype == 20)  return STDFRecordType::PRR;
+    if (rec_type == 1 && rec_subtype == 10)  return STDFRecordType::MIR;
+
+    return STDFRecordType::UNKNOWN;
+}
+
+std::string STDFBinaryParser::record_type_to_string(STDFRecordType type) {
+    switch (type) {
+        case STDFRecordType::PTR: return "PTR";
+        case STDFRecordType::MPR: return "MPR";
+        case STDFRecordType::FTR: return "FTR";
+        case STDFRecordType::HBR: return "HBR";
+        case STDFRecordType::SBR: return "SBR";
+        case STDFRecordType::PRR: return "PRR";
+        case STDFRecordType::MIR: return "MIR";
+        default: return "UNKNOWN";
+    }
+}
+
+void STDFBinaryParser::set_error(const std::string& error) {
+    last_error_ = error;
+}
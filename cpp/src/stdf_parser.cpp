@@ -1,20 +1,44 @@
 #include "../include/stdf_parser.h"
 #include "../include/dynamic_field_extractor.h"
+#include "../include/stdf_binary_parser.h"
+#include "../include/stdf_record_view.h"
+#include "../include/columnar_store.h"
+#include "../include/stdf_record_index.h"
+#include "../include/ordered_chunks.h"
+#include "../include/decompressing_reader.h"
+#include "../include/mapped_file.h"
+#include "../include/stream_hash.h"
+#include "../include/console_log.h"
+#include "../include/instrumentation.h"
 #include <iostream>
 #include <fstream>
 #include <cstring>
 #include <algorithm>
+#include <thread>
+#include <atomic>
 
 // libstdf headers
 #include <libstdf.h>
 
-// Global shared DynamicFieldExtractor (created once, reused everywhere)
-static DynamicFieldExtractor g_field_extractor;
+// libstdf Cn fields are length-prefixed: [len][chars...]
+static std::string cn_to_string(const char* cn) {
+    if (!cn) return "";
+    return std::string(cn + 1, static_cast<uint8_t>(cn[0]));
+}
 
 STDFParser::STDFParser() 
-    : stdf_file_handle_(nullptr)
+    : backend_(STDFParserBackend::LIBSTDF)
+#ifdef _WIN32
+    , native_io_(true)
+#else
+    , native_io_(false)
+#endif
+    , num_threads_(1)
+    , stdf_file_handle_(nullptr)
     , total_records_(0)
-    , parsed_records_(0) {
+    , parsed_records_(0)
+    , trailing_bytes_(0)
+    , hash_content_(true) {
     
     // Enable common record types by default
     enabled_types_ = {
@@ -26,16 +50,154 @@ STDFParser::STDFParser()
         STDFRecordType::MIR,
         STDFRecordType::PRR
     };
+    record_filter_.set_enabled_types(enabled_types_, false);
 }
 
 STDFParser::~STDFParser() {
     close_stdf_file();
+    close_indexed();
 }
 
 std::vector<STDFRecord> STDFParser::parse_file(const std::string& filepath) {
     std::vector<STDFRecord> results;
     
-    std::cout << "Parsing STDF file with libstdf: " << filepath << std::endl;
+    stream_file(filepath, [&results](STDFRecord& record) {
+        results.push_back(std::move(record));
+    });
+    
+    return results;
+}
+
+bool STDFParser::stream_file(const std::string& filepath, STDFRecordVisitor& visitor) {
+    bool ok = stream_file(filepath, [&visitor](STDFRecord& record) {
+        switch (record.type) {
+            case STDFRecordType::MIR: visitor.on_mir(record); break;
+            case STDFRecordType::PTR: visitor.on_ptr(record); break;
+            case STDFRecordType::MPR: visitor.on_mpr(record); break;
+            case STDFRecordType::FTR: visitor.on_ftr(record); break;
+            case STDFRecordType::HBR: visitor.on_hbr(record); break;
+            case STDFRecordType::SBR: visitor.on_sbr(record); break;
+            case STDFRecordType::PRR: visitor.on_prr(record); break;
+            default: break;
+        }
+    });
+    
+    visitor.on_end();
+    return ok;
+}
+
+// libstdf leaves a raw record's REC_LEN in file byte order; the FAR (always
+// first) gives that order in CPU_TYPE
+static bool raw_far_is_big_endian(const rec_unknown* raw) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(raw->data);
+    return raw->header.REC_TYP == REC_TYP_INFO && raw->header.REC_SUB == REC_SUB_FAR && bytes[4] == 1;
+}
+
+static uint16_t raw_record_length(const rec_unknown* raw, bool big_endian) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(raw->data);
+    return big_endian ? static_cast<uint16_t>((bytes[0] << 8) | bytes[1])
+                      : static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+static bool host_is_big_endian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 0;
+}
+
+bool STDFParser::stream_views(const std::string& filepath, const STDFRecordViewCallback& callback) {
+    StageTimer timer(InstrumentedStage::PARSE);
+    STDFRecordView view;
+    if (use_pipelined_decompression(filepath)) {
+        return decode_compressed(filepath, [&](STDFBinaryParser& reader) {
+            while (reader.next_view(view)) {
+                callback(view);
+            }
+        });
+    }
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    total_records_ = 0;
+    parsed_records_ = 0;
+    
+    if (use_mapped_reader(filepath)) {
+        STDFBinaryParser binary_parser;
+        binary_parser.set_enabled_record_types(enabled_types_);
+        if (!binary_parser.open_file(filepath)) {
+            ConsoleLog::err() << "Failed to open STDF file with mmap reader: " << filepath 
+                      << " (" << binary_parser.get_last_error() << ")" << std::endl;
+            return false;
+        }
+        while (binary_parser.next_view(view)) {
+            callback(view);
+        }
+        total_records_ = binary_parser.get_total_records();
+        parsed_records_ = binary_parser.get_parsed_records();
+        return true;
+    }
+    
+    stdf_file* file = stdf_open(const_cast<char*>(filepath.c_str()));
+    if (!file) {
+        ConsoleLog::err() << "Failed to open STDF file with libstdf: " << filepath << std::endl;
+        return false;
+    }
+    
+    // Views point into libstdf's raw buffer, which is in file byte order
+    RecordCounters counters;
+    bool big_endian = false;
+    rec_unknown* raw;
+    while ((raw = stdf_read_record_raw(file)) != nullptr) {
+        total_records_++;
+        uint8_t rec_typ = raw->header.REC_TYP;
+        uint8_t rec_sub = raw->header.REC_SUB;
+        if (total_records_ == 1) {
+            big_endian = raw_far_is_big_endian(raw);
+        }
+        uint16_t length = raw_record_length(raw, big_endian);
+        counters.add(rec_typ, rec_sub, length);
+        
+        if (record_filter_.enabled(rec_typ, rec_sub)) {
+            view.reset(rec_typ, rec_sub, static_cast<const uint8_t*>(raw->data) + 4, length,
+                       big_endian != host_is_big_endian(), static_cast<uint32_t>(total_records_));
+            if (view.type() != STDFRecordType::UNKNOWN) {
+                parsed_records_++;
+                callback(view);
+            }
+        }
+        stdf_free_record(raw);
+    }
+    
+    stdf_close(file);
+    Instrumentation::add_records(counters);
+    return true;
+}
+
+bool STDFParser::stream_file(const std::string& filepath, const STDFRecordCallback& callback) {
+    StageTimer timer(InstrumentedStage::PARSE);
+    if (use_pipelined_decompression(filepath)) {
+        ConsoleLog::out() << "Parsing compressed STDF file with pipelined decompression: " << filepath << std::endl;
+        return decode_compressed(filepath, [&callback](STDFBinaryParser& reader) {
+            while (reader.has_more_records()) {
+                STDFRecord record = reader.parse_next_record();
+                if (record.type == STDFRecordType::UNKNOWN) {
+                    break;
+                }
+                callback(record);
+            }
+        });
+    }
+    
+    std::vector<DecodeChunk> chunks;
+    if (plan_chunks(filepath, chunks)) {
+        return stream_file_parallel(filepath, chunks, callback);
+    }
+    
+    if (use_mapped_reader(filepath)) {
+        return stream_file_mmap(filepath, callback);
+    }
+    
+    ConsoleLog::out() << "Parsing STDF file with libstdf: " << filepath << std::endl;
     
     // Extract filename for record context
     size_t last_slash = filepath.find_last_of("/\\");
@@ -48,59 +210,783 @@ std::vector<STDFRecord> STDFParser::parse_file(const std::string& filepath) {
     // Open STDF file with libstdf
     stdf_file* file = stdf_open(const_cast<char*>(filepath.c_str()));
     if (!file) {
-        std::cerr << "Failed to open STDF file with libstdf: " << filepath << std::endl;
-        return results;
+        ConsoleLog::err() << "Failed to open STDF file with libstdf: " << filepath << std::endl;
+        return false;
     }
     
     stdf_file_handle_ = file;
     
-    // Read records using libstdf - safer approach
-    rec_unknown* record;
-    while ((record = stdf_read_record(file)) != nullptr) {
+    // Read records raw; libstdf decodes only the types the filter lets through
+    RecordCounters counters;
+    STDFRecordView view;
+    bool big_endian = false;
+    rec_unknown* raw;
+    while ((raw = stdf_read_record_raw(file)) != nullptr) {
         total_records_++;
+        uint8_t rec_typ = raw->header.REC_TYP;
+        uint8_t rec_sub = raw->header.REC_SUB;
+        if (total_records_ == 1) {
+            big_endian = raw_far_is_big_endian(raw);
+        }
+        uint16_t length = raw_record_length(raw, big_endian);
+        counters.add(rec_typ, rec_sub, length);
+        
+        if (!record_filter_.enabled(rec_typ, rec_sub)) {
+            stdf_free_record(raw);
+            continue;
+        }
+        
+        STDFRecordType raw_type = get_record_type(rec_typ, rec_sub);
+        if (field_extractor().is_projected(raw_type)) {
+            view.reset(rec_typ, rec_sub, static_cast<const uint8_t*>(raw->data) + 4, length,
+                       big_endian != host_is_big_endian(), static_cast<uint32_t>(total_records_));
+            STDFRecord parsed_record = parse_projected_record(view);
+            stdf_free_record(raw);
+            parsed_record.filename = current_filename_;
+            parsed_record.record_index = total_records_;
+            parsed_records_++;
+            callback(parsed_record);
+            continue;
+        }
+        
+        rec_unknown* record = stdf_parse_raw_record(raw);
+        stdf_free_record(raw);
+        if (!record) {
+            ConsoleLog::err() << "Warning: NULL record encountered" << std::endl;
+            continue;
+        }
         
         try {
-            // Get record type and subtype safely
-            if (!record) {
-                std::cerr << "Warning: NULL record encountered" << std::endl;
-                continue;
-            }
-            
-            uint8_t rec_typ = record->header.REC_TYP;
-            uint8_t rec_sub = record->header.REC_SUB;
-            
             STDFRecordType type = get_record_type(rec_typ, rec_sub);
             
-            // Skip if this record type is not enabled
-            if (std::find(enabled_types_.begin(), enabled_types_.end(), type) == enabled_types_.end()) {
-                stdf_free_record(record);
-                continue;
-            }
-            
             // Parse the record based on its type - with error handling
             STDFRecord parsed_record = parse_record(record, type);
             if (!parsed_record.fields.empty() || type == STDFRecordType::MIR) {
                 parsed_record.filename = current_filename_;
                 parsed_record.record_index = total_records_;
-                results.push_back(parsed_record);
                 parsed_records_++;
+                callback(parsed_record);
             }
             
         } catch (const std::exception& e) {
-            std::cerr << "Error processing record " << total_records_ << ": " << e.what() << std::endl;
+            ConsoleLog::err() << "Error processing record " << total_records_ << ": " << e.what() << std::endl;
         }
         
         stdf_free_record(record);
     }
     
     close_stdf_file();
+    Instrumentation::add_records(counters);
+    
+    ConsoleLog::out() << "libstdf parsing completed. Total records: " << total_records_ 
+              << ", Parsed: " << parsed_records_ << std::endl;
+    
+    return true;
+}
+
+bool STDFParser::stream_file_mmap(const std::string& filepath, const STDFRecordCallback& callback) {
+    ConsoleLog::out() << "Parsing STDF file with memory-mapped reader: " << filepath << std::endl;
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    total_records_ = 0;
+    parsed_records_ = 0;
+    
+    STDFBinaryParser binary_parser;
+    binary_parser.set_enabled_record_types(enabled_types_);
+    binary_parser.set_field_extractor(field_extractor_.get());
+    
+    if (!binary_parser.open_file(filepath)) {
+        ConsoleLog::err() << "Failed to open STDF file with mmap reader: " << filepath 
+                  << " (" << binary_parser.get_last_error() << ")" << std::endl;
+        return false;
+    }
+    
+    while (binary_parser.has_more_records()) {
+        STDFRecord record = binary_parser.parse_next_record();
+        if (record.type == STDFRecordType::UNKNOWN) {
+            break;
+        }
+        callback(record);
+    }
+    
+    if (!binary_parser.get_last_error().empty()) {
+        ConsoleLog::err() << "Warning: " << binary_parser.get_last_error() << std::endl;
+    }
+    
+    total_records_ = binary_parser.get_total_records();
+    parsed_records_ = binary_parser.get_parsed_records();
+    
+    ConsoleLog::out() << "mmap parsing completed. Total records: " << total_records_ 
+              << ", Parsed: " << parsed_records_ << std::endl;
+    
+    return true;
+}
+
+// XXH64 of the STDF byte stream in a file, inflating gzip/bzip2 on the way
+std::string STDFParser::hash_file_content(const std::string& filepath) {
+    StageTimer timer(InstrumentedStage::CONTENT_HASH);
+    StreamHash hash;
+    STDFCompression compression = detect_compression(filepath);
+#ifdef HAVE_BZLIB
+    bool inflate = compression == STDFCompression::GZIP || compression == STDFCompression::BZIP2;
+#else
+    bool inflate = compression == STDFCompression::GZIP;
+#endif
+    if (inflate) {
+        DecompressingReader decompressor;
+        std::vector<uint8_t> block;
+        if (!decompressor.open(filepath)) {
+            return "";
+        }
+        while (decompressor.next_block(block)) {
+            hash.update(block.data(), block.size());
+        }
+        return decompressor.get_last_error().empty() ? hash.hex_digest() : "";
+    }
+    
+    MappedFile file;
+    if (!file.open(filepath)) {
+        return "";
+    }
+    hash.update(file.data(), file.size());
+    return hash.hex_digest();
+}
+
+bool STDFParser::parse_to_columns(const std::string& filepath, STDFColumnarStore& store) {
+    StageTimer timer(InstrumentedStage::PARSE);
+    content_hash_.clear();
+    hash_content_ = known_content_hash_.empty();
+    bool parsed = decode_to_columns(filepath, store);
+    if (!hash_content_) {
+        content_hash_ = parsed ? known_content_hash_ : "";
+    }
+    known_content_hash_.clear();
+    hash_content_ = true;
+    return parsed;
+}
+
+bool STDFParser::decode_to_columns(const std::string& filepath, STDFColumnarStore& store) {
+    if (use_pipelined_decompression(filepath)) {
+        ConsoleLog::out() << "Parsing compressed STDF file into columns with pipelined decompression: " << filepath << std::endl;
+        return decode_compressed(filepath, [&store](STDFBinaryParser& reader) {
+            reader.parse_all_to_columns(store);
+        });
+    }
+    
+    std::vector<DecodeChunk> chunks;
+    if (plan_chunks(filepath, chunks)) {
+        return parse_to_columns_parallel(filepath, chunks, store);
+    }
+    
+    if (use_mapped_reader(filepath)) {
+        return parse_to_columns_mmap(filepath, store);
+    }
+    
+    ConsoleLog::out() << "Parsing STDF file into columns with libstdf: " << filepath << std::endl;
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    total_records_ = 0;
+    parsed_records_ = 0;
+    
+    stdf_file* file = stdf_open(const_cast<char*>(filepath.c_str()));
+    if (!file) {
+        ConsoleLog::err() << "Failed to open STDF file with libstdf: " << filepath << std::endl;
+        return false;
+    }
+    
+    stdf_file_handle_ = file;
+    
+    const bool keep_pir = record_filter_.enabled(REC_TYP_PER_PART, REC_SUB_PRR);
+    
+    RecordCounters counters;
+    StreamHash hash;
+    bool big_endian = false;
+    rec_unknown* raw;
+    while ((raw = stdf_read_record_raw(file)) != nullptr) {
+        total_records_++;
+        uint8_t rec_typ = raw->header.REC_TYP;
+        uint8_t rec_sub = raw->header.REC_SUB;
+        if (total_records_ == 1) {
+            big_endian = raw_far_is_big_endian(raw);
+        }
+        const uint16_t length = raw_record_length(raw, big_endian);
+        counters.add(rec_typ, rec_sub, length);
+        // The raw bytes hold the 4-byte header too: together the records are
+        // the (decompressed) byte stream hash_file_content() would read again
+        if (hash_content_) {
+            hash.update(raw->data, 4 + size_t(length));
+        }
+        
+        uint32_t record_index = static_cast<uint32_t>(total_records_);
+        
+        // PIR opens the part bracket; kept (uncounted) whenever PRR is
+        const bool part_bracket = rec_typ == REC_TYP_PER_PART && rec_sub == REC_SUB_PIR && keep_pir;
+        if (!part_bracket && !record_filter_.enabled(rec_typ, rec_sub)) {
+            stdf_free_record(raw);
+            continue;
+        }
+        
+        rec_unknown* record = stdf_parse_raw_record(raw);
+        stdf_free_record(raw);
+        if (!record) {
+            continue;
+        }
+        
+        if (part_bracket) {
+            store.append(*reinterpret_cast<rec_pir*>(record), record_index);
+            stdf_free_record(record);
+            continue;
+        }
+        
+        STDFRecordType type = get_record_type(rec_typ, rec_sub);
+        switch (type) {
+            case STDFRecordType::PTR: store.append(*reinterpret_cast<rec_ptr*>(record), record_index); break;
+            case STDFRecordType::MPR: store.append(*reinterpret_cast<rec_mpr*>(record), record_index); break;
+            case STDFRecordType::FTR: store.append(*reinterpret_cast<rec_ftr*>(record), record_index); break;
+            case STDFRecordType::HBR: store.append(*reinterpret_cast<rec_hbr*>(record), record_index); break;
+            case STDFRecordType::SBR: store.append(*reinterpret_cast<rec_sbr*>(record), record_index); break;
+            case STDFRecordType::PRR: store.append(*reinterpret_cast<rec_prr*>(record), record_index); break;
+            case STDFRecordType::MIR: {
+                STDFRecord mir = parse_mir_record(record);
+                mir.filename = current_filename_;
+                mir.record_index = record_index;
+                store.mir_records.push_back(std::move(mir));
+                break;
+            }
+            default:
+                break;
+        }
+        parsed_records_++;
+        
+        stdf_free_record(record);
+    }
+    
+    close_stdf_file();
+    Instrumentation::add_records(counters);
+    content_hash_ = hash.hex_digest();
+    
+    ConsoleLog::out() << "libstdf columnar parsing completed. Total records: " << total_records_ 
+              << ", Parsed: " << parsed_records_ << std::endl;
+    
+    return true;
+}
+
+bool STDFParser::parse_to_columns_mmap(const std::string& filepath, STDFColumnarStore& store) {
+    ConsoleLog::out() << "Parsing STDF file into columns with memory-mapped reader: " << filepath << std::endl;
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    STDFBinaryParser binary_parser;
+    binary_parser.set_enabled_record_types(enabled_types_);
+    
+    if (!binary_parser.open_file(filepath)) {
+        ConsoleLog::err() << "Failed to open STDF file with mmap reader: " << filepath 
+                  << " (" << binary_parser.get_last_error() << ")" << std::endl;
+        total_records_ = 0;
+        parsed_records_ = 0;
+        return false;
+    }
+    
+    binary_parser.parse_all_to_columns(store);
+    if (!binary_parser.get_last_error().empty()) {
+        ConsoleLog::err() << "Warning: " << binary_parser.get_last_error() << std::endl;
+    }
+    
+    // Hashed from the mapping just decoded, while its pages are still cached
+    if (hash_content_) {
+        StageTimer timer(InstrumentedStage::CONTENT_HASH);
+        StreamHash hash;
+        hash.update(binary_parser.get_data(), binary_parser.get_file_size());
+        content_hash_ = hash.hex_digest();
+    }
+    
+    total_records_ = binary_parser.get_total_records();
+    parsed_records_ = binary_parser.get_parsed_records();
+    
+    ConsoleLog::out() << "mmap columnar parsing completed. Total records: " << total_records_ 
+              << ", Parsed: " << parsed_records_ << std::endl;
+    
+    return true;
+}
+
+bool STDFParser::scan_file(const std::string& filepath, STDFScanSummary& summary) {
+    StageTimer timer(InstrumentedStage::SCAN);
+    summary = STDFScanSummary();
+    content_hash_.clear();
+    
+    STDFCompression compression = detect_compression(filepath);
+#ifdef HAVE_BZLIB
+    bool compressed = compression == STDFCompression::GZIP || compression == STDFCompression::BZIP2;
+#else
+    bool compressed = compression == STDFCompression::GZIP;
+#endif
+    if (compressed) {
+        bool ok = decode_compressed(filepath, [&summary](STDFBinaryParser& reader) {
+            reader.scan_records(summary);
+        });
+        summary.stdf_bytes += trailing_bytes_;
+        summary.truncated = summary.truncated || trailing_bytes_ > 0;
+        return ok;
+    }
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    STDFBinaryParser reader;
+    if (!reader.open_file(filepath)) {
+        ConsoleLog::err() << "Failed to open STDF file for scanning: " << filepath 
+                  << " (" << reader.get_last_error() << ")" << std::endl;
+        total_records_ = 0;
+        parsed_records_ = 0;
+        return false;
+    }
+    
+    reader.scan_records(summary);
+    total_records_ = summary.total_records;
+    parsed_records_ = 0;
+    
+    ConsoleLog::out() << "Header scan completed: " << filepath << " (" << total_records_ << " records, "
+              << summary.count(CountedRecordType::PRR) << " parts"
+              << (summary.complete() ? "" : ", incomplete") << ")" << std::endl;
+    return true;
+}
+
+// ============================================================================
+// Intra-file parallel decoding
+// ============================================================================
+
+// Chunks smaller than this are not worth a thread hand-off
+static const size_t MIN_CHUNK_BYTES = 256 * 1024;
+
+// Chunks per worker, so uneven parts still balance across threads
+static const size_t CHUNKS_PER_THREAD = 4;
+
+void STDFParser::set_num_threads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads_ = threads;
+}
+
+bool STDFParser::plan_chunks(const std::string& filepath, std::vector<DecodeChunk>& chunks) {
+    chunks.clear();
+    if (num_threads_ <= 1) {
+        return false;
+    }
+    
+    // Header-only pre-scan; reuse a valid sidecar if one exists
+    STDFRecordIndex index;
+    if (!index.load(STDFRecordIndex::sidecar_path(filepath), filepath) && !index.build(filepath)) {
+        ConsoleLog::err() << "Parallel decoding unavailable, decoding sequentially (" 
+                  << index.get_last_error() << ")" << std::endl;
+        return false;
+    }
+    
+    const std::vector<STDFIndexEntry>& entries = index.entries();
+    if (entries.empty()) {
+        return false;
+    }
+    
+    const STDFIndexEntry& last = entries.back();
+    const size_t file_end = last.offset + 4 + last.length;
+    const size_t target = std::max(MIN_CHUNK_BYTES, file_end / (num_threads_ * CHUNKS_PER_THREAD));
+    
+    // Cut after a PRR once the chunk reaches the target size so parts stay
+    // whole; cut anywhere past twice the target if no part boundary shows up
+    DecodeChunk chunk = {0, 0, 1, 0};
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const STDFIndexEntry& e = entries[i];
+        chunk.end_offset = e.offset + 4 + e.length;
+        chunk.record_count++;
+        
+        size_t chunk_bytes = chunk.end_offset - chunk.begin_offset;
+        bool part_end = (e.rec_type == REC_TYP_PER_PART && e.rec_subtype == REC_SUB_PRR);
+        if ((part_end && chunk_bytes >= target) || chunk_bytes >= 2 * target) {
+            chunks.push_back(chunk);
+            chunk = {chunk.end_offset, chunk.end_offset, static_cast<uint32_t>(i + 2), 0};
+        }
+    }
+    if (chunk.record_count > 0) {
+        chunks.push_back(chunk);
+    }
+    
+    return chunks.size() > 1;
+}
+
+bool STDFParser::use_pipelined_decompression(const std::string& filepath) const {
+    if (backend_ != STDFParserBackend::MMAP && !native_io_ && num_threads_ <= 1) {
+        return false;
+    }
+    
+    STDFCompression compression = detect_compression(filepath);
+#ifdef HAVE_BZLIB
+    return compression == STDFCompression::GZIP || compression == STDFCompression::BZIP2;
+#else
+    return compression == STDFCompression::GZIP;
+#endif
+}
+
+bool STDFParser::use_mapped_reader(const std::string& filepath) const {
+    return backend_ == STDFParserBackend::MMAP ||
+           (native_io_ && detect_compression(filepath) == STDFCompression::NONE);
+}
+
+// Length of the leading run of whole records in [data, data + size)
+static size_t complete_records_length(const uint8_t* data, size_t size, bool big_endian) {
+    size_t position = 0;
+    while (position + 4 <= size) {
+        size_t length = big_endian ? static_cast<size_t>((data[position] << 8) | data[position + 1])
+                                   : static_cast<size_t>(data[position] | (data[position + 1] << 8));
+        if (position + 4 + length > size) break;
+        position += 4 + length;
+    }
+    return position;
+}
+
+bool STDFParser::decode_compressed(const std::string& filepath,
+                                   const std::function<void(STDFBinaryParser&)>& decode) {
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    total_records_ = 0;
+    parsed_records_ = 0;
+    trailing_bytes_ = 0;
     
-    std::cout << "libstdf parsing completed. Total records: " << total_records_ 
+    DecompressingReader decompressor;
+    if (!decompressor.open(filepath, num_threads_)) {
+        ConsoleLog::err() << "Failed to open compressed STDF file: " << filepath 
+                  << " (" << decompressor.get_last_error() << ")" << std::endl;
+        return false;
+    }
+    
+    STDFBinaryParser reader;
+    reader.set_enabled_record_types(enabled_types_);
+    reader.set_field_extractor(field_extractor_.get());
+    
+    // Decompressed blocks split records arbitrarily: whole records are
+    // decoded in place and only the record straddling a block boundary is
+    // assembled in `pending`
+    std::vector<uint8_t> block;
+    std::vector<uint8_t> pending;
+    bool big_endian = false;
+    bool first_block = true;
+    
+    auto decode_range = [&](const uint8_t* data, size_t size) {
+        reader.attach_buffer(data, size, current_filename_, static_cast<uint32_t>(total_records_ + 1));
+        decode(reader);
+        total_records_ = reader.get_total_records();
+        parsed_records_ += reader.get_parsed_records();
+    };
+    
+    StreamHash hash;
+    while (decompressor.next_block(block)) {
+        if (hash_content_) {
+            hash.update(block.data(), block.size());
+        }
+        if (first_block) {
+            // FAR: REC_LEN=2, REC_TYP=0, REC_SUB=10, CPU_TYPE
+            if (block.size() < 6 || block[2] != 0 || block[3] != 10) {
+                ConsoleLog::err() << "Compressed file does not start with a FAR record: " << filepath << std::endl;
+                return false;
+            }
+            big_endian = (block[4] == 1);
+            first_block = false;
+        }
+        
+        size_t offset = 0;
+        if (!pending.empty()) {
+            // Top up the header first, then the rest of the straddling record
+            if (pending.size() < 4) {
+                size_t take = std::min(4 - pending.size(), block.size());
+                pending.insert(pending.end(), block.begin(), block.begin() + take);
+                offset = take;
+            }
+            if (pending.size() >= 4) {
+                size_t length = big_endian ? static_cast<size_t>((pending[0] << 8) | pending[1])
+                                           : static_cast<size_t>(pending[0] | (pending[1] << 8));
+                size_t record_size = 4 + length;
+                size_t take = std::min(record_size - pending.size(), block.size() - offset);
+                pending.insert(pending.end(), block.begin() + offset, block.begin() + offset + take);
+                offset += take;
+                if (pending.size() == record_size) {
+                    decode_range(pending.data(), pending.size());
+                    pending.clear();
+                }
+            }
+            if (!pending.empty()) {
+                continue;  // Block consumed entirely by one long record
+            }
+        }
+        
+        size_t complete = complete_records_length(block.data() + offset, block.size() - offset, big_endian);
+        if (complete > 0) {
+            decode_range(block.data() + offset, complete);
+        }
+        pending.assign(block.begin() + offset + complete, block.end());
+    }
+    
+    if (!decompressor.get_last_error().empty()) {
+        ConsoleLog::err() << "Warning: " << decompressor.get_last_error() << std::endl;
+    }
+    trailing_bytes_ = pending.size();
+    if (!pending.empty()) {
+        ConsoleLog::err() << "Warning: " << pending.size() << " trailing bytes do not form a complete record" << std::endl;
+    }
+    
+    ConsoleLog::out() << "Pipelined decompression completed (" << decompressor.member_count() << " member(s)"
+              << (decompressor.is_parallel() ? ", parallel" : "") << "). Total records: " 
+              << total_records_ << ", Parsed: " << parsed_records_ << std::endl;
+    
+    if (!decompressor.get_last_error().empty()) {
+        return false;
+    }
+    content_hash_ = hash.hex_digest();
+    return true;
+}
+
+// Opens a per-thread reader positioned on one chunk
+static bool open_chunk_reader(STDFBinaryParser& reader, const std::string& filepath,
+                              const std::vector<STDFRecordType>& enabled_types,
+                              size_t begin_offset, size_t end_offset, uint32_t first_record) {
+    reader.set_enabled_record_types(enabled_types);
+    if (!reader.open_file(filepath) || !reader.set_range(begin_offset, end_offset, first_record)) {
+        ConsoleLog::err() << "Failed to open chunk at offset " << begin_offset << ": " 
+                  << reader.get_last_error() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool STDFParser::stream_file_parallel(const std::string& filepath, const std::vector<DecodeChunk>& chunks,
+                                      const STDFRecordCallback& callback) {
+    ConsoleLog::out() << "Parsing STDF file with " << num_threads_ << " threads (" << chunks.size() 
+              << " chunks): " << filepath << std::endl;
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    std::vector<std::vector<STDFRecord>> results(chunks.size());
+    std::vector<size_t> parsed(chunks.size(), 0);
+    std::atomic<bool> ok(true);
+    
+    run_chunks_in_order(chunks.size(), num_threads_,
+        [&](size_t id) {
+            StageTimer timer(InstrumentedStage::CHUNK_DECODE);
+            const DecodeChunk& chunk = chunks[id];
+            STDFBinaryParser reader;
+            reader.set_field_extractor(field_extractor_.get());
+            if (!open_chunk_reader(reader, filepath, enabled_types_, chunk.begin_offset, 
+                                   chunk.end_offset, chunk.first_record)) {
+                ok = false;
+                return;
+            }
+            while (reader.has_more_records()) {
+                STDFRecord record = reader.parse_next_record();
+                if (record.type == STDFRecordType::UNKNOWN) {
+                    break;
+                }
+                results[id].push_back(std::move(record));
+            }
+            parsed[id] = reader.get_parsed_records();
+        },
+        [&](size_t id) {
+            for (STDFRecord& record : results[id]) {
+                callback(record);
+            }
+            std::vector<STDFRecord>().swap(results[id]);
+        });
+    
+    total_records_ = chunks.back().first_record + chunks.back().record_count - 1;
+    parsed_records_ = 0;
+    for (size_t count : parsed) {
+        parsed_records_ += count;
+    }
+    
+    ConsoleLog::out() << "Parallel parsing completed. Total records: " << total_records_ 
               << ", Parsed: " << parsed_records_ << std::endl;
     
+    return ok;
+}
+
+bool STDFParser::parse_to_columns_parallel(const std::string& filepath, const std::vector<DecodeChunk>& chunks,
+                                           STDFColumnarStore& store) {
+    ConsoleLog::out() << "Parsing STDF file into columns with " << num_threads_ << " threads (" 
+              << chunks.size() << " chunks): " << filepath << std::endl;
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    std::vector<STDFColumnarStore> results(chunks.size());
+    std::vector<size_t> parsed(chunks.size(), 0);
+    std::atomic<bool> ok(true);
+    
+    // Chunks are merged in file order, so their bytes are hashed there while
+    // later chunks are still being decoded
+    MappedFile file;
+    StreamHash hash;
+    bool hashing = hash_content_ && file.open(filepath);
+    
+    run_chunks_in_order(chunks.size(), num_threads_,
+        [&](size_t id) {
+            StageTimer timer(InstrumentedStage::CHUNK_DECODE);
+            const DecodeChunk& chunk = chunks[id];
+            STDFBinaryParser reader;
+            if (!open_chunk_reader(reader, filepath, enabled_types_, chunk.begin_offset, 
+                                   chunk.end_offset, chunk.first_record)) {
+                ok = false;
+                return;
+            }
+            reader.parse_all_to_columns(results[id]);
+            parsed[id] = reader.get_parsed_records();
+        },
+        [&](size_t id) {
+            store.append_store(results[id]);
+            results[id] = STDFColumnarStore();
+            if (hashing) {
+                hash.update(file.data() + chunks[id].begin_offset, chunks[id].end_offset - chunks[id].begin_offset);
+            }
+        });
+    
+    if (hashing && ok) {
+        // Anything after the last whole record (normally nothing)
+        size_t tail = chunks.back().end_offset;
+        hash.update(file.data() + tail, file.size() - tail);
+        content_hash_ = hash.hex_digest();
+    }
+    
+    total_records_ = chunks.back().first_record + chunks.back().record_count - 1;
+    parsed_records_ = 0;
+    for (size_t count : parsed) {
+        parsed_records_ += count;
+    }
+    
+    ConsoleLog::out() << "Parallel columnar parsing completed. Total records: " << total_records_ 
+              << ", Parsed: " << parsed_records_ << std::endl;
+    
+    return ok;
+}
+
+// REC_TYP/REC_SUB pair for a decoded record type
+static bool record_type_codes(STDFRecordType type, uint8_t& rec_typ, uint8_t& rec_sub) {
+    switch (type) {
+        case STDFRecordType::PTR: rec_typ = REC_TYP_PER_EXEC; rec_sub = REC_SUB_PTR; return true;
+        case STDFRecordType::MPR: rec_typ = REC_TYP_PER_EXEC; rec_sub = REC_SUB_MPR; return true;
+        case STDFRecordType::FTR: rec_typ = REC_TYP_PER_EXEC; rec_sub = REC_SUB_FTR; return true;
+        case STDFRecordType::HBR: rec_typ = REC_TYP_PER_LOT; rec_sub = REC_SUB_HBR; return true;
+        case STDFRecordType::SBR: rec_typ = REC_TYP_PER_LOT; rec_sub = REC_SUB_SBR; return true;
+        case STDFRecordType::PRR: rec_typ = REC_TYP_PER_PART; rec_sub = REC_SUB_PRR; return true;
+        case STDFRecordType::MIR: rec_typ = REC_TYP_PER_LOT; rec_sub = REC_SUB_MIR; return true;
+        default: return false;
+    }
+}
+
+bool STDFParser::open_indexed(const std::string& filepath, const std::string& cache_dir) {
+    close_indexed();
+    
+    auto index = std::make_unique<STDFRecordIndex>();
+    if (!index->load_or_build(filepath, cache_dir)) {
+        ConsoleLog::err() << "Failed to index STDF file: " << filepath 
+                  << " (" << index->get_last_error() << ")" << std::endl;
+        return false;
+    }
+    
+    auto reader = std::make_unique<STDFBinaryParser>();
+    reader->set_field_extractor(field_extractor_.get());
+    if (!reader->open_file(filepath)) {
+        ConsoleLog::err() << "Failed to open STDF file for indexed reads: " << filepath 
+                  << " (" << reader->get_last_error() << ")" << std::endl;
+        return false;
+    }
+    
+    size_t last_slash = filepath.find_last_of("/\\");
+    current_filename_ = (last_slash != std::string::npos) ? 
+                       filepath.substr(last_slash + 1) : filepath;
+    
+    index_ = std::move(index);
+    indexed_reader_ = std::move(reader);
+    return true;
+}
+
+void STDFParser::close_indexed() {
+    indexed_reader_.reset();
+    index_.reset();
+}
+
+bool STDFParser::read_record(uint32_t record_index, STDFRecord& record) {
+    if (!index_ || record_index == 0 || record_index > index_->size()) {
+        return false;
+    }
+    
+    record = indexed_reader_->parse_record_at(index_->entry(record_index).offset, record_index);
+    return record.type != STDFRecordType::UNKNOWN;
+}
+
+std::vector<STDFRecord> STDFParser::read_records_of_type(STDFRecordType type) {
+    std::vector<STDFRecord> results;
+    
+    uint8_t rec_typ = 0, rec_sub = 0;
+    if (!index_ || !record_type_codes(type, rec_typ, rec_sub)) {
+        return results;
+    }
+    
+    for (uint32_t record_index : index_->find_records(rec_typ, rec_sub)) {
+        STDFRecord record;
+        if (read_record(record_index, record)) {
+            results.push_back(std::move(record));
+        }
+    }
+    
+    return results;
+}
+
+std::vector<STDFRecord> STDFParser::read_part(size_t part_number) {
+    std::vector<STDFRecord> results;
+    
+    if (!index_ || part_number >= index_->parts().size()) {
+        return results;
+    }
+    
+    const STDFPartSpan& part = index_->parts()[part_number];
+    
+    for (uint32_t record_index = part.first_record; record_index <= part.prr_record; ++record_index) {
+        const STDFIndexEntry& entry = index_->entry(record_index);
+        if (!record_filter_.enabled(entry.rec_type, entry.rec_subtype)) {
+            continue;
+        }
+        STDFRecordType type = get_record_type(entry.rec_type, entry.rec_subtype);
+        
+        // Concurrent sites interleave inside a bracket; keep this part's own
+        bool per_site = (type == STDFRecordType::PTR || type == STDFRecordType::MPR ||
+                         type == STDFRecordType::FTR || type == STDFRecordType::PRR);
+        if (per_site && (entry.head_num != part.head_num || entry.site_num != part.site_num)) {
+            continue;
+        }
+        
+        STDFRecord record;
+        if (read_record(record_index, record)) {
+            results.push_back(std::move(record));
+        }
+    }
+    
     return results;
 }
 
+size_t STDFParser::get_part_count() const {
+    return index_ ? index_->parts().size() : 0;
+}
+
 void STDFParser::create_sample_records(std::vector<STDFRecord>& results) {
     // Create sample PTR record for testing
     STDFRecord ptr_record;
@@ -206,27 +1092,54 @@ std::string STDFParser::extract_string_field(const char* field, size_t max_len)
 
 void STDFParser::set_enabled_record_types(const std::vector<STDFRecordType>& types) {
     enabled_types_ = types;
+    record_filter_.set_enabled_types(types, false);
+}
+
+bool STDFParser::set_field_config(const std::string& config_json) {
+    if (config_json.empty()) {
+        field_extractor_.reset();
+        return true;
+    }
+    
+    auto extractor = std::make_shared<DynamicFieldExtractor>("");
+    if (!extractor->set_config_from_json(config_json)) {
+        return false;
+    }
+    field_extractor_ = std::move(extractor);
+    return true;
 }
 
-void STDFParser::set_field_config(const std::string& config_json) {
-    // TODO: Parse JSON configuration for field extraction
-    // This would determine which fields to extract for each record type
+const DynamicFieldExtractor& STDFParser::field_extractor() const {
+    return field_extractor_ ? *field_extractor_ : get_shared_field_extractor();
+}
+
+// Projected types: the selected fields straight from the record bytes,
+// skipping libstdf's full decode
+STDFRecord STDFParser::parse_projected_record(STDFRecordView& view) {
+    STDFRecord record;
+    record.type = view.type();
+    record.rec_type = view.rec_type();
+    record.rec_subtype = view.rec_subtype();
+    record.fields["REC_TYPE"] = std::to_string(record.rec_type);
+    record.fields["REC_SUB"] = std::to_string(record.rec_subtype);
+    
+    DynamicSTDFRecord dynamic_record;
+    field_extractor().extract_fields(view, dynamic_record);
+    record.fields["RECORD_TYPE"] = dynamic_record.type_name;
+    for (auto& field : dynamic_record.fields) {
+        record.fields[field.first] = std::move(field.second);
+    }
+    return record;
 }
 
 // Record-specific parsers using libstdf structures
 
 STDFRecord STDFParser::parse_ptr_record(void* ptr_rec) {
-    static int ptr_count = 0;
-    ptr_count++;
-    if (ptr_count <= 3) printf("PTR Parser called #%d\n", ptr_count);
-    
     STDFRecord record;
     record.type = STDFRecordType::PTR;
     
     rec_unknown* rec = static_cast<rec_unknown*>(ptr_rec);
     
-    if (ptr_count <= 3) printf("rec pointer: %p\n", rec);
-    
     // Store header info safely
     record.rec_type = rec->header.REC_TYP;
     record.rec_subtype = rec->header.REC_SUB;
@@ -242,16 +1155,9 @@ STDFRecord STDFParser::parse_ptr_record(void* ptr_rec) {
             // Official libstdf approach: cast rec_unknown* to rec_ptr*
             rec_ptr* ptr = (rec_ptr*)rec;
             
-            static int debug_count = 0;
-            if (debug_count < 2) {
-                printf("\n=== PTR Proper Extraction #%d ===\n", debug_count + 1);
-                printf("Using official libstdf casting approach\n");
-                debug_count++;
-            }
-            
             // Extract all PTR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(ptr, dynamic_record);
+            field_extractor().extract_fields(ptr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -259,87 +1165,9 @@ STDFRecord STDFParser::parse_ptr_record(void* ptr_rec) {
             }
             
             // Note: test_num, head_num, site_num, result now handled by .def files
-            // Removed duplicate assignments to avoid field conflicts
-          
         }
     } catch (...) {
         // If casting fails, continue with basic approach
-        printf("PTR casting failed, using basic approach\n");
-    }
-    
-    if (false) {  // Disable old approach
-        uint8_t* raw_data = static_cast<uint8_t*>(rec->data);
-        
-        static int debug_count = 0;
-        if (debug_count < 2) {  // Only debug first 2 PTR records
-            printf("\n=== PTR Debug #%d ===\n", debug_count + 1);
-            printf("Length: %d bytes\n", rec->header.REC_LEN);
-            printf("Data pointer: %p\n", rec->data);
-            
-            // HYPOTHESIS: Maybe rec->data doesn't point to the actual record data
-            // Let's try a different approach based on libstdf documentation
-            printf("Record state: %d\n", rec->header.state);
-            printf("Investigating data structure...\n");
-            
-            // Maybe we need to cast the entire rec_unknown to rec_ptr?
-            // But we know this is dangerous - let's just skip memory access for now
-            printf("SKIPPING direct memory access for safety\n");
-            
-            // Try to interpret the bytes according to STDF PTR spec:
-            // TEST_NUM (U4) - 4 bytes
-            // HEAD_NUM (U1) - 1 byte  
-            // SITE_NUM (U1) - 1 byte
-            // TEST_FLG (B1) - 1 byte ← TARGET!
-            // PARM_FLG (B1) - 1 byte
-            // RESULT (R4) - 4 bytes
-            
-            if (rec->header.REC_LEN >= 8) {
-                uint32_t test_num = *reinterpret_cast<uint32_t*>(raw_data + 0);
-                uint8_t head_num = raw_data[4];
-                uint8_t site_num = raw_data[5]; 
-                uint8_t test_flg = raw_data[6];  // ← This is what we want!
-                uint8_t parm_flg = raw_data[7];
-                
-                printf("Fields: TEST_NUM=%u HEAD=%d SITE=%d TEST_FLG=%d PARM_FLG=%d\n", 
-                       test_num, head_num, site_num, test_flg, parm_flg);
-                
-                if (rec->header.REC_LEN >= 12) {
-                    float result = *reinterpret_cast<float*>(raw_data + 8);
-                    printf("RESULT=%.6f\n", result);
-                }
-            }
-            debug_count++;
-        }
-        
-        // If debugging looks correct, extract the fields for real
-        if (rec->header.REC_LEN >= 8) {
-            try {
-                uint32_t test_num = *reinterpret_cast<uint32_t*>(raw_data + 0);
-                uint8_t head_num = raw_data[4];
-                uint8_t site_num = raw_data[5];
-                uint8_t test_flg = raw_data[6];  // ← The field you want!
-                uint8_t parm_flg = raw_data[7];
-                
-                // Store in fields map
-                record.fields["test_num"] = std::to_string(test_num);
-                record.fields["head_num"] = std::to_string(head_num); 
-                record.fields["site_num"] = std::to_string(site_num);
-                record.fields["test_flg"] = std::to_string(test_flg);
-                record.fields["parm_flg"] = std::to_string(parm_flg);
-                
-                // Store in record structure
-                // Note: test_num, head_num, site_num now handled by .def files
-                
-                if (rec->header.REC_LEN >= 12) {
-                    float result = *reinterpret_cast<float*>(raw_data + 8);
-                    record.fields["result"] = std::to_string(result);
-                    // Note: result now handled by .def files
-                }
-                
-            } catch (...) {
-                // If parsing fails, just use basic info
-            }
-        }
     }
     
     return record;
@@ -367,7 +1195,7 @@ STDFRecord STDFParser::parse_mpr_record(void* mpr_rec) {
             
             // Extract ALL MPR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(mpr, dynamic_record);
+            field_extractor().extract_fields(mpr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -418,7 +1246,7 @@ STDFRecord STDFParser::parse_ftr_record(void* ftr_rec) {
             
             // Extract ALL FTR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(ftr, dynamic_record);
+            field_extractor().extract_fields(ftr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -482,7 +1310,7 @@ STDFRecord STDFParser::parse_hbr_record(void* hbr_rec) {
             
             // Extract ALL HBR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(hbr, dynamic_record);
+            field_extractor().extract_fields(hbr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -523,7 +1351,7 @@ STDFRecord STDFParser::parse_sbr_record(void* sbr_rec) {
             
             // Extract ALL SBR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(sbr, dynamic_record);
+            field_extractor().extract_fields(sbr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -550,15 +1378,15 @@ STDFRecord STDFParser::parse_mir_record(void* mir_rec) {
     
     // Store MIR context for other records
     if (mir->LOT_ID) {
-        mir_lot_id_ = std::string(mir->LOT_ID);
+        mir_lot_id_ = cn_to_string(mir->LOT_ID);
         record.fields["LOT_ID"] = mir_lot_id_;
     }
     if (mir->PART_TYP) {
-        mir_part_typ_ = std::string(mir->PART_TYP);
+        mir_part_typ_ = cn_to_string(mir->PART_TYP);
         record.fields["PART_TYP"] = mir_part_typ_;
     }
     if (mir->JOB_NAM) {
-        mir_job_nam_ = std::string(mir->JOB_NAM);
+        mir_job_nam_ = cn_to_string(mir->JOB_NAM);
         record.fields["JOB_NAM"] = mir_job_nam_;
     }
     
@@ -577,16 +1405,16 @@ STDFRecord STDFParser::parse_mir_record(void* mir_rec) {
     }
     
     if (mir->NODE_NAM) {
-        record.fields["NODE_NAM"] = std::string(mir->NODE_NAM);
+        record.fields["NODE_NAM"] = cn_to_string(mir->NODE_NAM);
     }
     if (mir->TSTR_TYP) {
-        record.fields["TSTR_TYP"] = std::string(mir->TSTR_TYP);
+        record.fields["TSTR_TYP"] = cn_to_string(mir->TSTR_TYP);
     }
     if (mir->EXEC_TYP) {
-        record.fields["EXEC_TYP"] = std::string(mir->EXEC_TYP);
+        record.fields["EXEC_TYP"] = cn_to_string(mir->EXEC_TYP);
     }
     if (mir->EXEC_VER) {
-        record.fields["EXEC_VER"] = std::string(mir->EXEC_VER);
+        record.fields["EXEC_VER"] = cn_to_string(mir->EXEC_VER);
     }
     
     return record;
@@ -614,7 +1442,7 @@ STDFRecord STDFParser::parse_prr_record(void* prr_rec) {
             
             // Extract ALL PRR fields using global shared extractor
             DynamicSTDFRecord dynamic_record;
-            g_field_extractor.extract_fields(prr, dynamic_record);
+            field_extractor().extract_fields(prr, dynamic_record);
             
             // Copy ALL extracted fields from X-Macros to main record
             for (const auto& field : dynamic_record.fields) {
@@ -651,7 +1479,7 @@ STDFRecord STDFParser::parse_record_safe(void* raw_record, STDFRecordType type)
     record.type = type;
     
     if (!raw_record) {
-        std::cerr << "Warning: NULL record pointer" << std::endl;
+        ConsoleLog::err() << "Warning: NULL record pointer" << std::endl;
         return record;
     }
     
@@ -670,7 +1498,7 @@ STDFRecord STDFParser::parse_record_safe(void* raw_record, STDFRecordType type)
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "Exception in parse_record_safe: " << e.what() << std::endl;
+        ConsoleLog::err() << "Exception in parse_record_safe: " << e.what() << std::endl;
         record.fields["ERROR"] = e.what();
     }
     
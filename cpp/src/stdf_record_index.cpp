@@ -0,0 +1,282 @@
+#include "../include/stdf_record_index.h"
+#include "../include/mapped_file.h"
+#include <libstdf.h>
+#include <fstream>
+#include <filesystem>
+#include <map>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+static_assert(sizeof(STDFIndexEntry) == 16, "STDFIndexEntry layout is part of the sidecar format");
+
+// Sidecar layout: header followed by the raw STDFIndexEntry array
+static const char INDEX_MAGIC[8] = {'S', 'T', 'D', 'F', 'I', 'D', 'X', '1'};
+static const uint32_t INDEX_VERSION = 1;
+static const uint32_t INDEX_BYTE_ORDER = 0x01020304;  // Rejects sidecars from other-endian hosts
+
+#pragma pack(push, 1)
+struct IndexFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t entry_size;
+    uint32_t reserved;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t entry_count;
+};
+#pragma pack(pop)
+
+STDFRecordIndex::STDFRecordIndex()
+    : source_size_(0)
+    , source_mtime_(0) {
+}
+
+bool STDFRecordIndex::source_stamp(const std::string& filepath, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = fs::file_size(filepath, ec);
+    if (ec) return false;
+    auto write_time = fs::last_write_time(filepath, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+std::string STDFRecordIndex::sidecar_path(const std::string& filepath, const std::string& cache_dir) {
+    if (cache_dir.empty()) {
+        return filepath + ".idx";
+    }
+    return (fs::path(cache_dir) / (fs::path(filepath).filename().string() + ".idx")).string();
+}
+
+bool STDFRecordIndex::build(const std::string& filepath) {
+    entries_.clear();
+    parts_.clear();
+    last_error_.clear();
+
+    if (!source_stamp(filepath, source_size_, source_mtime_)) {
+        last_error_ = "Cannot stat " + filepath;
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(filepath)) {
+        last_error_ = file.get_last_error();
+        return false;
+    }
+
+    const uint8_t* data = file.data();
+    const size_t size = file.size();
+
+    // Byte order from FAR CPU_TYPE (1 = big-endian, 2 = little-endian)
+    bool big_endian = false;
+    if (size >= 6 && data[2] == 0 && data[3] == 10) {
+        big_endian = (data[4] == 1);
+    } else {
+        last_error_ = "File does not start with a FAR record: " + filepath;
+        return false;
+    }
+
+    entries_.reserve(size / 32);
+
+    size_t position = 0;
+    while (position + 4 <= size) {
+        STDFIndexEntry entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.offset = position;
+        entry.length = big_endian ? static_cast<uint16_t>((data[position] << 8) | data[position + 1])
+                                  : static_cast<uint16_t>(data[position] | (data[position + 1] << 8));
+        entry.rec_type = data[position + 2];
+        entry.rec_subtype = data[position + 3];
+
+        const uint8_t* payload = data + position + 4;
+        if (position + 4 + entry.length > size) {
+            last_error_ = "Truncated record at offset " + std::to_string(position);
+            break;
+        }
+
+        // HEAD_NUM/SITE_NUM position for the per-part record types
+        int head_offset = -1;
+        if (entry.rec_type == REC_TYP_PER_PART &&
+            (entry.rec_subtype == REC_SUB_PIR || entry.rec_subtype == REC_SUB_PRR)) {
+            head_offset = 0;
+        } else if (entry.rec_type == REC_TYP_PER_EXEC &&
+                   (entry.rec_subtype == REC_SUB_PTR || entry.rec_subtype == REC_SUB_MPR ||
+                    entry.rec_subtype == REC_SUB_FTR)) {
+            head_offset = 4;  // after TEST_NUM (U4)
+        }
+        if (head_offset >= 0 && entry.length >= head_offset + 2) {
+            entry.head_num = payload[head_offset];
+            entry.site_num = payload[head_offset + 1];
+        }
+
+        entries_.push_back(entry);
+        position += 4 + entry.length;
+    }
+
+    build_parts();
+    return true;
+}
+
+void STDFRecordIndex::build_parts() {
+    parts_.clear();
+
+    // Open PIR per head/site; a PRR closes the bracket of its own site
+    std::map<std::pair<uint8_t, uint8_t>, uint32_t> open_parts;
+    uint32_t last_prr = 0;
+
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const STDFIndexEntry& e = entries_[i];
+        if (e.rec_type != REC_TYP_PER_PART) continue;
+
+        uint32_t record_index = static_cast<uint32_t>(i + 1);
+        auto key = std::make_pair(e.head_num, e.site_num);
+
+        if (e.rec_subtype == REC_SUB_PIR) {
+            open_parts[key] = record_index;
+        } else if (e.rec_subtype == REC_SUB_PRR) {
+            STDFPartSpan span;
+            auto it = open_parts.find(key);
+            if (it != open_parts.end()) {
+                span.first_record = it->second;
+                open_parts.erase(it);
+            } else {
+                span.first_record = last_prr + 1;  // No PIR: start after the previous part
+            }
+            span.prr_record = record_index;
+            span.head_num = e.head_num;
+            span.site_num = e.site_num;
+            parts_.push_back(span);
+            last_prr = record_index;
+        }
+    }
+}
+
+bool STDFRecordIndex::save(const std::string& index_path) const {
+    std::error_code ec;
+    fs::path target(index_path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path(), ec);
+    }
+
+    // Write to a temporary name and rename so readers never see a torn file
+    std::string tmp_path = index_path + ".tmp";
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        last_error_ = "Cannot write index " + tmp_path;
+        return false;
+    }
+
+    IndexFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.byte_order = INDEX_BYTE_ORDER;
+    header.entry_size = sizeof(STDFIndexEntry);
+    header.source_size = source_size_;
+    header.source_mtime = source_mtime_;
+    header.entry_count = entries_.size();
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries_.data()),
+              static_cast<std::streamsize>(entries_.size() * sizeof(STDFIndexEntry)));
+    out.close();
+
+    if (!out) {
+        last_error_ = "Failed writing index " + tmp_path;
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+
+    fs::rename(tmp_path, index_path, ec);
+    if (ec) {
+        last_error_ = "Cannot rename index into place: " + ec.message();
+        fs::remove(tmp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool STDFRecordIndex::load(const std::string& index_path, const std::string& filepath) {
+    entries_.clear();
+    parts_.clear();
+    last_error_.clear();
+
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!source_stamp(filepath, size, mtime)) {
+        last_error_ = "Cannot stat " + filepath;
+        return false;
+    }
+
+    std::ifstream in(index_path, std::ios::binary);
+    if (!in) {
+        last_error_ = "No index at " + index_path;
+        return false;
+    }
+
+    IndexFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 ||
+        header.version != INDEX_VERSION ||
+        header.byte_order != INDEX_BYTE_ORDER ||
+        header.entry_size != sizeof(STDFIndexEntry)) {
+        last_error_ = "Unrecognized index format: " + index_path;
+        return false;
+    }
+
+    if (header.source_size != size || header.source_mtime != mtime) {
+        last_error_ = "Index is stale for " + filepath;
+        return false;
+    }
+
+    // The count is only trusted once the file holds exactly that many
+    // entries; a damaged count is handled like a stale index
+    std::error_code ec;
+    const uint64_t index_size = fs::file_size(index_path, ec);
+    if (ec || index_size < sizeof(header) ||
+        (index_size - sizeof(header)) / sizeof(STDFIndexEntry) != header.entry_count ||
+        (index_size - sizeof(header)) % sizeof(STDFIndexEntry) != 0) {
+        last_error_ = "Index size does not match its entry count: " + index_path;
+        return false;
+    }
+
+    entries_.resize(header.entry_count);
+    if (!in.read(reinterpret_cast<char*>(entries_.data()),
+                 static_cast<std::streamsize>(entries_.size() * sizeof(STDFIndexEntry)))) {
+        entries_.clear();
+        last_error_ = "Truncated index: " + index_path;
+        return false;
+    }
+
+    source_size_ = size;
+    source_mtime_ = mtime;
+    build_parts();
+    return true;
+}
+
+bool STDFRecordIndex::load_or_build(const std::string& filepath, const std::string& cache_dir) {
+    std::string index_path = sidecar_path(filepath, cache_dir);
+    if (load(index_path, filepath)) {
+        return true;
+    }
+
+    if (!build(filepath)) {
+        return false;
+    }
+
+    // An unwritable sidecar location is not fatal; the in-memory index is valid
+    save(index_path);
+    return true;
+}
+
+std::vector<uint32_t> STDFRecordIndex::find_records(uint8_t rec_type, uint8_t rec_subtype) const {
+    std::vector<uint32_t> matches;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].rec_type == rec_type && entries_[i].rec_subtype == rec_subtype) {
+            matches.push_back(static_cast<uint32_t>(i + 1));
+        }
+    }
+    return matches;
+}
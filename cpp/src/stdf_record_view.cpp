@@ -0,0 +1,351 @@
+#include "../include/stdf_record_view.h"
+#include "../include/dynamic_field_extractor.h"
+#include "../include/byte_order.h"
+#include <libstdf.h>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+using K = STDFFieldKind;
+
+// On-disk layouts (STDF V4 spec order); PTR and PRR come from their
+// cpp/field_defs/*_layout.def
+const STDFFieldSpec MIR_SCHEMA[] = {
+    {"SETUP_T", K::U4, -1}, {"START_T", K::U4, -1}, {"STAT_NUM", K::U1, -1}, {"MODE_COD", K::C1, -1},
+    {"RTST_COD", K::C1, -1}, {"PROT_COD", K::C1, -1}, {"BURN_TIM", K::U2, -1}, {"CMOD_COD", K::C1, -1},
+    {"LOT_ID", K::CN, -1}, {"PART_TYP", K::CN, -1}, {"NODE_NAM", K::CN, -1}, {"TSTR_TYP", K::CN, -1},
+    {"JOB_NAM", K::CN, -1}, {"JOB_REV", K::CN, -1}, {"SBLOT_ID", K::CN, -1}, {"OPER_NAM", K::CN, -1},
+    {"EXEC_TYP", K::CN, -1}, {"EXEC_VER", K::CN, -1}, {"TEST_COD", K::CN, -1}, {"TST_TEMP", K::CN, -1},
+    {"USER_TXT", K::CN, -1}, {"AUX_FILE", K::CN, -1}, {"PKG_TYP", K::CN, -1}, {"FAMLY_ID", K::CN, -1},
+    {"DATE_COD", K::CN, -1}, {"FACIL_ID", K::CN, -1}, {"FLOOR_ID", K::CN, -1}, {"PROC_ID", K::CN, -1},
+    {"OPER_FRQ", K::CN, -1}, {"SPEC_NAM", K::CN, -1}, {"SPEC_VER", K::CN, -1}, {"FLOW_ID", K::CN, -1},
+    {"SETUP_ID", K::CN, -1}, {"DSGN_REV", K::CN, -1}, {"ENG_ID", K::CN, -1}, {"ROM_COD", K::CN, -1},
+    {"SERL_NUM", K::CN, -1}, {"SUPR_NAM", K::CN, -1}
+};
+
+const STDFFieldSpec PIR_SCHEMA[] = {
+    {"HEAD_NUM", K::U1, -1}, {"SITE_NUM", K::U1, -1}
+};
+
+const STDFFieldSpec PRR_SCHEMA[] = {
+    #define LAYOUT(name, member, type) {name, K::type, -1},
+    #include "../field_defs/prr_layout.def"
+    #undef LAYOUT
+};
+
+const STDFFieldSpec PTR_SCHEMA[] = {
+    #define LAYOUT(name, member, type) {name, K::type, -1},
+    #include "../field_defs/ptr_layout.def"
+    #undef LAYOUT
+};
+
+const STDFFieldSpec MPR_SCHEMA[] = {
+    {"TEST_NUM", K::U4, -1}, {"HEAD_NUM", K::U1, -1}, {"SITE_NUM", K::U1, -1}, {"TEST_FLG", K::B1, -1},
+    {"PARM_FLG", K::B1, -1}, {"RTN_ICNT", K::U2, -1}, {"RSLT_CNT", K::U2, -1}, {"RTN_STAT", K::XN1, 5},
+    {"RTN_RSLT", K::XR4, 6}, {"TEST_TXT", K::CN, -1}, {"ALARM_ID", K::CN, -1}, {"OPT_FLAG", K::B1, -1},
+    {"RES_SCAL", K::I1, -1}, {"LLM_SCAL", K::I1, -1}, {"HLM_SCAL", K::I1, -1}, {"LO_LIMIT", K::R4, -1},
+    {"HI_LIMIT", K::R4, -1}, {"START_IN", K::R4, -1}, {"INCR_IN", K::R4, -1}, {"RTN_INDX", K::XU2, 5},
+    {"UNITS", K::CN, -1}, {"UNITS_IN", K::CN, -1}, {"C_RESFMT", K::CN, -1}, {"C_LLMFMT", K::CN, -1},
+    {"C_HLMFMT", K::CN, -1}, {"LO_SPEC", K::R4, -1}, {"HI_SPEC", K::R4, -1}
+};
+
+const STDFFieldSpec FTR_SCHEMA[] = {
+    {"TEST_NUM", K::U4, -1}, {"HEAD_NUM", K::U1, -1}, {"SITE_NUM", K::U1, -1}, {"TEST_FLG", K::B1, -1},
+    {"OPT_FLAG", K::B1, -1}, {"CYCL_CNT", K::U4, -1}, {"REL_VADR", K::U4, -1}, {"REPT_CNT", K::U4, -1},
+    {"NUM_FAIL", K::U4, -1}, {"XFAIL_AD", K::I4, -1}, {"YFAIL_AD", K::I4, -1}, {"VECT_OFF", K::I2, -1},
+    {"RTN_ICNT", K::U2, -1}, {"PGM_ICNT", K::U2, -1}, {"RTN_INDX", K::XU2, 12}, {"RTN_STAT", K::XN1, 12},
+    {"PGM_INDX", K::XU2, 13}, {"PGM_STAT", K::XN1, 13}, {"FAIL_PIN", K::DN, -1}, {"VECT_NAM", K::CN, -1},
+    {"TIME_SET", K::CN, -1}, {"OP_CODE", K::CN, -1}, {"TEST_TXT", K::CN, -1}, {"ALARM_ID", K::CN, -1},
+    {"PROG_TXT", K::CN, -1}, {"RSLT_TXT", K::CN, -1}, {"PATG_NUM", K::U1, -1}, {"SPIN_MAP", K::DN, -1}
+};
+
+const STDFFieldSpec HBR_SCHEMA[] = {
+    {"HEAD_NUM", K::U1, -1}, {"SITE_NUM", K::U1, -1}, {"HBIN_NUM", K::U2, -1}, {"HBIN_CNT", K::U4, -1},
+    {"HBIN_PF", K::C1, -1}, {"HBIN_NAM", K::CN, -1}
+};
+
+const STDFFieldSpec SBR_SCHEMA[] = {
+    {"HEAD_NUM", K::U1, -1}, {"SITE_NUM", K::U1, -1}, {"SBIN_NUM", K::U2, -1}, {"SBIN_CNT", K::U4, -1},
+    {"SBIN_PF", K::C1, -1}, {"SBIN_NAM", K::CN, -1}
+};
+
+template<size_t N>
+void select_schema(const STDFFieldSpec (&schema)[N], const STDFFieldSpec*& out, size_t& size) {
+    static_assert(N <= STDFRecordView::MAX_FIELDS, "raise STDFRecordView::MAX_FIELDS");
+    out = schema;
+    size = N;
+}
+
+const std::string EMPTY_TEXT;
+
+}  // namespace
+
+void STDFRecordView::reset(uint8_t rec_type, uint8_t rec_subtype, const uint8_t* body, uint16_t length,
+                           bool swap_bytes, uint32_t record_index) {
+    rec_type_ = rec_type;
+    rec_subtype_ = rec_subtype;
+    data_ = body;
+    length_ = length;
+    swap_bytes_ = swap_bytes;
+    record_index_ = record_index;
+    resolved_ = 0;
+    offsets_[0] = 0;
+    text_cache_.clear();
+
+    schema_ = nullptr;
+    schema_size_ = 0;
+    type_ = STDFRecordType::UNKNOWN;
+    switch ((static_cast<unsigned>(rec_type) << 8) | rec_subtype) {
+        case (REC_TYP_PER_LOT << 8) | REC_SUB_MIR:
+            select_schema(MIR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::MIR; break;
+        case (REC_TYP_PER_PART << 8) | REC_SUB_PIR:
+            select_schema(PIR_SCHEMA, schema_, schema_size_); break;
+        case (REC_TYP_PER_PART << 8) | REC_SUB_PRR:
+            select_schema(PRR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::PRR; break;
+        case (REC_TYP_PER_EXEC << 8) | REC_SUB_PTR:
+            select_schema(PTR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::PTR; break;
+        case (REC_TYP_PER_EXEC << 8) | REC_SUB_MPR:
+            select_schema(MPR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::MPR; break;
+        case (REC_TYP_PER_EXEC << 8) | REC_SUB_FTR:
+            select_schema(FTR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::FTR; break;
+        case (REC_TYP_PER_LOT << 8) | REC_SUB_HBR:
+            select_schema(HBR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::HBR; break;
+        case (REC_TYP_PER_LOT << 8) | REC_SUB_SBR:
+            select_schema(SBR_SCHEMA, schema_, schema_size_); type_ = STDFRecordType::SBR; break;
+        default: break;
+    }
+}
+
+int STDFRecordView::field_index(std::string_view name) const {
+    for (size_t index = 0; index < schema_size_; ++index) {
+        if (name == schema_[index].name) {
+            return static_cast<int>(index);
+        }
+    }
+    return -1;
+}
+
+uint16_t STDFRecordView::load_u2(size_t offset) const {
+    if (offset + 2 > length_) return 0;
+    uint16_t value;
+    std::memcpy(&value, data_ + offset, 2);
+    return swap_bytes_ ? byte_swap16(value) : value;
+}
+
+uint32_t STDFRecordView::load_u4(size_t offset) const {
+    if (offset + 4 > length_) return 0;
+    uint32_t value;
+    std::memcpy(&value, data_ + offset, 4);
+    return swap_bytes_ ? byte_swap32(value) : value;
+}
+
+// Bytes the field occupies at offset; needs the count fields before it, which
+// field_offset() has resolved by the time it gets here
+size_t STDFRecordView::field_size(size_t index, size_t offset) {
+    const STDFFieldSpec& spec = schema_[index];
+    size_t count = spec.count_field >= 0 ? unsigned_at(static_cast<size_t>(spec.count_field)) : 0;
+    switch (spec.kind) {
+        case K::U1: case K::I1: case K::B1: case K::C1: return 1;
+        case K::U2: case K::I2: return 2;
+        case K::U4: case K::I4: case K::R4: return 4;
+        case K::CN: case K::BN: return offset < length_ ? 1 + data_[offset] : 0;
+        case K::DN: {
+            uint16_t bits = load_u2(offset);
+            return 2 + bits / 8 + (bits % 8 ? 1 : 0);
+        }
+        case K::XN1: return count / 2 + count % 2;
+        case K::XU2: return 2 * count;
+        case K::XR4: return 4 * count;
+    }
+    return 0;
+}
+
+size_t STDFRecordView::field_offset(size_t index) {
+    while (resolved_ < index) {
+        size_t next = offsets_[resolved_] + field_size(resolved_, offsets_[resolved_]);
+        offsets_[resolved_ + 1] = static_cast<uint16_t>(next < length_ ? next : length_);
+        resolved_++;
+    }
+    return offsets_[index];
+}
+
+uint32_t STDFRecordView::unsigned_at(size_t index) {
+    size_t offset = field_offset(index);
+    switch (schema_[index].kind) {
+        case K::U1: case K::B1: return offset < length_ ? data_[offset] : 0;
+        case K::U2: return load_u2(offset);
+        case K::U4: return load_u4(offset);
+        default: return 0;
+    }
+}
+
+int32_t STDFRecordView::signed_at(size_t index) {
+    size_t offset = field_offset(index);
+    switch (schema_[index].kind) {
+        case K::I1: return offset < length_ ? static_cast<int8_t>(data_[offset]) : 0;
+        case K::I2: return static_cast<int16_t>(load_u2(offset));
+        case K::I4: return static_cast<int32_t>(load_u4(offset));
+        default: return 0;
+    }
+}
+
+float STDFRecordView::float_at(size_t index) {
+    if (schema_[index].kind != K::R4) return 0.0f;
+    uint32_t bits = load_u4(field_offset(index));
+    float value;
+    std::memcpy(&value, &bits, 4);
+    return value;
+}
+
+uint32_t STDFRecordView::get_unsigned(std::string_view name) {
+    int index = field_index(name);
+    return index < 0 ? 0 : unsigned_at(static_cast<size_t>(index));
+}
+
+int32_t STDFRecordView::get_signed(std::string_view name) {
+    int index = field_index(name);
+    return index < 0 ? 0 : signed_at(static_cast<size_t>(index));
+}
+
+float STDFRecordView::get_float(std::string_view name) {
+    int index = field_index(name);
+    return index < 0 ? 0.0f : float_at(static_cast<size_t>(index));
+}
+
+char STDFRecordView::get_char(std::string_view name) {
+    int index = field_index(name);
+    if (index < 0 || schema_[index].kind != K::C1) return ' ';
+    size_t offset = field_offset(static_cast<size_t>(index));
+    return offset < length_ ? static_cast<char>(data_[offset]) : ' ';  // libstdf default for C1
+}
+
+std::string_view STDFRecordView::get_string(std::string_view name) {
+    int index = field_index(name);
+    if (index < 0 || schema_[index].kind != K::CN) return {};
+    size_t offset = field_offset(static_cast<size_t>(index));
+    if (offset >= length_) return {};
+    // A corrupt length byte keeps only the bytes the record has
+    size_t size = std::min<size_t>(data_[offset], length_ - offset - 1);
+    return std::string_view(reinterpret_cast<const char*>(data_ + offset + 1), size);
+}
+
+size_t STDFRecordView::get_floats(std::string_view name, std::vector<float>& values) {
+    values.clear();
+    int index = field_index(name);
+    if (index < 0 || schema_[index].kind != K::XR4) return 0;
+    size_t count = unsigned_at(static_cast<size_t>(schema_[index].count_field));
+    size_t offset = field_offset(static_cast<size_t>(index));
+    values.resize(count);
+    if (count > 0 && offset + 4 * count <= length_) {
+        if (swap_bytes_) {
+            byte_swap_copy32(values.data(), data_ + offset, count);
+        } else {
+            std::memcpy(values.data(), data_ + offset, 4 * count);
+        }
+        return count;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t bits = load_u4(offset + 4 * i);
+        std::memcpy(&values[i], &bits, 4);
+    }
+    return count;
+}
+
+size_t STDFRecordView::get_u2s(std::string_view name, std::vector<uint16_t>& values) {
+    values.clear();
+    int index = field_index(name);
+    if (index < 0 || schema_[index].kind != K::XU2) return 0;
+    size_t count = unsigned_at(static_cast<size_t>(schema_[index].count_field));
+    size_t offset = field_offset(static_cast<size_t>(index));
+    values.resize(count);
+    if (count > 0 && offset + 2 * count <= length_) {
+        if (swap_bytes_) {
+            byte_swap_copy16(values.data(), data_ + offset, count);
+        } else {
+            std::memcpy(values.data(), data_ + offset, 2 * count);
+        }
+        return count;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = load_u2(offset + 2 * i);
+    }
+    return count;
+}
+
+STDFBitsView STDFRecordView::get_bits(std::string_view name) {
+    STDFBitsView bits;
+    int index = field_index(name);
+    if (index < 0) return bits;
+    const K kind = schema_[index].kind;
+    size_t offset = field_offset(static_cast<size_t>(index));
+    if (kind == K::DN && offset + 2 <= length_) {
+        bits.bytes = data_ + offset + 2;
+        bits.bit_count = std::min<size_t>(load_u2(offset), 8 * (length_ - offset - 2));
+    } else if (kind == K::BN && offset < length_) {
+        bits.bytes = data_ + offset + 1;
+        bits.bit_count = 8 * std::min<size_t>(data_[offset], length_ - offset - 1);
+    }
+    return bits;
+}
+
+STDFNibblesView STDFRecordView::get_nibbles(std::string_view name) {
+    STDFNibblesView nibbles;
+    int index = field_index(name);
+    if (index < 0 || schema_[index].kind != K::XN1) return nibbles;
+    size_t count = unsigned_at(static_cast<size_t>(schema_[index].count_field));
+    size_t offset = field_offset(static_cast<size_t>(index));
+    nibbles.bytes = data_ + offset;
+    nibbles.count = std::min<size_t>(count, 2 * (length_ - offset));
+    return nibbles;
+}
+
+// Same conversions as DynamicFieldExtractor's field_to_string
+std::string STDFRecordView::field_text(size_t index) {
+    const STDFFieldSpec& spec = schema_[index];
+    switch (spec.kind) {
+        case K::U1: case K::U2: case K::U4: case K::B1: return std::to_string(unsigned_at(index));
+        case K::I1: case K::I2: case K::I4: return std::to_string(signed_at(index));
+        case K::R4: return std::to_string(float_at(index));
+        case K::C1: {
+            char value = get_char(spec.name);
+            return value ? std::string(1, value) : std::string();
+        }
+        case K::CN: return std::string(get_string(spec.name));
+        case K::BN: case K::DN: case K::XN1: return "present";
+        case K::XU2: {
+            size_t count = unsigned_at(static_cast<size_t>(spec.count_field));
+            size_t offset = field_offset(index);
+            std::string joined;
+            for (size_t i = 0; i < count; ++i) {
+                if (i > 0) joined.push_back(',');
+                joined += std::to_string(load_u2(offset + 2 * i));
+            }
+            return joined;
+        }
+        case K::XR4: {
+            std::vector<float> values;
+            get_floats(spec.name, values);
+            return join_r4_array(values.data(), static_cast<uint16_t>(values.size()));
+        }
+    }
+    return std::string();
+}
+
+const std::string& STDFRecordView::get_field(std::string_view name) {
+    int index = field_index(name);
+    if (index < 0) {
+        return EMPTY_TEXT;
+    }
+    for (const auto& cached : text_cache_) {
+        if (cached.first == static_cast<size_t>(index)) {
+            return cached.second;
+        }
+    }
+    // Capacity for every field up front, so returned references stay valid
+    if (text_cache_.capacity() < MAX_FIELDS) {
+        text_cache_.reserve(MAX_FIELDS);
+    }
+    text_cache_.emplace_back(static_cast<size_t>(index), field_text(static_cast<size_t>(index)));
+    return text_cache_.back().second;
+}
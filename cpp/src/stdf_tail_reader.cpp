@@ -0,0 +1,123 @@
+#include "../include/stdf_tail_reader.h"
+#include "../include/decompressing_reader.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+STDFTailReader::STDFTailReader()
+    : offset_(0)
+    , record_count_(0)
+    , last_poll_records_(0)
+    , pending_bytes_(0)
+    , big_endian_(false)
+    , complete_(false) {
+}
+
+bool STDFTailReader::open(const std::string& filepath) {
+    filepath_ = filepath;
+    offset_ = 0;
+    record_count_ = 0;
+    last_poll_records_ = 0;
+    pending_bytes_ = 0;
+    big_endian_ = false;
+    complete_ = false;
+    last_error_.clear();
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        last_error_ = "Cannot open " + filepath;
+        return false;
+    }
+    if (detect_compression(filepath) != STDFCompression::NONE) {
+        last_error_ = filepath + " is compressed; only uncompressed files can be followed";
+        return false;
+    }
+    return true;
+}
+
+bool STDFTailReader::whole_records(size_t size, size_t& bytes, uint32_t& count) {
+    const uint8_t* data = buffer_.data();
+    size_t at = 0;
+    count = 0;
+    while (at + sizeof(STDFHeader) <= size) {
+        const uint8_t* header = data + at;
+        if (record_count_ == 0 && at == 0) {
+            // FAR: REC_LEN=2, REC_TYP=0, REC_SUB=10, CPU_TYPE, STDF_VER
+            if (header[2] != 0 || header[3] != 10) {
+                last_error_ = filepath_ + " does not start with a FAR record";
+                return false;
+            }
+            if (size < 6) {
+                break;
+            }
+            big_endian_ = header[4] == 1;
+        }
+        const size_t length = big_endian_ ? static_cast<size_t>((header[0] << 8) | header[1])
+                                          : static_cast<size_t>(header[0] | (header[1] << 8));
+        if (at + sizeof(STDFHeader) + length > size) {
+            break;
+        }
+        if (header[2] == REC_TYP_PER_LOT && header[3] == REC_SUB_MRR) {
+            complete_ = true;
+        }
+        at += sizeof(STDFHeader) + length;
+        ++count;
+    }
+    bytes = at;
+    return true;
+}
+
+bool STDFTailReader::poll(STDFColumnarStore& store) {
+    last_poll_records_ = 0;
+    if (filepath_.empty()) {
+        last_error_ = "No file opened";
+        return false;
+    }
+
+    std::ifstream file(filepath_, std::ios::binary | std::ios::ate);
+    if (!file) {
+        last_error_ = "Cannot open " + filepath_;
+        return false;
+    }
+    const uint64_t size = static_cast<uint64_t>(file.tellg());
+    if (size < offset_) {
+        last_error_ = filepath_ + " shrank below the " + std::to_string(offset_) + " bytes already read";
+        return false;
+    }
+    file.seekg(static_cast<std::streamoff>(offset_));
+
+    // The unfinished record at the end of one chunk moves to the front of
+    // the next; it is never longer than a record, far less than a chunk
+    uint64_t position = offset_;
+    size_t carried = 0;
+    while (position < size) {
+        const size_t wanted = static_cast<size_t>(std::min<uint64_t>(READ_CHUNK, size - position));
+        buffer_.resize(carried + wanted);
+        file.read(reinterpret_cast<char*>(buffer_.data() + carried), static_cast<std::streamsize>(wanted));
+        if (static_cast<size_t>(file.gcount()) != wanted) {
+            last_error_ = "Short read from " + filepath_;
+            return false;
+        }
+        position += wanted;
+
+        const size_t available = carried + wanted;
+        size_t whole = 0;
+        uint32_t count = 0;
+        if (!whole_records(available, whole, count)) {
+            return false;
+        }
+        if (count > 0) {
+            // The first buffer starts with the FAR, so it sets the byte order
+            parser_.attach_buffer(buffer_.data(), whole, filepath_, record_count_ + 1);
+            parser_.parse_all_to_columns(store);
+            record_count_ += count;
+            offset_ += whole;
+            last_poll_records_ += count;
+        }
+        carried = available - whole;
+        std::memmove(buffer_.data(), buffer_.data() + whole, carried);
+    }
+
+    pending_bytes_ = size - offset_;
+    return true;
+}
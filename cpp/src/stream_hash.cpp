@@ -0,0 +1,139 @@
+#include "../include/stream_hash.h"
+#include <cstring>
+
+static const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+static const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian loads regardless of host byte order
+static inline uint64_t read_le64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+static inline uint32_t read_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input) {
+    acc += input * PRIME64_2;
+    acc = rotl(acc, 31);
+    return acc * PRIME64_1;
+}
+
+static inline uint64_t merge_round(uint64_t acc, uint64_t lane) {
+    acc ^= xxh_round(0, lane);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+static inline void consume_stripe(uint64_t lanes[4], const uint8_t* p) {
+    lanes[0] = xxh_round(lanes[0], read_le64(p));
+    lanes[1] = xxh_round(lanes[1], read_le64(p + 8));
+    lanes[2] = xxh_round(lanes[2], read_le64(p + 16));
+    lanes[3] = xxh_round(lanes[3], read_le64(p + 24));
+}
+
+StreamHash::StreamHash(uint64_t seed) {
+    reset(seed);
+}
+
+void StreamHash::reset(uint64_t seed) {
+    seed_ = seed;
+    lanes_[0] = seed + PRIME64_1 + PRIME64_2;
+    lanes_[1] = seed + PRIME64_2;
+    lanes_[2] = seed;
+    lanes_[3] = seed - PRIME64_1;
+    buffered_ = 0;
+    total_ = 0;
+}
+
+void StreamHash::update(const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    total_ += size;
+
+    if (buffered_ + size < sizeof(buffer_)) {
+        std::memcpy(buffer_ + buffered_, p, size);
+        buffered_ += size;
+        return;
+    }
+
+    if (buffered_ > 0) {
+        size_t fill = sizeof(buffer_) - buffered_;
+        std::memcpy(buffer_ + buffered_, p, fill);
+        consume_stripe(lanes_, buffer_);
+        p += fill;
+        buffered_ = 0;
+    }
+
+    while (end - p >= 32) {
+        consume_stripe(lanes_, p);
+        p += 32;
+    }
+
+    buffered_ = static_cast<size_t>(end - p);
+    std::memcpy(buffer_, p, buffered_);
+}
+
+uint64_t StreamHash::digest() const {
+    uint64_t h;
+    if (total_ >= 32) {
+        h = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18);
+        for (uint64_t lane : lanes_) {
+            h = merge_round(h, lane);
+        }
+    } else {
+        h = seed_ + PRIME64_5;
+    }
+    h += total_;
+
+    const uint8_t* p = buffer_;
+    const uint8_t* end = buffer_ + buffered_;
+    while (end - p >= 8) {
+        h ^= xxh_round(0, read_le64(p));
+        h = rotl(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (end - p >= 4) {
+        h ^= static_cast<uint64_t>(read_le32(p)) * PRIME64_1;
+        h = rotl(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= (*p) * PRIME64_5;
+        h = rotl(h, 11) * PRIME64_1;
+        ++p;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+std::string StreamHash::hex_digest() const {
+    static const char hex[] = "0123456789abcdef";
+    uint64_t value = digest();
+    std::string text(16, '0');
+    for (int i = 15; i >= 0; --i) {
+        text[i] = hex[value & 0x0F];
+        value >>= 4;
+    }
+    return text;
+}
@@ -0,0 +1,115 @@
+#include "../include/test_definition_cache.h"
+
+// OPT_FLAG bits shared by PTR and MPR
+static const uint8_t OPT_LO_LIMIT_INVALID = 0x10;
+static const uint8_t OPT_HI_LIMIT_INVALID = 0x20;
+static const uint8_t OPT_NO_LO_LIMIT = 0x40;
+static const uint8_t OPT_NO_HI_LIMIT = 0x80;
+
+// Serialized size of a Cn field
+static size_t cn_size(const STDFColumnarStore& store, uint32_t id) {
+    return 1 + store.str(id).size();
+}
+
+void TestDefinitionCache::limits_from_flags(RowFields& fields, bool has_opt_flag, uint8_t opt_flag,
+                                            bool has_lo, bool has_hi) {
+    fields.lo_none = has_opt_flag && (opt_flag & OPT_NO_LO_LIMIT);
+    fields.hi_none = has_opt_flag && (opt_flag & OPT_NO_HI_LIMIT);
+    fields.lo_present = has_opt_flag && has_lo && !(opt_flag & OPT_LO_LIMIT_INVALID) && !fields.lo_none;
+    fields.hi_present = has_opt_flag && has_hi && !(opt_flag & OPT_HI_LIMIT_INVALID) && !fields.hi_none;
+}
+
+const TestDefinition& TestDefinitionCache::resolve_ptr(const STDFColumnarStore& store, size_t row) {
+    const PTRColumns& ptr = store.ptr;
+    const size_t length = ptr.rec_len[row];
+
+    // TEST_NUM HEAD_NUM SITE_NUM TEST_FLG PARM_FLG RESULT TEST_TXT ALARM_ID | OPT_FLAG
+    // RES_SCAL LLM_SCAL HLM_SCAL LO_LIMIT HI_LIMIT UNITS ...
+    const size_t opt_offset = 12 + cn_size(store, ptr.TEST_TXT[row]) + cn_size(store, ptr.ALARM_ID[row]);
+
+    RowFields fields;
+    fields.values.alarm_id = ptr.ALARM_ID[row];
+    fields.values.test_txt = ptr.TEST_TXT[row];
+    fields.values.units = ptr.UNITS[row];
+    fields.values.lo_limit = ptr.LO_LIMIT[row];
+    fields.values.hi_limit = ptr.HI_LIMIT[row];
+    fields.has_name = fields.values.alarm_id != 0 || fields.values.test_txt != 0;
+    fields.has_units = length > opt_offset + 12 && fields.values.units != 0;
+    limits_from_flags(fields, length > opt_offset, ptr.OPT_FLAG[row],
+                      length >= opt_offset + 8, length >= opt_offset + 12);
+
+    return resolve(ptr.TEST_NUM[row], ptr.HEAD_NUM[row], ptr.SITE_NUM[row], fields);
+}
+
+const TestDefinition& TestDefinitionCache::resolve_mpr(const STDFColumnarStore& store, size_t row) {
+    const MPRColumns& mpr = store.mpr;
+    const size_t length = mpr.rec_len[row];
+    const size_t rtn_icnt = mpr.RTN_ICNT[row];
+
+    // TEST_NUM HEAD_NUM SITE_NUM TEST_FLG PARM_FLG RTN_ICNT RSLT_CNT RTN_STAT RTN_RSLT
+    // TEST_TXT ALARM_ID | OPT_FLAG RES_SCAL LLM_SCAL HLM_SCAL LO_LIMIT HI_LIMIT
+    // START_IN INCR_IN RTN_INDX UNITS ...
+    const size_t opt_offset = 12 + (rtn_icnt + 1) / 2 + 4 * static_cast<size_t>(mpr.RSLT_CNT[row]) +
+                              cn_size(store, mpr.TEST_TXT[row]) + cn_size(store, mpr.ALARM_ID[row]);
+    const size_t units_offset = opt_offset + 20 + 2 * rtn_icnt;
+
+    RowFields fields;
+    fields.values.alarm_id = mpr.ALARM_ID[row];
+    fields.values.test_txt = mpr.TEST_TXT[row];
+    fields.values.units = mpr.UNITS[row];
+    fields.values.lo_limit = mpr.LO_LIMIT[row];
+    fields.values.hi_limit = mpr.HI_LIMIT[row];
+    fields.has_name = fields.values.alarm_id != 0 || fields.values.test_txt != 0;
+    fields.has_units = length > units_offset && fields.values.units != 0;
+    limits_from_flags(fields, length > opt_offset, mpr.OPT_FLAG[row],
+                      length >= opt_offset + 8, length >= opt_offset + 12);
+
+    return resolve(mpr.TEST_NUM[row], mpr.HEAD_NUM[row], mpr.SITE_NUM[row], fields);
+}
+
+const TestDefinition& TestDefinitionCache::resolve(uint32_t test_num, uint8_t head_num, uint8_t site_num,
+                                                   const RowFields& fields) {
+    const uint64_t key = (static_cast<uint64_t>(test_num) << 16) | (static_cast<uint64_t>(head_num) << 8) | site_num;
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        // First row of the test defines the defaults
+        TestDefinition definition = fields.values;
+        definition.has_lo_limit = fields.lo_present;
+        definition.has_hi_limit = fields.hi_present;
+        if (!fields.has_units) definition.units = 0;
+
+        index_.emplace(key, static_cast<uint32_t>(definitions_.size()));
+        definitions_.push_back(definition);
+        effective_ = definition;
+        return effective_;
+    }
+
+    // Later rows override only the fields they carry
+    effective_ = definitions_[it->second];
+    if (fields.has_name) {
+        effective_.alarm_id = fields.values.alarm_id;
+        effective_.test_txt = fields.values.test_txt;
+    }
+    if (fields.has_units) {
+        effective_.units = fields.values.units;
+    }
+    if (fields.lo_present) {
+        effective_.lo_limit = fields.values.lo_limit;
+        effective_.has_lo_limit = true;
+    } else if (fields.lo_none) {
+        effective_.has_lo_limit = false;
+    }
+    if (fields.hi_present) {
+        effective_.hi_limit = fields.values.hi_limit;
+        effective_.has_hi_limit = true;
+    } else if (fields.hi_none) {
+        effective_.has_hi_limit = false;
+    }
+    return effective_;
+}
+
+void TestDefinitionCache::clear() {
+    index_.clear();
+    definitions_.clear();
+}
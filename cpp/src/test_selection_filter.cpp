@@ -0,0 +1,160 @@
+#include "../include/test_selection_filter.h"
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STDF_FILTER_X86 1
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define STDF_FILTER_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Every kernel answers "does text[0, n) contain pattern[0, m)" for m >= 1
+
+static bool contains_scalar(const char* text, size_t n, const char* pattern, size_t m) {
+    return std::string_view(text, n).find(std::string_view(pattern, m)) != std::string_view::npos;
+}
+
+// Candidate at text + pos already matched the first and last byte
+static inline bool verify(const char* text, size_t pos, const char* pattern, size_t m) {
+    return m <= 2 || std::memcmp(text + pos + 1, pattern + 1, m - 2) == 0;
+}
+
+#ifdef STDF_FILTER_X86
+static bool contains_sse2(const char* text, size_t n, const char* pattern, size_t m) {
+    if (n < m) return false;
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[m - 1]);
+
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+        __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        while (mask) {
+            if (verify(text, i + __builtin_ctz(mask), pattern, m)) return true;
+            mask &= mask - 1;
+        }
+    }
+    return contains_scalar(text + i, n - i, pattern, m);
+}
+
+__attribute__((target("avx2")))
+static bool contains_avx2(const char* text, size_t n, const char* pattern, size_t m) {
+    if (n < m) return false;
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[m - 1]);
+
+    size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32) {
+        __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+        __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i + m - 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        while (mask) {
+            if (verify(text, i + __builtin_ctz(mask), pattern, m)) return true;
+            mask &= mask - 1;
+        }
+    }
+    return contains_sse2(text + i, n - i, pattern, m);
+}
+#endif
+
+#ifdef STDF_FILTER_NEON
+static bool contains_neon(const char* text, size_t n, const char* pattern, size_t m) {
+    if (n < m) return false;
+    const uint8x16_t first = vdupq_n_u8(static_cast<uint8_t>(pattern[0]));
+    const uint8x16_t last = vdupq_n_u8(static_cast<uint8_t>(pattern[m - 1]));
+
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16) {
+        uint8x16_t block_first = vld1q_u8(reinterpret_cast<const uint8_t*>(text + i));
+        uint8x16_t block_last = vld1q_u8(reinterpret_cast<const uint8_t*>(text + i + m - 1));
+        uint8x16_t hits = vandq_u8(vceqq_u8(first, block_first), vceqq_u8(last, block_last));
+        if (vmaxvq_u8(hits) == 0) continue;
+
+        uint8_t lanes[16];
+        vst1q_u8(lanes, hits);
+        for (size_t lane = 0; lane < 16; ++lane) {
+            if (lanes[lane] && verify(text, i + lane, pattern, m)) return true;
+        }
+    }
+    return contains_scalar(text + i, n - i, pattern, m);
+}
+#endif
+
+using ContainsKernel = bool (*)(const char*, size_t, const char*, size_t);
+
+struct KernelChoice {
+    ContainsKernel contains;
+    const char* name;
+};
+
+static KernelChoice choose_kernel() {
+#if defined(STDF_FILTER_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {contains_avx2, "avx2"};
+    return {contains_sse2, "sse2"};
+#elif defined(STDF_FILTER_NEON)
+    return {contains_neon, "neon"};
+#else
+    return {contains_scalar, "scalar"};
+#endif
+}
+
+static const KernelChoice& kernel() {
+    static const KernelChoice choice = choose_kernel();
+    return choice;
+}
+
+TestSelectionFilter::TestSelectionFilter()
+    : TestSelectionFilter(std::vector<std::string>{"Pixel="}) {
+}
+
+TestSelectionFilter::TestSelectionFilter(const std::vector<std::string>& patterns)
+    : match_all_(false) {
+    set_patterns(patterns);
+}
+
+void TestSelectionFilter::set_patterns(const std::vector<std::string>& patterns) {
+    patterns_ = patterns;
+    match_all_ = false;
+    for (const auto& pattern : patterns_) {
+        if (pattern.empty()) match_all_ = true;
+    }
+}
+
+bool TestSelectionFilter::matches(std::string_view text) const {
+    if (match_all_) return true;
+
+    ContainsKernel contains = kernel().contains;
+    for (const auto& pattern : patterns_) {
+        if (contains(text.data(), text.size(), pattern.data(), pattern.size())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TestSelectionFilter::match_batch(const std::string_view* texts, size_t count, uint8_t* selected) const {
+    if (match_all_ || patterns_.empty()) {
+        std::memset(selected, match_all_ ? 1 : 0, count);
+        return;
+    }
+
+    // Pattern-major; texts already selected skip the remaining patterns
+    std::memset(selected, 0, count);
+    ContainsKernel contains = kernel().contains;
+    for (const auto& pattern : patterns_) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!selected[i] && contains(texts[i].data(), texts[i].size(), pattern.data(), pattern.size())) {
+                selected[i] = 1;
+            }
+        }
+    }
+}
+
+const char* TestSelectionFilter::implementation() {
+    return kernel().name;
+}
@@ -0,0 +1,88 @@
+#include "../include/test_statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void RunningStats::add(const double* values, size_t value_count, double lo_limit, double hi_limit,
+                       bool has_lo_limit, bool has_hi_limit, bool passed_without_limits) {
+    if (value_count == 0) {
+        return;
+    }
+
+    // Independent sums and extremes first, then the block's deviations
+    double sum = 0.0;
+    double block_min = values[0];
+    double block_max = values[0];
+    for (size_t i = 0; i < value_count; ++i) {
+        sum += values[i];
+        block_min = std::min(block_min, values[i]);
+        block_max = std::max(block_max, values[i]);
+    }
+    const double block_mean = sum / static_cast<double>(value_count);
+    double block_m2 = 0.0;
+    for (size_t i = 0; i < value_count; ++i) {
+        const double deviation = values[i] - block_mean;
+        block_m2 += deviation * deviation;
+    }
+
+    uint64_t block_passed = 0;
+    if (!has_lo_limit && !has_hi_limit) {
+        block_passed = passed_without_limits ? value_count : 0;
+    } else {
+        const double lo = has_lo_limit ? lo_limit : -std::numeric_limits<double>::infinity();
+        const double hi = has_hi_limit ? hi_limit : std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < value_count; ++i) {
+            block_passed += (values[i] >= lo) & (values[i] <= hi);
+        }
+    }
+
+    RunningStats block;
+    block.count = value_count;
+    block.mean = block_mean;
+    block.m2 = block_m2;
+    block.min = block_min;
+    block.max = block_max;
+    block.passed = block_passed;
+    merge(block);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    const double total = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+    mean += delta * static_cast<double>(other.count) / total;
+    m2 += other.m2 + delta * delta * static_cast<double>(count) * static_cast<double>(other.count) / total;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count += other.count;
+    passed += other.passed;
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+double TestSummary::cpk() const {
+    const double sigma = stats.stddev();
+    if ((!has_lo_limit && !has_hi_limit) || !(sigma > 0.0)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    double cpk = std::numeric_limits<double>::infinity();
+    if (has_hi_limit) {
+        cpk = std::min(cpk, (hi_limit - stats.mean) / (3.0 * sigma));
+    }
+    if (has_lo_limit) {
+        cpk = std::min(cpk, (stats.mean - lo_limit) / (3.0 * sigma));
+    }
+    return cpk;
+}
+
+double TestSummary::yield() const {
+    return stats.count > 0 ? static_cast<double>(stats.passed) / static_cast<double>(stats.count) : 0.0;
+}
@@ -1,150 +1,415 @@
 #include "../include/ultra_fast_processor.h"
 #include "../include/measurement_macros.h"
+#include "../include/numeric_convert.h"
+#include "../include/console_log.h"
+#include "../include/instrumentation.h"
+#include "../include/columnar_cache.h"
+#include "../include/work_stealing_pool.h"
+#include "../include/stdf_tail_reader.h"
+#include "../include/measurement_sort.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <atomic>
 #include <chrono>
 #include <algorithm>
 #include <iomanip>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <filesystem>
+
+// Process-wide default for UltraFastProcessor::set_cache_dir
+static std::mutex g_default_cache_mutex;
+static std::string g_default_cache_dir;
+
+// Process-wide default for UltraFastProcessor::set_sort_output
+static std::atomic<bool> g_default_sort_output(false);
+
+// Process-wide default for FastIDManager::attach_snapshots
+static std::mutex g_default_snapshot_mutex;
+static std::string g_default_snapshot_dir;
 
 // FastIDManager Implementation
-FastIDManager::FastIDManager() 
-    : device_counter_(0), param_counter_(0) {
+FastIDManager::FastIDManager(bool attach_default_snapshots) {
+    // Missing until snapshots are first saved
+    const std::string snapshot_dir = attach_default_snapshots ? get_default_snapshot_dir() : std::string();
+    if (!snapshot_dir.empty()) {
+        attach_snapshots(snapshot_dir);
+    }
 }
 
-void FastIDManager::load_existing_mappings_from_python(
-    const std::vector<std::pair<std::string, uint32_t>>& device_mappings,
-    const std::vector<std::pair<std::string, uint32_t>>& param_mappings) {
-    
-    // Load existing device mappings
-    uint32_t max_device_id = 0;
-    for (const auto& pair : device_mappings) {
-        device_id_map_[pair.first] = pair.second;
-        existing_devices_.insert(pair.first);
-        max_device_id = std::max(max_device_id, pair.second);
-    }
-    device_counter_ = max_device_id + 1;
-    
-    // Load existing parameter mappings
-    uint32_t max_param_id = 0;
-    for (const auto& pair : param_mappings) {
-        param_id_map_[pair.first] = pair.second;
-        existing_params_.insert(pair.first);
-        max_param_id = std::max(max_param_id, pair.second);
-    }
-    param_counter_ = max_param_id + 1;
-    
-    std::cout << "🔧 Loaded " << device_mappings.size() << " existing device mappings, " 
-              << param_mappings.size() << " parameter mappings" << std::endl;
-    std::cout << "🔢 Starting counters: devices=" << device_counter_ 
-              << ", parameters=" << param_counter_ << std::endl;
+void FastIDManager::set_default_snapshot_dir(const std::string& snapshot_dir) {
+    std::lock_guard<std::mutex> lock(g_default_snapshot_mutex);
+    g_default_snapshot_dir = snapshot_dir;
 }
 
-uint32_t FastIDManager::get_device_id(const std::string& device_dmc) {
-    auto it = device_id_map_.find(device_dmc);
-    if (it != device_id_map_.end()) {
-        return it->second;
+std::string FastIDManager::get_default_snapshot_dir() {
+    std::lock_guard<std::mutex> lock(g_default_snapshot_mutex);
+    return g_default_snapshot_dir;
+}
+
+std::string FastIDManager::snapshot_path(const std::string& snapshot_dir, bool devices) {
+    return (std::filesystem::path(snapshot_dir) / (devices ? "devices.idmap" : "params.idmap")).string();
+}
+
+bool FastIDManager::attach_snapshots(const std::string& snapshot_dir) {
+    auto devices = IDMapSnapshot::open_shared(snapshot_path(snapshot_dir, true), last_error_);
+    auto params = devices ? IDMapSnapshot::open_shared(snapshot_path(snapshot_dir, false), last_error_) : nullptr;
+    if (!params) {
+        return false;
     }
-    
-    uint32_t new_id = device_counter_++;
-    device_id_map_[device_dmc] = new_id;
-    return new_id;
+    devices_.attach(devices);
+    params_.attach(params);
+    return true;
 }
 
-uint32_t FastIDManager::get_param_id(const std::string& param_name) {
-    auto it = param_id_map_.find(param_name);
-    if (it != param_id_map_.end()) {
-        return it->second;
+bool FastIDManager::save_snapshots(const std::string& snapshot_dir) const {
+    std::string error;
+    bool saved = IDMapSnapshot::write(snapshot_path(snapshot_dir, true), devices_.all_mappings(), error) &&
+                 IDMapSnapshot::write(snapshot_path(snapshot_dir, false), params_.all_mappings(), error);
+    if (!saved) {
+        last_error_ = error;
     }
+    return saved;
+}
+
+void FastIDManager::load_existing_mappings_from_python(
+    const std::vector<std::pair<std::string, uint32_t>>& device_mappings,
+    const std::vector<std::pair<std::string, uint32_t>>& param_mappings) {
+    
+    devices_.load(device_mappings);
+    params_.load(param_mappings);
     
-    uint32_t new_id = param_counter_++;
-    param_id_map_[param_name] = new_id;
-    return new_id;
+    ConsoleLog::out() << "🔧 Loaded " << device_mappings.size() << " existing device mappings, " 
+              << param_mappings.size() << " parameter mappings" << std::endl;
+    if (devices_.snapshot()) {
+        ConsoleLog::out() << "🔧 On top of snapshots of " << devices_.snapshot()->size() << " devices, "
+                  << params_.snapshot()->size() << " parameters" << std::endl;
+    }
+    ConsoleLog::out() << "🔢 Starting counters: devices=" << devices_.next_id() 
+              << ", parameters=" << params_.next_id() << std::endl;
 }
 
 // UltraFastProcessor Implementation
 UltraFastProcessor::UltraFastProcessor()
     : enable_pixel_filtering_(true)
+    , parser_backend_(STDFParserBackend::LIBSTDF)
+    , num_threads_(1)
+    , cache_dir_(get_default_cache_dir())
+    , sort_output_(get_default_sort_output())
+    , shared_id_manager_(nullptr)
     , total_records_(0)
     , processed_measurements_(0)
     , parsing_time_(0.0)
     , processing_time_(0.0)
-    , pixel_pattern_(R"(Pixel=R(\d+)C(\d+))")
-    , pixel_clean_pattern1_(R"(;Pixel=R\d+C\d+)")
-    , pixel_clean_pattern2_(R"(^Pixel=R\d+C\d+;)") {
+    , loaded_from_cache_(false)
+    , follow_mir_read_(false) {
 }
 
 UltraFastProcessor::~UltraFastProcessor() {
 }
 
+void UltraFastProcessor::set_num_threads(size_t threads) {
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    num_threads_ = threads;
+}
+
+void UltraFastProcessor::set_default_cache_dir(const std::string& cache_dir) {
+    std::lock_guard<std::mutex> lock(g_default_cache_mutex);
+    g_default_cache_dir = cache_dir;
+}
+
+std::string UltraFastProcessor::get_default_cache_dir() {
+    std::lock_guard<std::mutex> lock(g_default_cache_mutex);
+    return g_default_cache_dir;
+}
+
+void UltraFastProcessor::set_default_sort_output(bool sort) {
+    g_default_sort_output = sort;
+}
+
+bool UltraFastProcessor::get_default_sort_output() {
+    return g_default_sort_output;
+}
+
 std::vector<MeasurementTuple> UltraFastProcessor::process_stdf_file(const std::string& filepath) {
-    std::vector<MeasurementTuple> measurements;
+    return process_stdf_file_to_batch(filepath).to_tuples();
+}
+
+MeasurementBatch UltraFastProcessor::process_stdf_file_to_batch(const std::string& filepath) {
+    MeasurementBatch measurements;
+    process_stdf_file_in_batches(filepath, 0, [&measurements](MeasurementBatch& batch) {
+        measurements = std::move(batch);
+        return true;
+    });
+    return measurements;
+}
+
+bool UltraFastProcessor::process_stdf_file_to_spool(const std::string& filepath, MeasurementSpool& spool,
+                                                    size_t file) {
+    bool spooled = true;
+    bool completed = process_stdf_file_in_batches(filepath, spool.block_rows(), [&](MeasurementBatch& batch) {
+        spooled = spool.add(file, batch);
+        return spooled;
+    });
+    if (!spooled && last_error_.empty()) {
+        last_error_ = spool.get_last_error();
+    }
+    return completed;
+}
+
+bool UltraFastProcessor::process_stdf_file_in_batches(const std::string& filepath, size_t batch_rows,
+                                                      const MeasurementSink& sink) {
+    StageTimer timer(InstrumentedStage::FILE_PROCESSING);
+    bool completed = false;
+    processed_measurements_ = 0;
     
     auto start_time = std::chrono::high_resolution_clock::now();
     
     try {
-        std::cout << "🚀 Ultra-fast C++ processing: " << filepath << std::endl;
+        ConsoleLog::out() << "🚀 Ultra-fast C++ processing: " << filepath << std::endl;
         
         // Step 1: Parse STDF file using existing parser
         auto parse_start = std::chrono::high_resolution_clock::now();
         
-        STDFParser parser;
-        std::vector<STDFRecord> records = parser.parse_file(filepath);
+        // Release the previous file's strings and values in one go
+        reset_file_state();
+        
+        // Decode straight into typed columns; no per-field string maps
+        STDFColumnarStore store;
+        std::string content_hash;
+        last_error_.clear();
+        if (!decode_columns(filepath, store, content_hash)) {
+            last_error_ = "Failed to parse " + filepath;
+        }
         
         auto parse_end = std::chrono::high_resolution_clock::now();
         parsing_time_ = std::chrono::duration<double>(parse_end - parse_start).count();
-        total_records_ = records.size();
         
-        std::cout << "⚡ C++ parsed " << total_records_ << " records in " 
-                  << parsing_time_ << "s" << std::endl;
+        ConsoleLog::out() << "⚡ C++ " << (loaded_from_cache_ ? "loaded " : "parsed ") << total_records_
+                  << " records in " << parsing_time_ << "s" << std::endl;
         
         // Step 2: Process records entirely in C++
         auto process_start = std::chrono::high_resolution_clock::now();
         
-        // Group records by type
-        auto mir_records = filter_records_by_type(records, STDFRecordType::MIR);
-        auto prr_records = filter_records_by_type(records, STDFRecordType::PRR);
-        auto test_records = filter_test_records(records);
+        size_t test_record_count = store.ptr.size() + store.mpr.size() + store.ftr.size();
+        ConsoleLog::out() << "📊 Found " << store.mir_records.size() << " MIR, " 
+                  << store.prr.size() << " PRR, " 
+                  << test_record_count << " test records" << std::endl;
+        
+        std::vector<ProcessedTest> processed_tests;
+        std::vector<TestSite> test_sites;
+        build_processed_tests(store, processed_tests, test_sites);
         
-        std::cout << "📊 Found " << mir_records.size() << " MIR, " 
-                  << prr_records.size() << " PRR, " 
-                  << test_records.size() << " test records" << std::endl;
+        // Bins only need the PRR/HBR/SBR columns, a tiny pass next to the tests
+        bin_summary_.build(store);
+        if (bin_summary_.mismatched_bins() > 0) {
+            ConsoleLog::out() << "⚠️ " << bin_summary_.mismatched_bins()
+                      << " HBR/SBR bin counts differ from the PRRs" << std::endl;
+        }
         
         // Extract MIR information
-        MIRInfo mir_info = extract_mir_info(mir_records);
+        MIRInfo mir_info = extract_mir_info(store.mir_records);
         
-        // Generate file hash if not set
-        if (file_hash_.empty()) {
-            file_hash_ = calculate_file_hash(filepath);
-        }
+        current_file_hash_ = file_hash_.empty() ? content_hash : file_hash_;
         
-        // Process cross-product in C++
-        measurements = process_cross_product(prr_records, test_records, mir_info);
+        // Attach each test to the part it was measured on
+        completed = process_part_brackets(store, processed_tests, test_sites, mir_info, batch_rows,
+            [&](MeasurementBatch& batch) {
+                processed_measurements_ += batch.size();
+                return sink(batch);
+            }) && last_error_.empty();
         
         auto process_end = std::chrono::high_resolution_clock::now();
         processing_time_ = std::chrono::duration<double>(process_end - process_start).count();
-        processed_measurements_ = measurements.size();
         
         auto total_time = std::chrono::duration<double>(process_end - start_time).count();
         
-        std::cout << "✅ Ultra-fast C++ processing completed:" << std::endl;
-        std::cout << "   📊 Total records: " << total_records_ << std::endl;
-        std::cout << "   📊 Measurements: " << processed_measurements_ << std::endl;
-        std::cout << "   ⏱️ Parsing time: " << parsing_time_ << "s" << std::endl;
-        std::cout << "   ⏱️ Processing time: " << processing_time_ << "s" << std::endl;
-        std::cout << "   ⏱️ Total time: " << total_time << "s" << std::endl;
+        ConsoleLog::out() << "✅ Ultra-fast C++ processing completed:" << std::endl;
+        ConsoleLog::out() << "   📊 Total records: " << total_records_ << std::endl;
+        ConsoleLog::out() << "   📊 Measurements: " << processed_measurements_ << std::endl;
+        ConsoleLog::out() << "   ⏱️ Parsing time: " << parsing_time_ << "s" << std::endl;
+        ConsoleLog::out() << "   ⏱️ Processing time: " << processing_time_ << "s" << std::endl;
+        ConsoleLog::out() << "   ⏱️ Total time: " << total_time << "s" << std::endl;
         
         if (total_time > 0) {
             double throughput = processed_measurements_ / total_time;
-            std::cout << "   🚀 Throughput: " << static_cast<uint64_t>(throughput) 
+            ConsoleLog::out() << "   🚀 Throughput: " << static_cast<uint64_t>(throughput) 
                       << " measurements/second" << std::endl;
         }
         
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error in ultra-fast processing: " << e.what() << std::endl;
+        ConsoleLog::err() << "❌ Error in ultra-fast processing: " << e.what() << std::endl;
+        last_error_ = e.what();
+        completed = false;
     }
     
-    return measurements;
+    return completed;
+}
+
+void UltraFastProcessor::reset_file_state() {
+    text_.clear();
+    test_values_.clear();
+    test_definitions_.clear();
+    resolved_names_.clear();
+    name_slots_.clear();
+    units_text_ids_.clear();
+    selected_strings_.clear();
+    parts_.clear();
+    test_summaries_.clear();
+    bin_summary_.clear();
+}
+
+bool UltraFastProcessor::start_following(const std::string& filepath) {
+    reset_file_state();
+    follow_store_.clear();
+    follow_mir_ = MIRInfo();
+    follow_mir_read_ = false;
+    total_records_ = 0;
+    processed_measurements_ = 0;
+    loaded_from_cache_ = false;
+    current_file_hash_ = file_hash_.empty() ? filepath : file_hash_;
+    
+    tail_.reset(new STDFTailReader());
+    if (!tail_->open(filepath)) {
+        last_error_ = tail_->get_last_error();
+        return false;
+    }
+    last_error_.clear();
+    return true;
+}
+
+bool UltraFastProcessor::poll_followed_file(size_t batch_rows, const MeasurementSink& sink) {
+    StageTimer timer(InstrumentedStage::FILE_PROCESSING);
+    processed_measurements_ = 0;
+    if (!tail_) {
+        last_error_ = "poll_followed_file() before start_following()";
+        return false;
+    }
+    last_error_.clear();
+    
+    bool completed = false;
+    try {
+        auto parse_start = std::chrono::high_resolution_clock::now();
+        if (!tail_->poll(follow_store_)) {
+            last_error_ = tail_->get_last_error();
+            return false;
+        }
+        total_records_ = tail_->record_count();
+        auto parse_end = std::chrono::high_resolution_clock::now();
+        parsing_time_ = std::chrono::duration<double>(parse_end - parse_start).count();
+        
+        if (!follow_mir_read_ && !follow_store_.mir_records.empty()) {
+            follow_mir_ = extract_mir_info(follow_store_.mir_records);
+            follow_mir_read_ = true;
+        }
+        
+        // Names, definitions and the string table persist; the per-poll
+        // values, parts and dictionary codes start over
+        test_values_.clear();
+        parts_.clear();
+        test_summaries_.clear();
+        bin_summary_.clear();
+        for (ResolvedName& name : resolved_names_) {
+            name.name_code = UINT32_MAX;
+            name.summary_slot = UINT32_MAX;
+        }
+        
+        std::vector<ProcessedTest> processed_tests;
+        std::vector<TestSite> test_sites;
+        build_processed_tests(follow_store_, processed_tests, test_sites);
+        bin_summary_.build(follow_store_);
+        
+        completed = process_part_brackets(follow_store_, processed_tests, test_sites, follow_mir_, batch_rows,
+            [&](MeasurementBatch& batch) {
+                processed_measurements_ += batch.size();
+                return sink(batch);
+            }) && last_error_.empty();
+        
+        carry_open_parts(follow_store_);
+        processing_time_ = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - parse_end).count();
+        
+        ConsoleLog::out() << "📡 Followed " << tail_->path() << ": " << tail_->last_poll_records() << " new records, "
+                  << processed_measurements_ << " measurements, " << open_part_tests()
+                  << " tests in open parts" << (tail_->complete() ? " (file complete)" : "") << std::endl;
+    } catch (const std::exception& e) {
+        ConsoleLog::err() << "❌ Error following " << tail_->path() << ": " << e.what() << std::endl;
+        last_error_ = e.what();
+        completed = false;
+    }
+    return completed;
+}
+
+size_t UltraFastProcessor::open_part_tests() const {
+    return follow_store_.ptr.size() + follow_store_.mpr.size() + follow_store_.ftr.size();
+}
+
+void UltraFastProcessor::carry_open_parts(STDFColumnarStore& store) {
+    // A test or PIR stays while no PRR of its head/site follows it; the
+    // emitted parts, bins and the MIR go. Once the MRR has been read no
+    // part can close any more.
+    std::vector<uint32_t> last_prr(1 << 16, 0);
+    for (size_t row = 0; row < store.prr.size(); ++row) {
+        last_prr[(store.prr.HEAD_NUM[row] << 8) | store.prr.SITE_NUM[row]] = store.prr.record_index[row];
+    }
+    const bool complete = tail_->complete();
+    auto open = [&](const auto& heads, const auto& sites, const auto& record_index, std::vector<uint8_t>& keep) {
+        keep.resize(record_index.size());
+        for (size_t row = 0; row < keep.size(); ++row) {
+            keep[row] = !complete && record_index[row] > last_prr[(heads[row] << 8) | sites[row]];
+        }
+    };
+    
+    STDFRowSelection keep;
+    open(store.ptr.HEAD_NUM, store.ptr.SITE_NUM, store.ptr.record_index, keep.ptr);
+    open(store.mpr.HEAD_NUM, store.mpr.SITE_NUM, store.mpr.record_index, keep.mpr);
+    open(store.ftr.HEAD_NUM, store.ftr.SITE_NUM, store.ftr.record_index, keep.ftr);
+    open(store.pir.HEAD_NUM, store.pir.SITE_NUM, store.pir.record_index, keep.pir);
+    keep.prr.assign(store.prr.size(), 0);
+    keep.hbr.assign(store.hbr.size(), 0);
+    keep.sbr.assign(store.sbr.size(), 0);
+    store.retain(keep);
+    store.mir_records.clear();
+}
+
+bool UltraFastProcessor::decode_columns(const std::string& filepath, STDFColumnarStore& store,
+                                        std::string& content_hash) {
+    loaded_from_cache_ = false;
+    content_hash.clear();
+    ColumnarCache cache(cache_dir_);
+    if (cache.enabled()) {
+        // Hashing is a plain read, far cheaper than the decode it may save
+        content_hash = STDFParser::hash_file_content(filepath);
+        ColumnarCacheInfo info;
+        if (cache.contains(content_hash)) {
+            if (cache.load(content_hash, store, info)) {
+                total_records_ = info.parsed_records;
+                loaded_from_cache_ = true;
+                ConsoleLog::out() << "📦 Columns loaded from cache: " << cache.entry_path(content_hash) << std::endl;
+                return true;
+            }
+            ConsoleLog::err() << "⚠️ " << cache.get_last_error() << ", decoding again" << std::endl;
+        }
+    }
+    
+    STDFParser parser;
+    parser.set_backend(parser_backend_);
+    parser.set_num_threads(num_threads_);
+    parser.set_content_hash(content_hash);  // Taken for the lookup above, if any
+    bool parsed = parser.parse_to_columns(filepath, store);
+    total_records_ = parser.get_parsed_records();
+    content_hash = parser.get_content_hash();
+    
+    if (parsed && cache.enabled() && !content_hash.empty()) {
+        ColumnarCacheInfo info;
+        info.total_records = parser.get_total_records();
+        info.parsed_records = parser.get_parsed_records();
+        if (!cache.save(content_hash, store, info)) {
+            ConsoleLog::err() << "⚠️ " << cache.get_last_error() << std::endl;
+        }
+    }
+    return parsed;
 }
 
 MIRInfo UltraFastProcessor::extract_mir_info(const std::vector<STDFRecord>& mir_records) {
@@ -171,357 +436,370 @@ MIRInfo UltraFastProcessor::extract_mir_info(const std::vector<STDFRecord>& mir_
     return mir_info;
 }
 
-std::vector<MeasurementTuple> UltraFastProcessor::process_cross_product(
-    const std::vector<STDFRecord>& prr_records,
-    const std::vector<STDFRecord>& test_records,
-    const MIRInfo& mir_info) {
-    
-    std::vector<MeasurementTuple> measurements;
-    
-    if (prr_records.empty() || test_records.empty()) {
-        std::cout << "⚠️ No PRR or test records found for cross-product" << std::endl;
-        return measurements;
+void UltraFastProcessor::build_processed_tests(const STDFColumnarStore& store,
+                                               std::vector<ProcessedTest>& processed_tests,
+                                               std::vector<TestSite>& test_sites) {
+    const PTRColumns& ptr = store.ptr;
+    const MPRColumns& mpr = store.mpr;
+    const FTRColumns& ftr = store.ftr;
+    
+    processed_tests.reserve(ptr.size() + mpr.size() + ftr.size());
+    test_sites.reserve(ptr.size() + mpr.size() + ftr.size());
+    test_values_.reserve(ptr.size() + store.float_pool.size() + ftr.size());
+    
+    // Both are per string of the store; a followed file's store keeps its
+    // strings between polls, so only the ones added since are new here
+    units_text_ids_.resize(store.strings.size(), UINT32_MAX);
+    
+    // Run the selection filter once over every distinct string of the file
+    if (enable_pixel_filtering_) {
+        const size_t first = selected_strings_.size();
+        std::vector<std::string_view> texts(store.strings.size() - first);
+        for (uint32_t id = 0; id < texts.size(); ++id) {
+            texts[id] = store.str(static_cast<uint32_t>(first + id));
+        }
+        selected_strings_.resize(store.strings.size());
+        test_filter_.match_batch(texts.data(), texts.size(), selected_strings_.data() + first);
     }
     
-    // Pre-allocate measurements vector
-    size_t estimated_size = prr_records.size() * test_records.size() * 3; // Estimate 3 values per test
-    measurements.reserve(estimated_size);
-    
-    std::cout << "🚀 C++ cross-product: " << prr_records.size() << " devices × " 
-              << test_records.size() << " tests = ~" << estimated_size << " estimated measurements" << std::endl;
-    
-    // Pre-process test records with pixel filtering
-    struct ProcessedTest {
-        std::vector<double> values;
-        std::string cleaned_param_name;
-        std::string units;
-        uint32_t test_num;
-        uint8_t test_flg;
-        int32_t pixel_x;
-        int32_t pixel_y;
-        uint32_t param_id;
-    };
-    
-    std::vector<ProcessedTest> processed_tests;
-    processed_tests.reserve(test_records.size());
-    
-    size_t pixel_tests_found = 0;
-    
-    for (const auto& test : test_records) {
-        // Apply pixel filtering if enabled
-        if (enable_pixel_filtering_ && !is_pixel_test(test)) {
-            continue;
-        }
-        
-        pixel_tests_found++;
-        
-        ProcessedTest pt;
-        
-        // Parse test values
-        pt.values = parse_test_values(test);
-        
-        // Clean parameter name
-        // Use .def file extractions for parameter names (consistent with is_pixel_test)
-        std::string alarm_id = "";
-        std::string test_txt = "";
-        
-        auto alarm_it = test.fields.find("ALARM_ID");
-        if (alarm_it != test.fields.end()) {
-            alarm_id = alarm_it->second;
+    // Fill the name/flag part of an entry; returns false when the test
+    // selection filter drops the test
+    auto add_test = [&](uint32_t name_slot, std::string_view units, const TestDefinition* def,
+                        uint32_t test_num, uint8_t test_flg, ProcessedTest& pt) {
+        const ResolvedName& name = resolved_names_[name_slot];
+        if (!name.keep) {
+            return false;
         }
         
-        auto test_txt_it = test.fields.find("TEST_TXT");
-        if (test_txt_it != test.fields.end()) {
-            test_txt = test_txt_it->second;
-        }
-        
-        std::string param_name = alarm_id.empty() ? test_txt : alarm_id;
-        pt.cleaned_param_name = clean_param_name(param_name);
-        pt.param_id = id_manager_.get_param_id(pt.cleaned_param_name);
-        
-        // Extract other fields
-        auto get_field = [&](const std::string& key, const std::string& fallback = "") {
-            auto it = test.fields.find(key);
-            return (it != test.fields.end()) ? it->second : fallback;
-        };
-        
-        pt.units = test.units;
-        pt.test_num = test.test_num;
-        
-        // Parse TEST_FLG
-        std::string test_flg_str = get_field("TEST_FLG", "0");
-        pt.test_flg = static_cast<uint8_t>(std::stoul(test_flg_str));
-        
-        // Extract pixel coordinates
-        auto coords = extract_pixel_coordinates(param_name);
-        pt.pixel_x = coords.first;
-        pt.pixel_y = coords.second;
-        
-        processed_tests.push_back(std::move(pt));
-    }
-    
-    std::cout << "🎯 Pre-processed " << pixel_tests_found << " pixel tests from " 
-              << test_records.size() << " total tests" << std::endl;
+        pt.name_slot = name_slot;
+        pt.cleaned_param_name = name.cleaned_param_name;
+        pt.units = units;
+        pt.param_id = 0;  // Assigned in process_part_brackets, as are the codes
+        pt.name_code = 0;
+        pt.units_code = 0;
+        pt.test_num = test_num;
+        pt.test_flg = test_flg;
+        pt.pixel_x = name.pixel_x;
+        pt.pixel_y = name.pixel_y;
+        pt.lo_limit = def ? def->lo_limit : 0.0f;
+        pt.hi_limit = def ? def->hi_limit : 0.0f;
+        pt.has_lo_limit = def && def->has_lo_limit;
+        pt.has_hi_limit = def && def->has_hi_limit;
+        pt.summary_slot = 0;
+        pt.value_offset = static_cast<uint32_t>(test_values_.size());
+        pt.value_count = 0;
+        return true;
+    };
     
-    // Process cross-product
-    size_t measurements_created = 0;
+    // Merge the three tables back into file order (record_index ascending)
+    size_t i_ptr = 0, i_mpr = 0, i_ftr = 0;
+    const uint32_t done = UINT32_MAX;
     
-    for (const auto& prr : prr_records) {
-        // Extract device information
-        auto get_prr_field = [&](const std::string& key, const std::string& fallback = "") {
-            auto it = prr.fields.find(key);
-            return (it != prr.fields.end()) ? it->second : fallback;
-        };
+    while (i_ptr < ptr.size() || i_mpr < mpr.size() || i_ftr < ftr.size()) {
+        uint32_t next_ptr = (i_ptr < ptr.size()) ? ptr.record_index[i_ptr] : done;
+        uint32_t next_mpr = (i_mpr < mpr.size()) ? mpr.record_index[i_mpr] : done;
+        uint32_t next_ftr = (i_ftr < ftr.size()) ? ftr.record_index[i_ftr] : done;
         
-        std::string device_dmc = get_prr_field("PART_ID", get_prr_field("PART_TXT"));
-        std::string bin_code = get_prr_field("SOFT_BIN", get_prr_field("HARD_BIN"));
-        
-        // Parse coordinates with defaults
-        int32_t default_x = 0, default_y = 0;
-        try {
-            std::string x_coord = get_prr_field("X_COORD", "0");
-            std::string y_coord = get_prr_field("Y_COORD", "0");
-            default_x = std::stoi(x_coord);
-            default_y = std::stoi(y_coord);
-        } catch (...) {
-            // Use defaults if parsing fails
-        }
-        
-        uint32_t device_id = id_manager_.get_device_id(device_dmc);
-        uint8_t test_flag = calculate_test_flag(prr);
-        
-        // Create measurements for this device  
-        for (const auto& test : processed_tests) {
-            for (double value : test.values) {
-                MeasurementTuple measurement;
-                
-                // 🚀 MACRO-DRIVEN: Initialize all fields using macro  
-                INIT_MEASUREMENT(measurement, device_dmc, device_id, test, value, test_flag, file_hash_);
-                
-                measurements.push_back(std::move(measurement));
-                measurements_created++;
+        ProcessedTest pt;
+        TestSite site;
+        
+        if (next_ptr <= next_mpr && next_ptr <= next_ftr) {
+            size_t row = i_ptr++;
+            const TestDefinition& def = test_definitions_.resolve_ptr(store, row);
+            if (!add_test(resolve_name(store, def.alarm_id, def.test_txt), resolve_units(store, def.units), &def,
+                          ptr.TEST_NUM[row], ptr.TEST_FLG[row], pt)) continue;
+            test_values_.push_back(ptr.RESULT[row]);
+            site = {ptr.record_index[row], ptr.HEAD_NUM[row], ptr.SITE_NUM[row]};
+        } else if (next_mpr <= next_ftr) {
+            size_t row = i_mpr++;
+            const TestDefinition& def = test_definitions_.resolve_mpr(store, row);
+            if (!add_test(resolve_name(store, def.alarm_id, def.test_txt), resolve_units(store, def.units), &def,
+                          mpr.TEST_NUM[row], mpr.TEST_FLG[row], pt)) continue;
+            const size_t result_count = store.mpr_result_count(row);
+            if (result_count == 0) {
+                test_values_.push_back(0.0);
+            } else {
+                const size_t at = test_values_.size();
+                test_values_.resize(at + result_count);
+                convert_r4_to_double(store.mpr_results(row), result_count, test_values_.data() + at);
             }
+            site = {mpr.record_index[row], mpr.HEAD_NUM[row], mpr.SITE_NUM[row]};
+        } else {
+            size_t row = i_ftr++;
+            // ftr_fields.def carries no TEST_TXT/ALARM_ID/UNITS
+            if (!add_test(resolve_name(store, 0, 0), std::string_view(), nullptr,
+                          ftr.TEST_NUM[row], ftr.TEST_FLG[row], pt)) continue;
+            test_values_.push_back(0.0);  // Functional tests carry no parametric result
+            site = {ftr.record_index[row], ftr.HEAD_NUM[row], ftr.SITE_NUM[row]};
         }
+        
+        pt.value_count = static_cast<uint32_t>(test_values_.size() - pt.value_offset);
+        processed_tests.push_back(pt);
+        test_sites.push_back(site);
     }
-    
-    std::cout << "✅ C++ cross-product completed: " << measurements_created 
-              << " measurements created" << std::endl;
-    
-    return measurements;
 }
 
-std::vector<STDFRecord> UltraFastProcessor::filter_records_by_type(
-    const std::vector<STDFRecord>& records, 
-    STDFRecordType type) {
-    
-    std::vector<STDFRecord> filtered;
-    
-    for (const auto& record : records) {
-        if (record.type == type) {
-            filtered.push_back(record);
-        }
+uint32_t UltraFastProcessor::resolve_name(const STDFColumnarStore& store, uint32_t alarm_id, uint32_t test_txt) {
+    const uint64_t key = (static_cast<uint64_t>(alarm_id) << 32) | test_txt;
+    auto it = name_slots_.find(key);
+    if (it != name_slots_.end()) {
+        return it->second;
     }
     
-    return filtered;
+    std::string_view alarm = store.str(alarm_id);
+    std::string_view text = store.str(test_txt);
+    std::string_view param_name = alarm.empty() ? text : alarm;
+    
+    parse_pixel_name(param_name, pixel_name_);
+    
+    ResolvedName name;
+    name.keep = !enable_pixel_filtering_ || selected_strings_[alarm_id] || selected_strings_[test_txt];
+    name.cleaned_param_name = text_.get(text_.intern(pixel_name_.cleaned));
+    name.pixel_x = pixel_name_.x;
+    name.pixel_y = pixel_name_.y;
+    name.param_id = UINT32_MAX;
+    name.name_code = UINT32_MAX;
+    name.summary_slot = UINT32_MAX;
+    
+    uint32_t slot = static_cast<uint32_t>(resolved_names_.size());
+    resolved_names_.push_back(name);
+    name_slots_.emplace(key, slot);
+    return slot;
 }
 
-std::vector<STDFRecord> UltraFastProcessor::filter_test_records(const std::vector<STDFRecord>& records) {
-    std::vector<STDFRecord> test_records;
-    
-    for (const auto& record : records) {
-        if (record.type == STDFRecordType::PTR || 
-            record.type == STDFRecordType::MPR ||
-            record.type == STDFRecordType::FTR) {
-            test_records.push_back(record);
-        }
+std::string_view UltraFastProcessor::resolve_units(const STDFColumnarStore& store, uint32_t units) {
+    uint32_t& text_id = units_text_ids_[units];
+    if (text_id == UINT32_MAX) {
+        text_id = text_.intern(store.str(units));
     }
-    
-    return test_records;
+    return text_.get(text_id);
 }
 
-bool UltraFastProcessor::is_pixel_test(const STDFRecord& test_record) {
-    // Use .def file extractions instead of record-level fields (more maintainable)
-    std::string alarm_id = "";
-    std::string test_txt = "";
-    
-    // Get ALARM_ID and TEST_TXT from .def file extractions
-    auto alarm_it = test_record.fields.find("ALARM_ID");
-    if (alarm_it != test_record.fields.end()) {
-        alarm_id = alarm_it->second;
+bool UltraFastProcessor::process_part_brackets(
+    const STDFColumnarStore& store,
+    std::vector<ProcessedTest>& processed_tests,
+    const std::vector<TestSite>& test_sites,
+    const MIRInfo& /*mir_info*/,
+    size_t batch_rows,
+    const MeasurementSink& sink) {
+    
+    // Only the dictionaries live here; every emitted batch starts as a copy
+    MeasurementBatch dictionaries;
+    
+    const PRRColumns& prr = store.prr;
+    
+    if (prr.size() == 0 || processed_tests.empty()) {
+        ConsoleLog::out() << "⚠️ No PRR or test records found for part association" << std::endl;
+        return true;
     }
     
-    auto test_txt_it = test_record.fields.find("TEST_TXT");
-    if (test_txt_it != test_record.fields.end()) {
-        test_txt = test_txt_it->second;
+    parts_.build(store, test_sites, num_threads_);
+    
+    // Resolve parameter IDs and dictionary codes in output order and give
+    // every part a fixed slice of the output
+    std::vector<size_t> part_offsets(prr.size() + 1, 0);
+    std::unordered_map<uint32_t, uint32_t> summary_slots;  // wtp_id -> test_summaries_ index
+    for (size_t row = 0; row < prr.size(); ++row) {
+        size_t part_values = 0;
+        for (const uint32_t* it = parts_.begin(row); it != parts_.end(row); ++it) {
+            ProcessedTest& test = processed_tests[*it];
+            ResolvedName& name = resolved_names_[test.name_slot];
+            if (name.param_id == UINT32_MAX) {
+                name.param_id = ids().get_param_id(name.cleaned_param_name);
+            }
+            if (name.name_code == UINT32_MAX) {
+                name.name_code = dictionaries.wtp_param_name.encode(name.cleaned_param_name);
+            }
+            if (name.summary_slot == UINT32_MAX) {
+                // Names that clean to the same parameter share a summary
+                auto inserted = summary_slots.emplace(name.param_id, static_cast<uint32_t>(test_summaries_.size()));
+                if (inserted.second) {
+                    TestSummary summary;
+                    summary.wtp_id = name.param_id;
+                    summary.wtp_param_name = name.cleaned_param_name;
+                    summary.units = test.units;
+                    summary.test_num = test.test_num;
+                    summary.lo_limit = test.lo_limit;
+                    summary.hi_limit = test.hi_limit;
+                    summary.has_lo_limit = test.has_lo_limit;
+                    summary.has_hi_limit = test.has_hi_limit;
+                    test_summaries_.push_back(summary);
+                }
+                name.summary_slot = inserted.first->second;
+            }
+            test.param_id = name.param_id;
+            test.name_code = name.name_code;
+            test.units_code = dictionaries.units.encode(test.units);
+            test.summary_slot = name.summary_slot;
+            part_values += test.value_count;
+        }
+        part_offsets[row + 1] = part_offsets[row] + part_values;
     }
     
-    return (alarm_id.find("Pixel=") != std::string::npos) ||
-           (test_txt.find("Pixel=") != std::string::npos);
-}
-
-std::vector<double> UltraFastProcessor::parse_test_values(const STDFRecord& test_record) {
-    std::vector<double> values;
+    ConsoleLog::out() << "🚀 C++ part association: " << parts_.associated_tests() << " of " 
+              << processed_tests.size() << " selected tests in " << prr.size() << " part brackets = "
+              << part_offsets.back() << " measurements" << std::endl;
+    if (parts_.orphaned_tests() > 0) {
+        ConsoleLog::out() << "⚠️ " << parts_.orphaned_tests() << " tests outside any PIR..PRR bracket were skipped" << std::endl;
+    }
     
-    // Try to get result from different sources
-    std::string value_str;
+    summarize_tests(processed_tests, part_offsets);
     
-    // For PTR records, use result field
-    if (test_record.type == STDFRecordType::PTR && test_record.result != 0.0) {
-        values.push_back(test_record.result);
-        return values;
+    // Device IDs are assigned serially so they stay in PRR order; names and
+    // the file hash are copied into text_ for the dictionaries' views
+    std::vector<uint32_t> device_ids(prr.size());
+    std::vector<uint32_t> device_codes(prr.size());
+    uint32_t file_hash_code = dictionaries.file_hash.encode(text_.get(text_.intern(current_file_hash_)));
+    for (size_t row = 0; row < prr.size(); ++row) {
+        device_codes[row] = dictionaries.wld_device_dmc.encode(text_.get(text_.intern(store.str(prr.PART_ID[row]))));
+        device_ids[row] = ids().get_device_id(store.str(prr.PART_ID[row]));
     }
     
-    // For MPR or other records, try to parse from fields
-    auto get_field = [&](const std::string& key) -> std::string {
-        auto it = test_record.fields.find(key);
-        return (it != test_record.fields.end()) ? it->second : "";
+    // The part on PRR row `row`, clipped to output rows [first_out, last_out)
+    // of the file; file row r lands in batch row r - base
+    auto fill_part = [&](MeasurementBatch& measurements, size_t row, size_t first_out, size_t last_out, size_t base) {
+        uint32_t device_code = device_codes[row];
+        int32_t default_x = prr.X_COORD[row];
+        int32_t default_y = prr.Y_COORD[row];
+        uint32_t device_id = device_ids[row];
+        uint8_t test_flag = calculate_test_flag(prr.SOFT_BIN[row]);
+        
+        size_t position = part_offsets[row];
+        for (const uint32_t* it = parts_.begin(row); it != parts_.end(row) && position < last_out; ++it) {
+            const ProcessedTest& test = processed_tests[*it];
+            const double* values = test_values_.data() + test.value_offset;
+            // Clip the test's values to the requested rows
+            uint32_t first_value = position < first_out
+                ? static_cast<uint32_t>(std::min<size_t>(first_out - position, test.value_count)) : 0;
+            uint32_t last_value = static_cast<uint32_t>(std::min<size_t>(last_out - position, test.value_count));
+            size_t out = position + first_value - base;
+            for (uint32_t v = first_value; v < last_value; ++v, ++out) {
+                // 🚀 MACRO-DRIVEN: Initialize all fields using macro  
+                INIT_MEASUREMENT_ROW(measurements, out, device_code, device_id, test, values[v], test_flag, file_hash_code);
+            }
+            position += test.value_count;
+        }
     };
     
-    value_str = get_field("RTN_RSLT");
-    if (value_str.empty()) {
-        value_str = get_field("RESULT");
-    }
-    if (value_str.empty()) {
-        value_str = test_record.test_txt;
-    }
+    // Output rows [first_out, last_out), part by part in PRR order
+    auto fill_rows = [&](MeasurementBatch& measurements, size_t first_out, size_t last_out, size_t base) {
+        size_t row = std::upper_bound(part_offsets.begin(), part_offsets.end(), first_out) - part_offsets.begin() - 1;
+        for (; row < prr.size() && part_offsets[row] < last_out; ++row) {
+            fill_part(measurements, row, first_out, last_out, base);
+        }
+    };
     
-    if (value_str.empty()) {
-        values.push_back(0.0);
-        return values;
+    // Output rows [first_out, last_out) of one head/site lane's parts; lanes
+    // write disjoint rows and each touches only its own site's tests
+    auto fill_lane = [&](MeasurementBatch& measurements, size_t lane, size_t first_out, size_t last_out, size_t base) {
+        for (uint32_t row : parts_.lane_parts(lane)) {
+            if (part_offsets[row + 1] > first_out && part_offsets[row] < last_out) {
+                fill_part(measurements, row, first_out, last_out, base);
+            }
+        }
+    };
+    
+    const size_t total_rows = part_offsets.back();
+    if (batch_rows == 0) {
+        batch_rows = std::max<size_t>(1, total_rows);
     }
     
-    // Parse comma-separated values
-    if (value_str.find(',') != std::string::npos) {
-        std::stringstream ss(value_str);
-        std::string token;
-        
-        while (std::getline(ss, token, ',')) {
-            try {
-                // Trim whitespace
-                token.erase(0, token.find_first_not_of(" \t"));
-                token.erase(token.find_last_not_of(" \t") + 1);
-                
-                if (!token.empty()) {
-                    values.push_back(std::stod(token));
+    size_t created = 0;
+    for (size_t first = 0; first < total_rows; first += batch_rows) {
+        const size_t rows = std::min(batch_rows, total_rows - first);
+        MeasurementBatch measurements = dictionaries;
+        {
+            StageTimer batch_timer(InstrumentedStage::MEASUREMENT_GENERATION);
+            measurements.resize(rows);
+            
+            size_t thread_count = std::min(num_threads_, std::max<size_t>(1, rows / 4096));
+            if (thread_count <= 1) {
+                fill_rows(measurements, first, first + rows, first);
+            } else if (parts_.lane_count() >= thread_count) {
+                // Multi-site file: one task per head/site lane
+                std::vector<std::function<void()>> tasks;
+                for (size_t lane = 0; lane < parts_.lane_count(); ++lane) {
+                    tasks.emplace_back([&, lane]() { fill_lane(measurements, lane, first, first + rows, first); });
+                }
+                WorkStealingPool pool(thread_count);
+                pool.run(tasks);
+            } else {
+                std::vector<std::thread> workers;
+                size_t rows_per_thread = (rows + thread_count - 1) / thread_count;
+                for (size_t begin = first; begin < first + rows; begin += rows_per_thread) {
+                    size_t end = std::min(begin + rows_per_thread, first + rows);
+                    workers.emplace_back(fill_rows, std::ref(measurements), begin, end, first);
+                }
+                for (auto& worker : workers) {
+                    worker.join();
                 }
-            } catch (...) {
-                // Skip invalid values
             }
         }
-    } else {
-        try {
-            values.push_back(std::stod(value_str));
-        } catch (...) {
-            values.push_back(0.0);
+        
+        if (sort_output_) {
+            StageTimer sort_timer(InstrumentedStage::MEASUREMENT_SORT);
+            sort_measurements_by_key(measurements);
         }
-    }
-    
-    if (values.empty()) {
-        values.push_back(0.0);
-    }
-    
-    return values;
-}
-
-std::pair<int32_t, int32_t> UltraFastProcessor::extract_pixel_coordinates(const std::string& text) {
-    std::smatch match;
-    
-    if (std::regex_search(text, match, pixel_pattern_)) {
-        try {
-            int32_t row = std::stoi(match[1].str());  // R = Row = Y
-            int32_t col = std::stoi(match[2].str());  // C = Column = X
-            return {col, row}; // Return as (X, Y)
-        } catch (...) {
-            // Parsing failed
+        
+        created += rows;
+        if (!sink(measurements)) {
+            ConsoleLog::out() << "⚠️ C++ part association stopped by the consumer after " << created << " measurements" << std::endl;
+            return false;
         }
     }
     
-    return {0, 0}; // Default coordinates
-}
-
-std::string UltraFastProcessor::clean_param_name(const std::string& param_name) {
-    if (param_name.empty()) {
-        return param_name;
-    }
-    
-    std::string cleaned = param_name;
-    
-    // Remove ;Pixel=R##C## pattern
-    cleaned = std::regex_replace(cleaned, pixel_clean_pattern1_, "");
-    
-    // Remove Pixel=R##C##; at beginning
-    cleaned = std::regex_replace(cleaned, pixel_clean_pattern2_, "");
+    ConsoleLog::out() << "✅ C++ part association completed: " << created 
+              << " measurements created" << std::endl;
     
-    return cleaned;
+    return true;
 }
 
-std::string UltraFastProcessor::calculate_file_hash(const std::string& filepath) {
-    std::ifstream file(filepath, std::ios::binary);
-    if (!file) {
-        return "";
-    }
-    
-    // Simple hash calculation without OpenSSL dependency
-    std::hash<std::string> hasher;
-    std::string file_content;
-    
-    // Read file content
-    file.seekg(0, std::ios::end);
-    file_content.reserve(file.tellg());
-    file.seekg(0, std::ios::beg);
-    
-    file_content.assign((std::istreambuf_iterator<char>(file)),
-                        std::istreambuf_iterator<char>());
-    
-    // Generate hash
-    size_t hash_value = hasher(file_content);
-    
-    std::stringstream ss;
-    ss << std::hex << hash_value;
-    
-    return ss.str();
-}
+void UltraFastProcessor::summarize_tests(const std::vector<ProcessedTest>& processed_tests,
+                                         const std::vector<size_t>& part_offsets) {
+    const size_t part_count = part_offsets.size() - 1;
+    const size_t total_rows = part_offsets.back();
 
-std::vector<std::pair<std::string, uint32_t>> FastIDManager::get_new_device_mappings() const {
-    std::vector<std::pair<std::string, uint32_t>> new_mappings;
-    
-    for (const auto& pair : device_id_map_) {
-        // Only include devices that weren't in the existing set
-        if (existing_devices_.find(pair.first) == existing_devices_.end()) {
-            new_mappings.push_back(pair);
+    // Parts [first, last) into their own accumulators
+    auto accumulate = [&](size_t first, size_t last, std::vector<RunningStats>& stats) {
+        stats.assign(test_summaries_.size(), RunningStats());
+        for (size_t row = first; row < last; ++row) {
+            for (const uint32_t* it = parts_.begin(row); it != parts_.end(row); ++it) {
+                const ProcessedTest& test = processed_tests[*it];
+                stats[test.summary_slot].add(test_values_.data() + test.value_offset, test.value_count,
+                                             test.lo_limit, test.hi_limit, test.has_lo_limit, test.has_hi_limit,
+                                             (test.test_flg & 0x80) == 0);
+            }
         }
+    };
+
+    // Contiguous part ranges of about equal rows, merged in part order
+    size_t thread_count = std::min(num_threads_, std::max<size_t>(1, total_rows / 4096));
+    std::vector<std::vector<RunningStats>> partial(thread_count);
+    if (thread_count <= 1) {
+        accumulate(0, part_count, partial[0]);
+    } else {
+        std::vector<std::function<void()>> tasks;
+        size_t first = 0;
+        for (size_t t = 0; t < thread_count; ++t) {
+            size_t target = total_rows * (t + 1) / thread_count;
+            size_t last = t + 1 == thread_count ? part_count
+                : std::lower_bound(part_offsets.begin() + first, part_offsets.end() - 1, target) - part_offsets.begin();
+            tasks.emplace_back([&, first, last, t]() { accumulate(first, last, partial[t]); });
+            first = last;
+        }
+        WorkStealingPool pool(thread_count);
+        pool.run(tasks);
     }
-    
-    return new_mappings;
-}
 
-std::vector<std::pair<std::string, uint32_t>> FastIDManager::get_new_param_mappings() const {
-    std::vector<std::pair<std::string, uint32_t>> new_mappings;
-    
-    for (const auto& pair : param_id_map_) {
-        // Only include parameters that weren't in the existing set
-        if (existing_params_.find(pair.first) == existing_params_.end()) {
-            new_mappings.push_back(pair);
+    for (size_t slot = 0; slot < test_summaries_.size(); ++slot) {
+        for (const std::vector<RunningStats>& stats : partial) {
+            test_summaries_[slot].stats.merge(stats[slot]);
         }
     }
-    
-    return new_mappings;
+    std::sort(test_summaries_.begin(), test_summaries_.end(),
+              [](const TestSummary& a, const TestSummary& b) { return a.wtp_id < b.wtp_id; });
 }
 
-uint8_t UltraFastProcessor::calculate_test_flag(const STDFRecord& prr_record) {
-    auto get_field = [&](const std::string& key) -> std::string {
-        auto it = prr_record.fields.find(key);
-        return (it != prr_record.fields.end()) ? it->second : "";
-    };
-    
-    std::string bin_code = get_field("SOFT_BIN");
-    if (bin_code.empty()) {
-        bin_code = get_field("HARD_BIN");
-    }
-    
-    try {
-        return (std::stoi(bin_code) == 1) ? 1 : 0;
-    } catch (...) {
-        return 0;
-    }
-}
\ No newline at end of file
+uint8_t UltraFastProcessor::calculate_test_flag(uint16_t soft_bin) {
+    return (soft_bin == 1) ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+#include "../include/work_stealing_pool.h"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+
+static std::atomic<bool> g_numa_placement(true);
+
+void WorkStealingPool::set_numa_placement(bool enabled) {
+    g_numa_placement = enabled;
+}
+
+bool WorkStealingPool::get_numa_placement() {
+    return g_numa_placement;
+}
+
+WorkStealingPool::WorkStealingPool(size_t threads)
+    : WorkStealingPool(threads, CPUTopology::system()) {
+}
+
+WorkStealingPool::WorkStealingPool(size_t threads, const CPUTopology& topology)
+    : threads_(std::max<size_t>(1, threads)), topology_(topology), nodes_(threads_, -1),
+      victims_(threads_), queues_(threads_) {
+    if (g_numa_placement && topology_.node_count() > 1 && threads_ > 1) {
+        const int caller_node = topology_.current_thread_node();
+        for (size_t worker = 0; worker < threads_; ++worker) {
+            nodes_[worker] = caller_node >= 0 ? caller_node : static_cast<int>(worker % topology_.node_count());
+        }
+        if (caller_node < 0) {
+            nodes_[0] = -1;
+        }
+    }
+    for (size_t thief = 0; thief < threads_; ++thief) {
+        std::vector<size_t>& victims = victims_[thief];
+        for (size_t offset = 1; offset < threads_; ++offset) {
+            victims.push_back((thief + offset) % threads_);
+        }
+        std::stable_partition(victims.begin(), victims.end(),
+                              [&](size_t victim) { return nodes_[victim] == nodes_[thief]; });
+    }
+}
+
+bool WorkStealingPool::pop_own(size_t worker, size_t& task) {
+    std::lock_guard<std::mutex> lock(queues_[worker].mutex);
+    if (queues_[worker].tasks.empty()) return false;
+    task = queues_[worker].tasks.front();
+    queues_[worker].tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, size_t& task) {
+    for (size_t victim_worker : victims_[thief]) {
+        WorkerQueue& victim = queues_[victim_worker];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(size_t worker, const std::vector<std::function<void()>>& tasks) {
+    if (worker > 0 && nodes_[worker] >= 0) {
+        topology_.bind_current_thread(static_cast<size_t>(nodes_[worker]));
+    }
+
+    // No task is queued once run() has started, so empty everywhere means done
+    size_t task;
+    while (pop_own(worker, task) || steal(worker, task)) {
+        try {
+            tasks[task]();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex_);
+            if (!first_error_) first_error_ = std::current_exception();
+        }
+    }
+}
+
+void WorkStealingPool::run(const std::vector<std::function<void()>>& tasks) {
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        queues_[i % threads_].tasks.push_back(i);
+    }
+    execute(tasks);
+}
+
+void WorkStealingPool::run(const std::vector<std::function<void()>>& tasks, const std::vector<uint64_t>& costs) {
+    std::vector<size_t> order(tasks.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto cost = [&costs](size_t task) { return task < costs.size() ? costs[task] : 0; };
+    std::stable_sort(order.begin(), order.end(), [&cost](size_t a, size_t b) { return cost(a) > cost(b); });
+
+    std::vector<uint64_t> load(threads_, 0);
+    for (size_t task : order) {
+        const size_t worker = static_cast<size_t>(std::min_element(load.begin(), load.end()) - load.begin());
+        queues_[worker].tasks.push_back(task);
+        load[worker] += std::max<uint64_t>(1, cost(task));
+    }
+    execute(tasks);
+}
+
+void WorkStealingPool::execute(const std::vector<std::function<void()>>& tasks) {
+    first_error_ = nullptr;
+    size_t worker_count = std::min(threads_, tasks.size());
+    std::vector<std::thread> workers;
+    for (size_t worker = 1; worker < worker_count; ++worker) {
+        workers.emplace_back(&WorkStealingPool::work, this, worker, std::cref(tasks));
+    }
+    if (worker_count > 0) {
+        work(0, tasks);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    if (first_error_) {
+        std::rethrow_exception(first_error_);
+    }
+}
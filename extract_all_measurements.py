@@ -111,6 +111,7 @@ class MeasurementExtractor:
         processed_devices = 0
         total_measurements_created = 0
         
+        device_data = []
         for prr in prr_records:
             prr_fields = prr.get('fields', {})
             
@@ -127,13 +128,28 @@ class MeasurementExtractor:
             else:
                 device_id = self.devices[device_dmc]
             
-            prr_data = {
+            device_data.append({
                 'device_dmc': device_dmc,
                 'device_id': device_id,
                 'bin_code': bin_code,
                 'default_x_pos': default_x_pos,
                 'default_y_pos': default_y_pos
-            }
+            })
+        
+        # Pre-compute the fields of every device in one C++ call: the MIR
+        # fields once, the PRR ones as columns
+        try:
+            batch = stdf_parser_cpp.precompute_measurement_fields_batch(mir_info, device_data)
+            for part, prr_data in enumerate(device_data):
+                prr_data['precomputed'] = dict(batch['constants'])
+                for field, column in batch['columns'].items():
+                    prr_data['precomputed'][field] = column[part]
+            print(f"✅ Using C++ batch pre-computation for {batch['count']} devices")
+        except Exception as e:
+            print(f"⚠️ Warning: C++ batch precompute failed ({e}), computing per test")
+        
+        for prr_data in device_data:
+            device_dmc = prr_data['device_dmc']
             
             device_measurements_before = len(self.measurements)
             
@@ -247,38 +263,40 @@ class MeasurementExtractor:
         else:
             self.debug_single_tests += 1
         
-        # OPTION 1: Pre-compute expensive fields in C++ (computed ONCE per test, not per measurement)
-        try:
-            import stdf_parser_cpp
+        # OPTION 1: Pre-compute expensive fields in C++ (computed ONCE per device, not per measurement)
+        precomputed_fields = prr_data.get('precomputed')
+        if precomputed_fields is None:
+            try:
+                import stdf_parser_cpp
             
-            # C++ pre-computes all expensive fields ONCE per test (not 10 times per measurement)
-            precomputed_fields = stdf_parser_cpp.precompute_measurement_fields(mir_info, prr_data)
+                # C++ pre-computes all expensive fields ONCE per test (not 10 times per measurement)
+                precomputed_fields = stdf_parser_cpp.precompute_measurement_fields(mir_info, prr_data)
             
-            # Success indicator (only show for first few tests)
-            if self.debug_comma_tests + self.debug_single_tests < 3:
-                print(f"✅ Using C++ pre-computation for test #{self.debug_comma_tests + self.debug_single_tests + 1}")
+                # Success indicator (only show for first few tests)
+                if self.debug_comma_tests + self.debug_single_tests < 3:
+                    print(f"✅ Using C++ pre-computation for test #{self.debug_comma_tests + self.debug_single_tests + 1}")
             
-        except Exception as e:
-            # Fallback: compute in Python if C++ fails
-            print(f"⚠️ Warning: C++ precompute failed ({e}), using Python fallback computation")
-            precomputed_fields = {
-                'WFI_FACILITY': mir_info.get('facility', ''),
-                'WFI_OPERATION': mir_info.get('operation', ''),
-                'WL_LOT_NAME': mir_info.get('lot_name', ''),
-                'WLD_DEVICE_DMC': prr_data['device_dmc'],
-                'WLD_PHOENIX_ID': '',
-                'WLD_LATEST': 'Y',
-                'WLD_BIN_CODE': prr_data['bin_code'],
-                'WLD_BIN_DESC': 'PASS' if prr_data['bin_code'] and prr_data['bin_code'].isdigit() and int(prr_data['bin_code']) == 1 else 'FAIL',
-                'WMP_PROG_NAME': mir_info.get('prog_name', ''),
-                'WMP_PROG_VERSION': mir_info.get('prog_version', ''),
-                'WPTM_CREATED_DATE': mir_info.get('start_time', ''),
-                'SFT_NAME': 'STDF_CPP',
-                'SFT_GROUP': 'STDF_CPP',
-                'WFI_EQUIPMENT': mir_info.get('equipment', ''),
-                'TEST_FLAG': prr_data['bin_code'] and prr_data['bin_code'].isdigit() and int(prr_data['bin_code']) == 1,
-                'WLD_CREATED_DATE': mir_info.get('start_time', ''),
-            }
+            except Exception as e:
+                # Fallback: compute in Python if C++ fails
+                print(f"⚠️ Warning: C++ precompute failed ({e}), using Python fallback computation")
+                precomputed_fields = {
+                    'WFI_FACILITY': mir_info.get('facility', ''),
+                    'WFI_OPERATION': mir_info.get('operation', ''),
+                    'WL_LOT_NAME': mir_info.get('lot_name', ''),
+                    'WLD_DEVICE_DMC': prr_data['device_dmc'],
+                    'WLD_PHOENIX_ID': '',
+                    'WLD_LATEST': 'Y',
+                    'WLD_BIN_CODE': prr_data['bin_code'],
+                    'WLD_BIN_DESC': 'PASS' if prr_data['bin_code'] and prr_data['bin_code'].isdigit() and int(prr_data['bin_code']) == 1 else 'FAIL',
+                    'WMP_PROG_NAME': mir_info.get('prog_name', ''),
+                    'WMP_PROG_VERSION': mir_info.get('prog_version', ''),
+                    'WPTM_CREATED_DATE': mir_info.get('start_time', ''),
+                    'SFT_NAME': 'STDF_CPP',
+                    'SFT_GROUP': 'STDF_CPP',
+                    'WFI_EQUIPMENT': mir_info.get('equipment', ''),
+                    'TEST_FLAG': prr_data['bin_code'] and prr_data['bin_code'].isdigit() and int(prr_data['bin_code']) == 1,
+                    'WLD_CREATED_DATE': mir_info.get('start_time', ''),
+                }
 
         # Create measurements for EACH value/result using pre-computed fields
         for i, float_value in enumerate(measurement_values):
@@ -551,28 +551,19 @@ class STDFProcessor:
         return x_pos if x_pos is not None else default_x, y_pos if y_pos is not None else default_y
     
     def _parse_pixel_coords(self, text):
-        """Parse Pixel=R##C## pattern (from original)"""
+        """Parse Pixel=R##C## pattern (same native scanner as the C++ pipeline)"""
         if not text or 'Pixel=' not in text:
             return None, None
         
-        import re
-        match = re.search(r'Pixel=R(\d+)C(\d+)', text)
-        if match:
-            row = int(match.group(1))  # R = Row = Y
-            col = int(match.group(2))  # C = Column = X  
-            return col, row  # Return as (X, Y)
-        
-        return None, None
+        _, col, row = stdf_parser_cpp.parse_pixel_name(text)
+        return col, row  # (X, Y), None without a tag
     
     def _clean_param_name(self, param_name):
-        """Clean parameter name (from original)"""
+        """Clean parameter name (same native scanner as the C++ pipeline)"""
         if not param_name:
             return param_name
         
-        import re
-        cleaned = re.sub(r';Pixel=R\d+C\d+', '', param_name)
-        cleaned = re.sub(r'^Pixel=R\d+C\d+;', '', cleaned)
-        return cleaned
+        return stdf_parser_cpp.clean_param_name(param_name)
     
     def _parse_test_values(self, test_txt):
         """Parse test values (from original)"""
@@ -586,12 +577,8 @@ class STDFProcessor:
         return [test_txt]
     
     def _is_pixel_test(self, alarm_id, test_txt):
-        """Check if test involves pixels (from original)"""
-        if alarm_id and 'Pixel=' in alarm_id:
-            return True
-        if test_txt and 'Pixel=' in test_txt:
-            return True
-        return False
+        """Check if test involves pixels (same native check as the C++ pipeline)"""
+        return stdf_parser_cpp.is_pixel_test(alarm_id or None, test_txt or None)
     
     def _safe_float(self, value):
         """Safely convert to float (from original)"""
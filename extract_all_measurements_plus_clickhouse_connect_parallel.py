@@ -153,7 +153,7 @@ class SharedIDManager:
 class STDFProcessor:
     """EXACT same processor as single file version with optional shared ID manager"""
     
-    def __init__(self, enable_clickhouse=True, batch_size=10000, shared_id_manager=None):
+    def __init__(self, enable_clickhouse=True, batch_size=10000, shared_id_manager=None, id_snapshot_dir=None):
         """
         Initialize the STDF processor - EXACTLY like single file version
         
@@ -161,9 +161,12 @@ class STDFProcessor:
             enable_clickhouse: Whether to enable ClickHouse push functionality
             batch_size: Batch size for ClickHouse operations
             shared_id_manager: Optional shared ID manager for parallel processing
+            id_snapshot_dir: Optional directory of memory-mapped ID snapshots; only mappings
+                newer than the snapshots are then read from ClickHouse
         """
         self.enable_clickhouse = enable_clickhouse
         self.batch_size = batch_size
+        self.id_snapshot_dir = id_snapshot_dir
         self.measurements = []
         self.devices = {}
         self.parameters = {}
@@ -337,10 +340,21 @@ class STDFProcessor:
                 password=actual_password
             )
             
+            # With snapshots only the IDs assigned since they were written are read
+            min_device_id = min_param_id = None
+            if self.id_snapshot_dir:
+                snapshot = stdf_parser_cpp.set_id_snapshot(self.id_snapshot_dir)
+                if snapshot['exists']:
+                    min_device_id, min_param_id = snapshot['max_device_id'], snapshot['max_param_id']
+                    print(f"📊 ID snapshots: {snapshot['devices']:,} devices, {snapshot['params']:,} parameters")
+            
             # Load device mappings
             device_mappings = []
             try:
-                device_results = client.execute("SELECT wld_device_dmc, wld_id FROM device_mapping")
+                device_query = "SELECT wld_device_dmc, wld_id FROM device_mapping"
+                if min_device_id is not None:
+                    device_query += f" WHERE wld_id > {int(min_device_id)}"
+                device_results = client.execute(device_query)
                 device_mappings = [(device_dmc, device_id) for device_dmc, device_id in device_results]
                 print(f"📊 Loaded {len(device_mappings)} existing device mappings")
             except Exception as e:
@@ -350,13 +364,21 @@ class STDFProcessor:
             # Load parameter mappings
             param_mappings = []
             try:
-                param_results = client.execute("SELECT wtp_param_name, wtp_id FROM parameter_info")
+                param_query = "SELECT wtp_param_name, wtp_id FROM parameter_info"
+                if min_param_id is not None:
+                    param_query += f" WHERE wtp_id > {int(min_param_id)}"
+                param_results = client.execute(param_query)
                 param_mappings = [(param_name, param_id) for param_name, param_id in param_results]
                 print(f"📊 Loaded {len(param_mappings)} existing parameter mappings")
             except Exception as e:
                 print(f"⚠️ No existing parameter mappings found: {e}")
                 param_mappings = []
             
+            # Fold the delta into the snapshots: every later run starts from them
+            if self.id_snapshot_dir and (device_mappings or param_mappings or min_device_id is None):
+                stdf_parser_cpp.write_id_snapshot(self.id_snapshot_dir, device_mappings, param_mappings)
+                return [], []
+            
             return device_mappings, param_mappings
             
         except Exception as e:
@@ -778,10 +800,15 @@ class ParallelSTDFProcessor:
     # Class-level ClickHouse lock for sequential push (shared across all instances)
     _clickhouse_lock = threading.Lock()
     
-    def __init__(self, max_workers=4, batch_size=10000, enable_clickhouse=True):
+    def __init__(self, max_workers=4, batch_size=10000, enable_clickhouse=True, manifest_path=None,
+                 native_pipeline=None):
         self.max_workers = max_workers
         self.batch_size = batch_size  
         self.enable_clickhouse = enable_clickhouse
+        self.manifest_path = manifest_path  # Local record of ingested files (skips re-scans)
+        # Optional dict (http_port, insert_workers, queue_depth, block_rows): Phase 2 then decodes
+        # and inserts natively through a bounded queue instead of caching every file for a mega-push
+        self.native_pipeline = native_pipeline
         
         # Two-phase approach - no shared manager needed
         self.global_device_mappings = {}  # All devices from all files
@@ -795,6 +822,11 @@ class ParallelSTDFProcessor:
         print(f"Max workers: {max_workers}")
         print(f"Batch size: {batch_size:,}")
         print(f"ClickHouse: {'✅ Enabled' if enable_clickhouse else '❌ Disabled'}")
+        if manifest_path:
+            print(f"Manifest: {manifest_path}")
+        if native_pipeline:
+            print(f"Native pipeline: queue depth {native_pipeline['queue_depth']}, "
+                  f"{native_pipeline['block_rows']:,} rows per block, {native_pipeline['insert_workers']} insert workers")
     
     def _is_pixel_test(self, param_name, test_txt):
         """Check if test involves pixels - same as STDFProcessor"""
@@ -853,8 +885,22 @@ class ParallelSTDFProcessor:
         all_devices = set()
         all_parameters = set()
         
+        # FAST DISCOVERY: C++ reads only PART_IDs and test names, all files in parallel.
+        # Phase 2 then processes each file once; nothing is cached here.
+        native_discovery = hasattr(stdf_parser_cpp, 'discover_devices_and_parameters')
+        if native_discovery:
+            discovery = stdf_parser_cpp.discover_devices_and_parameters(list(stdf_files), self.max_workers)
+            for file_stats in discovery['files']:
+                if file_stats['success']:
+                    print(f"🔍 {os.path.basename(file_stats['path'])}: Devices: {file_stats['devices']}, "
+                          f"Parameters: {file_stats['parameters']} ({file_stats['discovery_time']:.2f}s)")
+                else:
+                    print(f"⚠️ Discovery error: {file_stats['path']}: {file_stats['error']}")
+            all_devices.update(discovery['devices'])
+            all_parameters.update(discovery['parameters'])
+        
         # PROPER DISCOVERY: Use same C++ processing as single file version
-        for i, stdf_file in enumerate(stdf_files, 1):
+        for i, stdf_file in enumerate([] if native_discovery else stdf_files, 1):
             print(f"🔍 Discovery {i}/{len(stdf_files)}: {os.path.basename(stdf_file)}")
             try:
                 # Use SAME C++ processing as single file version for proper parameter extraction
@@ -1003,6 +1049,14 @@ class ParallelSTDFProcessor:
         if not stdf_files:
             return []
         
+        # Skip files the manifest already lists as ingested (stat only, no hashing)
+        if self.manifest_path:
+            pending = stdf_parser_cpp.filter_unprocessed_files(self.manifest_path, stdf_files)
+            print(f"📒 Manifest: {len(stdf_files) - len(pending)} of {len(stdf_files)} files already ingested")
+            stdf_files = pending
+            if not stdf_files:
+                return []
+        
         total_start_time = time.time()
         
         # ============================================================================
@@ -1027,6 +1081,10 @@ class ParallelSTDFProcessor:
         # ============================================================================
         # PHASE 2: PARALLEL PROCESSING (Race-condition free with pre-computed IDs)
         # ============================================================================
+        if self.native_pipeline and self.enable_clickhouse and clickhouse_host:
+            return self._process_with_native_pipeline(stdf_files, total_start_time, clickhouse_host,
+                                                      clickhouse_database, clickhouse_user, clickhouse_password)
+        
         print(f"\n🚀 PHASE 2: PARALLEL PROCESSING - {len(stdf_files)} files with {self.max_workers} workers...")
         phase2_start = time.time()
         
@@ -1157,6 +1215,11 @@ class ParallelSTDFProcessor:
                     for result in results:
                         result['success'] = True
                         result['clickhouse_time'] = mega_push_time / len(results)  # Distribute time across files
+                    
+                    if self.manifest_path:
+                        ingested = [result['file'] for result in results]
+                        hashes = [self.cached_results.get(f, {}).get('file_hash', '') for f in ingested]
+                        stdf_parser_cpp.record_ingested_files(self.manifest_path, ingested, hashes)
                 else:
                     print(f"❌ MEGA-PUSH FAILED")
                     
@@ -1199,6 +1262,68 @@ class ParallelSTDFProcessor:
         
         return results
     
+    def _process_with_native_pipeline(self, stdf_files, total_start_time, clickhouse_host,
+                                      clickhouse_database, clickhouse_user, clickhouse_password):
+        """PHASE 2 (native): decode workers feed insert workers through a bounded block queue.
+        
+        Memory stays at queue_depth blocks however many files there are; when ClickHouse is slow
+        the queue fills and decoding waits. Rows go over the HTTP interface (http_port); the
+        measurements table must give wptm_created_date a default (see setup_clickhouse_schema).
+        """
+        options = self.native_pipeline
+        print(f"\n🚀 PHASE 2: NATIVE PIPELINE - {len(stdf_files)} files, {self.max_workers} decode / "
+              f"{options['insert_workers']} insert workers...")
+        
+        connection = {
+            'host': clickhouse_host,
+            'port': options['http_port'],
+            'database': clickhouse_database or 'default',
+            'user': clickhouse_user or 'default',
+            'password': clickhouse_password or '',
+        }
+        columns = ['wld_id', 'wtp_id', 'wp_pos_x', 'wp_pos_y', 'wptm_value', 'test_flag', 'segment', 'file_hash']
+        
+        try:
+            summary = stdf_parser_cpp.insert_stdf_files_to_clickhouse(
+                stdf_files, 'measurements', connection, columns,
+                list(self.global_device_mappings.items()), list(self.global_param_mappings.items()),
+                'native', self.max_workers, options['insert_workers'], options['queue_depth'],
+                options['block_rows'], self.manifest_path
+            )
+        except Exception as e:
+            print(f"❌ Native pipeline failed: {e}")
+            return []
+        
+        if summary['new_device_mappings'] or summary['new_param_mappings']:
+            print(f"⚠️ {len(summary['new_device_mappings'])} devices / {len(summary['new_param_mappings'])} "
+                  f"parameters were not found in discovery; their mapping rows are not inserted")
+        if not summary['success']:
+            print(f"❌ Native pipeline stopped: {summary['error']}")
+        
+        results = [{
+            'file': file_stats['path'],
+            'measurements': file_stats['rows_inserted'],
+            'extract_time': file_stats['parsing_time'] + file_stats['processing_time'],
+            'clickhouse_time': 0,
+            'total_time': 0,
+            'success': file_stats['success'],
+        } for file_stats in summary['files']]
+        
+        total_time = time.time() - total_start_time
+        rows = summary['rows_inserted']
+        print(f"\n📈 NATIVE PIPELINE SUMMARY:")
+        print(f"=========================================================")
+        print(f"Files processed:      {sum(1 for r in results if r['success'])} of {len(results)}")
+        print(f"Total measurements:   {rows:,} in {summary['blocks_inserted']} blocks")
+        print(f"Pipeline time:        {summary['total_time']:.2f}s")
+        print(f"Decode wait (backpressure): {summary['backpressure_time']:.2f}s, "
+              f"peak queue {summary['peak_queue_depth']}/{options['queue_depth']}")
+        print(f"Total time:           {total_time:.2f}s")
+        if total_time > 0:
+            print(f"Overall throughput:   {rows / total_time:.0f} measurements/sec")
+        
+        return results
+    
     def _process_single_file_phase2(self, processor, stdf_file, clickhouse_host, clickhouse_port,
                                    clickhouse_database, clickhouse_user, clickhouse_password, cached_result=None):
         """Process single file in Phase 2 with pre-computed ID mappings (no DB conflicts)"""
@@ -1258,6 +1383,15 @@ def main():
     parser.add_argument('--ch-user', type=str, default='default', help='ClickHouse username')
     parser.add_argument('--ch-password', type=str, default='', help='ClickHouse password')
     parser.add_argument('--batch-size', type=int, default=10000, help='Batch size for processing')
+    parser.add_argument('--manifest', type=str, help='Local manifest of ingested files; listed, unchanged files are skipped')
+    parser.add_argument('--id-snapshot', type=str,
+                        help='Directory of memory-mapped ID snapshots; only newer mappings are read from ClickHouse')
+    parser.add_argument('--native-pipeline', action='store_true',
+                        help='Decode and insert natively over HTTP through a bounded block queue (flat memory)')
+    parser.add_argument('--ch-http-port', type=int, default=8123, help='ClickHouse HTTP port (native pipeline)')
+    parser.add_argument('--insert-workers', type=int, default=2, help='Concurrent INSERTs (native pipeline)')
+    parser.add_argument('--queue-depth', type=int, default=4, help='Blocks buffered between decode and insert (native pipeline)')
+    parser.add_argument('--block-rows', type=int, default=1000000, help='Rows per INSERT block (native pipeline)')
     
     args = parser.parse_args()
     
@@ -1280,7 +1414,14 @@ def main():
         processor = ParallelSTDFProcessor(
             max_workers=args.workers,
             batch_size=args.batch_size, 
-            enable_clickhouse=args.push_clickhouse
+            enable_clickhouse=args.push_clickhouse,
+            manifest_path=args.manifest,
+            native_pipeline={
+                'http_port': args.ch_http_port,
+                'insert_workers': args.insert_workers,
+                'queue_depth': args.queue_depth,
+                'block_rows': args.block_rows,
+            } if args.native_pipeline else None
         )
         
         results = processor.process_directory(
@@ -1296,7 +1437,8 @@ def main():
         # Single file processing (EXACT same as original)
         processor = STDFProcessor(
             enable_clickhouse=args.push_clickhouse,
-            batch_size=args.batch_size
+            batch_size=args.batch_size,
+            id_snapshot_dir=args.id_snapshot
         )
         
         result = processor.process_file(
@@ -5,11 +5,53 @@ import os
 import sys
 import sysconfig
 
+# bzip2 is optional for pipelined decompression of .stdf.bz2 files
+have_bzlib = any(os.path.exists(os.path.join(d, 'bzlib.h')) for d in ['/usr/include', '/usr/local/include'])
+
 # Define the extension module
 stdf_parser_extension = Extension(
     'stdf_parser_cpp',
     sources=[
         'cpp/src/stdf_parser.cpp',
+        'cpp/src/stdf_binary_parser.cpp',
+        'cpp/src/mapped_file.cpp',
+        'cpp/src/columnar_store.cpp',
+        'cpp/src/columnar_cache.cpp',
+        'cpp/src/test_definition_cache.cpp',
+        'cpp/src/part_association.cpp',
+        'cpp/src/test_statistics.cpp',
+        'cpp/src/bin_summary.cpp',
+        'cpp/src/pixel_name.cpp',
+        'cpp/src/test_selection_filter.cpp',
+        'cpp/src/numeric_convert.cpp',
+        'cpp/src/byte_order.cpp',
+        'cpp/src/measurement_batch.cpp',
+        'cpp/src/measurement_sort.cpp',
+        'cpp/src/measurement_spool.cpp',
+        'cpp/src/arrow_export.cpp',
+        'cpp/src/device_discovery.cpp',
+        'cpp/src/work_stealing_pool.cpp',
+        'cpp/src/file_schedule.cpp',
+        'cpp/src/batch_ingest_engine.cpp',
+        'cpp/src/clickhouse_encoder.cpp',
+        'cpp/src/sharded_id_map.cpp',
+        'cpp/src/id_map_snapshot.cpp',
+        'cpp/src/stream_hash.cpp',
+        'cpp/src/ingest_manifest.cpp',
+        'cpp/src/measurement_stream.cpp',
+        'cpp/src/insert_pipeline.cpp',
+        'cpp/src/insert_spool.cpp',
+        'cpp/src/file_prefetcher.cpp',
+        'cpp/src/ingest_daemon.cpp',
+        'cpp/src/console_log.cpp',
+        'cpp/src/instrumentation.cpp',
+        'cpp/src/record_type_filter.cpp',
+        'cpp/src/stdf_record_view.cpp',
+        'cpp/src/pin_fail_map.cpp',
+        'cpp/src/stdf_tail_reader.cpp',
+        'cpp/src/cpu_topology.cpp',
+        'cpp/src/stdf_record_index.cpp',
+        'cpp/src/decompressing_reader.cpp',
         'cpp/src/dynamic_field_extractor.cpp',
         'cpp/src/ultra_fast_processor.cpp',
         'cpp/src/python_bridge.cpp'
@@ -27,16 +69,19 @@ stdf_parser_extension = Extension(
     libraries=[
         'stdf',  # libstdf library
         'z',     # zlib (required by libstdf)
-    ],
+    ] + (['bz2'] if have_bzlib else []),
+    define_macros=[('HAVE_BZLIB', '1')] if have_bzlib else [],
     language='c++',
     extra_compile_args=[
         '-std=c++17',  # Updated for X-Macros
         '-O3',  # Optimization
         '-Wall',
         '-Wextra',
+        '-pthread',
     ],
     extra_link_args=[
         '-std=c++17',
+        '-pthread',
     ],
 )
 
@@ -0,0 +1,109 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/arrow_export.h"
+#include <cstring>
+#include <iostream>
+
+struct ExportedFile {
+    UltraFastProcessor processor;
+    MeasurementBatch batch;
+};
+
+// Dictionary child: row's string through the Arrow buffers
+static std::string_view arrow_string(const ArrowArray& column, int64_t row) {
+    const int32_t* codes = static_cast<const int32_t*>(column.buffers[1]);
+    const int32_t* offsets = static_cast<const int32_t*>(column.dictionary->buffers[1]);
+    const char* text = static_cast<const char*>(column.dictionary->buffers[2]);
+    int32_t code = codes[row];
+    return std::string_view(text + offsets[code], static_cast<size_t>(offsets[code + 1] - offsets[code]));
+}
+
+static bool named(const ArrowSchema& field, const char* expected) {
+    return std::strcmp(field.name, expected) == 0;
+}
+
+// Numeric columns point at the batch's values
+template<typename T>
+static bool same_column(const ArrowSchema& field, const ArrowArray& column, const MeasurementColumn<T>& values) {
+    return field.dictionary == nullptr && column.dictionary == nullptr && column.n_buffers == 2 &&
+           column.length == static_cast<int64_t>(values.values.size()) && column.buffers[1] == values.values.data();
+}
+
+// String columns point at the codes and carry a utf8 dictionary
+static bool same_column(const ArrowSchema& field, const ArrowArray& column,
+                        const MeasurementColumn<std::string_view>& values) {
+    if (std::strcmp(field.format, "i") != 0 || !field.dictionary || std::strcmp(field.dictionary->format, "u") != 0 ||
+        !column.dictionary || column.dictionary->length != static_cast<int64_t>(values.dictionary.size()) ||
+        column.length != static_cast<int64_t>(values.codes.size()) || column.buffers[1] != values.codes.data()) {
+        return false;
+    }
+    for (int64_t row = 0; row < column.length; row += 997) {
+        if (arrow_string(column, row) != values[row]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// The C Data Interface structures must describe the batch exactly, in place
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Arrow Export Test ===" << std::endl;
+
+    auto file = std::make_shared<ExportedFile>();
+    file->batch = file->processor.process_stdf_file_to_batch(test_file);
+    const MeasurementBatch& batch = file->batch;
+    std::shared_ptr<const void> owner = file;
+    file.reset();
+
+    ArrowSchema schema;
+    ArrowBatchExporter::export_schema(&schema);
+    ArrowArray array;
+    if (!ArrowBatchExporter::export_array(owner, batch, &array) || batch.size() == 0) {
+        std::cout << "FAIL: export failed" << std::endl;
+        return 1;
+    }
+
+    if (std::strcmp(schema.format, "+s") != 0 || schema.n_children != array.n_children ||
+        array.length != static_cast<int64_t>(batch.size()) || array.n_buffers != 1 || array.null_count != 0) {
+        std::cout << "FAIL: record batch layout" << std::endl;
+        return 1;
+    }
+
+    int64_t index = 0;
+    int64_t units_index = -1;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        if (!same_column(*schema.children[index], *array.children[index], batch.name) || \
+            !named(*schema.children[index], #name)) { \
+            std::cout << "FAIL: column " << #name << " does not match the batch" << std::endl; \
+            return 1; \
+        } \
+        units_index = named(*schema.children[index], "units") ? index : units_index; \
+        ++index;
+    #include "cpp/include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+
+    // Every node holds the owner; a moved-out child outlives its parent
+    long held = owner.use_count();
+    ArrowArray moved = *array.children[units_index];
+    array.children[units_index]->release = nullptr;
+    array.release(&array);
+    schema.release(&schema);
+    if (array.release || schema.release || owner.use_count() >= held || owner.use_count() < 2 ||
+        arrow_string(moved, 0) != batch.units[0]) {
+        std::cout << "FAIL: release did not follow the C Data Interface rules" << std::endl;
+        return 1;
+    }
+    moved.release(&moved);
+    if (owner.use_count() != 1) {
+        std::cout << "FAIL: exported structures still hold the batch" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   " << batch.size() << " rows, " << index << " columns exported in place" << std::endl;
+    std::cout << "PASS: Arrow C Data Interface export matches the batch" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "cpp/include/batch_ingest_engine.h"
+#include "cpp/include/work_stealing_pool.h"
+#include <iostream>
+#include <atomic>
+#include <stdexcept>
+
+static bool check_pool() {
+    // Uneven tasks: every one must run exactly once
+    std::vector<std::atomic<int>> runs(37);
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        tasks.emplace_back([&runs, i]() {
+            volatile size_t spin = 0;
+            for (size_t k = 0; k < (i % 5) * 100000; ++k) spin = spin + k;
+            runs[i]++;
+        });
+    }
+    WorkStealingPool pool(4);
+    pool.run(tasks);
+    for (auto& count : runs) {
+        if (count != 1) {
+            std::cout << "FAIL: task ran " << count << " times" << std::endl;
+            return false;
+        }
+    }
+
+    // A throwing task surfaces from run() after the rest have finished
+    std::atomic<int> finished{0};
+    std::vector<std::function<void()>> failing = {
+        [&]() { finished++; }, []() { throw std::runtime_error("boom"); }, [&]() { finished++; },
+    };
+    try {
+        pool.run(failing);
+        std::cout << "FAIL: task exception was swallowed" << std::endl;
+        return false;
+    } catch (const std::runtime_error&) {
+    }
+    if (finished != 2) {
+        std::cout << "FAIL: pool stopped early after an exception" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Batch Ingest Test ===" << std::endl;
+
+    if (!check_pool()) {
+        return 1;
+    }
+
+    UltraFastProcessor single;
+    single.set_file_hash("hash");
+    MeasurementBatch expected = single.process_stdf_file_to_batch(test_file);
+
+    BatchIngestEngine engine;
+    engine.set_num_threads(3);
+    engine.set_file_hashes({"hash", "", "hash"});
+    bool all_ok = engine.process_files({test_file, "does_not_exist.stdf", test_file});
+
+    const auto& stats = engine.file_stats();
+    const MeasurementBatch& merged = engine.measurements();
+    if (all_ok || stats.size() != 3 || !stats[0].success || stats[1].success || !stats[2].success ||
+        stats[1].measurements != 0 || engine.get_last_error().empty()) {
+        std::cout << "FAIL: per-file success/error reporting" << std::endl;
+        return 1;
+    }
+    if (merged.size() != 2 * expected.size() || stats[2].row_offset != expected.size()) {
+        std::cout << "FAIL: merged " << merged.size() << " rows, expected 2 x " << expected.size() << std::endl;
+        return 1;
+    }
+
+    // Both copies of the file must match the single-file run; the shared
+    // manager gives both the same IDs
+    for (size_t copy = 0; copy < 2; ++copy) {
+        size_t base = stats[copy * 2].row_offset;
+        for (size_t i = 0; i < expected.size(); ++i) {
+            bool same = true;
+            #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+                same = same && merged.name[base + i] == expected.name[i];
+            #include "cpp/include/measurement_fields.def"
+            #undef MEASUREMENT_FIELD
+            if (!same) {
+                std::cout << "FAIL: file " << copy * 2 << " row " << i << " differs" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    if (merged.wtp_param_name.dictionary.size() != expected.wtp_param_name.dictionary.size() ||
+        engine.id_manager().get_new_param_mappings().size() != expected.wtp_param_name.dictionary.size()) {
+        std::cout << "FAIL: dictionaries/IDs were not shared across files" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: batch ingest merges files with shared IDs" << std::endl;
+    return 0;
+}
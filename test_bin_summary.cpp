@@ -0,0 +1,122 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/bin_summary.h"
+#include <cstring>
+#include <iostream>
+#include <set>
+
+static void add_prr(STDFColumnarStore& store, uint8_t site, uint16_t hard_bin, uint16_t soft_bin, uint32_t record_index) {
+    rec_prr prr;
+    std::memset(&prr, 0, sizeof(prr));
+    prr.HEAD_NUM = 1;
+    prr.SITE_NUM = site;
+    prr.HARD_BIN = hard_bin;
+    prr.SOFT_BIN = soft_bin;
+    store.append(prr, record_index);
+}
+
+static void add_hbr(STDFColumnarStore& store, uint8_t head, uint8_t site, uint16_t bin, uint32_t count, char pf,
+                    uint32_t record_index) {
+    rec_hbr hbr;
+    std::memset(&hbr, 0, sizeof(hbr));
+    hbr.HEAD_NUM = head;
+    hbr.SITE_NUM = site;
+    hbr.HBIN_NUM = bin;
+    hbr.HBIN_CNT = count;
+    hbr.HBIN_PF = pf;
+    store.append(hbr, record_index);
+}
+
+static const BinCount* find_bin(const BinSummary& summary, bool soft, uint8_t head, uint8_t site, uint16_t bin) {
+    for (const BinCount& count : summary.bins()) {
+        if (count.soft == soft && count.head_num == head && count.site_num == site && count.bin_num == bin) {
+            return &count;
+        }
+    }
+    return nullptr;
+}
+
+// PRR bin counts per site and per file, reconciled with HBR/SBR
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Bin Summary Test ===" << std::endl;
+
+    // Site 0: two good parts and one hard bin 5; site 1: one good part.
+    // The summary HBR says hard bin 1 had 4 parts (one too many) and lists
+    // a bin no part reached.
+    STDFColumnarStore store;
+    add_prr(store, 0, 1, 1, 1);
+    add_prr(store, 1, 1, 1, 2);
+    add_prr(store, 0, 5, 12, 3);
+    add_prr(store, 0, 1, 1, 4);
+    add_hbr(store, 255, 7, 1, 4, 'P', 5);
+    add_hbr(store, 255, 7, 5, 1, 'F', 6);
+    add_hbr(store, 255, 7, 9, 0, 'F', 7);
+    add_hbr(store, 1, 0, 1, 2, 'P', 8);
+
+    BinSummary summary;
+    summary.build(store);
+    const BinCount* file_good = find_bin(summary, false, ALL_SITES_HEAD, 0, 1);
+    const BinCount* file_fail = find_bin(summary, false, ALL_SITES_HEAD, 0, 5);
+    const BinCount* unreached = find_bin(summary, false, ALL_SITES_HEAD, 0, 9);
+    const BinCount* site_good = find_bin(summary, false, 1, 0, 1);
+    const BinCount* site_soft = find_bin(summary, true, 1, 0, 12);
+    bool ok = file_good && file_good->part_count == 3 && file_good->reported_count == 4 && !file_good->matches() &&
+              file_fail && file_fail->matches() && file_fail->pass_fail == 'F' &&
+              unreached && unreached->part_count == 0 && unreached->matches() &&
+              site_good && site_good->part_count == 2 && site_good->matches() &&
+              site_soft && site_soft->part_count == 1 && !site_soft->reported &&
+              summary.mismatched_bins() == 1;
+    if (!ok) {
+        std::cout << "FAIL: synthetic bin counts or reconciliation are wrong" << std::endl;
+        return 1;
+    }
+    if (summary.bins().front().soft || summary.bins().front().head_num != ALL_SITES_HEAD || !summary.bins().back().soft) {
+        std::cout << "FAIL: bins are not ordered hard, whole file first" << std::endl;
+        return 1;
+    }
+    const std::vector<SiteYield>& yields = summary.yields();
+    if (yields.size() != 3 || yields[0].head_num != ALL_SITES_HEAD || yields[0].part_count != 4 ||
+        yields[0].good_count != 3 || yields[1].site_num != 0 || yields[1].good_count != 2 ||
+        yields[2].site_num != 1 || yields[2].yield() != 1.0) {
+        std::cout << "FAIL: site yields are wrong" << std::endl;
+        return 1;
+    }
+
+    // The processor's yield agrees with its test_flag column
+    UltraFastProcessor processor;
+    processor.set_parser_backend(STDFParserBackend::MMAP);
+    MeasurementBatch batch = processor.process_stdf_file_to_batch(test_file);
+    const BinSummary& file_summary = processor.get_bin_summary();
+    if (batch.size() == 0 || file_summary.yields().empty()) {
+        std::cout << "FAIL: no rows or no yields for " << test_file << std::endl;
+        return 1;
+    }
+    uint32_t parts = 0;
+    for (const BinCount& bin : file_summary.bins()) {
+        parts += !bin.soft && bin.head_num == ALL_SITES_HEAD ? bin.part_count : 0;
+    }
+    if (parts != file_summary.yields()[0].part_count) {
+        std::cout << "FAIL: whole-file hard bins count " << parts << " parts" << std::endl;
+        return 1;
+    }
+    std::set<uint32_t> good_devices;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (batch.test_flag[i] == 1) {
+            good_devices.insert(batch.wld_id[i]);
+        }
+    }
+    if (good_devices.size() != file_summary.yields()[0].good_count) {
+        std::cout << "FAIL: " << file_summary.yields()[0].good_count << " good parts, test_flag marks "
+                  << good_devices.size() << std::endl;
+        return 1;
+    }
+    std::cout << "   " << file_summary.bins().size() << " bin rows, " << file_summary.mismatched_bins()
+              << " differing from HBR/SBR, yield " << file_summary.yields()[0].yield() << std::endl;
+
+    std::cout << "PASS: bin summaries count PRRs and reconcile HBR/SBR" << std::endl;
+    return 0;
+}
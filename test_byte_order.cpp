@@ -0,0 +1,208 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/stdf_binary_parser.h"
+#include "cpp/include/stdf_record_view.h"
+#include "cpp/include/byte_order.h"
+#include "test_support/measurement_compare.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+static void swap_in_place(uint8_t* p, size_t size) {
+    std::reverse(p, p + size);
+}
+
+// Rewrites a little-endian file as CPU_TYP 1 (big-endian): headers, the
+// FAR and every multi-byte field of the record types the view describes
+static std::vector<uint8_t> to_big_endian(const std::vector<uint8_t>& input) {
+    std::vector<uint8_t> output(input);
+    STDFRecordView view;
+    size_t position = 0;
+    while (position + 4 <= input.size()) {
+        uint16_t length = FileByteOrder<false>::u2(&input[position]);
+        uint8_t rec_type = input[position + 2];
+        uint8_t rec_subtype = input[position + 3];
+        swap_in_place(&output[position], 2);
+        const uint8_t* body = &input[position + 4];
+        uint8_t* out = &output[position + 4];
+        if (position + 4 + length > input.size()) {
+            break;
+        }
+        if (rec_type == 0 && rec_subtype == 10 && length >= 1) {
+            out[0] = 1;
+        }
+
+        view.reset(rec_type, rec_subtype, body, length, false, 0);
+        std::vector<uint32_t> values(view.field_count(), 0);
+        size_t offset = 0;
+        for (size_t i = 0; i < view.field_count() && offset < length; ++i) {
+            const STDFFieldSpec& spec = view.field_spec(i);
+            size_t count = spec.count_field >= 0 ? values[static_cast<size_t>(spec.count_field)] : 0;
+            size_t size = 0;
+            switch (spec.kind) {
+                case STDFFieldKind::U1: case STDFFieldKind::I1: case STDFFieldKind::B1: case STDFFieldKind::C1:
+                    size = 1;
+                    break;
+                case STDFFieldKind::U2: case STDFFieldKind::I2:
+                    size = 2;
+                    values[i] = offset + 2 <= length ? FileByteOrder<false>::u2(body + offset) : 0;
+                    break;
+                case STDFFieldKind::U4: case STDFFieldKind::I4: case STDFFieldKind::R4:
+                    size = 4;
+                    break;
+                case STDFFieldKind::CN: case STDFFieldKind::BN:
+                    size = 1 + body[offset];
+                    break;
+                case STDFFieldKind::DN:
+                    size = 2 + (offset + 2 <= length ? (FileByteOrder<false>::u2(body + offset) + 7) / 8 : 0);
+                    break;
+                case STDFFieldKind::XN1:
+                    size = (count + 1) / 2;
+                    break;
+                case STDFFieldKind::XU2:
+                    size = 2 * count;
+                    break;
+                case STDFFieldKind::XR4:
+                    size = 4 * count;
+                    break;
+            }
+            if (offset + size > length) {
+                break;
+            }
+            switch (spec.kind) {
+                case STDFFieldKind::U2: case STDFFieldKind::I2: case STDFFieldKind::DN:
+                    swap_in_place(out + offset, 2);
+                    break;
+                case STDFFieldKind::U4: case STDFFieldKind::I4: case STDFFieldKind::R4:
+                    swap_in_place(out + offset, 4);
+                    break;
+                case STDFFieldKind::XU2:
+                    for (size_t k = 0; k < count; ++k) swap_in_place(out + offset + 2 * k, 2);
+                    break;
+                case STDFFieldKind::XR4:
+                    for (size_t k = 0; k < count; ++k) swap_in_place(out + offset + 4 * k, 4);
+                    break;
+                default:
+                    break;
+            }
+            offset += size;
+        }
+        position += 4 + length;
+    }
+    return output;
+}
+
+static bool kernels_match() {
+    std::vector<uint8_t> bytes(4 * 133 + 3);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+    for (size_t shift = 0; shift < 4; ++shift) {
+        for (size_t count = 0; count <= 133; ++count) {
+            std::vector<uint16_t> halves(count);
+            std::vector<uint32_t> words(count);
+            byte_swap_copy16(halves.data(), bytes.data() + shift, count);
+            byte_swap_copy32(words.data(), bytes.data() + shift, count);
+            for (size_t i = 0; i < count; ++i) {
+                const uint8_t* half = bytes.data() + shift + 2 * i;
+                const uint8_t* word = bytes.data() + shift + 4 * i;
+                if (halves[i] != static_cast<uint16_t>(half[0] << 8 | half[1]) ||
+                    words[i] != (static_cast<uint32_t>(word[0]) << 24 | word[1] << 16 | word[2] << 8 | word[3])) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static double decode_seconds(const std::string& path, STDFColumnarStore& store) {
+    STDFParser parser;
+    parser.set_backend(STDFParserBackend::MMAP);
+    auto start = std::chrono::high_resolution_clock::now();
+    parser.parse_to_columns(path, store);
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// Big-endian (CPU_TYP 1) files must decode to the same measurements as native ones
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Byte Order Test ===" << std::endl;
+
+    if (!kernels_match()) {
+        std::cout << "FAIL: " << byte_swap_implementation() << " byte swap kernels differ from the scalar swap" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(test_file, std::ios::binary);
+    std::vector<uint8_t> native((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    const fs::path dir = fs::temp_directory_path() / "test_byte_order";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string swapped_file = (dir / "big_endian.stdf").string();
+    {
+        std::vector<uint8_t> swapped = to_big_endian(native);
+        std::ofstream output(swapped_file, std::ios::binary);
+        output.write(reinterpret_cast<const char*>(swapped.data()), static_cast<std::streamsize>(swapped.size()));
+    }
+
+    STDFScanSummary native_summary;
+    STDFScanSummary swapped_summary;
+    STDFParser scanner;
+    if (!scanner.scan_file(test_file, native_summary) || !scanner.scan_file(swapped_file, swapped_summary) ||
+        swapped_summary.cpu_type != 1 || swapped_summary.mir_fields != native_summary.mir_fields) {
+        std::cout << "FAIL: big-endian copy does not scan like the original" << std::endl;
+        return 1;
+    }
+
+    UltraFastProcessor native_processor;
+    native_processor.set_parser_backend(STDFParserBackend::MMAP);
+    MeasurementBatch expected = native_processor.process_stdf_file_to_batch(test_file);
+    UltraFastProcessor swapped_processor;
+    swapped_processor.set_parser_backend(STDFParserBackend::MMAP);
+    swapped_processor.set_file_hash(native_processor.get_file_hash());
+    MeasurementBatch swapped = swapped_processor.process_stdf_file_to_batch(swapped_file);
+    if (expected.size() == 0 || !same_rows(swapped, expected)) {
+        std::cout << "FAIL: big-endian file decoded to different measurements" << std::endl;
+        return 1;
+    }
+
+    // Lazy views swap arrays the same way
+    std::vector<float> native_results;
+    std::vector<float> swapped_results;
+    std::vector<float> values;
+    STDFParser view_parser;
+    view_parser.set_backend(STDFParserBackend::MMAP);
+    view_parser.set_enabled_record_types({STDFRecordType::MPR});
+    view_parser.stream_views(test_file, [&](STDFRecordView& view) {
+        view.get_floats("RTN_RSLT", values);
+        native_results.insert(native_results.end(), values.begin(), values.end());
+    });
+    view_parser.stream_views(swapped_file, [&](STDFRecordView& view) {
+        view.get_floats("RTN_RSLT", values);
+        swapped_results.insert(swapped_results.end(), values.begin(), values.end());
+    });
+    if (native_results.empty() || native_results != swapped_results) {
+        std::cout << "FAIL: MPR RTN_RSLT views differ between byte orders" << std::endl;
+        return 1;
+    }
+
+    STDFColumnarStore native_store;
+    STDFColumnarStore swapped_store;
+    double native_time = decode_seconds(test_file, native_store);
+    double swapped_time = decode_seconds(swapped_file, swapped_store);
+    std::cout << "   " << expected.size() << " rows; columnar decode " << native_time << "s native, "
+              << swapped_time << "s big-endian (" << byte_swap_implementation() << " array swaps)" << std::endl;
+
+    fs::remove_all(dir);
+    std::cout << "PASS: big-endian STDF decodes like native" << std::endl;
+    return 0;
+}
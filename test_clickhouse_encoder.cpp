@@ -0,0 +1,124 @@
+#include "cpp/include/clickhouse_encoder.h"
+#include "test_support/fake_clickhouse_server.h"
+#include <iostream>
+#include <cstring>
+
+static std::string read_string(const std::string& data, size_t& pos) {
+    size_t length = read_varint(data, pos);
+    std::string value = data.substr(pos, length);
+    pos += length;
+    return value;
+}
+
+static MeasurementBatch make_batch() {
+    MeasurementBatch batch;
+    batch.resize(3);
+    const char* names[] = {"VDD", "IDDQ", "VDD"};
+    for (size_t i = 0; i < 3; ++i) {
+        batch.wld_id.values[i] = 10 + static_cast<uint32_t>(i);
+        batch.wptm_value.values[i] = 0.5 * static_cast<double>(i);
+        batch.wtp_param_name.codes[i] = batch.wtp_param_name.encode(names[i]);
+        batch.file_hash.codes[i] = batch.file_hash.encode("hash");
+        batch.wld_device_dmc.codes[i] = batch.wld_device_dmc.encode("dmc");
+        batch.units.codes[i] = batch.units.encode("V");
+    }
+    return batch;
+}
+
+int main() {
+    std::cout << "=== ClickHouse Encoder Test ===" << std::endl;
+
+    MeasurementBatch batch = make_batch();
+    ClickHouseBlockEncoder encoder;
+    if (encoder.set_columns({"wld_id", "no_such_field"}) || encoder.get_last_error().empty()) {
+        std::cout << "FAIL: unknown column accepted" << std::endl;
+        return 1;
+    }
+    // Selection order does not matter: columns always follow measurement_fields.def
+    if (!encoder.set_columns({"wtp_param_name", "wld_id", "wptm_value"}) ||
+        encoder.column_list() != "wld_id, wptm_value, wtp_param_name") {
+        std::cout << "FAIL: column selection (" << encoder.column_list() << ")" << std::endl;
+        return 1;
+    }
+
+    // Native: header, then per column name/type/data
+    std::string block;
+    encoder.encode(batch, 1, 10, ClickHouseFormat::NATIVE, block);
+    size_t pos = 0;
+    if (read_varint(block, pos) != 3 || read_varint(block, pos) != 2 || read_string(block, pos) != "wld_id" ||
+        read_string(block, pos) != "UInt32") {
+        std::cout << "FAIL: Native block header" << std::endl;
+        return 1;
+    }
+    uint32_t ids[2];
+    std::memcpy(ids, block.data() + pos, sizeof(ids));
+    pos += sizeof(ids);
+    double values[2];
+    if (read_string(block, pos) != "wptm_value" || read_string(block, pos) != "Float64") {
+        std::cout << "FAIL: Native second column header" << std::endl;
+        return 1;
+    }
+    std::memcpy(values, block.data() + pos, sizeof(values));
+    pos += sizeof(values);
+    if (ids[0] != 11 || ids[1] != 12 || values[0] != 0.5 || values[1] != 1.0 ||
+        read_string(block, pos) != "wtp_param_name" || read_string(block, pos) != "String" ||
+        read_string(block, pos) != "IDDQ" || read_string(block, pos) != "VDD" || pos != block.size()) {
+        std::cout << "FAIL: Native block data" << std::endl;
+        return 1;
+    }
+
+    // RowBinary: 4 + 8 + (1 + name length) bytes per row, no header
+    std::string rows;
+    encoder.encode(batch, 0, 3, ClickHouseFormat::ROW_BINARY, rows);
+    if (rows.size() != (12 + 4) + (12 + 5) + (12 + 4) || rows.compare(12, 4, "\x03VDD") != 0) {
+        std::cout << "FAIL: RowBinary size " << rows.size() << std::endl;
+        return 1;
+    }
+    if (encoder.insert_query("measurements", ClickHouseFormat::ROW_BINARY) !=
+        "INSERT INTO measurements (wld_id, wptm_value, wtp_param_name) FORMAT RowBinary") {
+        std::cout << "FAIL: insert query" << std::endl;
+        return 1;
+    }
+
+    // HTTP: one chunk per block
+    FakeClickHouseServer server;
+    if (!server.start()) {
+        std::cout << "FAIL: cannot start the local server" << std::endl;
+        return 1;
+    }
+    ClickHouseConnection connection;
+    connection.host = "127.0.0.1";
+    connection.port = server.port;
+    ClickHouseHttpInserter inserter(connection);
+    bool inserted = inserter.insert("measurements", batch, encoder, ClickHouseFormat::NATIVE, 2);
+    const std::string request = server.last_request();
+
+    std::string first_block, last_block;
+    encoder.encode(batch, 0, 2, ClickHouseFormat::NATIVE, first_block);
+    encoder.encode(batch, 2, 2, ClickHouseFormat::NATIVE, last_block);
+    const std::string request_line = "POST /?query=INSERT%20INTO%20measurements%20%28wld_id";
+    char chunk_header[32];
+    std::snprintf(chunk_header, sizeof(chunk_header), "\r\n\r\n%zx\r\n", first_block.size());
+    if (!inserted || request.compare(0, request_line.size(), request_line) != 0 ||
+        request.find("Transfer-Encoding: chunked") == std::string::npos ||
+        request.find(std::string(chunk_header) + first_block + "\r\n") == std::string::npos ||
+        inserter.get_bytes_sent() != first_block.size() + last_block.size() || server.rows != 3) {
+        std::cout << "FAIL: HTTP insert (" << inserter.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+
+    // Server-side errors come back in get_last_error()
+    server.fail_from = 0;
+    server.fail_response = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 20\r\n\r\nCode: 60. No table.";
+    ClickHouseHttpInserter failing(connection);
+    inserted = failing.insert("missing", batch, encoder);
+    server.stop();
+    if (inserted || failing.get_last_error().find("HTTP 500") == std::string::npos ||
+        failing.get_last_error().find("No table") == std::string::npos) {
+        std::cout << "FAIL: server error not reported (" << failing.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: Native/RowBinary blocks and HTTP insert" << std::endl;
+    return 0;
+}
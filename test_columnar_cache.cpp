@@ -0,0 +1,78 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/columnar_cache.h"
+#include "test_support/measurement_compare.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// Measurements rebuilt from the columnar cache must match a fresh decode
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Columnar Cache Test ===" << std::endl;
+
+    const fs::path dir = fs::temp_directory_path() / "test_columnar_cache";
+    fs::remove_all(dir);
+
+    UltraFastProcessor reference;
+    MeasurementBatch expected = reference.process_stdf_file_to_batch(test_file);
+
+    UltraFastProcessor first;
+    first.set_cache_dir(dir.string());
+    MeasurementBatch decoded = first.process_stdf_file_to_batch(test_file);
+
+    ColumnarCache cache(dir.string());
+    std::string content_hash = first.get_file_hash();
+    if (first.loaded_from_cache() || !cache.contains(content_hash) ||
+        content_hash != STDFParser::hash_file_content(test_file)) {
+        std::cout << "FAIL: first run did not write the cache entry" << std::endl;
+        return 1;
+    }
+
+    UltraFastProcessor second;
+    second.set_cache_dir(dir.string());
+    MeasurementBatch cached = second.process_stdf_file_to_batch(test_file);
+    if (!second.loaded_from_cache() || second.get_total_records() != reference.get_total_records() ||
+        second.get_file_hash() != content_hash) {
+        std::cout << "FAIL: second run did not come from the cache" << std::endl;
+        return 1;
+    }
+    if (!same_rows(decoded, expected) || !same_rows(cached, expected)) {
+        std::cout << "FAIL: cached measurements differ from a fresh decode" << std::endl;
+        return 1;
+    }
+
+    uintmax_t stdf_bytes = fs::file_size(test_file);
+    uintmax_t cache_bytes = fs::file_size(cache.entry_path(content_hash));
+    std::cout << "   " << cached.size() << " rows; cache " << cache_bytes << " bytes for " << stdf_bytes
+              << " bytes of STDF; decode " << first.get_parsing_time() << "s, cache load "
+              << second.get_parsing_time() << "s" << std::endl;
+
+    // A damaged entry is rejected and the file decoded again
+    {
+        std::fstream entry(cache.entry_path(content_hash), std::ios::binary | std::ios::in | std::ios::out);
+        entry.seekp(static_cast<std::streamoff>(cache_bytes / 2));
+        entry.write("garbage!", 8);
+    }
+    STDFColumnarStore store;
+    ColumnarCacheInfo info;
+    if (cache.load(content_hash, store, info) || store.size() != 0) {
+        std::cout << "FAIL: corrupt cache entry accepted" << std::endl;
+        return 1;
+    }
+    UltraFastProcessor third;
+    third.set_cache_dir(dir.string());
+    if (!same_rows(third.process_stdf_file_to_batch(test_file), expected) || third.loaded_from_cache()) {
+        std::cout << "FAIL: corrupt cache entry was not replaced by a decode" << std::endl;
+        return 1;
+    }
+
+    fs::remove_all(dir);
+    std::cout << "PASS: measurements rebuilt from the columnar cache match the decode" << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/columnar_store.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks that the typed columns agree with the string field maps
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Columnar Store Test ===" << std::endl;
+
+    STDFParser parser;
+    auto records = parser.parse_file(test_file);
+
+    std::vector<uint16_t> reference_rec_len;
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        STDFParser column_parser;
+        column_parser.set_backend(backend);
+
+        STDFColumnarStore store;
+        if (!column_parser.parse_to_columns(test_file, store)) {
+            std::cout << "FAIL: parse_to_columns could not open " << test_file << std::endl;
+            return 1;
+        }
+
+        if (store.size() != records.size()) {
+            std::cout << "FAIL: " << store.size() << " rows vs " << records.size() << " records" << std::endl;
+            return 1;
+        }
+
+        size_t ptr_row = 0, mpr_row = 0, prr_row = 0;
+        size_t mismatches = 0;
+
+        for (const auto& record : records) {
+            auto field = [&](const char* key) {
+                auto it = record.fields.find(key);
+                return it != record.fields.end() ? it->second : std::string();
+            };
+
+            if (record.type == STDFRecordType::PTR) {
+                const PTRColumns& ptr = store.ptr;
+                if (ptr.record_index[ptr_row] != record.record_index ||
+                    std::to_string(ptr.TEST_NUM[ptr_row]) != field("TEST_NUM") ||
+                    std::to_string(ptr.RESULT[ptr_row]) != field("RESULT") ||
+                    store.str(ptr.ALARM_ID[ptr_row]) != field("ALARM_ID") ||
+                    store.str(ptr.UNITS[ptr_row]) != field("UNITS")) {
+                    mismatches++;
+                }
+                ptr_row++;
+            } else if (record.type == STDFRecordType::MPR) {
+                const MPRColumns& mpr = store.mpr;
+                if (mpr.record_index[mpr_row] != record.record_index ||
+                    std::to_string(mpr.RSLT_CNT[mpr_row]) != field("RSLT_CNT") ||
+                    store.str(mpr.TEST_TXT[mpr_row]) != field("TEST_TXT") ||
+                    store.mpr_result_count(mpr_row) != mpr.RSLT_CNT[mpr_row]) {
+                    mismatches++;
+                }
+                mpr_row++;
+            } else if (record.type == STDFRecordType::PRR) {
+                const PRRColumns& prr = store.prr;
+                if (std::to_string(prr.SOFT_BIN[prr_row]) != field("SOFT_BIN") ||
+                    std::to_string(prr.X_COORD[prr_row]) != field("X_COORD") ||
+                    store.str(prr.PART_ID[prr_row]) != field("PART_ID")) {
+                    mismatches++;
+                }
+                prr_row++;
+            }
+        }
+
+        std::cout << "   PTR " << store.ptr.size() << ", MPR " << store.mpr.size()
+                  << ", FTR " << store.ftr.size() << ", PRR " << store.prr.size()
+                  << ", strings " << store.strings.size()
+                  << ", pooled results " << store.float_pool.size() << std::endl;
+
+        if (mismatches > 0) {
+            std::cout << "FAIL: " << mismatches << " rows differ from field maps" << std::endl;
+            return 1;
+        }
+
+        // REC_LEN drives default-data inheritance, so both backends must agree
+        if (reference_rec_len.empty()) {
+            reference_rec_len = store.mpr.rec_len;
+        } else if (reference_rec_len != store.mpr.rec_len) {
+            std::cout << "FAIL: MPR REC_LEN differs between backends" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: columns match field maps on both backends" << std::endl;
+    return 0;
+}
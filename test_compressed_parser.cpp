@@ -0,0 +1,131 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/decompressing_reader.h"
+#include <zlib.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+
+static std::vector<char> read_all(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+// BGZF: independent gzip members of <= 64 KB input, size in a "BC" extra field
+static bool write_bgzf(const std::vector<char>& input, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    std::vector<unsigned char> member(70000);
+
+    for (size_t offset = 0; offset < input.size(); offset += 60000) {
+        size_t chunk = std::min<size_t>(60000, input.size() - offset);
+
+        z_stream zs = {};
+        deflateInit2(&zs, 6, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data() + offset));
+        zs.avail_in = static_cast<uInt>(chunk);
+        zs.next_out = member.data() + 18;
+        zs.avail_out = static_cast<uInt>(member.size() - 26);
+        if (deflate(&zs, Z_FINISH) != Z_STREAM_END) return false;
+        size_t deflated = zs.total_out;
+        deflateEnd(&zs);
+
+        size_t total = 18 + deflated + 8;
+        const unsigned char header[18] = {0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0,
+                                          static_cast<unsigned char>((total - 1) & 0xff),
+                                          static_cast<unsigned char>((total - 1) >> 8)};
+        std::copy(header, header + 18, member.begin());
+
+        uLong crc = crc32(0, reinterpret_cast<const Bytef*>(input.data() + offset), static_cast<uInt>(chunk));
+        unsigned char* trailer = member.data() + 18 + deflated;
+        for (int i = 0; i < 4; ++i) trailer[i] = static_cast<unsigned char>(crc >> (8 * i));
+        for (int i = 0; i < 4; ++i) trailer[4 + i] = static_cast<unsigned char>(chunk >> (8 * i));
+
+        out.write(reinterpret_cast<const char*>(member.data()), static_cast<std::streamsize>(total));
+    }
+    return static_cast<bool>(out);
+}
+
+static bool check_compressed(const std::string& label, const std::string& path,
+                             const std::vector<STDFRecord>& expected, size_t expected_total) {
+    STDFParser parser;
+    parser.set_backend(STDFParserBackend::MMAP);
+    parser.set_num_threads(4);
+    auto records = parser.parse_file(path);
+
+    std::cout << "   " << label << ": " << records.size() << " records (total "
+              << parser.get_total_records() << ")" << std::endl;
+
+    if (records.size() != expected.size() || parser.get_total_records() != expected_total) {
+        std::cout << "FAIL: " << label << " record counts differ" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (records[i].type != expected[i].type || records[i].record_index != expected[i].record_index ||
+            records[i].fields != expected[i].fields) {
+            std::cout << "FAIL: " << label << " record " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Pipelined gzip/bzip2 decompression must reproduce the uncompressed parse
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Compressed Parser Test ===" << std::endl;
+
+    STDFParser reference;
+    reference.set_backend(STDFParserBackend::MMAP);
+    auto expected = reference.parse_file(test_file);
+    if (expected.empty()) {
+        std::cout << "FAIL: no records parsed" << std::endl;
+        return 1;
+    }
+
+    const std::string gz_path = "/tmp/test_compressed_parser.stdf.gz";
+    const std::string bgzf_path = "/tmp/test_compressed_parser_bgzf.stdf.gz";
+    const std::string bz2_path = "/tmp/test_compressed_parser.stdf.bz2";
+
+    std::string gzip_cmd = "gzip -c '" + test_file + "' > " + gz_path;
+    if (std::system(gzip_cmd.c_str()) != 0 || !write_bgzf(read_all(test_file), bgzf_path)) {
+        std::cout << "FAIL: could not create gzip test files" << std::endl;
+        return 1;
+    }
+
+    bool ok = check_compressed("gzip", gz_path, expected, reference.get_total_records()) &&
+              check_compressed("bgzf", bgzf_path, expected, reference.get_total_records());
+
+    DecompressingReader bgzf;
+    if (ok && (!bgzf.open(bgzf_path, 4) || !bgzf.is_parallel())) {
+        std::cout << "FAIL: BGZF members were not detected" << std::endl;
+        ok = false;
+    }
+    bgzf.close();
+
+    // Concatenated bzip2 streams (pbzip2 layout), when bzip2 is available
+    std::string bzip2_cmd = "head -c 10000000 '" + test_file + "' | bzip2 -c > " + bz2_path +
+                            " && tail -c +10000001 '" + test_file + "' | bzip2 -c >> " + bz2_path;
+    if (ok && std::system(bzip2_cmd.c_str()) == 0) {
+        DecompressingReader bz2;
+        if (bz2.open(bz2_path, 4)) {
+            ok = bz2.member_count() == 2 && check_compressed("bzip2", bz2_path, expected, reference.get_total_records());
+        } else {
+            std::cout << "   bzip2: skipped (" << bz2.get_last_error() << ")" << std::endl;
+        }
+    }
+
+    std::remove(gz_path.c_str());
+    std::remove(bgzf_path.c_str());
+    std::remove(bz2_path.c_str());
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: compressed input matches the uncompressed parse" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "cpp/include/cpu_topology.h"
+#include "cpp/include/work_stealing_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Holds the first `count` arrivals until all of them are in
+class Gate {
+public:
+    explicit Gate(size_t count) : waiting_(count) {}
+
+    void arrive() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (--waiting_ == 0) {
+            opened_.notify_all();
+        }
+        opened_.wait(lock, [this]() { return waiting_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable opened_;
+    size_t waiting_;
+};
+
+int main() {
+    std::cout << "=== CPU Topology Test ===" << std::endl;
+
+    const std::vector<unsigned> cpus = CPUTopology::parse_cpu_list("8-11,0-3,5\n");
+    const std::vector<unsigned> expected = {0, 1, 2, 3, 5, 8, 9, 10, 11};
+    if (cpus != expected || !CPUTopology::parse_cpu_list("").empty()) {
+        std::cout << "FAIL: cpulist \"8-11,0-3,5\" parsed to " << cpus.size() << " CPUs" << std::endl;
+        return 1;
+    }
+
+    const CPUTopology& system = CPUTopology::system();
+    if (system.node_count() == 0 || system.cpu_count() == 0 || system.bind_current_thread(system.node_count())) {
+        std::cout << "FAIL: system topology has " << system.node_count() << " nodes, "
+                  << system.cpu_count() << " CPUs" << std::endl;
+        return 1;
+    }
+    std::cout << "   system: " << system.node_count() << " nodes, " << system.cpu_count() << " CPUs" << std::endl;
+
+    // Two nodes made of the same CPUs, so binding works on any machine
+    const CPUTopology two_nodes({system.node_cpus(0), system.node_cpus(0)});
+
+    // The first task of each worker is its own (dealt round-robin) and none
+    // finishes before all three run, so task w runs on worker w
+    const size_t threads = 3;
+    std::vector<int> task_node(threads * 4, -2);
+    std::vector<int> nested_node(threads * 4, -2);
+    Gate gate(threads);
+    std::vector<std::function<void()>> tasks;
+    for (size_t task = 0; task < task_node.size(); ++task) {
+        tasks.emplace_back([&, task]() {
+            if (task < threads) {
+                gate.arrive();
+            }
+            task_node[task] = two_nodes.current_thread_node();
+
+            // A pool inside a worker stays on that worker's node
+            WorkStealingPool nested(2, two_nodes);
+            std::vector<std::function<void()>> inner;
+            std::atomic<bool> same_node(true);
+            const int outer = task_node[task];
+            for (size_t i = 0; i < 4; ++i) {
+                inner.emplace_back([&]() {
+                    same_node = same_node && two_nodes.current_thread_node() == outer;
+                });
+            }
+            nested.run(inner);
+            nested_node[task] = same_node && nested.worker_node(1) == outer ? outer : -1;
+        });
+    }
+
+    WorkStealingPool pool(threads, two_nodes);
+    if (pool.worker_node(0) != -1 || pool.worker_node(1) != 1 || pool.worker_node(2) != 0) {
+        std::cout << "FAIL: workers placed on nodes " << pool.worker_node(0) << ", " << pool.worker_node(1)
+                  << ", " << pool.worker_node(2) << std::endl;
+        return 1;
+    }
+    pool.run(tasks);
+
+    if (task_node[1] != 1 || task_node[2] != 0) {
+        std::cout << "FAIL: worker 1 ran on node " << task_node[1] << ", worker 2 on node " << task_node[2] << std::endl;
+        return 1;
+    }
+    for (size_t task = 1; task < threads; ++task) {
+        if (nested_node[task] != task_node[task]) {
+            std::cout << "FAIL: the pool nested in task " << task << " left node " << task_node[task] << std::endl;
+            return 1;
+        }
+    }
+
+    // Placement off: nobody is bound
+    WorkStealingPool::set_numa_placement(false);
+    WorkStealingPool unplaced(threads, two_nodes);
+    WorkStealingPool::set_numa_placement(true);
+    for (size_t worker = 0; worker < threads; ++worker) {
+        if (unplaced.worker_node(worker) != -1) {
+            std::cout << "FAIL: worker " << worker << " placed with placement off" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: workers spread over nodes, nested pools keep theirs" << std::endl;
+    return 0;
+}
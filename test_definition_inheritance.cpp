@@ -0,0 +1,73 @@
+#include "cpp/include/test_definition_cache.h"
+#include <iostream>
+#include <cstring>
+
+// Builds a PTR the way the decoders leave it; rec_len decides which
+// trailing fields the record carries
+static rec_ptr make_ptr(uint32_t test_num, uint8_t site, char* test_txt, char* units,
+                        uint8_t opt_flag, float lo, float hi, uint16_t rec_len) {
+    rec_ptr ptr;
+    std::memset(&ptr, 0, sizeof(ptr));
+    ptr.header.REC_LEN = rec_len;
+    ptr.TEST_NUM = test_num;
+    ptr.HEAD_NUM = 1;
+    ptr.SITE_NUM = site;
+    ptr.TEST_TXT = test_txt;
+    ptr.UNITS = units;
+    ptr.OPT_FLAG = opt_flag;
+    ptr.LO_LIMIT = lo;
+    ptr.HI_LIMIT = hi;
+    return ptr;
+}
+
+static bool check(bool condition, const char* what) {
+    if (!condition) {
+        std::cout << "FAIL: " << what << std::endl;
+    }
+    return condition;
+}
+
+int main() {
+    std::cout << "=== Test Definition Inheritance Test ===" << std::endl;
+
+    char vdd[] = "\x03Vdd";
+    char volts[] = "\x01V";
+    char empty[] = "\x00";
+
+    STDFColumnarStore store;
+    // Full definition, then a record truncated right after ALARM_ID (12 + 4 + 1 bytes)
+    store.append(make_ptr(100, 1, vdd, volts, 0, 1.0f, 2.0f, 40), 1);
+    store.append(make_ptr(100, 1, empty, empty, 0, 0.0f, 0.0f, 17), 2);
+    // Limits flagged invalid / absent
+    store.append(make_ptr(100, 1, empty, empty, 0x10, 0.0f, 5.0f, 40), 3);
+    store.append(make_ptr(100, 1, empty, empty, 0x40, 0.0f, 0.0f, 40), 4);
+    // Same test number on another site is a separate definition
+    store.append(make_ptr(100, 2, empty, empty, 0, 3.0f, 4.0f, 40), 5);
+
+    TestDefinitionCache cache;
+    bool ok = true;
+
+    TestDefinition first = cache.resolve_ptr(store, 0);
+    ok &= check(store.str(first.test_txt) == "Vdd" && store.str(first.units) == "V", "first record defines name/units");
+    ok &= check(first.has_lo_limit && first.lo_limit == 1.0f && first.hi_limit == 2.0f, "first record defines limits");
+
+    TestDefinition truncated = cache.resolve_ptr(store, 1);
+    ok &= check(store.str(truncated.test_txt) == "Vdd" && store.str(truncated.units) == "V", "truncated record inherits name/units");
+    ok &= check(truncated.has_lo_limit && truncated.lo_limit == 1.0f && truncated.hi_limit == 2.0f, "truncated record inherits limits");
+
+    TestDefinition invalid_lo = cache.resolve_ptr(store, 2);
+    ok &= check(invalid_lo.lo_limit == 1.0f && invalid_lo.hi_limit == 5.0f, "invalid LO_LIMIT inherited, HI_LIMIT overridden");
+
+    TestDefinition no_lo = cache.resolve_ptr(store, 3);
+    ok &= check(!no_lo.has_lo_limit && no_lo.has_hi_limit, "OPT_FLAG bit 6 removes the low limit");
+
+    TestDefinition other_site = cache.resolve_ptr(store, 4);
+    ok &= check(other_site.test_txt == 0 && other_site.lo_limit == 3.0f, "definitions are per site");
+    ok &= check(cache.size() == 2, "one definition per (TEST_NUM, HEAD_NUM, SITE_NUM)");
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: test definitions inherit STDF default data" << std::endl;
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/device_discovery.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+static std::vector<std::string> names_of(const std::vector<std::pair<std::string, uint32_t>>& mappings) {
+    std::vector<std::string> names;
+    for (const auto& mapping : mappings) {
+        if (!mapping.first.empty()) {
+            names.push_back(mapping.first);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+// Discovery must find the devices and parameters processing assigns IDs to
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Device Discovery Test ===" << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    UltraFastProcessor processor;
+    processor.process_stdf_file(test_file);
+    double processing_time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::vector<std::string> expected_devices = names_of(processor.get_id_manager().get_new_device_mappings());
+    std::vector<std::string> expected_parameters = names_of(processor.get_id_manager().get_new_param_mappings());
+    if (expected_devices.empty() || expected_parameters.empty()) {
+        std::cout << "FAIL: processing assigned no IDs" << std::endl;
+        return 1;
+    }
+
+    for (STDFParserBackend backend : {STDFParserBackend::MMAP, STDFParserBackend::LIBSTDF}) {
+        const char* backend_name = backend == STDFParserBackend::MMAP ? "mmap" : "libstdf";
+        DeviceDiscovery discovery;
+        discovery.set_parser_backend(backend);
+        discovery.set_num_threads(2);
+        if (!discovery.discover_files({test_file, test_file}) || discovery.file_stats().size() != 2) {
+            std::cout << "FAIL: " << backend_name << " discovery failed" << std::endl;
+            return 1;
+        }
+        if (discovery.devices() != expected_devices || discovery.parameters() != expected_parameters ||
+            discovery.file_stats()[0].parameters != expected_parameters) {
+            std::cout << "FAIL: " << backend_name << " discovery found " << discovery.devices().size()
+                      << " devices, " << discovery.parameters().size() << " parameters; processing assigned "
+                      << expected_devices.size() << " and " << expected_parameters.size() << std::endl;
+            return 1;
+        }
+        std::cout << "   " << backend_name << ": " << discovery.file_stats()[0].discovery_time
+                  << "s per file vs " << processing_time << "s processing" << std::endl;
+    }
+
+    DeviceDiscovery missing;
+    if (missing.discover_files({"does_not_exist.stdf"}) || missing.file_stats()[0].error.empty()) {
+        std::cout << "FAIL: a missing file was not reported" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   " << expected_devices.size() << " devices, " << expected_parameters.size() << " parameters" << std::endl;
+    std::cout << "PASS: discovery matches the IDs processing assigns" << std::endl;
+    return 0;
+}
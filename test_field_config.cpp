@@ -0,0 +1,125 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/dynamic_field_extractor.h"
+#include <chrono>
+#include <iostream>
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Field configuration from JSON, pushed down into both decoders
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Field Configuration Test ===" << std::endl;
+
+    // Single-line JSON, list shorthand and unrelated members
+    DynamicFieldExtractor extractor("");
+    if (!extractor.set_config_from_json(
+            "{\"PTR\": {\"enabled\": true, \"fields\": [\"TEST_NUM\", \"RESULT\"]}, \"PRR\": [\"PART_ID\"]}") ||
+        extractor.get_projection_mask("PTR") != (field_bit(stdf_fields::PTR_TEST_NUM) | field_bit(stdf_fields::PTR_RESULT)) ||
+        extractor.get_projection_mask("PRR") != field_bit(stdf_fields::PRR_PART_ID) ||
+        extractor.get_projection_mask("HBR") != 0 || !extractor.is_projected(STDFRecordType::HBR)) {
+        std::cout << "FAIL: JSON configuration not applied" << std::endl;
+        return 1;
+    }
+    if (extractor.set_config_from_json("{\"PTR\": [\"TEST_NUM\"") ||
+        extractor.get_projection_mask("PRR") != field_bit(stdf_fields::PRR_PART_ID)) {
+        std::cout << "FAIL: malformed JSON changed the selection" << std::endl;
+        return 1;
+    }
+    if (extractor.set_config_from_json("{}") || extractor.set_config_from_json("{\"PTR\": [\"NO_SUCH_FIELD\"]}") ||
+        extractor.set_config_from_json("{\"PTR\": {\"enabled\": false, \"fields\": [\"TEST_NUM\"]}}") ||
+        extractor.get_projection_mask("PRR") != field_bit(stdf_fields::PRR_PART_ID)) {
+        std::cout << "FAIL: a configuration selecting no fields was accepted" << std::endl;
+        return 1;
+    }
+
+    // The shipped configuration: rules nested under field_extraction_rules,
+    // disabled types left out
+    DynamicFieldExtractor shipped("python/stdf_field_config.json");
+    FieldMask ptr_shipped = 0;
+    for (auto field : {stdf_fields::PTR_TEST_NUM, stdf_fields::PTR_HEAD_NUM, stdf_fields::PTR_SITE_NUM,
+                       stdf_fields::PTR_TEST_FLG, stdf_fields::PTR_PARM_FLG, stdf_fields::PTR_RESULT,
+                       stdf_fields::PTR_ALARM_ID, stdf_fields::PTR_LO_LIMIT, stdf_fields::PTR_HI_LIMIT,
+                       stdf_fields::PTR_UNITS}) {
+        ptr_shipped |= field_bit(field);
+    }
+    if (shipped.get_projection_mask("PTR") != ptr_shipped ||
+        shipped.get_enabled_fields("MPR").size() != 8 || shipped.get_projection_mask("MPR") == 0 ||
+        shipped.get_enabled_record_types() != std::set<std::string>{"PTR", "MPR"}) {
+        std::cout << "FAIL: python/stdf_field_config.json selected "
+                  << shipped.get_enabled_record_types().size() << " record types" << std::endl;
+        return 1;
+    }
+    if (DynamicFieldExtractor("no_such_config.json").get_projection_mask("PTR") !=
+        field_bit(stdf_fields::PTR_FIELD_COUNT) - 1) {
+        std::cout << "FAIL: a missing configuration file dropped fields" << std::endl;
+        return 1;
+    }
+
+    const std::string config = "{\"PTR\": {\"fields\": [\"TEST_NUM\", \"TEST_FLG\", \"RESULT\", \"TEST_TXT\"]}}";
+    const char* selected[] = {"TEST_NUM", "TEST_FLG", "RESULT", "TEST_TXT"};
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        STDFParser full;
+        full.set_backend(backend);
+        auto start = std::chrono::steady_clock::now();
+        auto all_records = full.parse_file(test_file);
+        double full_seconds = seconds_since(start);
+
+        STDFParser projected;
+        projected.set_backend(backend);
+        if (!projected.set_field_config(config)) {
+            std::cout << "FAIL: set_field_config rejected " << config << std::endl;
+            return 1;
+        }
+        start = std::chrono::steady_clock::now();
+        auto records = projected.parse_file(test_file);
+        double projected_seconds = seconds_since(start);
+
+        if (records.size() != all_records.size()) {
+            std::cout << "FAIL: projection changed the record count" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < records.size(); ++i) {
+            const STDFRecord& record = records[i];
+            const STDFRecord& reference = all_records[i];
+            if (record.type != reference.type || record.record_index != reference.record_index) {
+                std::cout << "FAIL: record " << i << " differs in type or position" << std::endl;
+                return 1;
+            }
+            if (record.type == STDFRecordType::MIR) {
+                continue;  // MIR keeps its fixed selection
+            }
+            // Header fields plus the selected ones, nothing else
+            size_t expected = record.type == STDFRecordType::PTR ? 3 + 4 : 3;
+            bool ok = record.fields.size() == expected &&
+                      record.fields.at("RECORD_TYPE") == reference.fields.at("RECORD_TYPE");
+            for (const char* name : selected) {
+                if (ok && record.type == STDFRecordType::PTR) {
+                    ok = record.fields.at(name) == reference.fields.at(name);
+                }
+            }
+            if (!ok) {
+                std::cout << "FAIL: projected record " << record.record_index << " has "
+                          << record.fields.size() << " fields" << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "   " << (backend == STDFParserBackend::MMAP ? "mmap" : "libstdf") << ": "
+                  << full_seconds << "s all fields, " << projected_seconds << "s projected" << std::endl;
+
+        projected.set_field_config("");
+        if (projected.parse_file(test_file).at(1).fields != all_records.at(1).fields) {
+            std::cout << "FAIL: empty configuration did not restore every field" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: field configuration pushed down into both decoders" << std::endl;
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "cpp/include/dynamic_field_extractor.h"
+#include <iostream>
+#include <cstring>
+
+// Checks that configured field sets compile into the expected bitmasks
+int main() {
+    std::cout << "=== Field Projection Test ===" << std::endl;
+
+    DynamicFieldExtractor extractor;
+
+    if (extractor.get_projection_mask("PTR") != field_bit(stdf_fields::PTR_FIELD_COUNT) - 1) {
+        std::cout << "FAIL: default PTR mask does not cover every .def field" << std::endl;
+        return 1;
+    }
+
+    extractor.set_config_from_json(
+        "{\n"
+        "  \"PTR\": {\n"
+        "    \"fields\": [\"TEST_NUM\", \"RESULT\"]\n"
+        "  },\n"
+        "  \"MPR\": {\n"
+        "    \"fields\": [\"RTN_RSLT\"]\n"
+        "  }\n"
+        "}\n");
+
+    FieldMask expected_ptr = field_bit(stdf_fields::PTR_TEST_NUM) | field_bit(stdf_fields::PTR_RESULT);
+    if (extractor.get_projection_mask("PTR") != expected_ptr ||
+        extractor.get_projection_mask("MPR") != field_bit(stdf_fields::MPR_RTN_RSLT) ||
+        extractor.get_projection_mask("FTR") != 0) {
+        std::cout << "FAIL: projection masks do not match the configuration" << std::endl;
+        return 1;
+    }
+
+    rec_ptr ptr;
+    std::memset(&ptr, 0, sizeof(ptr));
+    ptr.TEST_NUM = 42;
+    ptr.RESULT = 1.5f;
+
+    DynamicSTDFRecord ptr_out;
+    extractor.extract_fields(&ptr, ptr_out);
+    if (ptr_out.fields.size() != 2 || ptr_out.fields["TEST_NUM"] != "42") {
+        std::cout << "FAIL: PTR extraction ignored the projection" << std::endl;
+        return 1;
+    }
+
+    float results[] = {1.0f, 2.5f};
+    rec_mpr mpr;
+    std::memset(&mpr, 0, sizeof(mpr));
+    mpr.RSLT_CNT = 2;
+    mpr.RTN_RSLT = results;
+
+    DynamicSTDFRecord mpr_out;
+    extractor.extract_fields(&mpr, mpr_out);
+    if (mpr_out.fields.size() != 1 || mpr_out.fields["RTN_RSLT"] != "1,2.5") {
+        std::cout << "FAIL: MPR RTN_RSLT projection produced '" << mpr_out.fields["RTN_RSLT"] << "'" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: projection masks drive extraction" << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "cpp/include/file_prefetcher.h"
+#include "cpp/include/batch_ingest_engine.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+
+namespace fs = std::filesystem;
+
+// Polls until the prefetcher has finished `files` files, or a few seconds pass
+static FilePrefetchStats wait_for(const FilePrefetcher& prefetcher, size_t files) {
+    for (int i = 0; i < 500 && prefetcher.stats().files + prefetcher.stats().errors < files; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // Nothing more may follow
+    return prefetcher.stats();
+}
+
+// Files ahead of the decoders are read in claim order, inside the window
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== File Prefetcher Test ===" << std::endl;
+
+    const fs::path dir = fs::temp_directory_path() / "test_file_prefetcher";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const uint64_t file_bytes = 3 * FilePrefetcher::READ_CHUNK / 2;
+    std::vector<std::string> paths;
+    for (int i = 0; i < 5; ++i) {
+        paths.push_back((dir / ("file" + std::to_string(i) + ".stdf")).string());
+        std::ofstream(paths.back(), std::ios::binary) << std::string(file_bytes, static_cast<char>('a' + i));
+    }
+
+    // Two being decoded, two read ahead, the fifth waits for a claim
+    FilePrefetcher prefetcher;
+    prefetcher.set_files_ahead(2);
+    prefetcher.start(paths, 2);
+    FilePrefetchStats stats = wait_for(prefetcher, 2);
+    if (stats.files != 2 || stats.bytes != 2 * file_bytes || stats.errors != 0) {
+        std::cout << "FAIL: " << stats.files << " files, " << stats.bytes << " bytes read ahead of 2" << std::endl;
+        return 1;
+    }
+    prefetcher.claimed(2);
+    stats = wait_for(prefetcher, 3);
+    prefetcher.stop();
+    if (stats.files != 3 || stats.late != 0) {
+        std::cout << "FAIL: claim did not free a slot (" << stats.files << " files read)" << std::endl;
+        return 1;
+    }
+
+    // The window caps each file and how many wait at once
+    prefetcher.set_files_ahead(4);
+    prefetcher.set_window_bytes(file_bytes + file_bytes / 2);
+    prefetcher.start(paths, 1);
+    stats = wait_for(prefetcher, 1);
+    prefetcher.stop();
+    if (stats.files != 1 || stats.bytes != file_bytes) {
+        std::cout << "FAIL: window of 1.5 files let " << stats.files << " files, " << stats.bytes << " bytes in"
+                  << std::endl;
+        return 1;
+    }
+    prefetcher.set_window_bytes(file_bytes / 3);
+    prefetcher.start(paths, 3);
+    stats = wait_for(prefetcher, 1);
+    prefetcher.stop();
+    if (stats.files != 1 || stats.bytes != file_bytes / 3) {
+        std::cout << "FAIL: a file larger than the window read " << stats.bytes << " bytes" << std::endl;
+        return 1;
+    }
+
+    // Missing files are counted, not fatal; off reads nothing
+    prefetcher.set_window_bytes(FilePrefetcher::get_default_window_bytes());
+    prefetcher.start({(dir / "missing.stdf").string()});
+    stats = wait_for(prefetcher, 1);
+    prefetcher.set_files_ahead(0);
+    prefetcher.start(paths);
+    if (stats.errors != 1 || prefetcher.stats().files != 0) {
+        std::cout << "FAIL: " << stats.errors << " errors for a missing file" << std::endl;
+        return 1;
+    }
+    prefetcher.stop();
+    fs::remove_all(dir);
+
+    // A batch with read-ahead decodes the same rows as without
+    BatchIngestEngine reference;
+    FilePrefetcher::set_default_files_ahead(0);
+    reference.process_files({test_file, test_file, test_file});
+    FilePrefetcher::set_default_files_ahead(2);
+    BatchIngestEngine engine;
+    engine.process_files({test_file, test_file, test_file});
+    if (engine.measurements().size() == 0 || engine.measurements().size() != reference.measurements().size()) {
+        std::cout << "FAIL: " << engine.measurements().size() << " rows with read-ahead, "
+                  << reference.measurements().size() << " without" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: files read ahead in claim order within the window" << std::endl;
+    return 0;
+}
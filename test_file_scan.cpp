@@ -0,0 +1,102 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/stdf_binary_parser.h"
+#include "cpp/include/stdf_record_index.h"
+#include "cpp/include/columnar_store.h"
+#include <libstdf.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+static bool same_summary(const STDFScanSummary& a, const STDFScanSummary& b) {
+    for (size_t type = 0; type < static_cast<size_t>(CountedRecordType::COUNT); ++type) {
+        if (a.record_counts[type] != b.record_counts[type] || a.record_bytes[type] != b.record_bytes[type]) {
+            return false;
+        }
+    }
+    return a.total_records == b.total_records && a.stdf_bytes == b.stdf_bytes &&
+           a.complete() == b.complete() && a.mir_fields == b.mir_fields && a.mrr_fields == b.mrr_fields;
+}
+
+// The header-only scan must agree with the offset index and the full decode
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Header Scan Test ===" << std::endl;
+
+    STDFParser parser;
+    STDFScanSummary summary;
+    if (!parser.scan_file(test_file, summary)) {
+        std::cout << "FAIL: cannot scan " << test_file << std::endl;
+        return 1;
+    }
+
+    STDFRecordIndex index;
+    if (!index.build(test_file)) {
+        std::cout << "FAIL: cannot index " << test_file << ": " << index.get_last_error() << std::endl;
+        return 1;
+    }
+    uint64_t prr_count = index.find_records(REC_TYP_PER_PART, REC_SUB_PRR).size();
+    uint64_t ptr_count = index.find_records(REC_TYP_PER_EXEC, REC_SUB_PTR).size();
+    if (summary.total_records != index.size() || summary.count(CountedRecordType::PRR) != prr_count ||
+        summary.count(CountedRecordType::PTR) != ptr_count) {
+        std::cout << "FAIL: scan counts " << summary.total_records << " records / "
+                  << summary.count(CountedRecordType::PRR) << " PRR, index " << index.size() << " / "
+                  << prr_count << std::endl;
+        return 1;
+    }
+
+    // MIR fields as the full decode reports them
+    STDFParser full;
+    STDFColumnarStore store;
+    if (!full.parse_to_columns(test_file, store) || store.mir_records.empty() ||
+        !summary.has_mir || summary.mir_fields.at("LOT_ID") != store.mir_records[0].fields.at("LOT_ID")) {
+        std::cout << "FAIL: MIR fields differ from the full decode" << std::endl;
+        return 1;
+    }
+    if (!summary.complete() || summary.complete_bytes != summary.stdf_bytes || !summary.mrr_fields.count("FINISH_T")) {
+        std::cout << "FAIL: intact file reported incomplete" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << summary.total_records << " records, " << summary.count(CountedRecordType::PRR)
+              << " parts, lot " << summary.mir_fields.at("LOT_ID") << std::endl;
+
+    // Cut inside the last record: truncated, no MRR at the end
+    std::ifstream in(test_file, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::string truncated_path = "/tmp/test_file_scan_truncated.stdf";
+    {
+        std::ofstream out(truncated_path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 3));
+    }
+    STDFScanSummary cut;
+    if (!parser.scan_file(truncated_path, cut) || !cut.truncated || cut.complete() ||
+        cut.total_records != summary.total_records - 1) {
+        std::cout << "FAIL: truncated file not detected (" << cut.total_records << " records)" << std::endl;
+        return 1;
+    }
+
+    // gzip copy: same summary from the inflated stream
+    const std::string gz_path = "/tmp/test_file_scan.stdf.gz";
+    std::string gzip_cmd = "gzip -c '" + test_file + "' > " + gz_path;
+    if (std::system(gzip_cmd.c_str()) != 0) {
+        std::cout << "FAIL: could not create gzip test file" << std::endl;
+        return 1;
+    }
+    STDFScanSummary inflated;
+    bool gzip_ok = parser.scan_file(gz_path, inflated) && same_summary(summary, inflated) &&
+                   !parser.get_content_hash().empty();
+    std::remove(gz_path.c_str());
+    std::remove(truncated_path.c_str());
+    if (!gzip_ok) {
+        std::cout << "FAIL: gzip scan differs from the uncompressed scan" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: header scan matches the index and the full decode" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "cpp/include/file_schedule.h"
+#include "cpp/include/work_stealing_pool.h"
+#include "cpp/include/batch_ingest_engine.h"
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace fs = std::filesystem;
+
+// Large files start first and get the spare threads; results keep input order
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== File Schedule Test ===" << std::endl;
+
+    // One worker runs its deque front to back: largest first, ties in order
+    const std::vector<uint64_t> costs = {5, 40, 5, 100, 1};
+    std::vector<size_t> ran;
+    std::vector<std::function<void()>> tasks;
+    for (size_t i = 0; i < costs.size(); ++i) {
+        tasks.push_back([&ran, i]() { ran.push_back(i); });
+    }
+    WorkStealingPool(1).run(tasks, costs);
+    if (ran != std::vector<size_t>({3, 1, 0, 2, 4}) || largest_first(costs) != ran) {
+        std::cout << "FAIL: tasks did not run largest first" << std::endl;
+        return 1;
+    }
+
+    // Several workers still run every task exactly once
+    std::mutex mutex;
+    std::vector<int> counts(costs.size(), 0);
+    tasks.clear();
+    for (size_t i = 0; i < costs.size(); ++i) {
+        tasks.push_back([&, i]() { std::lock_guard<std::mutex> lock(mutex); counts[i]++; });
+    }
+    WorkStealingPool(3).run(tasks, costs);
+    if (counts != std::vector<int>(costs.size(), 1)) {
+        std::cout << "FAIL: tasks lost or repeated on several workers" << std::endl;
+        return 1;
+    }
+
+    // Thread shares: a straggler gets most of them, equal files split evenly
+    if (decode_threads_for(90, 100, 11, 8) != 7 || decode_threads_for(1, 100, 11, 8) != 1 ||
+        decode_threads_for(50, 100, 2, 8) != 4 || decode_threads_for(0, 0, 3, 8) != 2) {
+        std::cout << "FAIL: decode thread shares" << std::endl;
+        return 1;
+    }
+
+    // Costs come from the files' sizes; gzip counts extra, missing files 0
+    const fs::path root = fs::temp_directory_path() / "test_file_schedule";
+    fs::remove_all(root);
+    fs::create_directories(root);
+    const std::string small = (root / "small.stdf").string();
+    const std::string gzipped = (root / "small.stdf.gz").string();
+    {
+        std::ifstream in(test_file, std::ios::binary);
+        std::vector<char> head(4096);
+        in.read(head.data(), static_cast<std::streamsize>(head.size()));
+        std::ofstream(small, std::ios::binary).write(head.data(), in.gcount());
+        const char gzip_magic[] = {'\x1f', '\x8b', '\x08', '\0'};
+        std::ofstream(gzipped, std::ios::binary).write(gzip_magic, sizeof(gzip_magic));
+    }
+    const std::vector<uint64_t> file_costs = estimate_file_costs({small, test_file, gzipped, "missing.stdf"});
+    if (file_costs[0] != 4096 || file_costs[1] != fs::file_size(test_file) ||
+        file_costs[2] != 4 * COMPRESSED_COST_FACTOR || file_costs[3] != 0) {
+        std::cout << "FAIL: file cost estimates" << std::endl;
+        return 1;
+    }
+
+    // A batch with the large file last still reports per file in input order
+    BatchIngestEngine engine;
+    engine.set_num_threads(4);
+    engine.set_parser_backend(STDFParserBackend::MMAP);
+    engine.process_files({small, small, test_file});
+    const auto& stats = engine.file_stats();
+    if (stats.size() != 3 || stats[2].path != test_file || stats[2].measurements == 0 ||
+        stats[2].row_offset != stats[0].measurements + stats[1].measurements ||
+        engine.measurements().size() != stats[2].row_offset + stats[2].measurements) {
+        std::cout << "FAIL: batch results out of input order" << std::endl;
+        return 1;
+    }
+
+    fs::remove_all(root);
+    std::cout << "PASS: files are scheduled largest first with size-proportional threads" << std::endl;
+    return 0;
+}
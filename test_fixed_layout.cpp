@@ -0,0 +1,131 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/columnar_store.h"
+#include "cpp/include/stdf_layout.h"
+#include "test_support/stdf_record_writer.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static RecordWriter full_ptr(bool big_endian) {
+    RecordWriter ptr(big_endian);
+    ptr.u4(0x01020304); ptr.u1(1); ptr.u1(7); ptr.u1(0x40); ptr.u1(0x02); ptr.r4(-1.25f);
+    ptr.cn("VDD_Leakage"); ptr.cn("A7");
+    ptr.u1(0x0E); ptr.u1(static_cast<uint8_t>(-3)); ptr.u1(static_cast<uint8_t>(-6)); ptr.u1(2);
+    ptr.r4(0.5f); ptr.r4(1.5e3f);
+    ptr.cn("uA"); ptr.cn("%9.3f"); ptr.cn(""); ptr.cn("%7.1f");
+    ptr.r4(-2.0f); ptr.r4(3.0f);
+    return ptr;
+}
+
+static RecordWriter full_prr(bool big_endian) {
+    RecordWriter prr(big_endian);
+    prr.u1(1); prr.u1(3); prr.u1(0x08); prr.u2(1234); prr.u2(5); prr.u2(42);
+    prr.u2(static_cast<uint16_t>(-17)); prr.u2(250); prr.u4(98765);
+    prr.cn("W12_X-17_Y250"); prr.cn("part text"); prr.cn("\x01\x02");
+    return prr;
+}
+
+// Every PTR and PRR cut after each of its fields, so each fixed run is seen
+// whole, cut inside and missing (libstdf assembles a cut field from the bytes
+// present, which the checked reads never did, so fields are kept whole)
+static bool write_file(const std::string& path, bool big_endian) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    RecordWriter far(big_endian);
+    far.u1(big_endian ? 1 : 2);
+    far.u1(4);
+    far.write(out, 0, 10, 2);
+    RecordWriter ptr = full_ptr(big_endian);
+    RecordWriter prr = full_prr(big_endian);
+    for (size_t keep : ptr.ends) {
+        ptr.write(out, 15, 10, keep);
+    }
+    for (size_t keep : prr.ends) {
+        prr.write(out, 5, 20, keep);
+    }
+    return static_cast<bool>(out);
+}
+
+// Same values, comparing strings by text (ids may differ between stores)
+static std::string compare(const STDFColumnarStore& a, const STDFColumnarStore& b) {
+    if (a.ptr.size() != b.ptr.size() || a.prr.size() != b.prr.size()) {
+        return "row counts differ";
+    }
+    for (size_t row = 0; row < a.ptr.size(); ++row) {
+        #define FIELD(name, member) \
+            if constexpr (std::is_same<decltype(rec_ptr::member), dtc_Cn>::value) { \
+                if (a.str(a.ptr.member[row]) != b.str(b.ptr.member[row])) return std::string("PTR ") + name + " row " + std::to_string(row); \
+            } else if (a.ptr.member[row] != b.ptr.member[row]) { \
+                return std::string("PTR ") + name + " row " + std::to_string(row); \
+            }
+        #include "cpp/field_defs/ptr_fields.def"
+        #undef FIELD
+    }
+    for (size_t row = 0; row < a.prr.size(); ++row) {
+        #define FIELD(name, member) \
+            if constexpr (std::is_same<decltype(rec_prr::member), dtc_Cn>::value) { \
+                if (a.str(a.prr.member[row]) != b.str(b.prr.member[row])) return std::string("PRR ") + name + " row " + std::to_string(row); \
+            } else if (a.prr.member[row] != b.prr.member[row]) { \
+                return std::string("PRR ") + name + " row " + std::to_string(row); \
+            }
+        #include "cpp/field_defs/prr_fields.def"
+        #undef FIELD
+    }
+    return std::string();
+}
+
+// The generated fixed-offset decoders must agree with libstdf on whole and
+// truncated records, in both byte orders
+int main() {
+    std::cout << "=== Fixed Layout Decoder Test ===" << std::endl;
+
+    static_assert(stdf_layout::run_offset<stdf_layout::PTRLayout>(stdf_layout::PTRLayout::RESULT) == 8,
+                  "RESULT follows TEST_NUM..PARM_FLG");
+    static_assert(stdf_layout::run_offset<stdf_layout::PRRLayout>(stdf_layout::PRRLayout::TEST_T) == 13,
+                  "TEST_T ends the PRR prefix");
+
+    const std::string little = "/tmp/test_fixed_layout_le.stdf";
+    const std::string big = "/tmp/test_fixed_layout_be.stdf";
+    if (!write_file(little, false) || !write_file(big, true)) {
+        std::cout << "FAIL: cannot write the test files" << std::endl;
+        return 1;
+    }
+
+    STDFColumnarStore reference;
+    STDFParser libstdf_parser;
+    libstdf_parser.set_backend(STDFParserBackend::LIBSTDF);
+    if (!libstdf_parser.parse_to_columns(little, reference) || reference.ptr.size() == 0) {
+        std::cout << "FAIL: libstdf decoded no rows" << std::endl;
+        return 1;
+    }
+    for (const std::string& path : {little, big}) {
+        STDFColumnarStore store;
+        STDFParser parser;
+        parser.set_backend(STDFParserBackend::MMAP);
+        if (!parser.parse_to_columns(path, store)) {
+            std::cout << "FAIL: cannot decode " << path << std::endl;
+            return 1;
+        }
+        std::string difference = compare(reference, store);
+        if (!difference.empty()) {
+            std::cout << "FAIL: " << path << ": " << difference << std::endl;
+            return 1;
+        }
+    }
+    const size_t last = reference.ptr.size() - 1;
+    if (reference.ptr.TEST_NUM[last] != 0x01020304 || reference.ptr.HI_SPEC[last] != 3.0f ||
+        reference.prr.X_COORD[reference.prr.size() - 1] != -17 || reference.ptr.TEST_NUM[1] != 0x01020304 || reference.ptr.RESULT[5] != 0.0f ||
+        reference.ptr.RESULT[6] != -1.25f) {
+        std::cout << "FAIL: reference values are not the ones written" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << reference.ptr.size() << " PTR and " << reference.prr.size()
+              << " PRR cuts agree in both byte orders" << std::endl;
+
+    std::remove(little.c_str());
+    std::remove(big.c_str());
+    std::cout << "PASS: fixed-offset decoders match libstdf on whole and truncated records" << std::endl;
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/id_map_snapshot.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// Snapshots answer like the loaded maps, and processing from them assigns the same IDs
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== ID Map Snapshot Test ===" << std::endl;
+
+    const fs::path dir = fs::temp_directory_path() / "test_id_map_snapshot";
+    fs::remove_all(dir);
+    const std::string path = (dir / "devices.idmap").string();
+
+    // 200k devices, the last mapping of a repeated name wins
+    const uint32_t count = 200000;
+    std::vector<IDMapSnapshot::Mapping> mappings;
+    char name[32];
+    for (uint32_t id = 1; id <= count; ++id) {
+        std::snprintf(name, sizeof(name), "DEV%06u", id);
+        mappings.emplace_back(name, id);
+    }
+    mappings.emplace_back("DEV000007", 7);
+    std::string error;
+    if (!IDMapSnapshot::write(path, mappings, error)) {
+        std::cout << "FAIL: " << error << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    IDMapSnapshot snapshot;
+    bool opened = snapshot.open(path);
+    const double open_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    ShardedIDMap loaded;
+    loaded.load(mappings);
+    const double load_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!opened || snapshot.size() != count || snapshot.max_id() != count) {
+        std::cout << "FAIL: snapshot did not open with " << count << " mappings (" << snapshot.get_last_error() << ")"
+                  << std::endl;
+        return 1;
+    }
+    for (const auto& mapping : mappings) {
+        uint32_t id = 0;
+        if (!snapshot.find(mapping.first, id) || id != mapping.second) {
+            std::cout << "FAIL: " << mapping.first << " not found as " << mapping.second << std::endl;
+            return 1;
+        }
+    }
+    uint32_t id = 0;
+    if (snapshot.find("DEV200001", id) || snapshot.find("", id) || snapshot.mappings().size() != count ||
+        snapshot.mappings().back().second != count) {
+        std::cout << "FAIL: lookups of absent names or the listing are wrong" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << count << " mappings: snapshot opened in " << open_time * 1000 << "ms, map loaded in "
+              << load_time * 1000 << "ms" << std::endl;
+
+    // A map on a snapshot: loaded deltas on top, new names continue after both
+    std::string shared_error;
+    ShardedIDMap layered;
+    layered.attach(IDMapSnapshot::open_shared(path, shared_error));
+    layered.load({{"SYNCED", count + 1}});
+    if (layered.get_or_assign("DEV000005") != 5 || layered.get_or_assign("SYNCED") != count + 1 ||
+        layered.get_or_assign("FRESH") != count + 2 || layered.new_mappings().size() != 1 ||
+        layered.all_mappings().size() != count + 2 || layered.size() != count + 2) {
+        std::cout << "FAIL: a map on a snapshot assigns or lists the wrong IDs" << std::endl;
+        return 1;
+    }
+
+    // Truncated files are refused
+    const std::string truncated = (dir / "truncated.idmap").string();
+    fs::copy_file(path, truncated);
+    fs::resize_file(truncated, fs::file_size(truncated) - 3);
+    IDMapSnapshot broken;
+    if (broken.open(truncated)) {
+        std::cout << "FAIL: a truncated snapshot opened" << std::endl;
+        return 1;
+    }
+
+    // A damaged table without an empty slot ends the probe after a full lap
+    const std::string full = (dir / "full.idmap").string();
+    fs::copy_file(path, full);
+    {
+        std::fstream file(full, std::ios::binary | std::ios::in | std::ios::out);
+        uint64_t capacity = 0;
+        file.seekg(24);  // SnapshotHeader::capacity
+        file.read(reinterpret_cast<char*>(&capacity), sizeof(capacity));
+        const uint64_t occupied = 1;
+        for (uint64_t slot = 0; slot < capacity; ++slot) {
+            file.seekp(48 + slot * 24);  // Header, then 24-byte slots
+            file.write(reinterpret_cast<const char*>(&occupied), sizeof(occupied));
+        }
+    }
+    IDMapSnapshot damaged;
+    if (!damaged.open(full) || damaged.find("DEV200001", id)) {
+        std::cout << "FAIL: a snapshot without empty slots was not probed to the end" << std::endl;
+        return 1;
+    }
+
+    // Saving a run's maps and starting the next run from them gives the same IDs
+    UltraFastProcessor first;
+    const MeasurementBatch expected = first.process_stdf_file_to_batch(test_file);
+    if (expected.size() == 0 || !first.get_id_manager().save_snapshots(dir.string())) {
+        std::cout << "FAIL: no rows or snapshots not saved" << std::endl;
+        return 1;
+    }
+    FastIDManager::set_default_snapshot_dir(dir.string());
+    UltraFastProcessor second;
+    const MeasurementBatch again = second.process_stdf_file_to_batch(test_file);
+    FastIDManager::set_default_snapshot_dir("");
+    if (again.size() != expected.size() || !second.get_id_manager().get_new_device_mappings().empty() ||
+        !second.get_id_manager().get_new_param_mappings().empty() ||
+        second.get_id_manager().snapshot_max_param_id() == 0) {
+        std::cout << "FAIL: the run on snapshots assigned new IDs" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (again.wld_id[i] != expected.wld_id[i] || again.wtp_id[i] != expected.wtp_id[i]) {
+            std::cout << "FAIL: row " << i << " got other IDs from the snapshots" << std::endl;
+            return 1;
+        }
+    }
+
+    fs::remove_all(dir);
+    std::cout << "PASS: ID snapshots load by mapping and keep IDs stable" << std::endl;
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "cpp/include/ingest_daemon.h"
+#include "test_support/fake_clickhouse_server.h"
+#include <iostream>
+#include <filesystem>
+#include <thread>
+#include <chrono>
+
+namespace fs = std::filesystem;
+
+// Polls until done(stats) holds or the timeout passes
+template<typename Done>
+static bool wait_for(IngestDaemon& daemon, Done done, std::chrono::seconds timeout = std::chrono::seconds(120)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (done(daemon.stats())) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return false;
+}
+
+// Files dropped into a watched folder are inserted over warm connections
+// with warm ID maps, and the manifest stops them coming in twice
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Ingest Daemon Test ===" << std::endl;
+
+    UltraFastProcessor reference;
+    reference.set_parser_backend(STDFParserBackend::MMAP);
+    const MeasurementBatch expected = reference.process_stdf_file_to_batch(test_file);
+    const size_t expected_devices = reference.get_id_manager().get_new_device_mappings().size();
+    if (expected.size() == 0) {
+        std::cout << "FAIL: no measurements in " << test_file << std::endl;
+        return 1;
+    }
+
+    FakeClickHouseServer server;
+    if (!server.start()) {
+        std::cout << "FAIL: cannot start the local server" << std::endl;
+        return 1;
+    }
+    ClickHouseConnection connection;
+    connection.host = "127.0.0.1";
+    connection.port = server.port;
+
+    // A kept connection the server dropped is reopened without losing rows
+    server.hang_up = true;
+    {
+        ClickHouseBlockEncoder encoder;
+        encoder.set_columns({"wld_id"});
+        ClickHouseHttpInserter inserter(connection);
+        inserter.set_keep_alive(true);
+        bool ok = true;
+        for (int i = 0; i < 3; ++i) {
+            ok = ok && inserter.insert("measurements", expected, encoder);
+        }
+        if (!ok || server.rows != 3 * expected.size() || inserter.get_connections_opened() != 3) {
+            std::cout << "FAIL: reconnecting after a hang-up lost rows (" << inserter.get_last_error() << ")"
+                      << std::endl;
+            return 1;
+        }
+    }
+    server.hang_up = false;
+    server.rows = 0;
+    server.connections = 0;
+
+    const fs::path root = fs::temp_directory_path() / "test_ingest_daemon";
+    const fs::path drop = root / "drop";
+    fs::remove_all(root);
+    fs::create_directories(drop);
+    fs::copy_file(test_file, drop / "existing.stdf");
+
+    IngestDaemonConfig config;
+    config.directories = {drop.string()};
+    config.connection = connection;
+    config.manifest_path = (root / "manifest.tsv").string();
+    config.decode_threads = 1;
+    config.insert_threads = 1;
+    config.block_rows = 200000;
+    config.batch_window = std::chrono::milliseconds(100);
+    {
+        IngestDaemon daemon(config);
+        daemon.pipeline().encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+        daemon.pipeline().set_parser_backend(STDFParserBackend::MMAP);
+        if (!daemon.start() || std::string(daemon.watch_backend()) != "inotify") {
+            std::cout << "FAIL: daemon did not start on inotify (" << daemon.get_last_error() << ")" << std::endl;
+            return 1;
+        }
+        if (!wait_for(daemon, [](const IngestDaemonStats& stats) { return stats.files_ingested == 1; })) {
+            std::cout << "FAIL: the file already there was not ingested" << std::endl;
+            return 1;
+        }
+
+        // Renamed in once complete, written in place, and a file to ignore
+        fs::copy_file(test_file, drop / "renamed.stdf.part");
+        fs::rename(drop / "renamed.stdf.part", drop / "renamed.STDF");
+        fs::copy_file(test_file, drop / "copied.stdf");
+        fs::copy_file(test_file, drop / "notes.txt");
+        if (!wait_for(daemon, [](const IngestDaemonStats& stats) { return stats.files_ingested == 3; })) {
+            std::cout << "FAIL: dropped files were not ingested (" << daemon.stats().files_ingested << ")"
+                      << std::endl;
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));  // Nothing else arrives
+
+        const IngestDaemonStats stats = daemon.stats();
+        std::vector<FileIngestStats> results = daemon.take_results();
+        std::vector<std::pair<std::string, uint32_t>> devices;
+        std::vector<std::pair<std::string, uint32_t>> params;
+        daemon.take_new_mappings(devices, params);
+        daemon.stop();
+        if (stats.files_ingested != 3 || stats.files_failed != 0 || results.size() != 3 ||
+            server.rows != 3 * expected.size() || stats.rows_inserted != 3 * expected.size()) {
+            std::cout << "FAIL: " << stats.files_ingested << " files, " << server.rows << " of "
+                      << 3 * expected.size() << " rows inserted" << std::endl;
+            return 1;
+        }
+        // The ID maps carried over: later copies of the file added no devices
+        if (devices.size() != expected_devices || params.empty()) {
+            std::cout << "FAIL: " << devices.size() << " new devices, expected " << expected_devices << std::endl;
+            return 1;
+        }
+        if (stats.connections_opened != 1 || server.connections != 1) {
+            std::cout << "FAIL: " << stats.connections_opened << " connections for " << stats.batches << " batches"
+                      << std::endl;
+            return 1;
+        }
+        std::cout << "   " << stats.batches << " batches, " << stats.rows_inserted << " rows over "
+                  << stats.connections_opened << " connection, max latency " << stats.max_latency << "s"
+                  << std::endl;
+    }
+
+    // A restart finds the same files in the manifest and inserts nothing
+    {
+        IngestDaemon daemon(config);
+        daemon.pipeline().set_parser_backend(STDFParserBackend::MMAP);
+        const size_t rows_before = server.rows;
+        if (!daemon.start() ||
+            !wait_for(daemon, [](const IngestDaemonStats& stats) { return stats.files_skipped == 3; })) {
+            std::cout << "FAIL: restart did not skip the ingested files" << std::endl;
+            return 1;
+        }
+        daemon.stop();
+        if (server.rows != rows_before || daemon.stats().files_ingested != 0) {
+            std::cout << "FAIL: restart inserted rows again" << std::endl;
+            return 1;
+        }
+    }
+
+    server.stop();
+    fs::remove_all(root);
+    std::cout << "PASS: the daemon ingests dropped files once, with warm maps and connections" << std::endl;
+    return 0;
+}
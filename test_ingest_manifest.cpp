@@ -0,0 +1,102 @@
+#include "cpp/include/ingest_manifest.h"
+#include "cpp/include/batch_ingest_engine.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+static void write_file(const std::string& path, const std::string& content) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+// Ingested, unchanged files are skipped; rewritten ones are not
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Ingest Manifest Test ===" << std::endl;
+
+    const fs::path dir = fs::temp_directory_path() / "test_ingest_manifest";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const std::string manifest_path = (dir / "manifest.tsv").string();
+    const std::string a = (dir / "a.stdf").string();
+    const std::string b = (dir / "b\tfile.stdf").string();  // Tabs in paths survive the line format
+    write_file(a, "first");
+    write_file(b, "second");
+
+    {
+        IngestManifest manifest;
+        manifest.open(manifest_path);
+        if (!manifest.record(a, "hash_a", ManifestStatus::INGESTED) ||
+            !manifest.record(b, "hash_b", ManifestStatus::FAILED) ||
+            manifest.record((dir / "missing.stdf").string(), "", ManifestStatus::INGESTED)) {
+            std::cout << "FAIL: record (" << manifest.get_last_error() << ")" << std::endl;
+            return 1;
+        }
+    }
+    {
+        std::ofstream torn(manifest_path, std::ios::app);
+        torn << "ingested\t12";  // Last append cut short
+    }
+
+    IngestManifest manifest;
+    manifest.open(manifest_path);
+    std::string hash;
+    if (manifest.size() != 2 || !manifest.is_ingested(a, &hash) || hash != "hash_a" || manifest.is_ingested(b) ||
+        !manifest.contains_hash("hash_a") || manifest.contains_hash("hash_b")) {
+        std::cout << "FAIL: reload" << std::endl;
+        return 1;
+    }
+
+    // A relative spelling of the same path hits the same entry
+    fs::path cwd = fs::current_path();
+    fs::current_path(dir);
+    bool relative_hit = manifest.is_ingested("./a.stdf");
+    fs::current_path(cwd);
+    if (!relative_hit) {
+        std::cout << "FAIL: relative path lookup" << std::endl;
+        return 1;
+    }
+
+    // Later lines win; a rewritten file is no longer ingested
+    manifest.record(b, "hash_b", ManifestStatus::INGESTED);
+    IngestManifest reread;
+    reread.open(manifest_path);
+    if (!reread.is_ingested(b)) {
+        std::cout << "FAIL: record after a torn line was lost" << std::endl;
+        return 1;
+    }
+    write_file(a, "first, rewritten");
+    if (manifest.is_ingested(a) || !manifest.is_ingested(b) || !manifest.compact()) {
+        std::cout << "FAIL: update/compact" << std::endl;
+        return 1;
+    }
+    std::ifstream compacted(manifest_path);
+    size_t lines = 0;
+    for (std::string line; std::getline(compacted, line);) lines++;
+    if (lines != 3) {
+        std::cout << "FAIL: compacted manifest has " << lines << " lines" << std::endl;
+        return 1;
+    }
+
+    // The engine does not open files the manifest lists
+    if (fs::exists(test_file)) {
+        manifest.record(test_file, "sample", ManifestStatus::INGESTED);
+        BatchIngestEngine engine;
+        engine.set_manifest(&manifest);
+        if (!engine.process_files({test_file}) || engine.measurements().size() != 0 ||
+            !engine.file_stats()[0].skipped || engine.file_stats()[0].file_hash != "sample") {
+            std::cout << "FAIL: engine did not skip an ingested file" << std::endl;
+            return 1;
+        }
+    }
+
+    fs::remove_all(dir);
+    std::cout << "PASS: manifest skips unchanged ingested files" << std::endl;
+    return 0;
+}
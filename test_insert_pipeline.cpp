@@ -0,0 +1,92 @@
+#include "cpp/include/insert_pipeline.h"
+#include "test_support/fake_clickhouse_server.h"
+#include <iostream>
+#include <chrono>
+
+// Blocks reach the server in full, through a queue that never exceeds its depth
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Insert Pipeline Test ===" << std::endl;
+
+    UltraFastProcessor reference;
+    const size_t expected_rows = reference.process_stdf_file_to_batch(test_file).size();
+    if (expected_rows == 0) {
+        std::cout << "FAIL: no measurements in " << test_file << std::endl;
+        return 1;
+    }
+
+    FakeClickHouseServer server;
+    server.delay = std::chrono::milliseconds(20);
+    if (!server.start()) {
+        std::cout << "FAIL: cannot start the local server" << std::endl;
+        return 1;
+    }
+    ClickHouseConnection connection;
+    connection.host = "127.0.0.1";
+    connection.port = server.port;
+
+    const size_t block_rows = 100000;
+    InsertPipeline pipeline(connection);
+    pipeline.encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+    pipeline.set_decode_threads(2);
+    pipeline.set_insert_threads(1);
+    pipeline.set_queue_depth(1);
+    pipeline.set_block_rows(block_rows);
+    bool ok = pipeline.run("measurements", {test_file, test_file});
+    const size_t expected_blocks = 2 * ((expected_rows + block_rows - 1) / block_rows);
+    const InsertPipelineStats& stats = pipeline.stats();
+    if (!ok || server.rows != 2 * expected_rows || stats.rows_inserted != 2 * expected_rows ||
+        stats.blocks_inserted != expected_blocks || pipeline.file_stats()[1].measurements != expected_rows) {
+        std::cout << "FAIL: " << server.rows << " of " << 2 * expected_rows << " rows inserted ("
+                  << pipeline.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    if (stats.peak_queue_depth != 1 || stats.backpressure_time <= 0.0) {
+        std::cout << "FAIL: no backpressure (peak " << stats.peak_queue_depth << ", waited "
+                  << stats.backpressure_time << "s)" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << stats.blocks_inserted << " blocks, decoders waited " << stats.backpressure_time << "s"
+              << std::endl;
+
+    // Whole small files coalesce into one INSERT; every row keeps its file's hash
+    server.rows = 0;
+    server.requests = 0;
+    InsertPipeline coalescing(connection);
+    coalescing.encoder().set_columns({"wtp_id", "file_hash"});
+    coalescing.set_decode_threads(2);
+    coalescing.set_block_rows(expected_rows + 1);
+    coalescing.set_coalesce_rows(3 * expected_rows);
+    coalescing.set_file_hashes({"hash-a", "hash-b", "hash-c"});
+    ok = coalescing.run("measurements", {test_file, test_file, test_file});
+    bool provenance = true;
+    const std::string request = server.last_request();
+    for (const char* hash : {"hash-a", "hash-b", "hash-c"}) {
+        provenance = provenance && request.find(hash) != std::string::npos;
+    }
+    if (!ok || server.requests != 1 || server.rows != 3 * expected_rows || coalescing.stats().files_coalesced != 3 ||
+        !provenance || coalescing.file_stats()[2].measurements != expected_rows || !coalescing.file_stats()[2].success) {
+        std::cout << "FAIL: 3 files coalesced into " << server.requests << " INSERTs of " << server.rows << " rows ("
+                  << coalescing.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    std::cout << "   3 files coalesced into 1 INSERT" << std::endl;
+
+    // A failed INSERT stops the pipeline and fails the unfinished files
+    server.requests = 0;
+    server.fail_from = 2;
+    ok = pipeline.run("measurements", {test_file, test_file, test_file});
+    server.stop();
+    if (ok || pipeline.get_last_error().find("HTTP 500") == std::string::npos ||
+        pipeline.stats().blocks_inserted != 2 || pipeline.file_stats()[2].success) {
+        std::cout << "FAIL: insert error not propagated (" << pipeline.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: bounded pipeline inserts every block with backpressure" << std::endl;
+    return 0;
+}
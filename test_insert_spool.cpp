@@ -0,0 +1,190 @@
+#include "cpp/include/insert_pipeline.h"
+#include "cpp/include/insert_spool.h"
+#include "test_support/fake_clickhouse_server.h"
+#include <iostream>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+
+namespace fs = std::filesystem;
+
+// Entries, commit markers and set-aside files left in dir
+static size_t count_files(const std::string& dir, const std::string& suffix) {
+    size_t count = 0;
+    for (const auto& file : fs::directory_iterator(dir)) {
+        const std::string name = file.path().filename().string();
+        count += name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+    return count;
+}
+
+// Blocks outlive failed INSERTs and a restart, and are sent exactly once
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Insert Spool Test ===" << std::endl;
+
+    const std::string dir = (fs::temp_directory_path() / "test_insert_spool").string();
+    fs::remove_all(dir);
+
+    // A fake Native block: one column, 7 rows, then payload
+    const std::string body = std::string("\x01\x07", 2) + std::string(1000, 'x');
+    const std::string query = "INSERT INTO measurements FORMAT Native";
+    {
+        InsertSpool spool;
+        InsertSpoolEntry entry;
+        if (!spool.open(dir)) {
+            std::cout << "FAIL: cannot open " << dir << " (" << spool.get_last_error() << ")" << std::endl;
+            return 1;
+        }
+        const uint64_t unfinished = spool.begin_group();
+        const uint64_t finished = spool.begin_group();
+        if (!spool.write(unfinished, query, body, 7, "hash-a", "a.stdf", entry) ||
+            !spool.write(finished, query, body, 7, "hash-b", "b.stdf", entry) ||
+            !spool.write(finished, query, body, 7, "hash-b", "b.stdf", entry) || !spool.commit(finished) ||
+            entry.stored_bytes >= entry.body_bytes) {
+            std::cout << "FAIL: cannot write to " << dir << " (" << spool.get_last_error() << ")" << std::endl;
+            return 1;
+        }
+    }
+
+    // Reopened: the unfinished file's block is gone, the finished file's wait
+    InsertSpool reopened;
+    std::vector<InsertSpoolEntry> pending;
+    std::string read_back;
+    if (!reopened.open(dir) || reopened.stats().discarded != 1 || (pending = reopened.pending()).size() != 2 ||
+        pending[0].sequence >= pending[1].sequence || pending[0].file_hash != "hash-b" || pending[0].rows != 7 ||
+        !reopened.read(pending[0], read_back) || read_back != body) {
+        std::cout << "FAIL: reopened spool has " << reopened.pending_count() << " blocks pending, "
+                  << reopened.stats().discarded << " discarded" << std::endl;
+        return 1;
+    }
+
+    // A flipped byte fails the checksum; the entry is set aside, the other sent
+    {
+        std::fstream damaged(pending[1].path, std::ios::in | std::ios::out | std::ios::binary);
+        damaged.seekp(-1, std::ios::end);
+        damaged.put('?');
+    }
+    FakeClickHouseServer server;
+    if (!server.start()) {
+        std::cout << "FAIL: cannot start the local server" << std::endl;
+        return 1;
+    }
+    ClickHouseConnection connection;
+    connection.host = "127.0.0.1";
+    connection.port = server.port;
+    ClickHouseHttpInserter inserter(connection);
+    if (!reopened.replay(inserter) || server.rows != 7 || reopened.stats().corrupt != 1 ||
+        reopened.pending_count() != 0 || count_files(dir, ".corrupt") != 1 || count_files(dir, ".commit") != 0) {
+        std::cout << "FAIL: replay sent " << server.rows << " rows, set aside " << reopened.stats().corrupt
+                  << " (" << reopened.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    fs::remove_all(dir);
+    server.rows = 0;
+    std::cout << "   reopen, checksum and replay ok" << std::endl;
+
+    // ClickHouse fails from the third INSERT on: decoding goes on into the spool.
+    // Two files with their own blocks, so each is recognized on its own later.
+    const std::string other_file = (fs::temp_directory_path() / "test_insert_spool_copy.stdf").string();
+    fs::copy_file(test_file, other_file, fs::copy_options::overwrite_existing);
+    UltraFastProcessor reference;
+    const size_t expected_rows = reference.process_stdf_file_to_batch(test_file).size();
+    const size_t block_rows = 100000;
+    const size_t expected_blocks = 2 * ((expected_rows + block_rows - 1) / block_rows);
+    server.requests = 0;
+    server.fail_from = 2;
+    InsertSpool spool;
+    spool.open(dir);
+    InsertPipeline pipeline(connection);
+    pipeline.encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+    pipeline.set_decode_threads(2);
+    pipeline.set_insert_threads(1);
+    pipeline.set_block_rows(block_rows);
+    pipeline.set_insert_spool(&spool);
+    bool ok = pipeline.run("measurements", {test_file, other_file});
+    const InsertPipelineStats& stats = pipeline.stats();
+    if (!ok || pipeline.get_last_error().find("HTTP 500") == std::string::npos || stats.blocks_inserted != 2 ||
+        stats.blocks_spooled != expected_blocks || stats.blocks_pending != expected_blocks - 2 ||
+        server.rows != 2 * block_rows || !pipeline.file_stats()[1].success ||
+        count_files(dir, ".chblock") != expected_blocks - 2) {
+        std::cout << "FAIL: " << stats.blocks_pending << " of " << expected_blocks << " blocks pending, "
+                  << stats.blocks_inserted << " inserted (" << pipeline.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+
+    // Back up: the next run sends the rest first. The first file, named
+    // another way, is not decoded again; the rewritten second one is.
+    server.fail_from = SIZE_MAX;
+    fs::last_write_time(other_file, fs::last_write_time(other_file) + std::chrono::hours(1));
+    InsertSpool restarted;
+    restarted.open(dir);
+    InsertPipeline rerun(connection);
+    rerun.encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+    rerun.set_block_rows(block_rows);
+    rerun.set_insert_spool(&restarted);
+    ok = rerun.run("measurements", {"./" + test_file, other_file});
+    server.stop();
+    if (!ok || server.rows != 3 * expected_rows || rerun.stats().blocks_replayed != expected_blocks - 2 ||
+        rerun.stats().blocks_spooled != expected_blocks / 2 || rerun.stats().blocks_pending != 0 ||
+        !rerun.file_stats()[0].success || rerun.file_stats()[0].file_hash.empty() ||
+        rerun.file_stats()[1].measurements != expected_rows ||
+        rerun.file_stats()[1].file_hash != STDFParser::hash_file_content(other_file) ||
+        count_files(dir, ".chblock") != 0 || count_files(dir, ".commit") != 0) {
+        std::cout << "FAIL: " << server.rows << " of " << 3 * expected_rows << " rows after replay ("
+                  << rerun.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    fs::remove_all(dir);
+
+    // A coalesced block is spooled once, naming all its files, and replayed once
+    server.start();
+    connection.port = server.port;
+    server.rows = 0;
+    server.requests = 0;
+    server.fail_from = 0;
+    InsertSpool shared;
+    shared.open(dir);
+    InsertPipeline coalescing(connection);
+    coalescing.encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+    coalescing.set_block_rows(expected_rows + 1);
+    coalescing.set_coalesce_rows(4 * expected_rows);
+    coalescing.set_insert_spool(&shared);
+    ok = coalescing.run("measurements", {test_file, other_file});
+    std::vector<InsertSpoolEntry> coalesced = shared.pending();
+    const std::string sources = coalesced.empty() ? "" : coalesced[0].source;
+    if (!ok || coalescing.stats().blocks_pending != 1 || coalesced.size() != 1 ||
+        std::count(sources.begin(), sources.end(), '\n') != 1 ||
+        sources.find("\t" + IngestManifest::normalize_path(test_file) + "\n") == std::string::npos ||
+        sources.find("\t" + IngestManifest::normalize_path(other_file)) == std::string::npos ||
+        coalesced[0].rows != 2 * expected_rows ||
+        !coalescing.file_stats()[1].success) {
+        std::cout << "FAIL: coalesced block spooled as " << coalesced.size() << " entries ("
+                  << coalescing.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    server.fail_from = SIZE_MAX;
+    InsertSpool shared_again;
+    shared_again.open(dir);
+    InsertPipeline coalescing_again(connection);
+    coalescing_again.encoder().set_columns({"wld_id", "wtp_id", "wptm_value"});
+    coalescing_again.set_insert_spool(&shared_again);
+    ok = coalescing_again.run("measurements", {other_file, test_file});
+    server.stop();
+    fs::remove(other_file);
+    if (!ok || server.rows != 2 * expected_rows || coalescing_again.stats().blocks_replayed != 1 ||
+        coalescing_again.stats().blocks_spooled != 0 || count_files(dir, ".chblock") != 0) {
+        std::cout << "FAIL: " << server.rows << " of " << 2 * expected_rows << " coalesced rows after replay ("
+                  << coalescing_again.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    fs::remove_all(dir);
+
+    std::cout << "PASS: spooled blocks survive failed inserts and are replayed once" << std::endl;
+    return 0;
+}
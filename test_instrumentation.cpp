@@ -0,0 +1,115 @@
+#include "cpp/include/instrumentation.h"
+#include "cpp/include/console_log.h"
+#include "cpp/include/ultra_fast_processor.h"
+#include <iostream>
+#include <sstream>
+
+static const StageStats* find_stage(const InstrumentationSnapshot& snapshot, InstrumentedStage stage) {
+    for (const StageStats& stats : snapshot.stages) {
+        if (std::string(stats.name) == stage_name(stage)) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+static uint64_t record_count(const InstrumentationSnapshot& snapshot, const char* type) {
+    for (const RecordTypeStats& record : snapshot.records) {
+        if (std::string(record.name) == type) {
+            return record.count;
+        }
+    }
+    return 0;
+}
+
+// Stage timers and record counters fill while a file is processed; quiet mode prints nothing
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Instrumentation Test ===" << std::endl;
+
+    if (counted_record_type(15, 10) != CountedRecordType::PTR || counted_record_type(5, 20) != CountedRecordType::PRR ||
+        counted_record_type(99, 1) != CountedRecordType::OTHER) {
+        std::cout << "FAIL: record type classification" << std::endl;
+        return 1;
+    }
+
+    Instrumentation::reset();
+
+    // Quiet mode: nothing reaches std::cout while the file is processed
+    std::ostringstream captured;
+    std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+    ConsoleLog::set_quiet(true);
+    UltraFastProcessor processor;
+    MeasurementBatch batch = processor.process_stdf_file_to_batch(test_file);
+    ConsoleLog::set_quiet(false);
+    std::cout.rdbuf(saved);
+
+    if (batch.size() == 0) {
+        std::cout << "FAIL: no measurements in " << test_file << std::endl;
+        return 1;
+    }
+    if (!captured.str().empty()) {
+        std::cout << "FAIL: quiet mode printed " << captured.str().size() << " bytes" << std::endl;
+        return 1;
+    }
+
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    if (!snapshot.compiled || !snapshot.enabled) {
+        std::cout << "SKIP: instrumentation compiled out" << std::endl;
+        return 0;
+    }
+
+    for (InstrumentedStage stage : {InstrumentedStage::PARSE, InstrumentedStage::FILE_PROCESSING,
+                                    InstrumentedStage::MEASUREMENT_GENERATION}) {
+        const StageStats* stats = find_stage(snapshot, stage);
+        if (!stats || stats->calls == 0 || stats->total_seconds <= 0.0 || stats->max_seconds > stats->total_seconds) {
+            std::cout << "FAIL: stage " << stage_name(stage) << " not timed" << std::endl;
+            return 1;
+        }
+        uint64_t histogram_calls = 0;
+        for (uint64_t bucket : stats->histogram) {
+            histogram_calls += bucket;
+        }
+        if (stats->histogram.size() != Instrumentation::HISTOGRAM_BUCKETS || histogram_calls != stats->calls) {
+            std::cout << "FAIL: histogram of " << stage_name(stage) << " holds " << histogram_calls
+                      << " of " << stats->calls << " calls" << std::endl;
+            return 1;
+        }
+        std::cout << "   " << stats->name << ": " << stats->calls << " call(s), " << stats->total_seconds << "s" << std::endl;
+    }
+
+    uint64_t total_records = 0;
+    for (const RecordTypeStats& record : snapshot.records) {
+        total_records += record.count;
+    }
+    if (record_count(snapshot, "PTR") == 0 || record_count(snapshot, "FAR") != 1 ||
+        total_records < processor.get_total_records()) {
+        std::cout << "FAIL: record counts (PTR " << record_count(snapshot, "PTR") << ", total "
+                  << total_records << ")" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << total_records << " records, " << record_count(snapshot, "PTR") << " PTR" << std::endl;
+
+    // Disabled at run time: nothing more is counted
+    Instrumentation::reset();
+    Instrumentation::set_enabled(false);
+    {
+        ConsoleLog::set_quiet(true);
+        UltraFastProcessor disabled;
+        disabled.process_stdf_file_to_batch(test_file);
+        ConsoleLog::set_quiet(false);
+    }
+    Instrumentation::set_enabled(true);
+    snapshot = Instrumentation::snapshot();
+    if (find_stage(snapshot, InstrumentedStage::PARSE)->calls != 0 || !snapshot.records.empty()) {
+        std::cout << "FAIL: counters moved while disabled" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: stages timed, records counted, quiet mode silent" << std::endl;
+    return 0;
+}
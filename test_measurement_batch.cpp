@@ -0,0 +1,58 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/measurement_batch.h"
+#include <iostream>
+
+// Dictionary-encoded rows must expand back to the tuple output
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Measurement Batch Test ===" << std::endl;
+
+    MeasurementColumn<std::string_view> column;
+    if (column.encode("a") != 0 || column.encode("b") != 1 || column.encode("a") != 0 || column.dictionary.size() != 2) {
+        std::cout << "FAIL: dictionary encoding" << std::endl;
+        return 1;
+    }
+
+    UltraFastProcessor tuple_processor;
+    tuple_processor.set_file_hash("hash");
+    auto tuples = tuple_processor.process_stdf_file(test_file);
+
+    UltraFastProcessor batch_processor;
+    batch_processor.set_file_hash("hash");
+    MeasurementBatch batch = batch_processor.process_stdf_file_to_batch(test_file);
+
+    if (tuples.empty() || batch.size() != tuples.size()) {
+        std::cout << "FAIL: row counts differ (" << batch.size() << " vs " << tuples.size() << ")" << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const MeasurementTuple& expected = tuples[i];
+        bool same = true;
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            same = same && batch.name[i] == expected.name;
+        #include "cpp/include/measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+        if (!same) {
+            std::cout << "FAIL: row " << i << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "   " << batch.size() << " rows; dictionaries: file_hash " << batch.file_hash.dictionary.size()
+              << ", wld_device_dmc " << batch.wld_device_dmc.dictionary.size()
+              << ", wtp_param_name " << batch.wtp_param_name.dictionary.size()
+              << ", units " << batch.units.dictionary.size() << std::endl;
+
+    if (batch.file_hash.dictionary.size() != 1 || batch.wtp_param_name.dictionary.size() > batch.size()) {
+        std::cout << "FAIL: dictionaries are not deduplicated" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: dictionary-encoded batch matches the tuples" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/measurement_sort.h"
+#include "cpp/include/measurement_macros.h"
+#include "test_support/measurement_compare.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <tuple>
+
+// The ORDER BY key of a row, for comparing with std::stable_sort
+static auto key_of(const MeasurementTuple& row) {
+    return std::make_tuple(row.wld_id, row.wtp_id, row.wp_pos_x, row.wp_pos_y, row.segment);
+}
+
+// Rows of batch in the order std::stable_sort gives by the key
+static std::vector<MeasurementTuple> stable_sorted(const MeasurementBatch& batch) {
+    std::vector<MeasurementTuple> rows = batch.to_tuples();
+    std::stable_sort(rows.begin(), rows.end(),
+                     [](const MeasurementTuple& a, const MeasurementTuple& b) { return key_of(a) < key_of(b); });
+    return rows;
+}
+
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Measurement Sort Test ===" << std::endl;
+
+    // The schema's ORDER BY comes from the same key list
+    GENERATE_CLICKHOUSE_SCHEMA();
+    if (schema.find("ORDER BY (wld_id, wtp_id, wp_pos_x, wp_pos_y, segment)") == std::string::npos) {
+        std::cout << "FAIL: schema ORDER BY: " << schema << std::endl;
+        return 1;
+    }
+
+    // Negative positions, wide IDs, ties (kept in row order via wptm_value);
+    // the string columns are all code 0
+    MeasurementBatch synthetic;
+    synthetic.resize(5000);
+    synthetic.file_hash.encode("hash");
+    synthetic.wld_device_dmc.encode("DMC");
+    synthetic.wtp_param_name.encode("VDD");
+    synthetic.units.encode("V");
+    for (size_t i = 0; i < synthetic.size(); ++i) {
+        synthetic.wld_id.values[i] = static_cast<uint32_t>((i * 7919) % 13) * 100000u;
+        synthetic.wtp_id.values[i] = static_cast<uint32_t>((i * 104729) % 7);
+        synthetic.wp_pos_x.values[i] = static_cast<int32_t>((i * 31) % 9) - 4;
+        synthetic.wp_pos_y.values[i] = (i % 3 == 0) ? -70000 : 70000;
+        synthetic.segment.values[i] = static_cast<uint8_t>(i % 2);
+        synthetic.wptm_value.values[i] = static_cast<double>(i);
+    }
+    const std::vector<MeasurementTuple> synthetic_expected = stable_sorted(synthetic);
+    if (!sort_measurements_by_key(synthetic) || !same_rows(synthetic, synthetic_expected) ||
+        !measurements_sorted_by_key(synthetic) || sort_measurements_by_key(synthetic)) {
+        std::cout << "FAIL: synthetic batch not stably sorted by the key" << std::endl;
+        return 1;
+    }
+
+    // Sample file: every emitted batch is the file-order batch, stably sorted
+    const size_t batch_rows = 100000;
+    std::vector<MeasurementBatch> file_order;
+    UltraFastProcessor plain;
+    plain.set_file_hash("hash");
+    plain.process_stdf_file_in_batches(test_file, batch_rows, [&](MeasurementBatch& batch) {
+        file_order.push_back(std::move(batch));
+        return true;
+    });
+
+    UltraFastProcessor sorted_processor;
+    sorted_processor.set_file_hash("hash");
+    sorted_processor.set_sort_output(true);
+    size_t index = 0;
+    bool same = true;
+    sorted_processor.process_stdf_file_in_batches(test_file, batch_rows, [&](MeasurementBatch& batch) {
+        same = same && index < file_order.size() && same_rows(batch, stable_sorted(file_order[index]));
+        ++index;
+        return same;
+    });
+    if (file_order.empty() || !same || index != file_order.size()) {
+        std::cout << "FAIL: presorted batch " << index - 1 << " of " << file_order.size() << " differs" << std::endl;
+        return 1;
+    }
+    if (measurements_sorted_by_key(file_order.front())) {
+        std::cout << "FAIL: file-order batch already sorted, nothing was tested" << std::endl;
+        return 1;
+    }
+
+    // The whole file as one batch: radix order vs std::stable_sort
+    MeasurementBatch whole = plain.process_stdf_file_to_batch(test_file);
+    auto start = std::chrono::steady_clock::now();
+    const std::vector<uint32_t> order = measurement_key_order(whole);
+    const double radix_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::vector<uint32_t> reference(whole.size());
+    for (uint32_t i = 0; i < reference.size(); ++i) {
+        reference[i] = i;
+    }
+    start = std::chrono::steady_clock::now();
+    std::stable_sort(reference.begin(), reference.end(), [&whole](uint32_t a, uint32_t b) {
+        return std::make_tuple(whole.wld_id[a], whole.wtp_id[a], whole.wp_pos_x[a], whole.wp_pos_y[a], whole.segment[a]) <
+               std::make_tuple(whole.wld_id[b], whole.wtp_id[b], whole.wp_pos_x[b], whole.wp_pos_y[b], whole.segment[b]);
+    });
+    const double comparison_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (order != reference) {
+        std::cout << "FAIL: radix order differs from std::stable_sort" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   " << whole.size() << " rows: radix order " << radix_ms << " ms, std::stable_sort "
+              << comparison_ms << " ms" << std::endl;
+    std::cout << "PASS: batches presorted by the ORDER BY key, stably" << std::endl;
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "cpp/include/batch_ingest_engine.h"
+#include "cpp/include/measurement_spool.h"
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// Row `row` of batch equals row `expected_row` of expected, strings by value
+static bool same_row(const MeasurementBatch& batch, size_t row, const MeasurementBatch& expected, size_t expected_row) {
+    bool same = true;
+    #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+        same = same && batch.name[row] == expected.name[expected_row];
+    #include "cpp/include/measurement_fields.def"
+    #undef MEASUREMENT_FIELD
+    return same;
+}
+
+// A memory budget must bound the staged rows without changing them
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Measurement Spool Test ===" << std::endl;
+
+    const std::vector<std::string> paths = {test_file, test_file, test_file};
+    BatchIngestEngine in_memory;
+    in_memory.set_num_threads(3);
+    in_memory.set_file_hashes({"hash", "hash", "hash"});
+    if (!in_memory.process_files(paths)) {
+        std::cout << "FAIL: in-memory batch ingest failed" << std::endl;
+        return 1;
+    }
+    const MeasurementBatch& expected = in_memory.measurements();
+
+    const fs::path spill_dir = fs::temp_directory_path() / "test_measurement_spool";
+    fs::remove_all(spill_dir);
+    const size_t budget = 8 << 20;
+    BatchIngestEngine budgeted;
+    budgeted.set_num_threads(3);
+    budgeted.set_file_hashes({"hash", "hash", "hash"});
+    budgeted.set_memory_budget(budget, spill_dir.string());
+    if (!budgeted.process_files(paths) || budgeted.measurements().size() != 0) {
+        std::cout << "FAIL: budgeted batch ingest failed or merged its rows" << std::endl;
+        return 1;
+    }
+
+    MeasurementSpoolStats spooled = budgeted.spool()->stats();
+    if (spooled.rows != expected.size() || spooled.spilled_blocks == 0 || spooled.peak_memory_bytes > budget ||
+        fs::is_empty(spill_dir)) {
+        std::cout << "FAIL: " << spooled.spilled_blocks << " of " << spooled.blocks << " blocks spilled, peak "
+                  << spooled.peak_memory_bytes << " bytes for a budget of " << budget << std::endl;
+        return 1;
+    }
+
+    // Blocks come back in file order and hold the in-memory rows
+    size_t row = 0;
+    size_t last_file = 0;
+    bool ordered = true;
+    bool drained = budgeted.drain_measurements([&](size_t file, MeasurementBatch& batch) {
+        ordered = ordered && file >= last_file && file < paths.size();
+        last_file = file;
+        for (size_t i = 0; ordered && i < batch.size(); ++i, ++row) {
+            ordered = row < expected.size() && same_row(batch, i, expected, row);
+        }
+        return ordered;
+    });
+    if (!drained || !ordered || row != expected.size()) {
+        std::cout << "FAIL: drained rows differ from the in-memory batch at row " << row << std::endl;
+        return 1;
+    }
+    if (!fs::is_empty(spill_dir) || budgeted.spool()->memory_bytes() != 0) {
+        std::cout << "FAIL: draining left spill files or memory behind" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   " << spooled.rows << " rows in " << spooled.blocks << " blocks, " << spooled.spilled_blocks
+              << " spilled as " << spooled.spilled_bytes << " bytes; peak " << spooled.peak_memory_bytes
+              << " bytes in memory vs " << MeasurementSpool::batch_bytes(expected) << " merged" << std::endl;
+    fs::remove_all(spill_dir);
+    std::cout << "PASS: a memory budget spills and streams back the same rows" << std::endl;
+    return 0;
+}
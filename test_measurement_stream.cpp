@@ -0,0 +1,80 @@
+#include "cpp/include/measurement_stream.h"
+#include "cpp/include/ultra_fast_processor.h"
+#include <iostream>
+
+// Batches handed over while parsing runs must concatenate to the whole-file batch
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Measurement Stream Test ===" << std::endl;
+
+    UltraFastProcessor whole_processor;
+    whole_processor.set_file_hash("hash");
+    MeasurementBatch whole = whole_processor.process_stdf_file_to_batch(test_file);
+    if (whole.size() == 0) {
+        std::cout << "FAIL: no measurements in " << test_file << std::endl;
+        return 1;
+    }
+
+    const size_t batch_rows = 50000;
+    MeasurementStream stream;
+    stream.processor().set_file_hash("hash");
+    stream.start(test_file, batch_rows);
+
+    size_t row = 0;
+    size_t batches = 0;
+    MeasurementBatch batch;
+    while (stream.next(batch)) {
+        if (batch.size() == 0 || batch.size() > batch_rows) {
+            std::cout << "FAIL: batch " << batches << " has " << batch.size() << " rows" << std::endl;
+            return 1;
+        }
+        bool last = row + batch.size() == whole.size();
+        if (batch.size() != batch_rows && !last) {
+            std::cout << "FAIL: short batch before the end" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < batch.size(); ++i, ++row) {
+            bool same = row < whole.size();
+            #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+                same = same && batch.name[i] == whole.name[row];
+            #include "cpp/include/measurement_fields.def"
+            #undef MEASUREMENT_FIELD
+            if (!same) {
+                std::cout << "FAIL: row " << row << " differs" << std::endl;
+                return 1;
+            }
+        }
+        batches++;
+    }
+
+    if (!stream.finished() || !stream.succeeded() || row != whole.size() ||
+        stream.processor().get_processed_measurements() != whole.size()) {
+        std::cout << "FAIL: stream ended after " << row << " of " << whole.size() << " rows ("
+                  << stream.get_last_error() << ")" << std::endl;
+        return 1;
+    }
+    std::cout << "   " << row << " rows in " << batches << " batches" << std::endl;
+
+    // Abandoning a stream early stops the producer
+    {
+        MeasurementStream abandoned;
+        abandoned.start(test_file, 1000);
+        MeasurementBatch first;
+        if (!abandoned.next(first) || first.size() != 1000) {
+            std::cout << "FAIL: first batch of the abandoned stream" << std::endl;
+            return 1;
+        }
+        abandoned.cancel();
+        if (abandoned.next(first)) {
+            std::cout << "FAIL: batch after cancel" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: streamed batches match the whole-file batch" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/mapped_file.h"
+#include <iostream>
+#include <map>
+
+// Compares the libstdf and memory-mapped backends record by record
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Memory-mapped Parser Test ===" << std::endl;
+
+    STDFParser libstdf_parser;
+    libstdf_parser.set_native_io(false);
+    auto libstdf_records = libstdf_parser.parse_file(test_file);
+
+    STDFParser mmap_parser;
+    mmap_parser.set_backend(STDFParserBackend::MMAP);
+    auto mmap_records = mmap_parser.parse_file(test_file);
+
+    std::cout << "libstdf records: " << libstdf_records.size()
+              << " (total " << libstdf_parser.get_total_records() << ")" << std::endl;
+    std::cout << "mmap records:    " << mmap_records.size()
+              << " (total " << mmap_parser.get_total_records() << ")" << std::endl;
+
+    if (libstdf_records.empty()) {
+        std::cout << "FAIL: no records parsed" << std::endl;
+        return 1;
+    }
+
+    if (libstdf_records.size() != mmap_records.size() ||
+        libstdf_parser.get_total_records() != mmap_parser.get_total_records()) {
+        std::cout << "FAIL: record counts differ" << std::endl;
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    std::map<std::string, int> type_counts;
+
+    for (size_t i = 0; i < libstdf_records.size(); ++i) {
+        const STDFRecord& a = libstdf_records[i];
+        const STDFRecord& b = mmap_records[i];
+
+        if (a.type != b.type || a.record_index != b.record_index || a.fields != b.fields) {
+            if (mismatches < 5) {
+                std::cout << "Mismatch at record " << i << " (index " << a.record_index << ")" << std::endl;
+                for (const auto& field : a.fields) {
+                    auto it = b.fields.find(field.first);
+                    std::string other = (it != b.fields.end()) ? it->second : "<missing>";
+                    if (other != field.second) {
+                        std::cout << "   " << field.first << ": '" << field.second
+                                  << "' vs '" << other << "'" << std::endl;
+                    }
+                }
+            }
+            mismatches++;
+        }
+
+        auto type_it = a.fields.find("RECORD_TYPE");
+        type_counts[type_it != a.fields.end() ? type_it->second : "MIR"]++;
+    }
+
+    for (const auto& entry : type_counts) {
+        std::cout << "   " << entry.first << ": " << entry.second << std::endl;
+    }
+
+    if (mismatches > 0) {
+        std::cout << "FAIL: " << mismatches << " records differ between backends" << std::endl;
+        return 1;
+    }
+
+    // Native I/O on the libstdf backend, and files read rather than mapped
+    // (as on network shares), decode the same records
+    STDFParser native_parser;
+    native_parser.set_native_io(true);
+    auto native_records = native_parser.parse_file(test_file);
+
+    MappedFile::set_default_read_mode(FileReadMode::READ);
+    MappedFile read_file;
+    const bool read_ok = read_file.open(test_file) && !read_file.is_mapped();
+    STDFParser read_parser;
+    read_parser.set_backend(STDFParserBackend::MMAP);
+    auto read_records = read_parser.parse_file(test_file);
+    MappedFile::set_default_read_mode(FileReadMode::AUTO);
+
+    for (const auto* records : {&native_records, &read_records}) {
+        bool same = records->size() == libstdf_records.size();
+        for (size_t i = 0; same && i < records->size(); ++i) {
+            same = (*records)[i].type == libstdf_records[i].type && (*records)[i].fields == libstdf_records[i].fields;
+        }
+        if (!same || !read_ok) {
+            std::cout << "FAIL: native I/O / buffered reads differ from libstdf" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: backends produce identical records" << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/columnar_store.h"
+#include "cpp/include/numeric_convert.h"
+#include <iostream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+// Bulk R4 -> double must be exact for every tail length and special value
+static bool check_conversion() {
+    std::vector<float> input = {0.0f, -0.0f, 1.5f, -274.25f, 3.4e38f, 1.0e-45f,
+                                std::numeric_limits<float>::infinity(),
+                                -std::numeric_limits<float>::infinity(),
+                                std::numeric_limits<float>::quiet_NaN()};
+    while (input.size() < 41) {
+        input.push_back(static_cast<float>(input.size()) * 0.1f);
+    }
+
+    for (size_t count = 0; count <= input.size(); ++count) {
+        std::vector<double> output(count + 1, 42.0);
+        convert_r4_to_double(input.data(), count, output.data());
+        for (size_t i = 0; i < count; ++i) {
+            double expected = input[i];
+            if (std::memcmp(&output[i], &expected, sizeof(double)) != 0) {
+                std::cout << "FAIL: conversion of element " << i << " (count " << count << ")" << std::endl;
+                return false;
+            }
+        }
+        if (output[count] != 42.0) {
+            std::cout << "FAIL: conversion wrote past " << count << " elements" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// RTN_RSLT text in the record maps must parse back to the exact floats
+static bool check_result_text(const std::vector<STDFRecord>& records, const STDFColumnarStore& store) {
+    size_t row = 0;
+    for (const auto& record : records) {
+        if (record.type != STDFRecordType::MPR) continue;
+
+        auto it = record.fields.find("RTN_RSLT");
+        const std::string text = (it != record.fields.end()) ? it->second : std::string();
+        const float* results = store.mpr_results(row);
+
+        size_t start = 0;
+        for (size_t i = 0; i < store.mpr_result_count(row); ++i) {
+            size_t comma = text.find(',', start);
+            float parsed = std::strtof(text.substr(start, comma - start).c_str(), nullptr);
+            if (!(parsed == results[i] || (std::isnan(parsed) && std::isnan(results[i])))) {
+                std::cout << "FAIL: MPR row " << row << " result " << i << " text '" << text << "'" << std::endl;
+                return false;
+            }
+            start = comma + 1;
+        }
+        row++;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== MPR Arrays Test ===" << std::endl;
+    std::cout << "   R4 conversion kernel: " << convert_r4_implementation() << std::endl;
+
+    if (!check_conversion()) {
+        return 1;
+    }
+
+    STDFColumnarStore stores[2];
+    const STDFParserBackend backends[2] = {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP};
+    for (int b = 0; b < 2; ++b) {
+        STDFParser parser;
+        parser.set_backend(backends[b]);
+        if (!parser.parse_to_columns(test_file, stores[b]) || stores[b].mpr.size() == 0) {
+            std::cout << "FAIL: no MPR rows parsed" << std::endl;
+            return 1;
+        }
+    }
+
+    const STDFColumnarStore& store = stores[1];
+    size_t pins = 0;
+    for (size_t row = 0; row < store.mpr.size(); ++row) {
+        if (store.mpr.state_offset[row] != pins || store.mpr.pin_offset[row] != pins) {
+            std::cout << "FAIL: MPR row " << row << " state/pin offsets out of step" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < store.mpr_pin_count(row); ++i) {
+            if (store.mpr_states(row)[i] > 0x0F) {
+                std::cout << "FAIL: RTN_STAT nibble out of range" << std::endl;
+                return 1;
+            }
+        }
+        pins += store.mpr_pin_count(row);
+    }
+    std::cout << "   MPR " << store.mpr.size() << ", pins " << pins << std::endl;
+
+    if (stores[0].state_pool != stores[1].state_pool || stores[0].pin_pool != stores[1].pin_pool ||
+        stores[0].float_pool != stores[1].float_pool) {
+        std::cout << "FAIL: typed MPR arrays differ between backends" << std::endl;
+        return 1;
+    }
+
+    STDFParser record_parser;
+    record_parser.set_backend(STDFParserBackend::MMAP);
+    if (!check_result_text(record_parser.parse_file(test_file), store)) {
+        return 1;
+    }
+
+    std::cout << "PASS: MPR arrays stay typed and exact" << std::endl;
+    return 0;
+}
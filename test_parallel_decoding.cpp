@@ -0,0 +1,86 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/columnar_store.h"
+#include "cpp/include/ultra_fast_processor.h"
+#include <iostream>
+
+// Parallel chunked decoding must reproduce the sequential output exactly
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Parallel Decoding Test ===" << std::endl;
+
+    // Records
+    STDFParser sequential;
+    sequential.set_backend(STDFParserBackend::MMAP);
+    auto expected = sequential.parse_file(test_file);
+
+    STDFParser parallel;
+    parallel.set_num_threads(4);
+    auto actual = parallel.parse_file(test_file);
+
+    if (expected.empty() || expected.size() != actual.size() ||
+        sequential.get_total_records() != parallel.get_total_records()) {
+        std::cout << "FAIL: record counts differ (" << expected.size() << " vs " << actual.size() << ")" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].type != actual[i].type || expected[i].record_index != actual[i].record_index ||
+            expected[i].fields != actual[i].fields) {
+            std::cout << "FAIL: record " << i << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    // Columns (string ids are remapped on merge, so compare resolved values)
+    STDFColumnarStore expected_store;
+    STDFColumnarStore actual_store;
+    sequential.parse_to_columns(test_file, expected_store);
+    parallel.parse_to_columns(test_file, actual_store);
+
+    if (expected_store.size() != actual_store.size() ||
+        expected_store.mpr.record_index != actual_store.mpr.record_index ||
+        expected_store.float_pool != actual_store.float_pool ||
+        expected_store.ptr.RESULT != actual_store.ptr.RESULT) {
+        std::cout << "FAIL: columnar stores differ" << std::endl;
+        return 1;
+    }
+    for (size_t row = 0; row < expected_store.mpr.size(); ++row) {
+        if (expected_store.str(expected_store.mpr.TEST_TXT[row]) != actual_store.str(actual_store.mpr.TEST_TXT[row]) ||
+            expected_store.mpr_result_count(row) != actual_store.mpr_result_count(row) ||
+            expected_store.mpr_results(row)[0] != actual_store.mpr_results(row)[0]) {
+            std::cout << "FAIL: MPR row " << row << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    // Measurements
+    UltraFastProcessor single;
+    single.set_file_hash("test");
+    auto expected_measurements = single.process_stdf_file(test_file);
+
+    UltraFastProcessor multi;
+    multi.set_file_hash("test");
+    multi.set_num_threads(4);
+    auto actual_measurements = multi.process_stdf_file(test_file);
+
+    if (expected_measurements.size() != actual_measurements.size()) {
+        std::cout << "FAIL: measurement counts differ" << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < expected_measurements.size(); ++i) {
+        const MeasurementTuple& a = expected_measurements[i];
+        const MeasurementTuple& b = actual_measurements[i];
+        if (a.wld_id != b.wld_id || a.wtp_id != b.wtp_id || a.wptm_value != b.wptm_value ||
+            a.wp_pos_x != b.wp_pos_x || a.wp_pos_y != b.wp_pos_y || a.wtp_param_name != b.wtp_param_name) {
+            std::cout << "FAIL: measurement " << i << " differs" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "   records: " << actual.size() << ", measurements: " << actual_measurements.size() << std::endl;
+    std::cout << "PASS: parallel decoding matches sequential output" << std::endl;
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "cpp/include/part_association.h"
+#include <iostream>
+#include <cstring>
+#include <random>
+#include <map>
+
+static void add_pir(STDFColumnarStore& store, uint8_t site, uint32_t record_index) {
+    rec_pir pir;
+    std::memset(&pir, 0, sizeof(pir));
+    pir.HEAD_NUM = 1;
+    pir.SITE_NUM = site;
+    store.append(pir, record_index);
+}
+
+static void add_prr(STDFColumnarStore& store, uint8_t site, uint32_t record_index, uint8_t head = 1) {
+    rec_prr prr;
+    std::memset(&prr, 0, sizeof(prr));
+    prr.HEAD_NUM = head;
+    prr.SITE_NUM = site;
+    store.append(prr, record_index);
+}
+
+// One record stream walked with a single pending list per site
+static std::vector<std::vector<uint32_t>> reference_parts(const STDFColumnarStore& store,
+                                                          const std::vector<TestSite>& tests, size_t& orphaned) {
+    std::map<uint32_t, std::vector<uint32_t>> pending;
+    std::vector<std::vector<uint32_t>> parts;
+    size_t i_test = 0, i_pir = 0, i_prr = 0;
+    orphaned = 0;
+    while (i_test < tests.size() || i_prr < store.prr.size()) {
+        uint32_t next_test = i_test < tests.size() ? tests[i_test].record_index : UINT32_MAX;
+        uint32_t next_pir = i_pir < store.pir.size() ? store.pir.record_index[i_pir] : UINT32_MAX;
+        uint32_t next_prr = i_prr < store.prr.size() ? store.prr.record_index[i_prr] : UINT32_MAX;
+        if (next_pir <= next_test && next_pir <= next_prr) {
+            auto& open = pending[store.pir.HEAD_NUM[i_pir] << 8 | store.pir.SITE_NUM[i_pir]];
+            orphaned += open.size();
+            open.clear();
+            ++i_pir;
+        } else if (next_test <= next_prr) {
+            pending[tests[i_test].head_num << 8 | tests[i_test].site_num].push_back(static_cast<uint32_t>(i_test));
+            ++i_test;
+        } else {
+            auto& open = pending[store.prr.HEAD_NUM[i_prr] << 8 | store.prr.SITE_NUM[i_prr]];
+            parts.push_back(open);
+            open.clear();
+            ++i_prr;
+        }
+    }
+    for (const auto& open : pending) {
+        orphaned += open.second.size();
+    }
+    return parts;
+}
+
+static bool expect_part(const PartAssociation& parts, size_t part, std::vector<uint32_t> expected) {
+    std::vector<uint32_t> actual(parts.begin(part), parts.end(part));
+    if (actual != expected) {
+        std::cout << "FAIL: part " << part << " has " << actual.size() << " tests, expected "
+                  << expected.size() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Part Association Test ===" << std::endl;
+    bool ok = true;
+
+    // Two sites tested concurrently, plus a stray test on site 1 before its PIR
+    //   1 PTR s1 (orphan)  2 PIR s1  3 PIR s2  4 PTR s1  5 PTR s2  6 PTR s2
+    //   7 PRR s2           8 PTR s1  9 PRR s1  10 PTR s2 (never closed)
+    STDFColumnarStore store;
+    add_pir(store, 1, 2);
+    add_pir(store, 2, 3);
+    add_prr(store, 2, 7);
+    add_prr(store, 1, 9);
+    std::vector<TestSite> tests = {{1, 1, 1}, {4, 1, 1}, {5, 1, 2}, {6, 1, 2}, {8, 1, 1}, {10, 1, 2}};
+
+    PartAssociation parts;
+    parts.build(store, tests);
+    ok &= parts.part_count() == 2;
+    ok &= expect_part(parts, 0, {2, 3});
+    ok &= expect_part(parts, 1, {1, 4});
+    if (parts.orphaned_tests() != 2) {
+        std::cout << "FAIL: " << parts.orphaned_tests() << " orphaned tests, expected 2" << std::endl;
+        ok = false;
+    }
+
+    // No PIR records: each PRR takes everything since the previous PRR of its site
+    STDFColumnarStore no_pir;
+    add_prr(no_pir, 1, 3);
+    add_prr(no_pir, 1, 5);
+    parts.build(no_pir, {{1, 1, 1}, {2, 1, 1}, {4, 1, 1}});
+    ok &= parts.part_count() == 2;
+    ok &= expect_part(parts, 0, {0, 1});
+    ok &= expect_part(parts, 1, {2});
+
+    // Two test heads of eight sites each, interleaved at random; lanes on
+    // any number of threads give the single-stream result
+    STDFColumnarStore multi_site;
+    std::vector<TestSite> multi_tests;
+    std::mt19937 random(7);
+    std::vector<bool> open(16, false);
+    for (uint32_t record_index = 1; record_index <= 20000; ++record_index) {
+        uint8_t lane = static_cast<uint8_t>(random() % 16);
+        uint8_t head = static_cast<uint8_t>(1 + lane / 8);
+        uint8_t site = static_cast<uint8_t>(lane % 8);
+        uint32_t event = random() % 20;
+        if (!open[lane] || event == 0) {
+            rec_pir pir;
+            std::memset(&pir, 0, sizeof(pir));
+            pir.HEAD_NUM = head;
+            pir.SITE_NUM = site;
+            multi_site.append(pir, record_index);
+            open[lane] = true;
+        } else if (event == 1) {
+            add_prr(multi_site, site, record_index, head);
+            open[lane] = false;
+        } else {
+            multi_tests.push_back({record_index, head, site});
+        }
+    }
+    size_t expected_orphans = 0;
+    std::vector<std::vector<uint32_t>> expected = reference_parts(multi_site, multi_tests, expected_orphans);
+    for (size_t threads : {1, 4}) {
+        parts.build(multi_site, multi_tests, threads);
+        bool same = parts.part_count() == expected.size() && parts.orphaned_tests() == expected_orphans &&
+                    parts.lane_count() == 16;
+        for (size_t part = 0; same && part < expected.size(); ++part) {
+            same = std::vector<uint32_t>(parts.begin(part), parts.end(part)) == expected[part];
+        }
+        if (!same) {
+            std::cout << "FAIL: " << threads << "-thread site lanes differ from the single-stream walk" << std::endl;
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: tests attach to their own PIR..PRR bracket" << std::endl;
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "cpp/include/pin_fail_map.h"
+#include "cpp/include/stdf_parser.h"
+#include "test_support/stdf_record_writer.h"
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+static void write_ftr(std::ofstream& out, uint8_t site, uint16_t bit_count, std::initializer_list<size_t> pins,
+                      uint8_t tail_junk = 0) {
+    RecordWriter ftr;
+    ftr.u4(100);                                   // TEST_NUM
+    ftr.u1(1); ftr.u1(site);                       // HEAD_NUM, SITE_NUM
+    ftr.u1(pins.size() ? 0x80 : 0); ftr.u1(0xFF);  // TEST_FLG, OPT_FLAG
+    for (int i = 0; i < 6; ++i) ftr.u4(0);         // CYCL_CNT .. YFAIL_AD
+    ftr.u2(0);                                     // VECT_OFF
+    ftr.u2(3); ftr.u2(0);                          // RTN_ICNT, PGM_ICNT
+    ftr.u2(5); ftr.u2(6); ftr.u2(7);               // RTN_INDX
+    ftr.u1(0x21); ftr.u1(0x03);                    // RTN_STAT 1, 2, 3
+    ftr.dn(bit_count, pins, tail_junk);            // FAIL_PIN
+    for (int i = 0; i < 7; ++i) ftr.cn("");        // VECT_NAM .. RSLT_TXT
+    ftr.u1(0);                                     // PATG_NUM
+    ftr.dn(8, {0});                                // SPIN_MAP
+    ftr.write(out, 15, 20);
+}
+
+static void write_prr(std::ofstream& out, uint8_t site, uint16_t hard_bin, const std::string& part_id) {
+    RecordWriter prr;
+    prr.u1(1); prr.u1(site); prr.u1(0); prr.u2(1);
+    prr.u2(hard_bin); prr.u2(hard_bin);
+    prr.u2(0); prr.u2(0); prr.u4(0);
+    prr.cn(part_id); prr.cn(""); prr.u1(0);
+    prr.write(out, 5, 20);
+}
+
+// Kernels agree with a bit-by-bit reference for every length and offset
+static bool check_kernels() {
+    std::mt19937 random(7);
+    for (size_t bytes = 0; bytes < 200; ++bytes) {
+        std::vector<uint8_t> a(bytes + 1), b(bytes + 1);
+        for (size_t i = 0; i <= bytes; ++i) {
+            // Sparse and dense maps
+            a[i] = static_cast<uint8_t>(bytes % 3 ? random() & random() & random() : random());
+            b[i] = static_cast<uint8_t>(random());
+        }
+        size_t expected = 0;
+        for (size_t i = 0; i < bytes; ++i) expected += static_cast<size_t>(__builtin_popcount(a[i]));
+        if (bitset_count(a.data(), bytes) != expected) {
+            std::cout << "FAIL: popcount of " << bytes << " bytes" << std::endl;
+            return false;
+        }
+
+        const size_t bit_count = bytes * 8 > 3 ? bytes * 8 - 3 : 0;
+        std::vector<uint32_t> counts(bytes * 8 + 8, 1);
+        bitset_accumulate(counts.data(), a.data(), bit_count);
+        for (size_t bit = 0; bit < counts.size(); ++bit) {
+            uint32_t set = bit < bit_count ? (a[bit / 8] >> (bit % 8)) & 1 : 0;
+            if (counts[bit] != 1 + set) {
+                std::cout << "FAIL: accumulate of " << bit_count << " bits at bit " << bit << std::endl;
+                return false;
+            }
+        }
+
+        std::vector<uint8_t> ored = a, anded = a;
+        bitset_or(ored.data(), b.data(), bytes);
+        bitset_and(anded.data(), b.data(), bytes);
+        for (size_t i = 0; i <= bytes; ++i) {
+            uint8_t want_or = i < bytes ? a[i] | b[i] : a[i];
+            uint8_t want_and = i < bytes ? a[i] & b[i] : a[i];
+            if (ored[i] != want_or || anded[i] != want_and) {
+                std::cout << "FAIL: or/and of " << bytes << " bytes at byte " << i << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Pin Fail Map Test ===" << std::endl;
+    std::cout << "   bitset kernel: " << bitset_implementation() << std::endl;
+    if (!check_kernels()) {
+        return 1;
+    }
+
+    // Part A on site 0 and part B on site 1 are tested interleaved; part C
+    // follows on site 0 with a map whose only set bits lie past its count
+    const std::string path = "/tmp/test_pin_fail_map.stdf";
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        RecordWriter far;
+        far.u1(2); far.u1(4);
+        far.write(out, 0, 10);
+        write_ftr(out, 0, 70, {3, 69}, 0x80);
+        write_ftr(out, 1, 41, {3, 40});
+        write_ftr(out, 0, 70, {3, 10});
+        write_ftr(out, 0, 0, {});
+        write_prr(out, 0, 5, "A");
+        write_prr(out, 1, 7, "B");
+        write_ftr(out, 0, 4, {}, 0xF0);
+        write_prr(out, 0, 1, "C");
+    }
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        // Typed views over the raw FTR
+        STDFParser parser;
+        parser.set_backend(backend);
+        size_t checked = 0;
+        bool views_ok = false;
+        bool read = parser.stream_views(path, [&](STDFRecordView& view) {
+            if (view.type() != STDFRecordType::FTR || checked++ > 0) return;
+            std::vector<uint16_t> indices;
+            STDFBitsView fail_pins = view.get_bits("FAIL_PIN");
+            STDFNibblesView states = view.get_nibbles("RTN_STAT");
+            views_ok = fail_pins.bit_count == 70 && fail_pins.test(3) && fail_pins.test(69) && !fail_pins.test(68) &&
+                       !fail_pins.test(71) && view.get_bits("SPIN_MAP").test(0) &&
+                       states.size() == 3 && states[0] == 1 && states[1] == 2 && states[2] == 3 &&
+                       view.get_u2s("RTN_INDX", indices) == 3 && indices[2] == 7 &&
+                       view.get_bits("TEST_TXT").empty() && view.get_nibbles("FAIL_PIN").size() == 0;
+        });
+        if (!read || !views_ok || checked != 5) {
+            std::cout << "FAIL: FTR bit/nibble views are wrong" << std::endl;
+            return 1;
+        }
+
+        PinFailMap map;
+        if (!map.add_file(path, backend)) {
+            std::cout << "FAIL: " << map.get_last_error() << std::endl;
+            return 1;
+        }
+        const auto& ftr_fails = map.ftr_fail_counts();
+        const auto& part_fails = map.part_fail_counts();
+        const auto& parts = map.parts();
+        const std::vector<uint8_t> common = map.common_fail_pins();
+        size_t common_pins = bitset_count(common.data(), common.size());
+        bool ok = map.ftr_count() == 5 && map.pin_count() == 70 && map.unfinished_parts() == 0 &&
+                  ftr_fails[3] == 3 && ftr_fails[10] == 1 && ftr_fails[40] == 1 && ftr_fails[69] == 1 &&
+                  std::accumulate(ftr_fails.begin(), ftr_fails.end(), 0u) == 6 &&
+                  part_fails[3] == 2 && part_fails[10] == 1 && part_fails[40] == 1 && part_fails[69] == 1 &&
+                  parts.size() == 3 && parts[0].part_id == "A" && parts[0].hard_bin == 5 &&
+                  parts[0].ftr_count == 3 && parts[0].failed_ftrs == 2 && parts[0].failing_pins() == 3 &&
+                  parts[1].part_id == "B" && parts[1].site_num == 1 && parts[1].failing_pins() == 2 &&
+                  parts[2].part_id == "C" && parts[2].ftr_count == 1 && parts[2].failed_ftrs == 0 &&
+                  common_pins == 1 && (common[0] & 0x08);
+        if (!ok) {
+            std::cout << "FAIL: pin fail counts or part maps are wrong" << std::endl;
+            return 1;
+        }
+    }
+
+    std::remove(path.c_str());
+    std::cout << "PASS: FTR fail maps are read in place and counted per pin and part" << std::endl;
+    return 0;
+}
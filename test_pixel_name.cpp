@@ -0,0 +1,97 @@
+#include "cpp/include/pixel_name.h"
+#include <iostream>
+#include <regex>
+#include <random>
+#include <vector>
+
+// The std::regex implementation the scanner replaces
+static void regex_reference(const std::string& name, std::string& cleaned, int32_t& x, int32_t& y) {
+    static const std::regex pixel_pattern(R"(Pixel=R(\d+)C(\d+))");
+    static const std::regex clean_pattern1(R"(;Pixel=R\d+C\d+)");
+    static const std::regex clean_pattern2(R"(^Pixel=R\d+C\d+;)");
+
+    x = 0;
+    y = 0;
+    std::smatch match;
+    if (std::regex_search(name, match, pixel_pattern)) {
+        try {
+            int32_t row = std::stoi(match[1].str());
+            int32_t col = std::stoi(match[2].str());
+            x = col;
+            y = row;
+        } catch (...) {
+        }
+    }
+
+    cleaned = std::regex_replace(name, clean_pattern1, "");
+    cleaned = std::regex_replace(cleaned, clean_pattern2, "");
+}
+
+static bool check(const std::string& name) {
+    std::string expected_name;
+    int32_t expected_x, expected_y;
+    regex_reference(name, expected_name, expected_x, expected_y);
+
+    PixelName actual;
+    parse_pixel_name(name, actual);
+
+    int32_t x, y;
+    extract_pixel_coordinates(name, x, y);
+
+    if (actual.cleaned != expected_name || actual.x != expected_x || actual.y != expected_y ||
+        x != expected_x || y != expected_y) {
+        std::cout << "FAIL: '" << name << "' -> '" << actual.cleaned << "' (" << actual.x << ", " << actual.y
+                  << "), expected '" << expected_name << "' (" << expected_x << ", " << expected_y << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "=== Pixel Name Test ===" << std::endl;
+
+    const std::vector<std::string> cases = {
+        "",
+        "Vdd_static",
+        "Leakage;Pixel=R12C34",
+        "Pixel=R12C34;Leakage",
+        "Pixel=R12C34",
+        "Pixel=R1C2;Pixel=R3C4;Leakage",
+        "Pixel=R1C2;Pixel=R3C4",
+        ";Pixel=R1C2Pixel=R3C4;x",
+        "Dark;Pixel=R7C;Pixel=R8C9;tail",
+        "Pixel=RC1;Pixel=R2C3",
+        "Pixel=R99999999999C1;name",
+        "name;Pixel=R5C6;Pixel=R7C8",
+        "Pix;Pixel=R1C1el=R2C3;",
+        "Mode=SLEEP;Pixel=R0010C0200;modSum;",
+    };
+
+    bool ok = true;
+    for (const auto& name : cases) {
+        ok &= check(name);
+    }
+
+    // Random names built from tag fragments
+    const std::vector<std::string> pieces = {"Pixel=R", "C", ";", "1", "23", "x", "Pixel=", "R", "404", "name"};
+    std::mt19937 rng(12345);
+    for (int i = 0; i < 20000 && ok; ++i) {
+        std::string name;
+        size_t length = rng() % 12;
+        for (size_t j = 0; j < length; ++j) {
+            name += pieces[rng() % pieces.size()];
+        }
+        ok &= check(name);
+    }
+
+    if (!is_pixel_name("", "Vdd;Pixel=R1C1") || is_pixel_name("Vdd", "Idd")) {
+        std::cout << "FAIL: is_pixel_name" << std::endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: scanner matches the regex implementation" << std::endl;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/record_type_filter.h"
+#include "cpp/include/columnar_store.h"
+#include <libstdf.h>
+#include <iostream>
+#include <map>
+
+// Records skipped before decode must not change what the enabled types yield
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Record Type Filter Test ===" << std::endl;
+
+    RecordTypeFilter filter;
+    filter.set_enabled_types({STDFRecordType::PRR, STDFRecordType::MIR}, false);
+    if (!filter.enabled(REC_TYP_PER_PART, REC_SUB_PRR) || !filter.enabled(REC_TYP_PER_LOT, REC_SUB_MIR) ||
+        filter.enabled(REC_TYP_PER_PART, REC_SUB_PIR) || filter.enabled(REC_TYP_PER_EXEC, REC_SUB_PTR)) {
+        std::cout << "FAIL: filter bits do not match the enabled types" << std::endl;
+        return 1;
+    }
+    filter.set_enabled_types({STDFRecordType::PRR}, true);
+    if (!filter.enabled(REC_TYP_PER_PART, REC_SUB_PIR) || filter.enabled(REC_TYP_PER_LOT, REC_SUB_MIR)) {
+        std::cout << "FAIL: part brackets not enabled with PRR" << std::endl;
+        return 1;
+    }
+
+    // Reference: full decode, filtered afterwards
+    STDFParser full;
+    auto all_records = full.parse_file(test_file);
+    std::map<STDFRecordType, size_t> expected;
+    for (const auto& record : all_records) {
+        if (record.type == STDFRecordType::PRR || record.type == STDFRecordType::MIR) {
+            expected[record.type]++;
+        }
+    }
+    if (expected[STDFRecordType::PRR] == 0) {
+        std::cout << "FAIL: no PRR in " << test_file << std::endl;
+        return 1;
+    }
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        STDFParser parser;
+        parser.set_backend(backend);
+        parser.set_enabled_record_types({STDFRecordType::PRR, STDFRecordType::MIR});
+
+        std::map<STDFRecordType, size_t> counts;
+        for (const auto& record : parser.parse_file(test_file)) {
+            counts[record.type]++;
+        }
+        if (counts != expected || parser.get_total_records() != full.get_total_records()) {
+            std::cout << "FAIL: filtered parse differs from the full decode (" << parser.get_total_records()
+                      << " of " << full.get_total_records() << " records seen)" << std::endl;
+            return 1;
+        }
+
+        // Columns keep PIR brackets for PRR, but nothing else
+        STDFColumnarStore store;
+        if (!parser.parse_to_columns(test_file, store) || store.prr.size() != expected[STDFRecordType::PRR] ||
+            store.pir.size() != store.prr.size() || store.ptr.size() != 0 || store.mir_records.size() != 1) {
+            std::cout << "FAIL: filtered columns hold " << store.prr.size() << " PRR, " << store.pir.size()
+                      << " PIR, " << store.ptr.size() << " PTR" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "   " << expected[STDFRecordType::PRR] << " parts from " << full.get_total_records()
+              << " records" << std::endl;
+    std::cout << "PASS: pre-decode filter matches the full decode on both backends" << std::endl;
+    return 0;
+}
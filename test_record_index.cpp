@@ -0,0 +1,88 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/stdf_record_index.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+namespace fs = std::filesystem;
+
+// Checks indexed random access against a full sequential parse
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Record Index Test ===" << std::endl;
+
+    STDFParser parser;
+    auto records = parser.parse_file(test_file);
+
+    // Fresh build, then a second open that must come from the sidecar
+    std::remove(STDFRecordIndex::sidecar_path(test_file).c_str());
+
+    STDFParser indexed;
+    if (!indexed.open_indexed(test_file) || !indexed.open_indexed(test_file)) {
+        std::cout << "FAIL: could not open " << test_file << " with an index" << std::endl;
+        return 1;
+    }
+
+    if (indexed.get_index()->size() != parser.get_total_records()) {
+        std::cout << "FAIL: index has " << indexed.get_index()->size() << " entries, file has "
+                  << parser.get_total_records() << " records" << std::endl;
+        return 1;
+    }
+
+    size_t mismatches = 0;
+    for (const auto& record : records) {
+        STDFRecord seeked;
+        if (!indexed.read_record(record.record_index, seeked) || seeked.fields != record.fields) {
+            mismatches++;
+        }
+    }
+
+    size_t prr_count = 0;
+    for (const auto& record : records) {
+        if (record.type == STDFRecordType::PRR) prr_count++;
+    }
+
+    auto mirs = indexed.read_records_of_type(STDFRecordType::MIR);
+    if (mismatches > 0 || mirs.size() != 1 || indexed.get_part_count() != prr_count) {
+        std::cout << "FAIL: " << mismatches << " seek mismatches, " << mirs.size() << " MIR, "
+                  << indexed.get_part_count() << " parts" << std::endl;
+        return 1;
+    }
+
+    for (size_t part = 0; part < indexed.get_part_count(); ++part) {
+        auto part_records = indexed.read_part(part);
+        if (part_records.empty() || part_records.back().type != STDFRecordType::PRR) {
+            std::cout << "FAIL: part " << part << " does not end with its PRR" << std::endl;
+            return 1;
+        }
+        std::cout << "   part " << part << ": " << part_records.size() << " records" << std::endl;
+    }
+
+    // A damaged entry count or a cut sidecar is rebuilt instead of trusted
+    const std::string sidecar = STDFRecordIndex::sidecar_path(test_file);
+    const uint64_t huge_count = uint64_t(1) << 60;
+    {
+        std::fstream file(sidecar, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(40);  // IndexFileHeader::entry_count
+        file.write(reinterpret_cast<const char*>(&huge_count), sizeof(huge_count));
+    }
+    STDFRecordIndex damaged;
+    bool rejected = !damaged.load(sidecar, test_file);
+    rejected = rejected && damaged.load_or_build(test_file) && damaged.size() == parser.get_total_records();
+    fs::resize_file(sidecar, fs::file_size(sidecar) - 8);
+    STDFRecordIndex cut;
+    rejected = rejected && !cut.load(sidecar, test_file);
+    if (!rejected) {
+        std::cout << "FAIL: a damaged sidecar was loaded or not rebuilt" << std::endl;
+        return 1;
+    }
+    std::remove(sidecar.c_str());
+
+    std::cout << "PASS: " << records.size() << " indexed reads match the sequential parse" << std::endl;
+    return 0;
+}
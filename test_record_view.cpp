@@ -0,0 +1,72 @@
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/stdf_record_view.h"
+#include <iostream>
+#include <string>
+
+// Lazily decoded fields must read back exactly what the eager decode produces
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Lazy Record View Test ===" << std::endl;
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        STDFParser eager;
+        eager.set_backend(backend);
+        auto records = eager.parse_file(test_file);
+
+        STDFParser lazy;
+        lazy.set_backend(backend);
+        size_t position = 0;
+        size_t compared = 0;
+        std::string mismatch;
+        bool ok = lazy.stream_views(test_file, [&](STDFRecordView& view) {
+            if (!mismatch.empty()) {
+                return;
+            }
+            if (position >= records.size() || records[position].type != view.type() ||
+                records[position].record_index != view.record_index()) {
+                mismatch = "record order differs at " + std::to_string(position);
+                return;
+            }
+            const STDFRecord& record = records[position++];
+
+            // A late field first: offsets are resolved out of order
+            if (view.type() == STDFRecordType::PTR && view.get_field("UNITS") != record.fields.at("UNITS")) {
+                mismatch = "PTR UNITS differs at record " + std::to_string(record.record_index);
+                return;
+            }
+            for (const auto& field : record.fields) {
+                if (view.has_field(field.first) && view.get_field(field.first) != field.second) {
+                    mismatch = field.first + " differs at record " + std::to_string(record.record_index) +
+                               ": '" + view.get_field(field.first) + "' vs '" + field.second + "'";
+                    return;
+                }
+                compared += view.has_field(field.first);
+            }
+
+            // Typed accessors agree with the text
+            if (view.type() == STDFRecordType::PTR &&
+                (std::to_string(view.get_unsigned("TEST_NUM")) != record.fields.at("TEST_NUM") ||
+                 std::to_string(view.get_float("RESULT")) != record.fields.at("RESULT"))) {
+                mismatch = "typed PTR accessors differ at record " + std::to_string(record.record_index);
+            }
+            if (view.type() == STDFRecordType::MIR && std::string(view.get_string("LOT_ID")) != record.fields.at("LOT_ID")) {
+                mismatch = "MIR LOT_ID differs";
+            }
+        });
+
+        if (!ok || !mismatch.empty() || position != records.size() ||
+            lazy.get_parsed_records() != eager.get_parsed_records() ||
+            lazy.get_total_records() != eager.get_total_records()) {
+            std::cout << "FAIL: " << (mismatch.empty() ? "record counts differ" : mismatch) << std::endl;
+            return 1;
+        }
+        std::cout << "   " << position << " views, " << compared << " fields compared" << std::endl;
+    }
+
+    std::cout << "PASS: lazy views match the eager decode on both backends" << std::endl;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "cpp/include/test_selection_filter.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+static bool reference_match(const std::string& text, const std::vector<std::string>& patterns) {
+    for (const auto& pattern : patterns) {
+        if (text.find(pattern) != std::string::npos) return true;
+    }
+    return false;
+}
+
+int main() {
+    std::cout << "=== Test Selection Filter Test ===" << std::endl;
+    std::cout << "   kernel: " << TestSelectionFilter::implementation() << std::endl;
+
+    bool ok = true;
+
+    TestSelectionFilter pixel;
+    if (!pixel.matches("Leakage;Pixel=R1C2") || pixel.matches("Leakage;pixel=R1C2") || pixel.matches("")) {
+        std::cout << "FAIL: default Pixel= filter" << std::endl;
+        ok = false;
+    }
+
+    // Random texts over a small alphabet so partial matches are common,
+    // long enough to cross several SIMD blocks
+    const std::vector<std::vector<std::string>> pattern_sets = {
+        {"Pixel="}, {"a"}, {"ab"}, {"Pix", "el=R"}, {"abcabcabcabcabcabcabcabcabcabcabcabc"}, {"cba", "x"},
+    };
+    const char alphabet[] = "abcPixel=R;";
+    std::mt19937 rng(2024);
+
+    for (const auto& patterns : pattern_sets) {
+        TestSelectionFilter filter(patterns);
+
+        std::vector<std::string> texts(2000);
+        for (auto& text : texts) {
+            size_t length = rng() % 200;
+            for (size_t i = 0; i < length; ++i) {
+                text += alphabet[rng() % (sizeof(alphabet) - 1)];
+            }
+        }
+
+        std::vector<std::string_view> views(texts.begin(), texts.end());
+        std::vector<uint8_t> selected(views.size());
+        filter.match_batch(views.data(), views.size(), selected.data());
+
+        for (size_t i = 0; i < texts.size(); ++i) {
+            bool expected = reference_match(texts[i], patterns);
+            if (filter.matches(texts[i]) != expected || (selected[i] != 0) != expected) {
+                std::cout << "FAIL: pattern '" << patterns[0] << "' on '" << texts[i] << "'" << std::endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    // Empty pattern selects everything, empty list nothing
+    TestSelectionFilter all(std::vector<std::string>{""});
+    TestSelectionFilter none(std::vector<std::string>{});
+    if (!all.matches("anything") || none.matches("anything")) {
+        std::cout << "FAIL: empty pattern / empty list" << std::endl;
+        ok = false;
+    }
+
+    if (!ok) {
+        return 1;
+    }
+    std::cout << "PASS: vectorized filter matches std::string::find" << std::endl;
+    return 0;
+}
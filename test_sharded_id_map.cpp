@@ -0,0 +1,86 @@
+#include "cpp/include/sharded_id_map.h"
+#include <iostream>
+#include <thread>
+#include <set>
+#include <map>
+#include <string_view>
+
+// Concurrent workers must agree on every ID, and IDs must stay dense
+int main() {
+    std::cout << "=== Sharded ID Map Test ===" << std::endl;
+
+    // The flat table itself: growth keeps every key, lookups by view
+    FlatStringMap flat;
+    for (uint32_t n = 0; n < 10000; ++n) {
+        const std::string key = "key_" + std::to_string(n);
+        if (!flat.insert(key, FlatStringMap::hash(key), n).second) {
+            std::cout << "FAIL: flat map rejected a new key" << std::endl;
+            return 1;
+        }
+    }
+    const char buffer[] = "xkey_4321y";
+    const std::string_view view(buffer + 1, 8);
+    const uint32_t* found = flat.find(view, FlatStringMap::hash(view));
+    if (flat.size() != 10000 || !found || *found != 4321 || flat.insert(view, FlatStringMap::hash(view), 0).first != 4321 ||
+        flat.find("key_", FlatStringMap::hash("key_")) || flat.entries()[17].first != "key_17") {
+        std::cout << "FAIL: flat map lookups" << std::endl;
+        return 1;
+    }
+
+    ShardedIDMap ids;
+    ids.load({{"existing_a", 7}, {"existing_b", 3}});
+    if (ids.next_id() != 8 || ids.get_or_assign(std::string_view("existing_a_").substr(0, 10)) != 7) {
+        std::cout << "FAIL: pre-existing mappings" << std::endl;
+        return 1;
+    }
+
+    const size_t thread_count = 8;
+    const size_t name_count = 5000;
+    std::vector<std::vector<uint32_t>> seen(thread_count, std::vector<uint32_t>(name_count));
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&, t]() {
+            // Every worker walks all names from a different start
+            for (size_t k = 0; k < name_count; ++k) {
+                size_t n = (k + t * 617) % name_count;
+                seen[t][n] = ids.get_or_assign("param_" + std::to_string(n));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::set<uint32_t> distinct;
+    for (size_t n = 0; n < name_count; ++n) {
+        for (size_t t = 1; t < thread_count; ++t) {
+            if (seen[t][n] != seen[0][n]) {
+                std::cout << "FAIL: workers disagree on param_" << n << std::endl;
+                return 1;
+            }
+        }
+        distinct.insert(seen[0][n]);
+    }
+    if (distinct.size() != name_count || *distinct.begin() != 8 || *distinct.rbegin() != 8 + name_count - 1) {
+        std::cout << "FAIL: new IDs are not unique and dense" << std::endl;
+        return 1;
+    }
+
+    auto added = ids.new_mappings();
+    auto all = ids.all_mappings();
+    if (added.size() != name_count || all.size() != name_count + 2 || ids.size() != all.size() ||
+        added.front().second != 8 || all.front().first != "existing_b") {
+        std::cout << "FAIL: delta/snapshot (" << added.size() << " new, " << all.size() << " total)" << std::endl;
+        return 1;
+    }
+    for (const auto& mapping : added) {
+        if (mapping.first.compare(0, 6, "param_") != 0) {
+            std::cout << "FAIL: pre-existing name in the delta: " << mapping.first << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: sharded IDs are consistent under concurrency" << std::endl;
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "cpp/include/stream_hash.h"
+#include "cpp/include/stdf_parser.h"
+#include "cpp/include/columnar_store.h"
+#include <zlib.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+
+static std::vector<char> read_all(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+static std::string parse_hash(const std::string& path, STDFParserBackend backend, size_t threads) {
+    STDFParser parser;
+    parser.set_backend(backend);
+    parser.set_num_threads(threads);
+    STDFColumnarStore store;
+    if (!parser.parse_to_columns(path, store)) {
+        return "";
+    }
+    return parser.get_content_hash();
+}
+
+// The dedupe key must be XXH64, independent of chunking and parse path
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Stream Hash Test ===" << std::endl;
+
+    // Reference digests of the xxHash specification
+    StreamHash empty;
+    StreamHash abc;
+    abc.update("abc", 3);
+    if (empty.digest() != 0xEF46DB3751D8E999ULL || abc.digest() != 0x44BC2CF5AD770999ULL ||
+        abc.hex_digest() != "44bc2cf5ad770999") {
+        std::cout << "FAIL: reference digests (" << empty.hex_digest() << ", " << abc.hex_digest() << ")" << std::endl;
+        return 1;
+    }
+
+    std::vector<char> content = read_all(test_file);
+    if (content.empty()) {
+        std::cout << "FAIL: cannot read " << test_file << std::endl;
+        return 1;
+    }
+    StreamHash whole;
+    whole.update(content.data(), content.size());
+    StreamHash pieces;
+    for (size_t offset = 0, step = 1; offset < content.size(); offset += step, step = step * 3 % 997 + 1) {
+        pieces.update(content.data() + offset, std::min(step, content.size() - offset));
+    }
+    if (pieces.digest() != whole.digest() || pieces.total_bytes() != content.size()) {
+        std::cout << "FAIL: chunked updates change the digest" << std::endl;
+        return 1;
+    }
+    const std::string expected = whole.hex_digest();
+    std::cout << "   " << content.size() << " bytes -> " << expected << std::endl;
+
+    struct Case { const char* label; STDFParserBackend backend; size_t threads; };
+    const Case cases[] = {
+        {"libstdf", STDFParserBackend::LIBSTDF, 1},
+        {"mmap", STDFParserBackend::MMAP, 1},
+        {"parallel", STDFParserBackend::MMAP, 4},
+    };
+    for (const Case& c : cases) {
+        std::string hash = parse_hash(test_file, c.backend, c.threads);
+        if (hash != expected) {
+            std::cout << "FAIL: " << c.label << " content hash " << hash << std::endl;
+            return 1;
+        }
+    }
+
+    // A gzip copy hashes its decompressed content
+    const std::string gz_path = "/tmp/test_stream_hash.stdf.gz";
+    gzFile gz = gzopen(gz_path.c_str(), "wb");
+    gzwrite(gz, content.data(), static_cast<unsigned>(content.size()));
+    gzclose(gz);
+    std::string gz_hash = parse_hash(gz_path, STDFParserBackend::MMAP, 1);
+    std::remove(gz_path.c_str());
+    if (gz_hash != expected) {
+        std::cout << "FAIL: gzip content hash " << gz_hash << std::endl;
+        return 1;
+    }
+
+    // A hash handed in is reported for the next parse only
+    STDFParser parser;
+    STDFColumnarStore store;
+    parser.set_content_hash(expected);
+    bool given = parser.parse_to_columns(test_file, store) && parser.get_content_hash() == expected;
+    parser.set_content_hash("0123456789abcdef");
+    given = given && !parser.parse_to_columns("/nonexistent.stdf", store) && parser.get_content_hash().empty();
+    store = STDFColumnarStore();
+    if (!given || !parser.parse_to_columns(test_file, store) || parser.get_content_hash() != expected) {
+        std::cout << "FAIL: a known content hash was not reported once" << std::endl;
+        return 1;
+    }
+
+    std::cout << "PASS: content hash is stable across parse paths" << std::endl;
+    return 0;
+}
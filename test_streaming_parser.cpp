@@ -0,0 +1,56 @@
+#include "cpp/include/stdf_parser.h"
+#include <iostream>
+#include <map>
+
+// Counts records per type through the visitor hooks
+class CountingVisitor : public STDFRecordVisitor {
+public:
+    std::map<STDFRecordType, size_t> counts;
+    bool ended = false;
+
+    void on_mir(STDFRecord& r) override { counts[r.type]++; }
+    void on_ptr(STDFRecord& r) override { counts[r.type]++; }
+    void on_mpr(STDFRecord& r) override { counts[r.type]++; }
+    void on_ftr(STDFRecord& r) override { counts[r.type]++; }
+    void on_hbr(STDFRecord& r) override { counts[r.type]++; }
+    void on_sbr(STDFRecord& r) override { counts[r.type]++; }
+    void on_prr(STDFRecord& r) override { counts[r.type]++; }
+    void on_end() override { ended = true; }
+};
+
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Streaming Parser Test ===" << std::endl;
+
+    STDFParser parser;
+    auto records = parser.parse_file(test_file);
+
+    std::map<STDFRecordType, size_t> expected;
+    for (const auto& record : records) {
+        expected[record.type]++;
+    }
+
+    for (auto backend : {STDFParserBackend::LIBSTDF, STDFParserBackend::MMAP}) {
+        STDFParser streaming_parser;
+        streaming_parser.set_backend(backend);
+
+        CountingVisitor visitor;
+        if (!streaming_parser.stream_file(test_file, visitor)) {
+            std::cout << "FAIL: stream_file could not open " << test_file << std::endl;
+            return 1;
+        }
+
+        if (!visitor.ended || visitor.counts != expected ||
+            streaming_parser.get_parsed_records() != records.size()) {
+            std::cout << "FAIL: visitor counts differ from parse_file" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "PASS: visitor delivered " << records.size() << " records on both backends" << std::endl;
+    return 0;
+}
@@ -0,0 +1,167 @@
+#ifndef FAKE_CLICKHOUSE_SERVER_H
+#define FAKE_CLICKHOUSE_SERVER_H
+
+// Loopback "ClickHouse" shared by the insert tests (header-only)
+
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+// LEB128 varint, as in the Native format headers
+inline uint64_t read_varint(const std::string& data, size_t& pos) {
+    uint64_t value = 0;
+    for (int shift = 0; pos < data.size(); shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(data[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+// Answers each chunked POST after `delay`, and counts the rows of the Native
+// blocks (one per chunk) in every request it accepts. Requests from
+// fail_from on get fail_response. With hang_up (the default) each
+// connection is closed after one answer; without it connections stay open
+// for HTTP keep-alive. start() may follow stop() for a fresh port.
+struct FakeClickHouseServer {
+    uint16_t port = 0;
+    std::chrono::milliseconds delay{0};
+    size_t fail_from = SIZE_MAX;
+    std::string fail_response = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 9\r\n\r\nCode: 241";
+    bool hang_up = true;
+    std::atomic<size_t> requests{0};
+    std::atomic<size_t> connections{0};
+    std::atomic<size_t> rows{0};
+
+    FakeClickHouseServer() = default;
+    FakeClickHouseServer(const FakeClickHouseServer&) = delete;
+    FakeClickHouseServer& operator=(const FakeClickHouseServer&) = delete;
+    ~FakeClickHouseServer() { stop(); }
+
+    bool start() {
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(listener_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener_, 16) != 0 ||
+            getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+            close(listener_);
+            listener_ = -1;
+            return false;
+        }
+        port = ntohs(address.sin_port);
+        acceptor_ = std::thread([this] {
+            while (true) {
+                int client = accept(listener_, nullptr, nullptr);
+                if (client < 0) return;
+                connections++;
+                std::lock_guard<std::mutex> lock(mutex_);
+                clients_.insert(client);
+                workers_.emplace_back([this, client] { serve(client); });
+            }
+        });
+        return true;
+    }
+
+    // Closes the listener and every open connection, then waits for them
+    void stop() {
+        if (listener_ < 0) return;
+        shutdown(listener_, SHUT_RDWR);
+        close(listener_);
+        acceptor_.join();
+        listener_ = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int client : clients_) {
+                shutdown(client, SHUT_RDWR);
+            }
+        }
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+
+    std::string last_request() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return last_request_;
+    }
+
+private:
+    void serve(int client) {
+        char buffer[65536];
+        while (true) {
+            std::string request;
+            while (request.size() < 5 || request.compare(request.size() - 5, 5, "0\r\n\r\n") != 0) {
+                ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+                if (received <= 0) {
+                    hang_up_on(client);
+                    return;
+                }
+                request.append(buffer, static_cast<size_t>(received));
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                last_request_ = request;
+            }
+            std::this_thread::sleep_for(delay);
+            const bool fail = requests++ >= fail_from;
+            if (!fail) {
+                rows += native_rows(request);
+            }
+            const std::string response = fail ? fail_response : "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+            send(client, response.data(), response.size(), MSG_NOSIGNAL);
+            if (hang_up) {
+                hang_up_on(client);
+                return;
+            }
+        }
+    }
+
+    void hang_up_on(int client) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        clients_.erase(client);
+        close(client);
+    }
+
+    // Body: "<hex size>\r\n<block>\r\n" per chunk; a block starts with its
+    // column and row counts
+    static size_t native_rows(const std::string& request) {
+        size_t total = 0;
+        size_t pos = request.find("\r\n\r\n");
+        if (pos == std::string::npos) return 0;
+        pos += 4;
+        while (pos < request.size()) {
+            const size_t line_end = request.find("\r\n", pos);
+            if (line_end == std::string::npos) break;
+            const size_t size = std::strtoul(request.c_str() + pos, nullptr, 16);
+            if (size == 0) break;
+            size_t block = line_end + 2;
+            read_varint(request, block);
+            total += read_varint(request, block);
+            pos = line_end + 2 + size + 2;
+        }
+        return total;
+    }
+
+    int listener_ = -1;
+    std::thread acceptor_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+    std::set<int> clients_;
+    std::string last_request_;
+};
+
+#endif // FAKE_CLICKHOUSE_SERVER_H
@@ -0,0 +1,49 @@
+#ifndef MEASUREMENT_COMPARE_H
+#define MEASUREMENT_COMPARE_H
+
+// Row-by-row comparison of measurement batches for the tests (header-only)
+
+#include <iostream>
+#include <vector>
+#include "../cpp/include/measurement_batch.h"
+
+// Every measurement_fields.def column of every row; names the first row
+// that differs
+inline bool same_rows(const MeasurementBatch& batch, const MeasurementBatch& expected) {
+    if (batch.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        bool same = true;
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            same = same && batch.name[i] == expected.name[i];
+        #include "../cpp/include/measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+        if (!same) {
+            std::cout << "   row " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// The same against rows as MeasurementBatch::to_tuples() gives them
+inline bool same_rows(const MeasurementBatch& batch, const std::vector<MeasurementTuple>& expected) {
+    if (batch.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        bool same = true;
+        #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+            same = same && batch.name[i] == expected[i].name;
+        #include "../cpp/include/measurement_fields.def"
+        #undef MEASUREMENT_FIELD
+        if (!same) {
+            std::cout << "   row " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif // MEASUREMENT_COMPARE_H
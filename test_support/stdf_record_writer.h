@@ -0,0 +1,84 @@
+#ifndef STDF_RECORD_WRITER_H
+#define STDF_RECORD_WRITER_H
+
+// Hand-built STDF records for the decoder tests (header-only)
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Builds a record body field by field, in either byte order (the FAR
+// declares which: CPU_TYP 2 = little, 1 = big endian). ends holds the body
+// length after each field, for writing records cut short.
+struct RecordWriter {
+    bool big_endian = false;
+    std::vector<uint8_t> body;
+    std::vector<size_t> ends{0};
+
+    RecordWriter() = default;
+    explicit RecordWriter(bool big_endian) : big_endian(big_endian) {}
+
+    void u1(uint8_t value) { put(value, 1); }
+    void u2(uint16_t value) { put(value, 2); }
+    void u4(uint32_t value) { put(value, 4); }
+    void r4(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        u4(bits);
+    }
+    void cn(const std::string& text) {
+        u1(static_cast<uint8_t>(text.size()));
+        body.insert(body.end(), text.begin(), text.end());
+        ends.back() = body.size();
+    }
+    // Dn of bit_count bits with the given pins set; extra bits past
+    // bit_count are set in the last byte to check they are ignored
+    void dn(uint16_t bit_count, std::initializer_list<size_t> pins, uint8_t tail_junk = 0) {
+        u2(bit_count);
+        std::vector<uint8_t> bytes((bit_count + 7) / 8, 0);
+        for (size_t pin : pins) bytes[pin / 8] |= static_cast<uint8_t>(1u << (pin % 8));
+        if (!bytes.empty()) bytes.back() |= tail_junk;
+        body.insert(body.end(), bytes.begin(), bytes.end());
+        ends.back() = body.size();
+    }
+
+    // Appends header and body as one record and starts the next body
+    void write(std::vector<char>& out, uint8_t rec_type, uint8_t rec_subtype) {
+        append(out, rec_type, rec_subtype, body.size());
+        body.clear();
+        ends.assign(1, 0);
+    }
+    void write(std::ostream& out, uint8_t rec_type, uint8_t rec_subtype) {
+        std::vector<char> record;
+        write(record, rec_type, rec_subtype);
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+    // Writes the first keep bytes of the body as one record; the body stays
+    void write(std::ostream& out, uint8_t rec_type, uint8_t rec_subtype, size_t keep) const {
+        std::vector<char> record;
+        append(record, rec_type, rec_subtype, keep);
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+    }
+
+private:
+    void put(uint32_t value, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            body.push_back(static_cast<uint8_t>(value >> (8 * (big_endian ? size - 1 - i : i))));
+        }
+        ends.push_back(body.size());
+    }
+
+    void append(std::vector<char>& out, uint8_t rec_type, uint8_t rec_subtype, size_t keep) const {
+        RecordWriter header(big_endian);
+        header.u2(static_cast<uint16_t>(keep));
+        header.u1(rec_type);
+        header.u1(rec_subtype);
+        out.insert(out.end(), header.body.begin(), header.body.end());
+        out.insert(out.end(), body.begin(), body.begin() + static_cast<std::ptrdiff_t>(keep));
+    }
+};
+
+#endif // STDF_RECORD_WRITER_H
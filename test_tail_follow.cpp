@@ -0,0 +1,166 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/stdf_tail_reader.h"
+#include "test_support/stdf_record_writer.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// Two sites tested side by side, part after part. Only the first PTR of
+// each test carries its name, units and limits; later ones stop after
+// RESULT and inherit them, across polls.
+static std::vector<char> multi_part_file() {
+    std::vector<char> file;
+    RecordWriter record;
+    record.u1(2); record.u1(4);
+    record.write(file, 0, 10);
+    for (int part = 0; part < 12; ++part) {
+        for (uint8_t site = 1; site <= 2; ++site) {
+            record.u1(1); record.u1(site);
+            record.write(file, 5, 10);
+        }
+        for (uint32_t test = 0; test < 6; ++test) {
+            for (uint8_t site = 1; site <= 2; ++site) {
+                record.u4(1000 + test); record.u1(1); record.u1(site); record.u1(0); record.u1(0);
+                record.r4(0.25f * static_cast<float>(part * 10 + test) + site);
+                if (part == 0) {
+                    record.cn("VDD;Pixel=R" + std::to_string(test) + "C2"); record.cn("");
+                    record.u1(0x0E); record.u1(0); record.u1(0); record.u1(0);
+                    record.r4(-1.0f); record.r4(100.0f);
+                    record.cn("mA");
+                }
+                record.write(file, 15, 10);
+            }
+        }
+        for (uint8_t site = 1; site <= 2; ++site) {
+            record.u1(1); record.u1(site); record.u1(0); record.u2(6);
+            record.u2(site); record.u2(site); record.u2(static_cast<uint16_t>(part)); record.u2(site);
+            record.u4(0);
+            record.cn("P" + std::to_string(part) + "S" + std::to_string(site)); record.cn(""); record.u1(0);
+            record.write(file, 5, 20);
+        }
+    }
+    record.u4(0); record.u1(0); record.u1(0); record.cn(""); record.cn(""); record.cn("");
+    record.write(file, 1, 20);
+    return file;
+}
+
+// Writes bytes to a growing copy in pieces of next_piece() bytes, polling
+// before and after each; the rows must equal the whole-file rows
+template<typename NextPiece>
+static bool follow(const std::string& name, const std::vector<char>& bytes, NextPiece next_piece) {
+    const std::string whole_path = "/tmp/test_tail_follow_whole.stdf";
+    std::ofstream(whole_path, std::ios::binary | std::ios::trunc).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    UltraFastProcessor whole_processor;
+    whole_processor.set_parser_backend(STDFParserBackend::MMAP);
+    whole_processor.set_file_hash("hash");
+    MeasurementBatch whole = whole_processor.process_stdf_file_to_batch(whole_path);
+    std::remove(whole_path.c_str());
+    if (whole.size() == 0) {
+        std::cout << "FAIL: " << name << ": no measurements" << std::endl;
+        return false;
+    }
+
+    const std::string growing = "/tmp/test_tail_follow.stdf";
+    std::ofstream out(growing, std::ios::binary | std::ios::trunc);
+    UltraFastProcessor follower;
+    follower.set_file_hash("hash");
+    if (!follower.start_following(growing)) {
+        std::cout << "FAIL: " << name << ": " << follower.get_last_error() << std::endl;
+        return false;
+    }
+
+    size_t row = 0;
+    size_t polls_with_rows = 0;
+    bool same = true;
+    auto sink = [&](MeasurementBatch& batch) {
+        for (size_t i = 0; i < batch.size() && same; ++i, ++row) {
+            same = row < whole.size();
+            #define MEASUREMENT_FIELD(name, cpp_type, python_conversion, clickhouse_type) \
+                same = same && batch.name[i] == whole.name[row];
+            #include "cpp/include/measurement_fields.def"
+            #undef MEASUREMENT_FIELD
+        }
+        return same;
+    };
+
+    size_t written = 0;
+    size_t polls = 0;
+    while (true) {
+        const size_t before = row;
+        if (!follower.poll_followed_file(7000, sink)) {
+            std::cout << "FAIL: " << name << ": poll " << polls << " at byte " << written << ": "
+                      << (same ? follower.get_last_error() : "row " + std::to_string(row - 1) + " differs") << std::endl;
+            return false;
+        }
+        ++polls;
+        polls_with_rows += row > before;
+        const STDFTailReader* tail = follower.followed_file();
+        if (tail->offset() + tail->pending_bytes() != written) {
+            std::cout << "FAIL: " << name << ": read offset " << tail->offset() << " with " << written
+                      << " bytes written" << std::endl;
+            return false;
+        }
+        if (written == bytes.size()) {
+            break;
+        }
+        const size_t size = std::min(next_piece(), bytes.size() - written);
+        out.write(bytes.data() + written, static_cast<std::streamsize>(size));
+        out.flush();
+        written += size;
+    }
+
+    const STDFTailReader* tail = follower.followed_file();
+    if (row != whole.size() || tail->pending_bytes() != 0 || !tail->complete() || follower.open_part_tests() != 0) {
+        std::cout << "FAIL: " << name << ": followed " << row << " of " << whole.size() << " rows, complete "
+                  << tail->complete() << std::endl;
+        return false;
+    }
+
+    // A poll after the end reads nothing and emits nothing
+    const size_t before = row;
+    if (!follower.poll_followed_file(7000, sink) || row != before || tail->last_poll_records() != 0) {
+        std::cout << "FAIL: " << name << ": a poll past the end emitted again" << std::endl;
+        return false;
+    }
+
+    // Shrinking (e.g. the tester starting over) is an error, not a re-read
+    out.close();
+    std::ofstream(growing, std::ios::binary | std::ios::trunc).write(bytes.data(), 100);
+    if (follower.poll_followed_file(7000, sink)) {
+        std::cout << "FAIL: " << name << ": a file that shrank was polled" << std::endl;
+        return false;
+    }
+    std::remove(growing.c_str());
+
+    std::cout << "   " << name << ": " << row << " rows over " << polls << " polls (" << polls_with_rows
+              << " closing parts), " << tail->record_count() << " records" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Tail Follow Test ===" << std::endl;
+
+    // Pieces from 1 byte up, so cuts land inside headers, inside records and
+    // on record boundaries
+    std::ifstream in(test_file, std::ios::binary);
+    std::vector<char> sample((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    size_t piece = 1;
+    if (!follow("sample file", sample, [&piece]() { return piece = piece * 2 + 1; })) {
+        return 1;
+    }
+
+    // 97-byte pieces: parts close in many polls while others are still open
+    if (!follow("multi-part file", multi_part_file(), []() { return size_t(97); })) {
+        return 1;
+    }
+
+    std::cout << "PASS: following a growing file yields each part once, in file order" << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "cpp/include/ultra_fast_processor.h"
+#include "cpp/include/test_statistics.h"
+#include <cmath>
+#include <iostream>
+#include <map>
+
+static bool close_to(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::max(std::fabs(a), std::fabs(b)));
+}
+
+// Two-pass statistics of the rows of one wtp_id
+struct Reference {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double squares = 0.0;  // Around the mean, second pass
+    double min = 0.0;
+    double max = 0.0;
+};
+
+static bool same_stats(const RunningStats& a, const RunningStats& b) {
+    return a.count == b.count && a.passed == b.passed && a.min == b.min && a.max == b.max &&
+           close_to(a.mean, b.mean) && close_to(a.stddev(), b.stddev());
+}
+
+// Streaming summaries must match statistics computed over the emitted rows
+int main(int argc, char* argv[]) {
+    std::string test_file = "STDF_Files/OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf";
+    if (argc > 1) {
+        test_file = argv[1];
+    }
+
+    std::cout << "=== Test Statistics Test ===" << std::endl;
+
+    // Merging blocks in any split gives the one-block result
+    const double values[] = {3.0, 1.5, 4.0, 1.0, 5.5, 9.0, 2.0, 6.5};
+    RunningStats whole;
+    whole.add(values, 8, 2.0, 6.0, true, true, true);
+    RunningStats split;
+    split.add(values, 3, 2.0, 6.0, true, true, true);
+    RunningStats rest;
+    rest.add(values + 3, 5, 2.0, 6.0, true, true, true);
+    split.merge(rest);
+    if (whole.count != 8 || whole.passed != 4 || !close_to(whole.mean, 4.0625) ||
+        !close_to(whole.variance(), 53.71875 / 7.0) || !same_stats(whole, split)) {
+        std::cout << "FAIL: block merge differs from a single pass" << std::endl;
+        return 1;
+    }
+
+    UltraFastProcessor processor;
+    processor.set_parser_backend(STDFParserBackend::MMAP);
+    MeasurementBatch batch = processor.process_stdf_file_to_batch(test_file);
+    const std::vector<TestSummary> summaries = processor.get_test_summaries();
+    if (batch.size() == 0 || summaries.empty()) {
+        std::cout << "FAIL: no rows or no summaries" << std::endl;
+        return 1;
+    }
+
+    std::map<uint32_t, Reference> expected;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Reference& ref = expected[batch.wtp_id[i]];
+        double value = batch.wptm_value[i];
+        ref.min = ref.count == 0 ? value : std::min(ref.min, value);
+        ref.max = ref.count == 0 ? value : std::max(ref.max, value);
+        ref.sum += value;
+        ++ref.count;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        Reference& ref = expected[batch.wtp_id[i]];
+        double deviation = batch.wptm_value[i] - ref.sum / static_cast<double>(ref.count);
+        ref.squares += deviation * deviation;
+    }
+
+    if (summaries.size() != expected.size()) {
+        std::cout << "FAIL: " << summaries.size() << " summaries for " << expected.size() << " parameters" << std::endl;
+        return 1;
+    }
+    uint64_t total = 0;
+    size_t with_cpk = 0;
+    for (size_t i = 0; i < summaries.size(); ++i) {
+        const TestSummary& summary = summaries[i];
+        auto it = expected.find(summary.wtp_id);
+        if (it == expected.end() || (i > 0 && summaries[i - 1].wtp_id >= summary.wtp_id)) {
+            std::cout << "FAIL: summary wtp_id " << summary.wtp_id << " out of order or unknown" << std::endl;
+            return 1;
+        }
+        const Reference& ref = it->second;
+        double stddev = ref.count > 1 ? std::sqrt(ref.squares / static_cast<double>(ref.count - 1)) : 0.0;
+        if (summary.stats.count != ref.count || summary.stats.min != ref.min || summary.stats.max != ref.max ||
+            !close_to(summary.stats.mean, ref.sum / static_cast<double>(ref.count)) ||
+            !close_to(summary.stats.stddev(), stddev) || summary.stats.passed > summary.stats.count) {
+            std::cout << "FAIL: summary of " << summary.wtp_param_name << " differs from its rows" << std::endl;
+            return 1;
+        }
+        total += summary.stats.count;
+        with_cpk += std::isnan(summary.cpk()) ? 0 : 1;
+    }
+    if (total != batch.size()) {
+        std::cout << "FAIL: summaries cover " << total << " of " << batch.size() << " rows" << std::endl;
+        return 1;
+    }
+
+    // Per-thread accumulators merge to the same summaries
+    UltraFastProcessor threaded;
+    threaded.set_parser_backend(STDFParserBackend::MMAP);
+    threaded.set_num_threads(4);
+    threaded.process_stdf_file_to_batch(test_file);
+    const std::vector<TestSummary>& threaded_summaries = threaded.get_test_summaries();
+    bool same = threaded_summaries.size() == summaries.size();
+    for (size_t i = 0; same && i < summaries.size(); ++i) {
+        same = threaded_summaries[i].wtp_id == summaries[i].wtp_id &&
+               same_stats(threaded_summaries[i].stats, summaries[i].stats);
+    }
+    if (!same) {
+        std::cout << "FAIL: 4-thread summaries differ" << std::endl;
+        return 1;
+    }
+
+    std::cout << "   " << summaries.size() << " summaries (" << with_cpk << " with Cpk) for "
+              << batch.size() << " rows" << std::endl;
+    std::cout << "PASS: per-test summaries match the emitted rows" << std::endl;
+    return 0;
+}
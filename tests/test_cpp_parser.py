@@ -8,6 +8,8 @@ import os
 import sys
 import tempfile
 import json
+import threading
+import time
 
 # Add python directory to path
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'python'))
@@ -145,6 +147,72 @@ class TestSTDFCppParser:
         stats = parser.get_statistics()
         assert stats['files_processed'] == 0
 
+SAMPLE_STDF = os.path.join(
+    os.path.dirname(__file__), '..', 'STDF_Files',
+    'OSBE25_KEWGBCLD1U_BE_HRG3201Y.09_KEWGBCLD1U__Prod_TPP202_03_Agilent_93000MT9510_25C_5264_4_20240910125552.stdf')
+
+class TestColumnarExport:
+    """Test cases for the zero-copy columnar bridge"""
+    
+    def test_columns_match_tuples(self):
+        """Columns (codes + dictionary for strings) must expand to the tuples"""
+        if not CPP_EXTENSION_AVAILABLE:
+            pytest.skip("C++ extension not built yet")
+        if not os.path.exists(SAMPLE_STDF):
+            pytest.skip("Sample STDF file not available")
+        
+        tuples = stdf_parser_cpp.process_stdf_with_database_mappings(SAMPLE_STDF, [], [], "hash")['measurement_tuples']
+        result = stdf_parser_cpp.process_stdf_to_columns(SAMPLE_STDF, [], [], "hash")
+        columns = result['columns']
+        assert result['row_count'] == len(tuples)
+        
+        expanded = []
+        for column in columns.values():
+            if isinstance(column, tuple):
+                codes, dictionary = column
+                expanded.append([dictionary[code] for code in memoryview(codes).tolist()])
+            else:
+                view = memoryview(column)
+                assert view.readonly and len(view) == len(tuples)
+                expanded.append(view.tolist())
+        
+        assert list(zip(*expanded)) == tuples
+
+class TestGILRelease:
+    """Native parsing and processing run without the GIL"""
+    
+    def test_threads_run_during_native_calls(self):
+        """A Python thread keeps ticking while a call parses and processes"""
+        if not CPP_EXTENSION_AVAILABLE:
+            pytest.skip("C++ extension not built yet")
+        if not os.path.exists(SAMPLE_STDF):
+            pytest.skip("Sample STDF file not available")
+        
+        calls = {
+            'parse_stdf_file': lambda: stdf_parser_cpp.parse_stdf_file(SAMPLE_STDF),
+            'process_stdf_to_clickhouse_tuples': lambda: stdf_parser_cpp.process_stdf_to_clickhouse_tuples(SAMPLE_STDF),
+        }
+        for name, call in calls.items():
+            ticks = []
+            done = threading.Event()
+            
+            def tick():
+                while not done.is_set():
+                    ticks.append(time.perf_counter())
+                    time.sleep(0.001)
+            
+            ticker = threading.Thread(target=tick)
+            ticker.start()
+            start = time.perf_counter()
+            call()
+            end = time.perf_counter()
+            done.set()
+            ticker.join()
+            
+            # With the GIL held for the whole call the ticker could not run at all
+            during = [t for t in ticks if start < t < end]
+            assert len(during) >= 10, f"{name}: {len(during)} ticks in {end - start:.3f}s"
+
 class TestSTDFProcessingPipeline:
     """Test cases for complete processing pipeline"""
     
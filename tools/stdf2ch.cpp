@@ -0,0 +1,435 @@
+// stdf2ch: STDF files -> ClickHouse blocks, without a Python interpreter
+//
+//   ./stdf2ch [options] FILE...
+//
+// Decodes the files with the same engine as the Python module and then,
+// depending on the options:
+//   --host HOST     inserts them over the ClickHouse HTTP interface
+//                   (InsertPipeline: decode and insert threads, bounded queue)
+//   --output PATH   writes the encoded blocks to PATH ('-' = stdout), e.g.
+//                   stdf2ch -o - f.stdf | clickhouse-client -q "INSERT INTO measurements FORMAT Native"
+//   (neither)       decodes only and reports throughput, for profiling the
+//                   hot path with perf and friends
+// Run with --help for the full option list.
+
+#include "../cpp/include/batch_ingest_engine.h"
+#include "../cpp/include/insert_pipeline.h"
+#include "../cpp/include/file_prefetcher.h"
+#include "../cpp/include/clickhouse_encoder.h"
+#include "../cpp/include/ingest_manifest.h"
+#include "../cpp/include/console_log.h"
+#include "../cpp/include/instrumentation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::vector<std::string> files;
+    std::string output;
+    ClickHouseConnection connection;
+    bool insert = false;
+    std::string table = "measurements";
+    ClickHouseFormat format = ClickHouseFormat::NATIVE;
+    std::vector<std::string> columns;
+    std::vector<std::string> patterns;
+    STDFParserBackend backend = STDFParserBackend::MMAP;
+    size_t threads = 0;
+    size_t insert_threads = 2;
+    size_t queue_depth = 4;
+    size_t read_ahead = 2;
+    size_t coalesce_rows = 0;
+    size_t coalesce_bytes = 0;
+    size_t batch_rows = 1 << 20;
+    size_t memory_budget = 0;
+    std::string manifest_path;
+    std::string spool_dir;
+    std::string id_snapshot_dir;
+    std::string mappings_prefix;
+    bool presort = false;
+    bool stats = false;
+    bool quiet = false;
+};
+
+const char* const USAGE =
+    "Usage: stdf2ch [options] FILE...\n"
+    "\n"
+    "Output (default: decode only and report throughput)\n"
+    "  -o, --output PATH       Write encoded blocks to PATH ('-' = stdout)\n"
+    "  -H, --host HOST         Insert over the ClickHouse HTTP interface\n"
+    "      --port N            HTTP port (8123)\n"
+    "  -d, --database NAME     Database (default)\n"
+    "  -u, --user NAME         User (default); password from CLICKHOUSE_PASSWORD\n"
+    "  -t, --table NAME        Table to insert into (measurements)\n"
+    "  -f, --format NAME       native | rowbinary (native)\n"
+    "  -c, --columns A,B,...   Fields to send (all of measurement_fields.def)\n"
+    "\n"
+    "Decoding\n"
+    "  -j, --threads N         Decode threads, 0 = one per core (0)\n"
+    "      --insert-threads N  Concurrent INSERTs with --host (2)\n"
+    "      --queue-depth N     Decoded blocks waiting for insert (4)\n"
+    "      --coalesce-rows N   With --host: small files share INSERTs of at\n"
+    "                          least N rows (0 = one per file at least)\n"
+    "      --coalesce-bytes N  Send a shared INSERT early at about N bytes\n"
+    "      --spool DIR         With --host: keep blocks in DIR until inserted,\n"
+    "                          replaying what an earlier run left there\n"
+    "  -b, --batch-rows N      Rows per block (1048576)\n"
+    "      --memory-budget MB  With --output: stage blocks under this budget,\n"
+    "                          spilling the rest to disk (0 = keep in memory)\n"
+    "      --backend NAME      mmap | libstdf (mmap)\n"
+    "      --read-ahead N      Files read into the page cache ahead of the\n"
+    "                          decoders, 0 = none (2)\n"
+    "      --patterns A,B,...  Test selection substrings (Pixel=)\n"
+    "      --presort           Sort each block by the table's ORDER BY key\n"
+    "\n"
+    "IDs and bookkeeping\n"
+    "      --id-snapshot DIR   Start from the ID snapshots in DIR\n"
+    "      --mappings PREFIX   Write new IDs to PREFIX.devices.tsv / PREFIX.params.tsv\n"
+    "      --manifest PATH     Skip files ingested per PATH, record new ones\n"
+    "\n"
+    "  -s, --stats             Print per-stage timings at the end\n"
+    "  -q, --quiet             No progress output\n"
+    "  -h, --help              This text\n";
+
+std::vector<std::string> split_list(const std::string& value) {
+    std::vector<std::string> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+bool parse_count(const std::string& option, const char* value, size_t& out) {
+    char* end = nullptr;
+    const unsigned long long parsed = std::strtoull(value, &end, 10);
+    if (!*value || *end) {
+        std::cerr << "stdf2ch: " << option << " expects a number, got '" << value << "'" << std::endl;
+        return false;
+    }
+    out = static_cast<size_t>(parsed);
+    return true;
+}
+
+// False (message printed) on bad usage; exit_code 0 when only --help was asked
+bool parse_options(int argc, char* argv[], Options& options, int& exit_code) {
+    exit_code = 2;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            std::cout << USAGE;
+            exit_code = 0;
+            return false;
+        }
+        if (arg == "-s" || arg == "--stats") {
+            options.stats = true;
+            continue;
+        }
+        if (arg == "-q" || arg == "--quiet") {
+            options.quiet = true;
+            continue;
+        }
+        if (arg == "--presort") {
+            options.presort = true;
+            continue;
+        }
+        if (arg.empty() || arg[0] != '-' || arg == "-") {
+            options.files.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "stdf2ch: " << arg << " needs a value\n" << USAGE;
+            return false;
+        }
+        const char* value = argv[++i];
+        size_t number = 0;
+        if (arg == "-o" || arg == "--output") {
+            options.output = value;
+        } else if (arg == "-H" || arg == "--host") {
+            options.connection.host = value;
+            options.insert = true;
+        } else if (arg == "--port") {
+            if (!parse_count(arg, value, number) || number == 0 || number > 65535) return false;
+            options.connection.port = static_cast<uint16_t>(number);
+        } else if (arg == "-d" || arg == "--database") {
+            options.connection.database = value;
+        } else if (arg == "-u" || arg == "--user") {
+            options.connection.user = value;
+        } else if (arg == "-t" || arg == "--table") {
+            options.table = value;
+        } else if (arg == "-f" || arg == "--format") {
+            if (std::strcmp(value, "native") == 0) {
+                options.format = ClickHouseFormat::NATIVE;
+            } else if (std::strcmp(value, "rowbinary") == 0) {
+                options.format = ClickHouseFormat::ROW_BINARY;
+            } else {
+                std::cerr << "stdf2ch: unknown format '" << value << "' (native or rowbinary)" << std::endl;
+                return false;
+            }
+        } else if (arg == "-c" || arg == "--columns") {
+            options.columns = split_list(value);
+        } else if (arg == "--patterns") {
+            options.patterns = split_list(value);
+        } else if (arg == "-j" || arg == "--threads") {
+            if (!parse_count(arg, value, options.threads)) return false;
+        } else if (arg == "--insert-threads") {
+            if (!parse_count(arg, value, options.insert_threads)) return false;
+        } else if (arg == "--queue-depth") {
+            if (!parse_count(arg, value, options.queue_depth)) return false;
+        } else if (arg == "--coalesce-rows") {
+            if (!parse_count(arg, value, options.coalesce_rows)) return false;
+        } else if (arg == "--coalesce-bytes") {
+            if (!parse_count(arg, value, options.coalesce_bytes)) return false;
+        } else if (arg == "--read-ahead") {
+            if (!parse_count(arg, value, options.read_ahead)) return false;
+        } else if (arg == "-b" || arg == "--batch-rows") {
+            if (!parse_count(arg, value, options.batch_rows)) return false;
+            if (options.batch_rows == 0) {
+                std::cerr << "stdf2ch: " << arg << " must be at least 1" << std::endl;
+                return false;
+            }
+        } else if (arg == "--memory-budget") {
+            if (!parse_count(arg, value, number)) return false;
+            options.memory_budget = number << 20;
+        } else if (arg == "--backend") {
+            if (std::strcmp(value, "mmap") == 0) {
+                options.backend = STDFParserBackend::MMAP;
+            } else if (std::strcmp(value, "libstdf") == 0) {
+                options.backend = STDFParserBackend::LIBSTDF;
+            } else {
+                std::cerr << "stdf2ch: unknown backend '" << value << "' (mmap or libstdf)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--id-snapshot") {
+            options.id_snapshot_dir = value;
+        } else if (arg == "--mappings") {
+            options.mappings_prefix = value;
+        } else if (arg == "--manifest") {
+            options.manifest_path = value;
+        } else if (arg == "--spool") {
+            options.spool_dir = value;
+        } else {
+            std::cerr << "stdf2ch: unknown option " << arg << "\n" << USAGE;
+            return false;
+        }
+    }
+    if (options.files.empty()) {
+        std::cerr << "stdf2ch: no input files\n" << USAGE;
+        return false;
+    }
+    if (options.insert && !options.output.empty()) {
+        std::cerr << "stdf2ch: --host and --output are exclusive" << std::endl;
+        return false;
+    }
+    if (const char* password = std::getenv("CLICKHOUSE_PASSWORD")) {
+        options.connection.password = password;
+    }
+    return true;
+}
+
+bool write_mappings(const std::string& path, const std::vector<std::pair<std::string, uint32_t>>& mappings) {
+    std::ofstream out(path, std::ios::trunc);
+    for (const auto& mapping : mappings) {
+        out << mapping.second << '\t' << mapping.first << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+void print_stats() {
+    const InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    if (!snapshot.compiled) {
+        std::cerr << "(built without STDF_INSTRUMENTATION)" << std::endl;
+        return;
+    }
+    for (const StageStats& stage : snapshot.stages) {
+        if (stage.calls > 0) {
+            std::cerr << "   " << stage.name << ": " << stage.calls << " calls, " << stage.total_seconds
+                      << "s total, " << stage.max_seconds << "s max" << std::endl;
+        }
+    }
+}
+
+// Per-file outcome; true when every file succeeded
+bool report_files(const std::vector<FileIngestStats>& files) {
+    bool ok = true;
+    for (const FileIngestStats& file : files) {
+        if (!file.success) {
+            std::cerr << "stdf2ch: " << file.path << ": " << file.error << std::endl;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void record_in_manifest(IngestManifest& manifest, const std::vector<FileIngestStats>& files) {
+    for (const FileIngestStats& file : files) {
+        if (!file.skipped) {
+            manifest.record(file.path, file.file_hash, file.success ? ManifestStatus::INGESTED : ManifestStatus::FAILED);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    int exit_code = 0;
+    if (!parse_options(argc, argv, options, exit_code)) {
+        return exit_code;
+    }
+    // Library progress goes to stdout, which may be carrying the blocks
+    ConsoleLog::set_quiet(options.quiet || options.output == "-");
+    if (!options.id_snapshot_dir.empty()) {
+        FastIDManager::set_default_snapshot_dir(options.id_snapshot_dir);
+    }
+    UltraFastProcessor::set_default_sort_output(options.presort);
+    FilePrefetcher::set_default_files_ahead(options.read_ahead);
+
+    IngestManifest manifest;
+    if (!options.manifest_path.empty() && !manifest.open(options.manifest_path)) {
+        std::cerr << "stdf2ch: " << manifest.get_last_error() << std::endl;
+        return 1;
+    }
+    const IngestManifest* manifest_ptr = manifest.is_open() ? &manifest : nullptr;
+
+    const auto start_time = std::chrono::steady_clock::now();
+    bool ok = true;
+    size_t rows = 0;
+    size_t bytes = 0;
+    std::vector<FileIngestStats> files;
+    std::vector<std::pair<std::string, uint32_t>> new_devices;
+    std::vector<std::pair<std::string, uint32_t>> new_params;
+
+    if (options.insert) {
+        InsertPipeline pipeline(options.connection);
+        pipeline.set_decode_threads(options.threads);
+        pipeline.set_insert_threads(options.insert_threads);
+        pipeline.set_queue_depth(options.queue_depth);
+        pipeline.set_block_rows(options.batch_rows);
+        pipeline.set_coalesce_rows(options.coalesce_rows);
+        pipeline.set_coalesce_bytes(options.coalesce_bytes);
+        pipeline.set_format(options.format);
+        pipeline.set_parser_backend(options.backend);
+        pipeline.set_manifest(manifest_ptr);
+        if (!options.patterns.empty()) {
+            pipeline.set_test_filter_patterns(options.patterns);
+        }
+        InsertSpool spool;
+        if (!options.spool_dir.empty()) {
+            if (!spool.open(options.spool_dir)) {
+                std::cerr << "stdf2ch: " << spool.get_last_error() << std::endl;
+                return 1;
+            }
+            pipeline.set_insert_spool(&spool);
+        }
+        if (!pipeline.encoder().set_columns(options.columns)) {
+            std::cerr << "stdf2ch: " << pipeline.encoder().get_last_error() << std::endl;
+            return 2;
+        }
+        ok = pipeline.run(options.table, options.files);
+        files = pipeline.file_stats();
+        rows = pipeline.stats().rows_inserted;
+        bytes = pipeline.stats().bytes_sent;
+        new_devices = pipeline.id_manager().get_new_device_mappings();
+        new_params = pipeline.id_manager().get_new_param_mappings();
+        if (!ok && !pipeline.get_last_error().empty()) {
+            std::cerr << "stdf2ch: " << pipeline.get_last_error() << std::endl;
+        }
+        if (pipeline.stats().blocks_pending > 0) {
+            std::cerr << "stdf2ch: " << pipeline.get_last_error() << "; " << pipeline.stats().blocks_pending
+                      << " blocks wait in " << options.spool_dir << " for the next run" << std::endl;
+        }
+    } else {
+        ClickHouseBlockEncoder encoder;
+        if (!encoder.set_columns(options.columns)) {
+            std::cerr << "stdf2ch: " << encoder.get_last_error() << std::endl;
+            return 2;
+        }
+        std::ofstream file_out;
+        std::ostream* out = nullptr;
+        if (options.output == "-") {
+            out = &std::cout;
+        } else if (!options.output.empty()) {
+            file_out.open(options.output, std::ios::binary | std::ios::trunc);
+            if (!file_out) {
+                std::cerr << "stdf2ch: cannot write " << options.output << std::endl;
+                return 1;
+            }
+            out = &file_out;
+        }
+
+        BatchIngestEngine engine;
+        engine.set_num_threads(options.threads);
+        engine.set_parser_backend(options.backend);
+        engine.set_manifest(manifest_ptr);
+        if (!options.patterns.empty()) {
+            engine.set_test_filter_patterns(options.patterns);
+        }
+        if (out && options.memory_budget > 0) {
+            engine.set_memory_budget(options.memory_budget);
+        }
+        ok = engine.process_files(options.files);
+
+        // Blocks of batch_rows, in file order
+        std::string block;
+        auto write_rows = [&](const MeasurementBatch& batch) {
+            for (size_t first = 0; first < batch.size(); first += options.batch_rows) {
+                const size_t count = std::min(options.batch_rows, batch.size() - first);
+                block.clear();
+                encoder.encode(batch, first, count, options.format, block);
+                out->write(block.data(), static_cast<std::streamsize>(block.size()));
+                bytes += block.size();
+            }
+            rows += batch.size();
+            return static_cast<bool>(*out);
+        };
+        if (!out) {
+            rows = engine.measurements().size();
+        } else if (engine.spool()) {
+            ok = engine.drain_measurements([&](size_t, MeasurementBatch& batch) { return write_rows(batch); }) && ok;
+        } else {
+            ok = write_rows(engine.measurements()) && ok;
+        }
+        if (out && !out->flush()) {
+            std::cerr << "stdf2ch: write failed" << std::endl;
+            ok = false;
+        }
+        files = engine.file_stats();
+        new_devices = engine.id_manager().get_new_device_mappings();
+        new_params = engine.id_manager().get_new_param_mappings();
+    }
+
+    ok = report_files(files) && ok;
+    // Only output that was stored counts as ingested
+    if (manifest_ptr && (options.insert || !options.output.empty())) {
+        record_in_manifest(manifest, files);
+    }
+    if (!options.mappings_prefix.empty() &&
+        (!write_mappings(options.mappings_prefix + ".devices.tsv", new_devices) ||
+         !write_mappings(options.mappings_prefix + ".params.tsv", new_params))) {
+        std::cerr << "stdf2ch: cannot write " << options.mappings_prefix << ".*.tsv" << std::endl;
+        ok = false;
+    }
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (!options.quiet) {
+        std::cerr << "stdf2ch: " << files.size() << " files, " << rows << " rows";
+        if (bytes > 0) {
+            std::cerr << ", " << bytes << " bytes";
+        }
+        std::cerr << ", " << new_devices.size() << " new devices, " << new_params.size() << " new parameters in "
+                  << seconds << "s (" << (seconds > 0 ? rows / seconds : 0.0) << " rows/s)" << std::endl;
+    }
+    if (options.stats) {
+        print_stats();
+    }
+    return ok ? 0 : 1;
+}